@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../PMath.inl"
+#include "../PMathAnimation.h"
+#include "../PMathParallel.h"
+
+using namespace PMgene::Math;
+
+namespace
+{
+	// 2,000 characters of 100 joints playing a 2 second clip keyed at 30 Hz, ticked at 60 Hz
+	constexpr size_t CharacterCount = 2000;
+	constexpr size_t JointCount = 100;
+	constexpr size_t KeyCount = 61;
+	constexpr float Duration = 2.f;
+	constexpr float TickLength = 1.f / 60.f;
+
+	struct Keys
+	{
+		std::vector<float> times;
+		std::vector<Vector3> translations;
+		std::vector<Quaternion> rotations;
+		std::vector<Vector3> scales;
+	};
+
+	std::vector<Keys> RandomKeys(unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+		std::uniform_real_distribution<float> offset(-1.f, 1.f);
+
+		std::vector<Keys> result(JointCount);
+		for (Keys& keys : result)
+		{
+			for (size_t k = 0; k < KeyCount; ++k)
+			{
+				keys.times.push_back(Duration * k / (KeyCount - 1));
+				keys.translations.push_back(Vector3(offset(random), offset(random), offset(random)));
+				keys.rotations.push_back(Quaternion::CreateFromYawPitchRoll(angle(random), angle(random), angle(random)));
+				keys.scales.push_back(Vector3(1.f + 0.1f * offset(random)));
+			}
+		}
+		return result;
+	}
+
+	// What sampling looks like without cursors: a binary search per track and per sample
+	void SampleDirectXMath(const std::vector<Keys>& clip, float time, XMFLOAT4X4* pose) noexcept
+	{
+		for (size_t j = 0; j < clip.size(); ++j)
+		{
+			const Keys& keys = clip[j];
+			const size_t next = std::clamp<size_t>(std::upper_bound(keys.times.begin(), keys.times.end(), time) - keys.times.begin(), 1, KeyCount - 1);
+			const float t = std::clamp((time - keys.times[next - 1]) / (keys.times[next] - keys.times[next - 1]), 0.f, 1.f);
+
+			const XMVECTOR translation = XMVectorLerp(XMLoadFloat3(&keys.translations[next - 1]), XMLoadFloat3(&keys.translations[next]), t);
+			const XMVECTOR scale = XMVectorLerp(XMLoadFloat3(&keys.scales[next - 1]), XMLoadFloat3(&keys.scales[next]), t);
+			XMVECTOR Q0 = XMLoadFloat4(&keys.rotations[next - 1]);
+			XMVECTOR Q1 = XMLoadFloat4(&keys.rotations[next]);
+			if (!XMVector4GreaterOrEqual(XMVector4Dot(Q0, Q1), XMVectorZero()))
+				Q1 = XMVectorNegate(Q1);
+			const XMVECTOR rotation = XMQuaternionNormalize(XMVectorLerp(Q0, Q1, t));
+
+			XMStoreFloat4x4(pose + j, XMMatrixAffineTransformation(scale, XMVectorZero(), rotation, translation));
+		}
+	}
+
+	// Plays the clip forward in uneven steps, wrapping once, and compares every pose with the search
+	bool MatchesSearch(const std::vector<Keys>& keys, const AnimationClip& clip)
+	{
+		AnimationSampler sampler(clip);
+		std::vector<Matrix> pose(JointCount);
+		std::vector<XMFLOAT4X4> expected(JointCount);
+		for (float time = 0.f; time < 2.f * Duration; time += 0.7f * TickLength)
+		{
+			const float wrapped = time < Duration ? time : time - Duration;
+			sampler.Sample(wrapped, pose);
+			SampleDirectXMath(keys, wrapped, expected.data());
+			for (size_t j = 0; j < JointCount; ++j)
+			{
+				for (size_t e = 0; e < 16; ++e)
+				{
+					if (std::fabs(pose[j].m[e / 4][e % 4] - expected[j].m[e / 4][e % 4]) > 1e-4f)
+						return false;
+				}
+			}
+		}
+		return true;
+	}
+}
+
+PMATH_BENCHMARK(AnimationSampling)
+{
+	const std::vector<Keys> keys = RandomKeys(1);
+	std::vector<AnimationTrack> tracks(JointCount);
+	for (size_t j = 0; j < JointCount; ++j)
+		tracks[j] = { keys[j].times, keys[j].translations, keys[j].times, keys[j].rotations, keys[j].times, keys[j].scales };
+
+	AnimationClip clip;
+	clip.Build(Duration, tracks);
+	if (!MatchesSearch(keys, clip))
+		std::fprintf(stderr, "AnimationSampling: sampled poses differ from the search\n");
+
+	// Characters start at different points of the clip and all advance by one tick per call
+	std::vector<AnimationSampler> samplers(CharacterCount, AnimationSampler(clip));
+	std::vector<float> times(CharacterCount);
+	for (size_t i = 0; i < CharacterCount; ++i)
+		times[i] = Duration * i / CharacterCount;
+
+	const auto tick = [&] {
+		for (float& time : times)
+		{
+			time += TickLength;
+			if (time > Duration)
+				time -= Duration;
+		}
+	};
+
+	std::vector<SQT> sqtPoses(CharacterCount * JointCount);
+	std::vector<Matrix> matrixPoses(CharacterCount * JointCount);
+	std::vector<XMFLOAT4X4> rawPoses(CharacterCount * JointCount);
+
+	state.Compare("Sample Matrix", CharacterCount * JointCount,
+		[&] {
+			tick();
+			AnimationSampler::Sample(samplers, times, matrixPoses);
+			Benchmarks::DoNotOptimize(matrixPoses.data());
+		},
+		[&] {
+			tick();
+			for (size_t i = 0; i < CharacterCount; ++i)
+				SampleDirectXMath(keys, times[i], rawPoses.data() + i * JointCount);
+			Benchmarks::DoNotOptimize(rawPoses.data());
+		});
+
+	state.Measure("Sample SQT", CharacterCount * JointCount, [&] {
+		tick();
+		AnimationSampler::Sample(samplers, times, sqtPoses);
+		Benchmarks::DoNotOptimize(sqtPoses.data());
+	});
+	state.Measure("Sample SQT parallel", CharacterCount * JointCount, [&] {
+		tick();
+		AnimationSampler::Sample(Parallel::par, samplers, times, sqtPoses);
+		Benchmarks::DoNotOptimize(sqtPoses.data());
+	});
+	state.Measure("Sample Matrix parallel", CharacterCount * JointCount, [&] {
+		tick();
+		AnimationSampler::Sample(Parallel::par, samplers, times, matrixPoses);
+		Benchmarks::DoNotOptimize(matrixPoses.data());
+	});
+
+	// Random access defeats the cursors and measures the search path
+	std::mt19937 random(2);
+	std::uniform_real_distribution<float> seek(0.f, Duration);
+	state.Measure("Sample SQT random seek", CharacterCount * JointCount, [&] {
+		for (float& time : times)
+			time = seek(random);
+		AnimationSampler::Sample(samplers, times, sqtPoses);
+		Benchmarks::DoNotOptimize(sqtPoses.data());
+	});
+}
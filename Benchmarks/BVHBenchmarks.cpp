@@ -0,0 +1,216 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../PMath.inl"
+#include "../PMathBVH.h"
+#include "../PMathCpu.h"
+#include "../PMathParallel.h"
+
+using namespace PMgene::Math;
+
+namespace
+{
+	// Height field of 2 * GridSize^2 triangles, about a million
+	constexpr uint32_t GridSize = 708;
+	constexpr size_t RayCount = 1 << 16;
+	constexpr size_t BoxQueryCount = 1 << 14;
+
+	struct Mesh
+	{
+		std::vector<Vector3> vertices;
+		std::vector<uint32_t> indices;
+	};
+
+	Mesh Terrain()
+	{
+		Mesh mesh;
+		for (uint32_t z = 0; z <= GridSize; ++z)
+		{
+			for (uint32_t x = 0; x <= GridSize; ++x)
+			{
+				const float height = 5.f * std::sin(0.1f * x) * std::cos(0.13f * z);
+				mesh.vertices.emplace_back(static_cast<float>(x), height, static_cast<float>(z));
+			}
+		}
+		for (uint32_t z = 0; z < GridSize; ++z)
+		{
+			for (uint32_t x = 0; x < GridSize; ++x)
+			{
+				const uint32_t a = z * (GridSize + 1) + x;
+				const uint32_t b = a + GridSize + 1;
+				mesh.indices.insert(mesh.indices.end(), { a, a + 1, b, a + 1, b + 1, b });
+			}
+		}
+		return mesh;
+	}
+
+	// Camera rays over an image, neighbouring rays sharing a packet
+	std::vector<Ray> CameraRays()
+	{
+		constexpr size_t Width = 256;
+		const Vector3 eye(GridSize * 0.5f, 60.f, -40.f);
+
+		std::vector<Ray> rays;
+		rays.reserve(RayCount);
+		for (size_t y = 0; y < RayCount / Width; ++y)
+		{
+			for (size_t x = 0; x < Width; ++x)
+			{
+				Vector3 direction(static_cast<float>(x) / Width - 0.5f, -0.3f - 0.4f * static_cast<float>(y) * Width / RayCount, 1.f);
+				direction.Normalize();
+				rays.emplace_back(eye, direction);
+			}
+		}
+		return rays;
+	}
+
+	// Shadow rays from scattered surface points towards one light
+	std::vector<Ray> ShadowRays()
+	{
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> position(0.f, static_cast<float>(GridSize));
+		Vector3 light(1.f, 2.f, 0.5f);
+		light.Normalize();
+
+		std::vector<Ray> rays;
+		rays.reserve(RayCount);
+		for (size_t i = 0; i < RayCount; ++i)
+			rays.emplace_back(Vector3(position(random), 6.f, position(random)), light);
+		return rays;
+	}
+
+	std::vector<AABB> QueryBoxes()
+	{
+		std::mt19937 random(2);
+		std::uniform_real_distribution<float> position(0.f, static_cast<float>(GridSize));
+
+		std::vector<AABB> boxes(BoxQueryCount);
+		for (AABB& box : boxes)
+		{
+			const Vector3 center(position(random), 0.f, position(random));
+			box = AABB(center - Vector3(2.f, 6.f, 2.f), center + Vector3(2.f, 6.f, 2.f));
+		}
+		return boxes;
+	}
+}
+
+PMATH_BENCHMARK(BVHBuild)
+{
+	const Mesh mesh = Terrain();
+	const size_t triangles = mesh.indices.size() / 3;
+
+	state.Measure("Build triangles", triangles, [&] {
+		BVH bvh;
+		bvh.Build(mesh.vertices, mesh.indices);
+		Benchmarks::DoNotOptimize(bvh.NodeCount());
+	});
+	state.Measure("Build triangles parallel", triangles, [&] {
+		BVH bvh;
+		bvh.Build(Parallel::par, mesh.vertices, mesh.indices);
+		Benchmarks::DoNotOptimize(bvh.NodeCount());
+	});
+}
+
+PMATH_BENCHMARK(BVHRaycast)
+{
+	const Mesh mesh = Terrain();
+	BVH bvh;
+	bvh.Build(Parallel::par, mesh.vertices, mesh.indices);
+
+	const std::vector<Ray> rays = CameraRays();
+	std::vector<RayHit> hits(rays.size());
+
+	SetSimdLevel(SimdLevel::Scalar);
+	state.Measure("Raycast generic", rays.size(), [&] {
+		bvh.Raycast(rays, hits);
+		Benchmarks::DoNotOptimize(hits.data());
+	});
+
+	if (GetSupportedSimdLevel() >= SimdLevel::AVX2)
+	{
+		SetSimdLevel(SimdLevel::AVX2);
+		state.Measure("Raycast AVX2", rays.size(), [&] {
+			bvh.Raycast(rays, hits);
+			Benchmarks::DoNotOptimize(hits.data());
+		});
+		state.Measure("RaycastPackets AVX2", rays.size(), [&] {
+			bvh.RaycastPackets(rays, hits);
+			Benchmarks::DoNotOptimize(hits.data());
+		});
+	}
+
+	SetSimdLevel(GetSupportedSimdLevel());
+	state.Measure("Raycast parallel", rays.size(), [&] {
+		bvh.Raycast(Parallel::par, rays, hits);
+		Benchmarks::DoNotOptimize(hits.data());
+	});
+	state.Measure("RaycastPackets parallel", rays.size(), [&] {
+		bvh.RaycastPackets(Parallel::par, rays, hits);
+		Benchmarks::DoNotOptimize(hits.data());
+	});
+}
+
+PMATH_BENCHMARK(BVHOccluded)
+{
+	const Mesh mesh = Terrain();
+	BVH bvh;
+	bvh.Build(Parallel::par, mesh.vertices, mesh.indices);
+
+	const std::vector<Ray> rays = ShadowRays();
+	std::vector<uint8_t> occluded(rays.size());
+
+	SetSimdLevel(SimdLevel::Scalar);
+	state.Measure("Occluded generic", rays.size(), [&] {
+		bvh.Occluded(rays, occluded);
+		Benchmarks::DoNotOptimize(occluded.data());
+	});
+
+	if (GetSupportedSimdLevel() >= SimdLevel::AVX2)
+	{
+		SetSimdLevel(SimdLevel::AVX2);
+		state.Measure("Occluded AVX2", rays.size(), [&] {
+			bvh.Occluded(rays, occluded);
+			Benchmarks::DoNotOptimize(occluded.data());
+		});
+	}
+
+	SetSimdLevel(GetSupportedSimdLevel());
+	state.Measure("Occluded parallel", rays.size(), [&] {
+		bvh.Occluded(Parallel::par, rays, occluded);
+		Benchmarks::DoNotOptimize(occluded.data());
+	});
+}
+
+PMATH_BENCHMARK(BVHOverlap)
+{
+	const Mesh mesh = Terrain();
+	BVH bvh;
+	bvh.Build(Parallel::par, mesh.vertices, mesh.indices);
+
+	const std::vector<AABB> boxes = QueryBoxes();
+	std::vector<uint32_t> offsets;
+	std::vector<uint32_t> primitives;
+
+	SetSimdLevel(SimdLevel::Scalar);
+	state.Measure("Overlap generic", boxes.size(), [&] {
+		bvh.Overlap(boxes, offsets, primitives);
+		Benchmarks::DoNotOptimize(primitives.data());
+	});
+
+	if (GetSupportedSimdLevel() >= SimdLevel::AVX2)
+	{
+		SetSimdLevel(SimdLevel::AVX2);
+		state.Measure("Overlap AVX2", boxes.size(), [&] {
+			bvh.Overlap(boxes, offsets, primitives);
+			Benchmarks::DoNotOptimize(primitives.data());
+		});
+	}
+
+	SetSimdLevel(GetSupportedSimdLevel());
+	state.Measure("Overlap parallel", boxes.size(), [&] {
+		bvh.Overlap(Parallel::par, boxes, offsets, primitives);
+		Benchmarks::DoNotOptimize(primitives.data());
+	});
+}
@@ -0,0 +1,212 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+#include "../PMathCpu.h"
+
+namespace PMgene::Math::Benchmarks
+{
+	namespace
+	{
+		struct Entry
+		{
+			const char* name;
+			Function function;
+		};
+
+		struct Result
+		{
+			std::string name;
+			size_t iterations;
+			double nsPerItem;
+			double itemsPerSecond;
+			double directXMathNsPerItem; // 0 without a DirectXMath counterpart
+		};
+
+		std::vector<Entry>& Registry()
+		{
+			static std::vector<Entry> entries;
+			return entries;
+		}
+
+		std::vector<Result>& Results()
+		{
+			static std::vector<Result> results;
+			return results;
+		}
+
+		// Console table, switched off when JSON goes to stdout
+		bool g_console = true;
+
+		using Clock = std::chrono::steady_clock;
+
+		constexpr int Samples = 7;
+		constexpr double SampleSeconds = 0.02;
+
+		constexpr const char* LevelNames[] = { "Scalar", "SSE2", "SSE4.1", "AVX2", "AVX-512" };
+
+		double Seconds(const std::function<void()>& function, size_t iterations)
+		{
+			const auto start = Clock::now();
+			for (size_t i = 0; i < iterations; ++i)
+				function();
+			return std::chrono::duration<double>(Clock::now() - start).count();
+		}
+
+		// Median time per item over the samples
+		Result Run(const std::string& name, size_t items, const std::function<void()>& function)
+		{
+			// Warm up caches and calibrate the repeat count so a sample takes roughly SampleSeconds
+			const double once = std::max(Seconds(function, 1), 1e-9);
+			const size_t iterations = std::max<size_t>(1, static_cast<size_t>(SampleSeconds / once));
+
+			double samples[Samples];
+			for (double& sample : samples)
+				sample = Seconds(function, iterations) / static_cast<double>(iterations);
+			std::sort(samples, samples + Samples);
+
+			const double seconds = samples[Samples / 2];
+			const double count = static_cast<double>(std::max<size_t>(items, 1));
+			return { name, iterations * Samples, seconds * 1e9 / count, count / seconds, 0.0 };
+		}
+
+		void Print(const std::string& benchmark, const std::string& label, const Result& result, const char* note = "")
+		{
+			if (g_console)
+				std::printf("%-32s %-28s %12.3f ns/item %14.0f items/s%s\n", benchmark.c_str(), label.c_str(), result.nsPerItem,
+				            result.itemsPerSecond, note);
+		}
+
+		void WriteString(std::FILE* file, const std::string& text)
+		{
+			std::fputc('"', file);
+			for (const char c : text)
+			{
+				if (c == '"' || c == '\\')
+					std::fputc('\\', file);
+				std::fputc(c, file);
+			}
+			std::fputc('"', file);
+		}
+
+		void WriteJson(std::FILE* file, const char* executable)
+		{
+			char date[32];
+			const std::time_t now = std::time(nullptr);
+			std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+			std::fprintf(file, "{\n  \"context\": {\n    \"date\": \"%s\",\n    \"executable\": ", date);
+			WriteString(file, executable);
+			std::fprintf(file, ",\n    \"num_cpus\": %u,\n    \"simd_level\": \"%s\",\n", std::thread::hardware_concurrency(),
+			             LevelNames[static_cast<int>(GetSupportedSimdLevel())]);
+#ifdef NDEBUG
+			std::fprintf(file, "    \"library_build_type\": \"release\"\n  },\n  \"benchmarks\": [");
+#else
+			std::fprintf(file, "    \"library_build_type\": \"debug\"\n  },\n  \"benchmarks\": [");
+#endif
+
+			const std::vector<Result>& results = Results();
+			for (size_t i = 0; i < results.size(); ++i)
+			{
+				const Result& result = results[i];
+				std::fprintf(file, "%s\n    {\n      \"name\": ", i == 0 ? "" : ",");
+				WriteString(file, result.name);
+				std::fprintf(file, ",\n      \"run_type\": \"iteration\",\n      \"iterations\": %zu,\n      \"real_time\": %.4f,\n"
+				                   "      \"time_unit\": \"ns\",\n      \"items_per_second\": %.1f",
+				             result.iterations, result.nsPerItem, result.itemsPerSecond);
+				if (result.directXMathNsPerItem > 0.0)
+					std::fprintf(file, ",\n      \"directxmath_real_time\": %.4f,\n      \"overhead\": %.4f", result.directXMathNsPerItem,
+					             result.nsPerItem / result.directXMathNsPerItem);
+				std::fprintf(file, "\n    }");
+			}
+			std::fprintf(file, "\n  ]\n}\n");
+		}
+	}
+
+	bool Register(const char* name, Function function)
+	{
+		Registry().push_back({ name, function });
+		return true;
+	}
+
+	void State::Measure(const std::string& label, size_t items, const std::function<void()>& function) const
+	{
+		const Result result = Run(m_name + "/" + label, items, function);
+		Print(m_name, label, result);
+		Results().push_back(result);
+	}
+
+	void State::Compare(const std::string& label, size_t items, const std::function<void()>& function,
+	                    const std::function<void()>& directXMath) const
+	{
+		Result result = Run(m_name + "/" + label, items, function);
+		const Result baseline = Run(m_name + "/" + label + "/DirectXMath", items, directXMath);
+		result.directXMathNsPerItem = baseline.nsPerItem;
+
+		char note[32];
+		std::snprintf(note, sizeof(note), " %8.2fx DirectXMath", result.nsPerItem / baseline.nsPerItem);
+		Print(m_name, label, result, note);
+		Print(m_name, label + " (DirectXMath)", baseline);
+
+		Results().push_back(result);
+		Results().push_back(baseline);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	using namespace PMgene::Math;
+
+	// Flags follow Google Benchmark, other arguments select benchmarks whose name contains any of them
+	const char* outPath = nullptr;
+	bool jsonToConsole = false;
+	std::vector<const char*> filters;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strncmp(argv[i], "--benchmark_out=", 16) == 0)
+			outPath = argv[i] + 16;
+		else if (std::strcmp(argv[i], "--benchmark_format=json") == 0)
+			jsonToConsole = true;
+		else
+			filters.push_back(argv[i]);
+	}
+
+	Benchmarks::g_console = !jsonToConsole;
+	if (Benchmarks::g_console)
+		std::printf("Supported SIMD level: %s\n\n", Benchmarks::LevelNames[static_cast<int>(GetSupportedSimdLevel())]);
+
+	for (const auto& [name, function] : Benchmarks::Registry())
+	{
+		bool selected = filters.empty();
+		for (size_t i = 0; i < filters.size() && !selected; ++i)
+			selected = std::strstr(name, filters[i]) != nullptr;
+		if (!selected)
+			continue;
+
+		Benchmarks::State state(name);
+		function(state);
+		SetSimdLevel(GetSupportedSimdLevel());
+	}
+
+	if (jsonToConsole)
+		Benchmarks::WriteJson(stdout, argv[0]);
+
+	if (outPath)
+	{
+		std::FILE* file = std::fopen(outPath, "w");
+		if (!file)
+		{
+			std::fprintf(stderr, "Cannot open %s\n", outPath);
+			return 1;
+		}
+		Benchmarks::WriteJson(file, argv[0]);
+		std::fclose(file);
+	}
+	return 0;
+}
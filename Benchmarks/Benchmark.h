@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Minimal benchmark harness. Benchmarks register themselves with PMATH_BENCHMARK and report
+// one or more measurements through State::Measure. Results go to the console, and with
+// --benchmark_out=<file> or --benchmark_format=json also to JSON in the layout of Google Benchmark.
+
+namespace PMgene::Math::Benchmarks
+{
+	class State
+	{
+	public:
+		explicit State(std::string name) : m_name(std::move(name)) {}
+
+		// Times 'function', which processes 'items' elements per call, and prints the throughput
+		void Measure(const std::string& label, size_t items, const std::function<void()>& function) const;
+
+		// Times a PMath operation and the same work written against raw DirectXMath, so the cost of
+		// the XMFLOAT load/store wrappers shows up as the ratio between the two
+		void Compare(const std::string& label, size_t items, const std::function<void()>& function,
+		             const std::function<void()>& directXMath) const;
+
+	private:
+		std::string m_name;
+	};
+
+	using Function = void (*)(State& state);
+
+	bool Register(const char* name, Function function);
+
+	// Keeps the compiler from discarding a computed value
+	template <typename T>
+	inline void DoNotOptimize(const T& value) noexcept
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		const volatile char sink = *reinterpret_cast<const volatile char*>(&value);
+		(void)sink;
+#else
+		asm volatile("" : : "r,m"(value) : "memory");
+#endif
+	}
+
+	// Turns a per-element operation into a function for Measure and Compare that fills the whole
+	// output, output[i] = operation(i), and keeps it alive
+	template <typename T, typename Operation>
+	auto Loop(std::vector<T>& output, Operation operation)
+	{
+		return [&output, operation] {
+			for (size_t i = 0; i < output.size(); ++i)
+				output[i] = operation(i);
+			DoNotOptimize(output.data());
+		};
+	}
+}
+
+#define PMATH_BENCHMARK(Name) \
+	static void Name(PMgene::Math::Benchmarks::State& state); \
+	static const bool Name##Registered = PMgene::Math::Benchmarks::Register(#Name, Name); \
+	static void Name([[maybe_unused]] PMgene::Math::Benchmarks::State& state)
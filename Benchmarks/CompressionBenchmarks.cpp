@@ -0,0 +1,115 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <DirectXPackedVector.h>
+
+#include "Benchmark.h"
+#include "../PMath.inl"
+#include "../PMathCompression.h"
+
+using namespace PMgene::Math;
+using namespace DirectX::PackedVector;
+
+namespace
+{
+	// 100 joints for each of 2,000 characters
+	constexpr size_t Count = 100 * 2000;
+
+	std::vector<Quaternion> RandomRotations(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+
+		std::vector<Quaternion> result(count);
+		for (Quaternion& Q : result)
+			Q = Quaternion::CreateFromYawPitchRoll(angle(random), angle(random), angle(random));
+		return result;
+	}
+
+	std::vector<Vector3> RandomPoints(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> coordinate(-100.f, 100.f);
+
+		std::vector<Vector3> result(count);
+		for (Vector3& V : result)
+			V = Vector3(coordinate(random), coordinate(random), coordinate(random));
+		return result;
+	}
+}
+
+PMATH_BENCHMARK(QuaternionCompression)
+{
+	const std::vector<Quaternion> rotations = RandomRotations(Count, 1);
+	std::vector<Quaternion> decoded(Count);
+
+	std::vector<PackedQuaternion48> packed48(Count);
+	state.Measure("Encode 48-bit", Count, [&] {
+		PackedQuaternion48::Encode(rotations, packed48);
+		Benchmarks::DoNotOptimize(packed48.data());
+	});
+	state.Measure("Decode 48-bit", Count, [&] {
+		PackedQuaternion48::Decode(packed48, decoded);
+		Benchmarks::DoNotOptimize(decoded.data());
+	});
+
+	std::vector<PackedQuaternion32> packed32(Count);
+	state.Measure("Encode 32-bit", Count, [&] {
+		PackedQuaternion32::Encode(rotations, packed32);
+		Benchmarks::DoNotOptimize(packed32.data());
+	});
+	state.Measure("Decode 32-bit", Count, [&] {
+		PackedQuaternion32::Decode(packed32, decoded);
+		Benchmarks::DoNotOptimize(decoded.data());
+	});
+}
+
+PMATH_BENCHMARK(Vector3Compression)
+{
+	const std::vector<Vector3> points = RandomPoints(Count, 2);
+	const AABB range(Vector3(-100.f), Vector3(100.f));
+	std::vector<Vector3> decoded(Count);
+
+	std::vector<PackedVector3Half> halves(Count);
+	std::vector<HALF> rawHalves(Count * 3);
+	std::vector<XMFLOAT3> rawDecoded(Count);
+	state.Compare("Encode half", Count,
+		[&] {
+			PackedVector3Half::Encode(points, halves);
+			Benchmarks::DoNotOptimize(halves.data());
+		},
+		[&] {
+			XMConvertFloatToHalfStream(rawHalves.data(), sizeof(HALF), &points[0].x, sizeof(float), Count * 3);
+			Benchmarks::DoNotOptimize(rawHalves.data());
+		});
+	state.Compare("Decode half", Count,
+		[&] {
+			PackedVector3Half::Decode(halves, decoded);
+			Benchmarks::DoNotOptimize(decoded.data());
+		},
+		[&] {
+			XMConvertHalfToFloatStream(&rawDecoded[0].x, sizeof(float), rawHalves.data(), sizeof(HALF), Count * 3);
+			Benchmarks::DoNotOptimize(rawDecoded.data());
+		});
+
+	std::vector<PackedVector3Unorm16> unorm(Count);
+	state.Measure("Encode unorm16", Count, [&] {
+		PackedVector3Unorm16::Encode(range, points, unorm);
+		Benchmarks::DoNotOptimize(unorm.data());
+	});
+	state.Measure("Decode unorm16", Count, [&] {
+		PackedVector3Unorm16::Decode(range, unorm, decoded);
+		Benchmarks::DoNotOptimize(decoded.data());
+	});
+
+	std::vector<PackedVector3Snorm16> snorm(Count);
+	state.Measure("Encode snorm16", Count, [&] {
+		PackedVector3Snorm16::Encode(range, points, snorm);
+		Benchmarks::DoNotOptimize(snorm.data());
+	});
+	state.Measure("Decode snorm16", Count, [&] {
+		PackedVector3Snorm16::Decode(range, snorm, decoded);
+		Benchmarks::DoNotOptimize(decoded.data());
+	});
+}
@@ -0,0 +1,84 @@
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../PMath.inl"
+#include "../PMathBounds.h"
+#include "../PMathCpu.h"
+#include "../PMathParallel.h"
+
+using namespace PMgene::Math;
+
+namespace
+{
+	// Instances a renderer culls per frame
+	constexpr size_t BoxCount = 500000;
+
+	std::vector<AABB> RandomBoxes(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> position(-500.f, 500.f);
+		std::uniform_real_distribution<float> size(0.5f, 5.f);
+
+		std::vector<AABB> result(count);
+		for (AABB& box : result)
+		{
+			const Vector3 center(position(random), position(random), position(random));
+			const Vector3 extents(size(random), size(random), size(random));
+			box = AABB(center - extents, center + extents);
+		}
+		return result;
+	}
+
+	Frustum CameraFrustum()
+	{
+		const Matrix view = Matrix::CreateLookAt(Vector3(0.f, 10.f, -50.f), Vector3(0.f, 0.f, 100.f), Vector3::UnitY);
+		const Matrix projection = Matrix::CreatePerspectiveFieldOfView(1.2f, 16.f / 9.f, 0.1f, 1000.f);
+		return Frustum::FromMatrix(view * projection);
+	}
+}
+
+PMATH_BENCHMARK(FrustumCullAABB)
+{
+	const std::vector<AABB> boxes = RandomBoxes(BoxCount, 1);
+	const Frustum frustum = CameraFrustum();
+	std::vector<uint64_t> mask((BoxCount + 63) / 64);
+	std::vector<uint32_t> indices(BoxCount);
+
+	state.Measure("Intersects loop", BoxCount, [&] {
+		size_t visible = 0;
+		for (size_t i = 0; i < BoxCount; ++i)
+		{
+			indices[visible] = static_cast<uint32_t>(i);
+			visible += frustum.Intersects(boxes[i]);
+		}
+		Benchmarks::DoNotOptimize(indices.data());
+	});
+
+	SetSimdLevel(SimdLevel::Scalar);
+	state.Measure("Cull mask generic", BoxCount, [&] {
+		frustum.Cull(boxes, mask);
+		Benchmarks::DoNotOptimize(mask.data());
+	});
+	state.Measure("Cull indices generic", BoxCount, [&] {
+		Benchmarks::DoNotOptimize(frustum.Cull(boxes, indices));
+	});
+
+	if (GetSupportedSimdLevel() >= SimdLevel::AVX2)
+	{
+		SetSimdLevel(SimdLevel::AVX2);
+		state.Measure("Cull mask AVX2", BoxCount, [&] {
+			frustum.Cull(boxes, mask);
+			Benchmarks::DoNotOptimize(mask.data());
+		});
+		state.Measure("Cull indices AVX2", BoxCount, [&] {
+			Benchmarks::DoNotOptimize(frustum.Cull(boxes, indices));
+		});
+	}
+
+	SetSimdLevel(GetSupportedSimdLevel());
+	state.Measure("Cull mask parallel", BoxCount, [&] {
+		frustum.Cull(Parallel::par, boxes, mask);
+		Benchmarks::DoNotOptimize(mask.data());
+	});
+}
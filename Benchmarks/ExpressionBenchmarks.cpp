@@ -0,0 +1,100 @@
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../PMath.inl"
+#include "../PMathExpression.h"
+#include "../PMathParallel.h"
+
+using namespace PMgene::Math;
+
+namespace
+{
+	// Small enough to stay in L1, so the numbers are about the arithmetic and the wrappers
+	constexpr size_t Count = 1024;
+
+	// A million particles, well out of cache, so memory traffic dominates
+	constexpr size_t ParticleCount = 1 << 20;
+
+	std::vector<Vector3> RandomVectors(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> value(-10.f, 10.f);
+
+		std::vector<Vector3> result(count);
+		for (Vector3& V : result)
+			V = Vector3(value(random), value(random), value(random));
+		return result;
+	}
+
+	Vector3Stream RandomStream(size_t count, unsigned seed)
+	{
+		return Vector3Stream(RandomVectors(count, seed));
+	}
+
+	XMFLOAT3 Store(FXMVECTOR V) noexcept
+	{
+		XMFLOAT3 R;
+		XMStoreFloat3(&R, V);
+		return R;
+	}
+}
+
+PMATH_BENCHMARK(LazyExpressions)
+{
+	const std::vector<Vector3> a = RandomVectors(Count, 1);
+	const std::vector<Vector3> b = RandomVectors(Count, 2);
+	const std::vector<Vector3> c = RandomVectors(Count, 3);
+	const float s = 0.75f;
+	std::vector<Vector3> result(Count);
+	std::vector<XMFLOAT3> raw(Count);
+
+	state.Measure("a * s + b - c eager", Count, Benchmarks::Loop(result, [&](size_t i) { return a[i] * s + b[i] - c[i]; }));
+	state.Compare("a * s + b - c lazy", Count,
+		Benchmarks::Loop(result, [&](size_t i) -> Vector3 { return Lazy::Of(a[i]) * s + b[i] - c[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) {
+			return Store(XMVectorSubtract(XMVectorMultiplyAdd(XMLoadFloat3(&a[i]), XMVectorReplicate(s), XMLoadFloat3(&b[i])), XMLoadFloat3(&c[i])));
+		}));
+
+	state.Measure("(a + b) * (c - a) * s eager", Count, Benchmarks::Loop(result, [&](size_t i) { return (a[i] + b[i]) * (c[i] - a[i]) * s; }));
+	state.Measure("(a + b) * (c - a) * s lazy", Count,
+		Benchmarks::Loop(result, [&](size_t i) -> Vector3 { return (Lazy::Of(a[i]) + b[i]) * (Lazy::Of(c[i]) - a[i]) * s; }));
+}
+
+PMATH_BENCHMARK(LazyIntegrator)
+{
+	// Semi-implicit Euler: v += (f * inverseMass + g) * dt, x += v * dt
+	Vector3Stream positions = RandomStream(ParticleCount, 1);
+	Vector3Stream velocities = RandomStream(ParticleCount, 2);
+	const Vector3Stream forces = RandomStream(ParticleCount, 3);
+	const std::vector<float> inverseMasses(ParticleCount, 0.5f);
+	const Vector3 gravity(0.f, -9.81f, 0.f);
+	const float dt = 1.f / 60.f;
+	Vector3Stream scratch(ParticleCount);
+	Vector3Stream gravityStream(std::vector<Vector3>(ParticleCount, gravity));
+
+	state.Measure("Vector3Stream batch operations", ParticleCount, [&] {
+		for (size_t i = 0; i < ParticleCount; ++i)
+		{
+			scratch.x[i] = forces.x[i] * inverseMasses[i];
+			scratch.y[i] = forces.y[i] * inverseMasses[i];
+			scratch.z[i] = forces.z[i] * inverseMasses[i];
+		}
+		Vector3Stream::Add(scratch, gravityStream, scratch);
+		Vector3Stream::Scale(scratch, dt, scratch);
+		Vector3Stream::Add(velocities, scratch, velocities);
+		Vector3Stream::Scale(velocities, dt, scratch);
+		Vector3Stream::Add(positions, scratch, positions);
+		Benchmarks::DoNotOptimize(positions.x.data());
+	});
+	state.Measure("Lazy::Store", ParticleCount, [&] {
+		Lazy::Store(Lazy::Of(velocities) + (Lazy::Of(forces) * Lazy::Of(inverseMasses) + gravity) * dt, velocities);
+		Lazy::Store(Lazy::Of(velocities) * dt + positions, positions);
+		Benchmarks::DoNotOptimize(positions.x.data());
+	});
+	state.Measure("Lazy::Store parallel", ParticleCount, [&] {
+		Lazy::Store(Parallel::par, Lazy::Of(velocities) + (Lazy::Of(forces) * Lazy::Of(inverseMasses) + gravity) * dt, velocities);
+		Lazy::Store(Parallel::par, Lazy::Of(velocities) * dt + positions, positions);
+		Benchmarks::DoNotOptimize(positions.x.data());
+	});
+}
@@ -0,0 +1,189 @@
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../PMath.inl"
+#include "../PMathBounds.h"
+#include "../PMathStream.h"
+
+using namespace PMgene::Math;
+
+namespace
+{
+	// Small enough to stay in L1, so the numbers are about the arithmetic and the wrappers
+	constexpr size_t Count = 1024;
+
+	// Agents, particles or rays per frame
+	constexpr size_t StreamCount = 100000;
+
+	std::vector<float> RandomScalars(size_t count, unsigned seed, float low = -10.f, float high = 10.f)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> value(low, high);
+
+		std::vector<float> result(count);
+		for (float& S : result)
+			S = value(random);
+		return result;
+	}
+
+	std::vector<Vector2> RandomVector2s(size_t count, unsigned seed)
+	{
+		const std::vector<float> s = RandomScalars(2 * count, seed);
+
+		std::vector<Vector2> result(count);
+		for (size_t i = 0; i < count; ++i)
+			result[i] = Vector2(s[2 * i], s[2 * i + 1]);
+		return result;
+	}
+
+	std::vector<Vector3> RandomVector3s(size_t count, unsigned seed)
+	{
+		const std::vector<float> s = RandomScalars(3 * count, seed);
+
+		std::vector<Vector3> result(count);
+		for (size_t i = 0; i < count; ++i)
+			result[i] = Vector3(s[3 * i], s[3 * i + 1], s[3 * i + 2]);
+		return result;
+	}
+
+	std::vector<Vector4> RandomVector4s(size_t count, unsigned seed)
+	{
+		const std::vector<float> s = RandomScalars(4 * count, seed);
+
+		std::vector<Vector4> result(count);
+		for (size_t i = 0; i < count; ++i)
+			result[i] = Vector4(s[4 * i], s[4 * i + 1], s[4 * i + 2], s[4 * i + 3]);
+		return result;
+	}
+
+	XMFLOAT2 Store2(FXMVECTOR V) noexcept
+	{
+		XMFLOAT2 R;
+		XMStoreFloat2(&R, V);
+		return R;
+	}
+
+	XMFLOAT4 Store4(FXMVECTOR V) noexcept
+	{
+		XMFLOAT4 R;
+		XMStoreFloat4(&R, V);
+		return R;
+	}
+}
+
+PMATH_BENCHMARK(Vector2Operations)
+{
+	const std::vector<Vector2> a = RandomVector2s(Count, 1);
+	const std::vector<Vector2> b = RandomVector2s(Count, 2);
+	std::vector<Vector2> result(Count);
+	std::vector<XMFLOAT2> raw(Count);
+	std::vector<float> scalars(Count);
+
+	state.Compare("operator+", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] + b[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store2(XMVectorAdd(XMLoadFloat2(&a[i]), XMLoadFloat2(&b[i]))); }));
+	state.Compare("Dot", Count,
+		Benchmarks::Loop(scalars, [&](size_t i) { return a[i].Dot(b[i]); }),
+		Benchmarks::Loop(scalars, [&](size_t i) { return XMVectorGetX(XMVector2Dot(XMLoadFloat2(&a[i]), XMLoadFloat2(&b[i]))); }));
+	state.Compare("Cross", Count,
+		Benchmarks::Loop(scalars, [&](size_t i) { return a[i].Cross(b[i]); }),
+		Benchmarks::Loop(scalars, [&](size_t i) { return XMVectorGetX(XMVector2Cross(XMLoadFloat2(&a[i]), XMLoadFloat2(&b[i]))); }));
+	state.Compare("Length", Count,
+		Benchmarks::Loop(scalars, [&](size_t i) { return a[i].Length(); }),
+		Benchmarks::Loop(scalars, [&](size_t i) { return XMVectorGetX(XMVector2Length(XMLoadFloat2(&a[i]))); }));
+	state.Compare("Normalize", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Vector2 R; a[i].Normalize(R); return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store2(XMVector2Normalize(XMLoadFloat2(&a[i]))); }));
+}
+
+PMATH_BENCHMARK(Vector4Operations)
+{
+	const std::vector<Vector4> a = RandomVector4s(Count, 3);
+	const std::vector<Vector4> b = RandomVector4s(Count, 4);
+	const Matrix M = Matrix::CreatePerspectiveFieldOfView(1.f, 1.5f, 0.1f, 100.f);
+	std::vector<Vector4> result(Count);
+	std::vector<XMFLOAT4> raw(Count);
+	std::vector<float> scalars(Count);
+
+	state.Compare("operator+", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] + b[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store4(XMVectorAdd(XMLoadFloat4(&a[i]), XMLoadFloat4(&b[i]))); }));
+	state.Compare("Dot", Count,
+		Benchmarks::Loop(scalars, [&](size_t i) { return a[i].Dot(b[i]); }),
+		Benchmarks::Loop(scalars, [&](size_t i) { return XMVectorGetX(XMVector4Dot(XMLoadFloat4(&a[i]), XMLoadFloat4(&b[i]))); }));
+	state.Compare("Length", Count,
+		Benchmarks::Loop(scalars, [&](size_t i) { return a[i].Length(); }),
+		Benchmarks::Loop(scalars, [&](size_t i) { return XMVectorGetX(XMVector4Length(XMLoadFloat4(&a[i]))); }));
+	state.Compare("Normalize", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Vector4 R; a[i].Normalize(R); return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store4(XMVector4Normalize(XMLoadFloat4(&a[i]))); }));
+	state.Compare("Matrix::Transform", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return M.Transform(a[i]); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store4(XMVector4Transform(XMLoadFloat4(&a[i]), XMLoadFloat4x4(&M))); }));
+}
+
+PMATH_BENCHMARK(GeometryStreams)
+{
+	const std::vector<Vector2> headings = RandomVector2s(StreamCount, 5);
+	const std::vector<Vector4> a = RandomVector4s(StreamCount, 6);
+	const std::vector<Vector4> b = RandomVector4s(StreamCount, 7);
+	const std::vector<Vector3> points = RandomVector3s(StreamCount, 8);
+	const std::vector<Vector3> directions = RandomVector3s(StreamCount, 9);
+	std::vector<Vector2> normals(StreamCount);
+	std::vector<float> scalars(StreamCount);
+
+	const Vector2Stream headingStream(headings);
+	Vector2Stream normalStream(StreamCount);
+	const Vector4Stream first(a);
+	const Vector4Stream second(b);
+	const Vector3Stream pointStream(points);
+
+	std::vector<Ray> rays(StreamCount);
+	for (size_t i = 0; i < StreamCount; ++i)
+		rays[i] = Ray(points[i], directions[i]);
+	const RayStream rayStream(rays);
+
+	Plane plane(0.3f, 0.9f, -0.3f, 2.f);
+	plane.Normalize();
+	const BoundingSphere sphere(Vector3(1.f, 2.f, 3.f), 4.f);
+
+	state.Measure("Vector2 Normalize scalar", StreamCount,
+		Benchmarks::Loop(normals, [&](size_t i) { Vector2 R; headings[i].Normalize(R); return R; }));
+	state.Measure("Vector2Stream::Normalize", StreamCount, [&] {
+		Vector2Stream::Normalize(headingStream, normalStream);
+		Benchmarks::DoNotOptimize(normalStream.x.data());
+	});
+
+	state.Measure("Vector4 Dot scalar", StreamCount, Benchmarks::Loop(scalars, [&](size_t i) { return a[i].Dot(b[i]); }));
+	state.Measure("Vector4Stream::Dot", StreamCount, [&] {
+		Vector4Stream::Dot(first, second, scalars);
+		Benchmarks::DoNotOptimize(scalars.data());
+	});
+
+	state.Measure("Plane distance scalar", StreamCount, Benchmarks::Loop(scalars, [&](size_t i) { return plane.Distance(points[i]); }));
+	state.Measure("Plane distance batch", StreamCount, [&] {
+		plane.Distance(pointStream, scalars);
+		Benchmarks::DoNotOptimize(scalars.data());
+	});
+
+	state.Measure("Ray-plane scalar", StreamCount, Benchmarks::Loop(scalars, [&](size_t i) {
+		float distance = FLT_MAX;
+		rays[i].Intersects(plane, distance);
+		return distance;
+	}));
+	state.Measure("Ray-plane batch", StreamCount, [&] {
+		rayStream.Intersects(plane, scalars);
+		Benchmarks::DoNotOptimize(scalars.data());
+	});
+
+	state.Measure("Ray-sphere scalar", StreamCount, Benchmarks::Loop(scalars, [&](size_t i) {
+		float distance = FLT_MAX;
+		rays[i].Intersects(sphere, distance);
+		return distance;
+	}));
+	state.Measure("Ray-sphere batch", StreamCount, [&] {
+		rayStream.Intersects(sphere, scalars);
+		Benchmarks::DoNotOptimize(scalars.data());
+	});
+}
@@ -0,0 +1,123 @@
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../PMath.inl"
+#include "../PMathCpu.h"
+#include "../PMathIntersection.h"
+#include "../PMathParallel.h"
+
+using namespace PMgene::Math;
+
+namespace
+{
+	// A character-sized mesh of 2 * GridSize^2 triangles, tested without a BVH
+	constexpr uint32_t GridSize = 24;
+	constexpr size_t BoxCount = 1024;
+	constexpr size_t RayCount = 1 << 12;
+
+	TriangleStream Terrain()
+	{
+		std::vector<Vector3> vertices;
+		for (uint32_t z = 0; z <= GridSize; ++z)
+		{
+			for (uint32_t x = 0; x <= GridSize; ++x)
+			{
+				const float height = std::sin(0.5f * x) * std::cos(0.6f * z);
+				vertices.emplace_back(static_cast<float>(x), height, static_cast<float>(z));
+			}
+		}
+
+		std::vector<uint32_t> indices;
+		for (uint32_t z = 0; z < GridSize; ++z)
+		{
+			for (uint32_t x = 0; x < GridSize; ++x)
+			{
+				const uint32_t a = z * (GridSize + 1) + x;
+				const uint32_t b = a + GridSize + 1;
+				indices.insert(indices.end(), { a, a + 1, b, a + 1, b + 1, b });
+			}
+		}
+		return TriangleStream(vertices, indices);
+	}
+
+	AABBStream ScatteredBoxes()
+	{
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> position(0.f, static_cast<float>(GridSize));
+
+		std::vector<AABB> boxes(BoxCount);
+		for (AABB& box : boxes)
+		{
+			const Vector3 center(position(random), 0.f, position(random));
+			box = AABB(center - Vector3(0.3f, 1.f, 0.3f), center + Vector3(0.3f, 1.f, 0.3f));
+		}
+		return AABBStream(boxes);
+	}
+
+	// Bullet traces fanning out from one muzzle, neighbouring rays sharing a packet
+	std::vector<Ray> FanRays()
+	{
+		constexpr size_t Width = 64;
+		const Vector3 origin(GridSize * 0.5f, 8.f, -4.f);
+
+		std::vector<Ray> rays;
+		rays.reserve(RayCount);
+		for (size_t y = 0; y < RayCount / Width; ++y)
+		{
+			for (size_t x = 0; x < Width; ++x)
+			{
+				Vector3 direction(static_cast<float>(x) / Width - 0.5f, -0.2f - 0.6f * static_cast<float>(y) * Width / RayCount, 1.f);
+				direction.Normalize();
+				rays.emplace_back(origin, direction);
+			}
+		}
+		return rays;
+	}
+
+	template <typename Stream>
+	void MeasureRaycast(Benchmarks::State& state, const char* name, const Stream& stream, const std::vector<Ray>& rays)
+	{
+		std::vector<RayHit> hits(rays.size());
+		const size_t tests = rays.size() * stream.Size();
+		const std::string prefix(name);
+
+		SetSimdLevel(SimdLevel::Scalar);
+		state.Measure(prefix + " generic", tests, [&] {
+			stream.Raycast(rays, hits);
+			Benchmarks::DoNotOptimize(hits.data());
+		});
+
+		if (GetSupportedSimdLevel() >= SimdLevel::AVX2)
+		{
+			SetSimdLevel(SimdLevel::AVX2);
+			state.Measure(prefix + " AVX2", tests, [&] {
+				stream.Raycast(rays, hits);
+				Benchmarks::DoNotOptimize(hits.data());
+			});
+			state.Measure(prefix + " packets AVX2", tests, [&] {
+				stream.RaycastPackets(rays, hits);
+				Benchmarks::DoNotOptimize(hits.data());
+			});
+		}
+
+		SetSimdLevel(GetSupportedSimdLevel());
+		state.Measure(prefix + " packets parallel", tests, [&] {
+			stream.RaycastPackets(Parallel::par, rays, hits);
+			Benchmarks::DoNotOptimize(hits.data());
+		});
+	}
+}
+
+// Items are ray-primitive tests
+PMATH_BENCHMARK(RayTriangles)
+{
+	MeasureRaycast(state, "Triangles", Terrain(), FanRays());
+}
+
+PMATH_BENCHMARK(RayBoxes)
+{
+	MeasureRaycast(state, "Boxes", ScatteredBoxes(), FanRays());
+}
@@ -0,0 +1,342 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../PMath.inl"
+#include "../PMathBounds.h"
+#include "../PMathCpu.h"
+#include "../PMathParallel.h"
+
+using namespace PMgene::Math;
+
+namespace
+{
+	// A typical scene's worth of dynamic bodies
+	constexpr size_t BodyCount = 50000;
+
+	// Single operations run over L1-sized arrays
+	constexpr size_t Count = 256;
+
+	// Convex pieces of a fractured mesh, each fitted with its own box
+	constexpr size_t PieceCount = 4096;
+	constexpr size_t PointsPerPiece = 64;
+
+	std::vector<Quaternion> RandomRotations(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+
+		std::vector<Quaternion> result(count);
+		for (Quaternion& Q : result)
+			Q = Quaternion::CreateFromYawPitchRoll(angle(random), angle(random), angle(random));
+		return result;
+	}
+
+	std::vector<Matrix3> RandomMatrices(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> value(-2.f, 2.f);
+
+		std::vector<Matrix3> result(count);
+		for (Matrix3& M : result)
+			M = Matrix3(value(random), value(random), value(random),
+			            value(random), value(random), value(random),
+			            value(random), value(random), value(random));
+		return result;
+	}
+
+	// Rotation matrices and diagonal body-space inertia tensors, as a physics step holds them
+	std::vector<Matrix3> RotationMatrices(size_t count, unsigned seed)
+	{
+		const std::vector<Quaternion> rotations = RandomRotations(count, seed);
+		std::vector<Matrix3> result(count);
+		for (size_t i = 0; i < count; ++i)
+			result[i] = Matrix3::CreateFromQuaternion(rotations[i]);
+		return result;
+	}
+
+	std::vector<Matrix3> InertiaTensors(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> moment(0.1f, 10.f);
+
+		std::vector<Matrix3> result(count);
+		for (Matrix3& M : result)
+			M = Matrix3::CreateScale(Vector3(moment(random), moment(random), moment(random)));
+		return result;
+	}
+
+	std::vector<Vector3> RandomVectors(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> value(-10.f, 10.f);
+
+		std::vector<Vector3> result(count);
+		for (Vector3& V : result)
+			V = Vector3(value(random), value(random), value(random));
+		return result;
+	}
+
+	std::vector<float> RandomScalars(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> value(0.5f, 2.f);
+
+		std::vector<float> result(count);
+		for (float& S : result)
+			S = value(random);
+		return result;
+	}
+
+	XMFLOAT3X3 Store(FXMMATRIX M) noexcept
+	{
+		XMFLOAT3X3 R;
+		XMStoreFloat3x3(&R, M);
+		return R;
+	}
+
+	XMFLOAT3 Store(FXMVECTOR V) noexcept
+	{
+		XMFLOAT3 R;
+		XMStoreFloat3(&R, V);
+		return R;
+	}
+
+	// The element-wise operators apply one vector operation to each row
+	template <typename Operation>
+	XMFLOAT3X3 PerRow(const XMFLOAT3X3& A, const XMFLOAT3X3& B, Operation operation) noexcept
+	{
+		const XMMATRIX X = XMLoadFloat3x3(&A);
+		const XMMATRIX Y = XMLoadFloat3x3(&B);
+		return Store(XMMATRIX(operation(X.r[0], Y.r[0]), operation(X.r[1], Y.r[1]), operation(X.r[2], Y.r[2]), X.r[3]));
+	}
+
+	bool EqualRows(const XMFLOAT3X3& A, const XMFLOAT3X3& B) noexcept
+	{
+		const XMMATRIX X = XMLoadFloat3x3(&A);
+		const XMMATRIX Y = XMLoadFloat3x3(&B);
+		return XMVector3Equal(X.r[0], Y.r[0]) && XMVector3Equal(X.r[1], Y.r[1]) && XMVector3Equal(X.r[2], Y.r[2]);
+	}
+}
+
+PMATH_BENCHMARK(Matrix3Operations)
+{
+	const std::vector<Matrix3> a = RandomMatrices(Count, 1);
+	const std::vector<Matrix3> b = RandomMatrices(Count, 2);
+	const std::vector<Vector3> v = RandomVectors(Count, 3);
+	const std::vector<Quaternion> rotations = RandomRotations(Count, 4);
+	const std::vector<float> s = RandomScalars(Count, 5);
+	std::vector<Matrix3> result(Count);
+	std::vector<XMFLOAT3X3> raw(Count);
+	std::vector<Vector3> vectors(Count);
+	std::vector<XMFLOAT3> rawVectors(Count);
+	std::vector<float> scalars(Count);
+	std::vector<uint8_t> flags(Count);
+
+	state.Compare("operator==", Count,
+		Benchmarks::Loop(flags, [&](size_t i) { return uint8_t(a[i] == b[i]); }),
+		Benchmarks::Loop(flags, [&](size_t i) { return uint8_t(EqualRows(a[i], b[i])); }));
+	state.Compare("operator!=", Count,
+		Benchmarks::Loop(flags, [&](size_t i) { return uint8_t(a[i] != b[i]); }),
+		Benchmarks::Loop(flags, [&](size_t i) { return uint8_t(!EqualRows(a[i], b[i])); }));
+
+	state.Compare("operator+=", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Matrix3 R = a[i]; R += b[i]; return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return PerRow(a[i], b[i], [](FXMVECTOR x, FXMVECTOR y) { return XMVectorAdd(x, y); }); }));
+	state.Compare("operator-=", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Matrix3 R = a[i]; R -= b[i]; return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return PerRow(a[i], b[i], [](FXMVECTOR x, FXMVECTOR y) { return XMVectorSubtract(x, y); }); }));
+	state.Compare("operator*= matrix", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Matrix3 R = a[i]; R *= b[i]; return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixMultiply(XMLoadFloat3x3(&a[i]), XMLoadFloat3x3(&b[i]))); }));
+	state.Compare("operator*= scalar", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Matrix3 R = a[i]; R *= s[i]; return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return PerRow(a[i], a[i], [&](FXMVECTOR x, FXMVECTOR) { return XMVectorScale(x, s[i]); }); }));
+
+	state.Compare("operator- unary", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return -a[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return PerRow(a[i], a[i], [](FXMVECTOR x, FXMVECTOR) { return XMVectorNegate(x); }); }));
+
+	state.Compare("operator+", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] + b[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return PerRow(a[i], b[i], [](FXMVECTOR x, FXMVECTOR y) { return XMVectorAdd(x, y); }); }));
+	state.Compare("operator-", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] - b[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return PerRow(a[i], b[i], [](FXMVECTOR x, FXMVECTOR y) { return XMVectorSubtract(x, y); }); }));
+	state.Compare("operator* matrix", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] * b[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixMultiply(XMLoadFloat3x3(&a[i]), XMLoadFloat3x3(&b[i]))); }));
+	state.Compare("operator* scalar", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] * s[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return PerRow(a[i], a[i], [&](FXMVECTOR x, FXMVECTOR) { return XMVectorScale(x, s[i]); }); }));
+	state.Compare("operator* scalar first", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return s[i] * a[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return PerRow(a[i], a[i], [&](FXMVECTOR x, FXMVECTOR) { return XMVectorScale(x, s[i]); }); }));
+
+	state.Compare("Transpose", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i].Transpose(); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixTranspose(XMLoadFloat3x3(&a[i]))); }));
+	state.Compare("Transpose to result", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Matrix3 R; a[i].Transpose(R); return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixTranspose(XMLoadFloat3x3(&a[i]))); }));
+	state.Compare("Invert", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i].Invert(); }),
+		Benchmarks::Loop(raw, [&](size_t i) { XMVECTOR det; return Store(XMMatrixInverse(&det, XMLoadFloat3x3(&a[i]))); }));
+	state.Compare("Invert to result", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Matrix3 R; a[i].Invert(R); return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { XMVECTOR det; return Store(XMMatrixInverse(&det, XMLoadFloat3x3(&a[i]))); }));
+	state.Compare("Determinant", Count,
+		Benchmarks::Loop(scalars, [&](size_t i) { return a[i].Determinant(); }),
+		Benchmarks::Loop(scalars, [&](size_t i) { return XMVectorGetX(XMMatrixDeterminant(XMLoadFloat3x3(&a[i]))); }));
+
+	state.Compare("Transform", Count,
+		Benchmarks::Loop(vectors, [&](size_t i) { return a[i].Transform(v[i]); }),
+		Benchmarks::Loop(rawVectors, [&](size_t i) { return Store(XMVector3TransformNormal(XMLoadFloat3(&v[i]), XMLoadFloat3x3(&a[i]))); }));
+	state.Compare("CreateFromQuaternion", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix3::CreateFromQuaternion(rotations[i]); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixRotationQuaternion(XMLoadFloat4(&rotations[i]))); }));
+	state.Compare("CreateScale", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix3::CreateScale(v[i]); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixScalingFromVector(XMLoadFloat3(&v[i]))); }));
+
+	std::vector<Matrix> wide(Count);
+	std::vector<XMFLOAT4X4> rawWide(Count);
+	state.Compare("ToMatrix", Count,
+		Benchmarks::Loop(wide, [&](size_t i) { return a[i].ToMatrix(); }),
+		Benchmarks::Loop(rawWide, [&](size_t i) { XMFLOAT4X4 R; XMStoreFloat4x4(&R, XMLoadFloat3x3(&a[i])); return R; }));
+	state.Compare("Matrix3(Matrix)", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix3(wide[i]); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMLoadFloat4x4(&wide[i])); }));
+}
+
+PMATH_BENCHMARK(Matrix3RotateBatch)
+{
+	const std::vector<Matrix3> rotations = RotationMatrices(BodyCount, 5);
+	const std::vector<Matrix3> tensors = InertiaTensors(BodyCount, 6);
+	std::vector<Matrix3> result(BodyCount);
+	std::vector<XMFLOAT3X3> raw(BodyCount);
+
+	state.Compare("operator* loop", BodyCount,
+		Benchmarks::Loop(result, [&](size_t i) { return rotations[i].Transpose() * tensors[i] * rotations[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) {
+			const XMMATRIX R = XMLoadFloat3x3(&rotations[i]);
+			return Store(XMMatrixMultiply(XMMatrixTranspose(R), XMMatrixMultiply(XMLoadFloat3x3(&tensors[i]), R)));
+		}));
+
+	SetSimdLevel(SimdLevel::Scalar);
+	state.Measure("RotateBatch generic", BodyCount, [&] {
+		Matrix3::RotateBatch(rotations, tensors, result);
+		Benchmarks::DoNotOptimize(result.data());
+	});
+	state.Measure("MultiplyBatch generic", BodyCount, [&] {
+		Matrix3::MultiplyBatch(rotations, tensors, result);
+		Benchmarks::DoNotOptimize(result.data());
+	});
+
+	if (GetSupportedSimdLevel() >= SimdLevel::AVX2)
+	{
+		SetSimdLevel(SimdLevel::AVX2);
+		state.Measure("RotateBatch AVX2", BodyCount, [&] {
+			Matrix3::RotateBatch(rotations, tensors, result);
+			Benchmarks::DoNotOptimize(result.data());
+		});
+		state.Measure("MultiplyBatch AVX2", BodyCount, [&] {
+			Matrix3::MultiplyBatch(rotations, tensors, result);
+			Benchmarks::DoNotOptimize(result.data());
+		});
+	}
+
+	SetSimdLevel(GetSupportedSimdLevel());
+	state.Measure("RotateBatch parallel", BodyCount, [&] {
+		Matrix3::RotateBatch(Parallel::par, rotations, tensors, result);
+		Benchmarks::DoNotOptimize(result.data());
+	});
+}
+
+PMATH_BENCHMARK(Matrix3EigenSymmetricBatch)
+{
+	// World-space inertia tensors: symmetric with well-separated eigenvalues
+	const std::vector<Matrix3> rotations = RotationMatrices(BodyCount, 7);
+	std::vector<Matrix3> tensors = InertiaTensors(BodyCount, 8);
+	Matrix3::RotateBatch(rotations, tensors, tensors);
+
+	std::vector<Vector3> eigenvalues(BodyCount);
+	std::vector<Matrix3> eigenvectors(BodyCount);
+
+	// DirectXMath has no eigen-solver
+	state.Measure("EigenSymmetric loop", BodyCount, [&] {
+		for (size_t i = 0; i < BodyCount; ++i)
+			tensors[i].EigenSymmetric(eigenvalues[i], eigenvectors[i]);
+		Benchmarks::DoNotOptimize(eigenvectors.data());
+	});
+
+	SetSimdLevel(SimdLevel::Scalar);
+	state.Measure("EigenSymmetricBatch generic", BodyCount, [&] {
+		Matrix3::EigenSymmetricBatch(tensors, eigenvalues, eigenvectors);
+		Benchmarks::DoNotOptimize(eigenvectors.data());
+	});
+
+	if (GetSupportedSimdLevel() >= SimdLevel::AVX2)
+	{
+		SetSimdLevel(SimdLevel::AVX2);
+		state.Measure("EigenSymmetricBatch AVX2", BodyCount, [&] {
+			Matrix3::EigenSymmetricBatch(tensors, eigenvalues, eigenvectors);
+			Benchmarks::DoNotOptimize(eigenvectors.data());
+		});
+	}
+
+	SetSimdLevel(GetSupportedSimdLevel());
+	state.Measure("EigenSymmetricBatch parallel", BodyCount, [&] {
+		Matrix3::EigenSymmetricBatch(Parallel::par, tensors, eigenvalues, eigenvectors);
+		Benchmarks::DoNotOptimize(eigenvectors.data());
+	});
+}
+
+PMATH_BENCHMARK(OBBCreateFromPoints)
+{
+	std::mt19937 random(9);
+	std::uniform_real_distribution<float> value(-1.f, 1.f);
+	const std::vector<Matrix3> rotations = RotationMatrices(PieceCount, 10);
+
+	// Elongated point clouds, so the fitted axes are well defined
+	std::vector<Vector3> points(PieceCount * PointsPerPiece);
+	std::vector<uint32_t> offsets(PieceCount + 1);
+	for (size_t piece = 0; piece < PieceCount; ++piece)
+	{
+		offsets[piece] = uint32_t(piece * PointsPerPiece);
+		for (size_t i = 0; i < PointsPerPiece; ++i)
+			points[piece * PointsPerPiece + i] = rotations[piece].Transform(Vector3(4.f * value(random), 2.f * value(random), value(random)));
+	}
+	offsets[PieceCount] = uint32_t(points.size());
+
+	std::vector<OBB> boxes(PieceCount);
+
+	// DirectXMath's BoundingOrientedBox lives in DirectXCollision.h, which is not a dependency
+	state.Measure("CreateFromPoints loop", PieceCount, [&] {
+		for (size_t piece = 0; piece < PieceCount; ++piece)
+			boxes[piece] = OBB::CreateFromPoints(std::span(points).subspan(offsets[piece], PointsPerPiece));
+		Benchmarks::DoNotOptimize(boxes.data());
+	});
+
+	SetSimdLevel(SimdLevel::Scalar);
+	state.Measure("CreateFromPointsBatch generic", PieceCount, [&] {
+		OBB::CreateFromPointsBatch(points, offsets, boxes);
+		Benchmarks::DoNotOptimize(boxes.data());
+	});
+
+	if (GetSupportedSimdLevel() >= SimdLevel::AVX2)
+	{
+		SetSimdLevel(SimdLevel::AVX2);
+		state.Measure("CreateFromPointsBatch AVX2", PieceCount, [&] {
+			OBB::CreateFromPointsBatch(points, offsets, boxes);
+			Benchmarks::DoNotOptimize(boxes.data());
+		});
+	}
+
+	SetSimdLevel(GetSupportedSimdLevel());
+	state.Measure("CreateFromPointsBatch parallel", PieceCount, [&] {
+		OBB::CreateFromPointsBatch(Parallel::par, points, offsets, boxes);
+		Benchmarks::DoNotOptimize(boxes.data());
+	});
+}
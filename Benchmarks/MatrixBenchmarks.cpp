@@ -0,0 +1,460 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../PMath.inl"
+#include "../PMathCpu.h"
+#include "../PMathParallel.h"
+#include "../PMathStream.h"
+
+using namespace PMgene::Math;
+
+namespace
+{
+	// Roughly the node count of a large scene graph
+	constexpr size_t MatrixCount = 200000;
+
+	// Single operations run over L1-sized arrays
+	constexpr size_t Count = 256;
+
+	// Vertices of a large mesh
+	constexpr size_t PointCount = 100000;
+
+	std::vector<Matrix> RandomMatrices(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+		std::uniform_real_distribution<float> offset(-100.f, 100.f);
+
+		std::vector<Matrix> result(count);
+		for (Matrix& M : result)
+			M = Matrix::CreateFromYawPitchRoll(angle(random), angle(random), angle(random)) *
+				Matrix::CreateTranslation(offset(random), offset(random), offset(random));
+		return result;
+	}
+
+	std::vector<Vector3> RandomVectors(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> value(0.5f, 10.f);
+
+		std::vector<Vector3> result(count);
+		for (Vector3& V : result)
+			V = Vector3(value(random), value(random), value(random));
+		return result;
+	}
+
+	std::vector<float> RandomScalars(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> value(0.5f, 2.f);
+
+		std::vector<float> result(count);
+		for (float& S : result)
+			S = value(random);
+		return result;
+	}
+
+	XMFLOAT4X4 Store(FXMMATRIX M) noexcept
+	{
+		XMFLOAT4X4 R;
+		XMStoreFloat4x4(&R, M);
+		return R;
+	}
+
+	XMFLOAT3 Store(FXMVECTOR V) noexcept
+	{
+		XMFLOAT3 R;
+		XMStoreFloat3(&R, V);
+		return R;
+	}
+
+	// The element-wise operators apply one vector operation to each row
+	template <typename Operation>
+	XMFLOAT4X4 PerRow(const XMFLOAT4X4& A, const XMFLOAT4X4& B, Operation operation) noexcept
+	{
+		const XMMATRIX X = XMLoadFloat4x4(&A);
+		const XMMATRIX Y = XMLoadFloat4x4(&B);
+		return Store(XMMATRIX(operation(X.r[0], Y.r[0]), operation(X.r[1], Y.r[1]), operation(X.r[2], Y.r[2]), operation(X.r[3], Y.r[3])));
+	}
+
+	bool EqualRows(const XMFLOAT4X4& A, const XMFLOAT4X4& B) noexcept
+	{
+		const XMMATRIX X = XMLoadFloat4x4(&A);
+		const XMMATRIX Y = XMLoadFloat4x4(&B);
+		return XMVector4Equal(X.r[0], Y.r[0]) && XMVector4Equal(X.r[1], Y.r[1]) &&
+		       XMVector4Equal(X.r[2], Y.r[2]) && XMVector4Equal(X.r[3], Y.r[3]);
+	}
+}
+
+PMATH_BENCHMARK(MatrixMultiplyBatch)
+{
+	const std::vector<Matrix> a = RandomMatrices(MatrixCount, 1);
+	const std::vector<Matrix> b = RandomMatrices(MatrixCount, 2);
+	std::vector<Matrix> result(MatrixCount);
+	std::vector<XMFLOAT4X4> raw(MatrixCount);
+
+	state.Compare("operator* loop", MatrixCount,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] * b[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixMultiply(XMLoadFloat4x4(&a[i]), XMLoadFloat4x4(&b[i]))); }));
+
+	SetSimdLevel(SimdLevel::Scalar);
+	state.Measure("MultiplyBatch generic", MatrixCount, [&] {
+		Matrix::MultiplyBatch(a, b, result);
+		Benchmarks::DoNotOptimize(result.data());
+	});
+
+	if (GetSupportedSimdLevel() >= SimdLevel::AVX2)
+	{
+		SetSimdLevel(SimdLevel::AVX2);
+		state.Measure("MultiplyBatch AVX2", MatrixCount, [&] {
+			Matrix::MultiplyBatch(a, b, result);
+			Benchmarks::DoNotOptimize(result.data());
+		});
+	}
+
+	SetSimdLevel(GetSupportedSimdLevel());
+	state.Measure("MultiplyBatch parallel", MatrixCount, [&] {
+		Matrix::MultiplyBatch(Parallel::par, a, b, result);
+		Benchmarks::DoNotOptimize(result.data());
+	});
+}
+
+PMATH_BENCHMARK(MatrixMultiplyBroadcast)
+{
+	const std::vector<Matrix> local = RandomMatrices(MatrixCount, 3);
+	const Matrix parent = RandomMatrices(1, 4)[0];
+	std::vector<Matrix> result(MatrixCount);
+	std::vector<XMFLOAT4X4> raw(MatrixCount);
+
+	state.Compare("operator* loop", MatrixCount,
+		Benchmarks::Loop(result, [&](size_t i) { return local[i] * parent; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixMultiply(XMLoadFloat4x4(&local[i]), XMLoadFloat4x4(&parent))); }));
+
+	SetSimdLevel(SimdLevel::Scalar);
+	state.Measure("MultiplyBatch generic", MatrixCount, [&] {
+		Matrix::MultiplyBatch(local, parent, result);
+		Benchmarks::DoNotOptimize(result.data());
+	});
+
+	if (GetSupportedSimdLevel() >= SimdLevel::AVX2)
+	{
+		SetSimdLevel(SimdLevel::AVX2);
+		state.Measure("MultiplyBatch AVX2", MatrixCount, [&] {
+			Matrix::MultiplyBatch(local, parent, result);
+			Benchmarks::DoNotOptimize(result.data());
+		});
+	}
+}
+
+PMATH_BENCHMARK(MatrixOperators)
+{
+	const std::vector<Matrix> a = RandomMatrices(Count, 5);
+	const std::vector<Matrix> b = RandomMatrices(Count, 6);
+	const std::vector<float> s = RandomScalars(Count, 7);
+	std::vector<Matrix> result(Count);
+	std::vector<XMFLOAT4X4> raw(Count);
+	std::vector<uint8_t> flags(Count);
+
+	std::vector<XMFLOAT3X3> rotations(Count);
+	std::vector<XMFLOAT4X3> affine(Count);
+	for (size_t i = 0; i < Count; ++i)
+	{
+		XMStoreFloat3x3(&rotations[i], XMLoadFloat4x4(&a[i]));
+		XMStoreFloat4x3(&affine[i], XMLoadFloat4x4(&a[i]));
+	}
+
+	state.Compare("operator==", Count,
+		Benchmarks::Loop(flags, [&](size_t i) { return uint8_t(a[i] == b[i]); }),
+		Benchmarks::Loop(flags, [&](size_t i) { return uint8_t(EqualRows(a[i], b[i])); }));
+	state.Compare("operator!=", Count,
+		Benchmarks::Loop(flags, [&](size_t i) { return uint8_t(a[i] != b[i]); }),
+		Benchmarks::Loop(flags, [&](size_t i) { return uint8_t(!EqualRows(a[i], b[i])); }));
+
+	state.Compare("Matrix(XMFLOAT4X3)", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix(affine[i]); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMLoadFloat4x3(&affine[i])); }));
+	state.Compare("operator= XMFLOAT3X3", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Matrix R; R = rotations[i]; return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMLoadFloat3x3(&rotations[i])); }));
+	state.Compare("operator= XMFLOAT4X3", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Matrix R; R = affine[i]; return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMLoadFloat4x3(&affine[i])); }));
+
+	state.Compare("operator+=", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Matrix R = a[i]; R += b[i]; return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return PerRow(a[i], b[i], [](FXMVECTOR x, FXMVECTOR y) { return XMVectorAdd(x, y); }); }));
+	state.Compare("operator-=", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Matrix R = a[i]; R -= b[i]; return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return PerRow(a[i], b[i], [](FXMVECTOR x, FXMVECTOR y) { return XMVectorSubtract(x, y); }); }));
+	state.Compare("operator*= matrix", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Matrix R = a[i]; R *= b[i]; return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixMultiply(XMLoadFloat4x4(&a[i]), XMLoadFloat4x4(&b[i]))); }));
+	state.Compare("operator*= scalar", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Matrix R = a[i]; R *= s[i]; return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return PerRow(a[i], a[i], [&](FXMVECTOR x, FXMVECTOR) { return XMVectorScale(x, s[i]); }); }));
+	state.Compare("operator/= scalar", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Matrix R = a[i]; R /= s[i]; return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return PerRow(a[i], a[i], [&](FXMVECTOR x, FXMVECTOR) { return XMVectorScale(x, 1.f / s[i]); }); }));
+	state.Compare("operator/= matrix", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Matrix R = a[i]; R /= b[i]; return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return PerRow(a[i], b[i], [](FXMVECTOR x, FXMVECTOR y) { return XMVectorDivide(x, y); }); }));
+
+	state.Compare("operator- unary", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return -a[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return PerRow(a[i], a[i], [](FXMVECTOR x, FXMVECTOR) { return XMVectorNegate(x); }); }));
+
+	state.Compare("operator+", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] + b[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return PerRow(a[i], b[i], [](FXMVECTOR x, FXMVECTOR y) { return XMVectorAdd(x, y); }); }));
+	state.Compare("operator-", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] - b[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return PerRow(a[i], b[i], [](FXMVECTOR x, FXMVECTOR y) { return XMVectorSubtract(x, y); }); }));
+	state.Compare("operator* matrix", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] * b[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixMultiply(XMLoadFloat4x4(&a[i]), XMLoadFloat4x4(&b[i]))); }));
+	state.Compare("operator* scalar", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] * s[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return PerRow(a[i], a[i], [&](FXMVECTOR x, FXMVECTOR) { return XMVectorScale(x, s[i]); }); }));
+	state.Compare("operator* scalar first", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return s[i] * a[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return PerRow(a[i], a[i], [&](FXMVECTOR x, FXMVECTOR) { return XMVectorScale(x, s[i]); }); }));
+	state.Compare("operator/ scalar", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] / s[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return PerRow(a[i], a[i], [&](FXMVECTOR x, FXMVECTOR) { return XMVectorScale(x, 1.f / s[i]); }); }));
+	state.Compare("operator/ matrix", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] / b[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return PerRow(a[i], b[i], [](FXMVECTOR x, FXMVECTOR y) { return XMVectorDivide(x, y); }); }));
+}
+
+PMATH_BENCHMARK(MatrixOperations)
+{
+	const std::vector<Matrix> a = RandomMatrices(Count, 8);
+	const std::vector<Matrix> b = RandomMatrices(Count, 9);
+	const std::vector<Vector3> v = RandomVectors(Count, 10);
+	const std::vector<float> t = RandomScalars(Count, 11);
+	std::vector<Matrix> result(Count);
+	std::vector<XMFLOAT4X4> raw(Count);
+	std::vector<Vector3> vectors(Count);
+	std::vector<XMFLOAT3> rawVectors(Count);
+	std::vector<float> scalars(Count);
+	std::vector<SQT> parts(Count);
+
+	std::vector<Matrix> scaled(Count);
+	for (size_t i = 0; i < Count; ++i)
+		scaled[i] = Matrix::CreateScale(v[i]) * a[i];
+
+	const auto rawDecompose = [&](size_t i) {
+		XMVECTOR S{}, R{}, T{};
+		XMMatrixDecompose(&S, &R, &T, XMLoadFloat4x4(&scaled[i]));
+
+		SQT P{};
+		XMStoreFloat3(&P.scale, S);
+		XMStoreFloat4(&P.rotation, R);
+		XMStoreFloat3(&P.translation, T);
+		return P;
+	};
+	state.Compare("Decompose", Count,
+		Benchmarks::Loop(parts, [&](size_t i) { SQT P{}; scaled[i].Decompose(P.scale, P.rotation, P.translation); return P; }),
+		Benchmarks::Loop(parts, rawDecompose));
+	state.Compare("Decompose SQT", Count,
+		Benchmarks::Loop(parts, [&](size_t i) { SQT P{}; scaled[i].Decompose(P); return P; }),
+		Benchmarks::Loop(parts, rawDecompose));
+
+	state.Compare("Transpose", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i].Transpose(); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixTranspose(XMLoadFloat4x4(&a[i]))); }));
+	state.Compare("Transpose to result", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Matrix R; a[i].Transpose(R); return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixTranspose(XMLoadFloat4x4(&a[i]))); }));
+
+	state.Compare("Invert", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i].Invert(); }),
+		Benchmarks::Loop(raw, [&](size_t i) { XMVECTOR det; return Store(XMMatrixInverse(&det, XMLoadFloat4x4(&a[i]))); }));
+	state.Compare("Invert to result", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Matrix R; a[i].Invert(R); return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { XMVECTOR det; return Store(XMMatrixInverse(&det, XMLoadFloat4x4(&a[i]))); }));
+
+	state.Compare("Determinant", Count,
+		Benchmarks::Loop(scalars, [&](size_t i) { return a[i].Determinant(); }),
+		Benchmarks::Loop(scalars, [&](size_t i) { return XMVectorGetX(XMMatrixDeterminant(XMLoadFloat4x4(&a[i]))); }));
+
+	// DirectXMath has no Euler extraction
+	state.Measure("ToEuler", Count, Benchmarks::Loop(vectors, [&](size_t i) { return a[i].ToEuler(); }));
+
+	state.Compare("TransformPoint", Count,
+		Benchmarks::Loop(vectors, [&](size_t i) { return a[i].TransformPoint(v[i]); }),
+		Benchmarks::Loop(rawVectors, [&](size_t i) { return Store(XMVector3Transform(XMLoadFloat3(&v[i]), XMLoadFloat4x4(&a[i]))); }));
+	state.Compare("TransformNormal", Count,
+		Benchmarks::Loop(vectors, [&](size_t i) { return a[i].TransformNormal(v[i]); }),
+		Benchmarks::Loop(rawVectors, [&](size_t i) { return Store(XMVector3TransformNormal(XMLoadFloat3(&v[i]), XMLoadFloat4x4(&a[i]))); }));
+	state.Compare("TransformCoord", Count,
+		Benchmarks::Loop(vectors, [&](size_t i) { return a[i].TransformCoord(v[i]); }),
+		Benchmarks::Loop(rawVectors, [&](size_t i) { return Store(XMVector3TransformCoord(XMLoadFloat3(&v[i]), XMLoadFloat4x4(&a[i]))); }));
+
+	const auto rawLerp = [&](size_t i) {
+		return PerRow(a[i], b[i], [&](FXMVECTOR x, FXMVECTOR y) { return XMVectorLerp(x, y, t[i]); });
+	};
+	state.Compare("Lerp", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix::Lerp(a[i], b[i], t[i]); }),
+		Benchmarks::Loop(raw, rawLerp));
+	state.Compare("Lerp to result", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Matrix R; Matrix::Lerp(a[i], b[i], t[i], R); return R; }),
+		Benchmarks::Loop(raw, rawLerp));
+
+	const std::vector<Quaternion> rotations = [&] {
+		std::vector<Quaternion> q(Count);
+		for (size_t i = 0; i < Count; ++i)
+			q[i] = Quaternion::CreateFromRotationMatrix(b[i]);
+		return q;
+	}();
+	state.Compare("Transform", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix::Transform(a[i], rotations[i]); }),
+		Benchmarks::Loop(raw, [&](size_t i) {
+			return Store(XMMatrixMultiply(XMLoadFloat4x4(&a[i]), XMMatrixRotationQuaternion(XMLoadFloat4(&rotations[i]))));
+		}));
+}
+
+PMATH_BENCHMARK(MatrixCreate)
+{
+	const std::vector<Vector3> v = RandomVectors(Count, 12);
+	const std::vector<Vector3> w = RandomVectors(Count, 13);
+	const std::vector<float> s = RandomScalars(Count, 14);
+	std::vector<Matrix> result(Count);
+	std::vector<XMFLOAT4X4> raw(Count);
+
+	std::vector<Vector3> axes = v;
+	for (Vector3& axis : axes)
+		axis.Normalize();
+
+	std::vector<Quaternion> rotations(Count);
+	for (size_t i = 0; i < Count; ++i)
+		rotations[i] = Quaternion::CreateFromYawPitchRoll(v[i]);
+
+	state.Compare("CreateTranslation vector", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix::CreateTranslation(v[i]); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixTranslationFromVector(XMLoadFloat3(&v[i]))); }));
+	state.Compare("CreateTranslation", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix::CreateTranslation(v[i].x, v[i].y, v[i].z); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixTranslation(v[i].x, v[i].y, v[i].z)); }));
+
+	state.Compare("CreateScale vector", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix::CreateScale(v[i]); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixScalingFromVector(XMLoadFloat3(&v[i]))); }));
+	state.Compare("CreateScale", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix::CreateScale(v[i].x, v[i].y, v[i].z); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixScaling(v[i].x, v[i].y, v[i].z)); }));
+	state.Compare("CreateScale uniform", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix::CreateScale(s[i]); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixScaling(s[i], s[i], s[i])); }));
+
+	state.Compare("CreateRotationX", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix::CreateRotationX(s[i]); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixRotationX(s[i])); }));
+	state.Compare("CreateRotationY", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix::CreateRotationY(s[i]); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixRotationY(s[i])); }));
+	state.Compare("CreateRotationZ", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix::CreateRotationZ(s[i]); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixRotationZ(s[i])); }));
+	state.Compare("CreateFromAxisAngle", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix::CreateFromAxisAngle(axes[i], s[i]); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixRotationAxis(XMLoadFloat3(&axes[i]), s[i])); }));
+	state.Compare("CreateFromQuaternion", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix::CreateFromQuaternion(rotations[i]); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixRotationQuaternion(XMLoadFloat4(&rotations[i]))); }));
+	state.Compare("CreateFromYawPitchRoll", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix::CreateFromYawPitchRoll(v[i].y, v[i].x, v[i].z); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixRotationRollPitchYaw(v[i].x, v[i].y, v[i].z)); }));
+	state.Compare("CreateFromYawPitchRoll vector", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix::CreateFromYawPitchRoll(v[i]); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixRotationRollPitchYawFromVector(XMLoadFloat3(&v[i]))); }));
+
+	state.Compare("CreatePerspectiveFieldOfView", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix::CreatePerspectiveFieldOfView(s[i], 1.5f, 0.1f, 100.f); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixPerspectiveFovRH(s[i], 1.5f, 0.1f, 100.f)); }));
+	state.Compare("CreatePerspective", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix::CreatePerspective(v[i].x, v[i].y, 0.1f, 100.f); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixPerspectiveRH(v[i].x, v[i].y, 0.1f, 100.f)); }));
+	state.Compare("CreateOrthographic", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix::CreateOrthographic(v[i].x, v[i].y, 0.1f, 100.f); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMMatrixOrthographicRH(v[i].x, v[i].y, 0.1f, 100.f)); }));
+
+	state.Compare("CreateLookAt", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix::CreateLookAt(v[i], w[i], Vector3::UnitY); }),
+		Benchmarks::Loop(raw, [&](size_t i) {
+			return Store(XMMatrixLookAtRH(XMLoadFloat3(&v[i]), XMLoadFloat3(&w[i]), XMVectorSet(0.f, 1.f, 0.f, 0.f)));
+		}));
+	state.Compare("CreateWorld", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Matrix::CreateWorld(v[i], axes[i], Vector3::UnitY); }),
+		Benchmarks::Loop(raw, [&](size_t i) {
+			const XMVECTOR z = XMVector3Normalize(XMVectorNegate(XMLoadFloat3(&axes[i])));
+			const XMVECTOR x = XMVector3Normalize(XMVector3Cross(XMVectorSet(0.f, 1.f, 0.f, 0.f), z));
+			const XMVECTOR y = XMVector3Cross(z, x);
+			return Store(XMMATRIX(x, y, z, XMVectorSetW(XMLoadFloat3(&v[i]), 1.f)));
+		}));
+}
+
+PMATH_BENCHMARK(MatrixTransformBatch)
+{
+	const std::vector<Vector3> points = RandomVectors(PointCount, 15);
+	const Matrix M = RandomMatrices(1, 16)[0];
+	std::vector<Vector3> result(PointCount);
+	std::vector<XMFLOAT4> raw4(PointCount);
+	std::vector<XMFLOAT3> raw3(PointCount);
+
+	const Vector3Stream input(points);
+	Vector3Stream output(PointCount);
+
+	// DirectXMath's Transform stream writes w as well, so its output is XMFLOAT4
+	state.Compare("TransformPoints", PointCount,
+		[&] {
+			M.TransformPoints(points, result);
+			Benchmarks::DoNotOptimize(result.data());
+		},
+		[&] {
+			XMVector3TransformStream(raw4.data(), sizeof(XMFLOAT4), points.data(), sizeof(Vector3), PointCount, XMLoadFloat4x4(&M));
+			Benchmarks::DoNotOptimize(raw4.data());
+		});
+	state.Compare("TransformNormals", PointCount,
+		[&] {
+			M.TransformNormals(points, result);
+			Benchmarks::DoNotOptimize(result.data());
+		},
+		[&] {
+			XMVector3TransformNormalStream(raw3.data(), sizeof(XMFLOAT3), points.data(), sizeof(Vector3), PointCount, XMLoadFloat4x4(&M));
+			Benchmarks::DoNotOptimize(raw3.data());
+		});
+	state.Compare("TransformCoords", PointCount,
+		[&] {
+			M.TransformCoords(points, result);
+			Benchmarks::DoNotOptimize(result.data());
+		},
+		[&] {
+			XMVector3TransformCoordStream(raw3.data(), sizeof(XMFLOAT3), points.data(), sizeof(Vector3), PointCount, XMLoadFloat4x4(&M));
+			Benchmarks::DoNotOptimize(raw3.data());
+		});
+
+	// The SoA and parallel versions have no DirectXMath counterpart
+	state.Measure("TransformPoints stream", PointCount, [&] {
+		M.TransformPoints(input, output);
+		Benchmarks::DoNotOptimize(output.x.data());
+	});
+	state.Measure("TransformNormals stream", PointCount, [&] {
+		M.TransformNormals(input, output);
+		Benchmarks::DoNotOptimize(output.x.data());
+	});
+	state.Measure("TransformCoords stream", PointCount, [&] {
+		M.TransformCoords(input, output);
+		Benchmarks::DoNotOptimize(output.x.data());
+	});
+	state.Measure("TransformPoints parallel", PointCount, [&] {
+		M.TransformPoints(Parallel::par, points, result);
+		Benchmarks::DoNotOptimize(result.data());
+	});
+	state.Measure("TransformPoints stream parallel", PointCount, [&] {
+		M.TransformPoints(Parallel::par, input, output);
+		Benchmarks::DoNotOptimize(output.x.data());
+	});
+}
@@ -0,0 +1,100 @@
+#include <cstddef>
+#include <memory_resource>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../PMath.inl"
+#include "../PMathMemory.h"
+
+using namespace PMgene::Math;
+
+namespace
+{
+	// Per-frame scratch of one animated character: a palette and a vertex buffer
+	constexpr size_t JointCount = 128;
+	constexpr size_t VertexCount = 4096;
+
+	// Matrices per batch, L2-sized so alignment rather than memory bandwidth decides
+	constexpr size_t MatrixCount = 2048;
+
+	std::vector<Matrix> RandomMatrices(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+		std::uniform_real_distribution<float> offset(-100.f, 100.f);
+
+		std::vector<Matrix> result(count);
+		for (Matrix& M : result)
+			M = Matrix::CreateFromYawPitchRoll(angle(random), angle(random), angle(random)) *
+				Matrix::CreateTranslation(offset(random), offset(random), offset(random));
+		return result;
+	}
+
+	// Allocates one frame's scratch buffers without filling them, so only the allocation is timed
+	template <typename MatrixVector, typename VectorVector>
+	void Frame(MatrixVector& palette, VectorVector& vertices)
+	{
+		palette.reserve(JointCount);
+		vertices.reserve(VertexCount);
+		palette.push_back(Matrix::Identity);
+		vertices.push_back(Vector3::Zero);
+		Benchmarks::DoNotOptimize(palette.data());
+		Benchmarks::DoNotOptimize(vertices.data());
+	}
+}
+
+PMATH_BENCHMARK(FrameAllocation)
+{
+	state.Measure("std::vector", 1, [&] {
+		std::vector<Matrix> palette;
+		std::vector<Vector3> vertices;
+		Frame(palette, vertices);
+	});
+
+	FrameArena arena(1 << 16);
+	state.Measure("FrameArena", 1, [&] {
+		{
+			std::pmr::vector<Matrix> palette(&arena);
+			std::pmr::vector<Vector3> vertices(&arena);
+			Frame(palette, vertices);
+		}
+		arena.Reset();
+	});
+
+	BlockPool pool(VertexCount * sizeof(Vector3), 4);
+	state.Measure("BlockPool", 1, [&] {
+		std::pmr::vector<Matrix> palette(&pool);
+		std::pmr::vector<Vector3> vertices(&pool);
+		Frame(palette, vertices);
+	});
+}
+
+PMATH_BENCHMARK(AlignedMatrices)
+{
+	const std::vector<Matrix> a = RandomMatrices(MatrixCount, 1);
+	const std::vector<Matrix> b = RandomMatrices(MatrixCount, 2);
+
+	// Matrix only guarantees 4-byte alignment; offset by 4 bytes, every other one straddles a cache line
+	std::vector<std::byte> buffer((3 * MatrixCount + 1) * sizeof(Matrix) + 64);
+	std::byte* base = buffer.data() + (64 - reinterpret_cast<uintptr_t>(buffer.data()) % 64) + 4;
+	const std::span<Matrix> unalignedA(reinterpret_cast<Matrix*>(base), MatrixCount);
+	const std::span<Matrix> unalignedB(unalignedA.data() + MatrixCount, MatrixCount);
+	const std::span<Matrix> unalignedResult(unalignedB.data() + MatrixCount, MatrixCount);
+	std::copy(a.begin(), a.end(), unalignedA.begin());
+	std::copy(b.begin(), b.end(), unalignedB.begin());
+
+	AlignedVector<AlignedMatrix<>> alignedA(a.begin(), a.end());
+	AlignedVector<AlignedMatrix<>> alignedB(b.begin(), b.end());
+	AlignedVector<AlignedMatrix<>> alignedResult(MatrixCount);
+
+	state.Measure("MultiplyBatch unaligned", MatrixCount, [&] {
+		Matrix::MultiplyBatch(unalignedA, unalignedB, unalignedResult);
+		Benchmarks::DoNotOptimize(unalignedResult.data());
+	});
+	state.Measure("MultiplyBatch AlignedMatrix", MatrixCount, [&] {
+		Matrix::MultiplyBatch(AsSpan(alignedA), AsSpan(alignedB), AsSpan(alignedResult));
+		Benchmarks::DoNotOptimize(alignedResult.data());
+	});
+}
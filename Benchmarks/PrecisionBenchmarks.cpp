@@ -0,0 +1,142 @@
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../PMath.inl"
+
+using namespace PMgene::Math;
+
+namespace
+{
+	constexpr size_t Count = 1024;
+
+	std::vector<Vector3> RandomVectors(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> value(-10.f, 10.f);
+
+		std::vector<Vector3> result(count);
+		for (Vector3& V : result)
+			V = Vector3(value(random), value(random), value(random));
+		return result;
+	}
+
+	std::vector<Quaternion> RandomQuaternions(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+
+		std::vector<Quaternion> result(count);
+		for (Quaternion& Q : result)
+			Q = Quaternion::CreateFromYawPitchRoll(angle(random), angle(random), angle(random)) * 1.5f;
+		return result;
+	}
+
+	constexpr const char* Name(Precision precision) noexcept
+	{
+		switch (precision)
+		{
+		case Precision::Exact:
+			return " Exact";
+		case Precision::Fast:
+			return " Fast";
+		default:
+			return " Estimate";
+		}
+	}
+
+	// Scalar call sites pay the latency of these functions, so each is timed as a dependency chain
+	template <typename Operation>
+	auto Chain(const std::vector<float>& inputs, Operation operation)
+	{
+		return [&inputs, operation] {
+			float x = 0.5f;
+			for (float input : inputs)
+				x = operation(x + input);
+			Benchmarks::DoNotOptimize(x);
+		};
+	}
+
+	// Degenerate inputs the doc table promises to handle like Exact: zero, and vectors short
+	// enough for their squared length to be denormal or to underflow to zero
+	template <Precision P>
+	bool MatchesExactOnTinyInputs() noexcept
+	{
+		constexpr float Tolerance = 1e-3f;
+		const auto close = [](float a, float b) { return std::fabs(a - b) <= Tolerance * std::fmax(1.f, std::fabs(b)); };
+
+		for (const float length : { 0.f, 1e-30f, 1e-23f, 1e-20f, 3e-20f, 1e-19f, 1e-18f })
+		{
+			const Vector3 V(length, -0.5f * length, 0.25f * length);
+			Vector3 exact, normal;
+			V.Normalize(exact);
+			V.Normalize<P>(normal);
+			if (!close(normal.x, exact.x) || !close(normal.y, exact.y) || !close(normal.z, exact.z))
+				return false;
+
+			const Quaternion Q(length, 0.f, 0.f, -length);
+			Quaternion q = Q, exactQ = Q;
+			q.Normalize<P>();
+			exactQ.Normalize();
+			if (!close(q.x, exactQ.x) || !close(q.w, exactQ.w))
+				return false;
+
+			// Relative to the result, which is as small as the vector
+			const float squared = length * length;
+			const float root = std::sqrt(squared);
+			if (root != 0.f ? !close(Sqrt<P>(squared) / root, 1.f) : Sqrt<P>(squared) != 0.f)
+				return false;
+		}
+		return true;
+	}
+
+	template <Precision P>
+	void MeasurePrecision(Benchmarks::State& state, const std::vector<Vector3>& vectors, const std::vector<Quaternion>& quaternions,
+	                      const std::vector<float>& scalars)
+	{
+		std::vector<Vector3> vectorResult(Count);
+		std::vector<Quaternion> quaternionResult(Count);
+		const std::string suffix = Name(P);
+
+		if (!MatchesExactOnTinyInputs<P>())
+			std::fprintf(stderr, "PrecisionModes:%s differs from Exact on tiny vectors\n", suffix.c_str());
+
+		state.Measure("Vector3::Normalize" + suffix, Count, Benchmarks::Loop(vectorResult, [&](size_t i) {
+			Vector3 R;
+			vectors[i].Normalize<P>(R);
+			return R;
+		}));
+		state.Measure("Quaternion::Normalize" + suffix, Count, Benchmarks::Loop(quaternionResult, [&](size_t i) {
+			Quaternion R = quaternions[i];
+			R.Normalize<P>();
+			return R;
+		}));
+		state.Measure("Quaternion::ToEuler" + suffix, Count, Benchmarks::Loop(vectorResult, [&](size_t i) { return quaternions[i].ToEuler<P>(); }));
+
+		// Independent calls, which the compiler may vectorize, against the latency chains below
+		std::vector<float> scalarResult(Count);
+		state.Measure("Sin" + suffix, Count, Benchmarks::Loop(scalarResult, [&](size_t i) { return Sin<P>(vectors[i].x); }));
+
+		state.Measure("Sqrt latency" + suffix, Count, Chain(scalars, [](float x) { return Sqrt<P>(x); }));
+		state.Measure("ReciprocalSqrt latency" + suffix, Count, Chain(scalars, [](float x) { return ReciprocalSqrt<P>(x); }));
+		state.Measure("Reciprocal latency" + suffix, Count, Chain(scalars, [](float x) { return Reciprocal<P>(x); }));
+		state.Measure("Sin latency" + suffix, Count, Chain(scalars, [](float x) { return Sin<P>(x); }));
+		state.Measure("Atan2 latency" + suffix, Count, Chain(scalars, [](float x) { return Atan2<P>(x, 0.75f); }));
+	}
+}
+
+PMATH_BENCHMARK(PrecisionModes)
+{
+	const std::vector<Vector3> vectors = RandomVectors(Count, 1);
+	const std::vector<Quaternion> quaternions = RandomQuaternions(Count, 2);
+	std::vector<float> scalars(Count);
+	for (size_t i = 0; i < Count; ++i)
+		scalars[i] = 0.5f + 0.001f * static_cast<float>(i);
+
+	MeasurePrecision<Precision::Exact>(state, vectors, quaternions, scalars);
+	MeasurePrecision<Precision::Fast>(state, vectors, quaternions, scalars);
+	MeasurePrecision<Precision::Estimate>(state, vectors, quaternions, scalars);
+}
@@ -0,0 +1,321 @@
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../PMath.inl"
+#include "../PMathParallel.h"
+#include "../PMathStream.h"
+
+using namespace PMgene::Math;
+
+namespace
+{
+	constexpr size_t Count = 1024;
+
+	// 100 joints for each of 2,000 characters
+	constexpr size_t JointCount = 100 * 2000;
+
+	// One orientation per entity in a replicated scene
+	constexpr size_t EntityCount = 100000;
+
+	std::vector<Vector3> RandomAngles(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+
+		std::vector<Vector3> result(count);
+		for (Vector3& V : result)
+			V = Vector3(angle(random), angle(random), angle(random));
+		return result;
+	}
+
+	std::vector<Quaternion> RandomRotations(size_t count, unsigned seed)
+	{
+		const std::vector<Vector3> angles = RandomAngles(count, seed);
+
+		std::vector<Quaternion> result(count);
+		for (size_t i = 0; i < count; ++i)
+			result[i] = Quaternion::CreateFromYawPitchRoll(angles[i].y, angles[i].x, angles[i].z);
+		return result;
+	}
+
+	std::vector<float> RandomScalars(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> value(0.f, 1.f);
+
+		std::vector<float> result(count);
+		for (float& S : result)
+			S = value(random);
+		return result;
+	}
+
+	XMFLOAT4 Store(FXMVECTOR Q) noexcept
+	{
+		XMFLOAT4 R;
+		XMStoreFloat4(&R, Q);
+		return R;
+	}
+}
+
+PMATH_BENCHMARK(QuaternionOperators)
+{
+	const std::vector<Quaternion> a = RandomRotations(Count, 1);
+	const std::vector<Quaternion> b = RandomRotations(Count, 2);
+	const std::vector<float> s = RandomScalars(Count, 3);
+	std::vector<Quaternion> result(Count);
+	std::vector<XMFLOAT4> raw(Count);
+	std::vector<uint8_t> flags(Count);
+
+	state.Compare("operator==", Count,
+		Benchmarks::Loop(flags, [&](size_t i) { return uint8_t(a[i] == b[i]); }),
+		Benchmarks::Loop(flags, [&](size_t i) { return uint8_t(XMQuaternionEqual(XMLoadFloat4(&a[i]), XMLoadFloat4(&b[i]))); }));
+	state.Compare("operator!=", Count,
+		Benchmarks::Loop(flags, [&](size_t i) { return uint8_t(a[i] != b[i]); }),
+		Benchmarks::Loop(flags, [&](size_t i) { return uint8_t(XMQuaternionNotEqual(XMLoadFloat4(&a[i]), XMLoadFloat4(&b[i]))); }));
+
+	state.Compare("operator+=", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Quaternion R = a[i]; R += b[i]; return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVectorAdd(XMLoadFloat4(&a[i]), XMLoadFloat4(&b[i]))); }));
+	state.Compare("operator-=", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Quaternion R = a[i]; R -= b[i]; return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVectorSubtract(XMLoadFloat4(&a[i]), XMLoadFloat4(&b[i]))); }));
+	state.Compare("operator*= quaternion", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Quaternion R = a[i]; R *= b[i]; return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMQuaternionMultiply(XMLoadFloat4(&a[i]), XMLoadFloat4(&b[i]))); }));
+	state.Compare("operator*= scalar", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Quaternion R = a[i]; R *= s[i]; return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVectorScale(XMLoadFloat4(&a[i]), s[i])); }));
+	state.Compare("operator/=", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Quaternion R = a[i]; R /= b[i]; return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) {
+			return Store(XMQuaternionMultiply(XMLoadFloat4(&a[i]), XMQuaternionInverse(XMLoadFloat4(&b[i]))));
+		}));
+
+	state.Compare("operator- unary", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return -a[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVectorNegate(XMLoadFloat4(&a[i]))); }));
+
+	state.Compare("operator+", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] + b[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVectorAdd(XMLoadFloat4(&a[i]), XMLoadFloat4(&b[i]))); }));
+	state.Compare("operator-", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] - b[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVectorSubtract(XMLoadFloat4(&a[i]), XMLoadFloat4(&b[i]))); }));
+	state.Compare("operator* quaternion", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] * b[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMQuaternionMultiply(XMLoadFloat4(&a[i]), XMLoadFloat4(&b[i]))); }));
+	state.Compare("operator* scalar", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] * s[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVectorScale(XMLoadFloat4(&a[i]), s[i])); }));
+	state.Compare("operator* scalar first", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return s[i] * a[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVectorScale(XMLoadFloat4(&a[i]), s[i])); }));
+	state.Compare("operator/", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] / b[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) {
+			return Store(XMQuaternionMultiply(XMLoadFloat4(&a[i]), XMQuaternionInverse(XMLoadFloat4(&b[i]))));
+		}));
+}
+
+PMATH_BENCHMARK(QuaternionOperations)
+{
+	const std::vector<Quaternion> a = RandomRotations(Count, 4);
+	const std::vector<Quaternion> b = RandomRotations(Count, 5);
+	std::vector<Quaternion> result(Count);
+	std::vector<XMFLOAT4> raw(Count);
+	std::vector<float> scalars(Count);
+	std::vector<Vector3> angles(Count);
+
+	state.Compare("Length", Count,
+		Benchmarks::Loop(scalars, [&](size_t i) { return a[i].Length(); }),
+		Benchmarks::Loop(scalars, [&](size_t i) { return XMVectorGetX(XMQuaternionLength(XMLoadFloat4(&a[i]))); }));
+	state.Compare("Dot", Count,
+		Benchmarks::Loop(scalars, [&](size_t i) { return a[i].Dot(b[i]); }),
+		Benchmarks::Loop(scalars, [&](size_t i) { return XMVectorGetX(XMQuaternionDot(XMLoadFloat4(&a[i]), XMLoadFloat4(&b[i]))); }));
+
+	state.Compare("Normalize", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Quaternion R = a[i]; R.Normalize(); return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMQuaternionNormalize(XMLoadFloat4(&a[i]))); }));
+	state.Compare("Conjugate", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Quaternion R = a[i]; R.Conjugate(); return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMQuaternionConjugate(XMLoadFloat4(&a[i]))); }));
+	state.Compare("Inverse", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Quaternion R; a[i].Inverse(R); return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMQuaternionInverse(XMLoadFloat4(&a[i]))); }));
+
+	// DirectXMath has no Euler extraction
+	state.Measure("ToEuler", Count, Benchmarks::Loop(angles, [&](size_t i) { return a[i].ToEuler(); }));
+
+	state.Compare("Concatenate", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Quaternion::Concatenate(a[i], b[i]); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMQuaternionMultiply(XMLoadFloat4(&b[i]), XMLoadFloat4(&a[i]))); }));
+	state.Compare("Angle", Count,
+		Benchmarks::Loop(scalars, [&](size_t i) { return Quaternion::Angle(a[i], b[i]); }),
+		Benchmarks::Loop(scalars, [&](size_t i) {
+			const XMVECTOR R = XMQuaternionMultiply(XMQuaternionConjugate(XMLoadFloat4(&a[i])), XMLoadFloat4(&b[i]));
+			return 2.f * std::atan2(XMVectorGetX(XMVector3Length(R)), XMVectorGetW(R));
+		}));
+}
+
+PMATH_BENCHMARK(QuaternionCreate)
+{
+	const std::vector<Vector3> angles = RandomAngles(Count, 6);
+	const std::vector<Quaternion> rotations = RandomRotations(Count, 7);
+	std::vector<Matrix> matrices(Count);
+	for (size_t i = 0; i < Count; ++i)
+		matrices[i] = Matrix::CreateFromQuaternion(rotations[i]);
+
+	std::vector<Vector3> axes = RandomAngles(Count, 8);
+	for (Vector3& axis : axes)
+		axis.Normalize();
+
+	std::vector<Quaternion> result(Count);
+	std::vector<XMFLOAT4> raw(Count);
+
+	state.Compare("CreateFromAxisAngle", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Quaternion::CreateFromAxisAngle(axes[i], angles[i].x); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMQuaternionRotationAxis(XMLoadFloat3(&axes[i]), angles[i].x)); }));
+	state.Compare("CreateFromYawPitchRoll", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Quaternion::CreateFromYawPitchRoll(angles[i].y, angles[i].x, angles[i].z); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMQuaternionRotationRollPitchYaw(angles[i].x, angles[i].y, angles[i].z)); }));
+	state.Compare("CreateFromYawPitchRoll vector", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Quaternion::CreateFromYawPitchRoll(angles[i]); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMQuaternionRotationRollPitchYawFromVector(XMLoadFloat3(&angles[i]))); }));
+	state.Compare("CreateFromRotationMatrix", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Quaternion::CreateFromRotationMatrix(matrices[i]); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMQuaternionRotationMatrix(XMLoadFloat4x4(&matrices[i]))); }));
+}
+
+PMATH_BENCHMARK(QuaternionInterpolation)
+{
+	const std::vector<Quaternion> a = RandomRotations(Count, 9);
+	const std::vector<Quaternion> b = RandomRotations(Count, 10);
+	const std::vector<float> t = RandomScalars(Count, 11);
+	std::vector<Quaternion> result(Count);
+	std::vector<XMFLOAT4> raw(Count);
+
+	// Normalized lerp along the shorter arc, as Quaternion::Lerp does it
+	const auto rawLerp = [&](size_t i) {
+		const XMVECTOR Q0 = XMLoadFloat4(&a[i]);
+		const XMVECTOR Q1 = XMLoadFloat4(&b[i]);
+		const XMVECTOR R = XMVector4GreaterOrEqual(XMVector4Dot(Q0, Q1), XMVectorZero())
+			? XMVectorLerp(Q0, Q1, t[i])
+			: XMVectorSubtract(XMVectorScale(Q0, 1.f - t[i]), XMVectorScale(Q1, t[i]));
+		return Store(XMQuaternionNormalize(R));
+	};
+
+	state.Compare("Lerp", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Quaternion::Lerp(a[i], b[i], t[i]); }),
+		Benchmarks::Loop(raw, rawLerp));
+	state.Compare("Lerp to result", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Quaternion R; Quaternion::Lerp(a[i], b[i], t[i], R); return R; }),
+		Benchmarks::Loop(raw, rawLerp));
+
+	state.Compare("Slerp", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return Quaternion::Slerp(a[i], b[i], t[i]); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMQuaternionSlerp(XMLoadFloat4(&a[i]), XMLoadFloat4(&b[i]), t[i])); }));
+	state.Compare("Slerp to result", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Quaternion R; Quaternion::Slerp(a[i], b[i], t[i], R); return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMQuaternionSlerp(XMLoadFloat4(&a[i]), XMLoadFloat4(&b[i]), t[i])); }));
+}
+
+PMATH_BENCHMARK(QuaternionStreamBlend)
+{
+	const std::vector<Quaternion> a = RandomRotations(JointCount, 12);
+	const std::vector<Quaternion> b = RandomRotations(JointCount, 13);
+	const std::vector<float> t = RandomScalars(JointCount, 14);
+	std::vector<Quaternion> result(JointCount);
+	std::vector<XMFLOAT4> raw(JointCount);
+
+	const QuaternionStream first(a);
+	const QuaternionStream second(b);
+	QuaternionStream blended(JointCount);
+
+	state.Compare("Lerp", JointCount,
+		[&] {
+			QuaternionStream::Lerp(first, second, t, blended);
+			Benchmarks::DoNotOptimize(blended.x.data());
+		},
+		Benchmarks::Loop(raw, [&](size_t i) {
+			const XMVECTOR Q0 = XMLoadFloat4(&a[i]);
+			const XMVECTOR Q1 = XMLoadFloat4(&b[i]);
+			const XMVECTOR R = XMVector4GreaterOrEqual(XMVector4Dot(Q0, Q1), XMVectorZero())
+				? XMVectorLerp(Q0, Q1, t[i])
+				: XMVectorSubtract(XMVectorScale(Q0, 1.f - t[i]), XMVectorScale(Q1, t[i]));
+			return Store(XMQuaternionNormalize(R));
+		}));
+
+	const auto rawSlerp = Benchmarks::Loop(raw, [&](size_t i) { return Store(XMQuaternionSlerp(XMLoadFloat4(&a[i]), XMLoadFloat4(&b[i]), t[i])); });
+	state.Compare("Slerp", JointCount,
+		[&] {
+			QuaternionStream::Slerp(first, second, t, blended);
+			Benchmarks::DoNotOptimize(blended.x.data());
+		},
+		rawSlerp);
+	state.Compare("Slerp approximate", JointCount,
+		[&] {
+			QuaternionStream::Slerp(first, second, t, blended, SlerpMode::Approximate);
+			Benchmarks::DoNotOptimize(blended.x.data());
+		},
+		rawSlerp);
+
+	// Blending a whole pose by one weight, and the parallel versions, have no DirectXMath counterpart
+	state.Measure("Slerp one weight", JointCount, [&] {
+		QuaternionStream::Slerp(first, second, 0.25f, blended);
+		Benchmarks::DoNotOptimize(blended.x.data());
+	});
+	state.Measure("Slerp parallel", JointCount, [&] {
+		QuaternionStream::Slerp(Parallel::par, first, second, t, blended);
+		Benchmarks::DoNotOptimize(blended.x.data());
+	});
+	state.Measure("Slerp approximate parallel", JointCount, [&] {
+		QuaternionStream::Slerp(Parallel::par, first, second, t, blended, SlerpMode::Approximate);
+		Benchmarks::DoNotOptimize(blended.x.data());
+	});
+	state.Measure("Slerp AoS round trip", JointCount, [&] {
+		blended.Load(a);
+		QuaternionStream::Slerp(blended, second, t, blended);
+		blended.Store(result);
+		Benchmarks::DoNotOptimize(result.data());
+	});
+}
+
+PMATH_BENCHMARK(QuaternionStreamEuler)
+{
+	const std::vector<Vector3> angles = RandomAngles(EntityCount, 15);
+	const std::vector<Quaternion> rotations = RandomRotations(EntityCount, 16);
+	std::vector<Vector3> eulers(EntityCount);
+	std::vector<Quaternion> result(EntityCount);
+	std::vector<XMFLOAT4> raw(EntityCount);
+
+	const QuaternionStream orientations(rotations);
+	const Vector3Stream angleStream(angles);
+	Vector3Stream eulerStream(EntityCount);
+	QuaternionStream created(EntityCount);
+
+	state.Measure("ToEuler scalar", EntityCount, Benchmarks::Loop(eulers, [&](size_t i) { return rotations[i].ToEuler(); }));
+	state.Measure("ToEuler batch", EntityCount, [&] {
+		QuaternionStream::ToEuler(orientations, eulerStream);
+		Benchmarks::DoNotOptimize(eulerStream.x.data());
+	});
+	state.Measure("ToEuler batch parallel", EntityCount, [&] {
+		QuaternionStream::ToEuler(Parallel::par, orientations, eulerStream);
+		Benchmarks::DoNotOptimize(eulerStream.x.data());
+	});
+
+	state.Compare("CreateFromYawPitchRoll", EntityCount,
+		[&] {
+			QuaternionStream::CreateFromYawPitchRoll(angleStream, created);
+			Benchmarks::DoNotOptimize(created.x.data());
+		},
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMQuaternionRotationRollPitchYawFromVector(XMLoadFloat3(&angles[i]))); }));
+	state.Measure("CreateFromYawPitchRoll scalar", EntityCount,
+		Benchmarks::Loop(result, [&](size_t i) { return Quaternion::CreateFromYawPitchRoll(angles[i]); }));
+	state.Measure("CreateFromYawPitchRoll batch parallel", EntityCount, [&] {
+		QuaternionStream::CreateFromYawPitchRoll(Parallel::par, angleStream, created);
+		Benchmarks::DoNotOptimize(created.x.data());
+	});
+}
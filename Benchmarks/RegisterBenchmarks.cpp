@@ -0,0 +1,133 @@
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../PMathRegister.h"
+
+using namespace PMgene::Math;
+
+namespace
+{
+	// Small enough to stay in L1, so the numbers are about the load and store around every operator
+	constexpr size_t Count = 1024;
+
+	std::vector<Vector3> RandomVectors(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> value(-10.f, 10.f);
+
+		std::vector<Vector3> result(count);
+		for (Vector3& V : result)
+			V = Vector3(value(random), value(random), value(random));
+		return result;
+	}
+
+	std::vector<Quaternion> RandomQuaternions(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+
+		std::vector<Quaternion> result(count);
+		for (Quaternion& Q : result)
+			Q = Quaternion::CreateFromYawPitchRoll(angle(random), angle(random), angle(random));
+		return result;
+	}
+
+	std::vector<Matrix> RandomMatrices(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+		std::uniform_real_distribution<float> offset(-10.f, 10.f);
+
+		std::vector<Matrix> result(count);
+		for (Matrix& M : result)
+			M = Matrix::CreateFromYawPitchRoll(angle(random), angle(random), angle(random))
+			    * Matrix::CreateTranslation(offset(random), offset(random), offset(random));
+		return result;
+	}
+
+	XMFLOAT3 Store3(FXMVECTOR V) noexcept
+	{
+		XMFLOAT3 R;
+		XMStoreFloat3(&R, V);
+		return R;
+	}
+
+	XMFLOAT4 Store4(FXMVECTOR V) noexcept
+	{
+		XMFLOAT4 R;
+		XMStoreFloat4(&R, V);
+		return R;
+	}
+}
+
+PMATH_BENCHMARK(RegisterTypes)
+{
+	const std::vector<Vector3> a = RandomVectors(Count, 1);
+	const std::vector<Vector3> b = RandomVectors(Count, 2);
+	const std::vector<Vector3> c = RandomVectors(Count, 3);
+	const std::vector<Quaternion> q1 = RandomQuaternions(Count, 4);
+	const std::vector<Quaternion> q2 = RandomQuaternions(Count, 5);
+	const std::vector<Matrix> m1 = RandomMatrices(Count, 6);
+	const std::vector<Matrix> m2 = RandomMatrices(Count, 7);
+	const float s = 0.75f;
+
+	std::vector<Vector3> vectors(Count);
+	std::vector<XMFLOAT3> rawVectors(Count);
+	std::vector<Quaternion> quaternions(Count);
+	std::vector<XMFLOAT4> rawQuaternions(Count);
+
+	// A reflection-style chain: (a x b) * s + c - a * (a . c), normalized
+	state.Measure("Vector3 chain", Count, Benchmarks::Loop(vectors, [&](size_t i) {
+		Vector3 R = a[i].Cross(b[i]) * s + c[i] - a[i] * a[i].Dot(c[i]);
+		R.Normalize();
+		return R;
+	}));
+	state.Compare("Vector3V chain", Count,
+		Benchmarks::Loop(vectors, [&](size_t i) {
+			const Vector3V A(a[i]), C(c[i]);
+			Vector3V R = A.Cross(Vector3V(b[i])) * s + C - A * A.Dot(C);
+			R.Normalize();
+			return R.ToVector3();
+		}),
+		Benchmarks::Loop(rawVectors, [&](size_t i) {
+			const XMVECTOR A = XMLoadFloat3(&a[i]), C = XMLoadFloat3(&c[i]);
+			const XMVECTOR R = XMVectorSubtract(XMVectorAdd(XMVectorScale(XMVector3Cross(A, XMLoadFloat3(&b[i])), s), C),
+			                                    XMVectorMultiply(A, XMVector3Dot(A, C)));
+			return Store3(XMVector3Normalize(R));
+		}));
+
+	// Compose two rotations, then blend towards a third
+	state.Measure("Quaternion chain", Count, Benchmarks::Loop(quaternions, [&](size_t i) {
+		const Quaternion Q = q1[i] * q2[i];
+		return Quaternion::Lerp(Q, q2[i] * Q, s);
+	}));
+	state.Compare("QuaternionV chain", Count,
+		Benchmarks::Loop(quaternions, [&](size_t i) {
+			const QuaternionV Q2(q2[i]);
+			const QuaternionV Q = QuaternionV(q1[i]) * Q2;
+			return QuaternionV::Lerp(Q, Q2 * Q, s).ToQuaternion();
+		}),
+		Benchmarks::Loop(rawQuaternions, [&](size_t i) {
+			const XMVECTOR Q2 = XMLoadFloat4(&q2[i]);
+			const XMVECTOR Q = XMQuaternionMultiply(XMLoadFloat4(&q1[i]), Q2);
+			const XMVECTOR R = XMQuaternionMultiply(Q2, Q);
+			const XMVECTOR sign = XMVectorSelect(g_XMOne, g_XMNegativeOne, XMVectorLess(XMVector4Dot(Q, R), XMVectorZero()));
+			return Store4(XMQuaternionNormalize(XMVectorMultiplyAdd(Q, XMVectorReplicate(1.f - s), XMVectorMultiply(R, XMVectorScale(sign, s)))));
+		}));
+
+	// Concatenate, invert and transform a point
+	state.Measure("Matrix chain", Count, Benchmarks::Loop(vectors, [&](size_t i) {
+		const Matrix M = m1[i] * m2[i];
+		return (M * M.Invert()).TransformPoint(a[i]);
+	}));
+	state.Compare("MatrixV chain", Count,
+		Benchmarks::Loop(vectors, [&](size_t i) {
+			const MatrixV M = MatrixV(m1[i]) * MatrixV(m2[i]);
+			return (M * M.Invert()).TransformPoint(Vector3V(a[i])).ToVector3();
+		}),
+		Benchmarks::Loop(rawVectors, [&](size_t i) {
+			const XMMATRIX M = XMMatrixMultiply(XMLoadFloat4x4(&m1[i]), XMLoadFloat4x4(&m2[i]));
+			return Store3(XMVector3Transform(XMLoadFloat3(&a[i]), XMMatrixMultiply(M, XMMatrixInverse(nullptr, M))));
+		}));
+}
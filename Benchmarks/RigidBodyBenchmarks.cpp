@@ -0,0 +1,126 @@
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../PMath.inl"
+#include "../PMathParallel.h"
+#include "../PMathRigidBody.h"
+
+using namespace PMgene::Math;
+
+namespace
+{
+	// A typical scene's worth of dynamic bodies
+	constexpr size_t BodyCount = 50000;
+
+	constexpr float Dt = 1.f / 60.f;
+
+	struct Body
+	{
+		Vector3 position;
+		Vector3 velocity;
+		Quaternion orientation;
+		Vector3 angularVelocity;
+	};
+
+	Vector3 RandomVector(std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> value(-2.f, 2.f);
+		return Vector3(value(random), value(random), value(random));
+	}
+
+	std::vector<Body> RandomBodies(unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+
+		std::vector<Body> result(BodyCount);
+		for (Body& body : result)
+		{
+			body.position = RandomVector(random);
+			body.velocity = RandomVector(random);
+			body.orientation = Quaternion::CreateFromYawPitchRoll(angle(random), angle(random), angle(random));
+			body.angularVelocity = RandomVector(random);
+		}
+		return result;
+	}
+
+	RigidBodyStream ToStream(const std::vector<Body>& bodies)
+	{
+		RigidBodyStream result(bodies.size());
+		for (size_t i = 0; i < bodies.size(); ++i)
+		{
+			result.position.Set(i, bodies[i].position);
+			result.velocity.Set(i, bodies[i].velocity);
+			result.orientation.Set(i, bodies[i].orientation);
+			result.angularVelocity.Set(i, bodies[i].angularVelocity);
+		}
+		return result;
+	}
+
+	Vector3Stream RandomStream(unsigned seed)
+	{
+		std::mt19937 random(seed);
+		Vector3Stream result(BodyCount);
+		for (size_t i = 0; i < BodyCount; ++i)
+			result.Set(i, RandomVector(random));
+		return result;
+	}
+
+	// The usual per-body loop on the operators. Quaternion products apply the left operand first,
+	// so q * (h, 0) is the world-space derivative (h, 0) q.
+	void IntegrateOperators(std::vector<Body>& bodies, const Vector3Stream& linear, const Vector3Stream& angular) noexcept
+	{
+		for (size_t i = 0; i < bodies.size(); ++i)
+		{
+			Body& body = bodies[i];
+			body.velocity += linear.Get(i) * Dt;
+			body.angularVelocity += angular.Get(i) * Dt;
+			body.position += body.velocity * Dt;
+
+			const Vector3 h = body.angularVelocity * (0.5f * Dt);
+			body.orientation += body.orientation * Quaternion(h.x, h.y, h.z, 0.f);
+			body.orientation.Normalize();
+		}
+	}
+}
+
+PMATH_BENCHMARK(RigidBodyIntegration)
+{
+	const std::vector<Body> initial = RandomBodies(1);
+	const Vector3Stream linear = RandomStream(2);
+	const Vector3Stream angular = RandomStream(3);
+	Vector3Stream gravity(1);
+	gravity.Set(0, Vector3(0.f, -9.81f, 0.f));
+
+	std::vector<Body> bodies = initial;
+	RigidBodyStream stream = ToStream(initial);
+
+	state.Compare("Semi-implicit Euler", BodyCount,
+		[&] {
+			stream.IntegrateEuler(linear, angular, Dt);
+			Benchmarks::DoNotOptimize(stream.orientation.w.data());
+		},
+		[&] {
+			IntegrateOperators(bodies, linear, angular);
+			Benchmarks::DoNotOptimize(bodies.data());
+		});
+	state.Measure("Semi-implicit Euler, shared gravity", BodyCount, [&] {
+		stream.IntegrateEuler(gravity, angular, Dt);
+		Benchmarks::DoNotOptimize(stream.orientation.w.data());
+	});
+	state.Measure("Semi-implicit Euler parallel", BodyCount, [&] {
+		stream.IntegrateEuler(Parallel::par, linear, angular, Dt);
+		Benchmarks::DoNotOptimize(stream.orientation.w.data());
+	});
+	state.Measure("Velocity Verlet step", BodyCount, [&] {
+		stream.IntegrateVerletPositions(linear, angular, Dt);
+		stream.IntegrateVerletVelocities(linear, angular, Dt);
+		Benchmarks::DoNotOptimize(stream.orientation.w.data());
+	});
+	state.Measure("Velocity Verlet step parallel", BodyCount, [&] {
+		stream.IntegrateVerletPositions(Parallel::par, linear, angular, Dt);
+		stream.IntegrateVerletVelocities(Parallel::par, linear, angular, Dt);
+		Benchmarks::DoNotOptimize(stream.orientation.w.data());
+	});
+}
@@ -0,0 +1,159 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../PMath.inl"
+#include "../PMathCpu.h"
+#include "../PMathParallel.h"
+#include "../PMathSkinning.h"
+
+using namespace PMgene::Math;
+
+namespace
+{
+	// Meshes of 10k, 100k and 1M vertices bound to 100 joints, from fitting in cache to streaming
+	// from memory
+	constexpr size_t VertexCounts[] = { 10000, 100000, 1000000 };
+	constexpr size_t JointCount = 100;
+
+	std::string VertexLabel(size_t vertexCount)
+	{
+		return vertexCount >= 1000000 ? std::to_string(vertexCount / 1000000) + "M" : std::to_string(vertexCount / 1000) + "k";
+	}
+
+	SkinWeights RandomWeights(size_t vertexCount, size_t influences, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_int_distribution<unsigned> joint(0, JointCount - 1);
+		std::uniform_real_distribution<float> weight(0.f, 1.f);
+
+		SkinWeights result(vertexCount, influences);
+		for (size_t i = 0; i < vertexCount; ++i)
+		{
+			for (size_t k = 0; k < influences; ++k)
+				result.Set(i, k, static_cast<uint16_t>(joint(random)), weight(random));
+		}
+		result.NormalizeWeights();
+		return result;
+	}
+
+	Vector3Stream RandomStream(size_t vertexCount, unsigned seed, bool normalize)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> coordinate(-1.f, 1.f);
+
+		Vector3Stream result(vertexCount);
+		for (size_t i = 0; i < vertexCount; ++i)
+			result.Set(i, Vector3(coordinate(random), coordinate(random), coordinate(random)));
+		if (normalize)
+			result.Normalize();
+		return result;
+	}
+
+	std::vector<DualQuaternion> RandomPalette(unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+		std::uniform_real_distribution<float> offset(-1.f, 1.f);
+
+		std::vector<DualQuaternion> result(JointCount);
+		for (DualQuaternion& D : result)
+			D = DualQuaternion(Quaternion::CreateFromYawPitchRoll(angle(random), angle(random), angle(random)),
+			                   Vector3(offset(random), offset(random), offset(random)));
+		return result;
+	}
+
+	// The usual hand-written skinning loop: blend the palette matrices of each vertex, then transform
+	void LinearBlendDirectXMath(const std::vector<Matrix>& palette, const SkinWeights& weights, const Vector3Stream& positions,
+	                            const Vector3Stream& normals, Vector3Stream& skinnedPositions, Vector3Stream& skinnedNormals) noexcept
+	{
+		for (size_t i = 0; i < positions.Size(); ++i)
+		{
+			XMMATRIX M;
+			M.r[0] = M.r[1] = M.r[2] = M.r[3] = XMVectorZero();
+			for (size_t k = 0; k < weights.InfluenceCount(); ++k)
+			{
+				const XMMATRIX joint = XMLoadFloat4x4(&palette[weights.Joint(i, k)]);
+				const XMVECTOR w = XMVectorReplicate(weights.Weight(i, k));
+				M.r[0] = XMVectorMultiplyAdd(joint.r[0], w, M.r[0]);
+				M.r[1] = XMVectorMultiplyAdd(joint.r[1], w, M.r[1]);
+				M.r[2] = XMVectorMultiplyAdd(joint.r[2], w, M.r[2]);
+				M.r[3] = XMVectorMultiplyAdd(joint.r[3], w, M.r[3]);
+			}
+
+			Vector3 P;
+			XMStoreFloat3(&P, XMVector3Transform(XMVectorSet(positions.x[i], positions.y[i], positions.z[i], 1.f), M));
+			skinnedPositions.Set(i, P);
+
+			Vector3 N;
+			XMStoreFloat3(&N, XMVector3Normalize(XMVector3TransformNormal(XMVectorSet(normals.x[i], normals.y[i], normals.z[i], 0.f), M)));
+			skinnedNormals.Set(i, N);
+		}
+	}
+}
+
+PMATH_BENCHMARK(MeshSkinning)
+{
+	const std::vector<DualQuaternion> dualQuaternions = RandomPalette(1);
+	std::vector<Matrix> matrices(JointCount);
+	for (size_t j = 0; j < JointCount; ++j)
+		matrices[j] = dualQuaternions[j].ToMatrix();
+
+	for (size_t vertexCount : VertexCounts)
+	{
+		const Vector3Stream positions = RandomStream(vertexCount, 2, false);
+		const Vector3Stream normals = RandomStream(vertexCount, 3, true);
+		Vector3Stream skinnedPositions(vertexCount);
+		Vector3Stream skinnedNormals(vertexCount);
+
+		for (size_t influences : { 4, 8 })
+		{
+			const SkinWeights weights = RandomWeights(vertexCount, influences, 4);
+			const std::string suffix = " " + VertexLabel(vertexCount) + " vertices " + std::to_string(influences) + " influences";
+
+			const auto linearBlend = [&] {
+				Skinning::LinearBlend(matrices, weights, positions, normals, skinnedPositions, skinnedNormals);
+				Benchmarks::DoNotOptimize(skinnedNormals.x.data());
+			};
+			const auto dualQuaternionBlend = [&] {
+				Skinning::DualQuaternionBlend(dualQuaternions, weights, positions, normals, skinnedPositions, skinnedNormals);
+				Benchmarks::DoNotOptimize(skinnedNormals.x.data());
+			};
+
+			SetSimdLevel(SimdLevel::Scalar);
+			state.Measure("Linear blend generic" + suffix, vertexCount, linearBlend);
+			state.Measure("Dual quaternion blend generic" + suffix, vertexCount, dualQuaternionBlend);
+
+			if (GetSupportedSimdLevel() >= SimdLevel::AVX2)
+			{
+				SetSimdLevel(SimdLevel::AVX2);
+				state.Measure("Linear blend AVX2" + suffix, vertexCount, linearBlend);
+				state.Measure("Dual quaternion blend AVX2" + suffix, vertexCount, dualQuaternionBlend);
+			}
+
+			SetSimdLevel(GetSupportedSimdLevel());
+			state.Compare("Linear blend" + suffix, vertexCount, linearBlend, [&] {
+				LinearBlendDirectXMath(matrices, weights, positions, normals, skinnedPositions, skinnedNormals);
+				Benchmarks::DoNotOptimize(skinnedNormals.x.data());
+			});
+			state.Measure("Linear blend positions only" + suffix, vertexCount, [&] {
+				Skinning::LinearBlend(matrices, weights, positions, skinnedPositions);
+				Benchmarks::DoNotOptimize(skinnedPositions.x.data());
+			});
+			state.Measure("Linear blend parallel" + suffix, vertexCount, [&] {
+				Skinning::LinearBlend(Parallel::par, matrices, weights, positions, normals, skinnedPositions, skinnedNormals);
+				Benchmarks::DoNotOptimize(skinnedNormals.x.data());
+			});
+
+			state.Measure("Dual quaternion blend positions only" + suffix, vertexCount, [&] {
+				Skinning::DualQuaternionBlend(dualQuaternions, weights, positions, skinnedPositions);
+				Benchmarks::DoNotOptimize(skinnedPositions.x.data());
+			});
+			state.Measure("Dual quaternion blend parallel" + suffix, vertexCount, [&] {
+				Skinning::DualQuaternionBlend(Parallel::par, dualQuaternions, weights, positions, normals, skinnedPositions, skinnedNormals);
+				Benchmarks::DoNotOptimize(skinnedNormals.x.data());
+			});
+		}
+	}
+}
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../PMath.inl"
+#include "../PMathCpu.h"
+#include "../PMathParallel.h"
+#include "../PMathSpatialHash.h"
+
+using namespace PMgene::Math;
+
+namespace
+{
+	// A crowd of 100k agents on a 400 m square, about 10 neighbours within the query radius
+	constexpr size_t AgentCount = 100000;
+	constexpr float WorldSize = 400.f;
+	constexpr float Radius = 2.f;
+	constexpr size_t K = 8;
+
+	std::vector<Vector3> Agents()
+	{
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> position(0.f, WorldSize);
+
+		std::vector<Vector3> agents(AgentCount);
+		for (Vector3& A : agents)
+			A = Vector3(position(random), 0.f, position(random));
+		return agents;
+	}
+
+	// Compares the nearest query against sorting every agent by distance. Distances rather than
+	// indices are compared, since the SIMD kernels may round near-ties the other way.
+	float DistanceSquared(const Vector3& a, const Vector3& b) noexcept
+	{
+		const Vector3 d = a - b;
+		return d.Dot(d);
+	}
+
+	bool MatchesBruteForce(const std::vector<Vector3>& agents, const std::vector<uint32_t>& nearest, size_t centers, float radius, size_t k)
+	{
+		std::vector<float> expected;
+		for (size_t c = 0; c < centers; ++c)
+		{
+			expected.clear();
+			for (const Vector3& A : agents)
+			{
+				const float distance = DistanceSquared(A, agents[c]);
+				if (distance <= radius * radius)
+					expected.push_back(distance);
+			}
+			std::sort(expected.begin(), expected.end());
+			expected.resize(std::min({ expected.size(), k, SpatialHashGrid::MaxNearest }), 0.f);
+
+			const uint32_t* found = nearest.data() + c * k;
+			for (size_t j = 0; j < k; ++j)
+			{
+				if (j >= expected.size())
+				{
+					if (found[j] != SpatialHashGrid::InvalidIndex)
+						return false;
+				}
+				else if (found[j] == SpatialHashGrid::InvalidIndex ||
+				         std::fabs(DistanceSquared(agents[found[j]], agents[c]) - expected[j]) > 1e-3f)
+					return false;
+			}
+		}
+		return true;
+	}
+}
+
+PMATH_BENCHMARK(SpatialHashBuild)
+{
+	const std::vector<Vector3> agents = Agents();
+	SpatialHashGrid grid(Radius);
+
+	state.Measure("Build", AgentCount, [&] {
+		grid.Build(agents);
+		Benchmarks::DoNotOptimize(grid.Size());
+	});
+	state.Measure("Build parallel", AgentCount, [&] {
+		grid.Build(Parallel::par, agents);
+		Benchmarks::DoNotOptimize(grid.Size());
+	});
+}
+
+PMATH_BENCHMARK(SpatialHashQuery)
+{
+	const std::vector<Vector3> agents = Agents();
+	SpatialHashGrid grid(Radius);
+	grid.Build(agents);
+
+	std::vector<uint32_t> offsets, neighbours;
+	std::vector<uint32_t> nearest(AgentCount * K);
+
+	SetSimdLevel(SimdLevel::Scalar);
+	state.Measure("QueryRadius generic", AgentCount, [&] {
+		grid.QueryRadius(agents, Radius, offsets, neighbours);
+		Benchmarks::DoNotOptimize(neighbours.data());
+	});
+	state.Measure("QueryNearest generic", AgentCount, [&] {
+		grid.QueryNearest(agents, Radius, K, nearest);
+		Benchmarks::DoNotOptimize(nearest.data());
+	});
+
+	if (GetSupportedSimdLevel() >= SimdLevel::AVX2)
+	{
+		SetSimdLevel(SimdLevel::AVX2);
+		state.Measure("QueryRadius AVX2", AgentCount, [&] {
+			grid.QueryRadius(agents, Radius, offsets, neighbours);
+			Benchmarks::DoNotOptimize(neighbours.data());
+		});
+		state.Measure("QueryNearest AVX2", AgentCount, [&] {
+			grid.QueryNearest(agents, Radius, K, nearest);
+			Benchmarks::DoNotOptimize(nearest.data());
+		});
+	}
+
+	SetSimdLevel(GetSupportedSimdLevel());
+	state.Measure("QueryRadius parallel", AgentCount, [&] {
+		grid.QueryRadius(Parallel::par, agents, Radius, offsets, neighbours);
+		Benchmarks::DoNotOptimize(neighbours.data());
+	});
+	state.Measure("QueryNearest parallel", AgentCount, [&] {
+		grid.QueryNearest(Parallel::par, agents, Radius, K, nearest);
+		Benchmarks::DoNotOptimize(nearest.data());
+	});
+
+	// Every agent's own neighbours, walked in bucket order
+	state.Measure("QueryRadius all points", AgentCount, [&] {
+		grid.QueryRadius(Radius, offsets, neighbours);
+		Benchmarks::DoNotOptimize(neighbours.data());
+	});
+	state.Measure("QueryNearest all points", AgentCount, [&] {
+		grid.QueryNearest(Radius, K, nearest);
+		Benchmarks::DoNotOptimize(nearest.data());
+	});
+
+	// The whole per-tick cost for a crowd: rebuild, then every agent's neighbours
+	state.Measure("Build + QueryNearest all points parallel", AgentCount, [&] {
+		grid.Build(Parallel::par, agents);
+		grid.QueryNearest(Parallel::par, Radius, K, nearest);
+		Benchmarks::DoNotOptimize(nearest.data());
+	});
+}
+
+PMATH_BENCHMARK(SpatialHashQueryLargeK)
+{
+	// More neighbours than MaxNearest within the radius, and a k past it
+	constexpr float LargeRadius = 8.f;
+	constexpr size_t LargeK = SpatialHashGrid::MaxNearest + 16;
+	constexpr size_t CheckedCount = 256;
+
+	const std::vector<Vector3> agents = Agents();
+	SpatialHashGrid grid(LargeRadius);
+	grid.Build(agents);
+
+	const std::vector<Vector3> centers(agents.begin(), agents.begin() + CheckedCount);
+	std::vector<uint32_t> nearest(CheckedCount * LargeK);
+
+	SetSimdLevel(SimdLevel::Scalar);
+	grid.QueryNearest(centers, LargeRadius, LargeK, nearest);
+	if (!MatchesBruteForce(agents, nearest, CheckedCount, LargeRadius, LargeK))
+		std::fprintf(stderr, "SpatialHashQueryLargeK: generic QueryNearest differs from brute force\n");
+	state.Measure("QueryNearest k > MaxNearest generic", CheckedCount, [&] {
+		grid.QueryNearest(centers, LargeRadius, LargeK, nearest);
+		Benchmarks::DoNotOptimize(nearest.data());
+	});
+
+	if (GetSupportedSimdLevel() >= SimdLevel::AVX2)
+	{
+		SetSimdLevel(SimdLevel::AVX2);
+		grid.QueryNearest(centers, LargeRadius, LargeK, nearest);
+		if (!MatchesBruteForce(agents, nearest, CheckedCount, LargeRadius, LargeK))
+			std::fprintf(stderr, "SpatialHashQueryLargeK: AVX2 QueryNearest differs from brute force\n");
+		state.Measure("QueryNearest k > MaxNearest AVX2", CheckedCount, [&] {
+			grid.QueryNearest(centers, LargeRadius, LargeK, nearest);
+			Benchmarks::DoNotOptimize(nearest.data());
+		});
+	}
+
+	SetSimdLevel(GetSupportedSimdLevel());
+
+	// The single query takes k from the span
+	std::vector<uint32_t> single(LargeK);
+	grid.QueryNearest(agents[0], LargeRadius, single);
+	if (!std::equal(single.begin(), single.end(), nearest.begin()))
+		std::fprintf(stderr, "SpatialHashQueryLargeK: single QueryNearest differs from the batch\n");
+}
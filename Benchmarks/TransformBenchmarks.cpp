@@ -0,0 +1,222 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../PMath.inl"
+
+using namespace PMgene::Math;
+
+// DirectXMath has no affine or SQT type, so the counterparts go through XMMATRIX: XMLoadFloat3x4
+// reads an AffineTransform as the Matrix it stands for.
+
+namespace
+{
+	constexpr size_t Count = 256;
+
+	std::vector<SQT> RandomSQTs(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+		std::uniform_real_distribution<float> scale(0.5f, 2.f);
+		std::uniform_real_distribution<float> offset(-100.f, 100.f);
+
+		std::vector<SQT> result(count);
+		for (SQT& T : result)
+		{
+			const float s = scale(random);
+			T.scale = Vector3(s);
+			T.rotation = Quaternion::CreateFromYawPitchRoll(angle(random), angle(random), angle(random));
+			T.translation = Vector3(offset(random), offset(random), offset(random));
+		}
+		return result;
+	}
+
+	std::vector<AffineTransform> ToAffine(const std::vector<SQT>& transforms)
+	{
+		std::vector<AffineTransform> result(transforms.size());
+		for (size_t i = 0; i < transforms.size(); ++i)
+			result[i] = transforms[i].ToAffineTransform();
+		return result;
+	}
+
+	std::vector<Vector3> RandomVectors(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> value(-10.f, 10.f);
+
+		std::vector<Vector3> result(count);
+		for (Vector3& V : result)
+			V = Vector3(value(random), value(random), value(random));
+		return result;
+	}
+
+	XMFLOAT3X4 StoreAffine(FXMMATRIX M) noexcept
+	{
+		XMFLOAT3X4 R;
+		XMStoreFloat3x4(&R, M);
+		return R;
+	}
+
+	XMFLOAT4X4 Store(FXMMATRIX M) noexcept
+	{
+		XMFLOAT4X4 R;
+		XMStoreFloat4x4(&R, M);
+		return R;
+	}
+
+	XMFLOAT3 Store(FXMVECTOR V) noexcept
+	{
+		XMFLOAT3 R;
+		XMStoreFloat3(&R, V);
+		return R;
+	}
+
+	XMMATRIX Load(const SQT& T) noexcept
+	{
+		return XMMatrixAffineTransformation(XMLoadFloat3(&T.scale), XMVectorZero(), XMLoadFloat4(&T.rotation), XMLoadFloat3(&T.translation));
+	}
+}
+
+PMATH_BENCHMARK(AffineTransformOperations)
+{
+	const std::vector<AffineTransform> a = ToAffine(RandomSQTs(Count, 1));
+	const std::vector<AffineTransform> b = ToAffine(RandomSQTs(Count, 2));
+	const std::vector<Vector3> v = RandomVectors(Count, 3);
+	std::vector<AffineTransform> result(Count);
+	std::vector<XMFLOAT3X4> raw(Count);
+	std::vector<Matrix> matrices(Count);
+	std::vector<XMFLOAT4X4> rawMatrices(Count);
+	std::vector<Vector3> vectors(Count);
+	std::vector<XMFLOAT3> rawVectors(Count);
+	std::vector<float> scalars(Count);
+	std::vector<uint8_t> flags(Count);
+	std::vector<SQT> parts(Count);
+
+	for (size_t i = 0; i < Count; ++i)
+		matrices[i] = a[i].ToMatrix();
+	const std::vector<Matrix> sources = matrices;
+
+	state.Compare("AffineTransform(Matrix)", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return AffineTransform(sources[i]); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return StoreAffine(XMLoadFloat4x4(&sources[i])); }));
+	state.Compare("ToMatrix", Count,
+		Benchmarks::Loop(matrices, [&](size_t i) { return a[i].ToMatrix(); }),
+		Benchmarks::Loop(rawMatrices, [&](size_t i) { return Store(XMLoadFloat3x4(&a[i])); }));
+
+	state.Compare("operator==", Count,
+		Benchmarks::Loop(flags, [&](size_t i) { return uint8_t(a[i] == b[i]); }),
+		Benchmarks::Loop(flags, [&](size_t i) {
+			const XMMATRIX X = XMLoadFloat3x4(&a[i]);
+			const XMMATRIX Y = XMLoadFloat3x4(&b[i]);
+			return uint8_t(XMVector4Equal(X.r[0], Y.r[0]) && XMVector4Equal(X.r[1], Y.r[1]) &&
+			               XMVector4Equal(X.r[2], Y.r[2]) && XMVector4Equal(X.r[3], Y.r[3]));
+		}));
+
+	const auto rawMultiply = [&](size_t i) { return StoreAffine(XMMatrixMultiply(XMLoadFloat3x4(&a[i]), XMLoadFloat3x4(&b[i]))); };
+	state.Compare("operator*", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] * b[i]; }),
+		Benchmarks::Loop(raw, rawMultiply));
+	state.Compare("operator*=", Count,
+		Benchmarks::Loop(result, [&](size_t i) { AffineTransform R = a[i]; R *= b[i]; return R; }),
+		Benchmarks::Loop(raw, rawMultiply));
+
+	state.Compare("Decompose", Count,
+		Benchmarks::Loop(parts, [&](size_t i) { SQT P{}; a[i].Decompose(P); return P; }),
+		Benchmarks::Loop(parts, [&](size_t i) {
+			XMVECTOR S{}, R{}, T{};
+			XMMatrixDecompose(&S, &R, &T, XMLoadFloat3x4(&a[i]));
+
+			SQT P{};
+			XMStoreFloat3(&P.scale, S);
+			XMStoreFloat4(&P.rotation, R);
+			XMStoreFloat3(&P.translation, T);
+			return P;
+		}));
+
+	// Both inverses are measured against the general XMMatrixInverse one would use otherwise
+	const auto rawInvert = [&](size_t i) { XMVECTOR det; return StoreAffine(XMMatrixInverse(&det, XMLoadFloat3x4(&a[i]))); };
+	state.Compare("Invert", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i].Invert(); }),
+		Benchmarks::Loop(raw, rawInvert));
+	state.Compare("Invert to result", Count,
+		Benchmarks::Loop(result, [&](size_t i) { AffineTransform R; a[i].Invert(R); return R; }),
+		Benchmarks::Loop(raw, rawInvert));
+	state.Compare("InvertOrthonormal", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i].InvertOrthonormal(); }),
+		Benchmarks::Loop(raw, rawInvert));
+	state.Compare("InvertOrthonormal to result", Count,
+		Benchmarks::Loop(result, [&](size_t i) { AffineTransform R; a[i].InvertOrthonormal(R); return R; }),
+		Benchmarks::Loop(raw, rawInvert));
+
+	state.Compare("Determinant", Count,
+		Benchmarks::Loop(scalars, [&](size_t i) { return a[i].Determinant(); }),
+		Benchmarks::Loop(scalars, [&](size_t i) { return XMVectorGetX(XMMatrixDeterminant(XMLoadFloat3x4(&a[i]))); }));
+
+	state.Compare("TransformPoint", Count,
+		Benchmarks::Loop(vectors, [&](size_t i) { return a[i].TransformPoint(v[i]); }),
+		Benchmarks::Loop(rawVectors, [&](size_t i) { return Store(XMVector3Transform(XMLoadFloat3(&v[i]), XMLoadFloat3x4(&a[i]))); }));
+	state.Compare("TransformNormal", Count,
+		Benchmarks::Loop(vectors, [&](size_t i) { return a[i].TransformNormal(v[i]); }),
+		Benchmarks::Loop(rawVectors, [&](size_t i) { return Store(XMVector3TransformNormal(XMLoadFloat3(&v[i]), XMLoadFloat3x4(&a[i]))); }));
+}
+
+PMATH_BENCHMARK(SQTOperations)
+{
+	const std::vector<SQT> a = RandomSQTs(Count, 4);
+	const std::vector<SQT> b = RandomSQTs(Count, 5);
+	const std::vector<Vector3> v = RandomVectors(Count, 6);
+	std::vector<SQT> result(Count);
+	std::vector<Matrix> matrices(Count);
+	std::vector<XMFLOAT4X4> rawMatrices(Count);
+	std::vector<AffineTransform> affine(Count);
+	std::vector<XMFLOAT3X4> rawAffine(Count);
+	std::vector<Vector3> vectors(Count);
+	std::vector<XMFLOAT3> rawVectors(Count);
+	std::vector<uint8_t> flags(Count);
+
+	state.Compare("ToMatrix", Count,
+		Benchmarks::Loop(matrices, [&](size_t i) { return a[i].ToMatrix(); }),
+		Benchmarks::Loop(rawMatrices, [&](size_t i) { return Store(Load(a[i])); }));
+	state.Compare("ToAffineTransform", Count,
+		Benchmarks::Loop(affine, [&](size_t i) { return a[i].ToAffineTransform(); }),
+		Benchmarks::Loop(rawAffine, [&](size_t i) { return StoreAffine(Load(a[i])); }));
+
+	state.Compare("operator==", Count,
+		Benchmarks::Loop(flags, [&](size_t i) { return uint8_t(a[i] == b[i]); }),
+		Benchmarks::Loop(flags, [&](size_t i) {
+			return uint8_t(XMVector3Equal(XMLoadFloat3(&a[i].scale), XMLoadFloat3(&b[i].scale)) &&
+			               XMQuaternionEqual(XMLoadFloat4(&a[i].rotation), XMLoadFloat4(&b[i].rotation)) &&
+			               XMVector3Equal(XMLoadFloat3(&a[i].translation), XMLoadFloat3(&b[i].translation)));
+		}));
+
+	// The DirectXMath route to composing and inverting SQTs is through matrices
+	const auto rawMultiply = [&](size_t i) { return Store(XMMatrixMultiply(Load(a[i]), Load(b[i]))); };
+	state.Compare("operator*", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] * b[i]; }),
+		Benchmarks::Loop(rawMatrices, rawMultiply));
+	state.Compare("operator*=", Count,
+		Benchmarks::Loop(result, [&](size_t i) { SQT R = a[i]; R *= b[i]; return R; }),
+		Benchmarks::Loop(rawMatrices, rawMultiply));
+
+	const auto rawInvert = [&](size_t i) { XMVECTOR det; return Store(XMMatrixInverse(&det, Load(a[i]))); };
+	state.Compare("Invert", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i].Invert(); }),
+		Benchmarks::Loop(rawMatrices, rawInvert));
+	state.Compare("Invert to result", Count,
+		Benchmarks::Loop(result, [&](size_t i) { SQT R{}; a[i].Invert(R); return R; }),
+		Benchmarks::Loop(rawMatrices, rawInvert));
+
+	state.Compare("TransformPoint", Count,
+		Benchmarks::Loop(vectors, [&](size_t i) { return a[i].TransformPoint(v[i]); }),
+		Benchmarks::Loop(rawVectors, [&](size_t i) {
+			const XMVECTOR scaled = XMVectorMultiply(XMLoadFloat3(&v[i]), XMLoadFloat3(&a[i].scale));
+			return Store(XMVectorAdd(XMVector3Rotate(scaled, XMLoadFloat4(&a[i].rotation)), XMLoadFloat3(&a[i].translation)));
+		}));
+	state.Compare("TransformNormal", Count,
+		Benchmarks::Loop(vectors, [&](size_t i) { return a[i].TransformNormal(v[i]); }),
+		Benchmarks::Loop(rawVectors, [&](size_t i) {
+			const XMVECTOR scaled = XMVectorMultiply(XMLoadFloat3(&v[i]), XMLoadFloat3(&a[i].scale));
+			return Store(XMVector3Rotate(scaled, XMLoadFloat4(&a[i].rotation)));
+		}));
+}
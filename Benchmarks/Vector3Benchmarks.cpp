@@ -0,0 +1,132 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../PMath.inl"
+
+using namespace PMgene::Math;
+
+namespace
+{
+	// Small enough to stay in L1, so the numbers are about the arithmetic and the wrappers
+	constexpr size_t Count = 1024;
+
+	std::vector<Vector3> RandomVectors(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> value(0.5f, 10.f);
+
+		std::vector<Vector3> result(count);
+		for (Vector3& V : result)
+			V = Vector3(value(random), value(random), value(random));
+		return result;
+	}
+
+	std::vector<float> RandomScalars(size_t count, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> value(0.5f, 10.f);
+
+		std::vector<float> result(count);
+		for (float& S : result)
+			S = value(random);
+		return result;
+	}
+
+	XMFLOAT3 Store(FXMVECTOR V) noexcept
+	{
+		XMFLOAT3 R;
+		XMStoreFloat3(&R, V);
+		return R;
+	}
+}
+
+PMATH_BENCHMARK(Vector3Operators)
+{
+	const std::vector<Vector3> a = RandomVectors(Count, 1);
+	const std::vector<Vector3> b = RandomVectors(Count, 2);
+	const std::vector<float> s = RandomScalars(Count, 3);
+	std::vector<Vector3> result(Count);
+	std::vector<XMFLOAT3> raw(Count);
+	std::vector<uint8_t> flags(Count);
+
+	state.Compare("operator==", Count,
+		Benchmarks::Loop(flags, [&](size_t i) { return uint8_t(a[i] == b[i]); }),
+		Benchmarks::Loop(flags, [&](size_t i) { return uint8_t(XMVector3Equal(XMLoadFloat3(&a[i]), XMLoadFloat3(&b[i]))); }));
+	state.Compare("operator!=", Count,
+		Benchmarks::Loop(flags, [&](size_t i) { return uint8_t(a[i] != b[i]); }),
+		Benchmarks::Loop(flags, [&](size_t i) { return uint8_t(XMVector3NotEqual(XMLoadFloat3(&a[i]), XMLoadFloat3(&b[i]))); }));
+
+	state.Compare("operator+=", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Vector3 R = a[i]; R += b[i]; return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVectorAdd(XMLoadFloat3(&a[i]), XMLoadFloat3(&b[i]))); }));
+	state.Compare("operator-=", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Vector3 R = a[i]; R -= b[i]; return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVectorSubtract(XMLoadFloat3(&a[i]), XMLoadFloat3(&b[i]))); }));
+	state.Compare("operator*= vector", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Vector3 R = a[i]; R *= b[i]; return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVectorMultiply(XMLoadFloat3(&a[i]), XMLoadFloat3(&b[i]))); }));
+	state.Compare("operator*= scalar", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Vector3 R = a[i]; R *= s[i]; return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVectorScale(XMLoadFloat3(&a[i]), s[i])); }));
+	state.Compare("operator/= scalar", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Vector3 R = a[i]; R /= s[i]; return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVectorScale(XMLoadFloat3(&a[i]), 1.f / s[i])); }));
+
+	state.Compare("operator- unary", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return -a[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVectorNegate(XMLoadFloat3(&a[i]))); }));
+
+	state.Compare("operator+", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] + b[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVectorAdd(XMLoadFloat3(&a[i]), XMLoadFloat3(&b[i]))); }));
+	state.Compare("operator-", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] - b[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVectorSubtract(XMLoadFloat3(&a[i]), XMLoadFloat3(&b[i]))); }));
+	state.Compare("operator* vector", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] * b[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVectorMultiply(XMLoadFloat3(&a[i]), XMLoadFloat3(&b[i]))); }));
+	state.Compare("operator* scalar", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] * s[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVectorScale(XMLoadFloat3(&a[i]), s[i])); }));
+	state.Compare("operator* scalar first", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return s[i] * a[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVectorScale(XMLoadFloat3(&a[i]), s[i])); }));
+	state.Compare("operator/ vector", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] / b[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVectorDivide(XMLoadFloat3(&a[i]), XMLoadFloat3(&b[i]))); }));
+	state.Compare("operator/ scalar", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i] / s[i]; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVectorScale(XMLoadFloat3(&a[i]), 1.f / s[i])); }));
+}
+
+PMATH_BENCHMARK(Vector3Operations)
+{
+	const std::vector<Vector3> a = RandomVectors(Count, 4);
+	const std::vector<Vector3> b = RandomVectors(Count, 5);
+	std::vector<Vector3> result(Count);
+	std::vector<XMFLOAT3> raw(Count);
+	std::vector<float> scalars(Count);
+
+	state.Compare("Length", Count,
+		Benchmarks::Loop(scalars, [&](size_t i) { return a[i].Length(); }),
+		Benchmarks::Loop(scalars, [&](size_t i) { return XMVectorGetX(XMVector3Length(XMLoadFloat3(&a[i]))); }));
+	state.Compare("Dot", Count,
+		Benchmarks::Loop(scalars, [&](size_t i) { return a[i].Dot(b[i]); }),
+		Benchmarks::Loop(scalars, [&](size_t i) { return XMVectorGetX(XMVector3Dot(XMLoadFloat3(&a[i]), XMLoadFloat3(&b[i]))); }));
+
+	state.Compare("Cross", Count,
+		Benchmarks::Loop(result, [&](size_t i) { return a[i].Cross(b[i]); }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVector3Cross(XMLoadFloat3(&a[i]), XMLoadFloat3(&b[i]))); }));
+	state.Compare("Cross to result", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Vector3 R; a[i].Cross(b[i], R); return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVector3Cross(XMLoadFloat3(&a[i]), XMLoadFloat3(&b[i]))); }));
+
+	state.Compare("Normalize", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Vector3 R = a[i]; R.Normalize(); return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVector3Normalize(XMLoadFloat3(&a[i]))); }));
+	state.Compare("Normalize to result", Count,
+		Benchmarks::Loop(result, [&](size_t i) { Vector3 R; a[i].Normalize(R); return R; }),
+		Benchmarks::Loop(raw, [&](size_t i) { return Store(XMVector3Normalize(XMLoadFloat3(&a[i]))); }));
+}
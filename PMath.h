@@ -1,14 +1,159 @@
 #pragma once
 #include <cstring>
+#include <span>
 #include <DirectXMath.h>
 
 using namespace DirectX;
 
 namespace PMgene::Math
 {
+	struct Vector2;
 	struct Vector3;
+	struct Vector4;
 	struct Quaternion;
 	struct Matrix;
+	struct Matrix3;
+	struct AffineTransform;
+	struct SQT;
+	struct Plane;
+	struct Ray;
+	struct BoundingSphere;
+	struct AABB;
+	struct Vector3Stream;
+
+	namespace Parallel
+	{
+		struct ParallelPolicy;
+	}
+
+	// Arithmetic, Dot, Cross, Transpose, Concatenate and the translation, scale, rotation and
+	// projection factories are constexpr, so tables of them can be built at compile time. Their
+	// definitions are in PMath.inl.
+
+
+	//****************************************************************************
+	// Precision
+	// Accuracy traded for speed per call site, as the template argument of the functions below and
+	// of Length, Normalize and ToEuler. Exact is the default and keeps the full-precision path.
+	// Fast refines the reciprocal square root estimate with one Newton-Raphson step and uses a
+	// 15-degree atan minimax polynomial. Its Sqrt, Length, Reciprocal, Sin and Cos are those of
+	// Exact: the hardware square root and divide and the C library's sinf and cosf are no slower.
+	// Estimate takes the hardware estimates as they are, with 7-degree sin/atan and 6-degree cos
+	// polynomials. Estimate Sin and Cos cost about as much as Exact on a dependency chain and pay
+	// off in loops, which vectorize since they do not branch. Maximum errors measured over random
+	// inputs, trigonometry over [-4pi, 4pi]:
+	//
+	//                                  Fast                     Estimate
+	//   Sqrt, Reciprocal               0.5 ulp, as Exact        1.5 * 2^-12 relative
+	//   Length                         1.5 ulp, as Exact        1.5 * 2^-12 relative
+	//   ReciprocalSqrt                 4 ulp                    1.5 * 2^-12 relative
+	//   Normalize                      5 ulp                    1.5 * 2^-12 relative
+	//   Sin, Cos                       as Exact                 1e-5 absolute
+	//   Atan2, ToEuler                 4 ulp, 4e-7 absolute     5.2e-4 relative, 4e-4 absolute
+	//
+	// The Estimate bounds of the algebraic functions are the documented accuracy of rsqrtps and
+	// rcpps. Fast and Estimate keep zero for the square root and length of zero and for the normal
+	// of a zero vector, like Exact, and fall back to the exact path where a squared length is
+	// denormal, so vectors as short as 1e-20 still normalize to unit length. They do not handle
+	// infinities.
+
+	enum class Precision
+	{
+		Exact,
+		Fast,
+		Estimate
+	};
+
+	template <Precision P = Precision::Exact>
+	[[nodiscard]] float Sqrt(float x) noexcept;
+	template <Precision P = Precision::Exact>
+	[[nodiscard]] float ReciprocalSqrt(float x) noexcept;
+	template <Precision P = Precision::Exact>
+	[[nodiscard]] float Reciprocal(float x) noexcept;
+
+	// Angles in radians
+	template <Precision P = Precision::Exact>
+	[[nodiscard]] float Sin(float angle) noexcept;
+	template <Precision P = Precision::Exact>
+	[[nodiscard]] float Cos(float angle) noexcept;
+	template <Precision P = Precision::Exact>
+	void SinCos(float angle, float& sin, float& cos) noexcept;
+	template <Precision P = Precision::Exact>
+	[[nodiscard]] float Atan2(float y, float x) noexcept;
+
+
+	//****************************************************************************
+	// Vector2
+
+	struct Vector2 : public XMFLOAT2
+	{
+		// Constructors
+		constexpr Vector2() noexcept : XMFLOAT2(0.f, 0.f)
+		{
+		}
+
+		constexpr Vector2(float ix, float iy) noexcept : XMFLOAT2(ix, iy)
+		{
+		}
+
+		constexpr Vector2(const float ix) noexcept : XMFLOAT2(ix, ix)
+		{
+		}
+
+		explicit constexpr Vector2(const XMFLOAT2& V) noexcept : XMFLOAT2(V.x, V.y)
+		{
+		}
+
+		// Comparison operators
+		constexpr bool operator ==(const Vector2& V) const noexcept;
+		constexpr bool operator !=(const Vector2& V) const noexcept;
+
+		// Assignment operators
+		constexpr Vector2& operator+=(const Vector2& V) noexcept;
+		constexpr Vector2& operator-=(const Vector2& V) noexcept;
+		constexpr Vector2& operator*=(const Vector2& V) noexcept;
+		constexpr Vector2& operator*=(float S) noexcept;
+		constexpr Vector2& operator/=(float S) noexcept;
+
+		// Unary operators
+		constexpr Vector2 operator+() const noexcept { return *this; }
+		constexpr Vector2 operator-() const noexcept;
+
+		// Vector operations
+		template <Precision P = Precision::Exact>
+		[[nodiscard]] float Length() const noexcept;
+
+		[[nodiscard]] constexpr float Dot(const Vector2& V) const noexcept;
+		// z of the 3D cross product, positive when V is counter-clockwise from this vector
+		[[nodiscard]] constexpr float Cross(const Vector2& V) const noexcept;
+
+		template <Precision P = Precision::Exact>
+		void Normalize() noexcept;
+		template <Precision P = Precision::Exact>
+		void Normalize(Vector2& result) const noexcept;
+
+		// Constants
+		static const Vector2 Zero;
+		static const Vector2 One;
+		static const Vector2 UnitX;
+		static const Vector2 UnitY;
+	};
+
+	// Binary operators
+	constexpr Vector2 operator+(const Vector2& V1, const Vector2& V2) noexcept;
+	constexpr Vector2 operator-(const Vector2& V1, const Vector2& V2) noexcept;
+	constexpr Vector2 operator*(const Vector2& V1, const Vector2& V2) noexcept;
+	constexpr Vector2 operator*(const Vector2& V, float S) noexcept;
+	constexpr Vector2 operator/(const Vector2& V1, const Vector2& V2) noexcept;
+	constexpr Vector2 operator/(const Vector2& V, float S) noexcept;
+	constexpr Vector2 operator*(float S, const Vector2& V) noexcept;
+
+	// Constants
+	inline constexpr Vector2 Vector2::Zero = { 0.f, 0.f };
+	inline constexpr Vector2 Vector2::One = { 1.f, 1.f };
+	inline constexpr Vector2 Vector2::UnitX = { 1.f, 0.f };
+	inline constexpr Vector2 Vector2::UnitY = { 0.f, 1.f };
+
 
 
 	//****************************************************************************
@@ -17,7 +162,7 @@ namespace PMgene::Math
 	struct Vector3 : public XMFLOAT3
 	{
 		// Constructors
-		Vector3() noexcept : XMFLOAT3(0.f, 0.f, 0.f)
+		constexpr Vector3() noexcept : XMFLOAT3(0.f, 0.f, 0.f)
 		{
 		}
 
@@ -25,40 +170,40 @@ namespace PMgene::Math
 		{
 		}
 
-		Vector3(const float ix) noexcept : XMFLOAT3(ix, ix, ix)
+		constexpr Vector3(const float ix) noexcept : XMFLOAT3(ix, ix, ix)
 		{
 		}
 
-		explicit Vector3(const XMFLOAT3& V) noexcept : XMFLOAT3()
+		explicit constexpr Vector3(const XMFLOAT3& V) noexcept : XMFLOAT3(V.x, V.y, V.z)
 		{
-			this->x = V.x;
-			this->y = V.y;
-			this->z = V.z;
 		}
 
 		// Comparison operators
-		bool operator ==(const Vector3& V) const noexcept;
-		bool operator !=(const Vector3& V) const noexcept;
+		constexpr bool operator ==(const Vector3& V) const noexcept;
+		constexpr bool operator !=(const Vector3& V) const noexcept;
 
 		// Assignment operators
-		Vector3& operator+=(const Vector3& V) noexcept;
-		Vector3& operator-=(const Vector3& V) noexcept;
-		Vector3& operator*=(const Vector3& V) noexcept;
-		Vector3& operator*=(float S) noexcept;
-		Vector3& operator/=(float S) noexcept;
+		constexpr Vector3& operator+=(const Vector3& V) noexcept;
+		constexpr Vector3& operator-=(const Vector3& V) noexcept;
+		constexpr Vector3& operator*=(const Vector3& V) noexcept;
+		constexpr Vector3& operator*=(float S) noexcept;
+		constexpr Vector3& operator/=(float S) noexcept;
 
 		// Unary operators
-		Vector3 operator+() const noexcept { return *this; }
-		Vector3 operator-() const noexcept;
+		constexpr Vector3 operator+() const noexcept { return *this; }
+		constexpr Vector3 operator-() const noexcept;
 
 		// Vector operations
+		template <Precision P = Precision::Exact>
 		[[nodiscard]] float Length() const noexcept;
 
-		[[nodiscard]] float Dot(const Vector3& V) const noexcept;
-		void Cross(const Vector3& V, Vector3& result) const noexcept;
-		[[nodiscard]] Vector3 Cross(const Vector3& V) const noexcept;
+		[[nodiscard]] constexpr float Dot(const Vector3& V) const noexcept;
+		constexpr void Cross(const Vector3& V, Vector3& result) const noexcept;
+		[[nodiscard]] constexpr Vector3 Cross(const Vector3& V) const noexcept;
 
+		template <Precision P = Precision::Exact>
 		void Normalize() noexcept;
+		template <Precision P = Precision::Exact>
 		void Normalize(Vector3& result) const noexcept;
 
 		// Constants
@@ -70,13 +215,102 @@ namespace PMgene::Math
 	};
 
 	// Binary operators
-	Vector3 operator+(const Vector3& V1, const Vector3& V2) noexcept;
-	Vector3 operator-(const Vector3& V1, const Vector3& V2) noexcept;
-	Vector3 operator*(const Vector3& V1, const Vector3& V2) noexcept;
-	Vector3 operator*(const Vector3& V, float S) noexcept;
-	Vector3 operator/(const Vector3& V1, const Vector3& V2) noexcept;
-	Vector3 operator/(const Vector3& V, float S) noexcept;
-	Vector3 operator*(float S, const Vector3& V) noexcept;
+	constexpr Vector3 operator+(const Vector3& V1, const Vector3& V2) noexcept;
+	constexpr Vector3 operator-(const Vector3& V1, const Vector3& V2) noexcept;
+	constexpr Vector3 operator*(const Vector3& V1, const Vector3& V2) noexcept;
+	constexpr Vector3 operator*(const Vector3& V, float S) noexcept;
+	constexpr Vector3 operator/(const Vector3& V1, const Vector3& V2) noexcept;
+	constexpr Vector3 operator/(const Vector3& V, float S) noexcept;
+	constexpr Vector3 operator*(float S, const Vector3& V) noexcept;
+
+	// Constants
+	inline constexpr Vector3 Vector3::Zero = { 0.f, 0.f, 0.f };
+	inline constexpr Vector3 Vector3::One = { 1.f, 1.f, 1.f };
+	inline constexpr Vector3 Vector3::UnitX = { 1.f, 0.f, 0.f };
+	inline constexpr Vector3 Vector3::UnitY = { 0.f, 1.f, 0.f };
+	inline constexpr Vector3 Vector3::UnitZ = { 0.f, 0.f, 1.f };
+
+
+
+	//****************************************************************************
+	// Vector4
+
+	struct Vector4 : public XMFLOAT4
+	{
+		// Constructors
+		constexpr Vector4() noexcept : XMFLOAT4(0.f, 0.f, 0.f, 0.f)
+		{
+		}
+
+		constexpr Vector4(float ix, float iy, float iz, float iw) noexcept : XMFLOAT4(ix, iy, iz, iw)
+		{
+		}
+
+		constexpr Vector4(const float ix) noexcept : XMFLOAT4(ix, ix, ix, ix)
+		{
+		}
+
+		constexpr Vector4(const Vector3& V, float iw) noexcept : XMFLOAT4(V.x, V.y, V.z, iw)
+		{
+		}
+
+		explicit constexpr Vector4(const XMFLOAT4& V) noexcept : XMFLOAT4(V.x, V.y, V.z, V.w)
+		{
+		}
+
+		// Comparison operators
+		constexpr bool operator ==(const Vector4& V) const noexcept;
+		constexpr bool operator !=(const Vector4& V) const noexcept;
+
+		// Assignment operators
+		constexpr Vector4& operator+=(const Vector4& V) noexcept;
+		constexpr Vector4& operator-=(const Vector4& V) noexcept;
+		constexpr Vector4& operator*=(const Vector4& V) noexcept;
+		constexpr Vector4& operator*=(float S) noexcept;
+		constexpr Vector4& operator/=(float S) noexcept;
+
+		// Unary operators
+		constexpr Vector4 operator+() const noexcept { return *this; }
+		constexpr Vector4 operator-() const noexcept;
+
+		[[nodiscard]] constexpr Vector3 XYZ() const noexcept { return Vector3(x, y, z); }
+
+		// Vector operations
+		template <Precision P = Precision::Exact>
+		[[nodiscard]] float Length() const noexcept;
+
+		[[nodiscard]] constexpr float Dot(const Vector4& V) const noexcept;
+
+		template <Precision P = Precision::Exact>
+		void Normalize() noexcept;
+		template <Precision P = Precision::Exact>
+		void Normalize(Vector4& result) const noexcept;
+
+		// Constants
+		static const Vector4 Zero;
+		static const Vector4 One;
+		static const Vector4 UnitX;
+		static const Vector4 UnitY;
+		static const Vector4 UnitZ;
+		static const Vector4 UnitW;
+	};
+
+	// Binary operators
+	constexpr Vector4 operator+(const Vector4& V1, const Vector4& V2) noexcept;
+	constexpr Vector4 operator-(const Vector4& V1, const Vector4& V2) noexcept;
+	constexpr Vector4 operator*(const Vector4& V1, const Vector4& V2) noexcept;
+	constexpr Vector4 operator*(const Vector4& V, float S) noexcept;
+	constexpr Vector4 operator/(const Vector4& V1, const Vector4& V2) noexcept;
+	constexpr Vector4 operator/(const Vector4& V, float S) noexcept;
+	constexpr Vector4 operator*(float S, const Vector4& V) noexcept;
+
+	// Constants
+	inline constexpr Vector4 Vector4::Zero = { 0.f, 0.f, 0.f, 0.f };
+	inline constexpr Vector4 Vector4::One = { 1.f, 1.f, 1.f, 1.f };
+	inline constexpr Vector4 Vector4::UnitX = { 1.f, 0.f, 0.f, 0.f };
+	inline constexpr Vector4 Vector4::UnitY = { 0.f, 1.f, 0.f, 0.f };
+	inline constexpr Vector4 Vector4::UnitZ = { 0.f, 0.f, 1.f, 0.f };
+	inline constexpr Vector4 Vector4::UnitW = { 0.f, 0.f, 0.f, 1.f };
 
 
 
@@ -85,12 +319,11 @@ namespace PMgene::Math
 		// Quaternion
 	struct Quaternion : public XMFLOAT4
 	{
-		Quaternion() noexcept : XMFLOAT4(0, 0, 0, 1.f) {}
+		constexpr Quaternion() noexcept : XMFLOAT4(0, 0, 0, 1.f) {}
 		constexpr Quaternion(float ix, float iy, float iz, float iw) noexcept : XMFLOAT4(ix, iy, iz, iw) {}
-		Quaternion(const Vector3& v, float scalar) noexcept : XMFLOAT4(v.x, v.y, v.z, scalar) {}
+		constexpr Quaternion(const Vector3& v, float scalar) noexcept : XMFLOAT4(v.x, v.y, v.z, scalar) {}
 		explicit Quaternion(FXMVECTOR V) noexcept : XMFLOAT4() { XMStoreFloat4(this, V); }
-		explicit Quaternion(const XMFLOAT4& q) noexcept : XMFLOAT4()
-		{ this->x = q.x; this->y = q.y; this->z = q.z; this->w = q.w; }
+		explicit constexpr Quaternion(const XMFLOAT4& q) noexcept : XMFLOAT4(q.x, q.y, q.z, q.w) {}
 
 		Quaternion(const Quaternion&) = default;
 		Quaternion& operator=(const Quaternion&) = default;
@@ -101,33 +334,36 @@ namespace PMgene::Math
 		operator XMVECTOR() const noexcept { return XMLoadFloat4(this); }
 
 		// Comparison operators
-		bool operator == (const Quaternion& q) const noexcept;
-		bool operator != (const Quaternion& q) const noexcept;
+		constexpr bool operator == (const Quaternion& q) const noexcept;
+		constexpr bool operator != (const Quaternion& q) const noexcept;
 
 		// Assignment operators
 		Quaternion& operator= (const XMVECTORF32& F) noexcept { x = F.f[0]; y = F.f[1]; z = F.f[2]; w = F.f[3]; return *this; }
-		Quaternion& operator+= (const Quaternion& q) noexcept;
-		Quaternion& operator-= (const Quaternion& q) noexcept;
-		Quaternion& operator*= (const Quaternion& q) noexcept;
-		Quaternion& operator*= (float S) noexcept;
-		Quaternion& operator/= (const Quaternion& q) noexcept;
+		constexpr Quaternion& operator+= (const Quaternion& q) noexcept;
+		constexpr Quaternion& operator-= (const Quaternion& q) noexcept;
+		constexpr Quaternion& operator*= (const Quaternion& q) noexcept;
+		constexpr Quaternion& operator*= (float S) noexcept;
+		constexpr Quaternion& operator/= (const Quaternion& q) noexcept;
 
 		// Unary operators
-		Quaternion operator+ () const  noexcept { return *this; }
-		Quaternion operator- () const noexcept;
+		constexpr Quaternion operator+ () const  noexcept { return *this; }
+		constexpr Quaternion operator- () const noexcept;
 
 		// Quaternion operations
+		template <Precision P = Precision::Exact>
 		float Length() const noexcept;
 
+		template <Precision P = Precision::Exact>
 		void Normalize() noexcept;
 
-		void Conjugate() noexcept;
+		constexpr void Conjugate() noexcept;
 
-		void Inverse(Quaternion& result) const noexcept;
+		constexpr void Inverse(Quaternion& result) const noexcept;
 
-		float Dot(const Quaternion& Q) const noexcept;
+		constexpr float Dot(const Quaternion& Q) const noexcept;
 
 		// Computes rotation about y-axis (y), then x-axis (x), then z-axis (z)
+		template <Precision P = Precision::Exact>
 		Vector3 ToEuler() const noexcept;
 
 		// Static functions
@@ -147,7 +383,7 @@ namespace PMgene::Math
 		static void Slerp(const Quaternion& q1, const Quaternion& q2, float t, Quaternion& result) noexcept;
 		static Quaternion Slerp(const Quaternion& q1, const Quaternion& q2, float t) noexcept;
 		
-		static Quaternion Concatenate(const Quaternion& q1, const Quaternion& q2) noexcept;
+		static constexpr Quaternion Concatenate(const Quaternion& q1, const Quaternion& q2) noexcept;
 	
 		static float Angle(const Quaternion& q1, const Quaternion& q2) noexcept;
 
@@ -156,12 +392,15 @@ namespace PMgene::Math
 	};
 
 	// Binary operators
-	Quaternion operator+ (const Quaternion& Q1, const Quaternion& Q2) noexcept;
-	Quaternion operator- (const Quaternion& Q1, const Quaternion& Q2) noexcept;
-	Quaternion operator* (const Quaternion& Q1, const Quaternion& Q2) noexcept;
-	Quaternion operator* (const Quaternion& Q, float S) noexcept;
-	Quaternion operator/ (const Quaternion& Q1, const Quaternion& Q2) noexcept;
-	Quaternion operator* (float S, const Quaternion& Q) noexcept;
+	constexpr Quaternion operator+ (const Quaternion& Q1, const Quaternion& Q2) noexcept;
+	constexpr Quaternion operator- (const Quaternion& Q1, const Quaternion& Q2) noexcept;
+	constexpr Quaternion operator* (const Quaternion& Q1, const Quaternion& Q2) noexcept;
+	constexpr Quaternion operator* (const Quaternion& Q, float S) noexcept;
+	constexpr Quaternion operator/ (const Quaternion& Q1, const Quaternion& Q2) noexcept;
+	constexpr Quaternion operator* (float S, const Quaternion& Q) noexcept;
+
+	// Constants
+	inline constexpr Quaternion Quaternion::Identity = { 0.f, 0.f, 0.f, 1.f };
 
 
 
@@ -169,7 +408,7 @@ namespace PMgene::Math
 	// 4x4 Matrix
 	struct Matrix : public XMFLOAT4X4
 	{
-		Matrix() noexcept
+		constexpr Matrix() noexcept
 			: XMFLOAT4X4(1.f, 0, 0, 0,
 			             0, 1.f, 0, 0,
 			             0, 0, 1.f, 0,
@@ -188,7 +427,7 @@ namespace PMgene::Math
 		{
 		}
 
-		explicit Matrix(const Vector3& r0, const Vector3& r1, const Vector3& r2) noexcept
+		explicit constexpr Matrix(const Vector3& r0, const Vector3& r1, const Vector3& r2) noexcept
 			: XMFLOAT4X4(r0.x, r0.y, r0.z, 0,
 			             r1.x, r1.y, r1.z, 0,
 			             r2.x, r2.y, r2.z, 0,
@@ -210,32 +449,33 @@ namespace PMgene::Math
 		
 
 		// Comparison operators
-		bool operator ==(const Matrix& M) const noexcept;
-		bool operator !=(const Matrix& M) const noexcept;
+		constexpr bool operator ==(const Matrix& M) const noexcept;
+		constexpr bool operator !=(const Matrix& M) const noexcept;
 
 		// Assignment operators
 		Matrix& operator=(const XMFLOAT3X3& M) noexcept;
 		Matrix& operator=(const XMFLOAT4X3& M) noexcept;
-		Matrix& operator+=(const Matrix& M) noexcept;
-		Matrix& operator-=(const Matrix& M) noexcept;
-		Matrix& operator*=(const Matrix& M) noexcept;
-		Matrix& operator*=(float S) noexcept;
-		Matrix& operator/=(float S) noexcept;
+		constexpr Matrix& operator+=(const Matrix& M) noexcept;
+		constexpr Matrix& operator-=(const Matrix& M) noexcept;
+		constexpr Matrix& operator*=(const Matrix& M) noexcept;
+		constexpr Matrix& operator*=(float S) noexcept;
+		constexpr Matrix& operator/=(float S) noexcept;
 
-		Matrix& operator/=(const Matrix& M) noexcept;
+		constexpr Matrix& operator/=(const Matrix& M) noexcept;
 		// Element-wise divide
 
 		// Unary operators
-		Matrix operator+() const noexcept { return *this; }
-		Matrix operator-() const noexcept;
+		constexpr Matrix operator+() const noexcept { return *this; }
+		constexpr Matrix operator-() const noexcept;
 
-		[[nodiscard]] Vector3 Translation() const noexcept { return Vector3(_41, _42, _43); }
+		[[nodiscard]] constexpr Vector3 Translation() const noexcept { return Vector3(_41, _42, _43); }
 
 		// Matrix operations
-		bool Decompose(Vector3& scale, Quaternion& rotation, Vector3& translation) noexcept;
+		bool Decompose(Vector3& scale, Quaternion& rotation, Vector3& translation) const noexcept;
+		bool Decompose(SQT& result) const noexcept;
 
-		Matrix Transpose() const noexcept;
-		void Transpose(Matrix& result) const noexcept;
+		constexpr Matrix Transpose() const noexcept;
+		constexpr void Transpose(Matrix& result) const noexcept;
 
 		Matrix Invert() const noexcept;
 		void Invert(Matrix& result) const noexcept;
@@ -243,32 +483,69 @@ namespace PMgene::Math
 		float Determinant() const noexcept;
 
 		// Computes rotation about y-axis (y), then x-axis (x), then z-axis (z)
+		template <Precision P = Precision::Exact>
 		Vector3 ToEuler() const noexcept;
 
+		// Vector transforms: points use w = 1, normals w = 0, coords w = 1 followed by the divide by w
+		[[nodiscard]] Vector3 TransformPoint(const Vector3& V) const noexcept;
+		[[nodiscard]] Vector3 TransformNormal(const Vector3& V) const noexcept;
+		[[nodiscard]] Vector3 TransformCoord(const Vector3& V) const noexcept;
+		// Homogeneous transform, no divide by w
+		[[nodiscard]] Vector4 Transform(const Vector4& V) const noexcept;
+
+		// Batch transforms, output must have the same size as input and may alias it.
+		// Outputs larger than a few MB are written with non-temporal stores.
+		void TransformPoints(std::span<const Vector3> input, std::span<Vector3> output) const noexcept;
+		void TransformPoints(const Vector3Stream& input, Vector3Stream& output) const noexcept;
+		void TransformNormals(std::span<const Vector3> input, std::span<Vector3> output) const noexcept;
+		void TransformNormals(const Vector3Stream& input, Vector3Stream& output) const noexcept;
+		void TransformCoords(std::span<const Vector3> input, std::span<Vector3> output) const noexcept;
+		void TransformCoords(const Vector3Stream& input, Vector3Stream& output) const noexcept;
+
+		// Parallel batch transforms, split across the Parallel scheduler
+		void TransformPoints(const Parallel::ParallelPolicy& policy, std::span<const Vector3> input, std::span<Vector3> output) const noexcept;
+		void TransformPoints(const Parallel::ParallelPolicy& policy, const Vector3Stream& input, Vector3Stream& output) const noexcept;
+		void TransformNormals(const Parallel::ParallelPolicy& policy, std::span<const Vector3> input, std::span<Vector3> output) const noexcept;
+		void TransformNormals(const Parallel::ParallelPolicy& policy, const Vector3Stream& input, Vector3Stream& output) const noexcept;
+		void TransformCoords(const Parallel::ParallelPolicy& policy, std::span<const Vector3> input, std::span<Vector3> output) const noexcept;
+		void TransformCoords(const Parallel::ParallelPolicy& policy, const Vector3Stream& input, Vector3Stream& output) const noexcept;
+
+		// Batch concatenation, result[i] = a[i] * b[i]. All spans must have the same size, result may alias a or b
+		static void MultiplyBatch(std::span<const Matrix> a, std::span<const Matrix> b, std::span<Matrix> result) noexcept;
+
+		// Broadcast variants, result[i] = a * b[i] and result[i] = a[i] * b
+		static void MultiplyBatch(const Matrix& a, std::span<const Matrix> b, std::span<Matrix> result) noexcept;
+		static void MultiplyBatch(std::span<const Matrix> a, const Matrix& b, std::span<Matrix> result) noexcept;
+
+		// Parallel batch concatenation
+		static void MultiplyBatch(const Parallel::ParallelPolicy& policy, std::span<const Matrix> a, std::span<const Matrix> b, std::span<Matrix> result) noexcept;
+		static void MultiplyBatch(const Parallel::ParallelPolicy& policy, const Matrix& a, std::span<const Matrix> b, std::span<Matrix> result) noexcept;
+		static void MultiplyBatch(const Parallel::ParallelPolicy& policy, std::span<const Matrix> a, const Matrix& b, std::span<Matrix> result) noexcept;
+
 		
-		static Matrix CreateTranslation(const Vector3& position) noexcept;
-		static Matrix CreateTranslation(float x, float y, float z) noexcept;
+		static constexpr Matrix CreateTranslation(const Vector3& position) noexcept;
+		static constexpr Matrix CreateTranslation(float x, float y, float z) noexcept;
 
-		static Matrix CreateScale(const Vector3& scales) noexcept;
-		static Matrix CreateScale(float xs, float ys, float zs) noexcept;
-		static Matrix CreateScale(float scale) noexcept;
+		static constexpr Matrix CreateScale(const Vector3& scales) noexcept;
+		static constexpr Matrix CreateScale(float xs, float ys, float zs) noexcept;
+		static constexpr Matrix CreateScale(float scale) noexcept;
 
-		static Matrix CreateRotationX(float radians) noexcept;
-		static Matrix CreateRotationY(float radians) noexcept;
-		static Matrix CreateRotationZ(float radians) noexcept;
+		static constexpr Matrix CreateRotationX(float radians) noexcept;
+		static constexpr Matrix CreateRotationY(float radians) noexcept;
+		static constexpr Matrix CreateRotationZ(float radians) noexcept;
 
 		static Matrix CreateFromAxisAngle(const Vector3& axis, float angle) noexcept;
 
-		static Matrix CreatePerspectiveFieldOfView(float fov, float aspectRatio, float nearPlane,
-		                                           float farPlane) noexcept;
-		static Matrix CreatePerspective(float width, float height, float nearPlane, float farPlane) noexcept;
+		static constexpr Matrix CreatePerspectiveFieldOfView(float fov, float aspectRatio, float nearPlane,
+		                                                     float farPlane) noexcept;
+		static constexpr Matrix CreatePerspective(float width, float height, float nearPlane, float farPlane) noexcept;
 		
-		static Matrix CreateOrthographic(float width, float height, float zNearPlane, float zFarPlane) noexcept;
+		static constexpr Matrix CreateOrthographic(float width, float height, float zNearPlane, float zFarPlane) noexcept;
 		
 		static Matrix CreateLookAt(const Vector3& position, const Vector3& target, const Vector3& up) noexcept;
 		static Matrix CreateWorld(const Vector3& position, const Vector3& forward, const Vector3& up) noexcept;
 
-		static Matrix CreateFromQuaternion(const Quaternion& quat) noexcept;
+		static constexpr Matrix CreateFromQuaternion(const Quaternion& quat) noexcept;
 
 		// Rotates about y-axis (yaw), then x-axis (pitch), then z-axis (roll)
 		static Matrix CreateFromYawPitchRoll(float yaw, float pitch, float roll) noexcept;
@@ -287,12 +564,355 @@ namespace PMgene::Math
 	};
 
 	// Binary operators
-	Matrix operator+(const Matrix& M1, const Matrix& M2) noexcept;
-	Matrix operator-(const Matrix& M1, const Matrix& M2) noexcept;
-	Matrix operator*(const Matrix& M1, const Matrix& M2) noexcept;
-	Matrix operator*(const Matrix& M, float S) noexcept;
-	Matrix operator/(const Matrix& M, float S) noexcept;
-	Matrix operator/(const Matrix& M1, const Matrix& M2) noexcept;
+	constexpr Matrix operator+(const Matrix& M1, const Matrix& M2) noexcept;
+	constexpr Matrix operator-(const Matrix& M1, const Matrix& M2) noexcept;
+	constexpr Matrix operator*(const Matrix& M1, const Matrix& M2) noexcept;
+	constexpr Matrix operator*(const Matrix& M, float S) noexcept;
+	constexpr Matrix operator/(const Matrix& M, float S) noexcept;
+	constexpr Matrix operator/(const Matrix& M1, const Matrix& M2) noexcept;
 	// Element-wise divide
-	Matrix operator*(float S, const Matrix& M) noexcept;
+	constexpr Matrix operator*(float S, const Matrix& M) noexcept;
+
+	// Constants
+	inline constexpr Matrix Matrix::Identity = {
+		1.f, 0.f, 0.f, 0.f,
+		0.f, 1.f, 0.f, 0.f,
+		0.f, 0.f, 1.f, 0.f,
+		0.f, 0.f, 0.f, 1.f
+	};
+
+
+
+	//****************************************************************************
+	// 3x3 Matrix
+	// Rotation, scale and shear without the translation row and column, 36 bytes against the 64 of
+	// a Matrix, for inertia tensors, covariances and other 3x3 quantities. Same row-vector
+	// convention as Matrix: V * M, and M1 * M2 applies M1 first.
+	struct Matrix3 : public XMFLOAT3X3
+	{
+		// Constructors
+		constexpr Matrix3() noexcept
+			: XMFLOAT3X3(1.f, 0, 0,
+			             0, 1.f, 0,
+			             0, 0, 1.f)
+		{
+		}
+
+		constexpr Matrix3(float m00, float m01, float m02,
+		                  float m10, float m11, float m12,
+		                  float m20, float m21, float m22) noexcept
+			: XMFLOAT3X3(m00, m01, m02,
+			             m10, m11, m12,
+			             m20, m21, m22)
+		{
+		}
+
+		explicit constexpr Matrix3(const Vector3& r0, const Vector3& r1, const Vector3& r2) noexcept
+			: XMFLOAT3X3(r0.x, r0.y, r0.z,
+			             r1.x, r1.y, r1.z,
+			             r2.x, r2.y, r2.z)
+		{
+		}
+
+		// Upper-left 3x3 part of M
+		explicit Matrix3(const Matrix& M) noexcept;
+		explicit Matrix3(CXMMATRIX M) noexcept : XMFLOAT3X3() { XMStoreFloat3x3(this, M); }
+
+		Matrix3(const Matrix3&) = default;
+		Matrix3& operator=(const Matrix3&) = default;
+
+		Matrix3(Matrix3&&) = default;
+		Matrix3& operator=(Matrix3&&) = default;
+
+		// Comparison operators
+		bool operator ==(const Matrix3& M) const noexcept;
+		bool operator !=(const Matrix3& M) const noexcept;
+
+		// Assignment operators
+		Matrix3& operator+=(const Matrix3& M) noexcept;
+		Matrix3& operator-=(const Matrix3& M) noexcept;
+		Matrix3& operator*=(const Matrix3& M) noexcept;
+		Matrix3& operator*=(float S) noexcept;
+
+		// Unary operators
+		Matrix3 operator+() const noexcept { return *this; }
+		Matrix3 operator-() const noexcept;
+
+		[[nodiscard]] Vector3 Row(size_t i) const noexcept { return Vector3(m[i][0], m[i][1], m[i][2]); }
+
+		// Conversions
+		[[nodiscard]] Matrix ToMatrix() const noexcept;
+
+		// Matrix operations
+		Matrix3 Transpose() const noexcept;
+		void Transpose(Matrix3& result) const noexcept;
+
+		// Cofactors over the determinant; M must not be singular
+		Matrix3 Invert() const noexcept;
+		void Invert(Matrix3& result) const noexcept;
+
+		float Determinant() const noexcept;
+
+		// V * M
+		[[nodiscard]] Vector3 Transform(const Vector3& V) const noexcept;
+
+		// Diagonalizes a symmetric matrix by cyclic Jacobi rotations, reading the upper triangle only.
+		// Eigenvalues come out in decreasing order and row i of eigenvectors is the unit eigenvector
+		// of eigenvalue i. The rows form a rotation, so M = eigenvectors^T * diag(eigenvalues) *
+		// eigenvectors and, for a covariance, eigenvectors is the orientation of the principal axes.
+		void EigenSymmetric(Vector3& eigenvalues, Matrix3& eigenvectors) const noexcept;
+
+		// Batch operations. All spans must have the same size; results may alias the inputs.
+		// Run on AVX2 kernels, 8 matrices per iteration, or a portable fallback.
+		// result[i] = a[i] * b[i]
+		static void MultiplyBatch(std::span<const Matrix3> a, std::span<const Matrix3> b, std::span<Matrix3> result) noexcept;
+		static void MultiplyBatch(const Parallel::ParallelPolicy& policy, std::span<const Matrix3> a, std::span<const Matrix3> b,
+		                          std::span<Matrix3> result) noexcept;
+
+		// result[i] = rotations[i]^T * tensors[i] * rotations[i], which takes a body-space inertia
+		// tensor to world space for a body whose rotation is rotations[i]
+		static void RotateBatch(std::span<const Matrix3> rotations, std::span<const Matrix3> tensors, std::span<Matrix3> result) noexcept;
+		static void RotateBatch(const Parallel::ParallelPolicy& policy, std::span<const Matrix3> rotations, std::span<const Matrix3> tensors,
+		                        std::span<Matrix3> result) noexcept;
+
+		// EigenSymmetric of every matrix
+		static void EigenSymmetricBatch(std::span<const Matrix3> matrices, std::span<Vector3> eigenvalues, std::span<Matrix3> eigenvectors) noexcept;
+		static void EigenSymmetricBatch(const Parallel::ParallelPolicy& policy, std::span<const Matrix3> matrices, std::span<Vector3> eigenvalues,
+		                                std::span<Matrix3> eigenvectors) noexcept;
+
+		// Static functions
+		static constexpr Matrix3 CreateScale(const Vector3& scales) noexcept;
+		static Matrix3 CreateFromQuaternion(const Quaternion& rotation) noexcept;
+
+		// Constants
+		static const Matrix3 Identity;
+	};
+
+	// Binary operators
+	Matrix3 operator+(const Matrix3& M1, const Matrix3& M2) noexcept;
+	Matrix3 operator-(const Matrix3& M1, const Matrix3& M2) noexcept;
+	Matrix3 operator*(const Matrix3& M1, const Matrix3& M2) noexcept;
+	Matrix3 operator*(const Matrix3& M, float S) noexcept;
+	Matrix3 operator*(float S, const Matrix3& M) noexcept;
+
+	// Constants
+	inline constexpr Matrix3 Matrix3::Identity = {
+		1.f, 0.f, 0.f,
+		0.f, 1.f, 0.f,
+		0.f, 0.f, 1.f
+	};
+
+
+
+	//****************************************************************************
+	// Affine transform
+	// 3x4 row-major form of a Matrix whose last column is (0, 0, 0, 1). Row i holds column i of the
+	// Matrix's 3x3 part followed by translation component i, so it takes 48 bytes instead of 64.
+	struct AffineTransform : public XMFLOAT3X4
+	{
+		// Constructors
+		constexpr AffineTransform() noexcept
+			: XMFLOAT3X4(1.f, 0, 0, 0,
+			             0, 1.f, 0, 0,
+			             0, 0, 1.f, 0)
+		{
+		}
+
+		constexpr AffineTransform(float m00, float m01, float m02, float m03,
+		                          float m10, float m11, float m12, float m13,
+		                          float m20, float m21, float m22, float m23) noexcept
+			: XMFLOAT3X4(m00, m01, m02, m03,
+			             m10, m11, m12, m13,
+			             m20, m21, m22, m23)
+		{
+		}
+
+		// Drops the last column of M, which must be (0, 0, 0, 1)
+		explicit AffineTransform(const Matrix& M) noexcept;
+		explicit AffineTransform(const SQT& T) noexcept;
+
+		AffineTransform(const AffineTransform&) = default;
+		AffineTransform& operator=(const AffineTransform&) = default;
+
+		AffineTransform(AffineTransform&&) = default;
+		AffineTransform& operator=(AffineTransform&&) = default;
+
+		// Comparison operators
+		bool operator ==(const AffineTransform& T) const noexcept;
+		bool operator !=(const AffineTransform& T) const noexcept;
+
+		// Assignment operators
+		AffineTransform& operator*=(const AffineTransform& T) noexcept;
+
+		[[nodiscard]] Vector3 Translation() const noexcept { return Vector3(_14, _24, _34); }
+
+		// Conversions
+		[[nodiscard]] Matrix ToMatrix() const noexcept;
+
+		bool Decompose(Vector3& scale, Quaternion& rotation, Vector3& translation) const noexcept;
+		bool Decompose(SQT& result) const noexcept;
+
+		// General inverse: the 3x3 part is inverted through cross products and the translation
+		// rotated back, skipping the full 4x4 inverse. The 3x3 part must not be singular.
+		AffineTransform Invert() const noexcept;
+		void Invert(AffineTransform& result) const noexcept;
+
+		// Inverse for rotation and translation only: the 3x3 part is transposed instead of inverted
+		AffineTransform InvertOrthonormal() const noexcept;
+		void InvertOrthonormal(AffineTransform& result) const noexcept;
+
+		float Determinant() const noexcept;
+
+		// Vector transforms: points use w = 1, normals w = 0
+		[[nodiscard]] Vector3 TransformPoint(const Vector3& V) const noexcept;
+		[[nodiscard]] Vector3 TransformNormal(const Vector3& V) const noexcept;
+
+		// Constants
+		static const AffineTransform Identity;
+	};
+
+	// Binary operators
+	// Like Matrix, T1 * T2 applies T1 first
+	AffineTransform operator*(const AffineTransform& T1, const AffineTransform& T2) noexcept;
+
+	// Constants
+	inline constexpr AffineTransform AffineTransform::Identity = {
+		1.f, 0.f, 0.f, 0.f,
+		0.f, 1.f, 0.f, 0.f,
+		0.f, 0.f, 1.f, 0.f
+	};
+
+
+
+	//****************************************************************************
+	// Scale, rotation, translation
+	// Applied in that order. Concatenation and inversion are exact for uniform scale; with
+	// non-uniform scale the shear a Matrix would pick up is dropped.
+	struct SQT
+	{
+		Vector3 scale;
+		Quaternion rotation;
+		Vector3 translation;
+
+		// Constructors
+		constexpr SQT() noexcept : scale(1.f)
+		{
+		}
+
+		constexpr SQT(const Vector3& s, const Quaternion& r, const Vector3& t) noexcept : scale(s), rotation(r), translation(t)
+		{
+		}
+
+		// Comparison operators
+		bool operator ==(const SQT& T) const noexcept;
+		bool operator !=(const SQT& T) const noexcept;
+
+		// Assignment operators
+		SQT& operator*=(const SQT& T) noexcept;
+
+		// Conversions
+		[[nodiscard]] Matrix ToMatrix() const noexcept;
+		[[nodiscard]] AffineTransform ToAffineTransform() const noexcept;
+
+		// Conjugates the rotation and inverts the scale, no matrix inverse involved
+		SQT Invert() const noexcept;
+		void Invert(SQT& result) const noexcept;
+
+		// Vector transforms: points use w = 1, normals w = 0
+		[[nodiscard]] Vector3 TransformPoint(const Vector3& V) const noexcept;
+		[[nodiscard]] Vector3 TransformNormal(const Vector3& V) const noexcept;
+
+		// Constants
+		static const SQT Identity;
+	};
+
+	// Binary operators
+	// Like Matrix, T1 * T2 applies T1 first
+	SQT operator*(const SQT& T1, const SQT& T2) noexcept;
+
+	// Constants
+	inline constexpr SQT SQT::Identity = { Vector3::One, Quaternion::Identity, Vector3::Zero };
+
+
+
+	//****************************************************************************
+	// Plane
+	// (nx, ny, nz, d) with dot(n, p) + d = 0 for points on the plane, the layout of XMPlane* and of
+	// the Frustum planes. Distances are signed, positive on the side the normal points to, and in
+	// units of the normal's length, so normalize the plane to measure them in world units.
+
+	struct Plane : public XMFLOAT4
+	{
+		// Constructors
+		constexpr Plane() noexcept : XMFLOAT4(0.f, 1.f, 0.f, 0.f)
+		{
+		}
+
+		constexpr Plane(float nx, float ny, float nz, float d) noexcept : XMFLOAT4(nx, ny, nz, d)
+		{
+		}
+
+		constexpr Plane(const Vector3& normal, float d) noexcept : XMFLOAT4(normal.x, normal.y, normal.z, d)
+		{
+		}
+
+		// Plane through point with the given normal
+		constexpr Plane(const Vector3& point, const Vector3& normal) noexcept
+			: XMFLOAT4(normal.x, normal.y, normal.z, -(normal.x * point.x + normal.y * point.y + normal.z * point.z))
+		{
+		}
+
+		// Plane through three points with a unit normal, facing the side they wind counter-clockwise on
+		Plane(const Vector3& point1, const Vector3& point2, const Vector3& point3) noexcept;
+
+		explicit constexpr Plane(const XMFLOAT4& P) noexcept : XMFLOAT4(P.x, P.y, P.z, P.w)
+		{
+		}
+
+		// Comparison operators
+		constexpr bool operator ==(const Plane& P) const noexcept;
+		constexpr bool operator !=(const Plane& P) const noexcept;
+
+		[[nodiscard]] constexpr Vector3 Normal() const noexcept { return Vector3(x, y, z); }
+		[[nodiscard]] constexpr float D() const noexcept { return w; }
+
+		// Plane operations
+		// Scales the plane to a unit normal
+		template <Precision P = Precision::Exact>
+		void Normalize() noexcept;
+		template <Precision P = Precision::Exact>
+		void Normalize(Plane& result) const noexcept;
+
+		// dot(n, point) + d
+		[[nodiscard]] constexpr float Distance(const Vector3& point) const noexcept;
+		// dot(n, V), for directions
+		[[nodiscard]] constexpr float DotNormal(const Vector3& V) const noexcept;
+
+		// Batch signed distances, result must have the same size as points
+		void Distance(const Vector3Stream& points, std::span<float> result) const noexcept;
+
+		// M transforms points, and its inverse transpose is applied to the plane
+		[[nodiscard]] Plane Transform(const Matrix& M) const noexcept;
+	};
+
+
+	//****************************************************************************
+	// Ray
+	// Hit distances are measured in multiples of the direction, which need not be normalized.
+
+	struct Ray
+	{
+		Vector3 position;
+		Vector3 direction = Vector3(0.f, 0.f, 1.f);
+
+		// Constructors
+		constexpr Ray() noexcept = default;
+		constexpr Ray(const Vector3& pos, const Vector3& dir) noexcept : position(pos), direction(dir) {}
+
+		// Queries. A ray starting inside the volume hits it at distance 0. Rays parallel to a plane
+		// miss it, also when they lie in it.
+		bool Intersects(const Plane& P, float& distance) const noexcept;
+		bool Intersects(const BoundingSphere& S, float& distance) const noexcept;
+		bool Intersects(const AABB& box, float& distance) const noexcept;
+	};
 }
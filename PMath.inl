@@ -1,4 +1,9 @@
 #pragma once
+#include <bit>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
 
 #include "PMath.h"
 
@@ -6,25 +11,510 @@ using namespace DirectX;
 
 namespace PMgene::Math
 {
+	//****************************************************************************
+	// Constant evaluation
+	// DirectXMath's intrinsics can't run at compile time, so the constexpr operations below take a
+	// scalar path under std::is_constant_evaluated() and keep DirectXMath at run time.
+
+	namespace Detail
+	{
+		// XMScalarSinCos's range reduction and minimax polynomials, so rotations built at compile
+		// time match the run-time ones
+		constexpr void ScalarSinCos(float angle, float& sin, float& cos) noexcept
+		{
+			float quotient = XM_1DIV2PI * angle;
+			quotient = angle >= 0.f ? static_cast<float>(static_cast<int>(quotient + 0.5f)) : static_cast<float>(static_cast<int>(quotient - 0.5f));
+			float y = angle - XM_2PI * quotient;
+
+			// Map y to [-pi/2, pi/2] with sin(y) = sin(angle)
+			float sign = 1.f;
+			if (y > XM_PIDIV2)
+			{
+				y = XM_PI - y;
+				sign = -1.f;
+			}
+			else if (y < -XM_PIDIV2)
+			{
+				y = -XM_PI - y;
+				sign = -1.f;
+			}
+
+			const float y2 = y * y;
+			sin = (((((-2.3889859e-08f * y2 + 2.7525562e-06f) * y2 - 0.00019840874f) * y2 + 0.0083333310f) * y2 - 0.16666667f) * y2 + 1.f) * y;
+			cos = sign * ((((((-2.6051615e-07f * y2 + 2.4760495e-05f) * y2 - 0.0013888378f) * y2 + 0.041666638f) * y2 - 0.5f) * y2 + 1.f));
+		}
+
+		template <typename F>
+		constexpr Matrix MapElements(const Matrix& M, F f) noexcept
+		{
+			return Matrix(f(M._11), f(M._12), f(M._13), f(M._14),
+			              f(M._21), f(M._22), f(M._23), f(M._24),
+			              f(M._31), f(M._32), f(M._33), f(M._34),
+			              f(M._41), f(M._42), f(M._43), f(M._44));
+		}
+
+		template <typename F>
+		constexpr Matrix MapElements(const Matrix& M1, const Matrix& M2, F f) noexcept
+		{
+			return Matrix(f(M1._11, M2._11), f(M1._12, M2._12), f(M1._13, M2._13), f(M1._14, M2._14),
+			              f(M1._21, M2._21), f(M1._22, M2._22), f(M1._23, M2._23), f(M1._24, M2._24),
+			              f(M1._31, M2._31), f(M1._32, M2._32), f(M1._33, M2._33), f(M1._34, M2._34),
+			              f(M1._41, M2._41), f(M1._42, M2._42), f(M1._43, M2._43), f(M1._44, M2._44));
+		}
+
+		// XMQuaternionMultiply(Q1, Q2), the rotation Q1 followed by Q2
+		constexpr Quaternion QuaternionMultiply(const Quaternion& Q1, const Quaternion& Q2) noexcept
+		{
+			return Quaternion(Q2.w * Q1.x + Q2.x * Q1.w + Q2.y * Q1.z - Q2.z * Q1.y,
+			                  Q2.w * Q1.y - Q2.x * Q1.z + Q2.y * Q1.w + Q2.z * Q1.x,
+			                  Q2.w * Q1.z + Q2.x * Q1.y - Q2.y * Q1.x + Q2.z * Q1.w,
+			                  Q2.w * Q1.w - Q2.x * Q1.x - Q2.y * Q1.y - Q2.z * Q1.z);
+		}
+
+		// XMQuaternionInverse: the conjugate over the squared length, zero for near-zero quaternions
+		constexpr Quaternion QuaternionInverse(const Quaternion& Q) noexcept
+		{
+			const float lengthSq = Q.x * Q.x + Q.y * Q.y + Q.z * Q.z + Q.w * Q.w;
+			if (lengthSq <= FLT_EPSILON)
+				return Quaternion(0.f, 0.f, 0.f, 0.f);
+			return Quaternion(-Q.x / lengthSq, -Q.y / lengthSq, -Q.z / lengthSq, Q.w / lengthSq);
+		}
+
+		constexpr Matrix MatrixMultiply(const Matrix& A, const Matrix& B) noexcept
+		{
+			return Matrix(A._11 * B._11 + A._12 * B._21 + A._13 * B._31 + A._14 * B._41,
+			              A._11 * B._12 + A._12 * B._22 + A._13 * B._32 + A._14 * B._42,
+			              A._11 * B._13 + A._12 * B._23 + A._13 * B._33 + A._14 * B._43,
+			              A._11 * B._14 + A._12 * B._24 + A._13 * B._34 + A._14 * B._44,
+			              A._21 * B._11 + A._22 * B._21 + A._23 * B._31 + A._24 * B._41,
+			              A._21 * B._12 + A._22 * B._22 + A._23 * B._32 + A._24 * B._42,
+			              A._21 * B._13 + A._22 * B._23 + A._23 * B._33 + A._24 * B._43,
+			              A._21 * B._14 + A._22 * B._24 + A._23 * B._34 + A._24 * B._44,
+			              A._31 * B._11 + A._32 * B._21 + A._33 * B._31 + A._34 * B._41,
+			              A._31 * B._12 + A._32 * B._22 + A._33 * B._32 + A._34 * B._42,
+			              A._31 * B._13 + A._32 * B._23 + A._33 * B._33 + A._34 * B._43,
+			              A._31 * B._14 + A._32 * B._24 + A._33 * B._34 + A._34 * B._44,
+			              A._41 * B._11 + A._42 * B._21 + A._43 * B._31 + A._44 * B._41,
+			              A._41 * B._12 + A._42 * B._22 + A._43 * B._32 + A._44 * B._42,
+			              A._41 * B._13 + A._42 * B._23 + A._43 * B._33 + A._44 * B._43,
+			              A._41 * B._14 + A._42 * B._24 + A._43 * B._34 + A._44 * B._44);
+		}
+	}
+
+
+	//****************************************************************************
+	// Precision
+
+	namespace Detail
+	{
+		// Per lane. One Newton-Raphson step, e (3 - x e^2) / 2, takes the 12-bit estimate to a few ulp.
+		template <Precision P>
+		inline XMVECTOR ReciprocalSqrt(FXMVECTOR X) noexcept
+		{
+			if constexpr (P == Precision::Exact)
+				return XMVectorReciprocalSqrt(X);
+
+			const XMVECTOR e = XMVectorReciprocalSqrtEst(X);
+			if constexpr (P == Precision::Estimate)
+				return e;
+			return XMVectorMultiply(XMVectorMultiply(g_XMOneHalf, e), XMVectorNegativeMultiplySubtract(XMVectorMultiply(X, e), e, g_XMThree));
+		}
+
+		// Per lane. The hardware divide is as fast as a refined estimate, so only Estimate replaces it.
+		template <Precision P>
+		inline XMVECTOR Reciprocal(FXMVECTOR X) noexcept
+		{
+			if constexpr (P != Precision::Estimate)
+				return XMVectorReciprocal(X);
+			return XMVectorReciprocalEst(X);
+		}
+
+		// Per lane. As with Reciprocal, only Estimate replaces the hardware square root, as x / sqrt(x).
+		// The estimate is infinite for zero and denormal x, so those take the hardware square root.
+		template <Precision P>
+		inline XMVECTOR Sqrt(FXMVECTOR X) noexcept
+		{
+			if constexpr (P != Precision::Estimate)
+				return XMVectorSqrt(X);
+			if (!XMVector4GreaterOrEqual(X, XMVectorReplicate(FLT_MIN)))
+				return XMVectorSqrt(X);
+			return XMVectorMultiply(X, ReciprocalSqrt<P>(X));
+		}
+
+		// V / sqrt(lengthSq), zero where lengthSq is zero. Below FLT_MIN the reciprocal square root
+		// estimate is infinite, so tiny vectors take the exact quotient instead.
+		template <Precision P>
+		inline XMVECTOR Normalize(FXMVECTOR V, FXMVECTOR lengthSq) noexcept
+		{
+			if (XMVector4GreaterOrEqual(lengthSq, XMVectorReplicate(FLT_MIN)))
+				return XMVectorMultiply(V, ReciprocalSqrt<P>(lengthSq));
+			return XMVectorAndInt(XMVectorDivide(V, XMVectorSqrt(lengthSq)), XMVectorGreater(lengthSq, XMVectorZero()));
+		}
+
+		// XMScalarSinCosEst's polynomials after a branchless reduction to y = angle - q pi in
+		// [-pi/2, pi/2], with pi split in three so that q pi is exact, and the signs flipped for odd
+		// q. Without branches, loops over it vectorize. Valid for |angle| < 2^22 pi.
+		inline void SinCosEstimate(float angle, float& sin, float& cos) noexcept
+		{
+			// Adding 1.5 * 2^23 rounds to an integer, left in the low mantissa bits
+			const float biased = angle * XM_1DIVPI + 12582912.f;
+			const float q = biased - 12582912.f;
+			float y = angle - q * 3.140625f;
+			y -= q * 9.67502593994140625e-4f;
+			y -= q * 1.509957990978376432e-7f;
+			const uint32_t flip = std::bit_cast<uint32_t>(biased) << 31;
+
+			const float y2 = y * y;
+			const float s = (((-0.00018524670f * y2 + 0.0083139502f) * y2 - 0.16665852f) * y2 + 1.f) * y;
+			const float c = ((-0.0012712436f * y2 + 0.041493919f) * y2 - 0.49992746f) * y2 + 1.f;
+			sin = std::bit_cast<float>(std::bit_cast<uint32_t>(s) ^ flip);
+			cos = std::bit_cast<float>(std::bit_cast<uint32_t>(c) ^ flip);
+		}
+
+		// Minimax polynomials of atan(a) / a in a^2 for a in [0, 1], fitted for relative error
+		template <Precision P>
+		inline float AtanUnit(float a) noexcept
+		{
+			const float s = a * a;
+			if constexpr (P == Precision::Estimate)
+				return (((-0.044326613f * s + 0.15557875f) * s - 0.32580845f) * s + 0.99978785f) * a;
+			return (((((((-0.0046932760f * s + 0.024252403f) * s - 0.059486393f) * s + 0.099142928f) * s - 0.14019481f) * s
+			          + 0.19969724f) * s - 0.33331991f) * s + 0.99999990f) * a;
+		}
+	}
+
+	template <Precision P>
+	inline float Sqrt(float x) noexcept
+	{
+		if constexpr (P != Precision::Estimate)
+			return std::sqrt(x);
+		return XMVectorGetX(Detail::Sqrt<P>(XMVectorReplicate(x)));
+	}
+
+	template <Precision P>
+	inline float ReciprocalSqrt(float x) noexcept
+	{
+		if constexpr (P == Precision::Exact)
+			return 1.f / std::sqrt(x);
+		return XMVectorGetX(Detail::ReciprocalSqrt<P>(XMVectorReplicate(x)));
+	}
+
+	template <Precision P>
+	inline float Reciprocal(float x) noexcept
+	{
+		if constexpr (P != Precision::Estimate)
+			return 1.f / x;
+		return XMVectorGetX(Detail::Reciprocal<P>(XMVectorReplicate(x)));
+	}
+
+	// The C library's sinf and cosf beat a polynomial on latency, so only Estimate replaces them
+	template <Precision P>
+	inline float Sin(float angle) noexcept
+	{
+		if constexpr (P != Precision::Estimate)
+			return std::sin(angle);
+
+		float sin, cos;
+		Detail::SinCosEstimate(angle, sin, cos);
+		return sin;
+	}
+
+	template <Precision P>
+	inline float Cos(float angle) noexcept
+	{
+		if constexpr (P != Precision::Estimate)
+			return std::cos(angle);
+
+		float sin, cos;
+		Detail::SinCosEstimate(angle, sin, cos);
+		return cos;
+	}
+
+	template <Precision P>
+	inline void SinCos(float angle, float& sin, float& cos) noexcept
+	{
+		if constexpr (P != Precision::Estimate)
+		{
+			sin = std::sin(angle);
+			cos = std::cos(angle);
+		}
+		else
+		{
+			Detail::SinCosEstimate(angle, sin, cos);
+		}
+	}
+
+	template <Precision P>
+	inline float Atan2(float y, float x) noexcept
+	{
+		if constexpr (P == Precision::Exact)
+			return std::atan2(y, x);
+
+		// Reduce to atan(a) for a in [0, 1], then undo the octant
+		const float ax = std::fabs(x), ay = std::fabs(y);
+		const float high = ax > ay ? ax : ay;
+		const float low = ax > ay ? ay : ax;
+		float r = high > 0.f ? Detail::AtanUnit<P>(low * Reciprocal<P>(high)) : 0.f;
+		if (ay > ax)
+			r = XM_PIDIV2 - r;
+		if (std::signbit(x))
+			r = XM_PI - r;
+		return std::copysign(r, y);
+	}
+
+
+	//****************************************************************************
+	// Vector2
+
+	constexpr bool Vector2::operator==(const Vector2& V) const noexcept
+	{
+		if (std::is_constant_evaluated())
+			return x == V.x && y == V.y;
+
+		const XMVECTOR v1 = XMLoadFloat2(this);
+		const XMVECTOR v2 = XMLoadFloat2(&V);
+		return XMVector2Equal(v1, v2);
+	}
+
+	constexpr bool Vector2::operator !=(const Vector2& V) const noexcept
+	{
+		if (std::is_constant_evaluated())
+			return x != V.x || y != V.y;
+
+		const XMVECTOR v1 = XMLoadFloat2(this);
+		const XMVECTOR v2 = XMLoadFloat2(&V);
+		return XMVector2NotEqual(v1, v2);
+	}
+
+	constexpr Vector2& Vector2::operator+=(const Vector2& V) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return *this = Vector2(x + V.x, y + V.y);
+
+		const XMVECTOR v1 = XMLoadFloat2(this);
+		const XMVECTOR v2 = XMLoadFloat2(&V);
+		const XMVECTOR X = XMVectorAdd(v1, v2);
+		XMStoreFloat2(this, X);
+		return *this;
+	}
+
+	constexpr Vector2& Vector2::operator-=(const Vector2& V) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return *this = Vector2(x - V.x, y - V.y);
+
+		const XMVECTOR v1 = XMLoadFloat2(this);
+		const XMVECTOR v2 = XMLoadFloat2(&V);
+		const XMVECTOR X = XMVectorSubtract(v1, v2);
+		XMStoreFloat2(this, X);
+		return *this;
+	}
+
+	constexpr Vector2& Vector2::operator*=(const Vector2& V) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return *this = Vector2(x * V.x, y * V.y);
+
+		const XMVECTOR v1 = XMLoadFloat2(this);
+		const XMVECTOR v2 = XMLoadFloat2(&V);
+		const XMVECTOR X = XMVectorMultiply(v1, v2);
+		XMStoreFloat2(this, X);
+		return *this;
+	}
+
+	constexpr Vector2& Vector2::operator*=(float S) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return *this = Vector2(x * S, y * S);
+
+		const XMVECTOR v1 = XMLoadFloat2(this);
+		const XMVECTOR X = XMVectorScale(v1, S);
+		XMStoreFloat2(this, X);
+		return *this;
+	}
+
+	constexpr Vector2& Vector2::operator/=(float S) noexcept
+	{
+		if (S == 0.0f)
+		{
+			return *this;
+		}
+		if (std::is_constant_evaluated())
+			return *this *= 1.f / S;
+
+		const XMVECTOR v1 = XMLoadFloat2(this);
+		const XMVECTOR X = XMVectorScale(v1, 1.f / S);
+		XMStoreFloat2(this, X);
+		return *this;
+	}
+
+	constexpr Vector2 Vector2::operator-() const noexcept
+	{
+		if (std::is_constant_evaluated())
+			return Vector2(-x, -y);
+
+		const XMVECTOR v1 = XMLoadFloat2(this);
+		const XMVECTOR X = XMVectorNegate(v1);
+		Vector2 R;
+		XMStoreFloat2(&R, X);
+		return R;
+	}
+
+	constexpr Vector2 operator+(const Vector2& V1, const Vector2& V2) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return Vector2(V1.x + V2.x, V1.y + V2.y);
+
+		const XMVECTOR v1 = XMLoadFloat2(&V1);
+		const XMVECTOR v2 = XMLoadFloat2(&V2);
+		const XMVECTOR X = XMVectorAdd(v1, v2);
+		Vector2 R;
+		XMStoreFloat2(&R, X);
+		return R;
+	}
+
+	constexpr Vector2 operator-(const Vector2& V1, const Vector2& V2) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return Vector2(V1.x - V2.x, V1.y - V2.y);
+
+		const XMVECTOR v1 = XMLoadFloat2(&V1);
+		const XMVECTOR v2 = XMLoadFloat2(&V2);
+		const XMVECTOR X = XMVectorSubtract(v1, v2);
+		Vector2 R;
+		XMStoreFloat2(&R, X);
+		return R;
+	}
+
+	constexpr Vector2 operator*(const Vector2& V1, const Vector2& V2) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return Vector2(V1.x * V2.x, V1.y * V2.y);
+
+		const XMVECTOR v1 = XMLoadFloat2(&V1);
+		const XMVECTOR v2 = XMLoadFloat2(&V2);
+		const XMVECTOR X = XMVectorMultiply(v1, v2);
+		Vector2 R;
+		XMStoreFloat2(&R, X);
+		return R;
+	}
+
+	constexpr Vector2 operator*(const Vector2& V, float S) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return Vector2(V.x * S, V.y * S);
+
+		const XMVECTOR v1 = XMLoadFloat2(&V);
+		const XMVECTOR X = XMVectorScale(v1, S);
+		Vector2 R;
+		XMStoreFloat2(&R, X);
+		return R;
+	}
+
+	constexpr Vector2 operator/(const Vector2& V1, const Vector2& V2) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return Vector2(V1.x / V2.x, V1.y / V2.y);
+
+		const XMVECTOR v1 = XMLoadFloat2(&V1);
+		const XMVECTOR v2 = XMLoadFloat2(&V2);
+		const XMVECTOR X = XMVectorDivide(v1, v2);
+		Vector2 R;
+		XMStoreFloat2(&R, X);
+		return R;
+	}
+
+	constexpr Vector2 operator/(const Vector2& V, float S) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return V * (1.f / S);
+
+		const XMVECTOR v1 = XMLoadFloat2(&V);
+		const XMVECTOR X = XMVectorScale(v1, 1.f / S);
+		Vector2 R;
+		XMStoreFloat2(&R, X);
+		return R;
+	}
+
+	constexpr Vector2 operator*(float S, const Vector2& V) noexcept
+	{
+		return V * S;
+	}
+
+	template <Precision P>
+	inline float Vector2::Length() const noexcept
+	{
+		const XMVECTOR v1 = XMLoadFloat2(this);
+		if constexpr (P == Precision::Exact)
+			return XMVectorGetX(XMVector2Length(v1));
+		return XMVectorGetX(Detail::Sqrt<P>(XMVector2LengthSq(v1)));
+	}
+
+	constexpr float Vector2::Dot(const Vector2& V) const noexcept
+	{
+		if (std::is_constant_evaluated())
+			return x * V.x + y * V.y;
+
+		const XMVECTOR v1 = XMLoadFloat2(this);
+		const XMVECTOR v2 = XMLoadFloat2(&V);
+		const XMVECTOR X = XMVector2Dot(v1, v2);
+		return XMVectorGetX(X);
+	}
+
+	constexpr float Vector2::Cross(const Vector2& V) const noexcept
+	{
+		if (std::is_constant_evaluated())
+			return x * V.y - y * V.x;
+
+		const XMVECTOR v1 = XMLoadFloat2(this);
+		const XMVECTOR v2 = XMLoadFloat2(&V);
+		return XMVectorGetX(XMVector2Cross(v1, v2));
+	}
+
+	template <Precision P>
+	inline void Vector2::Normalize() noexcept
+	{
+		Normalize<P>(*this);
+	}
+
+	template <Precision P>
+	inline void Vector2::Normalize(Vector2& result) const noexcept
+	{
+		const XMVECTOR v1 = XMLoadFloat2(this);
+		if constexpr (P == Precision::Exact)
+			XMStoreFloat2(&result, XMVector2Normalize(v1));
+		else
+			XMStoreFloat2(&result, Detail::Normalize<P>(v1, XMVector2LengthSq(v1)));
+	}
+
 	//****************************************************************************
 	//Vector3
 
-	inline bool Vector3::operator==(const Vector3& V) const noexcept
+	constexpr bool Vector3::operator==(const Vector3& V) const noexcept
 	{
+		if (std::is_constant_evaluated())
+			return x == V.x && y == V.y && z == V.z;
+
 		const XMVECTOR v1 = XMLoadFloat3(this);
 		const XMVECTOR v2 = XMLoadFloat3(&V);
 		return XMVector3Equal(v1, v2);
 	}
 
-	inline bool Vector3::operator !=(const Vector3& V) const noexcept
+	constexpr bool Vector3::operator !=(const Vector3& V) const noexcept
 	{
+		if (std::is_constant_evaluated())
+			return x != V.x || y != V.y || z != V.z;
+
 		const XMVECTOR v1 = XMLoadFloat3(this);
 		const XMVECTOR v2 = XMLoadFloat3(&V);
 		return XMVector3NotEqual(v1, v2);
 	}
 
-	inline Vector3& Vector3::operator+=(const Vector3& V) noexcept
+	constexpr Vector3& Vector3::operator+=(const Vector3& V) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return *this = Vector3(x + V.x, y + V.y, z + V.z);
+
 		const XMVECTOR v1 = XMLoadFloat3(this);
 		const XMVECTOR v2 = XMLoadFloat3(&V);
 		const XMVECTOR X = XMVectorAdd(v1, v2);
@@ -32,8 +522,11 @@ namespace PMgene::Math
 		return *this;
 	}
 
-	inline Vector3& Vector3::operator-=(const Vector3& V) noexcept
+	constexpr Vector3& Vector3::operator-=(const Vector3& V) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return *this = Vector3(x - V.x, y - V.y, z - V.z);
+
 		const XMVECTOR v1 = XMLoadFloat3(this);
 		const XMVECTOR v2 = XMLoadFloat3(&V);
 		const XMVECTOR X = XMVectorSubtract(v1, v2);
@@ -41,8 +534,11 @@ namespace PMgene::Math
 		return *this;
 	}
 
-	inline Vector3& Vector3::operator*=(const Vector3& V) noexcept
+	constexpr Vector3& Vector3::operator*=(const Vector3& V) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return *this = Vector3(x * V.x, y * V.y, z * V.z);
+
 		const XMVECTOR v1 = XMLoadFloat3(this);
 		const XMVECTOR v2 = XMLoadFloat3(&V);
 		const XMVECTOR X = XMVectorMultiply(v1, v2);
@@ -50,28 +546,37 @@ namespace PMgene::Math
 		return *this;
 	}
 
-	inline Vector3& Vector3::operator*=(float S) noexcept
+	constexpr Vector3& Vector3::operator*=(float S) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return *this = Vector3(x * S, y * S, z * S);
+
 		const XMVECTOR v1 = XMLoadFloat3(this);
 		const XMVECTOR X = XMVectorScale(v1, S);
 		XMStoreFloat3(this, X);
 		return *this;
 	}
 
-	inline Vector3& Vector3::operator/=(float S) noexcept
+	constexpr Vector3& Vector3::operator/=(float S) noexcept
 	{
 		if (S == 0.0f)
 		{
 			return *this;
 		}
+		if (std::is_constant_evaluated())
+			return *this *= 1.f / S;
+
 		const XMVECTOR v1 = XMLoadFloat3(this);
 		const XMVECTOR X = XMVectorScale(v1, 1.f / S);
 		XMStoreFloat3(this, X);
 		return *this;
 	}
 
-	inline Vector3 Vector3::operator-() const noexcept
+	constexpr Vector3 Vector3::operator-() const noexcept
 	{
+		if (std::is_constant_evaluated())
+			return Vector3(-x, -y, -z);
+
 		const XMVECTOR v1 = XMLoadFloat3(this);
 		const XMVECTOR X = XMVectorNegate(v1);
 		Vector3 R;
@@ -79,8 +584,11 @@ namespace PMgene::Math
 		return R;
 	}
 
-	inline Vector3 operator+(const Vector3& V1, const Vector3& V2) noexcept
+	constexpr Vector3 operator+(const Vector3& V1, const Vector3& V2) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return Vector3(V1.x + V2.x, V1.y + V2.y, V1.z + V2.z);
+
 		const XMVECTOR v1 = XMLoadFloat3(&V1);
 		const XMVECTOR v2 = XMLoadFloat3(&V2);
 		const XMVECTOR X = XMVectorAdd(v1, v2);
@@ -89,8 +597,11 @@ namespace PMgene::Math
 		return R;
 	}
 
-	inline Vector3 operator-(const Vector3& V1, const Vector3& V2) noexcept
+	constexpr Vector3 operator-(const Vector3& V1, const Vector3& V2) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return Vector3(V1.x - V2.x, V1.y - V2.y, V1.z - V2.z);
+
 		const XMVECTOR v1 = XMLoadFloat3(&V1);
 		const XMVECTOR v2 = XMLoadFloat3(&V2);
 		const XMVECTOR X = XMVectorSubtract(v1, v2);
@@ -99,8 +610,11 @@ namespace PMgene::Math
 		return R;
 	}
 
-	inline Vector3 operator*(const Vector3& V1, const Vector3& V2) noexcept
+	constexpr Vector3 operator*(const Vector3& V1, const Vector3& V2) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return Vector3(V1.x * V2.x, V1.y * V2.y, V1.z * V2.z);
+
 		const XMVECTOR v1 = XMLoadFloat3(&V1);
 		const XMVECTOR v2 = XMLoadFloat3(&V2);
 		const XMVECTOR X = XMVectorMultiply(v1, v2);
@@ -109,8 +623,11 @@ namespace PMgene::Math
 		return R;
 	}
 
-	inline Vector3 operator*(const Vector3& V, float S) noexcept
+	constexpr Vector3 operator*(const Vector3& V, float S) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return Vector3(V.x * S, V.y * S, V.z * S);
+
 		const XMVECTOR v1 = XMLoadFloat3(&V);
 		const XMVECTOR X = XMVectorScale(v1, S);
 		Vector3 R;
@@ -118,8 +635,11 @@ namespace PMgene::Math
 		return R;
 	}
 
-	inline Vector3 operator/(const Vector3& V1, const Vector3& V2) noexcept
+	constexpr Vector3 operator/(const Vector3& V1, const Vector3& V2) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return Vector3(V1.x / V2.x, V1.y / V2.y, V1.z / V2.z);
+
 		const XMVECTOR v1 = XMLoadFloat3(&V1);
 		const XMVECTOR v2 = XMLoadFloat3(&V2);
 		const XMVECTOR X = XMVectorDivide(v1, v2);
@@ -128,8 +648,11 @@ namespace PMgene::Math
 		return R;
 	}
 
-	inline Vector3 operator/(const Vector3& V, float S) noexcept
+	constexpr Vector3 operator/(const Vector3& V, float S) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return V * (1.f / S);
+
 		const XMVECTOR v1 = XMLoadFloat3(&V);
 		const XMVECTOR X = XMVectorScale(v1, 1.f / S);
 		Vector3 R;
@@ -137,40 +660,41 @@ namespace PMgene::Math
 		return R;
 	}
 
-	inline Vector3 operator*(float S, const Vector3& V) noexcept
+	constexpr Vector3 operator*(float S, const Vector3& V) noexcept
 	{
-		const XMVECTOR v1 = XMLoadFloat3(&V);
-		const XMVECTOR X = XMVectorScale(v1, S);
-		Vector3 R;
-		XMStoreFloat3(&R, X);
-		return R;
+		return V * S;
 	}
 
+	template <Precision P>
 	inline float Vector3::Length() const noexcept
 	{
 		const XMVECTOR v1 = XMLoadFloat3(this);
-		const XMVECTOR X = XMVector3Length(v1);
-		return XMVectorGetX(X);
+		if constexpr (P == Precision::Exact)
+			return XMVectorGetX(XMVector3Length(v1));
+		return XMVectorGetX(Detail::Sqrt<P>(XMVector3LengthSq(v1)));
 	}
 
-	inline float Vector3::Dot(const Vector3& V) const noexcept
+	constexpr float Vector3::Dot(const Vector3& V) const noexcept
 	{
+		if (std::is_constant_evaluated())
+			return x * V.x + y * V.y + z * V.z;
+
 		const XMVECTOR v1 = XMLoadFloat3(this);
 		const XMVECTOR v2 = XMLoadFloat3(&V);
 		const XMVECTOR X = XMVector3Dot(v1, v2);
 		return XMVectorGetX(X);
 	}
 
-	inline void Vector3::Cross(const Vector3& V, Vector3& result) const noexcept
+	constexpr void Vector3::Cross(const Vector3& V, Vector3& result) const noexcept
 	{
-		const XMVECTOR v1 = XMLoadFloat3(this);
-		const XMVECTOR v2 = XMLoadFloat3(&V);
-		const XMVECTOR R = XMVector3Cross(v1, v2);
-		XMStoreFloat3(&result, R);
+		result = Cross(V);
 	}
 
-	inline Vector3 Vector3::Cross(const Vector3& V) const noexcept
+	constexpr Vector3 Vector3::Cross(const Vector3& V) const noexcept
 	{
+		if (std::is_constant_evaluated())
+			return Vector3(y * V.z - z * V.y, z * V.x - x * V.z, x * V.y - y * V.x);
+
 		const XMVECTOR v1 = XMLoadFloat3(this);
 		const XMVECTOR v2 = XMLoadFloat3(&V);
 		const XMVECTOR R = XMVector3Cross(v1, v2);
@@ -180,89 +704,332 @@ namespace PMgene::Math
 		return result;
 	}
 
+	template <Precision P>
 	inline void Vector3::Normalize() noexcept
 	{
-		const XMVECTOR v1 = XMLoadFloat3(this);
-		const XMVECTOR X = XMVector3Normalize(v1);
-		XMStoreFloat3(this, X);
+		Normalize<P>(*this);
 	}
 
+	template <Precision P>
 	inline void Vector3::Normalize(Vector3& result) const noexcept
 	{
 		const XMVECTOR v1 = XMLoadFloat3(this);
-		const XMVECTOR X = XMVector3Normalize(v1);
-		XMStoreFloat3(&result, X);
+		if constexpr (P == Precision::Exact)
+			XMStoreFloat3(&result, XMVector3Normalize(v1));
+		else
+			XMStoreFloat3(&result, Detail::Normalize<P>(v1, XMVector3LengthSq(v1)));
 	}
 
 	//****************************************************************************
-	//Quaternion
+	// Vector4
 
-	inline bool Quaternion::operator ==(const Quaternion& q) const noexcept
+	constexpr bool Vector4::operator==(const Vector4& V) const noexcept
 	{
-		const XMVECTOR q1 = XMLoadFloat4(this);
-		const XMVECTOR q2 = XMLoadFloat4(&q);
-		return XMQuaternionEqual(q1, q2);
+		if (std::is_constant_evaluated())
+			return x == V.x && y == V.y && z == V.z && w == V.w;
+
+		const XMVECTOR v1 = XMLoadFloat4(this);
+		const XMVECTOR v2 = XMLoadFloat4(&V);
+		return XMVector4Equal(v1, v2);
 	}
 
-	inline bool Quaternion::operator !=(const Quaternion& q) const noexcept
+	constexpr bool Vector4::operator !=(const Vector4& V) const noexcept
 	{
-		const XMVECTOR q1 = XMLoadFloat4(this);
-		const XMVECTOR q2 = XMLoadFloat4(&q);
-		return XMQuaternionNotEqual(q1, q2);
+		if (std::is_constant_evaluated())
+			return x != V.x || y != V.y || z != V.z || w != V.w;
+
+		const XMVECTOR v1 = XMLoadFloat4(this);
+		const XMVECTOR v2 = XMLoadFloat4(&V);
+		return XMVector4NotEqual(v1, v2);
 	}
 
-	inline Quaternion& Quaternion::operator+=(const Quaternion& q) noexcept
+	constexpr Vector4& Vector4::operator+=(const Vector4& V) noexcept
 	{
-		const XMVECTOR q1 = XMLoadFloat4(this);
-		const XMVECTOR q2 = XMLoadFloat4(&q);
-		XMStoreFloat4(this, XMVectorAdd(q1, q2));
+		if (std::is_constant_evaluated())
+			return *this = Vector4(x + V.x, y + V.y, z + V.z, w + V.w);
+
+		const XMVECTOR v1 = XMLoadFloat4(this);
+		const XMVECTOR v2 = XMLoadFloat4(&V);
+		const XMVECTOR X = XMVectorAdd(v1, v2);
+		XMStoreFloat4(this, X);
 		return *this;
 	}
 
-	inline Quaternion& Quaternion::operator-=(const Quaternion& q) noexcept
+	constexpr Vector4& Vector4::operator-=(const Vector4& V) noexcept
 	{
-		const XMVECTOR q1 = XMLoadFloat4(this);
-		const XMVECTOR q2 = XMLoadFloat4(&q);
-		XMStoreFloat4(this, XMVectorSubtract(q1, q2));
+		if (std::is_constant_evaluated())
+			return *this = Vector4(x - V.x, y - V.y, z - V.z, w - V.w);
+
+		const XMVECTOR v1 = XMLoadFloat4(this);
+		const XMVECTOR v2 = XMLoadFloat4(&V);
+		const XMVECTOR X = XMVectorSubtract(v1, v2);
+		XMStoreFloat4(this, X);
 		return *this;
 	}
 
-	inline Quaternion& Quaternion::operator*=(const Quaternion& q) noexcept
+	constexpr Vector4& Vector4::operator*=(const Vector4& V) noexcept
 	{
-		using namespace DirectX;
-		const XMVECTOR q1 = XMLoadFloat4(this);
-		const XMVECTOR q2 = XMLoadFloat4(&q);
-		XMStoreFloat4(this, XMQuaternionMultiply(q1, q2));
+		if (std::is_constant_evaluated())
+			return *this = Vector4(x * V.x, y * V.y, z * V.z, w * V.w);
+
+		const XMVECTOR v1 = XMLoadFloat4(this);
+		const XMVECTOR v2 = XMLoadFloat4(&V);
+		const XMVECTOR X = XMVectorMultiply(v1, v2);
+		XMStoreFloat4(this, X);
 		return *this;
 	}
 
-	inline Quaternion& Quaternion::operator*=(float S) noexcept
+	constexpr Vector4& Vector4::operator*=(float S) noexcept
 	{
-		const XMVECTOR q = XMLoadFloat4(this);
-		XMStoreFloat4(this, XMVectorScale(q, S));
+		if (std::is_constant_evaluated())
+			return *this = Vector4(x * S, y * S, z * S, w * S);
+
+		const XMVECTOR v1 = XMLoadFloat4(this);
+		const XMVECTOR X = XMVectorScale(v1, S);
+		XMStoreFloat4(this, X);
 		return *this;
 	}
 
-	inline Quaternion& Quaternion::operator/=(const Quaternion& q) noexcept
+	constexpr Vector4& Vector4::operator/=(float S) noexcept
 	{
-		const XMVECTOR q1 = XMLoadFloat4(this);
-		XMVECTOR q2 = XMLoadFloat4(&q);
-		q2 = XMQuaternionInverse(q2);
-		XMStoreFloat4(this, XMQuaternionMultiply(q1, q2));
+		if (S == 0.0f)
+		{
+			return *this;
+		}
+		if (std::is_constant_evaluated())
+			return *this *= 1.f / S;
+
+		const XMVECTOR v1 = XMLoadFloat4(this);
+		const XMVECTOR X = XMVectorScale(v1, 1.f / S);
+		XMStoreFloat4(this, X);
 		return *this;
 	}
 
-	inline Quaternion Quaternion::operator-() const noexcept
+	constexpr Vector4 Vector4::operator-() const noexcept
 	{
-		const XMVECTOR q = XMLoadFloat4(this);
+		if (std::is_constant_evaluated())
+			return Vector4(-x, -y, -z, -w);
 
-		Quaternion R;
-		XMStoreFloat4(&R, XMVectorNegate(q));
+		const XMVECTOR v1 = XMLoadFloat4(this);
+		const XMVECTOR X = XMVectorNegate(v1);
+		Vector4 R;
+		XMStoreFloat4(&R, X);
 		return R;
 	}
 
-	inline Quaternion operator+(const Quaternion& Q1, const Quaternion& Q2) noexcept
+	constexpr Vector4 operator+(const Vector4& V1, const Vector4& V2) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return Vector4(V1.x + V2.x, V1.y + V2.y, V1.z + V2.z, V1.w + V2.w);
+
+		const XMVECTOR v1 = XMLoadFloat4(&V1);
+		const XMVECTOR v2 = XMLoadFloat4(&V2);
+		const XMVECTOR X = XMVectorAdd(v1, v2);
+		Vector4 R;
+		XMStoreFloat4(&R, X);
+		return R;
+	}
+
+	constexpr Vector4 operator-(const Vector4& V1, const Vector4& V2) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return Vector4(V1.x - V2.x, V1.y - V2.y, V1.z - V2.z, V1.w - V2.w);
+
+		const XMVECTOR v1 = XMLoadFloat4(&V1);
+		const XMVECTOR v2 = XMLoadFloat4(&V2);
+		const XMVECTOR X = XMVectorSubtract(v1, v2);
+		Vector4 R;
+		XMStoreFloat4(&R, X);
+		return R;
+	}
+
+	constexpr Vector4 operator*(const Vector4& V1, const Vector4& V2) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return Vector4(V1.x * V2.x, V1.y * V2.y, V1.z * V2.z, V1.w * V2.w);
+
+		const XMVECTOR v1 = XMLoadFloat4(&V1);
+		const XMVECTOR v2 = XMLoadFloat4(&V2);
+		const XMVECTOR X = XMVectorMultiply(v1, v2);
+		Vector4 R;
+		XMStoreFloat4(&R, X);
+		return R;
+	}
+
+	constexpr Vector4 operator*(const Vector4& V, float S) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return Vector4(V.x * S, V.y * S, V.z * S, V.w * S);
+
+		const XMVECTOR v1 = XMLoadFloat4(&V);
+		const XMVECTOR X = XMVectorScale(v1, S);
+		Vector4 R;
+		XMStoreFloat4(&R, X);
+		return R;
+	}
+
+	constexpr Vector4 operator/(const Vector4& V1, const Vector4& V2) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return Vector4(V1.x / V2.x, V1.y / V2.y, V1.z / V2.z, V1.w / V2.w);
+
+		const XMVECTOR v1 = XMLoadFloat4(&V1);
+		const XMVECTOR v2 = XMLoadFloat4(&V2);
+		const XMVECTOR X = XMVectorDivide(v1, v2);
+		Vector4 R;
+		XMStoreFloat4(&R, X);
+		return R;
+	}
+
+	constexpr Vector4 operator/(const Vector4& V, float S) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return V * (1.f / S);
+
+		const XMVECTOR v1 = XMLoadFloat4(&V);
+		const XMVECTOR X = XMVectorScale(v1, 1.f / S);
+		Vector4 R;
+		XMStoreFloat4(&R, X);
+		return R;
+	}
+
+	constexpr Vector4 operator*(float S, const Vector4& V) noexcept
+	{
+		return V * S;
+	}
+
+	template <Precision P>
+	inline float Vector4::Length() const noexcept
+	{
+		const XMVECTOR v1 = XMLoadFloat4(this);
+		if constexpr (P == Precision::Exact)
+			return XMVectorGetX(XMVector4Length(v1));
+		return XMVectorGetX(Detail::Sqrt<P>(XMVector4LengthSq(v1)));
+	}
+
+	constexpr float Vector4::Dot(const Vector4& V) const noexcept
+	{
+		if (std::is_constant_evaluated())
+			return x * V.x + y * V.y + z * V.z + w * V.w;
+
+		const XMVECTOR v1 = XMLoadFloat4(this);
+		const XMVECTOR v2 = XMLoadFloat4(&V);
+		const XMVECTOR X = XMVector4Dot(v1, v2);
+		return XMVectorGetX(X);
+	}
+
+	template <Precision P>
+	inline void Vector4::Normalize() noexcept
+	{
+		Normalize<P>(*this);
+	}
+
+	template <Precision P>
+	inline void Vector4::Normalize(Vector4& result) const noexcept
+	{
+		const XMVECTOR v1 = XMLoadFloat4(this);
+		if constexpr (P == Precision::Exact)
+			XMStoreFloat4(&result, XMVector4Normalize(v1));
+		else
+			XMStoreFloat4(&result, Detail::Normalize<P>(v1, XMVector4LengthSq(v1)));
+	}
+
+	//****************************************************************************
+	//Quaternion
+
+	constexpr bool Quaternion::operator ==(const Quaternion& q) const noexcept
+	{
+		if (std::is_constant_evaluated())
+			return x == q.x && y == q.y && z == q.z && w == q.w;
+
+		const XMVECTOR q1 = XMLoadFloat4(this);
+		const XMVECTOR q2 = XMLoadFloat4(&q);
+		return XMQuaternionEqual(q1, q2);
+	}
+
+	constexpr bool Quaternion::operator !=(const Quaternion& q) const noexcept
+	{
+		if (std::is_constant_evaluated())
+			return x != q.x || y != q.y || z != q.z || w != q.w;
+
+		const XMVECTOR q1 = XMLoadFloat4(this);
+		const XMVECTOR q2 = XMLoadFloat4(&q);
+		return XMQuaternionNotEqual(q1, q2);
+	}
+
+	constexpr Quaternion& Quaternion::operator+=(const Quaternion& q) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return *this = Quaternion(x + q.x, y + q.y, z + q.z, w + q.w);
+
+		const XMVECTOR q1 = XMLoadFloat4(this);
+		const XMVECTOR q2 = XMLoadFloat4(&q);
+		XMStoreFloat4(this, XMVectorAdd(q1, q2));
+		return *this;
+	}
+
+	constexpr Quaternion& Quaternion::operator-=(const Quaternion& q) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return *this = Quaternion(x - q.x, y - q.y, z - q.z, w - q.w);
+
+		const XMVECTOR q1 = XMLoadFloat4(this);
+		const XMVECTOR q2 = XMLoadFloat4(&q);
+		XMStoreFloat4(this, XMVectorSubtract(q1, q2));
+		return *this;
+	}
+
+	constexpr Quaternion& Quaternion::operator*=(const Quaternion& q) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return *this = Detail::QuaternionMultiply(*this, q);
+
+		using namespace DirectX;
+		const XMVECTOR q1 = XMLoadFloat4(this);
+		const XMVECTOR q2 = XMLoadFloat4(&q);
+		XMStoreFloat4(this, XMQuaternionMultiply(q1, q2));
+		return *this;
+	}
+
+	constexpr Quaternion& Quaternion::operator*=(float S) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return *this = Quaternion(x * S, y * S, z * S, w * S);
+
+		const XMVECTOR q = XMLoadFloat4(this);
+		XMStoreFloat4(this, XMVectorScale(q, S));
+		return *this;
+	}
+
+	constexpr Quaternion& Quaternion::operator/=(const Quaternion& q) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return *this = Detail::QuaternionMultiply(*this, Detail::QuaternionInverse(q));
+
+		const XMVECTOR q1 = XMLoadFloat4(this);
+		XMVECTOR q2 = XMLoadFloat4(&q);
+		q2 = XMQuaternionInverse(q2);
+		XMStoreFloat4(this, XMQuaternionMultiply(q1, q2));
+		return *this;
+	}
+
+	constexpr Quaternion Quaternion::operator-() const noexcept
+	{
+		if (std::is_constant_evaluated())
+			return Quaternion(-x, -y, -z, -w);
+
+		const XMVECTOR q = XMLoadFloat4(this);
+
+		Quaternion R;
+		XMStoreFloat4(&R, XMVectorNegate(q));
+		return R;
+	}
+
+	constexpr Quaternion operator+(const Quaternion& Q1, const Quaternion& Q2) noexcept
+	{
+		if (std::is_constant_evaluated())
+			return Quaternion(Q1.x + Q2.x, Q1.y + Q2.y, Q1.z + Q2.z, Q1.w + Q2.w);
+
 		const XMVECTOR q1 = XMLoadFloat4(&Q1);
 		const XMVECTOR q2 = XMLoadFloat4(&Q2);
 
@@ -271,8 +1038,11 @@ namespace PMgene::Math
 		return R;
 	}
 
-	inline Quaternion operator-(const Quaternion& Q1, const Quaternion& Q2) noexcept
+	constexpr Quaternion operator-(const Quaternion& Q1, const Quaternion& Q2) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return Quaternion(Q1.x - Q2.x, Q1.y - Q2.y, Q1.z - Q2.z, Q1.w - Q2.w);
+
 		const XMVECTOR q1 = XMLoadFloat4(&Q1);
 		const XMVECTOR q2 = XMLoadFloat4(&Q2);
 
@@ -281,8 +1051,11 @@ namespace PMgene::Math
 		return R;
 	}
 
-	inline Quaternion operator*(const Quaternion& Q1, const Quaternion& Q2) noexcept
+	constexpr Quaternion operator*(const Quaternion& Q1, const Quaternion& Q2) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return Detail::QuaternionMultiply(Q1, Q2);
+
 		const XMVECTOR q1 = XMLoadFloat4(&Q1);
 		const XMVECTOR q2 = XMLoadFloat4(&Q2);
 
@@ -291,8 +1064,11 @@ namespace PMgene::Math
 		return R;
 	}
 
-	inline Quaternion operator*(const Quaternion& Q, float S) noexcept
+	constexpr Quaternion operator*(const Quaternion& Q, float S) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return Quaternion(Q.x * S, Q.y * S, Q.z * S, Q.w * S);
+
 		const XMVECTOR q = XMLoadFloat4(&Q);
 
 		Quaternion R;
@@ -300,8 +1076,11 @@ namespace PMgene::Math
 		return R;
 	}
 
-	inline Quaternion operator/(const Quaternion& Q1, const Quaternion& Q2) noexcept
+	constexpr Quaternion operator/(const Quaternion& Q1, const Quaternion& Q2) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return Detail::QuaternionMultiply(Q1, Detail::QuaternionInverse(Q2));
+
 		const XMVECTOR q1 = XMLoadFloat4(&Q1);
 		XMVECTOR q2 = XMLoadFloat4(&Q2);
 		q2 = XMQuaternionInverse(q2);
@@ -311,47 +1090,66 @@ namespace PMgene::Math
 		return R;
 	}
 
-	inline Quaternion operator*(float S, const Quaternion& Q) noexcept
+	constexpr Quaternion operator*(float S, const Quaternion& Q) noexcept
 	{
-		const XMVECTOR q1 = XMLoadFloat4(&Q);
-
-		Quaternion R;
-		XMStoreFloat4(&R, XMVectorScale(q1, S));
-		return R;
+		return Q * S;
 	}
 
+	template <Precision P>
 	inline float Quaternion::Length() const noexcept
 	{
 		const XMVECTOR q = XMLoadFloat4(this);
-		return XMVectorGetX(XMQuaternionLength(q));
+		if constexpr (P == Precision::Exact)
+			return XMVectorGetX(XMQuaternionLength(q));
+		return XMVectorGetX(Detail::Sqrt<P>(XMQuaternionLengthSq(q)));
 	}
 
+	template <Precision P>
 	inline void Quaternion::Normalize() noexcept
 	{
 		const XMVECTOR q = XMLoadFloat4(this);
-		XMStoreFloat4(this, XMQuaternionNormalize(q));
+		if constexpr (P == Precision::Exact)
+			XMStoreFloat4(this, XMQuaternionNormalize(q));
+		else
+			XMStoreFloat4(this, Detail::Normalize<P>(q, XMQuaternionLengthSq(q)));
 	}
 
-	inline void Quaternion::Conjugate() noexcept
+	constexpr void Quaternion::Conjugate() noexcept
 	{
+		if (std::is_constant_evaluated())
+		{
+			*this = Quaternion(-x, -y, -z, w);
+			return;
+		}
+
 		const XMVECTOR q = XMLoadFloat4(this);
 		XMStoreFloat4(this, XMQuaternionConjugate(q));
 	}
 
-	inline void Quaternion::Inverse(Quaternion& result) const noexcept
+	constexpr void Quaternion::Inverse(Quaternion& result) const noexcept
 	{
+		if (std::is_constant_evaluated())
+		{
+			result = Detail::QuaternionInverse(*this);
+			return;
+		}
+
 		using namespace DirectX;
 		const XMVECTOR q = XMLoadFloat4(this);
 		XMStoreFloat4(&result, XMQuaternionInverse(q));
 	}
 
-	inline float Quaternion::Dot(const Quaternion& q) const noexcept
+	constexpr float Quaternion::Dot(const Quaternion& q) const noexcept
 	{
+		if (std::is_constant_evaluated())
+			return x * q.x + y * q.y + z * q.z + w * q.w;
+
 		const XMVECTOR q1 = XMLoadFloat4(this);
 		const XMVECTOR q2 = XMLoadFloat4(&q);
 		return XMVectorGetX(XMQuaternionDot(q1, q2));
 	}
 
+	template <Precision P>
 	inline Vector3 Quaternion::ToEuler() const noexcept
 	{
 		const float xx = x * x;
@@ -362,19 +1160,19 @@ namespace PMgene::Math
 		const float m32 = 2.f * y * z - 2.f * x * w;
 		const float m33 = 1.f - 2.f * xx - 2.f * yy;
 
-		const float cy = sqrtf(m33 * m33 + m31 * m31);
-		const float cx = atan2f(-m32, cy);
+		const float cy = Sqrt<P>(m33 * m33 + m31 * m31);
+		const float cx = Atan2<P>(-m32, cy);
 		if (cy > 16.f * FLT_EPSILON)
 		{
 			const float m12 = 2.f * x * y + 2.f * z * w;
 			const float m22 = 1.f - 2.f * xx - 2.f * zz;
 
-			return Vector3(cx, atan2f(m31, m33), atan2f(m12, m22));
+			return Vector3(cx, Atan2<P>(m31, m33), Atan2<P>(m12, m22));
 		}
 		const float m11 = 1.f - 2.f * yy - 2.f * zz;
 		const float m21 = 2.f * x * y - 2.f * z * w;
 
-		return Vector3(cx, 0.f, atan2f(-m21, m11));
+		return Vector3(cx, 0.f, Atan2<P>(-m21, m11));
 	}
 
 	inline Quaternion Quaternion::CreateFromAxisAngle(const Vector3& axis, float angle) noexcept
@@ -396,7 +1194,7 @@ namespace PMgene::Math
 	inline Quaternion Quaternion::CreateFromYawPitchRoll(const Vector3& angles) noexcept
 	{
 		Quaternion R;
-		XMStoreFloat4(&R, XMQuaternionRotationRollPitchYawFromVector(angles));
+		XMStoreFloat4(&R, XMQuaternionRotationRollPitchYawFromVector(XMLoadFloat3(&angles)));
 		return R;
 	}
 
@@ -476,8 +1274,11 @@ namespace PMgene::Math
 		return result;
 	}
 
-	inline Quaternion Quaternion::Concatenate(const Quaternion& q1, const Quaternion& q2) noexcept
+	constexpr Quaternion Quaternion::Concatenate(const Quaternion& q1, const Quaternion& q2) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return Detail::QuaternionMultiply(q2, q1);
+
 		const XMVECTOR Q0 = XMLoadFloat4(&q1);
 		const XMVECTOR Q1 = XMLoadFloat4(&q2);
 
@@ -503,8 +1304,12 @@ namespace PMgene::Math
 	//****************************************************************************
 	//Matrix
 
-	inline bool Matrix::operator ==(const Matrix& M) const noexcept
+	constexpr bool Matrix::operator ==(const Matrix& M) const noexcept
 	{
+		if (std::is_constant_evaluated())
+			return _11 == M._11 && _12 == M._12 && _13 == M._13 && _14 == M._14 && _21 == M._21 && _22 == M._22 && _23 == M._23 && _24 == M._24
+			    && _31 == M._31 && _32 == M._32 && _33 == M._33 && _34 == M._34 && _41 == M._41 && _42 == M._42 && _43 == M._43 && _44 == M._44;
+
 		const XMVECTOR x1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_11));
 		const XMVECTOR x2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_21));
 		const XMVECTOR x3 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_31));
@@ -521,8 +1326,11 @@ namespace PMgene::Math
 			&& XMVector4Equal(x4, y4)) != 0;
 	}
 
-	inline bool Matrix::operator !=(const Matrix& M) const noexcept
+	constexpr bool Matrix::operator !=(const Matrix& M) const noexcept
 	{
+		if (std::is_constant_evaluated())
+			return !(*this == M);
+
 		const XMVECTOR x1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_11));
 		const XMVECTOR x2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_21));
 		const XMVECTOR x3 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_31));
@@ -601,8 +1409,11 @@ namespace PMgene::Math
 		return *this;
 	}
 
-	inline Matrix& Matrix::operator+=(const Matrix& M) noexcept
+	constexpr Matrix& Matrix::operator+=(const Matrix& M) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return *this = Detail::MapElements(*this, M, [](float a, float b) { return a + b; });
+
 		XMVECTOR x1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_11));
 		XMVECTOR x2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_21));
 		XMVECTOR x3 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_31));
@@ -625,8 +1436,11 @@ namespace PMgene::Math
 		return *this;
 	}
 
-	inline Matrix& Matrix::operator-=(const Matrix& M) noexcept
+	constexpr Matrix& Matrix::operator-=(const Matrix& M) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return *this = Detail::MapElements(*this, M, [](float a, float b) { return a - b; });
+
 		XMVECTOR x1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_11));
 		XMVECTOR x2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_21));
 		XMVECTOR x3 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_31));
@@ -649,8 +1463,11 @@ namespace PMgene::Math
 		return *this;
 	}
 
-	inline Matrix& Matrix::operator*=(const Matrix& M) noexcept
+	constexpr Matrix& Matrix::operator*=(const Matrix& M) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return *this = Detail::MatrixMultiply(*this, M);
+
 		const XMMATRIX M1 = XMLoadFloat4x4(this);
 		const XMMATRIX M2 = XMLoadFloat4x4(&M);
 		const XMMATRIX X = XMMatrixMultiply(M1, M2);
@@ -658,8 +1475,11 @@ namespace PMgene::Math
 		return *this;
 	}
 
-	inline Matrix& Matrix::operator*=(float S) noexcept
+	constexpr Matrix& Matrix::operator*=(float S) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return *this = Detail::MapElements(*this, [S](float a) { return a * S; });
+
 		XMVECTOR x1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_11));
 		XMVECTOR x2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_21));
 		XMVECTOR x3 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_31));
@@ -677,8 +1497,11 @@ namespace PMgene::Math
 		return *this;
 	}
 
-	inline Matrix& Matrix::operator/=(float S) noexcept
+	constexpr Matrix& Matrix::operator/=(float S) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return *this *= 1.f / S;
+
 		assert(S != 0.f);
 		XMVECTOR x1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_11));
 		XMVECTOR x2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_21));
@@ -699,8 +1522,11 @@ namespace PMgene::Math
 		return *this;
 	}
 
-	inline Matrix& Matrix::operator/=(const Matrix& M) noexcept
+	constexpr Matrix& Matrix::operator/=(const Matrix& M) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return *this = Detail::MapElements(*this, M, [](float a, float b) { return a / b; });
+
 		XMVECTOR x1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_11));
 		XMVECTOR x2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_21));
 		XMVECTOR x3 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_31));
@@ -723,8 +1549,11 @@ namespace PMgene::Math
 		return *this;
 	}
 
-	inline Matrix Matrix::operator-() const noexcept
+	constexpr Matrix Matrix::operator-() const noexcept
 	{
+		if (std::is_constant_evaluated())
+			return Detail::MapElements(*this, [](float a) { return -a; });
+
 		XMVECTOR v1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_11));
 		XMVECTOR v2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_21));
 		XMVECTOR v3 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_31));
@@ -743,8 +1572,11 @@ namespace PMgene::Math
 		return R;
 	}
 
-	inline Matrix operator+(const Matrix& M1, const Matrix& M2) noexcept
+	constexpr Matrix operator+(const Matrix& M1, const Matrix& M2) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return Detail::MapElements(M1, M2, [](float a, float b) { return a + b; });
+
 		XMVECTOR x1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&M1._11));
 		XMVECTOR x2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&M1._21));
 		XMVECTOR x3 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&M1._31));
@@ -768,8 +1600,11 @@ namespace PMgene::Math
 		return R;
 	}
 
-	inline Matrix operator-(const Matrix& M1, const Matrix& M2) noexcept
+	constexpr Matrix operator-(const Matrix& M1, const Matrix& M2) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return Detail::MapElements(M1, M2, [](float a, float b) { return a - b; });
+
 		XMVECTOR x1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&M1._11));
 		XMVECTOR x2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&M1._21));
 		XMVECTOR x3 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&M1._31));
@@ -793,8 +1628,11 @@ namespace PMgene::Math
 		return R;
 	}
 
-	inline Matrix operator*(const Matrix& M1, const Matrix& M2) noexcept
+	constexpr Matrix operator*(const Matrix& M1, const Matrix& M2) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return Detail::MatrixMultiply(M1, M2);
+
 		const XMMATRIX m1 = XMLoadFloat4x4(&M1);
 		const XMMATRIX m2 = XMLoadFloat4x4(&M2);
 		const XMMATRIX X = XMMatrixMultiply(m1, m2);
@@ -804,8 +1642,11 @@ namespace PMgene::Math
 		return R;
 	}
 
-	inline Matrix operator*(const Matrix& M, float S) noexcept
+	constexpr Matrix operator*(const Matrix& M, float S) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return Detail::MapElements(M, [S](float a) { return a * S; });
+
 		XMVECTOR x1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&M._11));
 		XMVECTOR x2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&M._21));
 		XMVECTOR x3 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&M._31));
@@ -824,8 +1665,11 @@ namespace PMgene::Math
 		return R;
 	}
 
-	inline Matrix operator/(const Matrix& M, float S) noexcept
+	constexpr Matrix operator/(const Matrix& M, float S) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return M * (1.f / S);
+
 		assert(S != 0.f);
 
 		XMVECTOR x1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&M._11));
@@ -848,8 +1692,11 @@ namespace PMgene::Math
 		return R;
 	}
 
-	inline Matrix operator/(const Matrix& M1, const Matrix& M2) noexcept
+	constexpr Matrix operator/(const Matrix& M1, const Matrix& M2) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return Detail::MapElements(M1, M2, [](float a, float b) { return a / b; });
+
 		XMVECTOR x1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&M1._11));
 		XMVECTOR x2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&M1._21));
 		XMVECTOR x3 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&M1._31));
@@ -873,31 +1720,16 @@ namespace PMgene::Math
 		return R;
 	}
 
-	inline Matrix operator*(float S, const Matrix& M) noexcept
+	constexpr Matrix operator*(float S, const Matrix& M) noexcept
 	{
-		XMVECTOR x1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&M._11));
-		XMVECTOR x2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&M._21));
-		XMVECTOR x3 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&M._31));
-		XMVECTOR x4 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&M._41));
-
-		x1 = XMVectorScale(x1, S);
-		x2 = XMVectorScale(x2, S);
-		x3 = XMVectorScale(x3, S);
-		x4 = XMVectorScale(x4, S);
-
-		Matrix R;
-		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&R._11), x1);
-		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&R._21), x2);
-		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&R._31), x3);
-		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&R._41), x4);
-		return R;
+		return M * S;
 	}
 
-	inline bool Matrix::Decompose(Vector3& scale, Quaternion& rotation, Vector3& translation) noexcept
+	inline bool Matrix::Decompose(Vector3& scale, Quaternion& rotation, Vector3& translation) const noexcept
 	{
 		XMVECTOR s, r, t;
 
-		if (!XMMatrixDecompose(&s, &r, &t, *this))
+		if (!XMMatrixDecompose(&s, &r, &t, XMLoadFloat4x4(this)))
 			return false;
 
 		XMStoreFloat3(&scale, s);
@@ -907,18 +1739,25 @@ namespace PMgene::Math
 		return true;
 	}
 
-	inline Matrix Matrix::Transpose() const noexcept
+	inline bool Matrix::Decompose(SQT& result) const noexcept
+	{
+		return Decompose(result.scale, result.rotation, result.translation);
+	}
+
+	constexpr Matrix Matrix::Transpose() const noexcept
 	{
+		if (std::is_constant_evaluated())
+			return Matrix(_11, _21, _31, _41, _12, _22, _32, _42, _13, _23, _33, _43, _14, _24, _34, _44);
+
 		const XMMATRIX M = XMLoadFloat4x4(this);
 		Matrix R;
 		XMStoreFloat4x4(&R, XMMatrixTranspose(M));
 		return R;
 	}
 
-	inline void Matrix::Transpose(Matrix& result) const noexcept
+	constexpr void Matrix::Transpose(Matrix& result) const noexcept
 	{
-		const XMMATRIX M = XMLoadFloat4x4(this);
-		XMStoreFloat4x4(&result, XMMatrixTranspose(M));
+		result = Transpose();
 	}
 
 	inline Matrix Matrix::Invert() const noexcept
@@ -943,68 +1782,141 @@ namespace PMgene::Math
 		return XMVectorGetX(XMMatrixDeterminant(M));
 	}
 
+	template <Precision P>
 	inline Vector3 Matrix::ToEuler() const noexcept
 	{
-		const float cy = sqrtf(_33 * _33 + _31 * _31);
-		const float cx = atan2f(-_32, cy);
+		const float cy = Sqrt<P>(_33 * _33 + _31 * _31);
+		const float cx = Atan2<P>(-_32, cy);
 		if (cy > 16.f * FLT_EPSILON)
 		{
-			return Vector3(cx, atan2f(_31, _33), atan2f(_12, _22));
+			return Vector3(cx, Atan2<P>(_31, _33), Atan2<P>(_12, _22));
 		}
-		return Vector3(cx, 0.f, atan2f(-_21, _11));
+		return Vector3(cx, 0.f, Atan2<P>(-_21, _11));
+	}
+
+	inline Vector3 Matrix::TransformPoint(const Vector3& V) const noexcept
+	{
+		const XMMATRIX M = XMLoadFloat4x4(this);
+		const XMVECTOR v1 = XMLoadFloat3(&V);
+		Vector3 R;
+		XMStoreFloat3(&R, XMVector3Transform(v1, M));
+		return R;
+	}
+
+	inline Vector3 Matrix::TransformNormal(const Vector3& V) const noexcept
+	{
+		const XMMATRIX M = XMLoadFloat4x4(this);
+		const XMVECTOR v1 = XMLoadFloat3(&V);
+		Vector3 R;
+		XMStoreFloat3(&R, XMVector3TransformNormal(v1, M));
+		return R;
+	}
+
+	inline Vector3 Matrix::TransformCoord(const Vector3& V) const noexcept
+	{
+		const XMMATRIX M = XMLoadFloat4x4(this);
+		const XMVECTOR v1 = XMLoadFloat3(&V);
+		Vector3 R;
+		XMStoreFloat3(&R, XMVector3TransformCoord(v1, M));
+		return R;
+	}
+
+	inline Vector4 Matrix::Transform(const Vector4& V) const noexcept
+	{
+		const XMMATRIX M = XMLoadFloat4x4(this);
+		const XMVECTOR v1 = XMLoadFloat4(&V);
+		Vector4 R;
+		XMStoreFloat4(&R, XMVector4Transform(v1, M));
+		return R;
 	}
 
-	inline Matrix Matrix::CreateTranslation(const Vector3& position) noexcept
+	constexpr Matrix Matrix::CreateTranslation(const Vector3& position) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return CreateTranslation(position.x, position.y, position.z);
+
 		Matrix R;
 		XMStoreFloat4x4(&R, XMMatrixTranslation(position.x, position.y, position.z));
 		return R;
 	}
 
-	inline Matrix Matrix::CreateTranslation(float x, float y, float z) noexcept
+	constexpr Matrix Matrix::CreateTranslation(float x, float y, float z) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return Matrix(1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, x, y, z, 1.f);
+
 		Matrix R;
 		XMStoreFloat4x4(&R, XMMatrixTranslation(x, y, z));
 		return R;
 	}
 
-	inline Matrix Matrix::CreateScale(const Vector3& scales) noexcept
+	constexpr Matrix Matrix::CreateScale(const Vector3& scales) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return CreateScale(scales.x, scales.y, scales.z);
+
 		Matrix R;
 		XMStoreFloat4x4(&R, XMMatrixScaling(scales.x, scales.y, scales.z));
 		return R;
 	}
 
-	inline Matrix Matrix::CreateScale(float xs, float ys, float zs) noexcept
+	constexpr Matrix Matrix::CreateScale(float xs, float ys, float zs) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return Matrix(xs, 0.f, 0.f, 0.f, 0.f, ys, 0.f, 0.f, 0.f, 0.f, zs, 0.f, 0.f, 0.f, 0.f, 1.f);
+
 		Matrix R;
 		XMStoreFloat4x4(&R, XMMatrixScaling(xs, ys, zs));
 		return R;
 	}
 
-	inline Matrix Matrix::CreateScale(float scale) noexcept
+	constexpr Matrix Matrix::CreateScale(float scale) noexcept
 	{
+		if (std::is_constant_evaluated())
+			return CreateScale(scale, scale, scale);
+
 		Matrix R;
 		XMStoreFloat4x4(&R, XMMatrixScaling(scale, scale, scale));
 		return R;
 	}
 
-	inline Matrix Matrix::CreateRotationX(float radians) noexcept
+	constexpr Matrix Matrix::CreateRotationX(float radians) noexcept
 	{
+		if (std::is_constant_evaluated())
+		{
+			float sin = 0.f, cos = 0.f;
+			Detail::ScalarSinCos(radians, sin, cos);
+			return Matrix(1.f, 0.f, 0.f, 0.f, 0.f, cos, sin, 0.f, 0.f, -sin, cos, 0.f, 0.f, 0.f, 0.f, 1.f);
+		}
+
 		Matrix R;
 		XMStoreFloat4x4(&R, XMMatrixRotationX(radians));
 		return R;
 	}
 
-	inline Matrix Matrix::CreateRotationY(float radians) noexcept
+	constexpr Matrix Matrix::CreateRotationY(float radians) noexcept
 	{
+		if (std::is_constant_evaluated())
+		{
+			float sin = 0.f, cos = 0.f;
+			Detail::ScalarSinCos(radians, sin, cos);
+			return Matrix(cos, 0.f, -sin, 0.f, 0.f, 1.f, 0.f, 0.f, sin, 0.f, cos, 0.f, 0.f, 0.f, 0.f, 1.f);
+		}
+
 		Matrix R;
 		XMStoreFloat4x4(&R, XMMatrixRotationY(radians));
 		return R;
 	}
 
-	inline Matrix Matrix::CreateRotationZ(float radians) noexcept
+	constexpr Matrix Matrix::CreateRotationZ(float radians) noexcept
 	{
+		if (std::is_constant_evaluated())
+		{
+			float sin = 0.f, cos = 0.f;
+			Detail::ScalarSinCos(radians, sin, cos);
+			return Matrix(cos, sin, 0.f, 0.f, -sin, cos, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f);
+		}
+
 		Matrix R;
 		XMStoreFloat4x4(&R, XMMatrixRotationZ(radians));
 		return R;
@@ -1019,23 +1931,45 @@ namespace PMgene::Math
 		return R;
 	}
 
-	inline Matrix Matrix::CreatePerspectiveFieldOfView(float fov, float aspectRatio, float nearPlane,
-	                                                   float farPlane) noexcept
+	constexpr Matrix Matrix::CreatePerspectiveFieldOfView(float fov, float aspectRatio, float nearPlane,
+	                                                      float farPlane) noexcept
 	{
+		if (std::is_constant_evaluated())
+		{
+			float sin = 0.f, cos = 0.f;
+			Detail::ScalarSinCos(0.5f * fov, sin, cos);
+			const float height = cos / sin;
+			const float range = farPlane / (nearPlane - farPlane);
+			return Matrix(height / aspectRatio, 0.f, 0.f, 0.f, 0.f, height, 0.f, 0.f, 0.f, 0.f, range, -1.f, 0.f, 0.f, range * nearPlane, 0.f);
+		}
+
 		Matrix R;
 		XMStoreFloat4x4(&R, XMMatrixPerspectiveFovRH(fov, aspectRatio, nearPlane, farPlane));
 		return R;
 	}
 
-	inline Matrix Matrix::CreatePerspective(float width, float height, float nearPlane, float farPlane) noexcept
+	constexpr Matrix Matrix::CreatePerspective(float width, float height, float nearPlane, float farPlane) noexcept
 	{
+		if (std::is_constant_evaluated())
+		{
+			const float twoNear = nearPlane + nearPlane;
+			const float range = farPlane / (nearPlane - farPlane);
+			return Matrix(twoNear / width, 0.f, 0.f, 0.f, 0.f, twoNear / height, 0.f, 0.f, 0.f, 0.f, range, -1.f, 0.f, 0.f, range * nearPlane, 0.f);
+		}
+
 		Matrix R;
 		XMStoreFloat4x4(&R, XMMatrixPerspectiveRH(width, height, nearPlane, farPlane));
 		return R;
 	}
 
-	inline Matrix Matrix::CreateOrthographic(float width, float height, float zNearPlane, float zFarPlane) noexcept
+	constexpr Matrix Matrix::CreateOrthographic(float width, float height, float zNearPlane, float zFarPlane) noexcept
 	{
+		if (std::is_constant_evaluated())
+		{
+			const float range = 1.f / (zNearPlane - zFarPlane);
+			return Matrix(2.f / width, 0.f, 0.f, 0.f, 0.f, 2.f / height, 0.f, 0.f, 0.f, 0.f, range, 0.f, 0.f, 0.f, range * zNearPlane, 1.f);
+		}
+
 		Matrix R;
 		XMStoreFloat4x4(&R, XMMatrixOrthographicRH(width, height, zNearPlane, zFarPlane));
 		return R;
@@ -1070,8 +2004,19 @@ namespace PMgene::Math
 		return R;
 	}
 
-	inline Matrix Matrix::CreateFromQuaternion(const Quaternion& rotation) noexcept
+	constexpr Matrix Matrix::CreateFromQuaternion(const Quaternion& rotation) noexcept
 	{
+		if (std::is_constant_evaluated())
+		{
+			const float xx = rotation.x * rotation.x, yy = rotation.y * rotation.y, zz = rotation.z * rotation.z;
+			const float xy = rotation.x * rotation.y, xz = rotation.x * rotation.z, yz = rotation.y * rotation.z;
+			const float xw = rotation.x * rotation.w, yw = rotation.y * rotation.w, zw = rotation.z * rotation.w;
+			return Matrix(1.f - 2.f * (yy + zz), 2.f * (xy + zw), 2.f * (xz - yw), 0.f,
+			              2.f * (xy - zw), 1.f - 2.f * (xx + zz), 2.f * (yz + xw), 0.f,
+			              2.f * (xz + yw), 2.f * (yz - xw), 1.f - 2.f * (xx + yy), 0.f,
+			              0.f, 0.f, 0.f, 1.f);
+		}
+
 		const XMVECTOR quatv = XMLoadFloat4(&rotation);
 		Matrix R;
 		XMStoreFloat4x4(&R, XMMatrixRotationQuaternion(quatv));
@@ -1088,7 +2033,7 @@ namespace PMgene::Math
 	inline Matrix Matrix::CreateFromYawPitchRoll(const Vector3& angles) noexcept
 	{
 		Matrix R;
-		XMStoreFloat4x4(&R, XMMatrixRotationRollPitchYawFromVector(angles));
+		XMStoreFloat4x4(&R, XMMatrixRotationRollPitchYawFromVector(XMLoadFloat3(&angles)));
 		return R;
 	}
 
@@ -1153,4 +2098,518 @@ namespace PMgene::Math
 		XMStoreFloat4x4(&result, XMMatrixMultiply(M0, M1));
 		return result;
 	}
+
+
+	//****************************************************************************
+	//Matrix3
+
+	inline Matrix3::Matrix3(const Matrix& M) noexcept : XMFLOAT3X3()
+	{
+		XMStoreFloat3x3(this, XMLoadFloat4x4(&M));
+	}
+
+	inline bool Matrix3::operator ==(const Matrix3& M) const noexcept
+	{
+		const XMMATRIX X = XMLoadFloat3x3(this);
+		const XMMATRIX Y = XMLoadFloat3x3(&M);
+		return (XMVector3Equal(X.r[0], Y.r[0])
+			&& XMVector3Equal(X.r[1], Y.r[1])
+			&& XMVector3Equal(X.r[2], Y.r[2])) != 0;
+	}
+
+	inline bool Matrix3::operator !=(const Matrix3& M) const noexcept
+	{
+		return !(*this == M);
+	}
+
+	inline Matrix3& Matrix3::operator+=(const Matrix3& M) noexcept
+	{
+		return *this = *this + M;
+	}
+
+	inline Matrix3& Matrix3::operator-=(const Matrix3& M) noexcept
+	{
+		return *this = *this - M;
+	}
+
+	inline Matrix3& Matrix3::operator*=(const Matrix3& M) noexcept
+	{
+		return *this = *this * M;
+	}
+
+	inline Matrix3& Matrix3::operator*=(float S) noexcept
+	{
+		return *this = *this * S;
+	}
+
+	inline Matrix3 Matrix3::operator-() const noexcept
+	{
+		const XMMATRIX M = XMLoadFloat3x3(this);
+		return Matrix3(XMMATRIX(XMVectorNegate(M.r[0]), XMVectorNegate(M.r[1]), XMVectorNegate(M.r[2]), M.r[3]));
+	}
+
+	inline Matrix Matrix3::ToMatrix() const noexcept
+	{
+		Matrix R;
+		R = *this;
+		return R;
+	}
+
+	inline Matrix3 Matrix3::Transpose() const noexcept
+	{
+		return Matrix3(_11, _21, _31, _12, _22, _32, _13, _23, _33);
+	}
+
+	inline void Matrix3::Transpose(Matrix3& result) const noexcept
+	{
+		result = Transpose();
+	}
+
+	inline void Matrix3::Invert(Matrix3& result) const noexcept
+	{
+		const XMMATRIX M = XMLoadFloat3x3(this);
+
+		// The inverse has the cofactor rows as columns
+		const XMVECTOR c1 = XMVector3Cross(M.r[1], M.r[2]);
+		const XMVECTOR c2 = XMVector3Cross(M.r[2], M.r[0]);
+		const XMVECTOR c3 = XMVector3Cross(M.r[0], M.r[1]);
+		const XMVECTOR det = XMVector3Dot(M.r[0], c1);
+		assert(XMVectorGetX(det) != 0.f);
+
+		const XMVECTOR invDet = XMVectorReciprocal(det);
+		const XMMATRIX I = XMMatrixTranspose(XMMATRIX(XMVectorMultiply(c1, invDet), XMVectorMultiply(c2, invDet), XMVectorMultiply(c3, invDet),
+		                                              XMVectorZero()));
+		XMStoreFloat3x3(&result, I);
+	}
+
+	inline Matrix3 Matrix3::Invert() const noexcept
+	{
+		Matrix3 R;
+		Invert(R);
+		return R;
+	}
+
+	inline float Matrix3::Determinant() const noexcept
+	{
+		const XMMATRIX M = XMLoadFloat3x3(this);
+		return XMVectorGetX(XMVector3Dot(M.r[0], XMVector3Cross(M.r[1], M.r[2])));
+	}
+
+	inline Vector3 Matrix3::Transform(const Vector3& V) const noexcept
+	{
+		const XMMATRIX M = XMLoadFloat3x3(this);
+		Vector3 R;
+		XMStoreFloat3(&R, XMVector3TransformNormal(XMLoadFloat3(&V), M));
+		return R;
+	}
+
+	constexpr Matrix3 Matrix3::CreateScale(const Vector3& scales) noexcept
+	{
+		return Matrix3(scales.x, 0.f, 0.f,
+		               0.f, scales.y, 0.f,
+		               0.f, 0.f, scales.z);
+	}
+
+	inline Matrix3 Matrix3::CreateFromQuaternion(const Quaternion& rotation) noexcept
+	{
+		return Matrix3(XMMatrixRotationQuaternion(XMLoadFloat4(&rotation)));
+	}
+
+	inline Matrix3 operator+(const Matrix3& M1, const Matrix3& M2) noexcept
+	{
+		const XMMATRIX X = XMLoadFloat3x3(&M1);
+		const XMMATRIX Y = XMLoadFloat3x3(&M2);
+		return Matrix3(XMMATRIX(XMVectorAdd(X.r[0], Y.r[0]), XMVectorAdd(X.r[1], Y.r[1]), XMVectorAdd(X.r[2], Y.r[2]), X.r[3]));
+	}
+
+	inline Matrix3 operator-(const Matrix3& M1, const Matrix3& M2) noexcept
+	{
+		const XMMATRIX X = XMLoadFloat3x3(&M1);
+		const XMMATRIX Y = XMLoadFloat3x3(&M2);
+		return Matrix3(XMMATRIX(XMVectorSubtract(X.r[0], Y.r[0]), XMVectorSubtract(X.r[1], Y.r[1]), XMVectorSubtract(X.r[2], Y.r[2]), X.r[3]));
+	}
+
+	inline Matrix3 operator*(const Matrix3& M1, const Matrix3& M2) noexcept
+	{
+		// Row i of the result is M1[i].x * M2[0] + M1[i].y * M2[1] + M1[i].z * M2[2], nine
+		// multiply-adds against the sixteen of XMMatrixMultiply
+		const XMMATRIX X = XMLoadFloat3x3(&M1);
+		const XMMATRIX Y = XMLoadFloat3x3(&M2);
+		XMMATRIX R;
+		for (int i = 0; i < 3; ++i)
+		{
+			XMVECTOR r = XMVectorMultiply(XMVectorSplatX(X.r[i]), Y.r[0]);
+			r = XMVectorMultiplyAdd(XMVectorSplatY(X.r[i]), Y.r[1], r);
+			R.r[i] = XMVectorMultiplyAdd(XMVectorSplatZ(X.r[i]), Y.r[2], r);
+		}
+		R.r[3] = X.r[3];
+		return Matrix3(R);
+	}
+
+	inline Matrix3 operator*(const Matrix3& M, float S) noexcept
+	{
+		const XMMATRIX X = XMLoadFloat3x3(&M);
+		return Matrix3(XMMATRIX(XMVectorScale(X.r[0], S), XMVectorScale(X.r[1], S), XMVectorScale(X.r[2], S), X.r[3]));
+	}
+
+	inline Matrix3 operator*(float S, const Matrix3& M) noexcept
+	{
+		return M * S;
+	}
+
+
+	//****************************************************************************
+	//AffineTransform
+
+	inline AffineTransform::AffineTransform(const Matrix& M) noexcept : XMFLOAT3X4()
+	{
+		assert(M._14 == 0.f && M._24 == 0.f && M._34 == 0.f && M._44 == 1.f);
+		XMStoreFloat3x4(this, XMLoadFloat4x4(&M));
+	}
+
+	inline AffineTransform::AffineTransform(const SQT& T) noexcept : XMFLOAT3X4()
+	{
+		const XMVECTOR s = XMLoadFloat3(&T.scale);
+		const XMVECTOR r = XMLoadFloat4(&T.rotation);
+		const XMVECTOR t = XMLoadFloat3(&T.translation);
+		XMStoreFloat3x4(this, XMMatrixAffineTransformation(s, XMVectorZero(), r, t));
+	}
+
+	inline bool AffineTransform::operator ==(const AffineTransform& T) const noexcept
+	{
+		const XMVECTOR x1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_11));
+		const XMVECTOR x2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_21));
+		const XMVECTOR x3 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_31));
+
+		const XMVECTOR y1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&T._11));
+		const XMVECTOR y2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&T._21));
+		const XMVECTOR y3 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&T._31));
+
+		return (XMVector4Equal(x1, y1)
+			&& XMVector4Equal(x2, y2)
+			&& XMVector4Equal(x3, y3)) != 0;
+	}
+
+	inline bool AffineTransform::operator !=(const AffineTransform& T) const noexcept
+	{
+		return !(*this == T);
+	}
+
+	inline AffineTransform& AffineTransform::operator*=(const AffineTransform& T) noexcept
+	{
+		*this = *this * T;
+		return *this;
+	}
+
+	inline Matrix AffineTransform::ToMatrix() const noexcept
+	{
+		return Matrix(XMLoadFloat3x4(this));
+	}
+
+	inline bool AffineTransform::Decompose(Vector3& scale, Quaternion& rotation, Vector3& translation) const noexcept
+	{
+		XMVECTOR s, r, t;
+
+		if (!XMMatrixDecompose(&s, &r, &t, XMLoadFloat3x4(this)))
+			return false;
+
+		XMStoreFloat3(&scale, s);
+		XMStoreFloat4(&rotation, r);
+		XMStoreFloat3(&translation, t);
+
+		return true;
+	}
+
+	inline bool AffineTransform::Decompose(SQT& result) const noexcept
+	{
+		return Decompose(result.scale, result.rotation, result.translation);
+	}
+
+	inline void AffineTransform::Invert(AffineTransform& result) const noexcept
+	{
+		const XMVECTOR r1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_11));
+		const XMVECTOR r2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_21));
+		const XMVECTOR r3 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_31));
+
+		// The inverse of the 3x3 part has the cofactor rows as columns
+		const XMVECTOR c1 = XMVector3Cross(r2, r3);
+		const XMVECTOR c2 = XMVector3Cross(r3, r1);
+		const XMVECTOR c3 = XMVector3Cross(r1, r2);
+		const XMVECTOR det = XMVector3Dot(r1, c1);
+		assert(XMVectorGetX(det) != 0.f);
+
+		const XMVECTOR invDet = XMVectorReciprocal(det);
+		const XMMATRIX I = XMMatrixTranspose(XMMATRIX(c1, c2, c3, XMVectorZero()));
+		const XMVECTOR i1 = XMVectorMultiply(I.r[0], invDet);
+		const XMVECTOR i2 = XMVectorMultiply(I.r[1], invDet);
+		const XMVECTOR i3 = XMVectorMultiply(I.r[2], invDet);
+
+		const XMVECTOR t = XMVectorSet(_14, _24, _34, 0.f);
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&result._11), XMVectorSetW(i1, -XMVectorGetX(XMVector3Dot(i1, t))));
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&result._21), XMVectorSetW(i2, -XMVectorGetX(XMVector3Dot(i2, t))));
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&result._31), XMVectorSetW(i3, -XMVectorGetX(XMVector3Dot(i3, t))));
+	}
+
+	inline AffineTransform AffineTransform::Invert() const noexcept
+	{
+		AffineTransform R;
+		Invert(R);
+		return R;
+	}
+
+	inline void AffineTransform::InvertOrthonormal(AffineTransform& result) const noexcept
+	{
+		const XMVECTOR r1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_11));
+		const XMVECTOR r2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_21));
+		const XMVECTOR r3 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_31));
+
+		// Transposing the rows leaves the 3x3 transpose in the first three rows and the translation in the last
+		const XMMATRIX T = XMMatrixTranspose(XMMATRIX(r1, r2, r3, XMVectorZero()));
+		const XMVECTOR t = T.r[3];
+
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&result._11), XMVectorSetW(T.r[0], -XMVectorGetX(XMVector3Dot(T.r[0], t))));
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&result._21), XMVectorSetW(T.r[1], -XMVectorGetX(XMVector3Dot(T.r[1], t))));
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&result._31), XMVectorSetW(T.r[2], -XMVectorGetX(XMVector3Dot(T.r[2], t))));
+	}
+
+	inline AffineTransform AffineTransform::InvertOrthonormal() const noexcept
+	{
+		AffineTransform R;
+		InvertOrthonormal(R);
+		return R;
+	}
+
+	inline float AffineTransform::Determinant() const noexcept
+	{
+		const XMVECTOR r1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_11));
+		const XMVECTOR r2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_21));
+		const XMVECTOR r3 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_31));
+		return XMVectorGetX(XMVector3Dot(r1, XMVector3Cross(r2, r3)));
+	}
+
+	inline Vector3 AffineTransform::TransformPoint(const Vector3& V) const noexcept
+	{
+		const XMVECTOR v = XMVectorSetW(XMLoadFloat3(&V), 1.f);
+		const XMVECTOR r1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_11));
+		const XMVECTOR r2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_21));
+		const XMVECTOR r3 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_31));
+		return Vector3(XMVectorGetX(XMVector4Dot(r1, v)), XMVectorGetX(XMVector4Dot(r2, v)), XMVectorGetX(XMVector4Dot(r3, v)));
+	}
+
+	inline Vector3 AffineTransform::TransformNormal(const Vector3& V) const noexcept
+	{
+		const XMVECTOR v = XMLoadFloat3(&V);
+		const XMVECTOR r1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_11));
+		const XMVECTOR r2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_21));
+		const XMVECTOR r3 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&_31));
+		return Vector3(XMVectorGetX(XMVector3Dot(r1, v)), XMVectorGetX(XMVector3Dot(r2, v)), XMVectorGetX(XMVector3Dot(r3, v)));
+	}
+
+	inline AffineTransform operator*(const AffineTransform& T1, const AffineTransform& T2) noexcept
+	{
+		const XMVECTOR x1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&T1._11));
+		const XMVECTOR x2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&T1._21));
+		const XMVECTOR x3 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&T1._31));
+
+		const XMVECTOR y[3] = {
+			XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&T2._11)),
+			XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&T2._21)),
+			XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&T2._31))
+		};
+
+		// Row i of the result is T2[i].x * T1[0] + T2[i].y * T1[1] + T2[i].z * T1[2] + (0, 0, 0, T2[i].w),
+		// twelve multiply-adds against the sixteen of a Matrix product
+		AffineTransform R;
+		XMFLOAT4* rows = reinterpret_cast<XMFLOAT4*>(&R._11);
+		for (int i = 0; i < 3; ++i)
+		{
+			XMVECTOR r = XMVectorSet(0.f, 0.f, 0.f, XMVectorGetW(y[i]));
+			r = XMVectorMultiplyAdd(XMVectorSplatX(y[i]), x1, r);
+			r = XMVectorMultiplyAdd(XMVectorSplatY(y[i]), x2, r);
+			r = XMVectorMultiplyAdd(XMVectorSplatZ(y[i]), x3, r);
+			XMStoreFloat4(rows + i, r);
+		}
+		return R;
+	}
+
+
+	//****************************************************************************
+	//SQT
+
+	inline bool SQT::operator ==(const SQT& T) const noexcept
+	{
+		return scale == T.scale && rotation == T.rotation && translation == T.translation;
+	}
+
+	inline bool SQT::operator !=(const SQT& T) const noexcept
+	{
+		return !(*this == T);
+	}
+
+	inline SQT& SQT::operator*=(const SQT& T) noexcept
+	{
+		*this = *this * T;
+		return *this;
+	}
+
+	inline Matrix SQT::ToMatrix() const noexcept
+	{
+		const XMVECTOR s = XMLoadFloat3(&scale);
+		const XMVECTOR r = XMLoadFloat4(&rotation);
+		const XMVECTOR t = XMLoadFloat3(&translation);
+		return Matrix(XMMatrixAffineTransformation(s, XMVectorZero(), r, t));
+	}
+
+	inline AffineTransform SQT::ToAffineTransform() const noexcept
+	{
+		return AffineTransform(*this);
+	}
+
+	inline void SQT::Invert(SQT& result) const noexcept
+	{
+		const XMVECTOR s = XMVectorReciprocal(XMLoadFloat3(&scale));
+		const XMVECTOR r = XMQuaternionConjugate(XMLoadFloat4(&rotation));
+		const XMVECTOR t = XMLoadFloat3(&translation);
+
+		XMStoreFloat3(&result.scale, s);
+		XMStoreFloat4(&result.rotation, r);
+		XMStoreFloat3(&result.translation, XMVectorNegate(XMVectorMultiply(XMVector3Rotate(t, r), s)));
+	}
+
+	inline SQT SQT::Invert() const noexcept
+	{
+		SQT R;
+		Invert(R);
+		return R;
+	}
+
+	inline Vector3 SQT::TransformPoint(const Vector3& V) const noexcept
+	{
+		XMVECTOR v = XMVectorMultiply(XMLoadFloat3(&V), XMLoadFloat3(&scale));
+		v = XMVector3Rotate(v, XMLoadFloat4(&rotation));
+
+		Vector3 R;
+		XMStoreFloat3(&R, XMVectorAdd(v, XMLoadFloat3(&translation)));
+		return R;
+	}
+
+	inline Vector3 SQT::TransformNormal(const Vector3& V) const noexcept
+	{
+		const XMVECTOR v = XMVectorMultiply(XMLoadFloat3(&V), XMLoadFloat3(&scale));
+
+		Vector3 R;
+		XMStoreFloat3(&R, XMVector3Rotate(v, XMLoadFloat4(&rotation)));
+		return R;
+	}
+
+	inline SQT operator*(const SQT& T1, const SQT& T2) noexcept
+	{
+		const XMVECTOR s1 = XMLoadFloat3(&T1.scale);
+		const XMVECTOR s2 = XMLoadFloat3(&T2.scale);
+		const XMVECTOR r1 = XMLoadFloat4(&T1.rotation);
+		const XMVECTOR r2 = XMLoadFloat4(&T2.rotation);
+		const XMVECTOR t1 = XMLoadFloat3(&T1.translation);
+		const XMVECTOR t2 = XMLoadFloat3(&T2.translation);
+
+		SQT R;
+		XMStoreFloat3(&R.scale, XMVectorMultiply(s1, s2));
+		XMStoreFloat4(&R.rotation, XMQuaternionMultiply(r1, r2));
+		XMStoreFloat3(&R.translation, XMVectorAdd(XMVector3Rotate(XMVectorMultiply(t1, s2), r2), t2));
+		return R;
+	}
+
+
+	//****************************************************************************
+	// Plane
+
+	inline Plane::Plane(const Vector3& point1, const Vector3& point2, const Vector3& point3) noexcept : XMFLOAT4()
+	{
+		const XMVECTOR p1 = XMLoadFloat3(&point1);
+		const XMVECTOR p2 = XMLoadFloat3(&point2);
+		const XMVECTOR p3 = XMLoadFloat3(&point3);
+		XMStoreFloat4(this, XMPlaneFromPoints(p1, p2, p3));
+	}
+
+	constexpr bool Plane::operator ==(const Plane& P) const noexcept
+	{
+		if (std::is_constant_evaluated())
+			return x == P.x && y == P.y && z == P.z && w == P.w;
+
+		const XMVECTOR p1 = XMLoadFloat4(this);
+		const XMVECTOR p2 = XMLoadFloat4(&P);
+		return XMVector4Equal(p1, p2);
+	}
+
+	constexpr bool Plane::operator !=(const Plane& P) const noexcept
+	{
+		if (std::is_constant_evaluated())
+			return x != P.x || y != P.y || z != P.z || w != P.w;
+
+		const XMVECTOR p1 = XMLoadFloat4(this);
+		const XMVECTOR p2 = XMLoadFloat4(&P);
+		return XMVector4NotEqual(p1, p2);
+	}
+
+	template <Precision P>
+	inline void Plane::Normalize() noexcept
+	{
+		Normalize<P>(*this);
+	}
+
+	template <Precision P>
+	inline void Plane::Normalize(Plane& result) const noexcept
+	{
+		const XMVECTOR p1 = XMLoadFloat4(this);
+		if constexpr (P == Precision::Exact)
+			XMStoreFloat4(&result, XMPlaneNormalize(p1));
+		else
+			XMStoreFloat4(&result, Detail::Normalize<P>(p1, XMVector3LengthSq(p1)));
+	}
+
+	constexpr float Plane::Distance(const Vector3& point) const noexcept
+	{
+		if (std::is_constant_evaluated())
+			return x * point.x + y * point.y + z * point.z + w;
+
+		const XMVECTOR p1 = XMLoadFloat4(this);
+		const XMVECTOR v1 = XMLoadFloat3(&point);
+		return XMVectorGetX(XMPlaneDotCoord(p1, v1));
+	}
+
+	constexpr float Plane::DotNormal(const Vector3& V) const noexcept
+	{
+		if (std::is_constant_evaluated())
+			return x * V.x + y * V.y + z * V.z;
+
+		const XMVECTOR p1 = XMLoadFloat4(this);
+		const XMVECTOR v1 = XMLoadFloat3(&V);
+		return XMVectorGetX(XMPlaneDotNormal(p1, v1));
+	}
+
+	inline Plane Plane::Transform(const Matrix& M) const noexcept
+	{
+		const XMMATRIX inverseTranspose = XMMatrixTranspose(XMMatrixInverse(nullptr, XMLoadFloat4x4(&M)));
+		const XMVECTOR p1 = XMLoadFloat4(this);
+		Plane R;
+		XMStoreFloat4(&R, XMPlaneTransform(p1, inverseTranspose));
+		return R;
+	}
+
+	//****************************************************************************
+	// Ray
+
+	inline bool Ray::Intersects(const Plane& P, float& distance) const noexcept
+	{
+		// Solves dot(n, position + t * direction) + d = 0 for t >= 0
+		const float rate = P.DotNormal(direction);
+		if (rate == 0.f)
+			return false;
+
+		const float t = -P.Distance(position) / rate;
+		if (t < 0.f)
+			return false;
+
+		distance = t;
+		return true;
+	}
 }
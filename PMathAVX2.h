@@ -0,0 +1,145 @@
+#pragma once
+#include <cstddef>
+#include <immintrin.h>
+
+// Helpers shared by the AVX2 kernel translation units. Only include from files compiled with
+// AVX2/FMA enabled. Everything has internal linkage so no AVX2 code can leak into generic callers.
+
+namespace PMgene::Math::Detail::AVX2
+{
+	namespace
+	{
+		alignas(32) constexpr int TailMaskTable[16] = { -1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+		// Full 8-lane access
+		struct Lanes8
+		{
+			static __m256 Load(const float* p) noexcept { return _mm256_loadu_ps(p); }
+			static void Store(float* p, __m256 v) noexcept { _mm256_storeu_ps(p, v); }
+		};
+
+		// First 'count' lanes only, the others read as zero and are never written
+		struct TailLanes
+		{
+			__m256i mask;
+
+			explicit TailLanes(size_t count) noexcept
+				: mask(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(TailMaskTable + 8 - count)))
+			{
+			}
+
+			__m256 Load(const float* p) const noexcept { return _mm256_maskload_ps(p, mask); }
+			void Store(float* p, __m256 v) const noexcept { _mm256_maskstore_ps(p, mask, v); }
+		};
+
+		// Calls kernel(index, lanes) for every block of 8 elements, then once for the remainder
+		template <typename Kernel>
+		inline void ForEach8(size_t count, Kernel&& kernel) noexcept
+		{
+			size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+				kernel(i, Lanes8{});
+			if (i < count)
+				kernel(i, TailLanes(count - i));
+		}
+
+		// De-interleaves 8 consecutive XMFLOAT2 values into x and y registers
+		inline void LoadAoS8x2(const float* p, __m256& x, __m256& y) noexcept
+		{
+			// The shuffles leave elements 0, 1, 4, 5 | 2, 3, 6, 7; the permute puts the pairs in order
+			const __m256 m03 = _mm256_loadu_ps(p);
+			const __m256 m47 = _mm256_loadu_ps(p + 8);
+			x = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(m03, m47, _MM_SHUFFLE(2, 0, 2, 0))), _MM_SHUFFLE(3, 1, 2, 0)));
+			y = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(m03, m47, _MM_SHUFFLE(3, 1, 3, 1))), _MM_SHUFFLE(3, 1, 2, 0)));
+		}
+
+		// Interleaves x and y registers into 8 consecutive XMFLOAT2 values
+		inline void StoreAoS8x2(float* p, __m256 x, __m256 y) noexcept
+		{
+			const __m256 xs = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(x), _MM_SHUFFLE(3, 1, 2, 0)));
+			const __m256 ys = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(y), _MM_SHUFFLE(3, 1, 2, 0)));
+			_mm256_storeu_ps(p, _mm256_unpacklo_ps(xs, ys));
+			_mm256_storeu_ps(p + 8, _mm256_unpackhi_ps(xs, ys));
+		}
+
+		// De-interleaves 8 consecutive XMFLOAT3 values into x, y and z registers
+		inline void LoadAoS8(const float* p, __m256& x, __m256& y, __m256& z) noexcept
+		{
+			__m256 m03 = _mm256_castps128_ps256(_mm_loadu_ps(p));
+			__m256 m14 = _mm256_castps128_ps256(_mm_loadu_ps(p + 4));
+			__m256 m25 = _mm256_castps128_ps256(_mm_loadu_ps(p + 8));
+			m03 = _mm256_insertf128_ps(m03, _mm_loadu_ps(p + 12), 1);
+			m14 = _mm256_insertf128_ps(m14, _mm_loadu_ps(p + 16), 1);
+			m25 = _mm256_insertf128_ps(m25, _mm_loadu_ps(p + 20), 1);
+
+			const __m256 xy = _mm256_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));
+			const __m256 yz = _mm256_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));
+			x = _mm256_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0));
+			y = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+			z = _mm256_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1));
+		}
+
+		// Interleaves x, y and z registers into 8 consecutive XMFLOAT3 values.
+		// The non-temporal variant requires p to be 16-byte aligned.
+		template <bool NonTemporal = false>
+		inline void StoreAoS8(float* p, __m256 x, __m256 y, __m256 z) noexcept
+		{
+			const __m256 rxy = _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));
+			const __m256 ryz = _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1));
+			const __m256 rzx = _mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0));
+			const __m256 r03 = _mm256_shuffle_ps(rxy, rzx, _MM_SHUFFLE(2, 0, 2, 0));
+			const __m256 r14 = _mm256_shuffle_ps(ryz, rxy, _MM_SHUFFLE(3, 1, 2, 0));
+			const __m256 r25 = _mm256_shuffle_ps(rzx, ryz, _MM_SHUFFLE(3, 1, 3, 1));
+
+			const __m128 r[6] = {
+				_mm256_castps256_ps128(r03), _mm256_castps256_ps128(r14), _mm256_castps256_ps128(r25),
+				_mm256_extractf128_ps(r03, 1), _mm256_extractf128_ps(r14, 1), _mm256_extractf128_ps(r25, 1)
+			};
+			for (int k = 0; k < 6; ++k)
+			{
+				if constexpr (NonTemporal)
+					_mm_stream_ps(p + 4 * k, r[k]);
+				else
+					_mm_storeu_ps(p + 4 * k, r[k]);
+			}
+		}
+
+		// De-interleaves 8 consecutive XMFLOAT4 values into x, y, z and w registers
+		inline void LoadAoS8x4(const float* p, __m256& x, __m256& y, __m256& z, __m256& w) noexcept
+		{
+			// Row k holds elements k and k + 4, then both halves are transposed as 4x4 blocks
+			__m256 r[4];
+			for (int k = 0; k < 4; ++k)
+				r[k] = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 4 * k)), _mm_loadu_ps(p + 16 + 4 * k), 1);
+
+			const __m256 xy01 = _mm256_unpacklo_ps(r[0], r[1]);
+			const __m256 xy23 = _mm256_unpacklo_ps(r[2], r[3]);
+			const __m256 zw01 = _mm256_unpackhi_ps(r[0], r[1]);
+			const __m256 zw23 = _mm256_unpackhi_ps(r[2], r[3]);
+			x = _mm256_shuffle_ps(xy01, xy23, _MM_SHUFFLE(1, 0, 1, 0));
+			y = _mm256_shuffle_ps(xy01, xy23, _MM_SHUFFLE(3, 2, 3, 2));
+			z = _mm256_shuffle_ps(zw01, zw23, _MM_SHUFFLE(1, 0, 1, 0));
+			w = _mm256_shuffle_ps(zw01, zw23, _MM_SHUFFLE(3, 2, 3, 2));
+		}
+
+		// Interleaves x, y, z and w registers into 8 consecutive XMFLOAT4 values
+		inline void StoreAoS8x4(float* p, __m256 x, __m256 y, __m256 z, __m256 w) noexcept
+		{
+			const __m256 xy02 = _mm256_unpacklo_ps(x, y);
+			const __m256 xy13 = _mm256_unpackhi_ps(x, y);
+			const __m256 zw02 = _mm256_unpacklo_ps(z, w);
+			const __m256 zw13 = _mm256_unpackhi_ps(z, w);
+			const __m256 r[4] = {
+				_mm256_shuffle_ps(xy02, zw02, _MM_SHUFFLE(1, 0, 1, 0)),
+				_mm256_shuffle_ps(xy02, zw02, _MM_SHUFFLE(3, 2, 3, 2)),
+				_mm256_shuffle_ps(xy13, zw13, _MM_SHUFFLE(1, 0, 1, 0)),
+				_mm256_shuffle_ps(xy13, zw13, _MM_SHUFFLE(3, 2, 3, 2))
+			};
+			for (int k = 0; k < 4; ++k)
+			{
+				_mm_storeu_ps(p + 4 * k, _mm256_castps256_ps128(r[k]));
+				_mm_storeu_ps(p + 16 + 4 * k, _mm256_extractf128_ps(r[k], 1));
+			}
+		}
+	}
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <cstddef>
+#include <immintrin.h>
+
+// Helpers shared by the AVX-512 kernel translation units. Only include from files compiled with
+// AVX-512 enabled. Everything has internal linkage so no AVX-512 code can leak into generic callers.
+
+namespace PMgene::Math::Detail::AVX512
+{
+	namespace
+	{
+		// Full 16-lane access
+		struct Lanes16
+		{
+			static __m512 Load(const float* p) noexcept { return _mm512_loadu_ps(p); }
+			static void Store(float* p, __m512 v) noexcept { _mm512_storeu_ps(p, v); }
+		};
+
+		// First 'count' lanes only, the others read as zero and are never written
+		struct TailLanes
+		{
+			__mmask16 mask;
+
+			explicit TailLanes(size_t count) noexcept
+				: mask(static_cast<__mmask16>((1u << count) - 1))
+			{
+			}
+
+			__m512 Load(const float* p) const noexcept { return _mm512_maskz_loadu_ps(mask, p); }
+			void Store(float* p, __m512 v) const noexcept { _mm512_mask_storeu_ps(p, mask, v); }
+		};
+
+		// Calls kernel(index, lanes) for every block of 16 elements, then once for the remainder
+		template <typename Kernel>
+		inline void ForEach16(size_t count, Kernel&& kernel) noexcept
+		{
+			size_t i = 0;
+			for (; i + 16 <= count; i += 16)
+				kernel(i, Lanes16{});
+			if (i < count)
+				kernel(i, TailLanes(count - i));
+		}
+
+		// Permutation tables gathering component c of 16 XMFLOAT3 values spread over three registers.
+		// The first pass picks from registers 0 and 1, the second from its result and register 2.
+		struct AoSGatherTable
+		{
+			int first[16];
+			int second[16];
+		};
+
+		constexpr AoSGatherTable MakeAoSGatherTable(int c) noexcept
+		{
+			AoSGatherTable t{};
+			for (int k = 0; k < 16; ++k)
+			{
+				const int source = 3 * k + c;
+				t.first[k] = source < 32 ? source : 0;
+				t.second[k] = source < 32 ? k : 16 + (source - 32);
+			}
+			return t;
+		}
+
+		// Inverse tables scattering x, y and z back into register r of the interleaved layout
+		constexpr AoSGatherTable MakeAoSScatterTable(int r) noexcept
+		{
+			AoSGatherTable t{};
+			for (int p = 0; p < 16; ++p)
+			{
+				const int flat = 16 * r + p;
+				const int k = flat / 3;
+				const int c = flat % 3;
+				t.first[p] = c == 0 ? k : (c == 1 ? 16 + k : 0);
+				t.second[p] = c == 2 ? 16 + k : p;
+			}
+			return t;
+		}
+
+		alignas(64) constexpr AoSGatherTable GatherX = MakeAoSGatherTable(0);
+		alignas(64) constexpr AoSGatherTable GatherY = MakeAoSGatherTable(1);
+		alignas(64) constexpr AoSGatherTable GatherZ = MakeAoSGatherTable(2);
+		alignas(64) constexpr AoSGatherTable Scatter0 = MakeAoSScatterTable(0);
+		alignas(64) constexpr AoSGatherTable Scatter1 = MakeAoSScatterTable(1);
+		alignas(64) constexpr AoSGatherTable Scatter2 = MakeAoSScatterTable(2);
+
+		inline __m512 Permute2(const AoSGatherTable& t, __m512 a, __m512 b, __m512 c) noexcept
+		{
+			const __m512 ab = _mm512_permutex2var_ps(a, _mm512_load_si512(t.first), b);
+			return _mm512_permutex2var_ps(ab, _mm512_load_si512(t.second), c);
+		}
+
+		// De-interleaves 16 consecutive XMFLOAT3 values into x, y and z registers
+		inline void LoadAoS16(const float* p, __m512& x, __m512& y, __m512& z) noexcept
+		{
+			const __m512 m0 = _mm512_loadu_ps(p);
+			const __m512 m1 = _mm512_loadu_ps(p + 16);
+			const __m512 m2 = _mm512_loadu_ps(p + 32);
+			x = Permute2(GatherX, m0, m1, m2);
+			y = Permute2(GatherY, m0, m1, m2);
+			z = Permute2(GatherZ, m0, m1, m2);
+		}
+
+		// Interleaves x, y and z registers into 16 consecutive XMFLOAT3 values
+		inline void StoreAoS16(float* p, __m512 x, __m512 y, __m512 z) noexcept
+		{
+			_mm512_storeu_ps(p, Permute2(Scatter0, x, y, z));
+			_mm512_storeu_ps(p + 16, Permute2(Scatter1, x, y, z));
+			_mm512_storeu_ps(p + 32, Permute2(Scatter2, x, y, z));
+		}
+	}
+}
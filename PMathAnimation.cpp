@@ -0,0 +1,347 @@
+#include "PMathAnimation.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+#include "PMathCpu.h"
+#include "PMathKernels.h"
+
+namespace PMgene::Math
+{
+	namespace
+	{
+		// Forward steps a cursor walks before falling back to a binary search
+		constexpr uint32_t MaxCursorSteps = 4;
+
+		// Joints interpolated per pass, with their pairs of keys gathered on the stack
+		constexpr size_t SampleChunk = 64;
+
+		// Samplers per parallel task
+		constexpr size_t SampleGrain = 8;
+	}
+
+	//****************************************************************************
+	// AnimationClip
+
+	namespace
+	{
+		template <typename Channel, typename Value>
+		void BuildChannel(Channel& channel, std::span<const AnimationTrack> tracks, std::span<const float> AnimationTrack::*times,
+		                  std::span<const Value> AnimationTrack::*values, const Value& identity)
+		{
+			size_t keyCount = 0;
+			for (const AnimationTrack& track : tracks)
+			{
+				assert((track.*times).size() == (track.*values).size());
+				keyCount += std::max<size_t>((track.*values).size(), 1);
+			}
+
+			channel.first.resize(tracks.size() + 1);
+			channel.times.resize(keyCount);
+			channel.values.Resize(keyCount);
+
+			uint32_t key = 0;
+			for (size_t j = 0; j < tracks.size(); ++j)
+			{
+				channel.first[j] = key;
+
+				const std::span<const float> trackTimes = tracks[j].*times;
+				const std::span<const Value> trackValues = tracks[j].*values;
+				if (trackValues.empty())
+				{
+					channel.times[key] = 0.f;
+					channel.values.Set(key++, identity);
+					continue;
+				}
+
+				for (size_t k = 0; k < trackValues.size(); ++k)
+				{
+					assert(k == 0 || trackTimes[k] > trackTimes[k - 1]);
+					channel.times[key] = trackTimes[k];
+					channel.values.Set(key++, trackValues[k]);
+				}
+			}
+			channel.first[tracks.size()] = key;
+		}
+	}
+
+	void AnimationClip::Build(float duration, std::span<const AnimationTrack> tracks)
+	{
+		BuildChannel(m_translation, tracks, &AnimationTrack::translationTimes, &AnimationTrack::translations, Vector3(0.f));
+		BuildChannel(m_rotation, tracks, &AnimationTrack::rotationTimes, &AnimationTrack::rotations, Quaternion(0.f, 0.f, 0.f, 1.f));
+		BuildChannel(m_scale, tracks, &AnimationTrack::scaleTimes, &AnimationTrack::scales, Vector3(1.f));
+		m_duration = duration;
+		m_jointCount = tracks.size();
+	}
+
+	void AnimationClip::Clear() noexcept
+	{
+		*this = AnimationClip();
+	}
+
+
+	//****************************************************************************
+	// AnimationSampler
+
+	namespace
+	{
+		// The pairs of keys around the sampled time for a chunk of joints, gathered SoA from the clip so
+		// the batch lerp kernels run over them
+		template <size_t Components>
+		struct KeyPairs
+		{
+			alignas(32) float from[Components][SampleChunk];
+			alignas(32) float to[Components][SampleChunk];
+			alignas(32) float factor[SampleChunk];
+			alignas(32) float value[Components][SampleChunk];
+		};
+
+		std::array<const float*, 3> Data(const Vector3Stream& S) noexcept
+		{
+			return { S.x.data(), S.y.data(), S.z.data() };
+		}
+
+		std::array<const float*, 4> Data(const QuaternionStream& S) noexcept
+		{
+			return { S.x.data(), S.y.data(), S.z.data(), S.w.data() };
+		}
+
+		// Pairs each joint's key with the next one, or with itself at the end of its track
+		template <typename Channel, size_t Components>
+		void Gather(const Channel& channel, std::span<const uint32_t> keys, size_t begin, float time, KeyPairs<Components>& pairs) noexcept
+		{
+			const float* times = channel.times.data();
+			const auto values = Data(channel.values);
+			float start[SampleChunk], length[SampleChunk];
+			for (size_t i = 0; i < keys.size(); ++i)
+			{
+				const uint32_t key = keys[i];
+				const uint32_t next = std::min(key + 1, channel.first[begin + i + 1] - 1);
+				start[i] = times[key];
+				length[i] = times[next] - times[key];
+				for (size_t c = 0; c < Components; ++c)
+				{
+					pairs.from[c][i] = values[c][key];
+					pairs.to[c][i] = values[c][next];
+				}
+			}
+
+			// A key paired with itself has length 0 and factor 0
+			for (size_t i = 0; i < keys.size(); ++i)
+			{
+				const float factor = std::clamp((time - start[i]) / length[i], 0.f, 1.f);
+				pairs.factor[i] = length[i] > 0.f ? factor : 0.f;
+			}
+		}
+
+		void Lerp(KeyPairs<3>& pairs, size_t count) noexcept
+		{
+			const Detail::ConstStreamView3 from{ pairs.from[0], pairs.from[1], pairs.from[2] };
+			const Detail::ConstStreamView3 to{ pairs.to[0], pairs.to[1], pairs.to[2] };
+			const Detail::StreamView3 value{ pairs.value[0], pairs.value[1], pairs.value[2] };
+
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+			{
+				Detail::AVX2::Vector3Lerp(from, to, pairs.factor, 1, value, count);
+				return;
+			}
+#endif
+			Detail::Generic::Vector3Lerp(from, to, pairs.factor, 1, value, count);
+		}
+
+		// Normalized lerp along the shorter arc
+		void Lerp(KeyPairs<4>& pairs, size_t count) noexcept
+		{
+			const Detail::ConstStreamView4 from{ pairs.from[0], pairs.from[1], pairs.from[2], pairs.from[3] };
+			const Detail::ConstStreamView4 to{ pairs.to[0], pairs.to[1], pairs.to[2], pairs.to[3] };
+			const Detail::StreamView4 value{ pairs.value[0], pairs.value[1], pairs.value[2], pairs.value[3] };
+
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+			{
+				Detail::AVX2::QuaternionLerp(from, to, pairs.factor, 1, value, count);
+				return;
+			}
+#endif
+			Detail::Generic::QuaternionLerp(from, to, pairs.factor, 1, value, count);
+		}
+
+		void Store(const KeyPairs<3>& scale, const KeyPairs<4>& rotation, const KeyPairs<3>& translation, std::span<SQT> pose) noexcept
+		{
+			for (size_t i = 0; i < pose.size(); ++i)
+			{
+				pose[i].scale = Vector3(scale.value[0][i], scale.value[1][i], scale.value[2][i]);
+				pose[i].rotation = Quaternion(rotation.value[0][i], rotation.value[1][i], rotation.value[2][i], rotation.value[3][i]);
+				pose[i].translation = Vector3(translation.value[0][i], translation.value[1][i], translation.value[2][i]);
+			}
+		}
+
+		// The scaled rotation matrix of every joint with the translation in the last row, as
+		// XMMatrixAffineTransformation builds it without a rotation origin
+		void Store(const KeyPairs<3>& scale, const KeyPairs<4>& rotation, const KeyPairs<3>& translation, std::span<Matrix> pose) noexcept
+		{
+			for (size_t i = 0; i < pose.size(); ++i)
+			{
+				const float x = rotation.value[0][i], y = rotation.value[1][i], z = rotation.value[2][i], w = rotation.value[3][i];
+				const float xx = x * x, yy = y * y, zz = z * z;
+				const float xy = x * y, xz = x * z, yz = y * z;
+				const float wx = w * x, wy = w * y, wz = w * z;
+				const float sx = scale.value[0][i], sy = scale.value[1][i], sz = scale.value[2][i];
+
+				pose[i] = Matrix(
+					sx * (1.f - 2.f * (yy + zz)), sx * 2.f * (xy + wz), sx * 2.f * (xz - wy), 0.f,
+					sy * 2.f * (xy - wz), sy * (1.f - 2.f * (xx + zz)), sy * 2.f * (yz + wx), 0.f,
+					sz * 2.f * (xz + wy), sz * 2.f * (yz - wx), sz * (1.f - 2.f * (xx + yy)), 0.f,
+					translation.value[0][i], translation.value[1][i], translation.value[2][i], 1.f);
+			}
+		}
+
+		template <typename Pose>
+		void SampleBatch(std::span<AnimationSampler> samplers, std::span<const float> times, std::span<Pose> poses, Parallel::Range range) noexcept
+		{
+			for (size_t i = range.begin; i < range.end; ++i)
+			{
+				const size_t jointCount = samplers[i].JointCount();
+				samplers[i].Sample(times[i], poses.subspan(i * jointCount, jointCount));
+			}
+		}
+
+		template <typename Pose>
+		[[maybe_unused]] bool SameJointCount(std::span<const AnimationSampler> samplers, std::span<const float> times, std::span<Pose> poses) noexcept
+		{
+			const size_t jointCount = samplers.empty() ? 0 : samplers[0].JointCount();
+			for (const AnimationSampler& sampler : samplers)
+			{
+				if (sampler.JointCount() != jointCount)
+					return false;
+			}
+			return times.size() == samplers.size() && poses.size() == samplers.size() * jointCount;
+		}
+	}
+
+	AnimationSampler::AnimationSampler(const AnimationClip& clip)
+	{
+		Bind(clip);
+	}
+
+	void AnimationSampler::Bind(const AnimationClip& clip)
+	{
+		m_clip = &clip;
+		m_translation.resize(clip.JointCount());
+		m_rotation.resize(clip.JointCount());
+		m_scale.resize(clip.JointCount());
+		Rewind();
+	}
+
+	void AnimationSampler::Rewind() noexcept
+	{
+		if (!m_clip)
+			return;
+
+		std::copy_n(m_clip->m_translation.first.begin(), m_translation.size(), m_translation.begin());
+		std::copy_n(m_clip->m_rotation.first.begin(), m_rotation.size(), m_rotation.begin());
+		std::copy_n(m_clip->m_scale.first.begin(), m_scale.size(), m_scale.begin());
+	}
+
+	// Moves every cursor to the last key at or before 'time', or the first key of the track when
+	// 'time' precedes it
+	template <typename Stream>
+	void AnimationSampler::Advance(const AnimationClip::Channel<Stream>& channel, std::span<uint32_t> keys, float time) noexcept
+	{
+		const float* times = channel.times.data();
+		for (size_t j = 0; j < keys.size(); ++j)
+		{
+			const uint32_t first = channel.first[j];
+			const uint32_t last = channel.first[j + 1] - 1;
+			uint32_t key = keys[j];
+
+			if (time < times[key] && key > first)
+			{
+				key = static_cast<uint32_t>(std::upper_bound(times + first + 1, times + key, time) - times) - 1;
+			}
+			else
+			{
+				uint32_t steps = 0;
+				while (key < last && times[key + 1] <= time)
+				{
+					if (++steps > MaxCursorSteps)
+					{
+						key = static_cast<uint32_t>(std::upper_bound(times + key + 1, times + last + 1, time) - times) - 1;
+						break;
+					}
+					++key;
+				}
+			}
+			keys[j] = key;
+		}
+	}
+
+	template <typename Pose>
+	void AnimationSampler::Evaluate(float time, std::span<Pose> pose) noexcept
+	{
+		assert(m_clip && pose.size() == JointCount());
+
+		const AnimationClip& clip = *m_clip;
+		Advance(clip.m_translation, m_translation, time);
+		Advance(clip.m_rotation, m_rotation, time);
+		Advance(clip.m_scale, m_scale, time);
+
+		KeyPairs<3> translation;
+		KeyPairs<4> rotation;
+		KeyPairs<3> scale;
+		for (size_t begin = 0; begin < pose.size(); begin += SampleChunk)
+		{
+			const size_t count = std::min(SampleChunk, pose.size() - begin);
+			Gather(clip.m_translation, std::span<const uint32_t>(m_translation).subspan(begin, count), begin, time, translation);
+			Gather(clip.m_rotation, std::span<const uint32_t>(m_rotation).subspan(begin, count), begin, time, rotation);
+			Gather(clip.m_scale, std::span<const uint32_t>(m_scale).subspan(begin, count), begin, time, scale);
+
+			Lerp(translation, count);
+			Lerp(rotation, count);
+			Lerp(scale, count);
+			Store(scale, rotation, translation, pose.subspan(begin, count));
+		}
+	}
+
+	void AnimationSampler::Sample(float time, std::span<SQT> pose) noexcept
+	{
+		Evaluate(time, pose);
+	}
+
+	void AnimationSampler::Sample(float time, std::span<Matrix> pose) noexcept
+	{
+		Evaluate(time, pose);
+	}
+
+	void AnimationSampler::Sample(std::span<AnimationSampler> samplers, std::span<const float> times, std::span<SQT> poses) noexcept
+	{
+		assert(SameJointCount<SQT>(samplers, times, poses));
+		SampleBatch(samplers, times, poses, { 0, samplers.size() });
+	}
+
+	void AnimationSampler::Sample(std::span<AnimationSampler> samplers, std::span<const float> times, std::span<Matrix> poses) noexcept
+	{
+		assert(SameJointCount<Matrix>(samplers, times, poses));
+		SampleBatch(samplers, times, poses, { 0, samplers.size() });
+	}
+
+	void AnimationSampler::Sample(const Parallel::ParallelPolicy& policy, std::span<AnimationSampler> samplers, std::span<const float> times,
+	                              std::span<SQT> poses) noexcept
+	{
+		assert(SameJointCount<SQT>(samplers, times, poses));
+		Parallel::ParallelFor(samplers.size(), policy.grain ? policy.grain : SampleGrain, [&](Parallel::Range range) {
+			SampleBatch(samplers, times, poses, range);
+		});
+	}
+
+	void AnimationSampler::Sample(const Parallel::ParallelPolicy& policy, std::span<AnimationSampler> samplers, std::span<const float> times,
+	                              std::span<Matrix> poses) noexcept
+	{
+		assert(SameJointCount<Matrix>(samplers, times, poses));
+		Parallel::ParallelFor(samplers.size(), policy.grain ? policy.grain : SampleGrain, [&](Parallel::Range range) {
+			SampleBatch(samplers, times, poses, range);
+		});
+	}
+}
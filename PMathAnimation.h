@@ -0,0 +1,109 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "PMath.h"
+#include "PMathMemory.h"
+#include "PMathParallel.h"
+#include "PMathStream.h"
+
+namespace PMgene::Math
+{
+	//****************************************************************************
+	// AnimationClip
+	// Keyframed translation, rotation and scale tracks for every joint of a skeleton. Keys of all
+	// joints are stored back to back per channel, times and values SoA.
+
+	// Keys of one joint, times in seconds and strictly increasing. Every channel may have its own
+	// number of keys; an empty channel holds the identity (zero translation, no rotation, unit scale).
+	struct AnimationTrack
+	{
+		std::span<const float> translationTimes;
+		std::span<const Vector3> translations;
+		std::span<const float> rotationTimes;
+		std::span<const Quaternion> rotations;
+		std::span<const float> scaleTimes;
+		std::span<const Vector3> scales;
+	};
+
+	class AnimationClip
+	{
+	public:
+		AnimationClip() = default;
+
+		// Copies the keys of one track per joint
+		void Build(float duration, std::span<const AnimationTrack> tracks);
+		void Clear() noexcept;
+
+		[[nodiscard]] float Duration() const noexcept { return m_duration; }
+		[[nodiscard]] size_t JointCount() const noexcept { return m_jointCount; }
+		[[nodiscard]] bool Empty() const noexcept { return m_jointCount == 0; }
+
+	private:
+		friend class AnimationSampler;
+
+		// Keys of joint j are [first[j], first[j + 1]); every joint has at least one
+		template <typename Stream>
+		struct Channel
+		{
+			std::vector<uint32_t> first;
+			AlignedVector<float> times;
+			Stream values;
+		};
+
+		Channel<Vector3Stream> m_translation;
+		Channel<QuaternionStream> m_rotation;
+		Channel<Vector3Stream> m_scale;
+		float m_duration = 0.f;
+		size_t m_jointCount = 0;
+	};
+
+
+	//****************************************************************************
+	// AnimationSampler
+	// Playback state of one clip instance. A cursor per track remembers the last key at or before
+	// the previous sample, so playing forward costs O(1) per track amortised instead of a search;
+	// jumping back searches again. Cursors are only key indices: every sample gathers the pairs of
+	// keys it needs from the clip, so the instances of a clip share one copy of the key data.
+
+	class AnimationSampler
+	{
+	public:
+		AnimationSampler() = default;
+		explicit AnimationSampler(const AnimationClip& clip);
+
+		// Binds a clip and rewinds to its start. The clip must outlive the sampler and must not be
+		// rebuilt while bound.
+		void Bind(const AnimationClip& clip);
+		void Rewind() noexcept;
+
+		[[nodiscard]] const AnimationClip* Clip() const noexcept { return m_clip; }
+		[[nodiscard]] size_t JointCount() const noexcept { return m_clip ? m_clip->JointCount() : 0; }
+
+		// Local pose of every joint at 'time', clamped to the keys. Translation and scale are
+		// interpolated linearly, rotation with a normalized lerp along the shorter arc.
+		// pose.size() must be JointCount().
+		void Sample(float time, std::span<SQT> pose) noexcept;
+		void Sample(float time, std::span<Matrix> pose) noexcept;
+
+		// Samples many instances, sampler i at times[i] into poses[i * n, (i + 1) * n), where n is the
+		// joint count every bound clip must share
+		static void Sample(std::span<AnimationSampler> samplers, std::span<const float> times, std::span<SQT> poses) noexcept;
+		static void Sample(std::span<AnimationSampler> samplers, std::span<const float> times, std::span<Matrix> poses) noexcept;
+		static void Sample(const Parallel::ParallelPolicy& policy, std::span<AnimationSampler> samplers, std::span<const float> times, std::span<SQT> poses) noexcept;
+		static void Sample(const Parallel::ParallelPolicy& policy, std::span<AnimationSampler> samplers, std::span<const float> times, std::span<Matrix> poses) noexcept;
+
+	private:
+		template <typename Stream>
+		static void Advance(const AnimationClip::Channel<Stream>& channel, std::span<uint32_t> keys, float time) noexcept;
+		template <typename Pose>
+		void Evaluate(float time, std::span<Pose> pose) noexcept;
+
+		// Per joint, the key each track's cursor is on
+		const AnimationClip* m_clip = nullptr;
+		std::vector<uint32_t> m_translation;
+		std::vector<uint32_t> m_rotation;
+		std::vector<uint32_t> m_scale;
+	};
+}
@@ -0,0 +1,745 @@
+#include "PMathBVH.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+#include "PMath.inl"
+#include "PMathBVHTraversal.h"
+#include "PMathCpu.h"
+#include "PMathKernels.h"
+
+namespace PMgene::Math
+{
+	namespace
+	{
+		static_assert(sizeof(Ray) == 6 * sizeof(float), "Ray must be tightly packed for batch kernels");
+		static_assert(sizeof(RayHit) == sizeof(Detail::BVHHit) && offsetof(RayHit, primitive) == offsetof(Detail::BVHHit, primitive) &&
+		              offsetof(RayHit, u) == offsetof(Detail::BVHHit, u), "RayHit must match the kernel hit layout");
+
+		constexpr size_t BinCount = 32;
+
+		// Deeper nodes split at the object median, which bounds the tree depth and so the
+		// traversal stack: at most 32 more levels, for up to 2^32 primitives
+		constexpr size_t MaxSAHDepth = 32;
+
+		// Ranges at least ParallelBinSize large are binned in chunks of BinGrain, nodes at least
+		// ParallelSubtreeSize large build their children as separate tasks
+		constexpr size_t ParallelBinSize = 65536;
+		constexpr size_t BinGrain = 16384;
+		constexpr size_t ParallelSubtreeSize = 4096;
+
+		// Queries per parallel chunk, a multiple of the packet width
+		constexpr size_t RayGrain = 256;
+		constexpr size_t OverlapGrain = 64;
+
+		struct Box
+		{
+			float min[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+			float max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+			void Merge(const Box& B) noexcept
+			{
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					min[axis] = std::min(min[axis], B.min[axis]);
+					max[axis] = std::max(max[axis], B.max[axis]);
+				}
+			}
+
+			void Merge(const float* point) noexcept
+			{
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					min[axis] = std::min(min[axis], point[axis]);
+					max[axis] = std::max(max[axis], point[axis]);
+				}
+			}
+
+			// Half the surface area, all the SAH needs
+			[[nodiscard]] float HalfArea() const noexcept
+			{
+				const float dx = max[0] - min[0], dy = max[1] - min[1], dz = max[2] - min[2];
+				return dx * dy + dy * dz + dz * dx;
+			}
+		};
+
+		struct Bins
+		{
+			Box box[3][BinCount];
+			uint32_t count[3][BinCount] = {};
+
+			void Merge(const Bins& B) noexcept
+			{
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					for (size_t i = 0; i < BinCount; ++i)
+					{
+						box[axis][i].Merge(B.box[axis][i]);
+						count[axis][i] += B.count[axis][i];
+					}
+				}
+			}
+		};
+
+		// Binned SAH builder producing 8-wide nodes. Every node starts with its whole range as one
+		// child and splits the child with the largest area until it has 8 of them. The primitive
+		// boxes are partitioned in place, so every pass over a range reads memory sequentially.
+		class Builder
+		{
+		public:
+			Builder(std::span<const AABB> bounds, bool parallel)
+				: m_parallel(parallel)
+			{
+				m_refs.resize(bounds.size());
+				for (size_t i = 0; i < bounds.size(); ++i)
+				{
+					const AABB& B = bounds[i];
+					m_refs[i] = { { { B.min.x, B.min.y, B.min.z }, { B.max.x, B.max.y, B.max.z } }, static_cast<uint32_t>(i) };
+				}
+			}
+
+			// Builds the nodes and returns the primitive indices in leaf order
+			void Build(std::vector<Detail::BVHNode>& nodes, std::vector<uint32_t>& order, Box& rootBounds)
+			{
+				rootBounds = RangeBounds(0, m_refs.size());
+				nodes.clear();
+				nodes.emplace_back();
+				BuildNode(nodes, 0, { 0, m_refs.size(), rootBounds }, 0);
+
+				order.resize(m_refs.size());
+				for (size_t i = 0; i < m_refs.size(); ++i)
+					order[i] = m_refs[i].index;
+			}
+
+		private:
+			struct Child
+			{
+				size_t begin;
+				size_t end;
+				Box bounds;
+
+				[[nodiscard]] size_t Size() const noexcept { return end - begin; }
+			};
+
+			struct PrimitiveRef
+			{
+				Box box;
+				uint32_t index;
+
+				[[nodiscard]] float Centroid(int axis) const noexcept { return (box.min[axis] + box.max[axis]) * 0.5f; }
+			};
+
+			// Runs kernel(begin, end, T&) over the range, in parallel chunks when it is large
+			template <typename T, typename Kernel>
+			T Reduce(size_t begin, size_t end, const Kernel& kernel) const
+			{
+				T result{};
+				if (!m_parallel || end - begin < ParallelBinSize)
+				{
+					kernel(begin, end, result);
+					return result;
+				}
+
+				std::vector<T> partial((end - begin + BinGrain - 1) / BinGrain);
+				Parallel::ParallelFor(end - begin, BinGrain, [&](Parallel::Range range) {
+					for (size_t c = range.begin; c < range.end; c += BinGrain)
+						kernel(begin + c, begin + std::min(c + BinGrain, range.end), partial[c / BinGrain]);
+				});
+				for (const T& p : partial)
+					result.Merge(p);
+				return result;
+			}
+
+			[[nodiscard]] Box RangeBounds(size_t begin, size_t end) const
+			{
+				return Reduce<Box>(begin, end, [this](size_t b, size_t e, Box& result) {
+					for (size_t i = b; i < e; ++i)
+						result.Merge(m_refs[i].box);
+				});
+			}
+
+			[[nodiscard]] Box CentroidBounds(size_t begin, size_t end) const
+			{
+				return Reduce<Box>(begin, end, [this](size_t b, size_t e, Box& result) {
+					for (size_t i = b; i < e; ++i)
+					{
+						const float centroid[3] = { m_refs[i].Centroid(0), m_refs[i].Centroid(1), m_refs[i].Centroid(2) };
+						result.Merge(centroid);
+					}
+				});
+			}
+
+			// Splits the child in place into two non-empty halves
+			std::pair<Child, Child> Split(const Child& child, size_t depth)
+			{
+				const Box centroids = CentroidBounds(child.begin, child.end);
+
+				float scale[3];
+				int longest = 0;
+				bool binnable = false;
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					const float extent = centroids.max[axis] - centroids.min[axis];
+					scale[axis] = extent > 0.f ? BinCount / extent : 0.f;
+					if (!std::isfinite(scale[axis]))
+						scale[axis] = 0.f;
+					binnable |= scale[axis] > 0.f;
+					if (extent > centroids.max[longest] - centroids.min[longest])
+						longest = axis;
+				}
+
+				const auto bin = [&](const PrimitiveRef& ref, int axis) {
+					const float offset = (ref.Centroid(axis) - centroids.min[axis]) * scale[axis];
+					return std::min(static_cast<size_t>(offset), BinCount - 1);
+				};
+
+				if (binnable && depth < MaxSAHDepth)
+				{
+					const Bins bins = Reduce<Bins>(child.begin, child.end, [&](size_t b, size_t e, Bins& result) {
+						for (size_t i = b; i < e; ++i)
+						{
+							const PrimitiveRef& ref = m_refs[i];
+							for (int axis = 0; axis < 3; ++axis)
+							{
+								const size_t k = bin(ref, axis);
+								result.box[axis][k].Merge(ref.box);
+								++result.count[axis][k];
+							}
+						}
+					});
+
+					// Sweep from the right for the suffix areas, then from the left for the costs
+					float bestCost = FLT_MAX;
+					int bestAxis = -1;
+					size_t bestBin = 0;
+					for (int axis = 0; axis < 3; ++axis)
+					{
+						if (scale[axis] == 0.f)
+							continue;
+
+						float rightArea[BinCount];
+						size_t rightCount[BinCount];
+						Box right;
+						size_t count = 0;
+						for (size_t i = BinCount - 1; i > 0; --i)
+						{
+							right.Merge(bins.box[axis][i]);
+							count += bins.count[axis][i];
+							rightArea[i] = right.HalfArea();
+							rightCount[i] = count;
+						}
+
+						Box left;
+						count = 0;
+						for (size_t i = 0; i + 1 < BinCount; ++i)
+						{
+							left.Merge(bins.box[axis][i]);
+							count += bins.count[axis][i];
+							if (count == 0 || rightCount[i + 1] == 0)
+								continue;
+
+							const float cost = count * left.HalfArea() + rightCount[i + 1] * rightArea[i + 1];
+							if (cost < bestCost)
+							{
+								bestCost = cost;
+								bestAxis = axis;
+								bestBin = i;
+							}
+						}
+					}
+
+					if (bestAxis >= 0)
+					{
+						const auto middle = std::partition(m_refs.begin() + child.begin, m_refs.begin() + child.end,
+						                                   [&](const PrimitiveRef& ref) { return bin(ref, bestAxis) <= bestBin; });
+						const size_t mid = static_cast<size_t>(middle - m_refs.begin());
+
+						Box left, right;
+						for (size_t i = 0; i < BinCount; ++i)
+							(i <= bestBin ? left : right).Merge(bins.box[bestAxis][i]);
+						return { { child.begin, mid, left }, { mid, child.end, right } };
+					}
+				}
+
+				// Object median on the longest axis, or any half when all centroids coincide
+				const size_t mid = child.begin + child.Size() / 2;
+				if (binnable)
+				{
+					std::nth_element(m_refs.begin() + child.begin, m_refs.begin() + mid, m_refs.begin() + child.end,
+					                 [&](const PrimitiveRef& a, const PrimitiveRef& b) { return a.Centroid(longest) < b.Centroid(longest); });
+				}
+				return { { child.begin, mid, RangeBounds(child.begin, mid) }, { mid, child.end, RangeBounds(mid, child.end) } };
+			}
+
+			void BuildNode(std::vector<Detail::BVHNode>& nodes, size_t index, const Child& range, size_t depth)
+			{
+				Child children[8] = { range };
+				size_t childCount = 1;
+				while (childCount < 8)
+				{
+					// Largest area first; past the SAH depth, largest count first to keep halving
+					int best = -1;
+					float bestKey = -1.f;
+					for (size_t i = 0; i < childCount; ++i)
+					{
+						if (children[i].Size() <= BVH::MaxLeafSize)
+							continue;
+						const float key = depth < MaxSAHDepth ? children[i].bounds.HalfArea() : static_cast<float>(children[i].Size());
+						if (key > bestKey)
+						{
+							bestKey = key;
+							best = static_cast<int>(i);
+						}
+					}
+					if (best < 0)
+						break;
+
+					auto [left, right] = Split(children[best], depth);
+					children[best] = left;
+					children[childCount++] = right;
+				}
+
+				Detail::BVHNode node;
+				size_t inner[8];
+				size_t innerCount = 0;
+				for (size_t i = 0; i < 8; ++i)
+				{
+					const bool used = i < childCount;
+					for (int axis = 0; axis < 3; ++axis)
+					{
+						node.bounds[axis][i] = used ? children[i].bounds.min[axis] : INFINITY;
+						node.bounds[axis + 3][i] = used ? children[i].bounds.max[axis] : -INFINITY;
+					}
+					node.child[i] = Detail::BVHEmptyChild;
+					node.count[i] = 0;
+
+					if (!used)
+						continue;
+					if (children[i].Size() <= BVH::MaxLeafSize)
+					{
+						node.child[i] = Detail::BVHLeafFlag | static_cast<uint32_t>(children[i].begin);
+						node.count[i] = static_cast<uint8_t>(children[i].Size());
+					}
+					else
+					{
+						inner[innerCount++] = i;
+					}
+				}
+				nodes[index] = node;
+
+				if (!m_parallel || range.Size() < ParallelSubtreeSize || innerCount < 2)
+				{
+					for (size_t k = 0; k < innerCount; ++k)
+					{
+						const size_t child = nodes.size();
+						nodes.emplace_back();
+						nodes[index].child[inner[k]] = static_cast<uint32_t>(child);
+						BuildNode(nodes, child, children[inner[k]], depth + 1);
+					}
+					return;
+				}
+
+				// Every subtree builds into its own array, then they are appended with their
+				// node indices shifted
+				std::vector<Detail::BVHNode> subtrees[8];
+				Parallel::ParallelFor(innerCount, 1, [&](Parallel::Range tasks) {
+					for (size_t k = tasks.begin; k < tasks.end; ++k)
+					{
+						subtrees[k].emplace_back();
+						BuildNode(subtrees[k], 0, children[inner[k]], depth + 1);
+					}
+				});
+
+				for (size_t k = 0; k < innerCount; ++k)
+				{
+					const uint32_t offset = static_cast<uint32_t>(nodes.size());
+					for (Detail::BVHNode& subtree : subtrees[k])
+					{
+						for (size_t i = 0; i < 8; ++i)
+						{
+							if (subtree.count[i] == 0 && subtree.child[i] != Detail::BVHEmptyChild)
+								subtree.child[i] += offset;
+						}
+					}
+					nodes.insert(nodes.end(), subtrees[k].begin(), subtrees[k].end());
+					nodes[index].child[inner[k]] = offset;
+				}
+			}
+
+			std::vector<PrimitiveRef> m_refs;
+			bool m_parallel;
+		};
+	}
+
+	//****************************************************************************
+	// Portable traversal kernels
+
+	namespace Detail::Generic
+	{
+		namespace
+		{
+			struct NodeTest
+			{
+				static uint32_t TestRay(const BVHNode& node, const BVHRay& ray, float maxDistance, float* tNear) noexcept
+				{
+					uint32_t mask = 0;
+					for (int i = 0; i < 8; ++i)
+					{
+						float t0 = 0.f;
+						float t1 = maxDistance;
+						for (int axis = 0; axis < 3; ++axis)
+						{
+							t0 = std::max(t0, node.bounds[ray.nearRow[axis]][i] * ray.inverse[axis] - ray.scaledOrigin[axis]);
+							t1 = std::min(t1, node.bounds[ray.FarRow(axis)][i] * ray.inverse[axis] - ray.scaledOrigin[axis]);
+						}
+						tNear[i] = t0;
+						mask |= uint32_t(t0 <= t1) << i;
+					}
+					return mask;
+				}
+
+				static uint32_t TestBox(const BVHNode& node, const float* box) noexcept
+				{
+					uint32_t mask = 0;
+					for (int i = 0; i < 8; ++i)
+					{
+						const bool overlaps = node.bounds[0][i] <= box[3] && node.bounds[3][i] >= box[0] &&
+						                      node.bounds[1][i] <= box[4] && node.bounds[4][i] >= box[1] &&
+						                      node.bounds[2][i] <= box[5] && node.bounds[5][i] >= box[2];
+						mask |= uint32_t(overlaps) << i;
+					}
+					return mask;
+				}
+			};
+		}
+
+		void BVHRaycast(const BVHView& bvh, const float* rays, float maxDistance, BVHHit* hits, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+				hits[i] = RaycastTraverse<NodeTest>(bvh, rays + 6 * i, maxDistance);
+		}
+
+		// Packets only pay off with SIMD, rays are traced one at a time here
+		void BVHRaycastPacket(const BVHView& bvh, const float* rays, float maxDistance, BVHHit* hits, size_t count) noexcept
+		{
+			BVHRaycast(bvh, rays, maxDistance, hits, count);
+		}
+
+		void BVHOccluded(const BVHView& bvh, const float* rays, float maxDistance, uint8_t* occluded, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+				occluded[i] = OccludedTraverse<NodeTest>(bvh, rays + 6 * i, maxDistance);
+		}
+
+		size_t BVHOverlap(const BVHView& bvh, const float* box, uint32_t* primitives, size_t capacity) noexcept
+		{
+			return OverlapTraverse<NodeTest>(bvh, box, primitives, capacity);
+		}
+	}
+
+	//****************************************************************************
+	// Construction
+
+	void BVH::BuildTree(bool parallel, std::span<const AABB> bounds)
+	{
+		assert(bounds.size() < Detail::BVHLeafFlag && "primitive indices must fit in 31 bits");
+
+		m_nodes.clear();
+		m_boxes.clear();
+		m_triangles.clear();
+		m_primitives.clear();
+		m_bounds = AABB();
+		if (bounds.empty())
+			return;
+
+		Box root;
+		Builder(bounds, parallel).Build(m_nodes, m_primitives, root);
+		m_bounds = AABB(Vector3(root.min[0], root.min[1], root.min[2]), Vector3(root.max[0], root.max[1], root.max[2]));
+
+		m_boxes.resize(m_primitives.size());
+		for (size_t i = 0; i < m_primitives.size(); ++i)
+			m_boxes[i] = bounds[m_primitives[i]];
+	}
+
+	void BVH::Build(std::span<const AABB> bounds)
+	{
+		BuildTree(false, bounds);
+	}
+
+	void BVH::Build(const Parallel::ParallelPolicy&, std::span<const AABB> bounds)
+	{
+		BuildTree(true, bounds);
+	}
+
+	namespace
+	{
+		std::vector<AABB> TriangleBounds(std::span<const Vector3> vertices, std::span<const uint32_t> indices)
+		{
+			assert(indices.size() % 3 == 0);
+
+			std::vector<AABB> bounds(indices.size() / 3);
+			for (size_t t = 0; t < bounds.size(); ++t)
+			{
+				const Vector3& a = vertices[indices[3 * t]];
+				const Vector3& b = vertices[indices[3 * t + 1]];
+				const Vector3& c = vertices[indices[3 * t + 2]];
+				bounds[t] = AABB(Vector3(std::min({ a.x, b.x, c.x }), std::min({ a.y, b.y, c.y }), std::min({ a.z, b.z, c.z })),
+				                 Vector3(std::max({ a.x, b.x, c.x }), std::max({ a.y, b.y, c.y }), std::max({ a.z, b.z, c.z })));
+			}
+			return bounds;
+		}
+
+		// Vertex 0 and the two edges from it, in leaf order
+		void FillTriangles(std::span<const Vector3> vertices, std::span<const uint32_t> indices, std::span<const uint32_t> order, std::vector<float>& triangles)
+		{
+			triangles.resize(order.size() * 9);
+			for (size_t i = 0; i < order.size(); ++i)
+			{
+				const size_t t = order[i];
+				const Vector3& a = vertices[indices[3 * t]];
+				const Vector3 e1 = vertices[indices[3 * t + 1]] - a;
+				const Vector3 e2 = vertices[indices[3 * t + 2]] - a;
+				float* out = triangles.data() + 9 * i;
+				out[0] = a.x, out[1] = a.y, out[2] = a.z;
+				out[3] = e1.x, out[4] = e1.y, out[5] = e1.z;
+				out[6] = e2.x, out[7] = e2.y, out[8] = e2.z;
+			}
+		}
+	}
+
+	void BVH::Build(std::span<const Vector3> vertices, std::span<const uint32_t> indices)
+	{
+		BuildTree(false, TriangleBounds(vertices, indices));
+		FillTriangles(vertices, indices, m_primitives, m_triangles);
+	}
+
+	void BVH::Build(const Parallel::ParallelPolicy&, std::span<const Vector3> vertices, std::span<const uint32_t> indices)
+	{
+		BuildTree(true, TriangleBounds(vertices, indices));
+		FillTriangles(vertices, indices, m_primitives, m_triangles);
+	}
+
+	void BVH::Clear() noexcept
+	{
+		m_nodes.clear();
+		m_boxes.clear();
+		m_triangles.clear();
+		m_primitives.clear();
+		m_bounds = AABB();
+	}
+
+	Detail::BVHView BVH::View() const noexcept
+	{
+		return { m_nodes.data(), reinterpret_cast<const float*>(m_boxes.data()), m_triangles.empty() ? nullptr : m_triangles.data(), m_primitives.data() };
+	}
+
+	//****************************************************************************
+	// Queries
+
+	namespace
+	{
+		const float* Data(std::span<const Ray> rays) noexcept
+		{
+			return reinterpret_cast<const float*>(rays.data());
+		}
+
+		Detail::BVHHit* Data(std::span<RayHit> hits) noexcept
+		{
+			return reinterpret_cast<Detail::BVHHit*>(hits.data());
+		}
+
+		void RaycastKernel(const Detail::BVHView& bvh, const float* rays, float maxDistance, Detail::BVHHit* hits, size_t count) noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+			{
+				Detail::AVX2::BVHRaycast(bvh, rays, maxDistance, hits, count);
+				return;
+			}
+#endif
+			Detail::Generic::BVHRaycast(bvh, rays, maxDistance, hits, count);
+		}
+
+		void RaycastPacketKernel(const Detail::BVHView& bvh, const float* rays, float maxDistance, Detail::BVHHit* hits, size_t count) noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+			{
+				Detail::AVX2::BVHRaycastPacket(bvh, rays, maxDistance, hits, count);
+				return;
+			}
+#endif
+			Detail::Generic::BVHRaycastPacket(bvh, rays, maxDistance, hits, count);
+		}
+
+		void OccludedKernel(const Detail::BVHView& bvh, const float* rays, float maxDistance, uint8_t* occluded, size_t count) noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+			{
+				Detail::AVX2::BVHOccluded(bvh, rays, maxDistance, occluded, count);
+				return;
+			}
+#endif
+			Detail::Generic::BVHOccluded(bvh, rays, maxDistance, occluded, count);
+		}
+
+		size_t OverlapKernel(const Detail::BVHView& bvh, const AABB& box, uint32_t* primitives, size_t capacity) noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+				return Detail::AVX2::BVHOverlap(bvh, &box.min.x, primitives, capacity);
+#endif
+			return Detail::Generic::BVHOverlap(bvh, &box.min.x, primitives, capacity);
+		}
+
+		size_t Grain(const Parallel::ParallelPolicy& policy, size_t grain) noexcept
+		{
+			return policy.grain != 0 ? policy.grain : grain;
+		}
+	}
+
+	RayHit BVH::Raycast(const Ray& ray, float maxDistance) const noexcept
+	{
+		RayHit hit;
+		if (!Empty())
+			RaycastKernel(View(), &ray.position.x, maxDistance, reinterpret_cast<Detail::BVHHit*>(&hit), 1);
+		return hit;
+	}
+
+	bool BVH::Occluded(const Ray& ray, float maxDistance) const noexcept
+	{
+		uint8_t occluded = 0;
+		if (!Empty())
+			OccludedKernel(View(), &ray.position.x, maxDistance, &occluded, 1);
+		return occluded != 0;
+	}
+
+	void BVH::Raycast(std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance) const noexcept
+	{
+		assert(rays.size() == hits.size());
+		if (Empty())
+			std::fill(hits.begin(), hits.end(), RayHit());
+		else
+			RaycastKernel(View(), Data(rays), maxDistance, Data(hits), rays.size());
+	}
+
+	void BVH::RaycastPackets(std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance) const noexcept
+	{
+		assert(rays.size() == hits.size());
+		if (Empty())
+			std::fill(hits.begin(), hits.end(), RayHit());
+		else
+			RaycastPacketKernel(View(), Data(rays), maxDistance, Data(hits), rays.size());
+	}
+
+	void BVH::Occluded(std::span<const Ray> rays, std::span<uint8_t> occluded, float maxDistance) const noexcept
+	{
+		assert(rays.size() == occluded.size());
+		if (Empty())
+			std::fill(occluded.begin(), occluded.end(), uint8_t(0));
+		else
+			OccludedKernel(View(), Data(rays), maxDistance, occluded.data(), rays.size());
+	}
+
+	void BVH::Raycast(const Parallel::ParallelPolicy& policy, std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance) const noexcept
+	{
+		assert(rays.size() == hits.size());
+		if (Empty())
+			return Raycast(rays, hits, maxDistance);
+
+		const Detail::BVHView bvh = View();
+		const float* R = Data(rays);
+		Detail::BVHHit* H = Data(hits);
+		Parallel::ParallelFor(rays.size(), Grain(policy, RayGrain), [&](Parallel::Range range) {
+			RaycastKernel(bvh, R + range.begin * 6, maxDistance, H + range.begin, range.Size());
+		});
+	}
+
+	void BVH::RaycastPackets(const Parallel::ParallelPolicy& policy, std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance) const noexcept
+	{
+		assert(rays.size() == hits.size());
+		if (Empty())
+			return RaycastPackets(rays, hits, maxDistance);
+
+		const Detail::BVHView bvh = View();
+		const float* R = Data(rays);
+		Detail::BVHHit* H = Data(hits);
+		Parallel::ParallelFor(rays.size(), Grain(policy, RayGrain), [&](Parallel::Range range) {
+			RaycastPacketKernel(bvh, R + range.begin * 6, maxDistance, H + range.begin, range.Size());
+		});
+	}
+
+	void BVH::Occluded(const Parallel::ParallelPolicy& policy, std::span<const Ray> rays, std::span<uint8_t> occluded, float maxDistance) const noexcept
+	{
+		assert(rays.size() == occluded.size());
+		if (Empty())
+			return Occluded(rays, occluded, maxDistance);
+
+		const Detail::BVHView bvh = View();
+		const float* R = Data(rays);
+		uint8_t* O = occluded.data();
+		Parallel::ParallelFor(rays.size(), Grain(policy, RayGrain), [&](Parallel::Range range) {
+			OccludedKernel(bvh, R + range.begin * 6, maxDistance, O + range.begin, range.Size());
+		});
+	}
+
+	size_t BVH::Overlap(const AABB& box, std::vector<uint32_t>& result) const
+	{
+		if (Empty())
+			return 0;
+
+		// Try with room for a typical query first and traverse again only if it was too small
+		constexpr size_t Guess = 64;
+		const size_t start = result.size();
+		result.resize(start + Guess);
+		const size_t found = OverlapKernel(View(), box, result.data() + start, result.size() - start);
+		if (found > result.size() - start)
+		{
+			result.resize(start + found);
+			OverlapKernel(View(), box, result.data() + start, found);
+		}
+		result.resize(start + found);
+		return found;
+	}
+
+	void BVH::Overlap(std::span<const AABB> boxes, std::vector<uint32_t>& offsets, std::vector<uint32_t>& primitives) const
+	{
+		offsets.resize(boxes.size() + 1);
+		offsets[0] = 0;
+		primitives.clear();
+		for (size_t i = 0; i < boxes.size(); ++i)
+		{
+			Overlap(boxes[i], primitives);
+			offsets[i + 1] = static_cast<uint32_t>(primitives.size());
+		}
+	}
+
+	void BVH::Overlap(const Parallel::ParallelPolicy& policy, std::span<const AABB> boxes, std::vector<uint32_t>& offsets, std::vector<uint32_t>& primitives) const
+	{
+		offsets.assign(boxes.size() + 1, 0);
+		primitives.clear();
+		if (Empty())
+			return;
+
+		// Count, turn the counts into offsets, then traverse again to fill every query's range
+		const Detail::BVHView bvh = View();
+		const size_t grain = Grain(policy, OverlapGrain);
+		Parallel::ParallelFor(boxes.size(), grain, [&](Parallel::Range range) {
+			for (size_t i = range.begin; i < range.end; ++i)
+				offsets[i + 1] = static_cast<uint32_t>(OverlapKernel(bvh, boxes[i], nullptr, 0));
+		});
+
+		for (size_t i = 0; i < boxes.size(); ++i)
+			offsets[i + 1] += offsets[i];
+		primitives.resize(offsets.back());
+
+		Parallel::ParallelFor(boxes.size(), grain, [&](Parallel::Range range) {
+			for (size_t i = range.begin; i < range.end; ++i)
+				OverlapKernel(bvh, boxes[i], primitives.data() + offsets[i], offsets[i + 1] - offsets[i]);
+		});
+	}
+}
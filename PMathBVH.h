@@ -0,0 +1,81 @@
+#pragma once
+#include <cfloat>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "PMath.h"
+#include "PMathBounds.h"
+#include "PMathIntersection.h"
+#include "PMathKernels.h"
+#include "PMathParallel.h"
+
+namespace PMgene::Math
+{
+	//****************************************************************************
+	// Bounding volume hierarchy
+	// 8-wide tree built with binned SAH. Every node stores the boxes of its children SoA, so one
+	// AVX2 iteration tests a ray against all of them.
+
+	class BVH
+	{
+	public:
+		static constexpr uint32_t InvalidPrimitive = UINT32_MAX;
+
+		// Primitives per leaf
+		static constexpr size_t MaxLeafSize = 4;
+
+		BVH() = default;
+
+		// Builds over arbitrary primitives given by their bounds; rays hit the boxes themselves.
+		// The parallel versions split the binning of large ranges and independent subtrees.
+		void Build(std::span<const AABB> bounds);
+		void Build(const Parallel::ParallelPolicy& policy, std::span<const AABB> bounds);
+
+		// Builds over an indexed triangle list, three indices per triangle; rays hit the triangles
+		void Build(std::span<const Vector3> vertices, std::span<const uint32_t> indices);
+		void Build(const Parallel::ParallelPolicy& policy, std::span<const Vector3> vertices, std::span<const uint32_t> indices);
+
+		void Clear() noexcept;
+
+		[[nodiscard]] bool Empty() const noexcept { return m_primitives.empty(); }
+		[[nodiscard]] size_t PrimitiveCount() const noexcept { return m_primitives.size(); }
+		[[nodiscard]] size_t NodeCount() const noexcept { return m_nodes.size(); }
+		[[nodiscard]] AABB Bounds() const noexcept { return m_bounds; }
+
+		// Closest hit and any hit closer than maxDistance. Primitive indices are the positions in
+		// the span given to Build, triangle numbers for meshes.
+		[[nodiscard]] RayHit Raycast(const Ray& ray, float maxDistance = FLT_MAX) const noexcept;
+		[[nodiscard]] bool Occluded(const Ray& ray, float maxDistance = FLT_MAX) const noexcept;
+
+		// Batches. The packet version traverses groups of 8 rays together, which pays off when they
+		// are coherent, like camera rays of neighbouring pixels or shadow rays towards one light.
+		void Raycast(std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance = FLT_MAX) const noexcept;
+		void RaycastPackets(std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance = FLT_MAX) const noexcept;
+		void Occluded(std::span<const Ray> rays, std::span<uint8_t> occluded, float maxDistance = FLT_MAX) const noexcept;
+
+		void Raycast(const Parallel::ParallelPolicy& policy, std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance = FLT_MAX) const noexcept;
+		void RaycastPackets(const Parallel::ParallelPolicy& policy, std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance = FLT_MAX) const noexcept;
+		void Occluded(const Parallel::ParallelPolicy& policy, std::span<const Ray> rays, std::span<uint8_t> occluded, float maxDistance = FLT_MAX) const noexcept;
+
+		// Appends the primitives whose bounds overlap the box, in no particular order, and returns their number
+		size_t Overlap(const AABB& box, std::vector<uint32_t>& result) const;
+
+		// Batch overlap: the primitives of query i are primitives[offsets[i], offsets[i + 1])
+		void Overlap(std::span<const AABB> boxes, std::vector<uint32_t>& offsets, std::vector<uint32_t>& primitives) const;
+		void Overlap(const Parallel::ParallelPolicy& policy, std::span<const AABB> boxes, std::vector<uint32_t>& offsets, std::vector<uint32_t>& primitives) const;
+
+	private:
+		void BuildTree(bool parallel, std::span<const AABB> bounds);
+		[[nodiscard]] Detail::BVHView View() const noexcept;
+
+		std::vector<Detail::BVHNode> m_nodes;
+
+		// Per primitive in leaf order
+		std::vector<AABB> m_boxes;
+		std::vector<float> m_triangles;
+		std::vector<uint32_t> m_primitives;
+
+		AABB m_bounds;
+	};
+}
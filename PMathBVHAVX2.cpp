@@ -0,0 +1,150 @@
+#include "PMathCpu.h"
+
+#if PMATH_X86
+#include <cstdint>
+
+#include "PMathAVX2.h"
+#include "PMathBVHTraversal.h"
+#include "PMathKernels.h"
+#include "PMathRayPacketAVX2.h"
+
+namespace PMgene::Math::Detail::AVX2
+{
+	namespace
+	{
+		// One ray against the 8 children of a node
+		struct NodeTest
+		{
+			static uint32_t TestRay(const BVHNode& node, const BVHRay& ray, float maxDistance, float* tNear) noexcept
+			{
+				__m256 t0 = _mm256_setzero_ps();
+				__m256 t1 = _mm256_set1_ps(maxDistance);
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					const __m256 inverse = _mm256_set1_ps(ray.inverse[axis]);
+					const __m256 scaledOrigin = _mm256_set1_ps(ray.scaledOrigin[axis]);
+					t0 = _mm256_max_ps(t0, _mm256_fmsub_ps(_mm256_load_ps(node.bounds[ray.nearRow[axis]]), inverse, scaledOrigin));
+					t1 = _mm256_min_ps(t1, _mm256_fmsub_ps(_mm256_load_ps(node.bounds[ray.FarRow(axis)]), inverse, scaledOrigin));
+				}
+				_mm256_store_ps(tNear, t0);
+				return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(t0, t1, _CMP_LE_OQ)));
+			}
+
+			static uint32_t TestBox(const BVHNode& node, const float* box) noexcept
+			{
+				__m256 overlaps = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					const __m256 below = _mm256_cmp_ps(_mm256_load_ps(node.bounds[axis]), _mm256_set1_ps(box[axis + 3]), _CMP_LE_OQ);
+					const __m256 above = _mm256_cmp_ps(_mm256_load_ps(node.bounds[axis + 3]), _mm256_set1_ps(box[axis]), _CMP_GE_OQ);
+					overlaps = _mm256_and_ps(overlaps, _mm256_and_ps(below, above));
+				}
+				return static_cast<uint32_t>(_mm256_movemask_ps(overlaps));
+			}
+		};
+
+		__m256 LaneMask(uint32_t bits) noexcept
+		{
+			const __m256i lanes = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+			return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(static_cast<int>(bits)), lanes), lanes));
+		}
+
+		// Traverses the tree once for up to 8 rays, descending into every child hit by any active ray
+		void RaycastPacket8(const BVHView& bvh, const float* rays, size_t count, float maxDistance, BVHHit* hits) noexcept
+		{
+			struct Entry
+			{
+				uint32_t node;
+				uint32_t lanes;
+			};
+
+			const Packet P(rays, count);
+			__m256 closest = _mm256_set1_ps(maxDistance);
+			__m256 primitive = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			__m256 hitU = _mm256_setzero_ps();
+			__m256 hitV = _mm256_setzero_ps();
+
+			Entry stack[BVHStackSize];
+			size_t size = 0;
+			stack[size++] = { 0, (1u << count) - 1 };
+			while (size != 0)
+			{
+				const Entry entry = stack[--size];
+				const BVHNode& node = bvh.nodes[entry.node];
+				for (int i = 0; i < 8 && node.child[i] != BVHEmptyChild; ++i)
+				{
+					const float lo[3] = { node.bounds[0][i], node.bounds[1][i], node.bounds[2][i] };
+					const float hi[3] = { node.bounds[3][i], node.bounds[4][i], node.bounds[5][i] };
+					__m256 tNear;
+					const uint32_t lanes = static_cast<uint32_t>(_mm256_movemask_ps(P.TestBox(lo, hi, closest, tNear))) & entry.lanes;
+					if (lanes == 0)
+						continue;
+
+					const uint32_t child = node.child[i];
+					if (!(child & BVHLeafFlag))
+					{
+						assert(size < BVHStackSize);
+						stack[size++] = { child, lanes };
+						continue;
+					}
+
+					const __m256 active = LaneMask(lanes);
+					const uint32_t first = child & ~BVHLeafFlag;
+					for (uint32_t p = first; p < first + node.count[i]; ++p)
+					{
+						__m256 t, u = _mm256_setzero_ps(), v = _mm256_setzero_ps(), hit;
+						if (bvh.triangles)
+						{
+							hit = P.TestTriangle(bvh.triangles + 9 * size_t(p), closest, t, u, v);
+						}
+						else
+						{
+							const float* box = bvh.boxes + 6 * size_t(p);
+							hit = P.TestBox(box, box + 3, closest, t);
+							hit = _mm256_and_ps(hit, _mm256_cmp_ps(t, closest, _CMP_LT_OQ));
+						}
+
+						hit = _mm256_and_ps(hit, active);
+						closest = _mm256_blendv_ps(closest, t, hit);
+						primitive = _mm256_blendv_ps(primitive, _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(p))), hit);
+						hitU = _mm256_blendv_ps(hitU, u, hit);
+						hitV = _mm256_blendv_ps(hitV, v, hit);
+					}
+				}
+			}
+
+			alignas(32) float distance[8], u[8], v[8];
+			alignas(32) uint32_t index[8];
+			_mm256_store_ps(distance, closest);
+			_mm256_store_ps(u, hitU);
+			_mm256_store_ps(v, hitV);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(index), _mm256_castps_si256(primitive));
+			for (size_t i = 0; i < count; ++i)
+				hits[i] = ResolveHit(bvh, { distance[i], index[i], u[i], v[i] });
+		}
+	}
+
+	void BVHRaycast(const BVHView& bvh, const float* rays, float maxDistance, BVHHit* hits, size_t count) noexcept
+	{
+		for (size_t i = 0; i < count; ++i)
+			hits[i] = RaycastTraverse<NodeTest>(bvh, rays + 6 * i, maxDistance);
+	}
+
+	void BVHRaycastPacket(const BVHView& bvh, const float* rays, float maxDistance, BVHHit* hits, size_t count) noexcept
+	{
+		for (size_t i = 0; i < count; i += 8)
+			RaycastPacket8(bvh, rays + 6 * i, count - i < 8 ? count - i : 8, maxDistance, hits + i);
+	}
+
+	void BVHOccluded(const BVHView& bvh, const float* rays, float maxDistance, uint8_t* occluded, size_t count) noexcept
+	{
+		for (size_t i = 0; i < count; ++i)
+			occluded[i] = OccludedTraverse<NodeTest>(bvh, rays + 6 * i, maxDistance);
+	}
+
+	size_t BVHOverlap(const BVHView& bvh, const float* box, uint32_t* primitives, size_t capacity) noexcept
+	{
+		return OverlapTraverse<NodeTest>(bvh, box, primitives, capacity);
+	}
+}
+#endif
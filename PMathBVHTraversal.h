@@ -0,0 +1,252 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+
+#include "PMathKernels.h"
+
+// BVH traversal shared by the kernel translation units. The loops are templates over the node
+// test, so each instruction set compiles its own copy with its own flags; like PMathAVX2.h,
+// everything has internal linkage. A node test provides
+//   static uint32_t TestRay(const BVHNode&, const BVHRay&, float maxDistance, float* tNear) noexcept;
+//   static uint32_t TestBox(const BVHNode&, const float* box) noexcept;
+// returning the mask of children hit, with the entry distances in tNear for rays.
+
+namespace PMgene::Math::Detail
+{
+	namespace
+	{
+		// Enough for the builder's depth limit with every level holding 7 pending siblings
+		constexpr size_t BVHStackSize = 512;
+
+		// Smaller direction components are clamped so the reciprocals stay finite
+		constexpr float MinDirection = 1e-20f;
+
+		struct BVHRay
+		{
+			float origin[3];
+			float direction[3];
+			float inverse[3];      // reciprocal of the clamped direction
+			float scaledOrigin[3]; // origin * inverse, so each slab is one multiply-subtract
+			int nearRow[3];        // bounds row entered first: min for positive directions, else max
+
+			explicit BVHRay(const float* ray) noexcept
+			{
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					const float d = ray[3 + axis];
+					origin[axis] = ray[axis];
+					direction[axis] = d;
+					inverse[axis] = 1.f / (std::abs(d) < MinDirection ? std::copysign(MinDirection, d) : d);
+					scaledOrigin[axis] = origin[axis] * inverse[axis];
+					nearRow[axis] = std::signbit(inverse[axis]) ? axis + 3 : axis;
+				}
+			}
+
+			[[nodiscard]] int FarRow(int axis) const noexcept { return nearRow[axis] < 3 ? axis + 3 : axis; }
+		};
+
+		// Möller-Trumbore against vertex 0 and the two edges from it
+		inline bool IntersectTriangle(const float* triangle, const BVHRay& ray, float maxDistance, float& t, float& u, float& v) noexcept
+		{
+			const float* v0 = triangle;
+			const float* e1 = triangle + 3;
+			const float* e2 = triangle + 6;
+			const float* d = ray.direction;
+
+			const float p[3] = { d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2], d[0] * e2[1] - d[1] * e2[0] };
+			const float det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+			if (det == 0.f)
+				return false;
+
+			const float inverse = 1.f / det;
+			const float s[3] = { ray.origin[0] - v0[0], ray.origin[1] - v0[1], ray.origin[2] - v0[2] };
+			u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inverse;
+			if (!(u >= 0.f && u <= 1.f))
+				return false;
+
+			const float q[3] = { s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0] };
+			v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * inverse;
+			if (!(v >= 0.f && u + v <= 1.f))
+				return false;
+
+			t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inverse;
+			return t >= 0.f && t < maxDistance;
+		}
+
+		// Entry distance into a 6-float box, 0 when the ray starts inside it
+		inline bool IntersectBox(const float* box, const BVHRay& ray, float maxDistance, float& t) noexcept
+		{
+			float tNear = 0.f;
+			float tFar = maxDistance;
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				tNear = std::max(tNear, box[ray.nearRow[axis]] * ray.inverse[axis] - ray.scaledOrigin[axis]);
+				tFar = std::min(tFar, box[ray.FarRow(axis)] * ray.inverse[axis] - ray.scaledOrigin[axis]);
+			}
+			t = tNear;
+			return tNear <= tFar && tNear < maxDistance;
+		}
+
+		inline bool BoxesOverlap(const float* a, const float* b) noexcept
+		{
+			return a[0] <= b[3] && a[3] >= b[0] &&
+			       a[1] <= b[4] && a[4] >= b[1] &&
+			       a[2] <= b[5] && a[5] >= b[2];
+		}
+
+		// Shrinks 'hit' to the closest primitive of the leaf, keeping the leaf order index
+		inline void IntersectLeaf(const BVHView& bvh, const BVHRay& ray, uint32_t first, uint32_t count, BVHHit& hit) noexcept
+		{
+			for (uint32_t p = first; p < first + count; ++p)
+			{
+				float t, u = 0.f, v = 0.f;
+				const bool intersects = bvh.triangles ? IntersectTriangle(bvh.triangles + 9 * size_t(p), ray, hit.distance, t, u, v)
+				                                      : IntersectBox(bvh.boxes + 6 * size_t(p), ray, hit.distance, t);
+				if (intersects)
+					hit = { t, p, u, v };
+			}
+		}
+
+		inline bool LeafOccludes(const BVHView& bvh, const BVHRay& ray, uint32_t first, uint32_t count, float maxDistance) noexcept
+		{
+			for (uint32_t p = first; p < first + count; ++p)
+			{
+				float t, u, v;
+				const bool intersects = bvh.triangles ? IntersectTriangle(bvh.triangles + 9 * size_t(p), ray, maxDistance, t, u, v)
+				                                      : IntersectBox(bvh.boxes + 6 * size_t(p), ray, maxDistance, t);
+				if (intersects)
+					return true;
+			}
+			return false;
+		}
+
+		// Maps a leaf order hit to the caller's primitive index, or marks the miss
+		inline BVHHit ResolveHit(const BVHView& bvh, BVHHit hit) noexcept
+		{
+			if (hit.primitive == UINT32_MAX)
+				hit.distance = FLT_MAX;
+			else
+				hit.primitive = bvh.primitives[hit.primitive];
+			return hit;
+		}
+
+		// Closest hit, visiting the nearest children first
+		template <typename NodeTest>
+		BVHHit RaycastTraverse(const BVHView& bvh, const float* rayData, float maxDistance) noexcept
+		{
+			struct Entry
+			{
+				uint32_t node;
+				float distance;
+			};
+
+			const BVHRay ray(rayData);
+			BVHHit hit = { maxDistance, UINT32_MAX, 0.f, 0.f };
+
+			Entry stack[BVHStackSize];
+			size_t size = 0;
+			stack[size++] = { 0, 0.f };
+			while (size != 0)
+			{
+				const Entry entry = stack[--size];
+				if (entry.distance >= hit.distance)
+					continue;
+
+				const BVHNode& node = bvh.nodes[entry.node];
+				alignas(32) float tNear[8];
+
+				// Leaves are tested right away, inner children are sorted farthest first
+				Entry inner[8];
+				size_t innerCount = 0;
+				for (uint32_t mask = NodeTest::TestRay(node, ray, hit.distance, tNear); mask != 0; mask &= mask - 1)
+				{
+					const int i = std::countr_zero(mask);
+					const uint32_t child = node.child[i];
+					if (child & BVHLeafFlag)
+					{
+						IntersectLeaf(bvh, ray, child & ~BVHLeafFlag, node.count[i], hit);
+						continue;
+					}
+
+					size_t k = innerCount++;
+					for (; k > 0 && inner[k - 1].distance < tNear[i]; --k)
+						inner[k] = inner[k - 1];
+					inner[k] = { child, tNear[i] };
+				}
+
+				assert(size + innerCount <= BVHStackSize);
+				for (size_t k = 0; k < innerCount; ++k)
+					stack[size++] = inner[k];
+			}
+			return ResolveHit(bvh, hit);
+		}
+
+		// Any hit closer than maxDistance
+		template <typename NodeTest>
+		bool OccludedTraverse(const BVHView& bvh, const float* rayData, float maxDistance) noexcept
+		{
+			const BVHRay ray(rayData);
+
+			uint32_t stack[BVHStackSize];
+			size_t size = 0;
+			stack[size++] = 0;
+			while (size != 0)
+			{
+				const BVHNode& node = bvh.nodes[stack[--size]];
+				alignas(32) float tNear[8];
+				for (uint32_t mask = NodeTest::TestRay(node, ray, maxDistance, tNear); mask != 0; mask &= mask - 1)
+				{
+					const int i = std::countr_zero(mask);
+					const uint32_t child = node.child[i];
+					if (!(child & BVHLeafFlag))
+					{
+						assert(size < BVHStackSize);
+						stack[size++] = child;
+					}
+					else if (LeafOccludes(bvh, ray, child & ~BVHLeafFlag, node.count[i], maxDistance))
+						return true;
+				}
+			}
+			return false;
+		}
+
+		template <typename NodeTest>
+		size_t OverlapTraverse(const BVHView& bvh, const float* box, uint32_t* primitives, size_t capacity) noexcept
+		{
+			uint32_t stack[BVHStackSize];
+			size_t size = 0;
+			size_t found = 0;
+			stack[size++] = 0;
+			while (size != 0)
+			{
+				const BVHNode& node = bvh.nodes[stack[--size]];
+				for (uint32_t mask = NodeTest::TestBox(node, box); mask != 0; mask &= mask - 1)
+				{
+					const int i = std::countr_zero(mask);
+					const uint32_t child = node.child[i];
+					if (!(child & BVHLeafFlag))
+					{
+						assert(size < BVHStackSize);
+						stack[size++] = child;
+						continue;
+					}
+
+					const uint32_t first = child & ~BVHLeafFlag;
+					for (uint32_t p = first; p < first + node.count[i]; ++p)
+					{
+						if (!BoxesOverlap(bvh.boxes + 6 * size_t(p), box))
+							continue;
+						if (found < capacity)
+							primitives[found] = bvh.primitives[p];
+						++found;
+					}
+				}
+			}
+			return found;
+		}
+	}
+}
@@ -0,0 +1,696 @@
+#include "PMathBounds.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <utility>
+
+#include "PMath.inl"
+#include "PMathCpu.h"
+#include "PMathKernels.h"
+
+namespace PMgene::Math
+{
+	namespace
+	{
+		static_assert(sizeof(AABB) == 6 * sizeof(float), "AABB must be tightly packed for batch kernels");
+		static_assert(sizeof(BoundingSphere) == 4 * sizeof(float), "BoundingSphere must be tightly packed for batch kernels");
+
+		// Masks per parallel chunk, a multiple of 64 so every chunk starts on a mask word
+		constexpr size_t CullGrain = 16384;
+
+		// Rows are the box axes in world space
+		void RotationAxes(const Quaternion& q, Vector3 axes[3]) noexcept
+		{
+			const Matrix R = Matrix::CreateFromQuaternion(q);
+			axes[0] = Vector3(R._11, R._12, R._13);
+			axes[1] = Vector3(R._21, R._22, R._23);
+			axes[2] = Vector3(R._31, R._32, R._33);
+		}
+
+		float LengthSquared(const Vector3& V) noexcept
+		{
+			return V.x * V.x + V.y * V.y + V.z * V.z;
+		}
+
+		float PlaneDistance(const float* plane, float x, float y, float z) noexcept
+		{
+			return plane[0] * x + plane[1] * y + plane[2] * z + plane[3];
+		}
+
+		// Tests the corner furthest along each plane normal. The sign bit picks it, like the
+		// AVX2 blend, so -0 normals give the same answer in every kernel.
+		bool AABBVisible(const float* planes, const float* box) noexcept
+		{
+			bool visible = true;
+			for (int k = 0; k < Frustum::PlaneCount; ++k)
+			{
+				const float* plane = planes + 4 * k;
+				const float x = std::signbit(plane[0]) ? box[0] : box[3];
+				const float y = std::signbit(plane[1]) ? box[1] : box[4];
+				const float z = std::signbit(plane[2]) ? box[2] : box[5];
+				visible &= !(PlaneDistance(plane, x, y, z) < 0.f);
+			}
+			return visible;
+		}
+
+		bool SphereVisible(const float* planes, const float* sphere) noexcept
+		{
+			bool visible = true;
+			for (int k = 0; k < Frustum::PlaneCount; ++k)
+				visible &= !(PlaneDistance(planes + 4 * k, sphere[0], sphere[1], sphere[2]) + sphere[3] < 0.f);
+			return visible;
+		}
+
+		template <size_t Stride, bool (*Visible)(const float*, const float*)>
+		void CullMask(const float* planes, const float* volumes, uint64_t* mask, size_t count) noexcept
+		{
+			for (size_t base = 0; base < count; base += 64)
+			{
+				const size_t end = std::min<size_t>(count - base, 64);
+				uint64_t bits = 0;
+				for (size_t i = 0; i < end; ++i)
+					bits |= uint64_t(Visible(planes, volumes + (base + i) * Stride)) << i;
+				mask[base / 64] = bits;
+			}
+		}
+
+		template <size_t Stride, bool (*Visible)(const float*, const float*)>
+		size_t CullIndices(const float* planes, const float* volumes, uint32_t* indices, size_t count) noexcept
+		{
+			size_t visible = 0;
+			for (size_t i = 0; i < count; ++i)
+			{
+				indices[visible] = static_cast<uint32_t>(i);
+				visible += Visible(planes, volumes + i * Stride);
+			}
+			return visible;
+		}
+	}
+
+	//****************************************************************************
+	// Portable culling kernels
+
+	namespace Detail::Generic
+	{
+		void FrustumCullAABBMask(const float* planes, const float* boxes, uint64_t* mask, size_t count) noexcept
+		{
+			CullMask<6, AABBVisible>(planes, boxes, mask, count);
+		}
+
+		size_t FrustumCullAABBIndices(const float* planes, const float* boxes, uint32_t* indices, size_t count) noexcept
+		{
+			return CullIndices<6, AABBVisible>(planes, boxes, indices, count);
+		}
+
+		void FrustumCullSphereMask(const float* planes, const float* spheres, uint64_t* mask, size_t count) noexcept
+		{
+			CullMask<4, SphereVisible>(planes, spheres, mask, count);
+		}
+
+		size_t FrustumCullSphereIndices(const float* planes, const float* spheres, uint32_t* indices, size_t count) noexcept
+		{
+			return CullIndices<4, SphereVisible>(planes, spheres, indices, count);
+		}
+	}
+
+	//****************************************************************************
+	// Bounding sphere
+
+	bool BoundingSphere::Contains(const Vector3& point) const noexcept
+	{
+		return LengthSquared(point - center) <= radius * radius;
+	}
+
+	bool BoundingSphere::Intersects(const BoundingSphere& S) const noexcept
+	{
+		const float r = radius + S.radius;
+		return LengthSquared(S.center - center) <= r * r;
+	}
+
+	bool BoundingSphere::Intersects(const AABB& box) const noexcept
+	{
+		const Vector3 closest(std::clamp(center.x, box.min.x, box.max.x),
+		                      std::clamp(center.y, box.min.y, box.max.y),
+		                      std::clamp(center.z, box.min.z, box.max.z));
+		return LengthSquared(closest - center) <= radius * radius;
+	}
+
+	BoundingSphere BoundingSphere::Transform(const Matrix& M) const noexcept
+	{
+		const float scale = std::max({ M._11 * M._11 + M._12 * M._12 + M._13 * M._13,
+		                               M._21 * M._21 + M._22 * M._22 + M._23 * M._23,
+		                               M._31 * M._31 + M._32 * M._32 + M._33 * M._33 });
+		return BoundingSphere(M.TransformPoint(center), radius * std::sqrt(scale));
+	}
+
+	BoundingSphere BoundingSphere::CreateFromPoints(std::span<const Vector3> points) noexcept
+	{
+		if (points.empty())
+			return BoundingSphere();
+
+		// Start from the most distant pair of axis extremes
+		const Vector3* extremes[6] = {};
+		for (const Vector3& p : points)
+		{
+			if (!extremes[0] || p.x < extremes[0]->x) extremes[0] = &p;
+			if (!extremes[1] || p.x > extremes[1]->x) extremes[1] = &p;
+			if (!extremes[2] || p.y < extremes[2]->y) extremes[2] = &p;
+			if (!extremes[3] || p.y > extremes[3]->y) extremes[3] = &p;
+			if (!extremes[4] || p.z < extremes[4]->z) extremes[4] = &p;
+			if (!extremes[5] || p.z > extremes[5]->z) extremes[5] = &p;
+		}
+
+		int axis = 0;
+		float distance = 0.f;
+		for (int i = 0; i < 3; ++i)
+		{
+			const float d = LengthSquared(*extremes[2 * i + 1] - *extremes[2 * i]);
+			if (d > distance)
+			{
+				distance = d;
+				axis = i;
+			}
+		}
+
+		BoundingSphere S((*extremes[2 * axis] + *extremes[2 * axis + 1]) * 0.5f, std::sqrt(distance) * 0.5f);
+
+		// Grow it towards every point left outside
+		for (const Vector3& p : points)
+		{
+			const float d = LengthSquared(p - S.center);
+			if (d <= S.radius * S.radius)
+				continue;
+
+			const float length = std::sqrt(d);
+			const float radius = (S.radius + length) * 0.5f;
+			S.center += (p - S.center) * ((radius - S.radius) / length);
+			S.radius = radius;
+		}
+		return S;
+	}
+
+	BoundingSphere BoundingSphere::CreateFromAABB(const AABB& box) noexcept
+	{
+		return BoundingSphere(box.Center(), box.Extents().Length());
+	}
+
+	BoundingSphere BoundingSphere::CreateMerged(const BoundingSphere& S1, const BoundingSphere& S2) noexcept
+	{
+		const Vector3 offset = S2.center - S1.center;
+		const float distance = offset.Length();
+
+		if (distance + S2.radius <= S1.radius)
+			return S1;
+		if (distance + S1.radius <= S2.radius)
+			return S2;
+
+		const float radius = (S1.radius + distance + S2.radius) * 0.5f;
+		return BoundingSphere(S1.center + offset * ((radius - S1.radius) / distance), radius);
+	}
+
+	//****************************************************************************
+	// Axis-aligned bounding box
+
+	float AABB::SurfaceArea() const noexcept
+	{
+		const Vector3 size = max - min;
+		return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+
+	bool AABB::Contains(const Vector3& point) const noexcept
+	{
+		return point.x >= min.x && point.x <= max.x &&
+		       point.y >= min.y && point.y <= max.y &&
+		       point.z >= min.z && point.z <= max.z;
+	}
+
+	bool AABB::Intersects(const AABB& box) const noexcept
+	{
+		return min.x <= box.max.x && max.x >= box.min.x &&
+		       min.y <= box.max.y && max.y >= box.min.y &&
+		       min.z <= box.max.z && max.z >= box.min.z;
+	}
+
+	bool AABB::Intersects(const BoundingSphere& S) const noexcept
+	{
+		return S.Intersects(*this);
+	}
+
+	AABB AABB::Transform(const Matrix& M) const noexcept
+	{
+		// Arvo: the new extents sum the absolute contributions of the old ones
+		const Vector3 center = M.TransformPoint(Center());
+		const Vector3 e = Extents();
+		const Vector3 extents(std::abs(M._11) * e.x + std::abs(M._21) * e.y + std::abs(M._31) * e.z,
+		                      std::abs(M._12) * e.x + std::abs(M._22) * e.y + std::abs(M._32) * e.z,
+		                      std::abs(M._13) * e.x + std::abs(M._23) * e.y + std::abs(M._33) * e.z);
+		return AABB(center - extents, center + extents);
+	}
+
+	AABB AABB::CreateFromPoints(std::span<const Vector3> points) noexcept
+	{
+		if (points.empty())
+			return AABB();
+
+		AABB box(points[0], points[0]);
+		for (const Vector3& p : points)
+		{
+			box.min = Vector3(std::min(box.min.x, p.x), std::min(box.min.y, p.y), std::min(box.min.z, p.z));
+			box.max = Vector3(std::max(box.max.x, p.x), std::max(box.max.y, p.y), std::max(box.max.z, p.z));
+		}
+		return box;
+	}
+
+	AABB AABB::CreateMerged(const AABB& B1, const AABB& B2) noexcept
+	{
+		return AABB(Vector3(std::min(B1.min.x, B2.min.x), std::min(B1.min.y, B2.min.y), std::min(B1.min.z, B2.min.z)),
+		            Vector3(std::max(B1.max.x, B2.max.x), std::max(B1.max.y, B2.max.y), std::max(B1.max.z, B2.max.z)));
+	}
+
+	//****************************************************************************
+	// Oriented bounding box
+
+	bool OBB::Contains(const Vector3& point) const noexcept
+	{
+		Vector3 axes[3];
+		RotationAxes(orientation, axes);
+
+		const Vector3 offset = point - center;
+		return std::abs(offset.Dot(axes[0])) <= extents.x &&
+		       std::abs(offset.Dot(axes[1])) <= extents.y &&
+		       std::abs(offset.Dot(axes[2])) <= extents.z;
+	}
+
+	bool OBB::Intersects(const OBB& box) const noexcept
+	{
+		// Ericson, Real-Time Collision Detection 4.4.1, with the translation and the rotation
+		// expressed in this box's frame
+		Vector3 a[3], b[3];
+		RotationAxes(orientation, a);
+		RotationAxes(box.orientation, b);
+
+		const float ea[3] = { extents.x, extents.y, extents.z };
+		const float eb[3] = { box.extents.x, box.extents.y, box.extents.z };
+
+		// The epsilon keeps near-parallel edge pairs from producing a false separating axis
+		constexpr float Epsilon = 1e-6f;
+		float R[3][3], AbsR[3][3];
+		for (int i = 0; i < 3; ++i)
+		{
+			for (int j = 0; j < 3; ++j)
+			{
+				R[i][j] = a[i].Dot(b[j]);
+				AbsR[i][j] = std::abs(R[i][j]) + Epsilon;
+			}
+		}
+
+		const Vector3 offset = box.center - center;
+		const float t[3] = { offset.Dot(a[0]), offset.Dot(a[1]), offset.Dot(a[2]) };
+
+		for (int i = 0; i < 3; ++i)
+		{
+			const float rb = eb[0] * AbsR[i][0] + eb[1] * AbsR[i][1] + eb[2] * AbsR[i][2];
+			if (std::abs(t[i]) > ea[i] + rb)
+				return false;
+		}
+
+		for (int j = 0; j < 3; ++j)
+		{
+			const float ra = ea[0] * AbsR[0][j] + ea[1] * AbsR[1][j] + ea[2] * AbsR[2][j];
+			if (std::abs(t[0] * R[0][j] + t[1] * R[1][j] + t[2] * R[2][j]) > ra + eb[j])
+				return false;
+		}
+
+		// Cross products a[i] x b[j]
+		for (int i = 0; i < 3; ++i)
+		{
+			const int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+			for (int j = 0; j < 3; ++j)
+			{
+				const int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+				const float ra = ea[i1] * AbsR[i2][j] + ea[i2] * AbsR[i1][j];
+				const float rb = eb[j1] * AbsR[i][j2] + eb[j2] * AbsR[i][j1];
+				if (std::abs(t[i2] * R[i1][j] - t[i1] * R[i2][j]) > ra + rb)
+					return false;
+			}
+		}
+		return true;
+	}
+
+	AABB OBB::ToAABB() const noexcept
+	{
+		Vector3 axes[3];
+		RotationAxes(orientation, axes);
+
+		const Vector3 e(std::abs(axes[0].x) * extents.x + std::abs(axes[1].x) * extents.y + std::abs(axes[2].x) * extents.z,
+		                std::abs(axes[0].y) * extents.x + std::abs(axes[1].y) * extents.y + std::abs(axes[2].y) * extents.z,
+		                std::abs(axes[0].z) * extents.x + std::abs(axes[1].z) * extents.y + std::abs(axes[2].z) * extents.z);
+		return AABB(center - e, center + e);
+	}
+
+	OBB OBB::Transform(const Matrix& M) const noexcept
+	{
+		// Non-uniform scale is approximated by the largest axis scale, so the result stays conservative
+		Vector3 rows[3] = { Vector3(M._11, M._12, M._13), Vector3(M._21, M._22, M._23), Vector3(M._31, M._32, M._33) };
+		const float scale = std::max({ rows[0].Length(), rows[1].Length(), rows[2].Length() });
+		for (Vector3& row : rows)
+			row.Normalize();
+
+		const Quaternion rotation = Quaternion::CreateFromRotationMatrix(Matrix(rows[0], rows[1], rows[2]));
+		Quaternion q = orientation * rotation;
+		q.Normalize();
+		return OBB(M.TransformPoint(center), extents * scale, q);
+	}
+
+	OBB OBB::CreateFromAABB(const AABB& box) noexcept
+	{
+		return OBB(box.Center(), box.Extents(), Quaternion::Identity);
+	}
+
+	namespace
+	{
+		// Sets per eigen batch, bounding the scratch on the stack
+		constexpr size_t FitBatch = 64;
+
+		// Sets per parallel chunk
+		constexpr size_t FitGrain = 256;
+
+		// Covariance of the points about their mean
+		Matrix3 Covariance(std::span<const Vector3> points) noexcept
+		{
+			if (points.empty())
+				return Matrix3(0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f);
+
+			Vector3 mean = Vector3::Zero;
+			for (const Vector3& p : points)
+				mean += p;
+			mean /= float(points.size());
+
+			float xx = 0.f, xy = 0.f, xz = 0.f, yy = 0.f, yz = 0.f, zz = 0.f;
+			for (const Vector3& p : points)
+			{
+				const Vector3 d = p - mean;
+				xx += d.x * d.x;
+				xy += d.x * d.y;
+				xz += d.x * d.z;
+				yy += d.y * d.y;
+				yz += d.y * d.z;
+				zz += d.z * d.z;
+			}
+
+			const float s = 1.f / float(points.size());
+			return Matrix3(xx * s, xy * s, xz * s,
+			               xy * s, yy * s, yz * s,
+			               xz * s, yz * s, zz * s);
+		}
+
+		// Box along the rows of axes, a rotation, enclosing the points
+		OBB FitAxes(std::span<const Vector3> points, const Matrix3& axes) noexcept
+		{
+			if (points.empty())
+				return OBB();
+
+			const Vector3 rows[3] = { axes.Row(0), axes.Row(1), axes.Row(2) };
+			float low[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+			float high[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+			for (const Vector3& p : points)
+			{
+				for (int k = 0; k < 3; ++k)
+				{
+					const float d = p.Dot(rows[k]);
+					low[k] = std::min(low[k], d);
+					high[k] = std::max(high[k], d);
+				}
+			}
+
+			const Vector3 center = axes.Transform(Vector3(low[0] + high[0], low[1] + high[1], low[2] + high[2]) * 0.5f);
+			const Vector3 extents = Vector3(high[0] - low[0], high[1] - low[1], high[2] - low[2]) * 0.5f;
+			Quaternion q = Quaternion::CreateFromRotationMatrix(axes.ToMatrix());
+			q.Normalize();
+			return OBB(center, extents, q);
+		}
+
+		void FitSets(std::span<const Vector3> points, std::span<const uint32_t> offsets, std::span<OBB> result, Parallel::Range range) noexcept
+		{
+			Matrix3 covariances[FitBatch];
+			Vector3 eigenvalues[FitBatch];
+			Matrix3 axes[FitBatch];
+
+			const auto set = [&](size_t i) { return points.subspan(offsets[i], offsets[i + 1] - offsets[i]); };
+			for (size_t first = range.begin; first < range.end; first += FitBatch)
+			{
+				const size_t count = std::min(FitBatch, range.end - first);
+				for (size_t k = 0; k < count; ++k)
+					covariances[k] = Covariance(set(first + k));
+
+				Matrix3::EigenSymmetricBatch(std::span(covariances, count), std::span(eigenvalues, count), std::span(axes, count));
+
+				for (size_t k = 0; k < count; ++k)
+					result[first + k] = FitAxes(set(first + k), axes[k]);
+			}
+		}
+
+		[[maybe_unused]] bool ValidOffsets(std::span<const Vector3> points, std::span<const uint32_t> offsets, std::span<OBB> result) noexcept
+		{
+			return offsets.size() == result.size() + 1 && std::is_sorted(offsets.begin(), offsets.end()) && offsets.back() <= points.size();
+		}
+	}
+
+	OBB OBB::CreateFromPoints(std::span<const Vector3> points) noexcept
+	{
+		Vector3 eigenvalues;
+		Matrix3 axes;
+		Covariance(points).EigenSymmetric(eigenvalues, axes);
+		return FitAxes(points, axes);
+	}
+
+	void OBB::CreateFromPointsBatch(std::span<const Vector3> points, std::span<const uint32_t> offsets, std::span<OBB> result) noexcept
+	{
+		assert(ValidOffsets(points, offsets, result));
+		FitSets(points, offsets, result, { 0, result.size() });
+	}
+
+	void OBB::CreateFromPointsBatch(const Parallel::ParallelPolicy& policy, std::span<const Vector3> points, std::span<const uint32_t> offsets,
+	                                std::span<OBB> result) noexcept
+	{
+		assert(ValidOffsets(points, offsets, result));
+		Parallel::ParallelFor(result.size(), policy.grain != 0 ? policy.grain : FitGrain, [&](Parallel::Range range) {
+			FitSets(points, offsets, result, range);
+		});
+	}
+
+	//****************************************************************************
+	// Frustum
+
+	bool Frustum::Contains(const Vector3& point) const noexcept
+	{
+		for (const XMFLOAT4& plane : planes)
+		{
+			if (PlaneDistance(&plane.x, point.x, point.y, point.z) < 0.f)
+				return false;
+		}
+		return true;
+	}
+
+	bool Frustum::Intersects(const BoundingSphere& S) const noexcept
+	{
+		return SphereVisible(&planes[0].x, &S.center.x);
+	}
+
+	bool Frustum::Intersects(const AABB& box) const noexcept
+	{
+		return AABBVisible(&planes[0].x, &box.min.x);
+	}
+
+	bool Frustum::Intersects(const OBB& box) const noexcept
+	{
+		Vector3 axes[3];
+		RotationAxes(box.orientation, axes);
+
+		for (const XMFLOAT4& plane : planes)
+		{
+			const Vector3 n(plane.x, plane.y, plane.z);
+			const float radius = std::abs(n.Dot(axes[0])) * box.extents.x +
+			                     std::abs(n.Dot(axes[1])) * box.extents.y +
+			                     std::abs(n.Dot(axes[2])) * box.extents.z;
+			if (PlaneDistance(&plane.x, box.center.x, box.center.y, box.center.z) + radius < 0.f)
+				return false;
+		}
+		return true;
+	}
+
+	namespace
+	{
+		void CullAABBMask(const float* planes, const AABB* boxes, uint64_t* mask, size_t count) noexcept
+		{
+			const float* data = reinterpret_cast<const float*>(boxes);
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+			{
+				Detail::AVX2::FrustumCullAABBMask(planes, data, mask, count);
+				return;
+			}
+#endif
+			Detail::Generic::FrustumCullAABBMask(planes, data, mask, count);
+		}
+
+		void CullSphereMask(const float* planes, const BoundingSphere* spheres, uint64_t* mask, size_t count) noexcept
+		{
+			const float* data = reinterpret_cast<const float*>(spheres);
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+			{
+				Detail::AVX2::FrustumCullSphereMask(planes, data, mask, count);
+				return;
+			}
+#endif
+			Detail::Generic::FrustumCullSphereMask(planes, data, mask, count);
+		}
+
+		size_t Grain(const Parallel::ParallelPolicy& policy) noexcept
+		{
+			return policy.grain != 0 ? (policy.grain + 63) / 64 * 64 : CullGrain;
+		}
+	}
+
+	void Frustum::Cull(std::span<const AABB> boxes, std::span<uint64_t> visibleMask) const noexcept
+	{
+		assert(visibleMask.size() >= (boxes.size() + 63) / 64);
+		CullAABBMask(&planes[0].x, boxes.data(), visibleMask.data(), boxes.size());
+	}
+
+	size_t Frustum::Cull(std::span<const AABB> boxes, std::span<uint32_t> visibleIndices) const noexcept
+	{
+		assert(visibleIndices.size() >= boxes.size() && boxes.size() <= UINT32_MAX);
+
+		const float* data = reinterpret_cast<const float*>(boxes.data());
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+			return Detail::AVX2::FrustumCullAABBIndices(&planes[0].x, data, visibleIndices.data(), boxes.size());
+#endif
+		return Detail::Generic::FrustumCullAABBIndices(&planes[0].x, data, visibleIndices.data(), boxes.size());
+	}
+
+	void Frustum::Cull(std::span<const BoundingSphere> spheres, std::span<uint64_t> visibleMask) const noexcept
+	{
+		assert(visibleMask.size() >= (spheres.size() + 63) / 64);
+		CullSphereMask(&planes[0].x, spheres.data(), visibleMask.data(), spheres.size());
+	}
+
+	size_t Frustum::Cull(std::span<const BoundingSphere> spheres, std::span<uint32_t> visibleIndices) const noexcept
+	{
+		assert(visibleIndices.size() >= spheres.size() && spheres.size() <= UINT32_MAX);
+
+		const float* data = reinterpret_cast<const float*>(spheres.data());
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+			return Detail::AVX2::FrustumCullSphereIndices(&planes[0].x, data, visibleIndices.data(), spheres.size());
+#endif
+		return Detail::Generic::FrustumCullSphereIndices(&planes[0].x, data, visibleIndices.data(), spheres.size());
+	}
+
+	void Frustum::Cull(const Parallel::ParallelPolicy& policy, std::span<const AABB> boxes, std::span<uint64_t> visibleMask) const noexcept
+	{
+		assert(visibleMask.size() >= (boxes.size() + 63) / 64);
+
+		const float* P = &planes[0].x;
+		const AABB* B = boxes.data();
+		uint64_t* mask = visibleMask.data();
+		Parallel::ParallelFor(boxes.size(), Grain(policy), [&](Parallel::Range range) {
+			CullAABBMask(P, B + range.begin, mask + range.begin / 64, range.Size());
+		});
+	}
+
+	void Frustum::Cull(const Parallel::ParallelPolicy& policy, std::span<const BoundingSphere> spheres, std::span<uint64_t> visibleMask) const noexcept
+	{
+		assert(visibleMask.size() >= (spheres.size() + 63) / 64);
+
+		const float* P = &planes[0].x;
+		const BoundingSphere* S = spheres.data();
+		uint64_t* mask = visibleMask.data();
+		Parallel::ParallelFor(spheres.size(), Grain(policy), [&](Parallel::Range range) {
+			CullSphereMask(P, S + range.begin, mask + range.begin / 64, range.Size());
+		});
+	}
+
+	Frustum Frustum::FromMatrix(const Matrix& M) noexcept
+	{
+		// Gribb-Hartmann: with row vectors, clip = v * M, so every plane combines matrix columns
+		const XMVECTOR c0 = XMVectorSet(M._11, M._21, M._31, M._41);
+		const XMVECTOR c1 = XMVectorSet(M._12, M._22, M._32, M._42);
+		const XMVECTOR c2 = XMVectorSet(M._13, M._23, M._33, M._43);
+		const XMVECTOR c3 = XMVectorSet(M._14, M._24, M._34, M._44);
+
+		const XMVECTOR P[PlaneCount] = {
+			XMVectorAdd(c3, c0),
+			XMVectorSubtract(c3, c0),
+			XMVectorAdd(c3, c1),
+			XMVectorSubtract(c3, c1),
+			c2,
+			XMVectorSubtract(c3, c2)
+		};
+
+		Frustum F;
+		for (int k = 0; k < PlaneCount; ++k)
+			XMStoreFloat4(&F.planes[k], XMPlaneNormalize(P[k]));
+		return F;
+	}
+
+	//****************************************************************************
+	// Ray
+
+	bool Ray::Intersects(const BoundingSphere& S, float& distance) const noexcept
+	{
+		// Solves |position + t * direction - center| = radius for the smaller non-negative t
+		const Vector3 offset = position - S.center;
+		const float a = direction.Dot(direction);
+		const float b = offset.Dot(direction);
+		const float c = offset.Dot(offset) - S.radius * S.radius;
+		if (c <= 0.f)
+		{
+			distance = 0.f;
+			return true;
+		}
+
+		const float discriminant = b * b - a * c;
+		if (b >= 0.f || discriminant < 0.f)
+			return false;
+
+		distance = (-b - std::sqrt(discriminant)) / a;
+		return true;
+	}
+
+	bool Ray::Intersects(const AABB& box, float& distance) const noexcept
+	{
+		float tNear = 0.f;
+		float tFar = FLT_MAX;
+		const float* o = &position.x;
+		const float* d = &direction.x;
+		const float* lo = &box.min.x;
+		const float* hi = &box.max.x;
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			if (d[axis] == 0.f)
+			{
+				if (o[axis] < lo[axis] || o[axis] > hi[axis])
+					return false;
+				continue;
+			}
+
+			const float inverse = 1.f / d[axis];
+			float t0 = (lo[axis] - o[axis]) * inverse;
+			float t1 = (hi[axis] - o[axis]) * inverse;
+			if (t0 > t1)
+				std::swap(t0, t1);
+			tNear = std::max(tNear, t0);
+			tFar = std::min(tFar, t1);
+			if (tNear > tFar)
+				return false;
+		}
+
+		distance = tNear;
+		return true;
+	}
+}
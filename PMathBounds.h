@@ -0,0 +1,154 @@
+#pragma once
+#include <cstdint>
+#include <span>
+
+#include "PMath.h"
+#include "PMathParallel.h"
+
+namespace PMgene::Math
+{
+	struct BoundingSphere;
+	struct AABB;
+	struct OBB;
+	struct Frustum;
+
+
+	//****************************************************************************
+	// Bounding sphere
+
+	struct BoundingSphere
+	{
+		Vector3 center;
+		float radius = 0.f;
+
+		// Constructors
+		BoundingSphere() noexcept = default;
+		BoundingSphere(const Vector3& c, float r) noexcept : center(c), radius(r) {}
+
+		// Queries
+		[[nodiscard]] bool Contains(const Vector3& point) const noexcept;
+		[[nodiscard]] bool Intersects(const BoundingSphere& S) const noexcept;
+		[[nodiscard]] bool Intersects(const AABB& box) const noexcept;
+
+		// The radius grows by the largest axis scale of M
+		[[nodiscard]] BoundingSphere Transform(const Matrix& M) const noexcept;
+
+		// Static functions
+		// Ritter's approximation, within a few percent of the minimal sphere
+		static BoundingSphere CreateFromPoints(std::span<const Vector3> points) noexcept;
+		static BoundingSphere CreateFromAABB(const AABB& box) noexcept;
+		static BoundingSphere CreateMerged(const BoundingSphere& S1, const BoundingSphere& S2) noexcept;
+	};
+
+
+	//****************************************************************************
+	// Axis-aligned bounding box
+
+	struct AABB
+	{
+		Vector3 min;
+		Vector3 max;
+
+		// Constructors
+		AABB() noexcept = default;
+		AABB(const Vector3& minimum, const Vector3& maximum) noexcept : min(minimum), max(maximum) {}
+
+		[[nodiscard]] Vector3 Center() const noexcept { return (min + max) * 0.5f; }
+		[[nodiscard]] Vector3 Extents() const noexcept { return (max - min) * 0.5f; }
+		[[nodiscard]] float SurfaceArea() const noexcept;
+
+		// Queries
+		[[nodiscard]] bool Contains(const Vector3& point) const noexcept;
+		[[nodiscard]] bool Intersects(const AABB& box) const noexcept;
+		[[nodiscard]] bool Intersects(const BoundingSphere& S) const noexcept;
+
+		// Box enclosing the transformed box
+		[[nodiscard]] AABB Transform(const Matrix& M) const noexcept;
+
+		// Static functions
+		static AABB CreateFromPoints(std::span<const Vector3> points) noexcept;
+		static AABB CreateMerged(const AABB& B1, const AABB& B2) noexcept;
+	};
+
+
+	//****************************************************************************
+	// Oriented bounding box
+
+	struct OBB
+	{
+		Vector3 center;
+		Vector3 extents;
+		Quaternion orientation;
+
+		// Constructors
+		OBB() noexcept = default;
+		OBB(const Vector3& c, const Vector3& e, const Quaternion& q) noexcept : center(c), extents(e), orientation(q) {}
+
+		// Queries
+		[[nodiscard]] bool Contains(const Vector3& point) const noexcept;
+		// Separating axis test over the 15 candidate axes
+		[[nodiscard]] bool Intersects(const OBB& box) const noexcept;
+
+		// Axis-aligned box enclosing this one
+		[[nodiscard]] AABB ToAABB() const noexcept;
+
+		// Exact for rotation, translation and uniform scale
+		[[nodiscard]] OBB Transform(const Matrix& M) const noexcept;
+
+		// Static functions
+		static OBB CreateFromAABB(const AABB& box) noexcept;
+
+		// Principal component fit: the axes are the eigenvectors of the points' covariance, largest
+		// spread first. Tight for elongated clouds, though not the minimal box.
+		static OBB CreateFromPoints(std::span<const Vector3> points) noexcept;
+
+		// Fits set i, points[offsets[i]] up to points[offsets[i + 1]], into result[i]; offsets has
+		// one more entry than result. The eigen decompositions run 8 sets at a time on AVX2.
+		static void CreateFromPointsBatch(std::span<const Vector3> points, std::span<const uint32_t> offsets, std::span<OBB> result) noexcept;
+		static void CreateFromPointsBatch(const Parallel::ParallelPolicy& policy, std::span<const Vector3> points, std::span<const uint32_t> offsets,
+		                                  std::span<OBB> result) noexcept;
+	};
+
+
+	//****************************************************************************
+	// Frustum
+	// Six planes (nx, ny, nz, d) with normals pointing inside: dot(n, p) + d >= 0 for inner points.
+
+	struct Frustum
+	{
+		enum Plane
+		{
+			Left,
+			Right,
+			Bottom,
+			Top,
+			Near,
+			Far,
+			PlaneCount
+		};
+
+		XMFLOAT4 planes[PlaneCount] = {};
+
+		// Queries
+		[[nodiscard]] bool Contains(const Vector3& point) const noexcept;
+		[[nodiscard]] bool Intersects(const BoundingSphere& S) const noexcept;
+		[[nodiscard]] bool Intersects(const AABB& box) const noexcept;
+		[[nodiscard]] bool Intersects(const OBB& box) const noexcept;
+
+		// Batch culling. The mask variants set bit i of visibleMask when volume i intersects the
+		// frustum and need (count + 63) / 64 words; the index variants write the indices of the
+		// visible volumes in increasing order, need room for count of them and return how many
+		// were written. Conservative like Intersects: boxes near a frustum corner may pass.
+		void Cull(std::span<const AABB> boxes, std::span<uint64_t> visibleMask) const noexcept;
+		size_t Cull(std::span<const AABB> boxes, std::span<uint32_t> visibleIndices) const noexcept;
+		void Cull(std::span<const BoundingSphere> spheres, std::span<uint64_t> visibleMask) const noexcept;
+		size_t Cull(std::span<const BoundingSphere> spheres, std::span<uint32_t> visibleIndices) const noexcept;
+
+		void Cull(const Parallel::ParallelPolicy& policy, std::span<const AABB> boxes, std::span<uint64_t> visibleMask) const noexcept;
+		void Cull(const Parallel::ParallelPolicy& policy, std::span<const BoundingSphere> spheres, std::span<uint64_t> visibleMask) const noexcept;
+
+		// Static functions
+		// Planes of a view-projection matrix with clip space depth in [0, w]
+		static Frustum FromMatrix(const Matrix& viewProjection) noexcept;
+	};
+}
@@ -0,0 +1,207 @@
+#include "PMathCpu.h"
+
+#if PMATH_X86
+#include <bit>
+#include <cstring>
+
+#include "PMathAVX2.h"
+#include "PMathKernels.h"
+
+namespace PMgene::Math::Detail::AVX2
+{
+	namespace
+	{
+		constexpr int PlaneCount = 6;
+
+		struct Planes
+		{
+			__m256 nx[PlaneCount];
+			__m256 ny[PlaneCount];
+			__m256 nz[PlaneCount];
+			__m256 d[PlaneCount];
+
+			explicit Planes(const float* planes) noexcept
+			{
+				for (int k = 0; k < PlaneCount; ++k)
+				{
+					nx[k] = _mm256_broadcast_ss(planes + 4 * k);
+					ny[k] = _mm256_broadcast_ss(planes + 4 * k + 1);
+					nz[k] = _mm256_broadcast_ss(planes + 4 * k + 2);
+					d[k] = _mm256_broadcast_ss(planes + 4 * k + 3);
+				}
+			}
+		};
+
+		// Lane numbers of the set bits of every 8-bit mask, one byte each, for left-packing indices
+		struct CompressTable
+		{
+			uint64_t lanes[256] = {};
+
+			constexpr CompressTable() noexcept
+			{
+				for (int mask = 0; mask < 256; ++mask)
+				{
+					int count = 0;
+					for (int lane = 0; lane < 8; ++lane)
+					{
+						if (mask & (1 << lane))
+							lanes[mask] |= uint64_t(lane) << (8 * count++);
+					}
+				}
+			}
+		};
+
+		constexpr CompressTable Compress;
+
+		// Visibility of 8 boxes as a bit mask, bit i for box i
+		struct AABB8
+		{
+			static constexpr size_t Stride = 6;
+
+			static uint32_t Test(const Planes& P, const float* boxes) noexcept
+			{
+				// Boxes are pairs of XMFLOAT3, min in the even and max in the odd positions
+				__m256 x0, y0, z0, x1, y1, z1;
+				LoadAoS8(boxes, x0, y0, z0);
+				LoadAoS8(boxes + 24, x1, y1, z1);
+
+				// Lanes hold boxes 0, 1, 4, 5, 2, 3, 6, 7
+				const __m256 minX = _mm256_shuffle_ps(x0, x1, _MM_SHUFFLE(2, 0, 2, 0));
+				const __m256 minY = _mm256_shuffle_ps(y0, y1, _MM_SHUFFLE(2, 0, 2, 0));
+				const __m256 minZ = _mm256_shuffle_ps(z0, z1, _MM_SHUFFLE(2, 0, 2, 0));
+				const __m256 maxX = _mm256_shuffle_ps(x0, x1, _MM_SHUFFLE(3, 1, 3, 1));
+				const __m256 maxY = _mm256_shuffle_ps(y0, y1, _MM_SHUFFLE(3, 1, 3, 1));
+				const __m256 maxZ = _mm256_shuffle_ps(z0, z1, _MM_SHUFFLE(3, 1, 3, 1));
+
+				__m256 outside = _mm256_setzero_ps();
+				for (int k = 0; k < PlaneCount; ++k)
+				{
+					// Corner furthest along the normal: min where the normal component is negative
+					const __m256 px = _mm256_blendv_ps(maxX, minX, P.nx[k]);
+					const __m256 py = _mm256_blendv_ps(maxY, minY, P.ny[k]);
+					const __m256 pz = _mm256_blendv_ps(maxZ, minZ, P.nz[k]);
+
+					__m256 distance = _mm256_fmadd_ps(P.nz[k], pz, P.d[k]);
+					distance = _mm256_fmadd_ps(P.ny[k], py, distance);
+					distance = _mm256_fmadd_ps(P.nx[k], px, distance);
+					outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_LT_OQ));
+				}
+
+				const uint32_t visible = ~uint32_t(_mm256_movemask_ps(outside)) & 0xFF;
+				return (visible & 0xC3) | ((visible & 0x0C) << 2) | ((visible & 0x30) >> 2);
+			}
+		};
+
+		// Visibility of 8 spheres as a bit mask, bit i for sphere i
+		struct Sphere8
+		{
+			static constexpr size_t Stride = 4;
+
+			static uint32_t Test(const Planes& P, const float* spheres) noexcept
+			{
+				// Two 4x4 transposes side by side, spheres 0-3 in the low and 4-7 in the high half
+				const __m256 s04 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(spheres)), _mm_loadu_ps(spheres + 16), 1);
+				const __m256 s15 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(spheres + 4)), _mm_loadu_ps(spheres + 20), 1);
+				const __m256 s26 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(spheres + 8)), _mm_loadu_ps(spheres + 24), 1);
+				const __m256 s37 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(spheres + 12)), _mm_loadu_ps(spheres + 28), 1);
+
+				const __m256 xy01 = _mm256_unpacklo_ps(s04, s15);
+				const __m256 xy23 = _mm256_unpacklo_ps(s26, s37);
+				const __m256 zr01 = _mm256_unpackhi_ps(s04, s15);
+				const __m256 zr23 = _mm256_unpackhi_ps(s26, s37);
+
+				const __m256 x = _mm256_shuffle_ps(xy01, xy23, _MM_SHUFFLE(1, 0, 1, 0));
+				const __m256 y = _mm256_shuffle_ps(xy01, xy23, _MM_SHUFFLE(3, 2, 3, 2));
+				const __m256 z = _mm256_shuffle_ps(zr01, zr23, _MM_SHUFFLE(1, 0, 1, 0));
+				const __m256 r = _mm256_shuffle_ps(zr01, zr23, _MM_SHUFFLE(3, 2, 3, 2));
+
+				__m256 outside = _mm256_setzero_ps();
+				for (int k = 0; k < PlaneCount; ++k)
+				{
+					__m256 distance = _mm256_fmadd_ps(P.nz[k], z, P.d[k]);
+					distance = _mm256_fmadd_ps(P.ny[k], y, distance);
+					distance = _mm256_fmadd_ps(P.nx[k], x, distance);
+					outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, r), _mm256_setzero_ps(), _CMP_LT_OQ));
+				}
+
+				return ~uint32_t(_mm256_movemask_ps(outside)) & 0xFF;
+			}
+		};
+
+		// Tests the last count % 8 volumes from a zero-padded copy
+		template <typename Block>
+		uint32_t TestTail(const Planes& P, const float* volumes, size_t count) noexcept
+		{
+			float padded[8 * Block::Stride] = {};
+			std::memcpy(padded, volumes, count * Block::Stride * sizeof(float));
+			return Block::Test(P, padded) & ((1u << count) - 1);
+		}
+
+		template <typename Block>
+		void CullMask(const float* planes, const float* volumes, uint64_t* mask, size_t count) noexcept
+		{
+			const Planes P(planes);
+			for (size_t base = 0; base < count; base += 64)
+			{
+				const size_t end = count - base < 64 ? count - base : 64;
+				const float* block = volumes + base * Block::Stride;
+
+				uint64_t bits = 0;
+				size_t i = 0;
+				for (; i + 8 <= end; i += 8)
+					bits |= uint64_t(Block::Test(P, block + i * Block::Stride)) << i;
+				if (i < end)
+					bits |= uint64_t(TestTail<Block>(P, block + i * Block::Stride, end - i)) << i;
+				mask[base / 64] = bits;
+			}
+		}
+
+		template <typename Block>
+		size_t CullIndices(const float* planes, const float* volumes, uint32_t* indices, size_t count) noexcept
+		{
+			const Planes P(planes);
+			__m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+			// Full blocks store 8 indices and advance by the visible count. The store never reaches
+			// past i + 8, and the output always has room for every index.
+			size_t visible = 0;
+			size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const uint32_t bits = Block::Test(P, volumes + i * Block::Stride);
+				const __m256i lanes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Compress.lanes + bits)));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(indices + visible), _mm256_permutevar8x32_epi32(index, lanes));
+				visible += std::popcount(bits);
+				index = _mm256_add_epi32(index, _mm256_set1_epi32(8));
+			}
+
+			if (i < count)
+			{
+				for (uint32_t bits = TestTail<Block>(P, volumes + i * Block::Stride, count - i); bits != 0; bits &= bits - 1)
+					indices[visible++] = static_cast<uint32_t>(i + std::countr_zero(bits));
+			}
+			return visible;
+		}
+	}
+
+	void FrustumCullAABBMask(const float* planes, const float* boxes, uint64_t* mask, size_t count) noexcept
+	{
+		CullMask<AABB8>(planes, boxes, mask, count);
+	}
+
+	size_t FrustumCullAABBIndices(const float* planes, const float* boxes, uint32_t* indices, size_t count) noexcept
+	{
+		return CullIndices<AABB8>(planes, boxes, indices, count);
+	}
+
+	void FrustumCullSphereMask(const float* planes, const float* spheres, uint64_t* mask, size_t count) noexcept
+	{
+		CullMask<Sphere8>(planes, spheres, mask, count);
+	}
+
+	size_t FrustumCullSphereIndices(const float* planes, const float* spheres, uint32_t* indices, size_t count) noexcept
+	{
+		return CullIndices<Sphere8>(planes, spheres, indices, count);
+	}
+}
+#endif
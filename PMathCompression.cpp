@@ -0,0 +1,492 @@
+#include "PMathCompression.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+
+#include "PMath.inl"
+#include "PMathCpu.h"
+#include "PMathKernels.h"
+
+namespace PMgene::Math
+{
+	//****************************************************************************
+	// Portable kernels. The AVX2 kernels follow the same steps in the same order, so encoding
+	// yields the same bits on both paths.
+
+	namespace Detail::Generic
+	{
+		namespace
+		{
+			constexpr float InvSqrt2 = 0.707106781f;
+
+			// Components of a unit quaternion other than the largest lie within +-1/sqrt(2). Codes are
+			// symmetric around the middle one, so zero components stay exact.
+			template <int Bits>
+			struct SmallestThree
+			{
+				static constexpr uint32_t Mask = (1u << Bits) - 1;
+				static constexpr int32_t Zero = (1 << (Bits - 1)) - 1;
+				static constexpr float Scale = Zero / InvSqrt2;
+				static constexpr float Step = InvSqrt2 / Zero;
+
+				uint32_t index;
+				uint32_t a, b, c;
+
+				static uint32_t Quantize(float v) noexcept
+				{
+					const float code = std::clamp(std::nearbyint(v * Scale), static_cast<float>(-Zero), static_cast<float>(Zero));
+					return static_cast<uint32_t>(static_cast<int32_t>(code) + Zero);
+				}
+
+				static float Dequantize(uint32_t code) noexcept
+				{
+					return static_cast<float>(static_cast<int32_t>(code) - Zero) * Step;
+				}
+
+				// Picks the largest magnitude, the first one on ties, and flips the sign so it is positive
+				static SmallestThree Encode(const float* q) noexcept
+				{
+					const float ax = std::fabs(q[0]), ay = std::fabs(q[1]), az = std::fabs(q[2]), aw = std::fabs(q[3]);
+					const uint32_t i01 = ay > ax ? 1 : 0;
+					const uint32_t i23 = aw > az ? 3 : 2;
+					const uint32_t index = std::max(az, aw) > std::max(ax, ay) ? i23 : i01;
+					const float sign = q[index] < 0.f ? -1.f : 1.f;
+
+					const float a = index == 0 ? q[1] : q[0];
+					const float b = index <= 1 ? q[2] : q[1];
+					const float c = index <= 2 ? q[3] : q[2];
+					return { index, Quantize(a * sign), Quantize(b * sign), Quantize(c * sign) };
+				}
+
+				void Decode(float* q) const noexcept
+				{
+					const float fa = Dequantize(a), fb = Dequantize(b), fc = Dequantize(c);
+					const float largest = std::sqrt(std::fmax(1.f - (fa * fa + fb * fb + fc * fc), 0.f));
+
+					q[0] = index == 0 ? largest : fa;
+					q[1] = index == 0 ? fa : index == 1 ? largest : fb;
+					q[2] = index <= 1 ? fb : index == 2 ? largest : fc;
+					q[3] = index == 3 ? largest : fc;
+				}
+			};
+
+			using SmallestThree48 = SmallestThree<15>;
+			using SmallestThree32 = SmallestThree<10>;
+
+			// Rounds to nearest even like F16C; NaN stays NaN and overflow becomes infinity
+			uint16_t FloatToHalf(float value) noexcept
+			{
+				const uint32_t bits = std::bit_cast<uint32_t>(value);
+				const uint32_t sign = (bits >> 16) & 0x8000u;
+				const uint32_t magnitude = bits & 0x7FFFFFFFu;
+
+				if (magnitude > 0x7F800000u)
+					return static_cast<uint16_t>(sign | 0x7E00u | ((magnitude >> 13) & 0x3FFu));
+				// At or above 65520, halfway between 65504 and the next power of two
+				if (magnitude >= 0x477FF000u)
+					return static_cast<uint16_t>(sign | 0x7C00u);
+				// Normal halves: rebias the exponent and round the mantissa, carrying into the exponent
+				if (magnitude >= 0x38800000u)
+				{
+					const uint32_t rebiased = magnitude - 0x38000000u;
+					return static_cast<uint16_t>(sign | ((rebiased + 0xFFFu + ((rebiased >> 13) & 1u)) >> 13));
+				}
+				// Subnormal halves count multiples of 2^-24; the scaling is exact
+				return static_cast<uint16_t>(sign | static_cast<uint32_t>(std::nearbyint(std::bit_cast<float>(magnitude) * 16777216.f)));
+			}
+
+			float HalfToFloat(uint16_t half) noexcept
+			{
+				const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+				const uint32_t exponent = (half >> 10) & 0x1Fu;
+				const uint32_t mantissa = half & 0x3FFu;
+
+				if (exponent == 0x1F)
+					return std::bit_cast<float>(sign | 0x7F800000u | (mantissa << 13));
+				if (exponent == 0)
+					return std::copysign(static_cast<float>(mantissa) * 5.96046448e-8f, std::bit_cast<float>(sign));
+				return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+			}
+
+			template <typename Code, int Min, int Max>
+			void Encode16(const float* input, const float* offset, const float* scale, Code* output, size_t count) noexcept
+			{
+				for (size_t i = 0; i < count * 3; ++i)
+				{
+					const float code = std::nearbyint((input[i] - offset[i % 3]) * scale[i % 3]);
+					output[i] = static_cast<Code>(std::clamp(code, static_cast<float>(Min), static_cast<float>(Max)));
+				}
+			}
+
+			template <typename Code>
+			void Decode16(const Code* input, const float* offset, const float* step, float* output, size_t count) noexcept
+			{
+				for (size_t i = 0; i < count * 3; ++i)
+					output[i] = static_cast<float>(input[i]) * step[i % 3] + offset[i % 3];
+			}
+		}
+
+		void QuaternionEncode48(const float* input, uint16_t* output, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const SmallestThree48 packed = SmallestThree48::Encode(input + i * 4);
+				output[i * 3] = static_cast<uint16_t>(packed.a << 1 | (packed.index & 1));
+				output[i * 3 + 1] = static_cast<uint16_t>(packed.b << 1 | packed.index >> 1);
+				output[i * 3 + 2] = static_cast<uint16_t>(packed.c << 1);
+			}
+		}
+
+		void QuaternionDecode48(const uint16_t* input, float* output, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const uint32_t a = input[i * 3], b = input[i * 3 + 1], c = input[i * 3 + 2];
+				const SmallestThree48 packed = { (a & 1) | (b & 1) << 1, a >> 1, b >> 1, c >> 1 };
+				packed.Decode(output + i * 4);
+			}
+		}
+
+		void QuaternionEncode32(const float* input, uint32_t* output, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const SmallestThree32 packed = SmallestThree32::Encode(input + i * 4);
+				output[i] = packed.a | packed.b << 10 | packed.c << 20 | packed.index << 30;
+			}
+		}
+
+		void QuaternionDecode32(const uint32_t* input, float* output, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const uint32_t bits = input[i];
+				const SmallestThree32 packed = { bits >> 30, bits & SmallestThree32::Mask, (bits >> 10) & SmallestThree32::Mask,
+				                                 (bits >> 20) & SmallestThree32::Mask };
+				packed.Decode(output + i * 4);
+			}
+		}
+
+		void Vector3EncodeHalf(const float* input, uint16_t* output, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count * 3; ++i)
+				output[i] = FloatToHalf(input[i]);
+		}
+
+		void Vector3DecodeHalf(const uint16_t* input, float* output, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count * 3; ++i)
+				output[i] = HalfToFloat(input[i]);
+		}
+
+		void Vector3EncodeUnorm16(const float* input, const float* offset, const float* scale, uint16_t* output, size_t count) noexcept
+		{
+			Encode16<uint16_t, 0, 65535>(input, offset, scale, output, count);
+		}
+
+		void Vector3DecodeUnorm16(const uint16_t* input, const float* offset, const float* step, float* output, size_t count) noexcept
+		{
+			Decode16(input, offset, step, output, count);
+		}
+
+		void Vector3EncodeSnorm16(const float* input, const float* offset, const float* scale, int16_t* output, size_t count) noexcept
+		{
+			Encode16<int16_t, -32767, 32767>(input, offset, scale, output, count);
+		}
+
+		void Vector3DecodeSnorm16(const int16_t* input, const float* offset, const float* step, float* output, size_t count) noexcept
+		{
+			Decode16(input, offset, step, output, count);
+		}
+	}
+
+	//****************************************************************************
+	// Packed formats
+
+	namespace
+	{
+		static_assert(sizeof(PackedQuaternion48) == 6 && sizeof(PackedQuaternion32) == 4, "Packed quaternions must be tightly packed");
+		static_assert(sizeof(PackedVector3Half) == 6 && sizeof(PackedVector3Unorm16) == 6 && sizeof(PackedVector3Snorm16) == 6,
+		              "Packed vectors must be tightly packed");
+
+		// Encoding and decoding parameters for every axis of a box
+		struct Quantization
+		{
+			float offset[3];
+			float scale[3];
+			float step[3];
+
+			Quantization(const Vector3& origin, const Vector3& size, float maxCode) noexcept
+			{
+				const float origins[3] = { origin.x, origin.y, origin.z };
+				const float sizes[3] = { size.x, size.y, size.z };
+				for (int k = 0; k < 3; ++k)
+				{
+					offset[k] = origins[k];
+					scale[k] = sizes[k] > 0.f ? maxCode / sizes[k] : 0.f;
+					step[k] = sizes[k] > 0.f ? sizes[k] / maxCode : 0.f;
+				}
+			}
+		};
+
+		Quantization Unorm16(const AABB& range) noexcept
+		{
+			return Quantization(range.min, range.max - range.min, 65535.f);
+		}
+
+		Quantization Snorm16(const AABB& range) noexcept
+		{
+			return Quantization(range.Center(), range.Extents(), 32767.f);
+		}
+
+		const float* Data(std::span<const Quaternion> Q) noexcept
+		{
+			return reinterpret_cast<const float*>(Q.data());
+		}
+
+		float* Data(std::span<Quaternion> Q) noexcept
+		{
+			return reinterpret_cast<float*>(Q.data());
+		}
+
+		const float* Data(std::span<const Vector3> V) noexcept
+		{
+			return reinterpret_cast<const float*>(V.data());
+		}
+
+		float* Data(std::span<Vector3> V) noexcept
+		{
+			return reinterpret_cast<float*>(V.data());
+		}
+	}
+
+	Quaternion PackedQuaternion48::Decode() const noexcept
+	{
+		Quaternion Q;
+		Detail::Generic::QuaternionDecode48(bits, &Q.x, 1);
+		return Q;
+	}
+
+	PackedQuaternion48 PackedQuaternion48::Encode(const Quaternion& Q) noexcept
+	{
+		PackedQuaternion48 P;
+		Detail::Generic::QuaternionEncode48(&Q.x, P.bits, 1);
+		return P;
+	}
+
+	void PackedQuaternion48::Encode(std::span<const Quaternion> input, std::span<PackedQuaternion48> output) noexcept
+	{
+		assert(input.size() == output.size());
+
+		uint16_t* bits = reinterpret_cast<uint16_t*>(output.data());
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::QuaternionEncode48(Data(input), bits, input.size());
+			return;
+		}
+#endif
+		Detail::Generic::QuaternionEncode48(Data(input), bits, input.size());
+	}
+
+	void PackedQuaternion48::Decode(std::span<const PackedQuaternion48> input, std::span<Quaternion> output) noexcept
+	{
+		assert(input.size() == output.size());
+
+		const uint16_t* bits = reinterpret_cast<const uint16_t*>(input.data());
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::QuaternionDecode48(bits, Data(output), input.size());
+			return;
+		}
+#endif
+		Detail::Generic::QuaternionDecode48(bits, Data(output), input.size());
+	}
+
+	Quaternion PackedQuaternion32::Decode() const noexcept
+	{
+		Quaternion Q;
+		Detail::Generic::QuaternionDecode32(&bits, &Q.x, 1);
+		return Q;
+	}
+
+	PackedQuaternion32 PackedQuaternion32::Encode(const Quaternion& Q) noexcept
+	{
+		PackedQuaternion32 P;
+		Detail::Generic::QuaternionEncode32(&Q.x, &P.bits, 1);
+		return P;
+	}
+
+	void PackedQuaternion32::Encode(std::span<const Quaternion> input, std::span<PackedQuaternion32> output) noexcept
+	{
+		assert(input.size() == output.size());
+
+		uint32_t* bits = reinterpret_cast<uint32_t*>(output.data());
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::QuaternionEncode32(Data(input), bits, input.size());
+			return;
+		}
+#endif
+		Detail::Generic::QuaternionEncode32(Data(input), bits, input.size());
+	}
+
+	void PackedQuaternion32::Decode(std::span<const PackedQuaternion32> input, std::span<Quaternion> output) noexcept
+	{
+		assert(input.size() == output.size());
+
+		const uint32_t* bits = reinterpret_cast<const uint32_t*>(input.data());
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::QuaternionDecode32(bits, Data(output), input.size());
+			return;
+		}
+#endif
+		Detail::Generic::QuaternionDecode32(bits, Data(output), input.size());
+	}
+
+	Vector3 PackedVector3Half::Decode() const noexcept
+	{
+		Vector3 V;
+		Detail::Generic::Vector3DecodeHalf(&x, &V.x, 1);
+		return V;
+	}
+
+	PackedVector3Half PackedVector3Half::Encode(const Vector3& V) noexcept
+	{
+		PackedVector3Half P;
+		Detail::Generic::Vector3EncodeHalf(&V.x, &P.x, 1);
+		return P;
+	}
+
+	void PackedVector3Half::Encode(std::span<const Vector3> input, std::span<PackedVector3Half> output) noexcept
+	{
+		assert(input.size() == output.size());
+
+		uint16_t* halves = reinterpret_cast<uint16_t*>(output.data());
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector3EncodeHalf(Data(input), halves, input.size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector3EncodeHalf(Data(input), halves, input.size());
+	}
+
+	void PackedVector3Half::Decode(std::span<const PackedVector3Half> input, std::span<Vector3> output) noexcept
+	{
+		assert(input.size() == output.size());
+
+		const uint16_t* halves = reinterpret_cast<const uint16_t*>(input.data());
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector3DecodeHalf(halves, Data(output), input.size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector3DecodeHalf(halves, Data(output), input.size());
+	}
+
+	Vector3 PackedVector3Unorm16::Decode(const AABB& range) const noexcept
+	{
+		const Quantization Q = Unorm16(range);
+		Vector3 V;
+		Detail::Generic::Vector3DecodeUnorm16(&x, Q.offset, Q.step, &V.x, 1);
+		return V;
+	}
+
+	PackedVector3Unorm16 PackedVector3Unorm16::Encode(const AABB& range, const Vector3& V) noexcept
+	{
+		const Quantization Q = Unorm16(range);
+		PackedVector3Unorm16 P;
+		Detail::Generic::Vector3EncodeUnorm16(&V.x, Q.offset, Q.scale, &P.x, 1);
+		return P;
+	}
+
+	void PackedVector3Unorm16::Encode(const AABB& range, std::span<const Vector3> input, std::span<PackedVector3Unorm16> output) noexcept
+	{
+		assert(input.size() == output.size());
+
+		const Quantization Q = Unorm16(range);
+		uint16_t* codes = reinterpret_cast<uint16_t*>(output.data());
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector3EncodeUnorm16(Data(input), Q.offset, Q.scale, codes, input.size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector3EncodeUnorm16(Data(input), Q.offset, Q.scale, codes, input.size());
+	}
+
+	void PackedVector3Unorm16::Decode(const AABB& range, std::span<const PackedVector3Unorm16> input, std::span<Vector3> output) noexcept
+	{
+		assert(input.size() == output.size());
+
+		const Quantization Q = Unorm16(range);
+		const uint16_t* codes = reinterpret_cast<const uint16_t*>(input.data());
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector3DecodeUnorm16(codes, Q.offset, Q.step, Data(output), input.size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector3DecodeUnorm16(codes, Q.offset, Q.step, Data(output), input.size());
+	}
+
+	Vector3 PackedVector3Snorm16::Decode(const AABB& range) const noexcept
+	{
+		const Quantization Q = Snorm16(range);
+		Vector3 V;
+		Detail::Generic::Vector3DecodeSnorm16(&x, Q.offset, Q.step, &V.x, 1);
+		return V;
+	}
+
+	PackedVector3Snorm16 PackedVector3Snorm16::Encode(const AABB& range, const Vector3& V) noexcept
+	{
+		const Quantization Q = Snorm16(range);
+		PackedVector3Snorm16 P;
+		Detail::Generic::Vector3EncodeSnorm16(&V.x, Q.offset, Q.scale, &P.x, 1);
+		return P;
+	}
+
+	void PackedVector3Snorm16::Encode(const AABB& range, std::span<const Vector3> input, std::span<PackedVector3Snorm16> output) noexcept
+	{
+		assert(input.size() == output.size());
+
+		const Quantization Q = Snorm16(range);
+		int16_t* codes = reinterpret_cast<int16_t*>(output.data());
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector3EncodeSnorm16(Data(input), Q.offset, Q.scale, codes, input.size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector3EncodeSnorm16(Data(input), Q.offset, Q.scale, codes, input.size());
+	}
+
+	void PackedVector3Snorm16::Decode(const AABB& range, std::span<const PackedVector3Snorm16> input, std::span<Vector3> output) noexcept
+	{
+		assert(input.size() == output.size());
+
+		const Quantization Q = Snorm16(range);
+		const int16_t* codes = reinterpret_cast<const int16_t*>(input.data());
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector3DecodeSnorm16(codes, Q.offset, Q.step, Data(output), input.size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector3DecodeSnorm16(codes, Q.offset, Q.step, Data(output), input.size());
+	}
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <cstdint>
+#include <span>
+
+#include "PMath.h"
+#include "PMathBounds.h"
+
+namespace PMgene::Math
+{
+	//****************************************************************************
+	// Packed formats
+	// Compact storage for rotations and vectors, 2-4 times smaller than Quaternion and Vector3.
+	// The batch functions run on AVX2 kernels, 8 values per iteration, or a portable fallback; both
+	// round to nearest even and encode to the same bits. Error bounds are per component and were
+	// measured over a million random inputs.
+
+
+	//****************************************************************************
+	// Smallest-three quaternions
+	// A unit quaternion is stored as its three smallest components, each within +-1/sqrt(2), plus
+	// the index of the largest one, rebuilt as sqrt(1 - a^2 - b^2 - c^2). The sign is chosen so the
+	// largest component is positive, which represents the same rotation. Codes are symmetric, so
+	// zero components such as those of the identity decode exactly. Decoding always yields a unit
+	// quaternion; encoding expects one.
+
+	// 6 bytes. Each word holds a 15-bit component in its upper bits; the low bits of the first two
+	// words hold the index. Error within 7e-5.
+	struct PackedQuaternion48
+	{
+		uint16_t bits[3];
+
+		[[nodiscard]] Quaternion Decode() const noexcept;
+		[[nodiscard]] static PackedQuaternion48 Encode(const Quaternion& Q) noexcept;
+
+		// Both spans must have the same size
+		static void Encode(std::span<const Quaternion> input, std::span<PackedQuaternion48> output) noexcept;
+		static void Decode(std::span<const PackedQuaternion48> input, std::span<Quaternion> output) noexcept;
+	};
+
+	// 4 bytes, 10 bits per component and the index in the top two bits. Error within 2e-3.
+	struct PackedQuaternion32
+	{
+		uint32_t bits;
+
+		[[nodiscard]] Quaternion Decode() const noexcept;
+		[[nodiscard]] static PackedQuaternion32 Encode(const Quaternion& Q) noexcept;
+
+		// Both spans must have the same size
+		static void Encode(std::span<const Quaternion> input, std::span<PackedQuaternion32> output) noexcept;
+		static void Decode(std::span<const PackedQuaternion32> input, std::span<Quaternion> output) noexcept;
+	};
+
+
+	//****************************************************************************
+	// Half-precision vectors
+	// IEEE 754 binary16 per component, as F16C and XMConvertFloatToHalf store them: relative error
+	// within 2^-11 for normal values, magnitudes up to 65504, larger ones become infinity.
+
+	// 6 bytes
+	struct PackedVector3Half
+	{
+		uint16_t x;
+		uint16_t y;
+		uint16_t z;
+
+		[[nodiscard]] Vector3 Decode() const noexcept;
+		[[nodiscard]] static PackedVector3Half Encode(const Vector3& V) noexcept;
+
+		// Both spans must have the same size
+		static void Encode(std::span<const Vector3> input, std::span<PackedVector3Half> output) noexcept;
+		static void Decode(std::span<const PackedVector3Half> input, std::span<Vector3> output) noexcept;
+	};
+
+
+	//****************************************************************************
+	// Quantized vectors
+	// 16-bit fixed point per component within a box, usually the bounds of a mesh or of a track.
+	// Values outside the box are clamped to it. The error is within half a step plus float rounding,
+	// about size / 131000 per axis. Snorm16 spends one code less but decodes the box center exactly.
+	// Flat axes decode to the box.
+
+	// 6 bytes, 0 at range.min to 65535 at range.max
+	struct PackedVector3Unorm16
+	{
+		uint16_t x;
+		uint16_t y;
+		uint16_t z;
+
+		[[nodiscard]] Vector3 Decode(const AABB& range) const noexcept;
+		[[nodiscard]] static PackedVector3Unorm16 Encode(const AABB& range, const Vector3& V) noexcept;
+
+		// Both spans must have the same size
+		static void Encode(const AABB& range, std::span<const Vector3> input, std::span<PackedVector3Unorm16> output) noexcept;
+		static void Decode(const AABB& range, std::span<const PackedVector3Unorm16> input, std::span<Vector3> output) noexcept;
+	};
+
+	// 6 bytes, -32767 at range.min to 32767 at range.max
+	struct PackedVector3Snorm16
+	{
+		int16_t x;
+		int16_t y;
+		int16_t z;
+
+		[[nodiscard]] Vector3 Decode(const AABB& range) const noexcept;
+		[[nodiscard]] static PackedVector3Snorm16 Encode(const AABB& range, const Vector3& V) noexcept;
+
+		// Both spans must have the same size
+		static void Encode(const AABB& range, std::span<const Vector3> input, std::span<PackedVector3Snorm16> output) noexcept;
+		static void Decode(const AABB& range, std::span<const PackedVector3Snorm16> input, std::span<Vector3> output) noexcept;
+	};
+}
@@ -0,0 +1,355 @@
+#include "PMathCpu.h"
+
+#if PMATH_X86
+#include <cstring>
+#include <type_traits>
+
+#include "PMathAVX2.h"
+#include "PMathKernels.h"
+
+namespace PMgene::Math::Detail::AVX2
+{
+	namespace
+	{
+		constexpr float InvSqrt2 = 0.707106781f;
+
+		// Runs block(input, output) on 8 values at a time, each 'InputSize' and 'OutputSize' scalars
+		// wide. The last partial block runs on zero-padded copies, so blocks never touch memory past
+		// the arrays.
+		template <size_t InputSize, size_t OutputSize, typename Input, typename Output, typename Block>
+		inline void ForEachBlock8(const Input* input, Output* output, size_t count, Block&& block) noexcept
+		{
+			size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+				block(input + i * InputSize, output + i * OutputSize);
+
+			if (i < count)
+			{
+				Input paddedInput[8 * InputSize] = {};
+				Output paddedOutput[8 * OutputSize];
+				std::memcpy(paddedInput, input + i * InputSize, (count - i) * InputSize * sizeof(Input));
+				block(paddedInput, paddedOutput);
+				std::memcpy(output + i * OutputSize, paddedOutput, (count - i) * OutputSize * sizeof(Output));
+			}
+		}
+
+		//****************************************************************************
+		// Smallest-three quaternions
+
+		template <int Bits>
+		struct SmallestThree8
+		{
+			static constexpr int Zero = (1 << (Bits - 1)) - 1;
+
+			__m256i index;
+			__m256i a, b, c;
+
+			static __m256i Quantize(__m256 v) noexcept
+			{
+				const __m256 code = _mm256_round_ps(_mm256_mul_ps(v, _mm256_set1_ps(Zero / InvSqrt2)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+				const __m256 clamped = _mm256_min_ps(_mm256_max_ps(code, _mm256_set1_ps(-Zero)), _mm256_set1_ps(Zero));
+				return _mm256_add_epi32(_mm256_cvttps_epi32(clamped), _mm256_set1_epi32(Zero));
+			}
+
+			static __m256 Dequantize(__m256i code) noexcept
+			{
+				return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(code, _mm256_set1_epi32(Zero))), _mm256_set1_ps(InvSqrt2 / Zero));
+			}
+
+			// Same selection as the generic kernel: the largest magnitude, the first one on ties
+			static SmallestThree8 Encode(const float* q) noexcept
+			{
+				__m256 x, y, z, w;
+				LoadAoS8x4(q, x, y, z, w);
+
+				const __m256 signMask = _mm256_set1_ps(-0.f);
+				const __m256 ax = _mm256_andnot_ps(signMask, x), ay = _mm256_andnot_ps(signMask, y);
+				const __m256 az = _mm256_andnot_ps(signMask, z), aw = _mm256_andnot_ps(signMask, w);
+				const __m256 gt01 = _mm256_cmp_ps(ay, ax, _CMP_GT_OQ);
+				const __m256 gt23 = _mm256_cmp_ps(aw, az, _CMP_GT_OQ);
+				const __m256 gt = _mm256_cmp_ps(_mm256_max_ps(az, aw), _mm256_max_ps(ax, ay), _CMP_GT_OQ);
+
+				const __m256i one = _mm256_set1_epi32(1);
+				const __m256i i01 = _mm256_and_si256(_mm256_castps_si256(gt01), one);
+				const __m256i i23 = _mm256_add_epi32(_mm256_and_si256(_mm256_castps_si256(gt23), one), _mm256_set1_epi32(2));
+				const __m256i index = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(i01), _mm256_castsi256_ps(i23), gt));
+
+				const __m256 largest = _mm256_blendv_ps(_mm256_blendv_ps(x, y, gt01), _mm256_blendv_ps(z, w, gt23), gt);
+				const __m256 sign = _mm256_and_ps(largest, signMask);
+
+				const __m256 is0 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(index, _mm256_setzero_si256()));
+				const __m256 is3 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(index, _mm256_set1_epi32(3)));
+				const __m256 below2 = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(2), index));
+
+				const __m256 a = _mm256_blendv_ps(x, y, is0);
+				const __m256 b = _mm256_blendv_ps(y, z, below2);
+				const __m256 c = _mm256_blendv_ps(w, z, is3);
+				return { index, Quantize(_mm256_xor_ps(a, sign)), Quantize(_mm256_xor_ps(b, sign)), Quantize(_mm256_xor_ps(c, sign)) };
+			}
+
+			void Decode(float* q) const noexcept
+			{
+				const __m256 fa = Dequantize(a), fb = Dequantize(b), fc = Dequantize(c);
+				const __m256 sum = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(fa, fa), _mm256_mul_ps(fb, fb)), _mm256_mul_ps(fc, fc));
+				const __m256 largest = _mm256_sqrt_ps(_mm256_max_ps(_mm256_sub_ps(_mm256_set1_ps(1.f), sum), _mm256_setzero_ps()));
+
+				const __m256 is0 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(index, _mm256_setzero_si256()));
+				const __m256 is1 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(index, _mm256_set1_epi32(1)));
+				const __m256 is2 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(index, _mm256_set1_epi32(2)));
+				const __m256 is3 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(index, _mm256_set1_epi32(3)));
+
+				const __m256 x = _mm256_blendv_ps(fa, largest, is0);
+				const __m256 y = _mm256_blendv_ps(_mm256_blendv_ps(fb, largest, is1), fa, is0);
+				const __m256 z = _mm256_blendv_ps(_mm256_blendv_ps(fc, largest, is2), fb, _mm256_or_ps(is0, is1));
+				const __m256 w = _mm256_blendv_ps(fc, largest, is3);
+				StoreAoS8x4(q, x, y, z, w);
+			}
+		};
+
+		// pshufb controls between the 48-bit layout, 12 words for the 4 quaternions of a 128-bit half,
+		// and one 32-bit lane per quaternion. Words 0-7 of a half sit in its first 16 bytes, words 8-11
+		// in the following 8.
+		struct Shuffle48
+		{
+			// [component][first 16 bytes, last 8 bytes]: zero-extends word 3k + component to lane k
+			alignas(32) uint8_t gather[3][2][32] = {};
+			// [first 16 bytes, last 8 bytes][source]: picks output words from a and b packed to
+			// words 0-3 and 4-7, or from c packed to words 0-3
+			alignas(32) uint8_t scatter[2][2][32] = {};
+
+			constexpr Shuffle48() noexcept
+			{
+				for (int half = 0; half < 2; ++half)
+				{
+					for (int component = 0; component < 3; ++component)
+					{
+						for (int lane = 0; lane < 4; ++lane)
+						{
+							const int word = lane * 3 + component;
+							for (int byte = 0; byte < 4; ++byte)
+							{
+								gather[component][0][half * 16 + lane * 4 + byte] = byte < 2 && word < 8 ? static_cast<uint8_t>(word * 2 + byte) : 0x80;
+								gather[component][1][half * 16 + lane * 4 + byte] = byte < 2 && word >= 8 ? static_cast<uint8_t>((word - 8) * 2 + byte) : 0x80;
+							}
+						}
+					}
+
+					for (int byte = 0; byte < 24; ++byte)
+					{
+						const int word = byte / 2;
+						const int lane = word / 3;
+						const int component = word % 3;
+						const int source = component < 2 ? 0 : 1;
+						const int sourceWord = component == 1 ? lane + 4 : lane;
+						const int part = byte < 16 ? 0 : 1;
+						const int position = half * 16 + byte - part * 16;
+						scatter[part][source][position] = static_cast<uint8_t>(sourceWord * 2 + byte % 2);
+						scatter[part][1 - source][position] = 0x80;
+					}
+					for (int byte = 8; byte < 16; ++byte)
+					{
+						scatter[1][0][half * 16 + byte] = 0x80;
+						scatter[1][1][half * 16 + byte] = 0x80;
+					}
+				}
+			}
+		};
+
+		constexpr Shuffle48 Shuffles48;
+
+		inline __m256i LoadShuffle(const uint8_t* control) noexcept
+		{
+			return _mm256_load_si256(reinterpret_cast<const __m256i*>(control));
+		}
+
+		inline __m256i Gather48(__m256i first, __m256i last, int component) noexcept
+		{
+			return _mm256_or_si256(_mm256_shuffle_epi8(first, LoadShuffle(Shuffles48.gather[component][0])),
+			                       _mm256_shuffle_epi8(last, LoadShuffle(Shuffles48.gather[component][1])));
+		}
+
+		inline __m256i Scatter48(__m256i ab, __m256i cc, int part) noexcept
+		{
+			return _mm256_or_si256(_mm256_shuffle_epi8(ab, LoadShuffle(Shuffles48.scatter[part][0])),
+			                       _mm256_shuffle_epi8(cc, LoadShuffle(Shuffles48.scatter[part][1])));
+		}
+
+		//****************************************************************************
+		// Quantized vectors
+
+		// Per-axis parameters spread over the 24 floats of 8 vectors, whose axes repeat x, y, z
+		struct AxisPattern
+		{
+			__m256 lanes[3];
+
+			explicit AxisPattern(const float* axes) noexcept
+			{
+				alignas(32) float pattern[24];
+				for (int k = 0; k < 24; ++k)
+					pattern[k] = axes[k % 3];
+				for (int k = 0; k < 3; ++k)
+					lanes[k] = _mm256_load_ps(pattern + 8 * k);
+			}
+		};
+
+		template <typename Code, int Min, int Max>
+		void Encode16(const float* input, const float* offset, const float* scale, Code* output, size_t count) noexcept
+		{
+			const AxisPattern offsets(offset), scales(scale);
+			const __m256 minCode = _mm256_set1_ps(static_cast<float>(Min));
+			const __m256 maxCode = _mm256_set1_ps(static_cast<float>(Max));
+
+			ForEachBlock8<3, 3>(input, output, count, [&](const float* in, Code* out)
+			{
+				__m256i codes[3];
+				for (int k = 0; k < 3; ++k)
+				{
+					const __m256 scaled = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(in + 8 * k), offsets.lanes[k]), scales.lanes[k]);
+					const __m256 code = _mm256_round_ps(scaled, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+					codes[k] = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(code, minCode), maxCode));
+				}
+
+				// Packing works within 128-bit halves, the permute restores the element order
+				__m256i first, last;
+				if constexpr (Min == 0)
+				{
+					first = _mm256_packus_epi32(codes[0], codes[1]);
+					last = _mm256_packus_epi32(codes[2], codes[2]);
+				}
+				else
+				{
+					first = _mm256_packs_epi32(codes[0], codes[1]);
+					last = _mm256_packs_epi32(codes[2], codes[2]);
+				}
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permute4x64_epi64(first, _MM_SHUFFLE(3, 1, 2, 0)));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm256_castsi256_si128(_mm256_permute4x64_epi64(last, _MM_SHUFFLE(3, 1, 2, 0))));
+			});
+		}
+
+		template <typename Code>
+		void Decode16(const Code* input, const float* offset, const float* step, float* output, size_t count) noexcept
+		{
+			const AxisPattern offsets(offset), steps(step);
+
+			ForEachBlock8<3, 3>(input, output, count, [&](const Code* in, float* out)
+			{
+				for (int k = 0; k < 3; ++k)
+				{
+					const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 8 * k));
+					__m256i codes;
+					if constexpr (std::is_signed_v<Code>)
+						codes = _mm256_cvtepi16_epi32(words);
+					else
+						codes = _mm256_cvtepu16_epi32(words);
+					_mm256_storeu_ps(out + 8 * k, _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(codes), steps.lanes[k]), offsets.lanes[k]));
+				}
+			});
+		}
+	}
+
+	void QuaternionEncode48(const float* input, uint16_t* output, size_t count) noexcept
+	{
+		ForEachBlock8<4, 3>(input, output, count, [](const float* in, uint16_t* out)
+		{
+			const SmallestThree8<15> packed = SmallestThree8<15>::Encode(in);
+
+			// Index bit 0 goes below a, bit 1 below b
+			const __m256i one = _mm256_set1_epi32(1);
+			const __m256i a = _mm256_or_si256(_mm256_slli_epi32(packed.a, 1), _mm256_and_si256(packed.index, one));
+			const __m256i b = _mm256_or_si256(_mm256_slli_epi32(packed.b, 1), _mm256_srli_epi32(packed.index, 1));
+			const __m256i c = _mm256_slli_epi32(packed.c, 1);
+
+			const __m256i ab = _mm256_packus_epi32(a, b);
+			const __m256i cc = _mm256_packus_epi32(c, c);
+			const __m256i first = Scatter48(ab, cc, 0);
+			const __m256i last = Scatter48(ab, cc, 1);
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(first));
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(out + 8), _mm256_castsi256_si128(last));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12), _mm256_extracti128_si256(first, 1));
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(out + 20), _mm256_extracti128_si256(last, 1));
+		});
+	}
+
+	void QuaternionDecode48(const uint16_t* input, float* output, size_t count) noexcept
+	{
+		ForEachBlock8<3, 4>(input, output, count, [](const uint16_t* in, float* out)
+		{
+			const __m256i first = _mm256_setr_m128i(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)),
+			                                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 12)));
+			const __m256i last = _mm256_setr_m128i(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + 8)),
+			                                       _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + 20)));
+			const __m256i a = Gather48(first, last, 0);
+			const __m256i b = Gather48(first, last, 1);
+			const __m256i c = Gather48(first, last, 2);
+
+			const __m256i one = _mm256_set1_epi32(1);
+			const __m256i index = _mm256_or_si256(_mm256_and_si256(a, one), _mm256_slli_epi32(_mm256_and_si256(b, one), 1));
+			const SmallestThree8<15> packed = { index, _mm256_srli_epi32(a, 1), _mm256_srli_epi32(b, 1), _mm256_srli_epi32(c, 1) };
+			packed.Decode(out);
+		});
+	}
+
+	void QuaternionEncode32(const float* input, uint32_t* output, size_t count) noexcept
+	{
+		ForEachBlock8<4, 1>(input, output, count, [](const float* in, uint32_t* out)
+		{
+			const SmallestThree8<10> packed = SmallestThree8<10>::Encode(in);
+			__m256i bits = _mm256_or_si256(packed.a, _mm256_slli_epi32(packed.b, 10));
+			bits = _mm256_or_si256(bits, _mm256_slli_epi32(packed.c, 20));
+			bits = _mm256_or_si256(bits, _mm256_slli_epi32(packed.index, 30));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), bits);
+		});
+	}
+
+	void QuaternionDecode32(const uint32_t* input, float* output, size_t count) noexcept
+	{
+		ForEachBlock8<1, 4>(input, output, count, [](const uint32_t* in, float* out)
+		{
+			const __m256i bits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+			const __m256i mask = _mm256_set1_epi32(0x3FF);
+			const SmallestThree8<10> packed = { _mm256_srli_epi32(bits, 30), _mm256_and_si256(bits, mask),
+			                                    _mm256_and_si256(_mm256_srli_epi32(bits, 10), mask), _mm256_and_si256(_mm256_srli_epi32(bits, 20), mask) };
+			packed.Decode(out);
+		});
+	}
+
+	void Vector3EncodeHalf(const float* input, uint16_t* output, size_t count) noexcept
+	{
+		ForEachBlock8<3, 3>(input, output, count, [](const float* in, uint16_t* out)
+		{
+			for (int k = 0; k < 3; ++k)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8 * k), _mm256_cvtps_ph(_mm256_loadu_ps(in + 8 * k), _MM_FROUND_TO_NEAREST_INT));
+		});
+	}
+
+	void Vector3DecodeHalf(const uint16_t* input, float* output, size_t count) noexcept
+	{
+		ForEachBlock8<3, 3>(input, output, count, [](const uint16_t* in, float* out)
+		{
+			for (int k = 0; k < 3; ++k)
+				_mm256_storeu_ps(out + 8 * k, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 8 * k))));
+		});
+	}
+
+	void Vector3EncodeUnorm16(const float* input, const float* offset, const float* scale, uint16_t* output, size_t count) noexcept
+	{
+		Encode16<uint16_t, 0, 65535>(input, offset, scale, output, count);
+	}
+
+	void Vector3DecodeUnorm16(const uint16_t* input, const float* offset, const float* step, float* output, size_t count) noexcept
+	{
+		Decode16(input, offset, step, output, count);
+	}
+
+	void Vector3EncodeSnorm16(const float* input, const float* offset, const float* scale, int16_t* output, size_t count) noexcept
+	{
+		Encode16<int16_t, -32767, 32767>(input, offset, scale, output, count);
+	}
+
+	void Vector3DecodeSnorm16(const int16_t* input, const float* offset, const float* step, float* output, size_t count) noexcept
+	{
+		Decode16(input, offset, step, output, count);
+	}
+}
+#endif
@@ -0,0 +1,126 @@
+#include "PMathCpu.h"
+
+#include <atomic>
+
+#if PMATH_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace PMgene::Math
+{
+	namespace
+	{
+#if PMATH_X86
+		void CpuId(unsigned int leaf, unsigned int subLeaf, unsigned int regs[4]) noexcept
+		{
+#if defined(_MSC_VER)
+			int info[4];
+			__cpuidex(info, static_cast<int>(leaf), static_cast<int>(subLeaf));
+			for (int i = 0; i < 4; ++i)
+				regs[i] = static_cast<unsigned int>(info[i]);
+#else
+			__cpuid_count(leaf, subLeaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+		}
+
+		unsigned long long XGetBV() noexcept
+		{
+#if defined(_MSC_VER)
+			return _xgetbv(0);
+#else
+			unsigned int eax, edx;
+			__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+			return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+		}
+#endif
+
+		SimdLevel DetectSimdLevel() noexcept
+		{
+#if PMATH_X86
+			unsigned int regs[4];
+			CpuId(0, 0, regs);
+			const unsigned int maxLeaf = regs[0];
+
+			CpuId(1, 0, regs);
+			const unsigned int ecx1 = regs[2];
+			const unsigned int edx1 = regs[3];
+
+			if (!(edx1 & (1u << 26)))
+				return SimdLevel::Scalar;
+			if (!(ecx1 & (1u << 19)))
+				return SimdLevel::SSE2;
+
+			const bool fma = ecx1 & (1u << 12);
+			const bool osxsave = ecx1 & (1u << 27);
+			const bool avx = ecx1 & (1u << 28);
+			const bool f16c = ecx1 & (1u << 29);
+			if (!fma || !osxsave || !avx || !f16c || maxLeaf < 7)
+				return SimdLevel::SSE41;
+
+			// OS must preserve XMM and YMM state
+			const unsigned long long xcr0 = XGetBV();
+			if ((xcr0 & 0x6) != 0x6)
+				return SimdLevel::SSE41;
+
+			CpuId(7, 0, regs);
+			const unsigned int ebx7 = regs[1];
+			if (!(ebx7 & (1u << 5)))
+				return SimdLevel::SSE41;
+
+			// F, DQ, BW, VL and opmask/ZMM state enabled by the OS
+			constexpr unsigned int avx512Bits = (1u << 16) | (1u << 17) | (1u << 30) | (1u << 31);
+			if ((ebx7 & avx512Bits) == avx512Bits && (xcr0 & 0xE6) == 0xE6)
+				return SimdLevel::AVX512;
+
+			return SimdLevel::AVX2;
+#else
+			return SimdLevel::Scalar;
+#endif
+		}
+
+		std::atomic<SimdLevel>& ActiveSimdLevel() noexcept
+		{
+			static std::atomic<SimdLevel> level{ GetSupportedSimdLevel() };
+			return level;
+		}
+	}
+
+	SimdLevel GetSupportedSimdLevel() noexcept
+	{
+		static const SimdLevel supported = DetectSimdLevel();
+		return supported;
+	}
+
+	SimdLevel GetCompiledSimdLevel() noexcept
+	{
+#if defined(PMATH_SIMD_BASELINE)
+		return static_cast<SimdLevel>(PMATH_SIMD_BASELINE);
+#elif defined(__AVX512F__) && defined(__AVX512DQ__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+		return SimdLevel::AVX512;
+#elif defined(__AVX2__)
+		return SimdLevel::AVX2;
+#elif defined(__SSE4_1__)
+		return SimdLevel::SSE41;
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		return SimdLevel::SSE2;
+#else
+		return SimdLevel::Scalar;
+#endif
+	}
+
+	SimdLevel GetSimdLevel() noexcept
+	{
+		return ActiveSimdLevel().load(std::memory_order_relaxed);
+	}
+
+	void SetSimdLevel(SimdLevel level) noexcept
+	{
+		const SimdLevel supported = GetSupportedSimdLevel();
+		ActiveSimdLevel().store(level < supported ? level : supported, std::memory_order_relaxed);
+	}
+}
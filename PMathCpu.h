@@ -0,0 +1,37 @@
+#pragma once
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PMATH_X86 1
+#else
+#define PMATH_X86 0
+#endif
+
+namespace PMgene::Math
+{
+	//****************************************************************************
+	// Runtime CPU dispatch
+
+	// Instruction set levels the batch kernels can dispatch to, lowest to highest
+	enum class SimdLevel : int
+	{
+		Scalar,
+		SSE2,
+		SSE41,
+		AVX2,   // AVX2 + FMA3 + F16C
+		AVX512  // AVX-512 F/DQ/BW/VL
+	};
+
+	// Highest level supported by both the CPU and the OS, detected once
+	SimdLevel GetSupportedSimdLevel() noexcept;
+
+	// Level the library itself was compiled for, PMATH_SIMD_BASELINE in the CMake variants.
+	// Hosts below it cannot run the library, whatever the dispatch picks.
+	SimdLevel GetCompiledSimdLevel() noexcept;
+
+	// Level currently used by the batch kernels
+	SimdLevel GetSimdLevel() noexcept;
+
+	// Caps the level used by the batch kernels, clamped to the supported level.
+	// Meant for benchmarks and for exercising the fallback paths.
+	void SetSimdLevel(SimdLevel level) noexcept;
+}
@@ -0,0 +1,329 @@
+#pragma once
+#include <cassert>
+#include <concepts>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "PMath.h"
+#include "PMathParallel.h"
+#include "PMathStream.h"
+
+namespace PMgene::Math
+{
+	//****************************************************************************
+	// Lazy expressions
+	// Opt-in expression templates for Vector3 arithmetic. Lazy::Of wraps an operand; operators on
+	// wrapped operands build an expression tree instead of computing, and the whole tree is
+	// evaluated in registers when it is converted to a Vector3 or stored to a Vector3Stream. Each
+	// operand is loaded once and the result stored once, where the eager operators load and store
+	// around every step. Products followed by a sum or difference become one multiply-add, fused
+	// when DirectXMath is built for FMA.
+	//
+	//   Vector3 r = Lazy::Of(a) * s + b - c;
+	//   Lazy::Store(Lazy::Of(velocities) * dt + positions, positions);
+	//
+	// Operands are +, -, component-wise * and /, negation, and scaling by float. Vector3 and float
+	// operands are copied into the expression; Vector3Stream and span operands are referenced, so
+	// an expression over streams must not outlive them.
+
+	namespace Lazy
+	{
+		// Four consecutive stream elements, one register per component
+		struct Block
+		{
+			XMVECTOR x;
+			XMVECTOR y;
+			XMVECTOR z;
+		};
+
+		// Base of every expression node. Nodes provide
+		//   XMVECTOR Element(size_t i) const noexcept;   element i as x, y, z in one register
+		//   Block Elements(size_t i) const noexcept;     elements i to i + 3
+		//   bool Fits(size_t count) const noexcept;      stream operands have 'count' elements
+		// and IsStream, true when any operand is a stream.
+		template <typename Derived>
+		struct Expression
+		{
+			// Only for expressions without stream operands
+			[[nodiscard]] Vector3 Evaluate() const noexcept requires (!Derived::IsStream)
+			{
+				Vector3 R;
+				XMStoreFloat3(&R, static_cast<const Derived&>(*this).Element(0));
+				return R;
+			}
+
+			operator Vector3() const noexcept requires (!Derived::IsStream) { return Evaluate(); }
+		};
+
+		template <typename T>
+		concept Node = std::derived_from<T, Expression<T>>;
+
+
+		//****************************************************************************
+		// Operands
+
+		struct VectorValue : Expression<VectorValue>
+		{
+			static constexpr bool IsStream = false;
+			XMVECTOR v;
+
+			explicit VectorValue(const Vector3& V) noexcept : v(XMLoadFloat3(&V)) {}
+
+			[[nodiscard]] XMVECTOR Element(size_t) const noexcept { return v; }
+			[[nodiscard]] Block Elements(size_t) const noexcept { return { XMVectorSplatX(v), XMVectorSplatY(v), XMVectorSplatZ(v) }; }
+			[[nodiscard]] bool Fits(size_t) const noexcept { return true; }
+		};
+
+		struct ScalarValue : Expression<ScalarValue>
+		{
+			static constexpr bool IsStream = false;
+			XMVECTOR s;
+
+			explicit ScalarValue(float S) noexcept : s(XMVectorReplicate(S)) {}
+
+			[[nodiscard]] XMVECTOR Element(size_t) const noexcept { return s; }
+			[[nodiscard]] Block Elements(size_t) const noexcept { return { s, s, s }; }
+			[[nodiscard]] bool Fits(size_t) const noexcept { return true; }
+		};
+
+		struct VectorStream : Expression<VectorStream>
+		{
+			static constexpr bool IsStream = true;
+			const float* x;
+			const float* y;
+			const float* z;
+			size_t size;
+
+			explicit VectorStream(const Vector3Stream& V) noexcept : x(V.x.data()), y(V.y.data()), z(V.z.data()), size(V.Size()) {}
+
+			[[nodiscard]] XMVECTOR Element(size_t i) const noexcept { return XMVectorSet(x[i], y[i], z[i], 0.f); }
+			[[nodiscard]] Block Elements(size_t i) const noexcept
+			{
+				return { XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(x + i)), XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(y + i)),
+				         XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(z + i)) };
+			}
+			[[nodiscard]] bool Fits(size_t count) const noexcept { return size == count; }
+		};
+
+		// One scalar per element, such as per-particle inverse masses
+		struct ScalarStream : Expression<ScalarStream>
+		{
+			static constexpr bool IsStream = true;
+			const float* s;
+			size_t size;
+
+			explicit ScalarStream(std::span<const float> S) noexcept : s(S.data()), size(S.size()) {}
+
+			[[nodiscard]] XMVECTOR Element(size_t i) const noexcept { return XMVectorReplicate(s[i]); }
+			[[nodiscard]] Block Elements(size_t i) const noexcept
+			{
+				const XMVECTOR v = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(s + i));
+				return { v, v, v };
+			}
+			[[nodiscard]] bool Fits(size_t count) const noexcept { return size == count; }
+		};
+
+		[[nodiscard]] inline VectorValue Of(const Vector3& V) noexcept { return VectorValue(V); }
+		[[nodiscard]] inline ScalarValue Of(float S) noexcept { return ScalarValue(S); }
+		[[nodiscard]] inline VectorStream Of(const Vector3Stream& V) noexcept { return VectorStream(V); }
+		[[nodiscard]] inline ScalarStream Of(std::span<const float> S) noexcept { return ScalarStream(S); }
+		template <Node E>
+		[[nodiscard]] const E& Of(const E& expression) noexcept { return expression; }
+
+		// Operand types that the operators wrap on the fly when the other side is an expression
+		template <typename T>
+		using Operand = decltype(Of(std::declval<const T&>()));
+
+		template <typename T>
+		concept Wrappable = requires(const T& t) { Of(t); };
+
+
+		//****************************************************************************
+		// Operations
+
+		template <typename A, typename B, typename Op>
+		struct Binary : Expression<Binary<A, B, Op>>
+		{
+			static constexpr bool IsStream = A::IsStream || B::IsStream;
+			A a;
+			B b;
+
+			Binary(const A& ia, const B& ib) noexcept : a(ia), b(ib) {}
+
+			[[nodiscard]] XMVECTOR Element(size_t i) const noexcept { return Op::Apply(a.Element(i), b.Element(i)); }
+			[[nodiscard]] Block Elements(size_t i) const noexcept
+			{
+				const Block p = a.Elements(i);
+				const Block q = b.Elements(i);
+				return { Op::Apply(p.x, q.x), Op::Apply(p.y, q.y), Op::Apply(p.z, q.z) };
+			}
+			[[nodiscard]] bool Fits(size_t count) const noexcept { return a.Fits(count) && b.Fits(count); }
+		};
+
+		struct AddOp { static XMVECTOR Apply(FXMVECTOR a, FXMVECTOR b) noexcept { return XMVectorAdd(a, b); } };
+		struct SubtractOp { static XMVECTOR Apply(FXMVECTOR a, FXMVECTOR b) noexcept { return XMVectorSubtract(a, b); } };
+		struct MultiplyOp { static XMVECTOR Apply(FXMVECTOR a, FXMVECTOR b) noexcept { return XMVectorMultiply(a, b); } };
+		struct DivideOp { static XMVECTOR Apply(FXMVECTOR a, FXMVECTOR b) noexcept { return XMVectorDivide(a, b); } };
+
+		template <typename A, typename B> using Add = Binary<A, B, AddOp>;
+		template <typename A, typename B> using Subtract = Binary<A, B, SubtractOp>;
+		template <typename A, typename B> using Multiply = Binary<A, B, MultiplyOp>;
+		template <typename A, typename B> using Divide = Binary<A, B, DivideOp>;
+
+		// a * b + c, or c - a * b when Negative
+		template <typename A, typename B, typename C, bool Negative>
+		struct MultiplyAdd : Expression<MultiplyAdd<A, B, C, Negative>>
+		{
+			static constexpr bool IsStream = A::IsStream || B::IsStream || C::IsStream;
+			A a;
+			B b;
+			C c;
+
+			MultiplyAdd(const A& ia, const B& ib, const C& ic) noexcept : a(ia), b(ib), c(ic) {}
+
+			static XMVECTOR Apply(FXMVECTOR v1, FXMVECTOR v2, FXMVECTOR v3) noexcept
+			{
+				if constexpr (Negative)
+					return XMVectorNegativeMultiplySubtract(v1, v2, v3);
+				else
+					return XMVectorMultiplyAdd(v1, v2, v3);
+			}
+
+			[[nodiscard]] XMVECTOR Element(size_t i) const noexcept { return Apply(a.Element(i), b.Element(i), c.Element(i)); }
+			[[nodiscard]] Block Elements(size_t i) const noexcept
+			{
+				const Block p = a.Elements(i);
+				const Block q = b.Elements(i);
+				const Block r = c.Elements(i);
+				return { Apply(p.x, q.x, r.x), Apply(p.y, q.y, r.y), Apply(p.z, q.z, r.z) };
+			}
+			[[nodiscard]] bool Fits(size_t count) const noexcept { return a.Fits(count) && b.Fits(count) && c.Fits(count); }
+		};
+
+		template <typename A>
+		struct Negate : Expression<Negate<A>>
+		{
+			static constexpr bool IsStream = A::IsStream;
+			A a;
+
+			explicit Negate(const A& ia) noexcept : a(ia) {}
+
+			[[nodiscard]] XMVECTOR Element(size_t i) const noexcept { return XMVectorNegate(a.Element(i)); }
+			[[nodiscard]] Block Elements(size_t i) const noexcept
+			{
+				const Block p = a.Elements(i);
+				return { XMVectorNegate(p.x), XMVectorNegate(p.y), XMVectorNegate(p.z) };
+			}
+			[[nodiscard]] bool Fits(size_t count) const noexcept { return a.Fits(count); }
+		};
+
+		template <typename T>
+		inline constexpr bool IsMultiply = false;
+		template <typename A, typename B>
+		inline constexpr bool IsMultiply<Multiply<A, B>> = true;
+
+		// At least one side must already be an expression, so plain Vector3 arithmetic is untouched
+		template <typename L, typename R>
+		concept Operands = Wrappable<L> && Wrappable<R> && (Node<L> || Node<R>);
+
+
+		//****************************************************************************
+		// Operators
+
+		template <typename L, typename R> requires Operands<L, R>
+		[[nodiscard]] auto operator+(const L& l, const R& r) noexcept
+		{
+			using A = std::remove_cvref_t<Operand<L>>;
+			using B = std::remove_cvref_t<Operand<R>>;
+			if constexpr (IsMultiply<A>)
+				return MultiplyAdd<decltype(A::a), decltype(A::b), B, false>(Of(l).a, Of(l).b, Of(r));
+			else if constexpr (IsMultiply<B>)
+				return MultiplyAdd<decltype(B::a), decltype(B::b), A, false>(Of(r).a, Of(r).b, Of(l));
+			else
+				return Add<A, B>(Of(l), Of(r));
+		}
+
+		template <typename L, typename R> requires Operands<L, R>
+		[[nodiscard]] auto operator-(const L& l, const R& r) noexcept
+		{
+			using A = std::remove_cvref_t<Operand<L>>;
+			using B = std::remove_cvref_t<Operand<R>>;
+			if constexpr (IsMultiply<B>)
+				return MultiplyAdd<decltype(B::a), decltype(B::b), A, true>(Of(r).a, Of(r).b, Of(l));
+			else if constexpr (IsMultiply<A>)
+				return MultiplyAdd<decltype(A::a), decltype(A::b), Negate<B>, false>(Of(l).a, Of(l).b, Negate<B>(Of(r)));
+			else
+				return Subtract<A, B>(Of(l), Of(r));
+		}
+
+		template <typename L, typename R> requires Operands<L, R>
+		[[nodiscard]] auto operator*(const L& l, const R& r) noexcept
+		{
+			return Multiply<std::remove_cvref_t<Operand<L>>, std::remove_cvref_t<Operand<R>>>(Of(l), Of(r));
+		}
+
+		// Division by a float multiplies by its reciprocal, like Vector3's operator/
+		template <typename L, typename R> requires Operands<L, R>
+		[[nodiscard]] auto operator/(const L& l, const R& r) noexcept
+		{
+			if constexpr (std::is_convertible_v<R, float> && !Node<R>)
+				return Multiply<std::remove_cvref_t<Operand<L>>, ScalarValue>(Of(l), ScalarValue(1.f / static_cast<float>(r)));
+			else
+				return Divide<std::remove_cvref_t<Operand<L>>, std::remove_cvref_t<Operand<R>>>(Of(l), Of(r));
+		}
+
+		template <Node E>
+		[[nodiscard]] Negate<E> operator-(const E& e) noexcept
+		{
+			return Negate<E>(e);
+		}
+
+
+		//****************************************************************************
+		// Evaluation over streams
+
+		namespace Detail
+		{
+			constexpr size_t StoreGrain = 16384;
+
+			template <Node E>
+			void Store(const E& expression, Vector3Stream& result, Parallel::Range range) noexcept
+			{
+				size_t i = range.begin;
+				for (; i + 4 <= range.end; i += 4)
+				{
+					const Block b = expression.Elements(i);
+					XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(result.x.data() + i), b.x);
+					XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(result.y.data() + i), b.y);
+					XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(result.z.data() + i), b.z);
+				}
+				for (; i < range.end; ++i)
+				{
+					const XMVECTOR v = expression.Element(i);
+					result.x[i] = XMVectorGetX(v);
+					result.y[i] = XMVectorGetY(v);
+					result.z[i] = XMVectorGetZ(v);
+				}
+			}
+		}
+
+		// Evaluates the expression for every element of 'result' in a single pass. Stream operands
+		// must have the size of 'result', which may be one of them.
+		template <Node E>
+		void Store(const E& expression, Vector3Stream& result) noexcept
+		{
+			assert(expression.Fits(result.Size()));
+			Detail::Store(expression, result, { 0, result.Size() });
+		}
+
+		template <Node E>
+		void Store(const Parallel::ParallelPolicy& policy, const E& expression, Vector3Stream& result) noexcept
+		{
+			assert(expression.Fits(result.Size()));
+			Parallel::ParallelFor(result.Size(), policy.grain ? policy.grain : Detail::StoreGrain, [&](Parallel::Range range) {
+				Detail::Store(expression, result, range);
+			});
+		}
+	}
+}
@@ -0,0 +1,352 @@
+#include "PMathHierarchy.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "PMath.inl"
+
+namespace PMgene::Math
+{
+	namespace
+	{
+		// Below this many changed nodes the update runs on the calling thread only
+		constexpr size_t MinParallelNodes = 16384;
+
+		// Tasks per thread, so uneven subtrees still balance out
+		constexpr size_t TasksPerThread = 8;
+	}
+
+	//****************************************************************************
+	// Structure
+
+	TransformHierarchy::NodeId TransformHierarchy::Create(NodeId parent, const Matrix& local)
+	{
+		assert(parent == InvalidNode || IsValid(parent));
+
+		NodeId node;
+		if (!m_freeNodes.empty())
+		{
+			node = m_freeNodes.back();
+			m_freeNodes.pop_back();
+		}
+		else
+		{
+			node = static_cast<NodeId>(m_slot.size());
+			m_slot.push_back(InvalidSlot);
+		}
+
+		const Slot slot = static_cast<Slot>(m_local.size());
+		const Slot parentSlot = parent != InvalidNode ? m_slot[parent] : InvalidSlot;
+		m_local.push_back(local);
+		m_world.push_back(local);
+		m_parent.push_back(parentSlot);
+		m_subtreeEnd.push_back(slot + 1);
+		m_node.push_back(node);
+		m_dirty.push_back(1);
+		m_slot[node] = slot;
+		++m_count;
+
+		// Appending keeps the depth-first order when the parent's subtree is the last one,
+		// which is the case when a hierarchy is built top-down
+		if (parentSlot != InvalidSlot && !m_orderDirty)
+		{
+			if (m_subtreeEnd[parentSlot] == slot)
+			{
+				for (Slot p = parentSlot; p != InvalidSlot; p = m_parent[p])
+					m_subtreeEnd[p] = slot + 1;
+			}
+			else
+			{
+				m_orderDirty = true;
+			}
+		}
+		return node;
+	}
+
+	void TransformHierarchy::Destroy(NodeId node)
+	{
+		assert(IsValid(node));
+		EnsureOrder();
+
+		const Slot begin = m_slot[node];
+		const Slot end = m_subtreeEnd[begin];
+		for (Slot s = begin; s < end; ++s)
+		{
+			m_slot[m_node[s]] = InvalidSlot;
+			m_freeNodes.push_back(m_node[s]);
+			m_node[s] = InvalidNode;
+		}
+		m_count -= end - begin;
+		m_orderDirty = true;
+	}
+
+	void TransformHierarchy::SetParent(NodeId node, NodeId parent)
+	{
+		assert(IsValid(node) && (parent == InvalidNode || IsValid(parent)));
+		EnsureOrder();
+
+		const Slot slot = m_slot[node];
+		const Slot parentSlot = parent != InvalidNode ? m_slot[parent] : InvalidSlot;
+		assert((parentSlot < slot || parentSlot >= m_subtreeEnd[slot]) && "a node cannot be parented to its own subtree");
+
+		m_parent[slot] = parentSlot;
+		m_dirty[slot] = 1;
+		m_orderDirty = true;
+	}
+
+	void TransformHierarchy::Reserve(size_t count)
+	{
+		m_local.reserve(count);
+		m_world.reserve(count);
+		m_parent.reserve(count);
+		m_subtreeEnd.reserve(count);
+		m_node.reserve(count);
+		m_dirty.reserve(count);
+		m_slot.reserve(count);
+	}
+
+	void TransformHierarchy::Clear() noexcept
+	{
+		m_local.clear();
+		m_world.clear();
+		m_parent.clear();
+		m_subtreeEnd.clear();
+		m_node.clear();
+		m_dirty.clear();
+		m_slot.clear();
+		m_freeNodes.clear();
+		m_count = 0;
+		m_orderDirty = false;
+	}
+
+	TransformHierarchy::NodeId TransformHierarchy::Parent(NodeId node) const noexcept
+	{
+		assert(IsValid(node));
+		const Slot parent = m_parent[m_slot[node]];
+		return parent != InvalidSlot ? m_node[parent] : InvalidNode;
+	}
+
+	//****************************************************************************
+	// Transforms
+
+	const Matrix& TransformHierarchy::GetLocal(NodeId node) const noexcept
+	{
+		assert(IsValid(node));
+		return m_local[m_slot[node]];
+	}
+
+	void TransformHierarchy::SetLocal(NodeId node, const Matrix& local) noexcept
+	{
+		assert(IsValid(node));
+		const Slot slot = m_slot[node];
+		m_local[slot] = local;
+		m_dirty[slot] = 1;
+	}
+
+	void TransformHierarchy::SetLocal(NodeId node, const SQT& local) noexcept
+	{
+		SetLocal(node, local.ToMatrix());
+	}
+
+	const Matrix& TransformHierarchy::GetWorld(NodeId node) const noexcept
+	{
+		assert(IsValid(node));
+		return m_world[m_slot[node]];
+	}
+
+	size_t TransformHierarchy::CollectChangedRanges(std::vector<Range>& ranges) const
+	{
+		// A changed node invalidates its whole subtree, which is the contiguous range up to
+		// its subtree end, so clean subtrees are skipped without touching their matrices
+		size_t changed = 0;
+		const Slot count = static_cast<Slot>(m_local.size());
+		for (Slot s = 0; s < count;)
+		{
+			if (m_dirty[s])
+			{
+				ranges.push_back({ s, m_subtreeEnd[s] });
+				changed += m_subtreeEnd[s] - s;
+				s = m_subtreeEnd[s];
+			}
+			else
+			{
+				++s;
+			}
+		}
+		return changed;
+	}
+
+	void TransformHierarchy::Update()
+	{
+		EnsureOrder();
+
+		std::vector<Range> ranges;
+		CollectChangedRanges(ranges);
+		for (const Range& range : ranges)
+			UpdateRange(range);
+	}
+
+	void TransformHierarchy::Update(const Parallel::ParallelPolicy& policy)
+	{
+		EnsureOrder();
+
+		std::vector<Range> ranges;
+		const size_t changed = CollectChangedRanges(ranges);
+		const unsigned threadCount = Parallel::GetThreadCount();
+		if (threadCount <= 1 || changed < std::max(MinParallelNodes, policy.grain * 2))
+		{
+			for (const Range& range : ranges)
+				UpdateRange(range);
+			return;
+		}
+
+		const size_t taskCount = policy.grain != 0 ? changed / policy.grain : threadCount * TasksPerThread;
+		SplitRanges(ranges, taskCount);
+
+		Parallel::ParallelFor(ranges.size(), 1, [&](Parallel::Range tasks) {
+			for (size_t i = tasks.begin; i < tasks.end; ++i)
+				UpdateRange(ranges[i]);
+		});
+	}
+
+	void TransformHierarchy::UpdateRange(Range range) noexcept
+	{
+		// The parent of the first node lies outside the range and is already up to date,
+		// every other parent comes earlier in the range
+		for (Slot s = range.begin; s < range.end; ++s)
+		{
+			const Slot parent = m_parent[s];
+			if (parent != InvalidSlot)
+				m_world[s] = m_local[s] * m_world[parent];
+			else
+				m_world[s] = m_local[s];
+			m_dirty[s] = 0;
+		}
+	}
+
+	void TransformHierarchy::SplitRanges(std::vector<Range>& ranges, size_t taskCount)
+	{
+		size_t total = 0;
+		for (const Range& range : ranges)
+			total += range.end - range.begin;
+		const size_t target = std::max<size_t>(total / taskCount, 1);
+
+		// A range that is too large has its root updated here, then its child subtrees become
+		// ranges of their own: they only depend on that root, not on each other
+		std::vector<Range> split;
+		for (size_t i = 0; i < ranges.size(); ++i)
+		{
+			const Range range = ranges[i];
+			if (range.end - range.begin <= target)
+			{
+				split.push_back(range);
+				continue;
+			}
+
+			UpdateRange({ range.begin, range.begin + 1 });
+			for (Slot child = range.begin + 1; child < range.end; child = m_subtreeEnd[child])
+				ranges.push_back({ child, m_subtreeEnd[child] });
+		}
+
+		// Adjacent ranges are whole subtrees next to each other, merge them back up to the
+		// target size so wide, shallow trees do not turn into one task per leaf
+		std::sort(split.begin(), split.end(), [](const Range& a, const Range& b) { return a.begin < b.begin; });
+		ranges.clear();
+		for (const Range& range : split)
+		{
+			if (!ranges.empty() && ranges.back().end == range.begin && range.end - ranges.back().begin <= target)
+				ranges.back().end = range.end;
+			else
+				ranges.push_back(range);
+		}
+	}
+
+	//****************************************************************************
+	// Depth-first ordering
+
+	void TransformHierarchy::EnsureOrder()
+	{
+		if (m_orderDirty)
+			Rebuild();
+	}
+
+	void TransformHierarchy::Rebuild()
+	{
+		const Slot count = static_cast<Slot>(m_local.size());
+
+		// Children of every slot, in slot order, as one array indexed by offsets
+		std::vector<Slot> offsets(size_t(count) + 1, 0);
+		std::vector<Slot> roots;
+		for (Slot s = 0; s < count; ++s)
+		{
+			if (m_node[s] == InvalidNode)
+				continue;
+			if (m_parent[s] != InvalidSlot)
+				++offsets[m_parent[s] + 1];
+			else
+				roots.push_back(s);
+		}
+		for (Slot s = 0; s < count; ++s)
+			offsets[s + 1] += offsets[s];
+
+		std::vector<Slot> children(offsets[count]);
+		std::vector<Slot> fill(offsets.begin(), offsets.end() - 1);
+		for (Slot s = 0; s < count; ++s)
+		{
+			if (m_node[s] != InvalidNode && m_parent[s] != InvalidSlot)
+				children[fill[m_parent[s]]++] = s;
+		}
+
+		// Pre-order walk from every root
+		std::vector<Slot> order;
+		order.reserve(m_count);
+		std::vector<Slot> stack(roots.rbegin(), roots.rend());
+		while (!stack.empty())
+		{
+			const Slot s = stack.back();
+			stack.pop_back();
+			order.push_back(s);
+			for (Slot c = offsets[s + 1]; c > offsets[s]; --c)
+				stack.push_back(children[c - 1]);
+		}
+		assert(order.size() == m_count);
+
+		std::vector<Slot> newSlot(count, InvalidSlot);
+		for (Slot s = 0; s < static_cast<Slot>(order.size()); ++s)
+			newSlot[order[s]] = s;
+
+		std::vector<Matrix> local(order.size());
+		std::vector<Matrix> world(order.size());
+		std::vector<Slot> parent(order.size());
+		std::vector<Slot> subtreeEnd(order.size());
+		std::vector<NodeId> node(order.size());
+		std::vector<uint8_t> dirty(order.size());
+		for (Slot s = 0; s < static_cast<Slot>(order.size()); ++s)
+		{
+			const Slot old = order[s];
+			local[s] = m_local[old];
+			world[s] = m_world[old];
+			parent[s] = m_parent[old] != InvalidSlot ? newSlot[m_parent[old]] : InvalidSlot;
+			node[s] = m_node[old];
+			dirty[s] = m_dirty[old];
+			m_slot[node[s]] = s;
+		}
+
+		// Parents precede children, so subtree sizes accumulate in a single backward pass
+		std::vector<Slot> size(order.size(), 1);
+		for (Slot s = static_cast<Slot>(order.size()); s-- > 0;)
+		{
+			subtreeEnd[s] = s + size[s];
+			if (parent[s] != InvalidSlot)
+				size[parent[s]] += size[s];
+		}
+
+		m_local = std::move(local);
+		m_world = std::move(world);
+		m_parent = std::move(parent);
+		m_subtreeEnd = std::move(subtreeEnd);
+		m_node = std::move(node);
+		m_dirty = std::move(dirty);
+		m_orderDirty = false;
+	}
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "PMath.h"
+#include "PMathParallel.h"
+
+namespace PMgene::Math
+{
+	//****************************************************************************
+	// TransformHierarchy
+	// Parent/child transform tree stored in flat arrays sorted depth-first, so every parent comes
+	// before its children and every subtree occupies a contiguous range. World matrices are
+	// recomputed in one linear pass over the subtrees of nodes whose local transform changed.
+
+	class TransformHierarchy
+	{
+	public:
+		using NodeId = uint32_t;
+		static constexpr NodeId InvalidNode = UINT32_MAX;
+
+		TransformHierarchy() = default;
+
+		// Structure. Nodes keep their id for their whole lifetime; ids of destroyed nodes are reused.
+		NodeId Create(NodeId parent = InvalidNode, const Matrix& local = Matrix::Identity);
+		// Destroys the node and all of its descendants
+		void Destroy(NodeId node);
+		void SetParent(NodeId node, NodeId parent);
+
+		void Reserve(size_t count);
+		void Clear() noexcept;
+
+		[[nodiscard]] size_t Size() const noexcept { return m_count; }
+		[[nodiscard]] bool IsValid(NodeId node) const noexcept { return node < m_slot.size() && m_slot[node] != InvalidSlot; }
+		[[nodiscard]] NodeId Parent(NodeId node) const noexcept;
+
+		// Local transforms, relative to the parent. Setting one marks the node's subtree for update.
+		[[nodiscard]] const Matrix& GetLocal(NodeId node) const noexcept;
+		void SetLocal(NodeId node, const Matrix& local) noexcept;
+		void SetLocal(NodeId node, const SQT& local) noexcept;
+
+		// World transforms as of the last Update
+		[[nodiscard]] const Matrix& GetWorld(NodeId node) const noexcept;
+
+		// Recomputes world = local * parent world for every changed subtree. The parallel version
+		// splits independent subtrees across the Parallel scheduler; a policy grain sets the
+		// minimum number of nodes per task.
+		void Update();
+		void Update(const Parallel::ParallelPolicy& policy);
+
+		// Direct access in update order, valid until the next structural change or Update
+		[[nodiscard]] std::span<const Matrix> WorldMatrices() const noexcept { return m_world; }
+		[[nodiscard]] std::span<const NodeId> Nodes() const noexcept { return m_node; }
+
+	private:
+		using Slot = uint32_t;
+		static constexpr Slot InvalidSlot = UINT32_MAX;
+
+		struct Range
+		{
+			Slot begin;
+			Slot end;
+		};
+
+		void Rebuild();
+		void EnsureOrder();
+		size_t CollectChangedRanges(std::vector<Range>& ranges) const;
+		void UpdateRange(Range range) noexcept;
+		void SplitRanges(std::vector<Range>& ranges, size_t taskCount);
+
+		// Per slot, in depth-first order (after Rebuild)
+		std::vector<Matrix> m_local;
+		std::vector<Matrix> m_world;
+		std::vector<Slot> m_parent;
+		std::vector<Slot> m_subtreeEnd;
+		std::vector<NodeId> m_node;
+		std::vector<uint8_t> m_dirty;
+
+		// Live nodes, the slot arrays also hold destroyed ones until the next Rebuild
+		size_t m_count = 0;
+
+		// Per node id
+		std::vector<Slot> m_slot;
+		std::vector<NodeId> m_freeNodes;
+
+		// Slots are out of depth-first order or contain destroyed nodes
+		bool m_orderDirty = false;
+	};
+}
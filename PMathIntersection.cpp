@@ -0,0 +1,306 @@
+#include "PMathIntersection.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+#include "PMath.inl"
+#include "PMathBVHTraversal.h"
+#include "PMathCpu.h"
+#include "PMathKernels.h"
+
+namespace PMgene::Math
+{
+	//****************************************************************************
+	// Generic kernels
+
+	namespace Detail::Generic
+	{
+		namespace
+		{
+			BVHHit Miss() noexcept
+			{
+				return { FLT_MAX, UINT32_MAX, 0.f, 0.f };
+			}
+
+			void GatherTriangle(const TriangleView& triangles, size_t i, float* triangle) noexcept
+			{
+				const ConstStreamView3 rows[3] = { triangles.vertex, triangles.edge1, triangles.edge2 };
+				for (int k = 0; k < 3; ++k)
+				{
+					triangle[3 * k + 0] = rows[k].x[i];
+					triangle[3 * k + 1] = rows[k].y[i];
+					triangle[3 * k + 2] = rows[k].z[i];
+				}
+			}
+
+			void GatherBox(const BoxView& boxes, size_t i, float* box) noexcept
+			{
+				box[0] = boxes.min.x[i];
+				box[1] = boxes.min.y[i];
+				box[2] = boxes.min.z[i];
+				box[3] = boxes.max.x[i];
+				box[4] = boxes.max.y[i];
+				box[5] = boxes.max.z[i];
+			}
+		}
+
+		void RaycastTriangles(const TriangleView& triangles, const float* rays, float maxDistance, BVHHit* hits, size_t count) noexcept
+		{
+			for (size_t r = 0; r < count; ++r)
+			{
+				const BVHRay ray(rays + 6 * r);
+				BVHHit hit = { maxDistance, UINT32_MAX, 0.f, 0.f };
+				for (size_t i = 0; i < triangles.count; ++i)
+				{
+					float triangle[9], t, u, v;
+					GatherTriangle(triangles, i, triangle);
+					if (IntersectTriangle(triangle, ray, hit.distance, t, u, v))
+						hit = { t, static_cast<uint32_t>(i), u, v };
+				}
+				hits[r] = hit.primitive == UINT32_MAX ? Miss() : hit;
+			}
+		}
+
+		// Packets only pay off with SIMD, rays are tested one at a time here
+		void RaycastTrianglesPacket(const TriangleView& triangles, const float* rays, float maxDistance, BVHHit* hits, size_t count) noexcept
+		{
+			RaycastTriangles(triangles, rays, maxDistance, hits, count);
+		}
+
+		void RaycastBoxes(const BoxView& boxes, const float* rays, float maxDistance, BVHHit* hits, size_t count) noexcept
+		{
+			for (size_t r = 0; r < count; ++r)
+			{
+				const BVHRay ray(rays + 6 * r);
+				BVHHit hit = { maxDistance, UINT32_MAX, 0.f, 0.f };
+				for (size_t i = 0; i < boxes.count; ++i)
+				{
+					float box[6], t;
+					GatherBox(boxes, i, box);
+					if (IntersectBox(box, ray, hit.distance, t))
+						hit = { t, static_cast<uint32_t>(i), 0.f, 0.f };
+				}
+				hits[r] = hit.primitive == UINT32_MAX ? Miss() : hit;
+			}
+		}
+
+		void RaycastBoxesPacket(const BoxView& boxes, const float* rays, float maxDistance, BVHHit* hits, size_t count) noexcept
+		{
+			RaycastBoxes(boxes, rays, maxDistance, hits, count);
+		}
+	}
+
+	namespace
+	{
+		static_assert(sizeof(Ray) == 6 * sizeof(float), "Ray must be tightly packed for batch kernels");
+		static_assert(sizeof(RayHit) == sizeof(Detail::BVHHit) && offsetof(RayHit, primitive) == offsetof(Detail::BVHHit, primitive) &&
+		              offsetof(RayHit, u) == offsetof(Detail::BVHHit, u), "RayHit must match the kernel hit layout");
+
+		// Rays per parallel chunk, a multiple of the packet width. Every ray visits every
+		// primitive, so chunks are smaller than for the BVH.
+		constexpr size_t RayGrain = 64;
+
+		Detail::ConstStreamView3 View(const Vector3Stream& V) noexcept
+		{
+			return { V.x.data(), V.y.data(), V.z.data() };
+		}
+
+		Detail::TriangleView View(const TriangleStream& triangles) noexcept
+		{
+			return { View(triangles.vertex), View(triangles.edge1), View(triangles.edge2), triangles.Size() };
+		}
+
+		Detail::BoxView View(const AABBStream& boxes) noexcept
+		{
+			return { View(boxes.min), View(boxes.max), boxes.Size() };
+		}
+
+		const float* Data(std::span<const Ray> rays) noexcept
+		{
+			return reinterpret_cast<const float*>(rays.data());
+		}
+
+		Detail::BVHHit* Data(std::span<RayHit> hits) noexcept
+		{
+			return reinterpret_cast<Detail::BVHHit*>(hits.data());
+		}
+
+		template <bool Packet>
+		void RaycastKernel(const Detail::TriangleView& triangles, const float* rays, float maxDistance, Detail::BVHHit* hits, size_t count) noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+			{
+				if constexpr (Packet)
+					Detail::AVX2::RaycastTrianglesPacket(triangles, rays, maxDistance, hits, count);
+				else
+					Detail::AVX2::RaycastTriangles(triangles, rays, maxDistance, hits, count);
+				return;
+			}
+#endif
+			if constexpr (Packet)
+				Detail::Generic::RaycastTrianglesPacket(triangles, rays, maxDistance, hits, count);
+			else
+				Detail::Generic::RaycastTriangles(triangles, rays, maxDistance, hits, count);
+		}
+
+		template <bool Packet>
+		void RaycastKernel(const Detail::BoxView& boxes, const float* rays, float maxDistance, Detail::BVHHit* hits, size_t count) noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+			{
+				if constexpr (Packet)
+					Detail::AVX2::RaycastBoxesPacket(boxes, rays, maxDistance, hits, count);
+				else
+					Detail::AVX2::RaycastBoxes(boxes, rays, maxDistance, hits, count);
+				return;
+			}
+#endif
+			if constexpr (Packet)
+				Detail::Generic::RaycastBoxesPacket(boxes, rays, maxDistance, hits, count);
+			else
+				Detail::Generic::RaycastBoxes(boxes, rays, maxDistance, hits, count);
+		}
+
+		template <bool Packet, typename PrimitiveView>
+		void Raycast(const PrimitiveView& primitives, std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance) noexcept
+		{
+			assert(rays.size() == hits.size());
+			if (primitives.count == 0)
+				std::fill(hits.begin(), hits.end(), RayHit());
+			else
+				RaycastKernel<Packet>(primitives, Data(rays), maxDistance, Data(hits), rays.size());
+		}
+
+		template <bool Packet, typename PrimitiveView>
+		void Raycast(const Parallel::ParallelPolicy& policy, const PrimitiveView& primitives, std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance) noexcept
+		{
+			assert(rays.size() == hits.size());
+			if (primitives.count == 0)
+				return Raycast<Packet>(primitives, rays, hits, maxDistance);
+
+			const float* R = Data(rays);
+			Detail::BVHHit* H = Data(hits);
+			Parallel::ParallelFor(rays.size(), policy.grain != 0 ? policy.grain : RayGrain, [&](Parallel::Range range) {
+				RaycastKernel<Packet>(primitives, R + range.begin * 6, maxDistance, H + range.begin, range.Size());
+			});
+		}
+	}
+
+
+	//****************************************************************************
+	// TriangleStream
+
+	void TriangleStream::Clear() noexcept
+	{
+		vertex.Clear();
+		edge1.Clear();
+		edge2.Clear();
+	}
+
+	void TriangleStream::Load(std::span<const Vector3> vertices)
+	{
+		assert(vertices.size() % 3 == 0);
+		const size_t count = vertices.size() / 3;
+		vertex.Resize(count);
+		edge1.Resize(count);
+		edge2.Resize(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Vector3& v0 = vertices[3 * i];
+			vertex.Set(i, v0);
+			edge1.Set(i, vertices[3 * i + 1] - v0);
+			edge2.Set(i, vertices[3 * i + 2] - v0);
+		}
+	}
+
+	void TriangleStream::Load(std::span<const Vector3> vertices, std::span<const uint32_t> indices)
+	{
+		assert(indices.size() % 3 == 0);
+		const size_t count = indices.size() / 3;
+		vertex.Resize(count);
+		edge1.Resize(count);
+		edge2.Resize(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Vector3& v0 = vertices[indices[3 * i]];
+			vertex.Set(i, v0);
+			edge1.Set(i, vertices[indices[3 * i + 1]] - v0);
+			edge2.Set(i, vertices[indices[3 * i + 2]] - v0);
+		}
+	}
+
+	RayHit TriangleStream::Raycast(const Ray& ray, float maxDistance) const noexcept
+	{
+		RayHit hit;
+		Math::Raycast<false>(View(*this), std::span(&ray, 1), std::span(&hit, 1), maxDistance);
+		return hit;
+	}
+
+	void TriangleStream::Raycast(std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance) const noexcept
+	{
+		Math::Raycast<false>(View(*this), rays, hits, maxDistance);
+	}
+
+	void TriangleStream::RaycastPackets(std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance) const noexcept
+	{
+		Math::Raycast<true>(View(*this), rays, hits, maxDistance);
+	}
+
+	void TriangleStream::Raycast(const Parallel::ParallelPolicy& policy, std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance) const noexcept
+	{
+		Math::Raycast<false>(policy, View(*this), rays, hits, maxDistance);
+	}
+
+	void TriangleStream::RaycastPackets(const Parallel::ParallelPolicy& policy, std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance) const noexcept
+	{
+		Math::Raycast<true>(policy, View(*this), rays, hits, maxDistance);
+	}
+
+
+	//****************************************************************************
+	// AABBStream
+
+	void AABBStream::Clear() noexcept
+	{
+		min.Clear();
+		max.Clear();
+	}
+
+	void AABBStream::Load(std::span<const AABB> boxes)
+	{
+		min.Resize(boxes.size());
+		max.Resize(boxes.size());
+		for (size_t i = 0; i < boxes.size(); ++i)
+			Set(i, boxes[i]);
+	}
+
+	RayHit AABBStream::Raycast(const Ray& ray, float maxDistance) const noexcept
+	{
+		RayHit hit;
+		Math::Raycast<false>(View(*this), std::span(&ray, 1), std::span(&hit, 1), maxDistance);
+		return hit;
+	}
+
+	void AABBStream::Raycast(std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance) const noexcept
+	{
+		Math::Raycast<false>(View(*this), rays, hits, maxDistance);
+	}
+
+	void AABBStream::RaycastPackets(std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance) const noexcept
+	{
+		Math::Raycast<true>(View(*this), rays, hits, maxDistance);
+	}
+
+	void AABBStream::Raycast(const Parallel::ParallelPolicy& policy, std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance) const noexcept
+	{
+		Math::Raycast<false>(policy, View(*this), rays, hits, maxDistance);
+	}
+
+	void AABBStream::RaycastPackets(const Parallel::ParallelPolicy& policy, std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance) const noexcept
+	{
+		Math::Raycast<true>(policy, View(*this), rays, hits, maxDistance);
+	}
+}
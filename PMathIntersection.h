@@ -0,0 +1,116 @@
+#pragma once
+#include <cfloat>
+#include <cstdint>
+#include <span>
+
+#include "PMath.h"
+#include "PMathBounds.h"
+#include "PMathParallel.h"
+#include "PMathStream.h"
+
+namespace PMgene::Math
+{
+	struct RayHit
+	{
+		float distance = FLT_MAX;
+		uint32_t primitive = UINT32_MAX;
+		// Barycentric coordinates of the hit for triangles: point = (1 - u - v) * v0 + u * v1 + v * v2
+		float u = 0.f;
+		float v = 0.f;
+
+		[[nodiscard]] bool Hit() const noexcept { return primitive != UINT32_MAX; }
+	};
+
+
+	//****************************************************************************
+	// TriangleStream
+	// Structure-of-arrays triangles for casting rays against a flat list, like meshes too small or
+	// too dynamic to be worth a BVH. Each triangle is stored as its first vertex and the two edges
+	// from it, the form Möller-Trumbore reads. Raycast tests a ray against 8 triangles per AVX2
+	// iteration; RaycastPackets tests 8 rays against each triangle, reading the triangles once per
+	// 8 rays, which helps when they do not fit in cache. Hits follow BVH::Raycast, with primitive
+	// the triangle number.
+
+	struct TriangleStream
+	{
+		Vector3Stream vertex;
+		Vector3Stream edge1;
+		Vector3Stream edge2;
+
+		// Constructors
+		TriangleStream() noexcept = default;
+
+		// Three vertices per triangle
+		explicit TriangleStream(std::span<const Vector3> vertices)
+		{
+			Load(vertices);
+		}
+
+		// Indexed triangle list, three indices per triangle
+		TriangleStream(std::span<const Vector3> vertices, std::span<const uint32_t> indices)
+		{
+			Load(vertices, indices);
+		}
+
+		[[nodiscard]] size_t Size() const noexcept { return vertex.Size(); }
+		[[nodiscard]] bool Empty() const noexcept { return vertex.Empty(); }
+
+		void Clear() noexcept;
+
+		// Replace the triangles
+		void Load(std::span<const Vector3> vertices);
+		void Load(std::span<const Vector3> vertices, std::span<const uint32_t> indices);
+
+		// Queries. Closest hit closer than maxDistance; hits must have the size of rays.
+		[[nodiscard]] RayHit Raycast(const Ray& ray, float maxDistance = FLT_MAX) const noexcept;
+		void Raycast(std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance = FLT_MAX) const noexcept;
+		void RaycastPackets(std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance = FLT_MAX) const noexcept;
+
+		void Raycast(const Parallel::ParallelPolicy& policy, std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance = FLT_MAX) const noexcept;
+		void RaycastPackets(const Parallel::ParallelPolicy& policy, std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance = FLT_MAX) const noexcept;
+	};
+
+
+	//****************************************************************************
+	// AABBStream
+	// Structure-of-arrays boxes with the same queries, using the slab test. The distance is where
+	// the ray enters the box, 0 when it starts inside; u and v stay 0.
+
+	struct AABBStream
+	{
+		Vector3Stream min;
+		Vector3Stream max;
+
+		// Constructors
+		AABBStream() noexcept = default;
+
+		explicit AABBStream(std::span<const AABB> boxes)
+		{
+			Load(boxes);
+		}
+
+		[[nodiscard]] size_t Size() const noexcept { return min.Size(); }
+		[[nodiscard]] bool Empty() const noexcept { return min.Empty(); }
+
+		void Clear() noexcept;
+
+		// Element access
+		[[nodiscard]] AABB Get(size_t i) const noexcept { return AABB(min.Get(i), max.Get(i)); }
+		void Set(size_t i, const AABB& box) noexcept
+		{
+			min.Set(i, box.min);
+			max.Set(i, box.max);
+		}
+
+		// Replace the boxes
+		void Load(std::span<const AABB> boxes);
+
+		// Queries
+		[[nodiscard]] RayHit Raycast(const Ray& ray, float maxDistance = FLT_MAX) const noexcept;
+		void Raycast(std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance = FLT_MAX) const noexcept;
+		void RaycastPackets(std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance = FLT_MAX) const noexcept;
+
+		void Raycast(const Parallel::ParallelPolicy& policy, std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance = FLT_MAX) const noexcept;
+		void RaycastPackets(const Parallel::ParallelPolicy& policy, std::span<const Ray> rays, std::span<RayHit> hits, float maxDistance = FLT_MAX) const noexcept;
+	};
+}
@@ -0,0 +1,207 @@
+#include "PMathCpu.h"
+
+#if PMATH_X86
+#include <cfloat>
+#include <cstdint>
+
+#include "PMathAVX2.h"
+#include "PMathBVHTraversal.h"
+#include "PMathKernels.h"
+#include "PMathRayPacketAVX2.h"
+
+namespace PMgene::Math::Detail::AVX2
+{
+	namespace
+	{
+		// Best hit of each lane
+		struct LaneHits
+		{
+			__m256 closest;
+			__m256i primitive = _mm256_set1_epi32(-1);
+			__m256 u = _mm256_setzero_ps();
+			__m256 v = _mm256_setzero_ps();
+
+			explicit LaneHits(float maxDistance) noexcept : closest(_mm256_set1_ps(maxDistance))
+			{
+			}
+
+			void Update(__m256 hit, __m256 t, __m256i index, __m256 hitU, __m256 hitV) noexcept
+			{
+				closest = _mm256_blendv_ps(closest, t, hit);
+				primitive = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(primitive), _mm256_castsi256_ps(index), hit));
+				u = _mm256_blendv_ps(u, hitU, hit);
+				v = _mm256_blendv_ps(v, hitV, hit);
+			}
+
+			// Closest of the lanes, the lowest primitive on ties like the generic loop
+			BVHHit Reduce() const noexcept
+			{
+				alignas(32) float distance[8], hitU[8], hitV[8];
+				alignas(32) uint32_t index[8];
+				_mm256_store_ps(distance, closest);
+				_mm256_store_ps(hitU, u);
+				_mm256_store_ps(hitV, v);
+				_mm256_store_si256(reinterpret_cast<__m256i*>(index), primitive);
+
+				BVHHit hit = { FLT_MAX, UINT32_MAX, 0.f, 0.f };
+				for (int i = 0; i < 8; ++i)
+				{
+					if (index[i] != UINT32_MAX && (hit.primitive == UINT32_MAX || distance[i] < hit.distance ||
+					                               (distance[i] == hit.distance && index[i] < hit.primitive)))
+						hit = { distance[i], index[i], hitU[i], hitV[i] };
+				}
+				return hit;
+			}
+		};
+
+		// One ray against all triangles, 8 per iteration. The lanes past the end load zero edges,
+		// whose zero determinant never hits.
+		BVHHit RaycastTriangles8(const TriangleView& triangles, const float* rayData, float maxDistance) noexcept
+		{
+			const __m256 o[3] = { _mm256_set1_ps(rayData[0]), _mm256_set1_ps(rayData[1]), _mm256_set1_ps(rayData[2]) };
+			const __m256 d[3] = { _mm256_set1_ps(rayData[3]), _mm256_set1_ps(rayData[4]), _mm256_set1_ps(rayData[5]) };
+			const __m256 zero = _mm256_setzero_ps();
+			const __m256 one = _mm256_set1_ps(1.f);
+
+			LaneHits hits(maxDistance);
+			__m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+			ForEach8(triangles.count, [&](size_t i, auto lanes)
+			{
+				const __m256 e1[3] = { lanes.Load(triangles.edge1.x + i), lanes.Load(triangles.edge1.y + i), lanes.Load(triangles.edge1.z + i) };
+				const __m256 e2[3] = { lanes.Load(triangles.edge2.x + i), lanes.Load(triangles.edge2.y + i), lanes.Load(triangles.edge2.z + i) };
+
+				const __m256 p[3] = {
+					_mm256_fmsub_ps(d[1], e2[2], _mm256_mul_ps(d[2], e2[1])),
+					_mm256_fmsub_ps(d[2], e2[0], _mm256_mul_ps(d[0], e2[2])),
+					_mm256_fmsub_ps(d[0], e2[1], _mm256_mul_ps(d[1], e2[0]))
+				};
+				const __m256 det = _mm256_fmadd_ps(e1[0], p[0], _mm256_fmadd_ps(e1[1], p[1], _mm256_mul_ps(e1[2], p[2])));
+				const __m256 inverse = _mm256_div_ps(one, det);
+
+				const __m256 s[3] = {
+					_mm256_sub_ps(o[0], lanes.Load(triangles.vertex.x + i)),
+					_mm256_sub_ps(o[1], lanes.Load(triangles.vertex.y + i)),
+					_mm256_sub_ps(o[2], lanes.Load(triangles.vertex.z + i))
+				};
+				const __m256 u = _mm256_mul_ps(_mm256_fmadd_ps(s[0], p[0], _mm256_fmadd_ps(s[1], p[1], _mm256_mul_ps(s[2], p[2]))), inverse);
+
+				const __m256 q[3] = {
+					_mm256_fmsub_ps(s[1], e1[2], _mm256_mul_ps(s[2], e1[1])),
+					_mm256_fmsub_ps(s[2], e1[0], _mm256_mul_ps(s[0], e1[2])),
+					_mm256_fmsub_ps(s[0], e1[1], _mm256_mul_ps(s[1], e1[0]))
+				};
+				const __m256 v = _mm256_mul_ps(_mm256_fmadd_ps(d[0], q[0], _mm256_fmadd_ps(d[1], q[1], _mm256_mul_ps(d[2], q[2]))), inverse);
+				const __m256 t = _mm256_mul_ps(_mm256_fmadd_ps(e2[0], q[0], _mm256_fmadd_ps(e2[1], q[1], _mm256_mul_ps(e2[2], q[2]))), inverse);
+
+				// Ordered comparisons also reject the NaNs of parallel rays
+				__m256 hit = _mm256_cmp_ps(det, zero, _CMP_NEQ_OQ);
+				hit = _mm256_and_ps(hit, _mm256_cmp_ps(u, zero, _CMP_GE_OQ));
+				hit = _mm256_and_ps(hit, _mm256_cmp_ps(v, zero, _CMP_GE_OQ));
+				hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_add_ps(u, v), one, _CMP_LE_OQ));
+				hit = _mm256_and_ps(hit, _mm256_cmp_ps(t, zero, _CMP_GE_OQ));
+				hit = _mm256_and_ps(hit, _mm256_cmp_ps(t, hits.closest, _CMP_LT_OQ));
+
+				hits.Update(hit, t, index, u, v);
+				index = _mm256_add_epi32(index, _mm256_set1_epi32(8));
+			});
+			return hits.Reduce();
+		}
+
+		// One ray against all boxes, 8 per iteration. The ray's direction signs pick the near
+		// corner per axis for every lane at once, as in the BVH node test.
+		BVHHit RaycastBoxes8(const BoxView& boxes, const float* rayData, float maxDistance) noexcept
+		{
+			const BVHRay ray(rayData);
+			const float* rows[6] = { boxes.min.x, boxes.min.y, boxes.min.z, boxes.max.x, boxes.max.y, boxes.max.z };
+			const __m256 zero = _mm256_setzero_ps();
+
+			LaneHits hits(maxDistance);
+			__m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+			ForEach8(boxes.count, [&](size_t i, auto lanes)
+			{
+				__m256 t0 = zero;
+				__m256 t1 = hits.closest;
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					const __m256 inverse = _mm256_set1_ps(ray.inverse[axis]);
+					const __m256 scaledOrigin = _mm256_set1_ps(ray.scaledOrigin[axis]);
+					t0 = _mm256_max_ps(t0, _mm256_fmsub_ps(lanes.Load(rows[ray.nearRow[axis]] + i), inverse, scaledOrigin));
+					t1 = _mm256_min_ps(t1, _mm256_fmsub_ps(lanes.Load(rows[ray.FarRow(axis)] + i), inverse, scaledOrigin));
+				}
+
+				__m256 hit = _mm256_and_ps(_mm256_cmp_ps(t0, t1, _CMP_LE_OQ), _mm256_cmp_ps(t0, hits.closest, _CMP_LT_OQ));
+				// Past the end the boxes are points at the origin, which a ray may well hit
+				if constexpr (requires { lanes.mask; })
+					hit = _mm256_and_ps(hit, _mm256_castsi256_ps(lanes.mask));
+
+				hits.Update(hit, t0, index, zero, zero);
+				index = _mm256_add_epi32(index, _mm256_set1_epi32(8));
+			});
+			return hits.Reduce();
+		}
+
+		// 8 rays against every primitive; the lanes past the last ray are traced but not written
+		template <typename Test>
+		void RaycastPacket8(const float* rays, size_t count, float maxDistance, size_t primitiveCount, BVHHit* result, Test&& test) noexcept
+		{
+			const Packet P(rays, count);
+			LaneHits hits(maxDistance);
+			for (size_t i = 0; i < primitiveCount; ++i)
+			{
+				__m256 t, u = _mm256_setzero_ps(), v = _mm256_setzero_ps();
+				const __m256 hit = test(P, i, hits.closest, t, u, v);
+				hits.Update(hit, t, _mm256_set1_epi32(static_cast<int>(i)), u, v);
+			}
+
+			alignas(32) float distance[8], u[8], v[8];
+			alignas(32) uint32_t index[8];
+			_mm256_store_ps(distance, hits.closest);
+			_mm256_store_ps(u, hits.u);
+			_mm256_store_ps(v, hits.v);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(index), hits.primitive);
+			for (size_t k = 0; k < count; ++k)
+				result[k] = index[k] == UINT32_MAX ? BVHHit{ FLT_MAX, UINT32_MAX, 0.f, 0.f } : BVHHit{ distance[k], index[k], u[k], v[k] };
+		}
+	}
+
+	void RaycastTriangles(const TriangleView& triangles, const float* rays, float maxDistance, BVHHit* hits, size_t count) noexcept
+	{
+		for (size_t i = 0; i < count; ++i)
+			hits[i] = RaycastTriangles8(triangles, rays + 6 * i, maxDistance);
+	}
+
+	void RaycastTrianglesPacket(const TriangleView& triangles, const float* rays, float maxDistance, BVHHit* hits, size_t count) noexcept
+	{
+		const auto test = [&](const Packet& P, size_t i, __m256 closest, __m256& t, __m256& u, __m256& v) {
+			const float triangle[9] = {
+				triangles.vertex.x[i], triangles.vertex.y[i], triangles.vertex.z[i],
+				triangles.edge1.x[i], triangles.edge1.y[i], triangles.edge1.z[i],
+				triangles.edge2.x[i], triangles.edge2.y[i], triangles.edge2.z[i]
+			};
+			return P.TestTriangle(triangle, closest, t, u, v);
+		};
+
+		for (size_t i = 0; i < count; i += 8)
+			RaycastPacket8(rays + 6 * i, count - i < 8 ? count - i : 8, maxDistance, triangles.count, hits + i, test);
+	}
+
+	void RaycastBoxes(const BoxView& boxes, const float* rays, float maxDistance, BVHHit* hits, size_t count) noexcept
+	{
+		for (size_t i = 0; i < count; ++i)
+			hits[i] = RaycastBoxes8(boxes, rays + 6 * i, maxDistance);
+	}
+
+	void RaycastBoxesPacket(const BoxView& boxes, const float* rays, float maxDistance, BVHHit* hits, size_t count) noexcept
+	{
+		const auto test = [&](const Packet& P, size_t i, __m256 closest, __m256& t, __m256&, __m256&) {
+			const float lo[3] = { boxes.min.x[i], boxes.min.y[i], boxes.min.z[i] };
+			const float hi[3] = { boxes.max.x[i], boxes.max.y[i], boxes.max.z[i] };
+			const __m256 hit = P.TestBox(lo, hi, closest, t);
+			return _mm256_and_ps(hit, _mm256_cmp_ps(t, closest, _CMP_LT_OQ));
+		};
+
+		for (size_t i = 0; i < count; i += 8)
+			RaycastPacket8(rays + 6 * i, count - i < 8 ? count - i : 8, maxDistance, boxes.count, hits + i, test);
+	}
+}
+#endif
@@ -0,0 +1,471 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Raw batch kernels behind the stream types. Every instruction set is compiled in its own
+// translation unit with matching compiler flags, so this header must not contain inline code:
+// an inline function emitted by an AVX unit could be picked by the linker for generic callers.
+
+namespace PMgene::Math::Detail
+{
+	struct StreamView2
+	{
+		float* x;
+		float* y;
+	};
+
+	struct ConstStreamView2
+	{
+		const float* x;
+		const float* y;
+	};
+
+	struct StreamView3
+	{
+		float* x;
+		float* y;
+		float* z;
+	};
+
+	struct ConstStreamView3
+	{
+		const float* x;
+		const float* y;
+		const float* z;
+	};
+
+	struct StreamView4
+	{
+		float* x;
+		float* y;
+		float* z;
+		float* w;
+	};
+
+	struct ConstStreamView4
+	{
+		const float* x;
+		const float* y;
+		const float* z;
+		const float* w;
+	};
+
+	//****************************************************************************
+	// Vector3Stream
+
+	// Lerp reads factor i from t[i * tStride], so a stride of 0 broadcasts t[0]
+
+#define PMATH_VECTOR3_STREAM_KERNELS \
+	void Vector3Add(ConstStreamView3 a, ConstStreamView3 b, StreamView3 result, size_t count) noexcept; \
+	void Vector3Subtract(ConstStreamView3 a, ConstStreamView3 b, StreamView3 result, size_t count) noexcept; \
+	void Vector3Multiply(ConstStreamView3 a, ConstStreamView3 b, StreamView3 result, size_t count) noexcept; \
+	void Vector3Scale(ConstStreamView3 a, float s, StreamView3 result, size_t count) noexcept; \
+	void Vector3Lerp(ConstStreamView3 a, ConstStreamView3 b, const float* t, size_t tStride, StreamView3 result, size_t count) noexcept; \
+	void Vector3Dot(ConstStreamView3 a, ConstStreamView3 b, float* result, size_t count) noexcept; \
+	void Vector3Cross(ConstStreamView3 a, ConstStreamView3 b, StreamView3 result, size_t count) noexcept; \
+	void Vector3Length(ConstStreamView3 a, float* result, size_t count) noexcept; \
+	void Vector3Normalize(ConstStreamView3 a, StreamView3 result, size_t count) noexcept; \
+	void Vector3LoadAoS(const float* source, StreamView3 result, size_t count) noexcept; \
+	void Vector3StoreAoS(ConstStreamView3 a, float* destination, size_t count) noexcept;
+
+	namespace Generic
+	{
+		PMATH_VECTOR3_STREAM_KERNELS
+	}
+
+	namespace AVX2
+	{
+		PMATH_VECTOR3_STREAM_KERNELS
+	}
+
+	namespace AVX512
+	{
+		PMATH_VECTOR3_STREAM_KERNELS
+	}
+
+#undef PMATH_VECTOR3_STREAM_KERNELS
+
+	//****************************************************************************
+	// QuaternionStream
+
+	// Interpolation kernels read factor i from t[i * tStride], so a stride of 0 broadcasts t[0].
+	// They take the shorter arc, negating b per element where dot(a, b) < 0.
+	// Euler kernels lay angles out as Quaternion::ToEuler does: pitch in x, yaw in y, roll in z.
+#define PMATH_QUATERNION_STREAM_KERNELS \
+	void QuaternionNormalize(ConstStreamView4 a, StreamView4 result, size_t count) noexcept; \
+	void QuaternionLerp(ConstStreamView4 a, ConstStreamView4 b, const float* t, size_t tStride, StreamView4 result, size_t count) noexcept; \
+	void QuaternionSlerp(ConstStreamView4 a, ConstStreamView4 b, const float* t, size_t tStride, StreamView4 result, size_t count) noexcept; \
+	void QuaternionSlerpApproximate(ConstStreamView4 a, ConstStreamView4 b, const float* t, size_t tStride, StreamView4 result, size_t count) noexcept; \
+	void QuaternionLoadAoS(const float* source, StreamView4 result, size_t count) noexcept; \
+	void QuaternionStoreAoS(ConstStreamView4 a, float* destination, size_t count) noexcept; \
+	void QuaternionToEuler(ConstStreamView4 a, StreamView3 angles, size_t count) noexcept; \
+	void QuaternionFromYawPitchRoll(ConstStreamView3 angles, StreamView4 result, size_t count) noexcept;
+
+	namespace Generic
+	{
+		PMATH_QUATERNION_STREAM_KERNELS
+	}
+
+	namespace AVX2
+	{
+		PMATH_QUATERNION_STREAM_KERNELS
+	}
+
+#undef PMATH_QUATERNION_STREAM_KERNELS
+
+	//****************************************************************************
+	// Vector2Stream, Vector4Stream, Plane and RayStream
+
+	// Lerp reads factor i from t[i * tStride], as for Vector3Stream. Planes are 4 floats
+	// (nx, ny, nz, d) and spheres 4 floats (center, radius). Ray queries write the hit distance,
+	// or FLT_MAX for a miss.
+#define PMATH_VECTOR_STREAM_KERNELS \
+	void Vector2Add(ConstStreamView2 a, ConstStreamView2 b, StreamView2 result, size_t count) noexcept; \
+	void Vector2Subtract(ConstStreamView2 a, ConstStreamView2 b, StreamView2 result, size_t count) noexcept; \
+	void Vector2Multiply(ConstStreamView2 a, ConstStreamView2 b, StreamView2 result, size_t count) noexcept; \
+	void Vector2Scale(ConstStreamView2 a, float s, StreamView2 result, size_t count) noexcept; \
+	void Vector2Lerp(ConstStreamView2 a, ConstStreamView2 b, const float* t, size_t tStride, StreamView2 result, size_t count) noexcept; \
+	void Vector2Dot(ConstStreamView2 a, ConstStreamView2 b, float* result, size_t count) noexcept; \
+	void Vector2Length(ConstStreamView2 a, float* result, size_t count) noexcept; \
+	void Vector2Normalize(ConstStreamView2 a, StreamView2 result, size_t count) noexcept; \
+	void Vector2LoadAoS(const float* source, StreamView2 result, size_t count) noexcept; \
+	void Vector2StoreAoS(ConstStreamView2 a, float* destination, size_t count) noexcept; \
+	void Vector4Add(ConstStreamView4 a, ConstStreamView4 b, StreamView4 result, size_t count) noexcept; \
+	void Vector4Subtract(ConstStreamView4 a, ConstStreamView4 b, StreamView4 result, size_t count) noexcept; \
+	void Vector4Multiply(ConstStreamView4 a, ConstStreamView4 b, StreamView4 result, size_t count) noexcept; \
+	void Vector4Scale(ConstStreamView4 a, float s, StreamView4 result, size_t count) noexcept; \
+	void Vector4Lerp(ConstStreamView4 a, ConstStreamView4 b, const float* t, size_t tStride, StreamView4 result, size_t count) noexcept; \
+	void Vector4Dot(ConstStreamView4 a, ConstStreamView4 b, float* result, size_t count) noexcept; \
+	void Vector4Length(ConstStreamView4 a, float* result, size_t count) noexcept; \
+	void Vector4Normalize(ConstStreamView4 a, StreamView4 result, size_t count) noexcept; \
+	void Vector4LoadAoS(const float* source, StreamView4 result, size_t count) noexcept; \
+	void Vector4StoreAoS(ConstStreamView4 a, float* destination, size_t count) noexcept; \
+	void PlaneDistance(const float* plane, ConstStreamView3 points, float* result, size_t count) noexcept; \
+	void RayPlaneIntersect(ConstStreamView3 position, ConstStreamView3 direction, const float* plane, float* distance, size_t count) noexcept; \
+	void RaySphereIntersect(ConstStreamView3 position, ConstStreamView3 direction, const float* sphere, float* distance, size_t count) noexcept;
+
+	namespace Generic
+	{
+		PMATH_VECTOR_STREAM_KERNELS
+	}
+
+	namespace AVX2
+	{
+		PMATH_VECTOR_STREAM_KERNELS
+	}
+
+#undef PMATH_VECTOR_STREAM_KERNELS
+
+	//****************************************************************************
+	// Matrix transforms and concatenation
+
+	enum class TransformMode
+	{
+		Point,  // w = 1
+		Normal, // w = 0
+		Coord   // w = 1, then divided by the transformed w
+	};
+
+	// Outputs at least this large bypass the cache with non-temporal stores
+	constexpr size_t NonTemporalStoreBytes = size_t(4) << 20;
+
+	// Matrices are 16 floats in row-major order. The broadcast variants take a single matrix for
+	// the named operand and 'count' matrices for the other one.
+#define PMATH_TRANSFORM_KERNELS \
+	void Vector3TransformSoA(const float* matrix, TransformMode mode, ConstStreamView3 input, StreamView3 output, size_t count) noexcept; \
+	void Vector3TransformAoS(const float* matrix, TransformMode mode, const float* input, float* output, size_t count) noexcept; \
+	void MatrixMultiply(const float* a, const float* b, float* result, size_t count) noexcept; \
+	void MatrixMultiplyBroadcastA(const float* a, const float* b, float* result, size_t count) noexcept; \
+	void MatrixMultiplyBroadcastB(const float* a, const float* b, float* result, size_t count) noexcept;
+
+	namespace Generic
+	{
+		PMATH_TRANSFORM_KERNELS
+	}
+
+	namespace AVX2
+	{
+		PMATH_TRANSFORM_KERNELS
+	}
+
+#undef PMATH_TRANSFORM_KERNELS
+
+	//****************************************************************************
+	// 3x3 matrices
+
+	// Matrices are 9 floats, row-major, and eigenvalues 3 floats per matrix. Results may alias the
+	// inputs. Eigenvectors are stored as rows, sorted by decreasing eigenvalue.
+#define PMATH_MATRIX3_KERNELS \
+	void Matrix3Multiply(const float* a, const float* b, float* result, size_t count) noexcept; \
+	void Matrix3Rotate(const float* rotations, const float* tensors, float* result, size_t count) noexcept; \
+	void Matrix3EigenSymmetric(const float* matrices, float* eigenvalues, float* eigenvectors, size_t count) noexcept;
+
+	namespace Generic
+	{
+		PMATH_MATRIX3_KERNELS
+	}
+
+	namespace AVX2
+	{
+		PMATH_MATRIX3_KERNELS
+	}
+
+#undef PMATH_MATRIX3_KERNELS
+
+	//****************************************************************************
+	// Frustum culling
+
+	// Planes are 6 x (nx, ny, nz, d) with inward normals, boxes are 6 floats (min, max) and spheres
+	// 4 floats (center, radius). Mask kernels write all (count + 63) / 64 words, leaving the bits past
+	// 'count' clear. Index kernels write the visible indices in order and return their number; they
+	// may write scratch values up to index 'count' - 1 past the returned number.
+#define PMATH_BOUNDS_KERNELS \
+	void FrustumCullAABBMask(const float* planes, const float* boxes, uint64_t* mask, size_t count) noexcept; \
+	size_t FrustumCullAABBIndices(const float* planes, const float* boxes, uint32_t* indices, size_t count) noexcept; \
+	void FrustumCullSphereMask(const float* planes, const float* spheres, uint64_t* mask, size_t count) noexcept; \
+	size_t FrustumCullSphereIndices(const float* planes, const float* spheres, uint32_t* indices, size_t count) noexcept;
+
+	namespace Generic
+	{
+		PMATH_BOUNDS_KERNELS
+	}
+
+	namespace AVX2
+	{
+		PMATH_BOUNDS_KERNELS
+	}
+
+#undef PMATH_BOUNDS_KERNELS
+
+	//****************************************************************************
+	// Bounding volume hierarchy
+
+	constexpr uint32_t BVHLeafFlag = 0x80000000u;
+	constexpr uint32_t BVHEmptyChild = UINT32_MAX;
+
+	// 8-wide node with the child boxes stored SoA. Rows are min x, y, z then max x, y, z. Leaf
+	// children hold BVHLeafFlag | first primitive and a non-zero count; used slots come first and
+	// empty ones have inverted infinite bounds, so no box test ever hits them.
+	struct alignas(64) BVHNode
+	{
+		float bounds[6][8];
+		uint32_t child[8];
+		uint8_t count[8];
+	};
+
+	// Primitive data in leaf order: boxes are 6 floats (min, max), triangles 9 floats (vertex 0
+	// and the two edges from it) or null for box primitives, primitives the caller's indices.
+	struct BVHView
+	{
+		const BVHNode* nodes;
+		const float* boxes;
+		const float* triangles;
+		const uint32_t* primitives;
+	};
+
+	struct BVHHit
+	{
+		float distance;
+		uint32_t primitive;
+		float u;
+		float v;
+	};
+
+	// Rays are 6 floats (position, direction). Misses report primitive UINT32_MAX and distance
+	// FLT_MAX. The overlap kernel writes at most 'capacity' primitives but returns the full count.
+#define PMATH_BVH_KERNELS \
+	void BVHRaycast(const BVHView& bvh, const float* rays, float maxDistance, BVHHit* hits, size_t count) noexcept; \
+	void BVHRaycastPacket(const BVHView& bvh, const float* rays, float maxDistance, BVHHit* hits, size_t count) noexcept; \
+	void BVHOccluded(const BVHView& bvh, const float* rays, float maxDistance, uint8_t* occluded, size_t count) noexcept; \
+	size_t BVHOverlap(const BVHView& bvh, const float* box, uint32_t* primitives, size_t capacity) noexcept;
+
+	namespace Generic
+	{
+		PMATH_BVH_KERNELS
+	}
+
+	namespace AVX2
+	{
+		PMATH_BVH_KERNELS
+	}
+
+#undef PMATH_BVH_KERNELS
+
+	//****************************************************************************
+	// Ray intersection
+
+	// Flat primitive lists, SoA: triangles as vertex 0 and the two edges from it, boxes as their
+	// min and max corners
+	struct TriangleView
+	{
+		ConstStreamView3 vertex;
+		ConstStreamView3 edge1;
+		ConstStreamView3 edge2;
+		size_t count;
+	};
+
+	struct BoxView
+	{
+		ConstStreamView3 min;
+		ConstStreamView3 max;
+		size_t count;
+	};
+
+	// Rays and hits as for the BVH kernels, with primitive indices into the list. The single ray
+	// kernels test each ray against 8 primitives at a time, the packet kernels 8 rays against one.
+#define PMATH_INTERSECTION_KERNELS \
+	void RaycastTriangles(const TriangleView& triangles, const float* rays, float maxDistance, BVHHit* hits, size_t count) noexcept; \
+	void RaycastTrianglesPacket(const TriangleView& triangles, const float* rays, float maxDistance, BVHHit* hits, size_t count) noexcept; \
+	void RaycastBoxes(const BoxView& boxes, const float* rays, float maxDistance, BVHHit* hits, size_t count) noexcept; \
+	void RaycastBoxesPacket(const BoxView& boxes, const float* rays, float maxDistance, BVHHit* hits, size_t count) noexcept;
+
+	namespace Generic
+	{
+		PMATH_INTERSECTION_KERNELS
+	}
+
+	namespace AVX2
+	{
+		PMATH_INTERSECTION_KERNELS
+	}
+
+#undef PMATH_INTERSECTION_KERNELS
+
+	//****************************************************************************
+	// Spatial hash grid
+
+	// Points sorted by bucket, SoA, with the caller's index of each. A cell maps to the bucket
+	// (x & mask[0]) | (y & mask[1]) << shift[1] | (z & mask[2]) << shift[2] of its coordinates,
+	// and the points of bucket b are [cellStart[b], cellStart[b + 1]).
+	struct SpatialHashView
+	{
+		const float* x;
+		const float* y;
+		const float* z;
+		const uint32_t* indices;
+		const uint32_t* cellStart;
+		float inverseCellSize;
+		uint32_t mask[3];
+		uint32_t shift[3];
+	};
+
+	// Centers are 3 floats and distances are squared. The radius kernel writes at most 'capacity'
+	// indices but returns the full count. The nearest kernel keeps the k closest, sorted by
+	// distance then index, and returns how many it found.
+#define PMATH_SPATIAL_HASH_KERNELS \
+	size_t SpatialHashRadius(const SpatialHashView& grid, const float* center, float radius, uint32_t* neighbours, size_t capacity) noexcept; \
+	size_t SpatialHashNearest(const SpatialHashView& grid, const float* center, float radius, uint32_t* neighbours, float* distances, size_t k) noexcept;
+
+	namespace Generic
+	{
+		PMATH_SPATIAL_HASH_KERNELS
+	}
+
+	namespace AVX2
+	{
+		PMATH_SPATIAL_HASH_KERNELS
+	}
+
+#undef PMATH_SPATIAL_HASH_KERNELS
+
+	//****************************************************************************
+	// Packed formats
+
+	// Quaternions are 4 floats, vectors 3. Packed quaternions are 3 words or one 32-bit value each,
+	// packed vectors 3 words. Quantization takes 3 floats per parameter, one for every axis:
+	// encoding computes round((v - offset) * scale), decoding q * step + offset.
+#define PMATH_COMPRESSION_KERNELS \
+	void QuaternionEncode48(const float* input, uint16_t* output, size_t count) noexcept; \
+	void QuaternionDecode48(const uint16_t* input, float* output, size_t count) noexcept; \
+	void QuaternionEncode32(const float* input, uint32_t* output, size_t count) noexcept; \
+	void QuaternionDecode32(const uint32_t* input, float* output, size_t count) noexcept; \
+	void Vector3EncodeHalf(const float* input, uint16_t* output, size_t count) noexcept; \
+	void Vector3DecodeHalf(const uint16_t* input, float* output, size_t count) noexcept; \
+	void Vector3EncodeUnorm16(const float* input, const float* offset, const float* scale, uint16_t* output, size_t count) noexcept; \
+	void Vector3DecodeUnorm16(const uint16_t* input, const float* offset, const float* step, float* output, size_t count) noexcept; \
+	void Vector3EncodeSnorm16(const float* input, const float* offset, const float* scale, int16_t* output, size_t count) noexcept; \
+	void Vector3DecodeSnorm16(const int16_t* input, const float* offset, const float* step, float* output, size_t count) noexcept;
+
+	namespace Generic
+	{
+		PMATH_COMPRESSION_KERNELS
+	}
+
+	namespace AVX2
+	{
+		PMATH_COMPRESSION_KERNELS
+	}
+
+#undef PMATH_COMPRESSION_KERNELS
+
+	//****************************************************************************
+	// Skinning
+
+	// Slot k of vertex i is joints[k * stride + i] and weights[k * stride + i]
+	struct SkinView
+	{
+		const uint16_t* joints;
+		const float* weights;
+		size_t influences;
+		size_t stride;
+	};
+
+	// Palettes are 16 floats per joint for linear blending (a row-major Matrix) and 8 for dual
+	// quaternions (real, then dual part). Null normals skip the normal streams.
+#define PMATH_SKINNING_KERNELS \
+	void SkinLinearBlend(const float* palette, SkinView skin, ConstStreamView3 positions, ConstStreamView3 normals, \
+	                     StreamView3 skinnedPositions, StreamView3 skinnedNormals, size_t count) noexcept; \
+	void SkinDualQuaternionBlend(const float* palette, SkinView skin, ConstStreamView3 positions, ConstStreamView3 normals, \
+	                             StreamView3 skinnedPositions, StreamView3 skinnedNormals, size_t count) noexcept;
+
+	namespace Generic
+	{
+		PMATH_SKINNING_KERNELS
+	}
+
+	namespace AVX2
+	{
+		PMATH_SKINNING_KERNELS
+	}
+
+#undef PMATH_SKINNING_KERNELS
+
+	//****************************************************************************
+	// Rigid body integration
+
+	// Orientations are unit quaternions, angular velocities are world space
+	struct RigidBodyView
+	{
+		StreamView3 position;
+		StreamView3 velocity;
+		StreamView4 orientation;
+		StreamView3 angularVelocity;
+	};
+
+	// Element i is read at i * stride, so a stride of 0 applies element 0 to every body
+	struct AccelerationView
+	{
+		ConstStreamView3 linear;
+		ConstStreamView3 angular;
+		size_t linearStride;
+		size_t angularStride;
+	};
+
+	// Kick adds acceleration * kick to both velocities. KickDrift kicks, then moves every position by
+	// velocity * dt and every orientation by dt * 0.5 * (angularVelocity, 0) * q, renormalized.
+#define PMATH_RIGID_BODY_KERNELS \
+	void RigidBodyKick(RigidBodyView bodies, AccelerationView acceleration, float kick, size_t count) noexcept; \
+	void RigidBodyKickDrift(RigidBodyView bodies, AccelerationView acceleration, float kick, float dt, size_t count) noexcept;
+
+	namespace Generic
+	{
+		PMATH_RIGID_BODY_KERNELS
+	}
+
+	namespace AVX2
+	{
+		PMATH_RIGID_BODY_KERNELS
+	}
+
+#undef PMATH_RIGID_BODY_KERNELS
+}
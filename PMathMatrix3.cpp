@@ -0,0 +1,279 @@
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+#include "PMath.h"
+#include "PMathCpu.h"
+#include "PMathKernels.h"
+#include "PMathParallel.h"
+
+namespace PMgene::Math
+{
+	//****************************************************************************
+	// Portable 3x3 matrix kernels
+
+	namespace Detail::Generic
+	{
+		namespace
+		{
+			// Sweeps stop once the off-diagonal part holds less than this fraction of the squared
+			// Frobenius norm. Three sweeps usually get there; the limit only guards against
+			// denormal and non-finite input.
+			constexpr float JacobiTolerance = 1e-14f;
+			constexpr int JacobiMaxSweeps = 8;
+
+			// result = a * b for row-major 3x3 matrices; result may alias a or b
+			void Multiply(const float* a, const float* b, float* result) noexcept
+			{
+				float r[9];
+				for (int i = 0; i < 3; ++i)
+				{
+					for (int j = 0; j < 3; ++j)
+						r[i * 3 + j] = a[i * 3] * b[j] + a[i * 3 + 1] * b[3 + j] + a[i * 3 + 2] * b[6 + j];
+				}
+				for (int k = 0; k < 9; ++k)
+					result[k] = r[k];
+			}
+
+			// Zeroes apq with the rotation J of angle theta in plane (p, q): A' = J^T A J and V' = V J.
+			// arp and arq are the entries of the remaining row r.
+			void Rotate(float& app, float& aqq, float& apq, float& arp, float& arq, float (&v)[3][3], int p, int q) noexcept
+			{
+				if (apq == 0.f)
+					return;
+
+				const float theta = 0.5f * (aqq - app) / apq;
+				const float t = std::copysign(1.f, theta) / (std::fabs(theta) + std::sqrt(theta * theta + 1.f));
+				const float c = 1.f / std::sqrt(t * t + 1.f);
+				const float s = t * c;
+
+				app -= t * apq;
+				aqq += t * apq;
+				apq = 0.f;
+
+				const float rp = arp, rq = arq;
+				arp = c * rp - s * rq;
+				arq = s * rp + c * rq;
+
+				for (int r = 0; r < 3; ++r)
+				{
+					const float vp = v[r][p], vq = v[r][q];
+					v[r][p] = c * vp - s * vq;
+					v[r][q] = s * vp + c * vq;
+				}
+			}
+		}
+
+		void Matrix3Multiply(const float* a, const float* b, float* result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+				Multiply(a + i * 9, b + i * 9, result + i * 9);
+		}
+
+		void Matrix3Rotate(const float* rotations, const float* tensors, float* result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float* R = rotations + i * 9;
+				const float transposed[9] = { R[0], R[3], R[6], R[1], R[4], R[7], R[2], R[5], R[8] };
+				float tr[9];
+				Multiply(tensors + i * 9, R, tr);
+				Multiply(transposed, tr, result + i * 9);
+			}
+		}
+
+		void Matrix3EigenSymmetric(const float* matrices, float* eigenvalues, float* eigenvectors, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float* M = matrices + i * 9;
+				float a00 = M[0], a01 = M[1], a02 = M[2], a11 = M[4], a12 = M[5], a22 = M[8];
+
+				// Column j of v is the eigenvector of the diagonal entry j
+				float v[3][3] = { { 1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f }, { 0.f, 0.f, 1.f } };
+
+				const float norm = a00 * a00 + a11 * a11 + a22 * a22 + 2.f * (a01 * a01 + a02 * a02 + a12 * a12);
+				for (int sweep = 0; sweep < JacobiMaxSweeps; ++sweep)
+				{
+					if (a01 * a01 + a02 * a02 + a12 * a12 <= JacobiTolerance * norm)
+						break;
+					Rotate(a00, a11, a01, a02, a12, v, 0, 1);
+					Rotate(a00, a22, a02, a01, a12, v, 0, 2);
+					Rotate(a11, a22, a12, a01, a02, v, 1, 2);
+				}
+
+				// Sorting network for decreasing eigenvalues, swapping only on strict order
+				float d[3] = { a00, a11, a22 };
+				int order[3] = { 0, 1, 2 };
+				const auto exchange = [&](int x, int y) {
+					if (d[x] < d[y])
+					{
+						std::swap(d[x], d[y]);
+						std::swap(order[x], order[y]);
+					}
+				};
+				exchange(0, 1);
+				exchange(0, 2);
+				exchange(1, 2);
+
+				float* values = eigenvalues + i * 3;
+				float* vectors = eigenvectors + i * 9;
+				for (int k = 0; k < 2; ++k)
+				{
+					values[k] = d[k];
+					vectors[k * 3] = v[0][order[k]];
+					vectors[k * 3 + 1] = v[1][order[k]];
+					vectors[k * 3 + 2] = v[2][order[k]];
+				}
+				values[2] = d[2];
+
+				// The third row as the cross product of the first two keeps the rows a rotation
+				vectors[6] = vectors[1] * vectors[5] - vectors[2] * vectors[4];
+				vectors[7] = vectors[2] * vectors[3] - vectors[0] * vectors[5];
+				vectors[8] = vectors[0] * vectors[4] - vectors[1] * vectors[3];
+			}
+		}
+	}
+
+
+	//****************************************************************************
+	// Matrix3 batch operations
+
+	namespace
+	{
+		static_assert(sizeof(Matrix3) == 9 * sizeof(float), "Matrix3 must be tightly packed for batch kernels");
+		static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 must be tightly packed for batch kernels");
+
+		using BinaryKernel = void (*)(const float* a, const float* b, float* result, size_t count) noexcept;
+		using EigenKernel = void (*)(const float* matrices, float* eigenvalues, float* eigenvectors, size_t count) noexcept;
+
+		// Elements per parallel chunk, multiples of the SIMD width
+		constexpr size_t MultiplyGrain = 2048;
+		constexpr size_t EigenGrain = 512;
+
+		size_t Grain(const Parallel::ParallelPolicy& policy, size_t grain) noexcept
+		{
+			return policy.grain != 0 ? policy.grain : grain;
+		}
+
+		const float* Data(std::span<const Matrix3> M) noexcept
+		{
+			return reinterpret_cast<const float*>(M.data());
+		}
+
+		float* Data(std::span<Matrix3> M) noexcept
+		{
+			return reinterpret_cast<float*>(M.data());
+		}
+
+		float* Data(std::span<Vector3> V) noexcept
+		{
+			return reinterpret_cast<float*>(V.data());
+		}
+
+		BinaryKernel MultiplyKernel() noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+				return Detail::AVX2::Matrix3Multiply;
+#endif
+			return Detail::Generic::Matrix3Multiply;
+		}
+
+		BinaryKernel RotateKernel() noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+				return Detail::AVX2::Matrix3Rotate;
+#endif
+			return Detail::Generic::Matrix3Rotate;
+		}
+
+		EigenKernel EigenSymmetricKernel() noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+				return Detail::AVX2::Matrix3EigenSymmetric;
+#endif
+			return Detail::Generic::Matrix3EigenSymmetric;
+		}
+
+		void Binary(const Parallel::ParallelPolicy* policy, BinaryKernel kernel, std::span<const Matrix3> a, std::span<const Matrix3> b,
+		            std::span<Matrix3> result) noexcept
+		{
+			assert(a.size() == b.size() && result.size() == a.size());
+
+			const float* A = Data(a);
+			const float* B = Data(b);
+			float* R = Data(result);
+			if (!policy)
+			{
+				kernel(A, B, R, a.size());
+				return;
+			}
+
+			Parallel::ParallelFor(a.size(), Grain(*policy, MultiplyGrain), [&](Parallel::Range range) {
+				kernel(A + range.begin * 9, B + range.begin * 9, R + range.begin * 9, range.Size());
+			});
+		}
+
+		void Eigen(const Parallel::ParallelPolicy* policy, std::span<const Matrix3> matrices, std::span<Vector3> eigenvalues,
+		           std::span<Matrix3> eigenvectors) noexcept
+		{
+			assert(eigenvalues.size() == matrices.size() && eigenvectors.size() == matrices.size());
+
+			const EigenKernel kernel = EigenSymmetricKernel();
+			const float* M = Data(matrices);
+			float* values = Data(eigenvalues);
+			float* vectors = Data(eigenvectors);
+			if (!policy)
+			{
+				kernel(M, values, vectors, matrices.size());
+				return;
+			}
+
+			Parallel::ParallelFor(matrices.size(), Grain(*policy, EigenGrain), [&](Parallel::Range range) {
+				kernel(M + range.begin * 9, values + range.begin * 3, vectors + range.begin * 9, range.Size());
+			});
+		}
+	}
+
+	void Matrix3::EigenSymmetric(Vector3& eigenvalues, Matrix3& eigenvectors) const noexcept
+	{
+		// One matrix leaves nothing to vectorize across
+		Detail::Generic::Matrix3EigenSymmetric(&_11, &eigenvalues.x, &eigenvectors._11, 1);
+	}
+
+	void Matrix3::MultiplyBatch(std::span<const Matrix3> a, std::span<const Matrix3> b, std::span<Matrix3> result) noexcept
+	{
+		Binary(nullptr, MultiplyKernel(), a, b, result);
+	}
+
+	void Matrix3::MultiplyBatch(const Parallel::ParallelPolicy& policy, std::span<const Matrix3> a, std::span<const Matrix3> b,
+	                            std::span<Matrix3> result) noexcept
+	{
+		Binary(&policy, MultiplyKernel(), a, b, result);
+	}
+
+	void Matrix3::RotateBatch(std::span<const Matrix3> rotations, std::span<const Matrix3> tensors, std::span<Matrix3> result) noexcept
+	{
+		Binary(nullptr, RotateKernel(), rotations, tensors, result);
+	}
+
+	void Matrix3::RotateBatch(const Parallel::ParallelPolicy& policy, std::span<const Matrix3> rotations, std::span<const Matrix3> tensors,
+	                          std::span<Matrix3> result) noexcept
+	{
+		Binary(&policy, RotateKernel(), rotations, tensors, result);
+	}
+
+	void Matrix3::EigenSymmetricBatch(std::span<const Matrix3> matrices, std::span<Vector3> eigenvalues, std::span<Matrix3> eigenvectors) noexcept
+	{
+		Eigen(nullptr, matrices, eigenvalues, eigenvectors);
+	}
+
+	void Matrix3::EigenSymmetricBatch(const Parallel::ParallelPolicy& policy, std::span<const Matrix3> matrices, std::span<Vector3> eigenvalues,
+	                                  std::span<Matrix3> eigenvectors) noexcept
+	{
+		Eigen(&policy, matrices, eigenvalues, eigenvectors);
+	}
+}
@@ -0,0 +1,183 @@
+#include "PMathCpu.h"
+
+#if PMATH_X86
+#include <bit>
+
+#include "PMathAVX2.h"
+#include "PMathKernels.h"
+
+namespace PMgene::Math::Detail::AVX2
+{
+	namespace
+	{
+		// Same stopping rule as the generic kernel, applied once every lane meets it
+		constexpr float JacobiTolerance = 1e-14f;
+		constexpr int JacobiMaxSweeps = 8;
+
+		template <typename Lanes>
+		inline int LaneCount(Lanes lanes) noexcept
+		{
+			if constexpr (requires { lanes.mask; })
+				return std::popcount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(lanes.mask))));
+			else
+				return 8;
+		}
+
+		// Element k of the 8 arrays of N floats from p into m[k], one array per lane. Tail lanes read
+		// as zero.
+		template <int N, typename Lanes>
+		inline void Load8(const float* p, Lanes lanes, __m256 (&m)[N]) noexcept
+		{
+			const __m256i offsets = _mm256_setr_epi32(0, N, 2 * N, 3 * N, 4 * N, 5 * N, 6 * N, 7 * N);
+			for (int k = 0; k < N; ++k)
+			{
+				if constexpr (requires { lanes.mask; })
+					m[k] = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), p + k, offsets, _mm256_castsi256_ps(lanes.mask), 4);
+				else
+					m[k] = _mm256_i32gather_ps(p + k, offsets, 4);
+			}
+		}
+
+		// Inverse of Load8, writing the active lanes only
+		template <int N, typename Lanes>
+		inline void Store8(float* p, Lanes lanes, const __m256 (&m)[N]) noexcept
+		{
+			alignas(32) float transposed[N][8];
+			for (int k = 0; k < N; ++k)
+				_mm256_store_ps(transposed[k], m[k]);
+
+			const int count = LaneCount(lanes);
+			for (int lane = 0; lane < count; ++lane)
+			{
+				for (int k = 0; k < N; ++k)
+					p[lane * N + k] = transposed[k][lane];
+			}
+		}
+
+		// r = a * b for 8 pairs of row-major 3x3 matrices; r must not alias a or b
+		inline void Multiply(const __m256 (&a)[9], const __m256 (&b)[9], __m256 (&r)[9]) noexcept
+		{
+			for (int i = 0; i < 3; ++i)
+			{
+				for (int j = 0; j < 3; ++j)
+					r[i * 3 + j] = _mm256_fmadd_ps(a[i * 3 + 2], b[6 + j], _mm256_fmadd_ps(a[i * 3 + 1], b[3 + j], _mm256_mul_ps(a[i * 3], b[j])));
+			}
+		}
+
+		// Zeroes apq with the rotation J in plane (p, q), A' = J^T A J and V' = V J, as in the generic
+		// kernel. Lanes where apq is already zero are left alone.
+		inline void Rotate(__m256& app, __m256& aqq, __m256& apq, __m256& arp, __m256& arq, __m256 (&v)[9], int p, int q) noexcept
+		{
+			const __m256 one = _mm256_set1_ps(1.f);
+			const __m256 sign = _mm256_set1_ps(-0.f);
+
+			const __m256 theta = _mm256_mul_ps(_mm256_set1_ps(0.5f), _mm256_div_ps(_mm256_sub_ps(aqq, app), apq));
+			const __m256 numerator = _mm256_or_ps(one, _mm256_and_ps(theta, sign));
+			const __m256 denominator = _mm256_add_ps(_mm256_andnot_ps(sign, theta), _mm256_sqrt_ps(_mm256_fmadd_ps(theta, theta, one)));
+			const __m256 nonZero = _mm256_cmp_ps(apq, _mm256_setzero_ps(), _CMP_NEQ_OQ);
+			const __m256 t = _mm256_and_ps(_mm256_div_ps(numerator, denominator), nonZero);
+			const __m256 c = _mm256_div_ps(one, _mm256_sqrt_ps(_mm256_fmadd_ps(t, t, one)));
+			const __m256 s = _mm256_mul_ps(t, c);
+
+			const __m256 tApq = _mm256_mul_ps(t, apq);
+			app = _mm256_sub_ps(app, tApq);
+			aqq = _mm256_add_ps(aqq, tApq);
+			apq = _mm256_andnot_ps(nonZero, apq);
+
+			const __m256 rp = arp;
+			arp = _mm256_fmsub_ps(c, rp, _mm256_mul_ps(s, arq));
+			arq = _mm256_fmadd_ps(s, rp, _mm256_mul_ps(c, arq));
+
+			for (int r = 0; r < 3; ++r)
+			{
+				const __m256 vp = v[r * 3 + p], vq = v[r * 3 + q];
+				v[r * 3 + p] = _mm256_fmsub_ps(c, vp, _mm256_mul_ps(s, vq));
+				v[r * 3 + q] = _mm256_fmadd_ps(s, vp, _mm256_mul_ps(c, vq));
+			}
+		}
+
+		// Moves the larger of d[x] and d[y] to x, with its column of v
+		inline void Exchange(__m256 (&d)[3], __m256 (&v)[9], int x, int y) noexcept
+		{
+			const __m256 swap = _mm256_cmp_ps(d[x], d[y], _CMP_LT_OQ);
+			const __m256 dx = d[x];
+			d[x] = _mm256_blendv_ps(dx, d[y], swap);
+			d[y] = _mm256_blendv_ps(d[y], dx, swap);
+			for (int r = 0; r < 3; ++r)
+			{
+				const __m256 vx = v[r * 3 + x];
+				v[r * 3 + x] = _mm256_blendv_ps(vx, v[r * 3 + y], swap);
+				v[r * 3 + y] = _mm256_blendv_ps(v[r * 3 + y], vx, swap);
+			}
+		}
+	}
+
+	void Matrix3Multiply(const float* a, const float* b, float* result, size_t count) noexcept
+	{
+		ForEach8(count, [&](size_t i, auto lanes) {
+			__m256 A[9], B[9], R[9];
+			Load8(a + i * 9, lanes, A);
+			Load8(b + i * 9, lanes, B);
+			Multiply(A, B, R);
+			Store8(result + i * 9, lanes, R);
+		});
+	}
+
+	void Matrix3Rotate(const float* rotations, const float* tensors, float* result, size_t count) noexcept
+	{
+		ForEach8(count, [&](size_t i, auto lanes) {
+			__m256 R[9], T[9], TR[9], Rt[9], out[9];
+			Load8(rotations + i * 9, lanes, R);
+			Load8(tensors + i * 9, lanes, T);
+			Multiply(T, R, TR);
+			for (int j = 0; j < 3; ++j)
+			{
+				for (int k = 0; k < 3; ++k)
+					Rt[j * 3 + k] = R[k * 3 + j];
+			}
+			Multiply(Rt, TR, out);
+			Store8(result + i * 9, lanes, out);
+		});
+	}
+
+	void Matrix3EigenSymmetric(const float* matrices, float* eigenvalues, float* eigenvectors, size_t count) noexcept
+	{
+		ForEach8(count, [&](size_t i, auto lanes) {
+			__m256 M[9];
+			Load8(matrices + i * 9, lanes, M);
+			__m256 a00 = M[0], a01 = M[1], a02 = M[2], a11 = M[4], a12 = M[5], a22 = M[8];
+
+			// Column j of v is the eigenvector of the diagonal entry j
+			const __m256 zero = _mm256_setzero_ps();
+			const __m256 one = _mm256_set1_ps(1.f);
+			__m256 v[9] = { one, zero, zero, zero, one, zero, zero, zero, one };
+
+			const __m256 offDiagonal0 = _mm256_fmadd_ps(a12, a12, _mm256_fmadd_ps(a02, a02, _mm256_mul_ps(a01, a01)));
+			const __m256 diagonal = _mm256_fmadd_ps(a22, a22, _mm256_fmadd_ps(a11, a11, _mm256_mul_ps(a00, a00)));
+			const __m256 threshold = _mm256_mul_ps(_mm256_set1_ps(JacobiTolerance), _mm256_fmadd_ps(_mm256_set1_ps(2.f), offDiagonal0, diagonal));
+			for (int sweep = 0; sweep < JacobiMaxSweeps; ++sweep)
+			{
+				const __m256 offDiagonal = _mm256_fmadd_ps(a12, a12, _mm256_fmadd_ps(a02, a02, _mm256_mul_ps(a01, a01)));
+				if (_mm256_movemask_ps(_mm256_cmp_ps(offDiagonal, threshold, _CMP_LE_OQ)) == 0xFF)
+					break;
+				Rotate(a00, a11, a01, a02, a12, v, 0, 1);
+				Rotate(a00, a22, a02, a01, a12, v, 0, 2);
+				Rotate(a11, a22, a12, a01, a02, v, 1, 2);
+			}
+
+			__m256 d[3] = { a00, a11, a22 };
+			Exchange(d, v, 0, 1);
+			Exchange(d, v, 0, 2);
+			Exchange(d, v, 1, 2);
+			Store8(eigenvalues + i * 3, lanes, d);
+
+			// Rows are the sorted columns, the third the cross product of the first two
+			__m256 E[9] = { v[0], v[3], v[6], v[1], v[4], v[7] };
+			E[6] = _mm256_fmsub_ps(E[1], E[5], _mm256_mul_ps(E[2], E[4]));
+			E[7] = _mm256_fmsub_ps(E[2], E[3], _mm256_mul_ps(E[0], E[5]));
+			E[8] = _mm256_fmsub_ps(E[0], E[4], _mm256_mul_ps(E[1], E[3]));
+			Store8(eigenvectors + i * 9, lanes, E);
+		});
+	}
+}
+#endif
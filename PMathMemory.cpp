@@ -0,0 +1,152 @@
+#include "PMathMemory.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+namespace PMgene::Math
+{
+	namespace
+	{
+		constexpr bool IsPowerOfTwo(std::size_t value) noexcept
+		{
+			return value != 0 && (value & (value - 1)) == 0;
+		}
+
+		constexpr std::size_t AlignUp(std::size_t value, std::size_t alignment) noexcept
+		{
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+	}
+
+	//****************************************************************************
+	// FrameArena
+
+	FrameArena::FrameArena(std::size_t capacity, std::size_t alignment, std::pmr::memory_resource* upstream)
+		: m_upstream(upstream), m_capacity(capacity), m_alignment(alignment)
+	{
+		assert(IsPowerOfTwo(alignment));
+		if (m_capacity != 0)
+			m_buffer = static_cast<std::byte*>(m_upstream->allocate(m_capacity, m_alignment));
+	}
+
+	FrameArena::~FrameArena()
+	{
+		ReleaseOverflow();
+		if (m_buffer)
+			m_upstream->deallocate(m_buffer, m_capacity, m_alignment);
+	}
+
+	void FrameArena::Reset()
+	{
+		const bool overflowed = !m_overflow.empty();
+		ReleaseOverflow();
+		m_offset = 0;
+		m_overflowBytes = 0;
+		m_demand = 0;
+
+		// Grow to the high-water mark, so the next frame fits without the upstream
+		if (overflowed && m_highWater > m_capacity)
+		{
+			const std::size_t capacity = AlignUp(m_highWater, m_alignment);
+			if (m_buffer)
+				m_upstream->deallocate(m_buffer, m_capacity, m_alignment);
+			m_buffer = nullptr;
+			m_capacity = 0;
+			m_buffer = static_cast<std::byte*>(m_upstream->allocate(capacity, m_alignment));
+			m_capacity = capacity;
+		}
+	}
+
+	void* FrameArena::do_allocate(std::size_t bytes, std::size_t alignment)
+	{
+		alignment = std::max(alignment, m_alignment);
+
+		// The demand counts the worst-case padding, so a buffer of the high-water mark fits the
+		// same frame again whatever the packing
+		m_demand += bytes + alignment - 1;
+		m_highWater = std::max(m_highWater, m_demand);
+
+		if (m_buffer)
+		{
+			const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(m_buffer);
+			const std::size_t offset = AlignUp(base + m_offset, alignment) - base;
+			if (offset <= m_capacity && bytes <= m_capacity - offset)
+			{
+				m_offset = offset + bytes;
+				return m_buffer + offset;
+			}
+		}
+
+		m_overflow.reserve(m_overflow.size() + 1);
+		void* p = m_upstream->allocate(bytes, alignment);
+		m_overflow.push_back({ p, bytes, alignment });
+		m_overflowBytes += bytes;
+		return p;
+	}
+
+	void FrameArena::ReleaseOverflow() noexcept
+	{
+		for (const Overflow& overflow : m_overflow)
+			m_upstream->deallocate(overflow.p, overflow.bytes, overflow.alignment);
+		m_overflow.clear();
+	}
+
+
+	//****************************************************************************
+	// BlockPool
+
+	BlockPool::BlockPool(std::size_t blockSize, std::size_t blocksPerChunk, std::size_t alignment, std::pmr::memory_resource* upstream)
+		: m_upstream(upstream),
+		  m_blockSize(AlignUp(std::max(blockSize, sizeof(FreeBlock)), alignment)),
+		  m_blocksPerChunk(std::max<std::size_t>(blocksPerChunk, 1)),
+		  m_alignment(alignment)
+	{
+		assert(IsPowerOfTwo(alignment) && alignment >= alignof(FreeBlock));
+	}
+
+	BlockPool::~BlockPool()
+	{
+		Release();
+	}
+
+	void BlockPool::Release() noexcept
+	{
+		for (void* chunk : m_chunks)
+			m_upstream->deallocate(chunk, m_blockSize * m_blocksPerChunk, m_alignment);
+		m_chunks.clear();
+		m_free = nullptr;
+	}
+
+	void* BlockPool::do_allocate(std::size_t bytes, std::size_t alignment)
+	{
+		if (!Fits(bytes, alignment))
+			return m_upstream->allocate(bytes, alignment);
+
+		if (!m_free)
+		{
+			m_chunks.reserve(m_chunks.size() + 1);
+			std::byte* chunk = static_cast<std::byte*>(m_upstream->allocate(m_blockSize * m_blocksPerChunk, m_alignment));
+			m_chunks.push_back(chunk);
+
+			// Thread the chunk's blocks onto the free list, first block on top
+			for (std::size_t i = m_blocksPerChunk; i-- > 0;)
+				m_free = ::new (chunk + i * m_blockSize) FreeBlock{ m_free };
+		}
+
+		FreeBlock* block = m_free;
+		m_free = block->next;
+		return block;
+	}
+
+	void BlockPool::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) noexcept
+	{
+		if (!Fits(bytes, alignment))
+		{
+			m_upstream->deallocate(p, bytes, alignment);
+			return;
+		}
+
+		m_free = ::new (p) FreeBlock{ m_free };
+	}
+}
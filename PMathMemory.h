@@ -0,0 +1,210 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "PMath.h"
+
+namespace PMgene::Math
+{
+	//****************************************************************************
+	// Aligned allocation
+
+	template <typename T, std::size_t Alignment>
+	struct AlignedAllocator
+	{
+		static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+		static_assert(Alignment >= alignof(T), "Alignment must not be weaker than the type's alignment");
+
+		using value_type = T;
+
+		template <typename U>
+		struct rebind
+		{
+			using other = AlignedAllocator<U, Alignment>;
+		};
+
+		AlignedAllocator() noexcept = default;
+
+		template <typename U>
+		AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept
+		{
+		}
+
+		[[nodiscard]] T* allocate(std::size_t count)
+		{
+			return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{ Alignment }));
+		}
+
+		void deallocate(T* p, std::size_t count) noexcept
+		{
+			::operator delete(p, count * sizeof(T), std::align_val_t{ Alignment });
+		}
+
+		template <typename U>
+		bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+	};
+
+	// 64 bytes covers a cache line and a full AVX-512 register
+	template <typename T, std::size_t Alignment = 64>
+	using AlignedVector = std::vector<T, AlignedAllocator<T, Alignment>>;
+
+
+	//****************************************************************************
+	// Aligned storage
+	// The XMFLOAT base types only guarantee 4-byte alignment, so a Matrix can straddle two cache
+	// lines. Aligned<T> is a T that starts on an Alignment boundary and converts to and from T.
+	// Where the alignment does not pad it (every Matrix variant, Quaternion at 16), arrays of it
+	// reach the batch functions through AsSpan.
+
+	template <typename T, std::size_t Alignment>
+	struct alignas(Alignment) Aligned : T
+	{
+		static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+		using Type = T;
+
+		using T::T;
+		constexpr Aligned() noexcept = default;
+		constexpr Aligned(const T& V) noexcept : T(V) {}
+	};
+
+	template <std::size_t Alignment = 64>
+	using AlignedMatrix = Aligned<Matrix, Alignment>;
+	template <std::size_t Alignment = 16>
+	using AlignedQuaternion = Aligned<Quaternion, Alignment>;
+	template <std::size_t Alignment = 16>
+	using AlignedVector3 = Aligned<Vector3, Alignment>;
+
+	namespace Detail
+	{
+		template <typename A>
+		concept UnpaddedAligned = requires { typename std::remove_const_t<A>::Type; }
+		                          && std::is_base_of_v<typename std::remove_const_t<A>::Type, std::remove_const_t<A>>
+		                          && sizeof(A) == sizeof(typename std::remove_const_t<A>::Type);
+	}
+
+	// Views a contiguous range of Aligned<T> as a span of T
+	template <std::ranges::contiguous_range R>
+		requires Detail::UnpaddedAligned<std::remove_reference_t<std::ranges::range_reference_t<R>>>
+	[[nodiscard]] auto AsSpan(R&& range) noexcept
+	{
+		using A = std::remove_reference_t<std::ranges::range_reference_t<R>>;
+		using T = std::conditional_t<std::is_const_v<A>, const typename std::remove_const_t<A>::Type, typename A::Type>;
+		return std::span<T>(static_cast<T*>(std::ranges::data(range)), std::ranges::size(range));
+	}
+
+
+	//****************************************************************************
+	// FrameArena
+	// Linear std::pmr resource for scratch memory that lives for one frame. Allocation bumps an
+	// offset, deallocation does nothing and Reset releases everything at once. Requests that do not
+	// fit the buffer go to the upstream resource until the next Reset, which grows the buffer to the
+	// frame's high-water mark, so a steady workload stops reaching the upstream after one frame.
+	// Every allocation is aligned to at least the arena's alignment. Not synchronized; use one arena
+	// per thread.
+	//
+	//   FrameArena arena(1 << 20);
+	//   std::pmr::vector<Matrix> palette(jointCount, &arena);
+	//   ...
+	//   arena.Reset();
+
+	class FrameArena final : public std::pmr::memory_resource
+	{
+	public:
+		explicit FrameArena(std::size_t capacity, std::size_t alignment = 64,
+		                    std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+		~FrameArena() override;
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+
+		// Invalidates every allocation made since the last Reset
+		void Reset();
+
+		[[nodiscard]] std::size_t Capacity() const noexcept { return m_capacity; }
+		// Bytes handed out since the last Reset, including padding and overflow
+		[[nodiscard]] std::size_t Used() const noexcept { return m_offset + m_overflowBytes; }
+		// Largest frame so far, with worst-case alignment padding
+		[[nodiscard]] std::size_t HighWater() const noexcept { return m_highWater; }
+
+	private:
+		struct Overflow
+		{
+			void* p;
+			std::size_t bytes;
+			std::size_t alignment;
+		};
+
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+		void do_deallocate(void*, std::size_t, std::size_t) noexcept override {}
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+		void ReleaseOverflow() noexcept;
+
+		std::pmr::memory_resource* m_upstream;
+		std::byte* m_buffer = nullptr;
+		std::size_t m_capacity;
+		std::size_t m_alignment;
+		std::size_t m_offset = 0;
+		std::size_t m_overflowBytes = 0;
+		std::size_t m_demand = 0;
+		std::size_t m_highWater = 0;
+		std::vector<Overflow> m_overflow;
+	};
+
+
+	//****************************************************************************
+	// BlockPool
+	// std::pmr resource handing out fixed-size blocks from a free list, for arrays that are allocated
+	// and freed over and over at the same size, like skinning palettes or per-object vertex scratch.
+	// Blocks are carved from chunks of the upstream resource, blocksPerChunk at a time, and only
+	// return to it on Release or destruction. Requests larger than a block, or more strictly aligned,
+	// pass through to the upstream. Not synchronized; use one pool per thread.
+	//
+	//   BlockPool pool(sizeof(Matrix) * MaxJoints);
+	//   std::pmr::vector<Matrix> palette(jointCount, &pool);
+
+	class BlockPool final : public std::pmr::memory_resource
+	{
+	public:
+		explicit BlockPool(std::size_t blockSize, std::size_t blocksPerChunk = 64, std::size_t alignment = 64,
+		                   std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+		~BlockPool() override;
+
+		BlockPool(const BlockPool&) = delete;
+		BlockPool& operator=(const BlockPool&) = delete;
+
+		// Returns every chunk to the upstream, invalidating all outstanding blocks
+		void Release() noexcept;
+
+		[[nodiscard]] std::size_t BlockSize() const noexcept { return m_blockSize; }
+		[[nodiscard]] std::size_t ChunkCount() const noexcept { return m_chunks.size(); }
+
+	private:
+		struct FreeBlock
+		{
+			FreeBlock* next;
+		};
+
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+		void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) noexcept override;
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+		[[nodiscard]] bool Fits(std::size_t bytes, std::size_t alignment) const noexcept
+		{
+			return bytes <= m_blockSize && alignment <= m_alignment;
+		}
+
+		std::pmr::memory_resource* m_upstream;
+		std::size_t m_blockSize;
+		std::size_t m_blocksPerChunk;
+		std::size_t m_alignment;
+		FreeBlock* m_free = nullptr;
+		std::vector<void*> m_chunks;
+	};
+}
@@ -0,0 +1,212 @@
+#include "PMathParallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PMgene::Math::Parallel
+{
+	namespace
+	{
+		class Scheduler
+		{
+		public:
+			explicit Scheduler(unsigned threadCount)
+			{
+				const unsigned workers = std::max(threadCount, 1u) - 1;
+
+				// Queue 0 is shared by all threads that are not workers
+				for (unsigned i = 0; i <= workers; ++i)
+					m_queues.push_back(std::make_unique<Queue>());
+
+				m_threads.reserve(workers);
+				for (unsigned i = 1; i <= workers; ++i)
+					m_threads.emplace_back([this, i] { WorkerLoop(i); });
+			}
+
+			~Scheduler()
+			{
+				{
+					std::lock_guard lock(m_sleepMutex);
+					m_stop = true;
+				}
+				m_wake.notify_all();
+				for (std::thread& thread : m_threads)
+					thread.join();
+			}
+
+			Scheduler(const Scheduler&) = delete;
+			Scheduler& operator=(const Scheduler&) = delete;
+
+			[[nodiscard]] unsigned ThreadCount() const noexcept { return static_cast<unsigned>(m_queues.size()); }
+
+			void Run(Range range, size_t grain, Detail::KernelRef kernel) noexcept
+			{
+				Job job{ kernel, grain, range.Size() };
+				const size_t queue = t_queue < m_queues.size() ? t_queue : 0;
+
+				Execute(queue, { &job, range });
+
+				// Help with any queued work until every chunk of this job is done
+				while (job.remaining.load(std::memory_order_acquire) != 0)
+				{
+					Task task;
+					if (Pop(queue, task) || Steal(queue, task))
+						Execute(queue, task);
+					else
+						std::this_thread::yield();
+				}
+			}
+
+		private:
+			struct Job
+			{
+				Detail::KernelRef kernel;
+				size_t grain;
+				std::atomic<size_t> remaining;
+			};
+
+			struct Task
+			{
+				Job* job;
+				Range range;
+			};
+
+			struct Queue
+			{
+				std::mutex mutex;
+				std::deque<Task> tasks;
+			};
+
+			void WorkerLoop(size_t queue) noexcept
+			{
+				t_queue = queue;
+				for (;;)
+				{
+					Task task;
+					if (Pop(queue, task) || Steal(queue, task))
+					{
+						Execute(queue, task);
+						continue;
+					}
+
+					std::unique_lock lock(m_sleepMutex);
+					m_wake.wait(lock, [this] { return m_stop || m_queued.load() != 0; });
+					if (m_stop)
+						return;
+				}
+			}
+
+			void Execute(size_t queue, Task task) noexcept
+			{
+				// Keep the first half, offer the second to other threads
+				Range range = task.range;
+				const size_t grain = task.job->grain;
+				while (range.Size() > grain)
+				{
+					const size_t half = std::max<size_t>(range.Size() / grain / 2, 1) * grain;
+					Push(queue, { task.job, { range.begin + half, range.end } });
+					range.end = range.begin + half;
+				}
+
+				task.job->kernel.invoke(task.job->kernel.kernel, range);
+				task.job->remaining.fetch_sub(range.Size(), std::memory_order_acq_rel);
+			}
+
+			void Push(size_t queue, Task task) noexcept
+			{
+				{
+					std::lock_guard lock(m_queues[queue]->mutex);
+					m_queues[queue]->tasks.push_back(task);
+				}
+				m_queued.fetch_add(1);
+				{
+					std::lock_guard lock(m_sleepMutex);
+				}
+				m_wake.notify_one();
+			}
+
+			// Own queue, newest first: it is the smallest and still warm in cache
+			bool Pop(size_t queue, Task& task) noexcept
+			{
+				std::lock_guard lock(m_queues[queue]->mutex);
+				std::deque<Task>& tasks = m_queues[queue]->tasks;
+				if (tasks.empty())
+					return false;
+				task = tasks.back();
+				tasks.pop_back();
+				m_queued.fetch_sub(1);
+				return true;
+			}
+
+			// Other queues, oldest first: it is the largest piece of work left there
+			bool Steal(size_t queue, Task& task) noexcept
+			{
+				const size_t count = m_queues.size();
+				for (size_t i = 1; i < count; ++i)
+				{
+					Queue& victim = *m_queues[(queue + i) % count];
+					std::lock_guard lock(victim.mutex);
+					if (victim.tasks.empty())
+						continue;
+					task = victim.tasks.front();
+					victim.tasks.pop_front();
+					m_queued.fetch_sub(1);
+					return true;
+				}
+				return false;
+			}
+
+			std::vector<std::unique_ptr<Queue>> m_queues;
+			std::vector<std::thread> m_threads;
+			std::atomic<size_t> m_queued = 0;
+
+			std::mutex m_sleepMutex;
+			std::condition_variable m_wake;
+			bool m_stop = false;
+
+			static thread_local size_t t_queue;
+		};
+
+		thread_local size_t Scheduler::t_queue = 0;
+
+		std::mutex g_schedulerMutex;
+		std::unique_ptr<Scheduler> g_scheduler;
+
+		Scheduler& GetScheduler()
+		{
+			std::lock_guard lock(g_schedulerMutex);
+			if (!g_scheduler)
+				g_scheduler = std::make_unique<Scheduler>(std::max(std::thread::hardware_concurrency(), 1u));
+			return *g_scheduler;
+		}
+	}
+
+	unsigned GetThreadCount() noexcept
+	{
+		return GetScheduler().ThreadCount();
+	}
+
+	void SetThreadCount(unsigned count)
+	{
+		if (count == 0)
+			count = std::max(std::thread::hardware_concurrency(), 1u);
+
+		std::lock_guard lock(g_schedulerMutex);
+		g_scheduler.reset();
+		g_scheduler = std::make_unique<Scheduler>(count);
+	}
+
+	namespace Detail
+	{
+		void ParallelFor(Range range, size_t grain, KernelRef kernel) noexcept
+		{
+			GetScheduler().Run(range, grain, kernel);
+		}
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+
+namespace PMgene::Math::Parallel
+{
+	//****************************************************************************
+	// Parallel execution
+	// A process-wide work-stealing scheduler. Ranges are split in halves down to the grain size;
+	// every thread pushes the halves it does not run onto its own queue, idle threads steal them.
+
+	// Half-open index range [begin, end)
+	struct Range
+	{
+		size_t begin;
+		size_t end;
+
+		[[nodiscard]] size_t Size() const noexcept { return end - begin; }
+	};
+
+	// Execution policy accepted by the batch operations, like std::execution::par_unseq.
+	// A grain of 0 lets each operation pick its own.
+	struct ParallelPolicy
+	{
+		size_t grain = 0;
+	};
+
+	inline constexpr ParallelPolicy par{};
+
+	// Threads taking part in parallel work, including the calling thread
+	unsigned GetThreadCount() noexcept;
+
+	// Recreates the worker threads, 0 selects the hardware concurrency.
+	// Must not be called while parallel work is running.
+	void SetThreadCount(unsigned count);
+
+	namespace Detail
+	{
+		struct KernelRef
+		{
+			const void* kernel;
+			void (*invoke)(const void* kernel, Range range);
+		};
+
+		void ParallelFor(Range range, size_t grain, KernelRef kernel) noexcept;
+	}
+
+	// Calls kernel(Range) on disjoint sub-ranges covering 'range', in parallel. Split points fall
+	// on multiples of 'grain' from range.begin, so a grain that is a multiple of the SIMD width
+	// keeps every chunk aligned like the first one. Returns when all chunks are done; the kernel
+	// must not throw.
+	template <typename Kernel>
+	void ParallelFor(Range range, size_t grain, const Kernel& kernel) noexcept
+	{
+		if (grain == 0)
+			grain = 1;
+		if (range.end <= range.begin)
+			return;
+		if (range.Size() <= grain)
+		{
+			kernel(range);
+			return;
+		}
+
+		Detail::ParallelFor(range, grain, { &kernel, [](const void* k, Range r) { (*static_cast<const Kernel*>(k))(r); } });
+	}
+
+	template <typename Kernel>
+	void ParallelFor(size_t count, size_t grain, const Kernel& kernel) noexcept
+	{
+		ParallelFor(Range{ 0, count }, grain, kernel);
+	}
+}
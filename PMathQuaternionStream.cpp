@@ -0,0 +1,489 @@
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+
+#include "PMathCpu.h"
+#include "PMathKernels.h"
+#include "PMathStream.h"
+
+namespace PMgene::Math
+{
+	//****************************************************************************
+	// Portable kernels. Selects are written as ternaries on values, so the loops stay free of
+	// branches and the compiler can vectorize them for the baseline ISA.
+
+	namespace Detail::Generic
+	{
+		namespace
+		{
+			constexpr float Pi = 3.141592654f;
+			constexpr float TwoPi = 6.283185307f;
+			constexpr float PiOverTwo = 1.570796327f;
+			constexpr float OneOverTwoPi = 0.159154943f;
+
+			// Above this cosine the arc is too short for sin(omega) to divide by, as in XMQuaternionSlerp
+			constexpr float SlerpLinearCosine = 1.f - 0.00001f;
+
+			// Below this cos(yaw) Quaternion::ToEuler treats the rotation as gimbal locked
+			constexpr float GimbalLockCosine = 16.f * FLT_EPSILON;
+
+			// 11-degree minimax approximation after reduction to [-pi/2, pi/2], as in XMScalarSin
+			inline float Sin(float angle) noexcept
+			{
+				const float x = angle - TwoPi * std::nearbyint(angle * OneOverTwoPi);
+				const float absX = std::fabs(x);
+				const float y = std::fmin(absX, Pi - absX);
+				const float y2 = y * y;
+				const float s = (((((-2.3889859e-08f * y2 + 2.7525562e-06f) * y2 - 0.00019840874f) * y2 + 0.0083333310f) * y2 - 0.16666667f) * y2 + 1.f) * y;
+				return std::copysign(s, x);
+			}
+
+			// Sin and Cos of the same reduced angle; the cosine polynomial is XMScalarCos's
+			inline void SinCos(float angle, float& sin, float& cos) noexcept
+			{
+				const float x = angle - TwoPi * std::nearbyint(angle * OneOverTwoPi);
+				const float absX = std::fabs(x);
+				const float y = std::fmin(absX, Pi - absX);
+				const float y2 = y * y;
+				const float s = (((((-2.3889859e-08f * y2 + 2.7525562e-06f) * y2 - 0.00019840874f) * y2 + 0.0083333310f) * y2 - 0.16666667f) * y2 + 1.f) * y;
+				const float c = ((((-2.6051615e-07f * y2 + 2.4760495e-05f) * y2 - 0.0013888378f) * y2 + 0.041666638f) * y2 - 0.5f) * y2 + 1.f;
+				sin = std::copysign(s, x);
+				cos = absX > PiOverTwo ? -c : c;
+			}
+
+			// Octant reduction to atan(a) for a in [0, 1], with the Precision::Fast polynomial of Atan2
+			inline float Atan2(float y, float x) noexcept
+			{
+				const float ax = std::fabs(x), ay = std::fabs(y);
+				const float high = std::fmax(ax, ay);
+				const float a = high > 0.f ? std::fmin(ax, ay) / high : 0.f;
+				const float s = a * a;
+				float r = (((((((-0.0046932760f * s + 0.024252403f) * s - 0.059486393f) * s + 0.099142928f) * s - 0.14019481f) * s
+				             + 0.19969724f) * s - 0.33331991f) * s + 0.99999990f) * a;
+				r = ay > ax ? PiOverTwo - r : r;
+				r = std::signbit(x) ? Pi - r : r;
+				return std::copysign(r, y);
+			}
+
+			// 7-degree minimax approximation for c in [0, 1], as in XMScalarACos
+			inline float ACosPositive(float c) noexcept
+			{
+				const float p = ((((((-0.0012624911f * c + 0.0066700901f) * c - 0.0170881256f) * c + 0.0308918810f) * c - 0.0501743046f) * c + 0.0889789874f) * c - 0.2145988016f) * c + 1.5707963050f;
+				return p * std::sqrt(std::fmax(1.f - c, 0.f));
+			}
+
+			inline float Dot(ConstStreamView4 a, ConstStreamView4 b, size_t i) noexcept
+			{
+				return a.x[i] * b.x[i] + a.y[i] * b.y[i] + a.z[i] * b.z[i] + a.w[i] * b.w[i];
+			}
+
+			// result = s0 * a + s1 * b
+			inline void Combine(ConstStreamView4 a, ConstStreamView4 b, float s0, float s1, StreamView4 result, size_t i) noexcept
+			{
+				result.x[i] = s0 * a.x[i] + s1 * b.x[i];
+				result.y[i] = s0 * a.y[i] + s1 * b.y[i];
+				result.z[i] = s0 * a.z[i] + s1 * b.z[i];
+				result.w[i] = s0 * a.w[i] + s1 * b.w[i];
+			}
+
+			inline float InverseLength(float x, float y, float z, float w) noexcept
+			{
+				const float length = std::sqrt(x * x + y * y + z * z + w * w);
+				return length != 0.f ? 1.f / length : 0.f;
+			}
+		}
+
+		void QuaternionNormalize(ConstStreamView4 a, StreamView4 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float x = a.x[i], y = a.y[i], z = a.z[i], w = a.w[i];
+				const float invLength = InverseLength(x, y, z, w);
+				result.x[i] = x * invLength;
+				result.y[i] = y * invLength;
+				result.z[i] = z * invLength;
+				result.w[i] = w * invLength;
+			}
+		}
+
+		void QuaternionLerp(ConstStreamView4 a, ConstStreamView4 b, const float* t, size_t tStride, StreamView4 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float ti = t[i * tStride];
+				const float s1 = std::copysign(ti, Dot(a, b, i));
+
+				const float rx = (1.f - ti) * a.x[i] + s1 * b.x[i];
+				const float ry = (1.f - ti) * a.y[i] + s1 * b.y[i];
+				const float rz = (1.f - ti) * a.z[i] + s1 * b.z[i];
+				const float rw = (1.f - ti) * a.w[i] + s1 * b.w[i];
+				const float invLength = InverseLength(rx, ry, rz, rw);
+				result.x[i] = rx * invLength;
+				result.y[i] = ry * invLength;
+				result.z[i] = rz * invLength;
+				result.w[i] = rw * invLength;
+			}
+		}
+
+		void QuaternionSlerp(ConstStreamView4 a, ConstStreamView4 b, const float* t, size_t tStride, StreamView4 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float ti = t[i * tStride];
+				const float dot = Dot(a, b, i);
+				const float cosOmega = std::fmin(std::fabs(dot), 1.f);
+
+				const float omega = ACosPositive(cosOmega);
+				const float invSinOmega = 1.f / std::sqrt((1.f - cosOmega) * (1.f + cosOmega));
+				const bool linear = cosOmega >= SlerpLinearCosine;
+				const float s0 = linear ? 1.f - ti : Sin((1.f - ti) * omega) * invSinOmega;
+				const float s1 = linear ? ti : Sin(ti * omega) * invSinOmega;
+
+				Combine(a, b, s0, std::copysign(s1, dot), result, i);
+			}
+		}
+
+		void QuaternionSlerpApproximate(ConstStreamView4 a, ConstStreamView4 b, const float* t, size_t tStride, StreamView4 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float ti = t[i * tStride];
+				const float dot = Dot(a, b, i);
+				const float d = std::fabs(dot);
+
+				// Bends t so the normalized lerp follows the arc; the fit depends on the arc length
+				const float A = 1.0904f + d * (-3.2452f + d * (3.55645f - d * 1.43519f));
+				const float B = 0.848013f + d * (-1.06021f + d * 0.215638f);
+				const float k = A * (ti - 0.5f) * (ti - 0.5f) + B;
+				const float ot = ti + ti * (ti - 0.5f) * (ti - 1.f) * k;
+
+				const float s1 = std::copysign(ot, dot);
+				const float rx = (1.f - ot) * a.x[i] + s1 * b.x[i];
+				const float ry = (1.f - ot) * a.y[i] + s1 * b.y[i];
+				const float rz = (1.f - ot) * a.z[i] + s1 * b.z[i];
+				const float rw = (1.f - ot) * a.w[i] + s1 * b.w[i];
+				const float invLength = InverseLength(rx, ry, rz, rw);
+				result.x[i] = rx * invLength;
+				result.y[i] = ry * invLength;
+				result.z[i] = rz * invLength;
+				result.w[i] = rw * invLength;
+			}
+		}
+
+		void QuaternionToEuler(ConstStreamView4 a, StreamView3 angles, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float x = a.x[i], y = a.y[i], z = a.z[i], w = a.w[i];
+				const float xx = x * x, yy = y * y, zz = z * z;
+
+				const float m31 = 2.f * x * z + 2.f * y * w;
+				const float m32 = 2.f * y * z - 2.f * x * w;
+				const float m33 = 1.f - 2.f * xx - 2.f * yy;
+				const float m12 = 2.f * x * y + 2.f * z * w;
+				const float m22 = 1.f - 2.f * xx - 2.f * zz;
+				const float m11 = 1.f - 2.f * yy - 2.f * zz;
+				const float m21 = 2.f * x * y - 2.f * z * w;
+
+				// At gimbal lock yaw folds into roll; selecting the roll inputs keeps it to one Atan2
+				const float cy = std::sqrt(m33 * m33 + m31 * m31);
+				const bool locked = cy <= GimbalLockCosine;
+				angles.x[i] = Atan2(-m32, cy);
+				angles.y[i] = locked ? 0.f : Atan2(m31, m33);
+				angles.z[i] = Atan2(locked ? -m21 : m12, locked ? m11 : m22);
+			}
+		}
+
+		void QuaternionFromYawPitchRoll(ConstStreamView3 angles, StreamView4 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				float sp, cp, sy, cy, sr, cr;
+				SinCos(0.5f * angles.x[i], sp, cp);
+				SinCos(0.5f * angles.y[i], sy, cy);
+				SinCos(0.5f * angles.z[i], sr, cr);
+
+				const float spcy = sp * cy, cpsy = cp * sy, cpcy = cp * cy, spsy = sp * sy;
+				result.x[i] = cr * spcy + sr * cpsy;
+				result.y[i] = cr * cpsy - sr * spcy;
+				result.z[i] = sr * cpcy - cr * spsy;
+				result.w[i] = cr * cpcy + sr * spsy;
+			}
+		}
+
+		void QuaternionLoadAoS(const float* source, StreamView4 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				result.x[i] = source[i * 4];
+				result.y[i] = source[i * 4 + 1];
+				result.z[i] = source[i * 4 + 2];
+				result.w[i] = source[i * 4 + 3];
+			}
+		}
+
+		void QuaternionStoreAoS(ConstStreamView4 a, float* destination, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				destination[i * 4] = a.x[i];
+				destination[i * 4 + 1] = a.y[i];
+				destination[i * 4 + 2] = a.z[i];
+				destination[i * 4 + 3] = a.w[i];
+			}
+		}
+	}
+
+	//****************************************************************************
+	// QuaternionStream
+
+	namespace
+	{
+		static_assert(sizeof(Quaternion) == 4 * sizeof(float), "Quaternion must be tightly packed for AoS conversion");
+
+		using InterpolateKernel = void (*)(Detail::ConstStreamView4 a, Detail::ConstStreamView4 b, const float* t, size_t tStride, Detail::StreamView4 result, size_t count) noexcept;
+
+		// Elements per parallel chunk, a multiple of every SIMD width
+		constexpr size_t InterpolateGrain = 8192;
+
+		Detail::StreamView4 View(QuaternionStream& S) noexcept
+		{
+			return { S.x.data(), S.y.data(), S.z.data(), S.w.data() };
+		}
+
+		Detail::ConstStreamView4 View(const QuaternionStream& S) noexcept
+		{
+			return { S.x.data(), S.y.data(), S.z.data(), S.w.data() };
+		}
+
+		Detail::StreamView3 View(Vector3Stream& S) noexcept
+		{
+			return { S.x.data(), S.y.data(), S.z.data() };
+		}
+
+		Detail::ConstStreamView3 View(const Vector3Stream& S) noexcept
+		{
+			return { S.x.data(), S.y.data(), S.z.data() };
+		}
+
+		template <typename View>
+		View Offset(View V, size_t offset) noexcept
+		{
+			if constexpr (requires { V.w; })
+				return { V.x + offset, V.y + offset, V.z + offset, V.w + offset };
+			else
+				return { V.x + offset, V.y + offset, V.z + offset };
+		}
+
+		size_t Grain(const Parallel::ParallelPolicy& policy) noexcept
+		{
+			return policy.grain != 0 ? policy.grain : InterpolateGrain;
+		}
+
+		InterpolateKernel LerpKernel() noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+				return Detail::AVX2::QuaternionLerp;
+#endif
+			return Detail::Generic::QuaternionLerp;
+		}
+
+		InterpolateKernel SlerpKernel(SlerpMode mode) noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+				return mode == SlerpMode::Exact ? Detail::AVX2::QuaternionSlerp : Detail::AVX2::QuaternionSlerpApproximate;
+#endif
+			return mode == SlerpMode::Exact ? Detail::Generic::QuaternionSlerp : Detail::Generic::QuaternionSlerpApproximate;
+		}
+
+		template <typename Input, typename Output>
+		using ConvertKernel = void (*)(Input input, Output output, size_t count) noexcept;
+
+		ConvertKernel<Detail::ConstStreamView4, Detail::StreamView3> ToEulerKernel() noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+				return Detail::AVX2::QuaternionToEuler;
+#endif
+			return Detail::Generic::QuaternionToEuler;
+		}
+
+		ConvertKernel<Detail::ConstStreamView3, Detail::StreamView4> FromYawPitchRollKernel() noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+				return Detail::AVX2::QuaternionFromYawPitchRoll;
+#endif
+			return Detail::Generic::QuaternionFromYawPitchRoll;
+		}
+
+		template <typename Input, typename Output>
+		void Convert(const Parallel::ParallelPolicy& policy, ConvertKernel<Input, Output> kernel, Input input, Output output, size_t count) noexcept
+		{
+			Parallel::ParallelFor(count, Grain(policy), [&](Parallel::Range range) {
+				kernel(Offset(input, range.begin), Offset(output, range.begin), range.Size());
+			});
+		}
+
+		void Interpolate(InterpolateKernel kernel, const QuaternionStream& a, const QuaternionStream& b, const float* t, size_t tStride,
+		                 QuaternionStream& result) noexcept
+		{
+			assert(a.Size() == b.Size() && result.Size() == a.Size());
+			kernel(View(a), View(b), t, tStride, View(result), a.Size());
+		}
+
+		void Interpolate(const Parallel::ParallelPolicy& policy, InterpolateKernel kernel, const QuaternionStream& a, const QuaternionStream& b,
+		                 const float* t, size_t tStride, QuaternionStream& result) noexcept
+		{
+			assert(a.Size() == b.Size() && result.Size() == a.Size());
+
+			const Detail::ConstStreamView4 first = View(a);
+			const Detail::ConstStreamView4 second = View(b);
+			const Detail::StreamView4 output = View(result);
+			Parallel::ParallelFor(a.Size(), Grain(policy), [&](Parallel::Range range) {
+				kernel(Offset(first, range.begin), Offset(second, range.begin), t + range.begin * tStride, tStride,
+				       Offset(output, range.begin), range.Size());
+			});
+		}
+	}
+
+	void QuaternionStream::Resize(size_t count)
+	{
+		x.resize(count);
+		y.resize(count);
+		z.resize(count);
+		w.resize(count);
+	}
+
+	void QuaternionStream::Clear() noexcept
+	{
+		x.clear();
+		y.clear();
+		z.clear();
+		w.clear();
+	}
+
+	void QuaternionStream::Load(std::span<const Quaternion> Q)
+	{
+		Resize(Q.size());
+
+		const float* source = reinterpret_cast<const float*>(Q.data());
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::QuaternionLoadAoS(source, View(*this), Q.size());
+			return;
+		}
+#endif
+		Detail::Generic::QuaternionLoadAoS(source, View(*this), Q.size());
+	}
+
+	void QuaternionStream::Store(std::span<Quaternion> Q) const noexcept
+	{
+		assert(Q.size() == Size());
+
+		float* destination = reinterpret_cast<float*>(Q.data());
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::QuaternionStoreAoS(View(*this), destination, Size());
+			return;
+		}
+#endif
+		Detail::Generic::QuaternionStoreAoS(View(*this), destination, Size());
+	}
+
+	void QuaternionStream::Normalize() noexcept
+	{
+		Normalize(*this, *this);
+	}
+
+	void QuaternionStream::Normalize(const QuaternionStream& a, QuaternionStream& result) noexcept
+	{
+		assert(result.Size() == a.Size());
+
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::QuaternionNormalize(View(a), View(result), a.Size());
+			return;
+		}
+#endif
+		Detail::Generic::QuaternionNormalize(View(a), View(result), a.Size());
+	}
+
+	void QuaternionStream::Lerp(const QuaternionStream& a, const QuaternionStream& b, float t, QuaternionStream& result) noexcept
+	{
+		Interpolate(LerpKernel(), a, b, &t, 0, result);
+	}
+
+	void QuaternionStream::Lerp(const QuaternionStream& a, const QuaternionStream& b, std::span<const float> t, QuaternionStream& result) noexcept
+	{
+		assert(t.size() == a.Size());
+		Interpolate(LerpKernel(), a, b, t.data(), 1, result);
+	}
+
+	void QuaternionStream::Lerp(const Parallel::ParallelPolicy& policy, const QuaternionStream& a, const QuaternionStream& b, float t,
+	                            QuaternionStream& result) noexcept
+	{
+		Interpolate(policy, LerpKernel(), a, b, &t, 0, result);
+	}
+
+	void QuaternionStream::Lerp(const Parallel::ParallelPolicy& policy, const QuaternionStream& a, const QuaternionStream& b, std::span<const float> t,
+	                            QuaternionStream& result) noexcept
+	{
+		assert(t.size() == a.Size());
+		Interpolate(policy, LerpKernel(), a, b, t.data(), 1, result);
+	}
+
+	void QuaternionStream::Slerp(const QuaternionStream& a, const QuaternionStream& b, float t, QuaternionStream& result, SlerpMode mode) noexcept
+	{
+		Interpolate(SlerpKernel(mode), a, b, &t, 0, result);
+	}
+
+	void QuaternionStream::Slerp(const QuaternionStream& a, const QuaternionStream& b, std::span<const float> t, QuaternionStream& result,
+	                             SlerpMode mode) noexcept
+	{
+		assert(t.size() == a.Size());
+		Interpolate(SlerpKernel(mode), a, b, t.data(), 1, result);
+	}
+
+	void QuaternionStream::Slerp(const Parallel::ParallelPolicy& policy, const QuaternionStream& a, const QuaternionStream& b, float t,
+	                             QuaternionStream& result, SlerpMode mode) noexcept
+	{
+		Interpolate(policy, SlerpKernel(mode), a, b, &t, 0, result);
+	}
+
+	void QuaternionStream::Slerp(const Parallel::ParallelPolicy& policy, const QuaternionStream& a, const QuaternionStream& b,
+	                             std::span<const float> t, QuaternionStream& result, SlerpMode mode) noexcept
+	{
+		assert(t.size() == a.Size());
+		Interpolate(policy, SlerpKernel(mode), a, b, t.data(), 1, result);
+	}
+
+	void QuaternionStream::ToEuler(const QuaternionStream& a, Vector3Stream& angles) noexcept
+	{
+		assert(angles.Size() == a.Size());
+		ToEulerKernel()(View(a), View(angles), a.Size());
+	}
+
+	void QuaternionStream::ToEuler(const Parallel::ParallelPolicy& policy, const QuaternionStream& a, Vector3Stream& angles) noexcept
+	{
+		assert(angles.Size() == a.Size());
+		Convert(policy, ToEulerKernel(), View(a), View(angles), a.Size());
+	}
+
+	void QuaternionStream::CreateFromYawPitchRoll(const Vector3Stream& angles, QuaternionStream& result) noexcept
+	{
+		assert(result.Size() == angles.Size());
+		FromYawPitchRollKernel()(View(angles), View(result), angles.Size());
+	}
+
+	void QuaternionStream::CreateFromYawPitchRoll(const Parallel::ParallelPolicy& policy, const Vector3Stream& angles, QuaternionStream& result) noexcept
+	{
+		assert(result.Size() == angles.Size());
+		Convert(policy, FromYawPitchRollKernel(), View(angles), View(result), angles.Size());
+	}
+}
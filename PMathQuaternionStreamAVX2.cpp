@@ -0,0 +1,341 @@
+#include "PMathCpu.h"
+
+#if PMATH_X86
+#include <cfloat>
+
+#include "PMathAVX2.h"
+#include "PMathKernels.h"
+
+namespace PMgene::Math::Detail::AVX2
+{
+	namespace
+	{
+		struct Quaternion8
+		{
+			__m256 x, y, z, w;
+
+			template <typename Lanes>
+			static Quaternion8 Load(ConstStreamView4 V, size_t i, Lanes lanes) noexcept
+			{
+				return { lanes.Load(V.x + i), lanes.Load(V.y + i), lanes.Load(V.z + i), lanes.Load(V.w + i) };
+			}
+
+			template <typename Lanes>
+			void Store(StreamView4 V, size_t i, Lanes lanes) const noexcept
+			{
+				lanes.Store(V.x + i, x);
+				lanes.Store(V.y + i, y);
+				lanes.Store(V.z + i, z);
+				lanes.Store(V.w + i, w);
+			}
+		};
+
+		inline __m256 SignMask() noexcept
+		{
+			return _mm256_set1_ps(-0.f);
+		}
+
+		inline __m256 Dot(const Quaternion8& a, const Quaternion8& b) noexcept
+		{
+			__m256 d = _mm256_mul_ps(a.x, b.x);
+			d = _mm256_fmadd_ps(a.y, b.y, d);
+			d = _mm256_fmadd_ps(a.z, b.z, d);
+			return _mm256_fmadd_ps(a.w, b.w, d);
+		}
+
+		// s0 * a + s1 * b
+		inline Quaternion8 Combine(const Quaternion8& a, const Quaternion8& b, __m256 s0, __m256 s1) noexcept
+		{
+			return {
+				_mm256_fmadd_ps(s0, a.x, _mm256_mul_ps(s1, b.x)),
+				_mm256_fmadd_ps(s0, a.y, _mm256_mul_ps(s1, b.y)),
+				_mm256_fmadd_ps(s0, a.z, _mm256_mul_ps(s1, b.z)),
+				_mm256_fmadd_ps(s0, a.w, _mm256_mul_ps(s1, b.w))
+			};
+		}
+
+		// Zero-length quaternions normalize to zero, matching the generic kernel
+		inline Quaternion8 Normalize(const Quaternion8& q) noexcept
+		{
+			const __m256 length = _mm256_sqrt_ps(Dot(q, q));
+			const __m256 nonZero = _mm256_cmp_ps(length, _mm256_setzero_ps(), _CMP_NEQ_OQ);
+			const __m256 invLength = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(1.f), length), nonZero);
+			return { _mm256_mul_ps(q.x, invLength), _mm256_mul_ps(q.y, invLength), _mm256_mul_ps(q.z, invLength), _mm256_mul_ps(q.w, invLength) };
+		}
+
+		// 11-degree minimax approximation after reduction to [-pi/2, pi/2], as in XMVectorSin
+		inline __m256 Sin(__m256 angle) noexcept
+		{
+			const __m256 twoPi = _mm256_set1_ps(6.283185307f);
+			const __m256 quotient = _mm256_round_ps(_mm256_mul_ps(angle, _mm256_set1_ps(0.159154943f)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+			const __m256 x = _mm256_fnmadd_ps(quotient, twoPi, angle);
+
+			const __m256 sign = _mm256_and_ps(x, SignMask());
+			const __m256 absX = _mm256_andnot_ps(SignMask(), x);
+			const __m256 y = _mm256_min_ps(absX, _mm256_sub_ps(_mm256_set1_ps(3.141592654f), absX));
+			const __m256 y2 = _mm256_mul_ps(y, y);
+
+			__m256 s = _mm256_fmadd_ps(_mm256_set1_ps(-2.3889859e-08f), y2, _mm256_set1_ps(2.7525562e-06f));
+			s = _mm256_fmadd_ps(s, y2, _mm256_set1_ps(-0.00019840874f));
+			s = _mm256_fmadd_ps(s, y2, _mm256_set1_ps(0.0083333310f));
+			s = _mm256_fmadd_ps(s, y2, _mm256_set1_ps(-0.16666667f));
+			s = _mm256_fmadd_ps(s, y2, _mm256_set1_ps(1.f));
+			return _mm256_xor_ps(_mm256_mul_ps(s, y), sign);
+		}
+
+		// Sin and Cos of the same reduced angle; the cosine polynomial is XMVectorCos's
+		inline void SinCos(__m256 angle, __m256& sin, __m256& cos) noexcept
+		{
+			const __m256 twoPi = _mm256_set1_ps(6.283185307f);
+			const __m256 quotient = _mm256_round_ps(_mm256_mul_ps(angle, _mm256_set1_ps(0.159154943f)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+			const __m256 x = _mm256_fnmadd_ps(quotient, twoPi, angle);
+
+			const __m256 sign = _mm256_and_ps(x, SignMask());
+			const __m256 absX = _mm256_andnot_ps(SignMask(), x);
+			const __m256 y = _mm256_min_ps(absX, _mm256_sub_ps(_mm256_set1_ps(3.141592654f), absX));
+			const __m256 y2 = _mm256_mul_ps(y, y);
+			const __m256 one = _mm256_set1_ps(1.f);
+
+			__m256 s = _mm256_fmadd_ps(_mm256_set1_ps(-2.3889859e-08f), y2, _mm256_set1_ps(2.7525562e-06f));
+			s = _mm256_fmadd_ps(s, y2, _mm256_set1_ps(-0.00019840874f));
+			s = _mm256_fmadd_ps(s, y2, _mm256_set1_ps(0.0083333310f));
+			s = _mm256_fmadd_ps(s, y2, _mm256_set1_ps(-0.16666667f));
+			s = _mm256_fmadd_ps(s, y2, one);
+			sin = _mm256_xor_ps(_mm256_mul_ps(s, y), sign);
+
+			__m256 c = _mm256_fmadd_ps(_mm256_set1_ps(-2.6051615e-07f), y2, _mm256_set1_ps(2.4760495e-05f));
+			c = _mm256_fmadd_ps(c, y2, _mm256_set1_ps(-0.0013888378f));
+			c = _mm256_fmadd_ps(c, y2, _mm256_set1_ps(0.041666638f));
+			c = _mm256_fmadd_ps(c, y2, _mm256_set1_ps(-0.5f));
+			c = _mm256_fmadd_ps(c, y2, one);
+			const __m256 folded = _mm256_cmp_ps(absX, _mm256_set1_ps(1.570796327f), _CMP_GT_OQ);
+			cos = _mm256_xor_ps(c, _mm256_and_ps(folded, SignMask()));
+		}
+
+		// Octant reduction to atan(a) for a in [0, 1], with the Precision::Fast polynomial of Atan2
+		inline __m256 Atan2(__m256 y, __m256 x) noexcept
+		{
+			const __m256 ax = _mm256_andnot_ps(SignMask(), x);
+			const __m256 ay = _mm256_andnot_ps(SignMask(), y);
+			const __m256 high = _mm256_max_ps(ax, ay);
+			const __m256 nonZero = _mm256_cmp_ps(high, _mm256_setzero_ps(), _CMP_GT_OQ);
+			const __m256 a = _mm256_and_ps(_mm256_div_ps(_mm256_min_ps(ax, ay), high), nonZero);
+			const __m256 s = _mm256_mul_ps(a, a);
+
+			__m256 p = _mm256_fmadd_ps(_mm256_set1_ps(-0.0046932760f), s, _mm256_set1_ps(0.024252403f));
+			p = _mm256_fmadd_ps(p, s, _mm256_set1_ps(-0.059486393f));
+			p = _mm256_fmadd_ps(p, s, _mm256_set1_ps(0.099142928f));
+			p = _mm256_fmadd_ps(p, s, _mm256_set1_ps(-0.14019481f));
+			p = _mm256_fmadd_ps(p, s, _mm256_set1_ps(0.19969724f));
+			p = _mm256_fmadd_ps(p, s, _mm256_set1_ps(-0.33331991f));
+			p = _mm256_fmadd_ps(p, s, _mm256_set1_ps(0.99999990f));
+			__m256 r = _mm256_mul_ps(p, a);
+
+			r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(1.570796327f), r), _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+			// blendv selects on the sign bit, so -0 counts as negative like std::signbit
+			r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(3.141592654f), r), x);
+			return _mm256_or_ps(r, _mm256_and_ps(y, SignMask()));
+		}
+
+		// 7-degree minimax approximation for c in [0, 1], as in XMVectorACos
+		inline __m256 ACosPositive(__m256 c) noexcept
+		{
+			__m256 p = _mm256_fmadd_ps(_mm256_set1_ps(-0.0012624911f), c, _mm256_set1_ps(0.0066700901f));
+			p = _mm256_fmadd_ps(p, c, _mm256_set1_ps(-0.0170881256f));
+			p = _mm256_fmadd_ps(p, c, _mm256_set1_ps(0.0308918810f));
+			p = _mm256_fmadd_ps(p, c, _mm256_set1_ps(-0.0501743046f));
+			p = _mm256_fmadd_ps(p, c, _mm256_set1_ps(0.0889789874f));
+			p = _mm256_fmadd_ps(p, c, _mm256_set1_ps(-0.2145988016f));
+			p = _mm256_fmadd_ps(p, c, _mm256_set1_ps(1.5707963050f));
+			const __m256 root = _mm256_sqrt_ps(_mm256_max_ps(_mm256_sub_ps(_mm256_set1_ps(1.f), c), _mm256_setzero_ps()));
+			return _mm256_mul_ps(p, root);
+		}
+
+		// Runs kernel(a, b, t, i, lanes) over 8 quaternions at a time, with t broadcast or per element
+		template <typename Kernel>
+		inline void Interpolate(const float* t, size_t tStride, size_t count, Kernel&& kernel) noexcept
+		{
+			if (tStride == 0)
+			{
+				const __m256 T = _mm256_set1_ps(*t);
+				ForEach8(count, [&](size_t i, auto lanes) { kernel(T, i, lanes); });
+			}
+			else
+			{
+				ForEach8(count, [&](size_t i, auto lanes) { kernel(lanes.Load(t + i), i, lanes); });
+			}
+		}
+	}
+
+	void QuaternionNormalize(ConstStreamView4 a, StreamView4 result, size_t count) noexcept
+	{
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			Normalize(Quaternion8::Load(a, i, lanes)).Store(result, i, lanes);
+		});
+	}
+
+	void QuaternionLerp(ConstStreamView4 a, ConstStreamView4 b, const float* t, size_t tStride, StreamView4 result, size_t count) noexcept
+	{
+		const __m256 one = _mm256_set1_ps(1.f);
+		Interpolate(t, tStride, count, [&](__m256 T, size_t i, auto lanes)
+		{
+			const Quaternion8 q0 = Quaternion8::Load(a, i, lanes);
+			const Quaternion8 q1 = Quaternion8::Load(b, i, lanes);
+
+			// Flipping the sign of t instead of q1 keeps the shorter arc without a branch
+			const __m256 sign = _mm256_and_ps(Dot(q0, q1), SignMask());
+			Normalize(Combine(q0, q1, _mm256_sub_ps(one, T), _mm256_xor_ps(T, sign))).Store(result, i, lanes);
+		});
+	}
+
+	void QuaternionSlerp(ConstStreamView4 a, ConstStreamView4 b, const float* t, size_t tStride, StreamView4 result, size_t count) noexcept
+	{
+		const __m256 one = _mm256_set1_ps(1.f);
+		const __m256 linearCosine = _mm256_set1_ps(1.f - 0.00001f);
+		Interpolate(t, tStride, count, [&](__m256 T, size_t i, auto lanes)
+		{
+			const Quaternion8 q0 = Quaternion8::Load(a, i, lanes);
+			const Quaternion8 q1 = Quaternion8::Load(b, i, lanes);
+
+			const __m256 dot = Dot(q0, q1);
+			const __m256 sign = _mm256_and_ps(dot, SignMask());
+			const __m256 cosOmega = _mm256_min_ps(_mm256_andnot_ps(SignMask(), dot), one);
+
+			const __m256 omega = ACosPositive(cosOmega);
+			// (1 - c)(1 + c) keeps sin(omega) accurate for short arcs, where 1 - c * c cancels
+			const __m256 sinOmegaSq = _mm256_mul_ps(_mm256_sub_ps(one, cosOmega), _mm256_add_ps(one, cosOmega));
+			const __m256 invSinOmega = _mm256_div_ps(one, _mm256_sqrt_ps(sinOmegaSq));
+			const __m256 t0 = _mm256_sub_ps(one, T);
+			__m256 s0 = _mm256_mul_ps(Sin(_mm256_mul_ps(t0, omega)), invSinOmega);
+			__m256 s1 = _mm256_mul_ps(Sin(_mm256_mul_ps(T, omega)), invSinOmega);
+
+			// Nearly equal rotations fall back to linear weights, as XMQuaternionSlerp does
+			const __m256 linear = _mm256_cmp_ps(cosOmega, linearCosine, _CMP_GE_OQ);
+			s0 = _mm256_blendv_ps(s0, t0, linear);
+			s1 = _mm256_blendv_ps(s1, T, linear);
+
+			Combine(q0, q1, s0, _mm256_xor_ps(s1, sign)).Store(result, i, lanes);
+		});
+	}
+
+	void QuaternionSlerpApproximate(ConstStreamView4 a, ConstStreamView4 b, const float* t, size_t tStride, StreamView4 result, size_t count) noexcept
+	{
+		const __m256 one = _mm256_set1_ps(1.f);
+		const __m256 half = _mm256_set1_ps(0.5f);
+		Interpolate(t, tStride, count, [&](__m256 T, size_t i, auto lanes)
+		{
+			const Quaternion8 q0 = Quaternion8::Load(a, i, lanes);
+			const Quaternion8 q1 = Quaternion8::Load(b, i, lanes);
+
+			const __m256 dot = Dot(q0, q1);
+			const __m256 sign = _mm256_and_ps(dot, SignMask());
+			const __m256 d = _mm256_andnot_ps(SignMask(), dot);
+
+			// Bends t so the normalized lerp follows the arc, see the generic kernel
+			__m256 A = _mm256_fnmadd_ps(d, _mm256_set1_ps(1.43519f), _mm256_set1_ps(3.55645f));
+			A = _mm256_fmadd_ps(d, A, _mm256_set1_ps(-3.2452f));
+			A = _mm256_fmadd_ps(d, A, _mm256_set1_ps(1.0904f));
+			__m256 B = _mm256_fmadd_ps(d, _mm256_set1_ps(0.215638f), _mm256_set1_ps(-1.06021f));
+			B = _mm256_fmadd_ps(d, B, _mm256_set1_ps(0.848013f));
+
+			const __m256 centered = _mm256_sub_ps(T, half);
+			const __m256 k = _mm256_fmadd_ps(_mm256_mul_ps(A, centered), centered, B);
+			const __m256 bend = _mm256_mul_ps(_mm256_mul_ps(T, centered), _mm256_sub_ps(T, one));
+			const __m256 ot = _mm256_fmadd_ps(bend, k, T);
+
+			Normalize(Combine(q0, q1, _mm256_sub_ps(one, ot), _mm256_xor_ps(ot, sign))).Store(result, i, lanes);
+		});
+	}
+
+	void QuaternionToEuler(ConstStreamView4 a, StreamView3 angles, size_t count) noexcept
+	{
+		const __m256 one = _mm256_set1_ps(1.f);
+		const __m256 two = _mm256_set1_ps(2.f);
+		const __m256 gimbalLockCosine = _mm256_set1_ps(16.f * FLT_EPSILON);
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			const Quaternion8 q = Quaternion8::Load(a, i, lanes);
+			const __m256 x2 = _mm256_mul_ps(q.x, two), y2 = _mm256_mul_ps(q.y, two), z2 = _mm256_mul_ps(q.z, two);
+			const __m256 xx2 = _mm256_mul_ps(q.x, x2), yy2 = _mm256_mul_ps(q.y, y2), zz2 = _mm256_mul_ps(q.z, z2);
+
+			const __m256 m31 = _mm256_fmadd_ps(x2, q.z, _mm256_mul_ps(y2, q.w));
+			const __m256 m32 = _mm256_fmsub_ps(y2, q.z, _mm256_mul_ps(x2, q.w));
+			const __m256 m33 = _mm256_sub_ps(_mm256_sub_ps(one, xx2), yy2);
+			const __m256 m12 = _mm256_fmadd_ps(x2, q.y, _mm256_mul_ps(z2, q.w));
+			const __m256 m22 = _mm256_sub_ps(_mm256_sub_ps(one, xx2), zz2);
+			const __m256 m11 = _mm256_sub_ps(_mm256_sub_ps(one, yy2), zz2);
+			const __m256 m21 = _mm256_fmsub_ps(x2, q.y, _mm256_mul_ps(z2, q.w));
+
+			// At gimbal lock yaw folds into roll; blending the roll inputs keeps it to one Atan2
+			const __m256 cy = _mm256_sqrt_ps(_mm256_fmadd_ps(m33, m33, _mm256_mul_ps(m31, m31)));
+			const __m256 locked = _mm256_cmp_ps(cy, gimbalLockCosine, _CMP_LE_OQ);
+			const __m256 rollY = _mm256_blendv_ps(m12, _mm256_xor_ps(m21, SignMask()), locked);
+			const __m256 rollX = _mm256_blendv_ps(m22, m11, locked);
+
+			lanes.Store(angles.x + i, Atan2(_mm256_xor_ps(m32, SignMask()), cy));
+			lanes.Store(angles.y + i, _mm256_andnot_ps(locked, Atan2(m31, m33)));
+			lanes.Store(angles.z + i, Atan2(rollY, rollX));
+		});
+	}
+
+	void QuaternionFromYawPitchRoll(ConstStreamView3 angles, StreamView4 result, size_t count) noexcept
+	{
+		const __m256 half = _mm256_set1_ps(0.5f);
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			__m256 sp, cp, sy, cy, sr, cr;
+			SinCos(_mm256_mul_ps(lanes.Load(angles.x + i), half), sp, cp);
+			SinCos(_mm256_mul_ps(lanes.Load(angles.y + i), half), sy, cy);
+			SinCos(_mm256_mul_ps(lanes.Load(angles.z + i), half), sr, cr);
+
+			const __m256 spcy = _mm256_mul_ps(sp, cy), cpsy = _mm256_mul_ps(cp, sy);
+			const __m256 cpcy = _mm256_mul_ps(cp, cy), spsy = _mm256_mul_ps(sp, sy);
+			const Quaternion8 q = {
+				_mm256_fmadd_ps(cr, spcy, _mm256_mul_ps(sr, cpsy)),
+				_mm256_fmsub_ps(cr, cpsy, _mm256_mul_ps(sr, spcy)),
+				_mm256_fmsub_ps(sr, cpcy, _mm256_mul_ps(cr, spsy)),
+				_mm256_fmadd_ps(cr, cpcy, _mm256_mul_ps(sr, spsy))
+			};
+			q.Store(result, i, lanes);
+		});
+	}
+
+	void QuaternionLoadAoS(const float* source, StreamView4 result, size_t count) noexcept
+	{
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 x, y, z, w;
+			LoadAoS8x4(source + i * 4, x, y, z, w);
+			_mm256_storeu_ps(result.x + i, x);
+			_mm256_storeu_ps(result.y + i, y);
+			_mm256_storeu_ps(result.z + i, z);
+			_mm256_storeu_ps(result.w + i, w);
+		}
+		for (; i < count; ++i)
+		{
+			result.x[i] = source[i * 4];
+			result.y[i] = source[i * 4 + 1];
+			result.z[i] = source[i * 4 + 2];
+			result.w[i] = source[i * 4 + 3];
+		}
+	}
+
+	void QuaternionStoreAoS(ConstStreamView4 a, float* destination, size_t count) noexcept
+	{
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			StoreAoS8x4(destination + i * 4, _mm256_loadu_ps(a.x + i), _mm256_loadu_ps(a.y + i), _mm256_loadu_ps(a.z + i), _mm256_loadu_ps(a.w + i));
+		}
+		for (; i < count; ++i)
+		{
+			destination[i * 4] = a.x[i];
+			destination[i * 4 + 1] = a.y[i];
+			destination[i * 4 + 2] = a.z[i];
+			destination[i * 4 + 3] = a.w[i];
+		}
+	}
+}
+#endif
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstddef>
+
+#include "PMathAVX2.h"
+#include "PMathBVHTraversal.h"
+
+// Ray packets shared by the AVX2 kernels that trace 8 rays together. Same rules as PMathAVX2.h:
+// only include from files compiled with AVX2/FMA enabled.
+
+namespace PMgene::Math::Detail::AVX2
+{
+	namespace
+	{
+		// 8 rays in SoA form
+		struct Packet
+		{
+			__m256 origin[3];
+			__m256 direction[3];
+			__m256 inverse[3];
+			__m256 scaledOrigin[3];
+
+			Packet(const float* rays, size_t count) noexcept
+			{
+				alignas(32) float soa[6][8] = {};
+				for (size_t i = 0; i < count; ++i)
+				{
+					for (int k = 0; k < 6; ++k)
+						soa[k][i] = rays[6 * i + k];
+				}
+
+				const __m256 sign = _mm256_set1_ps(-0.f);
+				const __m256 minDirection = _mm256_set1_ps(MinDirection);
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					origin[axis] = _mm256_load_ps(soa[axis]);
+					direction[axis] = _mm256_load_ps(soa[axis + 3]);
+
+					// Same clamping as BVHRay, keeping the sign of tiny components
+					const __m256 d = direction[axis];
+					const __m256 tiny = _mm256_cmp_ps(_mm256_andnot_ps(sign, d), minDirection, _CMP_LT_OQ);
+					const __m256 clamped = _mm256_blendv_ps(d, _mm256_or_ps(_mm256_and_ps(sign, d), minDirection), tiny);
+					inverse[axis] = _mm256_div_ps(_mm256_set1_ps(1.f), clamped);
+					scaledOrigin[axis] = _mm256_mul_ps(origin[axis], inverse[axis]);
+				}
+			}
+
+			// Entry distances into a box given by its 6 bounds, and the lanes that hit it before 'closest'
+			__m256 TestBox(const float* lo, const float* hi, __m256 closest, __m256& tNear) const noexcept
+			{
+				__m256 t0 = _mm256_setzero_ps();
+				__m256 t1 = closest;
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					const __m256 a = _mm256_fmsub_ps(_mm256_set1_ps(lo[axis]), inverse[axis], scaledOrigin[axis]);
+					const __m256 b = _mm256_fmsub_ps(_mm256_set1_ps(hi[axis]), inverse[axis], scaledOrigin[axis]);
+					t0 = _mm256_max_ps(t0, _mm256_min_ps(a, b));
+					t1 = _mm256_min_ps(t1, _mm256_max_ps(a, b));
+				}
+				tNear = t0;
+				return _mm256_cmp_ps(t0, t1, _CMP_LE_OQ);
+			}
+
+			// Möller-Trumbore for all 8 rays against one triangle
+			__m256 TestTriangle(const float* triangle, __m256 closest, __m256& t, __m256& u, __m256& v) const noexcept
+			{
+				const __m256 e1[3] = { _mm256_set1_ps(triangle[3]), _mm256_set1_ps(triangle[4]), _mm256_set1_ps(triangle[5]) };
+				const __m256 e2[3] = { _mm256_set1_ps(triangle[6]), _mm256_set1_ps(triangle[7]), _mm256_set1_ps(triangle[8]) };
+				const __m256* d = direction;
+
+				const __m256 p[3] = {
+					_mm256_fmsub_ps(d[1], e2[2], _mm256_mul_ps(d[2], e2[1])),
+					_mm256_fmsub_ps(d[2], e2[0], _mm256_mul_ps(d[0], e2[2])),
+					_mm256_fmsub_ps(d[0], e2[1], _mm256_mul_ps(d[1], e2[0]))
+				};
+				const __m256 det = _mm256_fmadd_ps(e1[0], p[0], _mm256_fmadd_ps(e1[1], p[1], _mm256_mul_ps(e1[2], p[2])));
+				const __m256 inverse = _mm256_div_ps(_mm256_set1_ps(1.f), det);
+
+				const __m256 s[3] = {
+					_mm256_sub_ps(origin[0], _mm256_set1_ps(triangle[0])),
+					_mm256_sub_ps(origin[1], _mm256_set1_ps(triangle[1])),
+					_mm256_sub_ps(origin[2], _mm256_set1_ps(triangle[2]))
+				};
+				u = _mm256_mul_ps(_mm256_fmadd_ps(s[0], p[0], _mm256_fmadd_ps(s[1], p[1], _mm256_mul_ps(s[2], p[2]))), inverse);
+
+				const __m256 q[3] = {
+					_mm256_fmsub_ps(s[1], e1[2], _mm256_mul_ps(s[2], e1[1])),
+					_mm256_fmsub_ps(s[2], e1[0], _mm256_mul_ps(s[0], e1[2])),
+					_mm256_fmsub_ps(s[0], e1[1], _mm256_mul_ps(s[1], e1[0]))
+				};
+				v = _mm256_mul_ps(_mm256_fmadd_ps(d[0], q[0], _mm256_fmadd_ps(d[1], q[1], _mm256_mul_ps(d[2], q[2]))), inverse);
+				t = _mm256_mul_ps(_mm256_fmadd_ps(e2[0], q[0], _mm256_fmadd_ps(e2[1], q[1], _mm256_mul_ps(e2[2], q[2]))), inverse);
+
+				// Ordered comparisons also reject the NaNs of parallel rays
+				const __m256 zero = _mm256_setzero_ps();
+				__m256 hit = _mm256_cmp_ps(det, zero, _CMP_NEQ_OQ);
+				hit = _mm256_and_ps(hit, _mm256_cmp_ps(u, zero, _CMP_GE_OQ));
+				hit = _mm256_and_ps(hit, _mm256_cmp_ps(v, zero, _CMP_GE_OQ));
+				hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_add_ps(u, v), _mm256_set1_ps(1.f), _CMP_LE_OQ));
+				hit = _mm256_and_ps(hit, _mm256_cmp_ps(t, zero, _CMP_GE_OQ));
+				return _mm256_and_ps(hit, _mm256_cmp_ps(t, closest, _CMP_LT_OQ));
+			}
+		};
+	}
+}
@@ -0,0 +1,416 @@
+#pragma once
+#include <cassert>
+#include <cmath>
+
+#include "PMath.inl"
+
+namespace PMgene::Math
+{
+	//****************************************************************************
+	// Register types
+	// Companions of Vector3, Quaternion and Matrix that hold an XMVECTOR or XMMATRIX instead of
+	// XMFLOAT storage, so chains of operations stay in registers. The storage types load and store
+	// around every operator. Converting from and to a storage type is one load or store; everything
+	// else has the API of PMath.h. Definitions are inline, so like PMath.inl this header compiles
+	// DirectXMath into the including code. Like XMVECTOR, they belong in locals and parameters, not in
+	// arrays or members that outlive a computation. Vector3V's w lane is unspecified.
+	//
+	//   Vector3V p(position);
+	//   p = p + Vector3V(velocity) * dt;
+	//   position = p.ToVector3();
+
+	struct QuaternionV;
+	struct MatrixV;
+
+
+	//****************************************************************************
+	// Vector3V
+
+	struct Vector3V
+	{
+		XMVECTOR v;
+
+		// Constructors
+		Vector3V() noexcept : v(XMVectorZero()) {}
+		Vector3V(float ix, float iy, float iz) noexcept : v(XMVectorSet(ix, iy, iz, 0.f)) {}
+		explicit Vector3V(float ix) noexcept : v(XMVectorReplicate(ix)) {}
+		explicit Vector3V(FXMVECTOR V) noexcept : v(V) {}
+		explicit Vector3V(const Vector3& V) noexcept : v(XMLoadFloat3(&V)) {}
+
+		operator XMVECTOR() const noexcept { return v; }
+
+		// Conversions
+		[[nodiscard]] Vector3 ToVector3() const noexcept
+		{
+			Vector3 R;
+			XMStoreFloat3(&R, v);
+			return R;
+		}
+		void Store(Vector3& result) const noexcept { XMStoreFloat3(&result, v); }
+
+		[[nodiscard]] float X() const noexcept { return XMVectorGetX(v); }
+		[[nodiscard]] float Y() const noexcept { return XMVectorGetY(v); }
+		[[nodiscard]] float Z() const noexcept { return XMVectorGetZ(v); }
+
+		// Comparison operators
+		bool operator ==(Vector3V V) const noexcept { return XMVector3Equal(v, V.v); }
+		bool operator !=(Vector3V V) const noexcept { return XMVector3NotEqual(v, V.v); }
+
+		// Assignment operators
+		Vector3V& operator+=(Vector3V V) noexcept { v = XMVectorAdd(v, V.v); return *this; }
+		Vector3V& operator-=(Vector3V V) noexcept { v = XMVectorSubtract(v, V.v); return *this; }
+		Vector3V& operator*=(Vector3V V) noexcept { v = XMVectorMultiply(v, V.v); return *this; }
+		Vector3V& operator*=(float S) noexcept { v = XMVectorScale(v, S); return *this; }
+		Vector3V& operator/=(float S) noexcept
+		{
+			if (S != 0.f)
+				v = XMVectorScale(v, 1.f / S);
+			return *this;
+		}
+
+		// Unary operators
+		Vector3V operator+() const noexcept { return *this; }
+		Vector3V operator-() const noexcept { return Vector3V(XMVectorNegate(v)); }
+
+		// Vector operations
+		template <Precision P = Precision::Exact>
+		[[nodiscard]] float Length() const noexcept
+		{
+			if constexpr (P == Precision::Exact)
+				return XMVectorGetX(XMVector3Length(v));
+			return XMVectorGetX(Detail::Sqrt<P>(XMVector3LengthSq(v)));
+		}
+
+		[[nodiscard]] float Dot(Vector3V V) const noexcept { return XMVectorGetX(XMVector3Dot(v, V.v)); }
+		void Cross(Vector3V V, Vector3V& result) const noexcept { result.v = XMVector3Cross(v, V.v); }
+		[[nodiscard]] Vector3V Cross(Vector3V V) const noexcept { return Vector3V(XMVector3Cross(v, V.v)); }
+
+		template <Precision P = Precision::Exact>
+		void Normalize() noexcept { Normalize<P>(*this); }
+		template <Precision P = Precision::Exact>
+		void Normalize(Vector3V& result) const noexcept
+		{
+			if constexpr (P == Precision::Exact)
+				result.v = XMVector3Normalize(v);
+			else
+				result.v = Detail::Normalize<P>(v, XMVector3LengthSq(v));
+		}
+	};
+
+	// Binary operators
+	inline Vector3V operator+(Vector3V V1, Vector3V V2) noexcept { return Vector3V(XMVectorAdd(V1.v, V2.v)); }
+	inline Vector3V operator-(Vector3V V1, Vector3V V2) noexcept { return Vector3V(XMVectorSubtract(V1.v, V2.v)); }
+	inline Vector3V operator*(Vector3V V1, Vector3V V2) noexcept { return Vector3V(XMVectorMultiply(V1.v, V2.v)); }
+	inline Vector3V operator*(Vector3V V, float S) noexcept { return Vector3V(XMVectorScale(V.v, S)); }
+	inline Vector3V operator/(Vector3V V1, Vector3V V2) noexcept { return Vector3V(XMVectorDivide(V1.v, V2.v)); }
+	inline Vector3V operator/(Vector3V V, float S) noexcept { return Vector3V(XMVectorScale(V.v, 1.f / S)); }
+	inline Vector3V operator*(float S, Vector3V V) noexcept { return Vector3V(XMVectorScale(V.v, S)); }
+
+
+	//****************************************************************************
+	// QuaternionV
+
+	struct QuaternionV
+	{
+		XMVECTOR v;
+
+		// Constructors
+		QuaternionV() noexcept : v(XMQuaternionIdentity()) {}
+		QuaternionV(float ix, float iy, float iz, float iw) noexcept : v(XMVectorSet(ix, iy, iz, iw)) {}
+		QuaternionV(Vector3V V, float scalar) noexcept : v(XMVectorSetW(V.v, scalar)) {}
+		explicit QuaternionV(FXMVECTOR Q) noexcept : v(Q) {}
+		explicit QuaternionV(const Quaternion& Q) noexcept : v(XMLoadFloat4(&Q)) {}
+
+		operator XMVECTOR() const noexcept { return v; }
+
+		// Conversions
+		[[nodiscard]] Quaternion ToQuaternion() const noexcept { return Quaternion(v); }
+		void Store(Quaternion& result) const noexcept { XMStoreFloat4(&result, v); }
+
+		// Comparison operators
+		bool operator ==(QuaternionV Q) const noexcept { return XMQuaternionEqual(v, Q.v); }
+		bool operator !=(QuaternionV Q) const noexcept { return XMQuaternionNotEqual(v, Q.v); }
+
+		// Assignment operators
+		QuaternionV& operator+=(QuaternionV Q) noexcept { v = XMVectorAdd(v, Q.v); return *this; }
+		QuaternionV& operator-=(QuaternionV Q) noexcept { v = XMVectorSubtract(v, Q.v); return *this; }
+		QuaternionV& operator*=(QuaternionV Q) noexcept { v = XMQuaternionMultiply(v, Q.v); return *this; }
+		QuaternionV& operator*=(float S) noexcept { v = XMVectorScale(v, S); return *this; }
+		QuaternionV& operator/=(QuaternionV Q) noexcept { v = XMQuaternionMultiply(v, XMQuaternionInverse(Q.v)); return *this; }
+
+		// Unary operators
+		QuaternionV operator+() const noexcept { return *this; }
+		QuaternionV operator-() const noexcept { return QuaternionV(XMVectorNegate(v)); }
+
+		// Quaternion operations
+		template <Precision P = Precision::Exact>
+		[[nodiscard]] float Length() const noexcept
+		{
+			if constexpr (P == Precision::Exact)
+				return XMVectorGetX(XMQuaternionLength(v));
+			return XMVectorGetX(Detail::Sqrt<P>(XMQuaternionLengthSq(v)));
+		}
+
+		template <Precision P = Precision::Exact>
+		void Normalize() noexcept
+		{
+			if constexpr (P == Precision::Exact)
+				v = XMQuaternionNormalize(v);
+			else
+				v = Detail::Normalize<P>(v, XMQuaternionLengthSq(v));
+		}
+
+		void Conjugate() noexcept { v = XMQuaternionConjugate(v); }
+
+		void Inverse(QuaternionV& result) const noexcept { result.v = XMQuaternionInverse(v); }
+
+		[[nodiscard]] float Dot(QuaternionV Q) const noexcept { return XMVectorGetX(XMQuaternionDot(v, Q.v)); }
+
+		// Computes rotation about y-axis (y), then x-axis (x), then z-axis (z)
+		template <Precision P = Precision::Exact>
+		[[nodiscard]] Vector3V ToEuler() const noexcept { return Vector3V(ToQuaternion().ToEuler<P>()); }
+
+		// Static functions
+		static QuaternionV CreateFromAxisAngle(Vector3V axis, float angle) noexcept { return QuaternionV(XMQuaternionRotationAxis(axis.v, angle)); }
+
+		// Rotates about y-axis (yaw), then x-axis (pitch), then z-axis (roll)
+		static QuaternionV CreateFromYawPitchRoll(float yaw, float pitch, float roll) noexcept
+		{
+			return QuaternionV(XMQuaternionRotationRollPitchYaw(pitch, yaw, roll));
+		}
+
+		// Rotates about y-axis (angles.y), then x-axis (angles.x), then z-axis (angles.z)
+		static QuaternionV CreateFromYawPitchRoll(Vector3V angles) noexcept { return QuaternionV(XMQuaternionRotationRollPitchYawFromVector(angles.v)); }
+
+		static QuaternionV CreateFromRotationMatrix(const MatrixV& M) noexcept;
+
+		static QuaternionV Lerp(QuaternionV q1, QuaternionV q2, float t) noexcept
+		{
+			// Along the shorter arc, like Quaternion::Lerp
+			const XMVECTOR sign = XMVectorSelect(g_XMOne, g_XMNegativeOne, XMVectorLess(XMVector4Dot(q1.v, q2.v), XMVectorZero()));
+			const XMVECTOR R = XMVectorMultiplyAdd(q1.v, XMVectorReplicate(1.f - t), XMVectorMultiply(q2.v, XMVectorScale(sign, t)));
+			return QuaternionV(XMQuaternionNormalize(R));
+		}
+		static void Lerp(QuaternionV q1, QuaternionV q2, float t, QuaternionV& result) noexcept { result = Lerp(q1, q2, t); }
+
+		static QuaternionV Slerp(QuaternionV q1, QuaternionV q2, float t) noexcept { return QuaternionV(XMQuaternionSlerp(q1.v, q2.v, t)); }
+		static void Slerp(QuaternionV q1, QuaternionV q2, float t, QuaternionV& result) noexcept { result.v = XMQuaternionSlerp(q1.v, q2.v, t); }
+
+		// q1 followed by q2, like Quaternion::Concatenate
+		static QuaternionV Concatenate(QuaternionV q1, QuaternionV q2) noexcept { return QuaternionV(XMQuaternionMultiply(q2.v, q1.v)); }
+
+		static float Angle(QuaternionV q1, QuaternionV q2) noexcept
+		{
+			// The conjugate stands in for the inverse of a unit quaternion
+			const XMVECTOR R = XMQuaternionMultiply(XMQuaternionConjugate(q1.v), q2.v);
+			return 2.f * atan2f(XMVectorGetX(XMVector3Length(R)), XMVectorGetW(R));
+		}
+	};
+
+	// Binary operators
+	inline QuaternionV operator+(QuaternionV Q1, QuaternionV Q2) noexcept { return QuaternionV(XMVectorAdd(Q1.v, Q2.v)); }
+	inline QuaternionV operator-(QuaternionV Q1, QuaternionV Q2) noexcept { return QuaternionV(XMVectorSubtract(Q1.v, Q2.v)); }
+	inline QuaternionV operator*(QuaternionV Q1, QuaternionV Q2) noexcept { return QuaternionV(XMQuaternionMultiply(Q1.v, Q2.v)); }
+	inline QuaternionV operator*(QuaternionV Q, float S) noexcept { return QuaternionV(XMVectorScale(Q.v, S)); }
+	inline QuaternionV operator/(QuaternionV Q1, QuaternionV Q2) noexcept { return QuaternionV(XMQuaternionMultiply(Q1.v, XMQuaternionInverse(Q2.v))); }
+	inline QuaternionV operator*(float S, QuaternionV Q) noexcept { return QuaternionV(XMVectorScale(Q.v, S)); }
+
+
+	//****************************************************************************
+	// MatrixV
+
+	struct MatrixV
+	{
+		XMMATRIX m;
+
+		// Constructors
+		MatrixV() noexcept : m(XMMatrixIdentity()) {}
+		explicit MatrixV(Vector3V r0, Vector3V r1, Vector3V r2) noexcept
+			: m(XMVectorAndInt(r0.v, g_XMMask3), XMVectorAndInt(r1.v, g_XMMask3), XMVectorAndInt(r2.v, g_XMMask3), g_XMIdentityR3)
+		{
+		}
+		explicit MatrixV(FXMMATRIX M) noexcept : m(M) {}
+		explicit MatrixV(const Matrix& M) noexcept : m(XMLoadFloat4x4(&M)) {}
+
+		operator XMMATRIX() const noexcept { return m; }
+
+		// Conversions
+		[[nodiscard]] Matrix ToMatrix() const noexcept { return Matrix(m); }
+		void Store(Matrix& result) const noexcept { XMStoreFloat4x4(&result, m); }
+
+		// Comparison operators
+		bool operator ==(const MatrixV& M) const noexcept
+		{
+			return XMVector4Equal(m.r[0], M.m.r[0]) && XMVector4Equal(m.r[1], M.m.r[1]) && XMVector4Equal(m.r[2], M.m.r[2])
+			       && XMVector4Equal(m.r[3], M.m.r[3]);
+		}
+		bool operator !=(const MatrixV& M) const noexcept { return !(*this == M); }
+
+		// Assignment operators
+		MatrixV& operator+=(const MatrixV& M) noexcept;
+		MatrixV& operator-=(const MatrixV& M) noexcept;
+		MatrixV& operator*=(const MatrixV& M) noexcept { m = XMMatrixMultiply(m, M.m); return *this; }
+		MatrixV& operator*=(float S) noexcept;
+		MatrixV& operator/=(float S) noexcept;
+
+		// Element-wise divide
+		MatrixV& operator/=(const MatrixV& M) noexcept;
+
+		// Unary operators
+		MatrixV operator+() const noexcept { return *this; }
+		MatrixV operator-() const noexcept;
+
+		[[nodiscard]] Vector3V Translation() const noexcept { return Vector3V(XMVectorAndInt(m.r[3], g_XMMask3)); }
+
+		// Matrix operations
+		bool Decompose(Vector3V& scale, QuaternionV& rotation, Vector3V& translation) const noexcept
+		{
+			return XMMatrixDecompose(&scale.v, &rotation.v, &translation.v, m);
+		}
+
+		[[nodiscard]] MatrixV Transpose() const noexcept { return MatrixV(XMMatrixTranspose(m)); }
+		void Transpose(MatrixV& result) const noexcept { result.m = XMMatrixTranspose(m); }
+
+		[[nodiscard]] MatrixV Invert() const noexcept { return MatrixV(XMMatrixInverse(nullptr, m)); }
+		void Invert(MatrixV& result) const noexcept { result.m = XMMatrixInverse(nullptr, m); }
+
+		[[nodiscard]] float Determinant() const noexcept { return XMVectorGetX(XMMatrixDeterminant(m)); }
+
+		// Vector transforms: points use w = 1, normals w = 0, coords w = 1 followed by the divide by w
+		[[nodiscard]] Vector3V TransformPoint(Vector3V V) const noexcept { return Vector3V(XMVector3Transform(V.v, m)); }
+		[[nodiscard]] Vector3V TransformNormal(Vector3V V) const noexcept { return Vector3V(XMVector3TransformNormal(V.v, m)); }
+		[[nodiscard]] Vector3V TransformCoord(Vector3V V) const noexcept { return Vector3V(XMVector3TransformCoord(V.v, m)); }
+
+		// Static functions
+		static MatrixV CreateTranslation(Vector3V position) noexcept { return MatrixV(XMMatrixTranslationFromVector(position.v)); }
+		static MatrixV CreateTranslation(float x, float y, float z) noexcept { return MatrixV(XMMatrixTranslation(x, y, z)); }
+
+		static MatrixV CreateScale(Vector3V scales) noexcept { return MatrixV(XMMatrixScalingFromVector(scales.v)); }
+		static MatrixV CreateScale(float xs, float ys, float zs) noexcept { return MatrixV(XMMatrixScaling(xs, ys, zs)); }
+		static MatrixV CreateScale(float scale) noexcept { return MatrixV(XMMatrixScaling(scale, scale, scale)); }
+
+		static MatrixV CreateRotationX(float radians) noexcept { return MatrixV(XMMatrixRotationX(radians)); }
+		static MatrixV CreateRotationY(float radians) noexcept { return MatrixV(XMMatrixRotationY(radians)); }
+		static MatrixV CreateRotationZ(float radians) noexcept { return MatrixV(XMMatrixRotationZ(radians)); }
+
+		static MatrixV CreateFromAxisAngle(Vector3V axis, float angle) noexcept { return MatrixV(XMMatrixRotationAxis(axis.v, angle)); }
+
+		static MatrixV CreatePerspectiveFieldOfView(float fov, float aspectRatio, float nearPlane, float farPlane) noexcept
+		{
+			return MatrixV(XMMatrixPerspectiveFovRH(fov, aspectRatio, nearPlane, farPlane));
+		}
+		static MatrixV CreatePerspective(float width, float height, float nearPlane, float farPlane) noexcept
+		{
+			return MatrixV(XMMatrixPerspectiveRH(width, height, nearPlane, farPlane));
+		}
+
+		static MatrixV CreateOrthographic(float width, float height, float zNearPlane, float zFarPlane) noexcept
+		{
+			return MatrixV(XMMatrixOrthographicRH(width, height, zNearPlane, zFarPlane));
+		}
+
+		static MatrixV CreateLookAt(Vector3V position, Vector3V target, Vector3V up) noexcept
+		{
+			return MatrixV(XMMatrixLookAtRH(position.v, target.v, up.v));
+		}
+		static MatrixV CreateWorld(Vector3V position, Vector3V forward, Vector3V up) noexcept;
+
+		static MatrixV CreateFromQuaternion(QuaternionV rotation) noexcept { return MatrixV(XMMatrixRotationQuaternion(rotation.v)); }
+
+		// Rotates about y-axis (yaw), then x-axis (pitch), then z-axis (roll)
+		static MatrixV CreateFromYawPitchRoll(float yaw, float pitch, float roll) noexcept
+		{
+			return MatrixV(XMMatrixRotationRollPitchYaw(pitch, yaw, roll));
+		}
+
+		// Rotates about y-axis (angles.y), then x-axis (angles.x), then z-axis (angles.z)
+		static MatrixV CreateFromYawPitchRoll(Vector3V angles) noexcept { return MatrixV(XMMatrixRotationRollPitchYawFromVector(angles.v)); }
+
+		static MatrixV Lerp(const MatrixV& M1, const MatrixV& M2, float t) noexcept;
+		static void Lerp(const MatrixV& M1, const MatrixV& M2, float t, MatrixV& result) noexcept { result = Lerp(M1, M2, t); }
+	};
+
+	// Binary operators
+	MatrixV operator+(const MatrixV& M1, const MatrixV& M2) noexcept;
+	MatrixV operator-(const MatrixV& M1, const MatrixV& M2) noexcept;
+	inline MatrixV operator*(const MatrixV& M1, const MatrixV& M2) noexcept { return MatrixV(XMMatrixMultiply(M1.m, M2.m)); }
+	MatrixV operator*(const MatrixV& M, float S) noexcept;
+	MatrixV operator/(const MatrixV& M, float S) noexcept;
+	// Element-wise divide
+	MatrixV operator/(const MatrixV& M1, const MatrixV& M2) noexcept;
+	MatrixV operator*(float S, const MatrixV& M) noexcept;
+
+
+	//****************************************************************************
+	// Row-wise MatrixV operations
+
+	namespace Detail
+	{
+		template <typename Op>
+		inline MatrixV MapRows(const MatrixV& M1, const MatrixV& M2, Op op) noexcept
+		{
+			return MatrixV(XMMATRIX(op(M1.m.r[0], M2.m.r[0]), op(M1.m.r[1], M2.m.r[1]), op(M1.m.r[2], M2.m.r[2]), op(M1.m.r[3], M2.m.r[3])));
+		}
+
+		inline MatrixV ScaleRows(const MatrixV& M, float S) noexcept
+		{
+			const XMVECTOR s = XMVectorReplicate(S);
+			return MatrixV(XMMATRIX(XMVectorMultiply(M.m.r[0], s), XMVectorMultiply(M.m.r[1], s), XMVectorMultiply(M.m.r[2], s),
+			                        XMVectorMultiply(M.m.r[3], s)));
+		}
+	}
+
+	inline MatrixV operator+(const MatrixV& M1, const MatrixV& M2) noexcept
+	{
+		return Detail::MapRows(M1, M2, [](FXMVECTOR a, FXMVECTOR b) { return XMVectorAdd(a, b); });
+	}
+
+	inline MatrixV operator-(const MatrixV& M1, const MatrixV& M2) noexcept
+	{
+		return Detail::MapRows(M1, M2, [](FXMVECTOR a, FXMVECTOR b) { return XMVectorSubtract(a, b); });
+	}
+
+	inline MatrixV operator*(const MatrixV& M, float S) noexcept { return Detail::ScaleRows(M, S); }
+	inline MatrixV operator*(float S, const MatrixV& M) noexcept { return Detail::ScaleRows(M, S); }
+
+	inline MatrixV operator/(const MatrixV& M, float S) noexcept
+	{
+		assert(S != 0.f);
+		return Detail::ScaleRows(M, 1.f / S);
+	}
+
+	inline MatrixV operator/(const MatrixV& M1, const MatrixV& M2) noexcept
+	{
+		return Detail::MapRows(M1, M2, [](FXMVECTOR a, FXMVECTOR b) { return XMVectorDivide(a, b); });
+	}
+
+	inline MatrixV& MatrixV::operator+=(const MatrixV& M) noexcept { return *this = *this + M; }
+	inline MatrixV& MatrixV::operator-=(const MatrixV& M) noexcept { return *this = *this - M; }
+	inline MatrixV& MatrixV::operator*=(float S) noexcept { return *this = *this * S; }
+	inline MatrixV& MatrixV::operator/=(float S) noexcept { return *this = *this / S; }
+	inline MatrixV& MatrixV::operator/=(const MatrixV& M) noexcept { return *this = *this / M; }
+
+	inline MatrixV MatrixV::operator-() const noexcept
+	{
+		return MatrixV(XMMATRIX(XMVectorNegate(m.r[0]), XMVectorNegate(m.r[1]), XMVectorNegate(m.r[2]), XMVectorNegate(m.r[3])));
+	}
+
+	inline MatrixV MatrixV::CreateWorld(Vector3V position, Vector3V forward, Vector3V up) noexcept
+	{
+		const XMVECTOR zaxis = XMVector3Normalize(XMVectorNegate(forward.v));
+		const XMVECTOR xaxis = XMVector3Normalize(XMVector3Cross(up.v, zaxis));
+		const XMVECTOR yaxis = XMVector3Cross(zaxis, xaxis);
+		return MatrixV(XMMATRIX(XMVectorAndInt(xaxis, g_XMMask3), XMVectorAndInt(yaxis, g_XMMask3), XMVectorAndInt(zaxis, g_XMMask3),
+		                        XMVectorSelect(g_XMIdentityR3, position.v, g_XMSelect1110)));
+	}
+
+	inline MatrixV MatrixV::Lerp(const MatrixV& M1, const MatrixV& M2, float t) noexcept
+	{
+		return Detail::MapRows(M1, M2, [t](FXMVECTOR a, FXMVECTOR b) { return XMVectorLerp(a, b, t); });
+	}
+
+	inline QuaternionV QuaternionV::CreateFromRotationMatrix(const MatrixV& M) noexcept
+	{
+		return QuaternionV(XMQuaternionRotationMatrix(M.m));
+	}
+}
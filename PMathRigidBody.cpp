@@ -0,0 +1,241 @@
+#include "PMathRigidBody.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "PMathCpu.h"
+#include "PMathKernels.h"
+
+namespace PMgene::Math
+{
+	//****************************************************************************
+	// Portable rigid body kernels
+
+	namespace Detail::Generic
+	{
+		namespace
+		{
+			void Kick(RigidBodyView bodies, const AccelerationView& acceleration, float kick, size_t i) noexcept
+			{
+				const size_t linear = i * acceleration.linearStride;
+				const size_t angular = i * acceleration.angularStride;
+				bodies.velocity.x[i] += acceleration.linear.x[linear] * kick;
+				bodies.velocity.y[i] += acceleration.linear.y[linear] * kick;
+				bodies.velocity.z[i] += acceleration.linear.z[linear] * kick;
+				bodies.angularVelocity.x[i] += acceleration.angular.x[angular] * kick;
+				bodies.angularVelocity.y[i] += acceleration.angular.y[angular] * kick;
+				bodies.angularVelocity.z[i] += acceleration.angular.z[angular] * kick;
+			}
+		}
+
+		void RigidBodyKick(RigidBodyView bodies, AccelerationView acceleration, float kick, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+				Kick(bodies, acceleration, kick, i);
+		}
+
+		void RigidBodyKickDrift(RigidBodyView bodies, AccelerationView acceleration, float kick, float dt, size_t count) noexcept
+		{
+			const float halfDt = 0.5f * dt;
+			for (size_t i = 0; i < count; ++i)
+			{
+				Kick(bodies, acceleration, kick, i);
+
+				bodies.position.x[i] += bodies.velocity.x[i] * dt;
+				bodies.position.y[i] += bodies.velocity.y[i] * dt;
+				bodies.position.z[i] += bodies.velocity.z[i] * dt;
+
+				// q += (h, 0) * q with h = dt / 2 * angular velocity: the vector part gains
+				// qw h + h x q, the scalar part -h . q
+				const float hx = bodies.angularVelocity.x[i] * halfDt;
+				const float hy = bodies.angularVelocity.y[i] * halfDt;
+				const float hz = bodies.angularVelocity.z[i] * halfDt;
+				const float qx = bodies.orientation.x[i], qy = bodies.orientation.y[i], qz = bodies.orientation.z[i], qw = bodies.orientation.w[i];
+				const float x = qx + qw * hx + (hy * qz - hz * qy);
+				const float y = qy + qw * hy + (hz * qx - hx * qz);
+				const float z = qz + qw * hz + (hx * qy - hy * qx);
+				const float w = qw - (hx * qx + hy * qy + hz * qz);
+
+				const float length = std::sqrt(x * x + y * y + z * z + w * w);
+				const float invLength = length != 0.f ? 1.f / length : 0.f;
+				bodies.orientation.x[i] = x * invLength;
+				bodies.orientation.y[i] = y * invLength;
+				bodies.orientation.z[i] = z * invLength;
+				bodies.orientation.w[i] = w * invLength;
+			}
+		}
+	}
+
+
+	//****************************************************************************
+	// RigidBodyStream
+
+	namespace
+	{
+		using KickKernel = void (*)(Detail::RigidBodyView bodies, Detail::AccelerationView acceleration, float kick, size_t count) noexcept;
+		using KickDriftKernel = void (*)(Detail::RigidBodyView bodies, Detail::AccelerationView acceleration, float kick, float dt, size_t count) noexcept;
+
+		// Bodies per parallel chunk, a multiple of the SIMD width
+		constexpr size_t IntegrateGrain = 4096;
+
+		Detail::RigidBodyView View(RigidBodyStream& S) noexcept
+		{
+			return {
+				{ S.position.x.data(), S.position.y.data(), S.position.z.data() },
+				{ S.velocity.x.data(), S.velocity.y.data(), S.velocity.z.data() },
+				{ S.orientation.x.data(), S.orientation.y.data(), S.orientation.z.data(), S.orientation.w.data() },
+				{ S.angularVelocity.x.data(), S.angularVelocity.y.data(), S.angularVelocity.z.data() }
+			};
+		}
+
+		Detail::ConstStreamView3 View(const Vector3Stream& S) noexcept
+		{
+			return { S.x.data(), S.y.data(), S.z.data() };
+		}
+
+		template <typename View>
+		View Offset(View V, size_t offset) noexcept
+		{
+			if constexpr (requires { V.w; })
+				return { V.x + offset, V.y + offset, V.z + offset, V.w + offset };
+			else
+				return { V.x + offset, V.y + offset, V.z + offset };
+		}
+
+		Detail::RigidBodyView Offset(const Detail::RigidBodyView& V, size_t offset) noexcept
+		{
+			return { Offset(V.position, offset), Offset(V.velocity, offset), Offset(V.orientation, offset), Offset(V.angularVelocity, offset) };
+		}
+
+		Detail::AccelerationView Offset(const Detail::AccelerationView& V, size_t offset) noexcept
+		{
+			return { Offset(V.linear, offset * V.linearStride), Offset(V.angular, offset * V.angularStride), V.linearStride, V.angularStride };
+		}
+
+		Detail::AccelerationView Acceleration(const RigidBodyStream& bodies, const Vector3Stream& linear, const Vector3Stream& angular) noexcept
+		{
+			assert(linear.Size() == bodies.Size() || linear.Size() == 1);
+			assert(angular.Size() == bodies.Size() || angular.Size() == 1);
+			(void)bodies;
+			return { View(linear), View(angular), linear.Size() == 1 ? size_t(0) : size_t(1), angular.Size() == 1 ? size_t(0) : size_t(1) };
+		}
+
+		[[maybe_unused]] bool ValidSizes(const RigidBodyStream& bodies) noexcept
+		{
+			const size_t count = bodies.Size();
+			return bodies.velocity.Size() == count && bodies.orientation.Size() == count && bodies.angularVelocity.Size() == count;
+		}
+
+		size_t Grain(const Parallel::ParallelPolicy& policy) noexcept
+		{
+			return policy.grain != 0 ? policy.grain : IntegrateGrain;
+		}
+
+		KickKernel KickFunction() noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+				return Detail::AVX2::RigidBodyKick;
+#endif
+			return Detail::Generic::RigidBodyKick;
+		}
+
+		KickDriftKernel KickDriftFunction() noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+				return Detail::AVX2::RigidBodyKickDrift;
+#endif
+			return Detail::Generic::RigidBodyKickDrift;
+		}
+
+		void Kick(const Parallel::ParallelPolicy* policy, RigidBodyStream& bodies, const Vector3Stream& linear, const Vector3Stream& angular,
+		          float kick) noexcept
+		{
+			assert(ValidSizes(bodies));
+			const KickKernel kernel = KickFunction();
+			const Detail::RigidBodyView state = View(bodies);
+			const Detail::AccelerationView acceleration = Acceleration(bodies, linear, angular);
+
+			const auto run = [&](Parallel::Range range) {
+				kernel(Offset(state, range.begin), Offset(acceleration, range.begin), kick, range.Size());
+			};
+
+			if (policy)
+				Parallel::ParallelFor(bodies.Size(), Grain(*policy), run);
+			else
+				run({ 0, bodies.Size() });
+		}
+
+		void KickDrift(const Parallel::ParallelPolicy* policy, RigidBodyStream& bodies, const Vector3Stream& linear, const Vector3Stream& angular,
+		               float kick, float dt) noexcept
+		{
+			assert(ValidSizes(bodies));
+			const KickDriftKernel kernel = KickDriftFunction();
+			const Detail::RigidBodyView state = View(bodies);
+			const Detail::AccelerationView acceleration = Acceleration(bodies, linear, angular);
+
+			const auto run = [&](Parallel::Range range) {
+				kernel(Offset(state, range.begin), Offset(acceleration, range.begin), kick, dt, range.Size());
+			};
+
+			if (policy)
+				Parallel::ParallelFor(bodies.Size(), Grain(*policy), run);
+			else
+				run({ 0, bodies.Size() });
+		}
+	}
+
+	void RigidBodyStream::Resize(size_t count)
+	{
+		const size_t previous = orientation.Size();
+		position.Resize(count);
+		velocity.Resize(count);
+		orientation.Resize(count);
+		angularVelocity.Resize(count);
+		if (count > previous)
+			std::fill(orientation.w.begin() + previous, orientation.w.end(), 1.f);
+	}
+
+	void RigidBodyStream::Clear() noexcept
+	{
+		position.Clear();
+		velocity.Clear();
+		orientation.Clear();
+		angularVelocity.Clear();
+	}
+
+	void RigidBodyStream::IntegrateEuler(const Vector3Stream& linearAcceleration, const Vector3Stream& angularAcceleration, float dt) noexcept
+	{
+		KickDrift(nullptr, *this, linearAcceleration, angularAcceleration, dt, dt);
+	}
+
+	void RigidBodyStream::IntegrateEuler(const Parallel::ParallelPolicy& policy, const Vector3Stream& linearAcceleration,
+	                                     const Vector3Stream& angularAcceleration, float dt) noexcept
+	{
+		KickDrift(&policy, *this, linearAcceleration, angularAcceleration, dt, dt);
+	}
+
+	void RigidBodyStream::IntegrateVerletPositions(const Vector3Stream& linearAcceleration, const Vector3Stream& angularAcceleration, float dt) noexcept
+	{
+		KickDrift(nullptr, *this, linearAcceleration, angularAcceleration, 0.5f * dt, dt);
+	}
+
+	void RigidBodyStream::IntegrateVerletPositions(const Parallel::ParallelPolicy& policy, const Vector3Stream& linearAcceleration,
+	                                               const Vector3Stream& angularAcceleration, float dt) noexcept
+	{
+		KickDrift(&policy, *this, linearAcceleration, angularAcceleration, 0.5f * dt, dt);
+	}
+
+	void RigidBodyStream::IntegrateVerletVelocities(const Vector3Stream& linearAcceleration, const Vector3Stream& angularAcceleration, float dt) noexcept
+	{
+		Kick(nullptr, *this, linearAcceleration, angularAcceleration, 0.5f * dt);
+	}
+
+	void RigidBodyStream::IntegrateVerletVelocities(const Parallel::ParallelPolicy& policy, const Vector3Stream& linearAcceleration,
+	                                                const Vector3Stream& angularAcceleration, float dt) noexcept
+	{
+		Kick(&policy, *this, linearAcceleration, angularAcceleration, 0.5f * dt);
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "PMath.h"
+#include "PMathParallel.h"
+#include "PMathStream.h"
+
+namespace PMgene::Math
+{
+	//****************************************************************************
+	// RigidBodyStream
+	// Structure-of-arrays state of many rigid bodies, stepped in a single pass per integration
+	// stage: velocities, positions and orientations are loaded once, 8 bodies at a time on AVX2,
+	// and the orientation derivative is renormalized in the same pass. Orientations are unit
+	// quaternions and angular velocities are world space, in radians per second.
+	//
+	// Accelerations hold either one element per body or a single element applied to every body,
+	// like gravity. Angular accelerations are world space too, the inverse world inertia tensor
+	// times the torque.
+
+	struct RigidBodyStream
+	{
+		Vector3Stream position;
+		Vector3Stream velocity;
+		QuaternionStream orientation;
+		Vector3Stream angularVelocity;
+
+		// Constructors
+		RigidBodyStream() noexcept = default;
+
+		// Bodies at rest at the origin, with the identity orientation
+		explicit RigidBodyStream(size_t count)
+		{
+			Resize(count);
+		}
+
+		[[nodiscard]] size_t Size() const noexcept { return position.Size(); }
+		[[nodiscard]] bool Empty() const noexcept { return position.Empty(); }
+
+		// Added bodies are at rest at the origin, with the identity orientation
+		void Resize(size_t count);
+		void Clear() noexcept;
+
+		// Semi-implicit Euler: the velocities first, then the positions and orientations with the
+		// new velocities
+		void IntegrateEuler(const Vector3Stream& linearAcceleration, const Vector3Stream& angularAcceleration, float dt) noexcept;
+		void IntegrateEuler(const Parallel::ParallelPolicy& policy, const Vector3Stream& linearAcceleration, const Vector3Stream& angularAcceleration,
+		                    float dt) noexcept;
+
+		// Velocity Verlet, split around the force evaluation:
+		//   bodies.IntegrateVerletPositions(a, alpha, dt);   // half kick, then drift
+		//   ...                                              // accelerations at the new positions
+		//   bodies.IntegrateVerletVelocities(a, alpha, dt);  // second half kick
+		void IntegrateVerletPositions(const Vector3Stream& linearAcceleration, const Vector3Stream& angularAcceleration, float dt) noexcept;
+		void IntegrateVerletPositions(const Parallel::ParallelPolicy& policy, const Vector3Stream& linearAcceleration,
+		                              const Vector3Stream& angularAcceleration, float dt) noexcept;
+		void IntegrateVerletVelocities(const Vector3Stream& linearAcceleration, const Vector3Stream& angularAcceleration, float dt) noexcept;
+		void IntegrateVerletVelocities(const Parallel::ParallelPolicy& policy, const Vector3Stream& linearAcceleration,
+		                               const Vector3Stream& angularAcceleration, float dt) noexcept;
+	};
+}
@@ -0,0 +1,85 @@
+#include "PMathCpu.h"
+
+#if PMATH_X86
+#include "PMathAVX2.h"
+#include "PMathKernels.h"
+
+namespace PMgene::Math::Detail::AVX2
+{
+	namespace
+	{
+		// Stride 0 broadcasts element 0 to every lane
+		template <typename Lanes>
+		inline __m256 LoadAcceleration(const float* p, size_t stride, size_t i, Lanes lanes) noexcept
+		{
+			return stride == 0 ? _mm256_set1_ps(*p) : lanes.Load(p + i);
+		}
+
+		// v += a * kick for both velocities, which are also returned
+		template <typename Lanes>
+		inline void Kick(const RigidBodyView& bodies, const AccelerationView& acceleration, __m256 kick, size_t i, Lanes lanes,
+		                 __m256 (&velocity)[3], __m256 (&angular)[3]) noexcept
+		{
+			velocity[0] = _mm256_fmadd_ps(LoadAcceleration(acceleration.linear.x, acceleration.linearStride, i, lanes), kick, lanes.Load(bodies.velocity.x + i));
+			velocity[1] = _mm256_fmadd_ps(LoadAcceleration(acceleration.linear.y, acceleration.linearStride, i, lanes), kick, lanes.Load(bodies.velocity.y + i));
+			velocity[2] = _mm256_fmadd_ps(LoadAcceleration(acceleration.linear.z, acceleration.linearStride, i, lanes), kick, lanes.Load(bodies.velocity.z + i));
+			angular[0] = _mm256_fmadd_ps(LoadAcceleration(acceleration.angular.x, acceleration.angularStride, i, lanes), kick, lanes.Load(bodies.angularVelocity.x + i));
+			angular[1] = _mm256_fmadd_ps(LoadAcceleration(acceleration.angular.y, acceleration.angularStride, i, lanes), kick, lanes.Load(bodies.angularVelocity.y + i));
+			angular[2] = _mm256_fmadd_ps(LoadAcceleration(acceleration.angular.z, acceleration.angularStride, i, lanes), kick, lanes.Load(bodies.angularVelocity.z + i));
+
+			lanes.Store(bodies.velocity.x + i, velocity[0]);
+			lanes.Store(bodies.velocity.y + i, velocity[1]);
+			lanes.Store(bodies.velocity.z + i, velocity[2]);
+			lanes.Store(bodies.angularVelocity.x + i, angular[0]);
+			lanes.Store(bodies.angularVelocity.y + i, angular[1]);
+			lanes.Store(bodies.angularVelocity.z + i, angular[2]);
+		}
+	}
+
+	void RigidBodyKick(RigidBodyView bodies, AccelerationView acceleration, float kick, size_t count) noexcept
+	{
+		const __m256 K = _mm256_set1_ps(kick);
+		ForEach8(count, [&](size_t i, auto lanes) {
+			__m256 velocity[3], angular[3];
+			Kick(bodies, acceleration, K, i, lanes, velocity, angular);
+		});
+	}
+
+	void RigidBodyKickDrift(RigidBodyView bodies, AccelerationView acceleration, float kick, float dt, size_t count) noexcept
+	{
+		const __m256 K = _mm256_set1_ps(kick);
+		const __m256 Dt = _mm256_set1_ps(dt);
+		const __m256 halfDt = _mm256_set1_ps(0.5f * dt);
+		ForEach8(count, [&](size_t i, auto lanes) {
+			__m256 velocity[3], angular[3];
+			Kick(bodies, acceleration, K, i, lanes, velocity, angular);
+
+			lanes.Store(bodies.position.x + i, _mm256_fmadd_ps(velocity[0], Dt, lanes.Load(bodies.position.x + i)));
+			lanes.Store(bodies.position.y + i, _mm256_fmadd_ps(velocity[1], Dt, lanes.Load(bodies.position.y + i)));
+			lanes.Store(bodies.position.z + i, _mm256_fmadd_ps(velocity[2], Dt, lanes.Load(bodies.position.z + i)));
+
+			// q += (h, 0) * q with h = dt / 2 * angular velocity, as in the generic kernel
+			const __m256 hx = _mm256_mul_ps(angular[0], halfDt);
+			const __m256 hy = _mm256_mul_ps(angular[1], halfDt);
+			const __m256 hz = _mm256_mul_ps(angular[2], halfDt);
+			const __m256 qx = lanes.Load(bodies.orientation.x + i);
+			const __m256 qy = lanes.Load(bodies.orientation.y + i);
+			const __m256 qz = lanes.Load(bodies.orientation.z + i);
+			const __m256 qw = lanes.Load(bodies.orientation.w + i);
+			const __m256 x = _mm256_add_ps(_mm256_fmadd_ps(qw, hx, qx), _mm256_fmsub_ps(hy, qz, _mm256_mul_ps(hz, qy)));
+			const __m256 y = _mm256_add_ps(_mm256_fmadd_ps(qw, hy, qy), _mm256_fmsub_ps(hz, qx, _mm256_mul_ps(hx, qz)));
+			const __m256 z = _mm256_add_ps(_mm256_fmadd_ps(qw, hz, qz), _mm256_fmsub_ps(hx, qy, _mm256_mul_ps(hy, qx)));
+			const __m256 w = _mm256_sub_ps(qw, _mm256_fmadd_ps(hz, qz, _mm256_fmadd_ps(hy, qy, _mm256_mul_ps(hx, qx))));
+
+			// Zero-length quaternions normalize to zero, matching the generic kernel
+			const __m256 length = _mm256_sqrt_ps(_mm256_fmadd_ps(w, w, _mm256_fmadd_ps(z, z, _mm256_fmadd_ps(y, y, _mm256_mul_ps(x, x)))));
+			const __m256 nonZero = _mm256_cmp_ps(length, _mm256_setzero_ps(), _CMP_NEQ_OQ);
+			const __m256 invLength = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(1.f), length), nonZero);
+			lanes.Store(bodies.orientation.x + i, _mm256_mul_ps(x, invLength));
+			lanes.Store(bodies.orientation.y + i, _mm256_mul_ps(y, invLength));
+			lanes.Store(bodies.orientation.z + i, _mm256_mul_ps(z, invLength));
+			lanes.Store(bodies.orientation.w + i, _mm256_mul_ps(w, invLength));
+		});
+	}
+}
+#endif
@@ -0,0 +1,412 @@
+#include "PMathSkinning.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "PMath.inl"
+#include "PMathCpu.h"
+#include "PMathKernels.h"
+
+using namespace DirectX;
+
+namespace PMgene::Math
+{
+	//****************************************************************************
+	// Dual quaternion
+	// XMQuaternionMultiply(a, b) is the product b * a, so the products below read right to left
+
+	DualQuaternion::DualQuaternion(const Quaternion& rotation, const Vector3& translation) noexcept : real(rotation)
+	{
+		// dual = t * r / 2
+		const XMVECTOR t = XMVectorSetW(XMLoadFloat3(&translation), 0.f);
+		XMStoreFloat4(&dual, XMVectorScale(XMQuaternionMultiply(XMLoadFloat4(&rotation), t), 0.5f));
+	}
+
+	bool DualQuaternion::operator ==(const DualQuaternion& D) const noexcept
+	{
+		return real == D.real && dual == D.dual;
+	}
+
+	bool DualQuaternion::operator !=(const DualQuaternion& D) const noexcept
+	{
+		return !(*this == D);
+	}
+
+	DualQuaternion& DualQuaternion::operator*=(const DualQuaternion& D) noexcept
+	{
+		*this = *this * D;
+		return *this;
+	}
+
+	Vector3 DualQuaternion::Translation() const noexcept
+	{
+		// t = 2 * dual * conjugate(real)
+		const XMVECTOR t = XMQuaternionMultiply(XMQuaternionConjugate(XMLoadFloat4(&real)), XMLoadFloat4(&dual));
+
+		Vector3 R;
+		XMStoreFloat3(&R, XMVectorScale(t, 2.f));
+		return R;
+	}
+
+	void DualQuaternion::Normalize() noexcept
+	{
+		const XMVECTOR length = XMVector4Length(XMLoadFloat4(&real));
+		XMStoreFloat4(&real, XMVectorDivide(XMLoadFloat4(&real), length));
+		XMStoreFloat4(&dual, XMVectorDivide(XMLoadFloat4(&dual), length));
+	}
+
+	DualQuaternion DualQuaternion::Invert() const noexcept
+	{
+		DualQuaternion R;
+		XMStoreFloat4(&R.real, XMQuaternionConjugate(XMLoadFloat4(&real)));
+		XMStoreFloat4(&R.dual, XMQuaternionConjugate(XMLoadFloat4(&dual)));
+		return R;
+	}
+
+	Matrix DualQuaternion::ToMatrix() const noexcept
+	{
+		XMMATRIX M = XMMatrixRotationQuaternion(XMLoadFloat4(&real));
+		const Vector3 t = Translation();
+		M.r[3] = XMVectorSet(t.x, t.y, t.z, 1.f);
+
+		Matrix R;
+		XMStoreFloat4x4(&R, M);
+		return R;
+	}
+
+	Vector3 DualQuaternion::TransformPoint(const Vector3& V) const noexcept
+	{
+		const XMVECTOR v = XMVector3Rotate(XMLoadFloat3(&V), XMLoadFloat4(&real));
+		const Vector3 t = Translation();
+
+		Vector3 R;
+		XMStoreFloat3(&R, XMVectorAdd(v, XMLoadFloat3(&t)));
+		return R;
+	}
+
+	Vector3 DualQuaternion::TransformNormal(const Vector3& V) const noexcept
+	{
+		Vector3 R;
+		XMStoreFloat3(&R, XMVector3Rotate(XMLoadFloat3(&V), XMLoadFloat4(&real)));
+		return R;
+	}
+
+	DualQuaternion DualQuaternion::CreateFromMatrix(const Matrix& M) noexcept
+	{
+		Vector3 scale, translation;
+		Quaternion rotation;
+		if (!M.Decompose(scale, rotation, translation))
+			rotation = Quaternion::Identity;
+		return DualQuaternion(rotation, Vector3(M._41, M._42, M._43));
+	}
+
+	DualQuaternion operator*(const DualQuaternion& D1, const DualQuaternion& D2) noexcept
+	{
+		// real = r2 * r1, dual = r2 * d1 + d2 * r1
+		const XMVECTOR r1 = XMLoadFloat4(&D1.real);
+		const XMVECTOR d1 = XMLoadFloat4(&D1.dual);
+		const XMVECTOR r2 = XMLoadFloat4(&D2.real);
+		const XMVECTOR d2 = XMLoadFloat4(&D2.dual);
+
+		DualQuaternion R;
+		XMStoreFloat4(&R.real, XMQuaternionMultiply(r1, r2));
+		XMStoreFloat4(&R.dual, XMVectorAdd(XMQuaternionMultiply(d1, r2), XMQuaternionMultiply(r1, d2)));
+		return R;
+	}
+
+
+	//****************************************************************************
+	// Skin weights
+
+	SkinWeights::SkinWeights(size_t vertexCount, size_t influenceCount)
+	{
+		Resize(vertexCount, influenceCount);
+	}
+
+	void SkinWeights::Resize(size_t vertexCount, size_t influenceCount)
+	{
+		assert(influenceCount <= MaxInfluences);
+		m_joints.assign(vertexCount * influenceCount, 0);
+		m_weights.assign(vertexCount * influenceCount, 0.f);
+		m_vertexCount = vertexCount;
+		m_influenceCount = influenceCount;
+	}
+
+	void SkinWeights::Clear() noexcept
+	{
+		m_joints.clear();
+		m_weights.clear();
+		m_vertexCount = 0;
+		m_influenceCount = 0;
+	}
+
+	void SkinWeights::NormalizeWeights() noexcept
+	{
+		for (size_t i = 0; i < m_vertexCount; ++i)
+		{
+			float sum = 0.f;
+			for (size_t k = 0; k < m_influenceCount; ++k)
+				sum += m_weights[k * m_vertexCount + i];
+			if (sum <= 0.f)
+				continue;
+
+			const float scale = 1.f / sum;
+			for (size_t k = 0; k < m_influenceCount; ++k)
+				m_weights[k * m_vertexCount + i] *= scale;
+		}
+	}
+
+
+	//****************************************************************************
+	// Portable skinning kernels
+
+	namespace Detail::Generic
+	{
+		namespace
+		{
+			void StoreNormal(StreamView3 normals, size_t i, float x, float y, float z) noexcept
+			{
+				const float length = std::sqrt(x * x + y * y + z * z);
+				const float invLength = length != 0.f ? 1.f / length : 0.f;
+				normals.x[i] = x * invLength;
+				normals.y[i] = y * invLength;
+				normals.z[i] = z * invLength;
+			}
+		}
+
+		void SkinLinearBlend(const float* palette, SkinView skin, ConstStreamView3 positions, ConstStreamView3 normals,
+		                     StreamView3 skinnedPositions, StreamView3 skinnedNormals, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				// Rows 0-3 of the blended matrix, columns x, y and z
+				float m[12] = {};
+				for (size_t k = 0; k < skin.influences; ++k)
+				{
+					const float weight = skin.weights[k * skin.stride + i];
+					const float* M = palette + skin.joints[k * skin.stride + i] * size_t(16);
+					for (int row = 0; row < 4; ++row)
+					{
+						m[row * 3] += weight * M[row * 4];
+						m[row * 3 + 1] += weight * M[row * 4 + 1];
+						m[row * 3 + 2] += weight * M[row * 4 + 2];
+					}
+				}
+
+				const float x = positions.x[i], y = positions.y[i], z = positions.z[i];
+				skinnedPositions.x[i] = x * m[0] + y * m[3] + z * m[6] + m[9];
+				skinnedPositions.y[i] = x * m[1] + y * m[4] + z * m[7] + m[10];
+				skinnedPositions.z[i] = x * m[2] + y * m[5] + z * m[8] + m[11];
+
+				if (normals.x)
+				{
+					const float nx = normals.x[i], ny = normals.y[i], nz = normals.z[i];
+					StoreNormal(skinnedNormals, i, nx * m[0] + ny * m[3] + nz * m[6], nx * m[1] + ny * m[4] + nz * m[7], nx * m[2] + ny * m[5] + nz * m[8]);
+				}
+			}
+		}
+
+		void SkinDualQuaternionBlend(const float* palette, SkinView skin, ConstStreamView3 positions, ConstStreamView3 normals,
+		                             StreamView3 skinnedPositions, StreamView3 skinnedNormals, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float* pivot = palette + skin.joints[i] * size_t(8);
+
+				// Real part r, dual part d
+				float b[8] = {};
+				for (size_t k = 0; k < skin.influences; ++k)
+				{
+					const float* D = palette + skin.joints[k * skin.stride + i] * size_t(8);
+					const float dot = D[0] * pivot[0] + D[1] * pivot[1] + D[2] * pivot[2] + D[3] * pivot[3];
+					const float weight = std::copysign(skin.weights[k * skin.stride + i], dot);
+					for (int e = 0; e < 8; ++e)
+						b[e] += weight * D[e];
+				}
+
+				const float length = std::sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2] + b[3] * b[3]);
+				const float invLength = length != 0.f ? 1.f / length : 0.f;
+				const float rx = b[0] * invLength, ry = b[1] * invLength, rz = b[2] * invLength, rw = b[3] * invLength;
+				const float dx = b[4] * invLength, dy = b[5] * invLength, dz = b[6] * invLength, dw = b[7] * invLength;
+
+				// Translation t = 2 (rw d - dw r + r x d), vector parts only
+				const float tx = 2.f * (rw * dx - dw * rx + ry * dz - rz * dy);
+				const float ty = 2.f * (rw * dy - dw * ry + rz * dx - rx * dz);
+				const float tz = 2.f * (rw * dz - dw * rz + rx * dy - ry * dx);
+
+				// Rotation v' = v + 2 r x (r x v + rw v)
+				const auto rotate = [&](float vx, float vy, float vz, float& ox, float& oy, float& oz) {
+					const float cx = ry * vz - rz * vy + rw * vx;
+					const float cy = rz * vx - rx * vz + rw * vy;
+					const float cz = rx * vy - ry * vx + rw * vz;
+					ox = vx + 2.f * (ry * cz - rz * cy);
+					oy = vy + 2.f * (rz * cx - rx * cz);
+					oz = vz + 2.f * (rx * cy - ry * cx);
+				};
+
+				float px, py, pz;
+				rotate(positions.x[i], positions.y[i], positions.z[i], px, py, pz);
+				skinnedPositions.x[i] = px + tx;
+				skinnedPositions.y[i] = py + ty;
+				skinnedPositions.z[i] = pz + tz;
+
+				if (normals.x)
+				{
+					float nx, ny, nz;
+					rotate(normals.x[i], normals.y[i], normals.z[i], nx, ny, nz);
+					StoreNormal(skinnedNormals, i, nx, ny, nz);
+				}
+			}
+		}
+	}
+
+
+	//****************************************************************************
+	// Skinning
+
+	namespace
+	{
+		static_assert(sizeof(Matrix) == 16 * sizeof(float), "Matrix must be tightly packed for the skinning kernels");
+		static_assert(sizeof(DualQuaternion) == 8 * sizeof(float), "DualQuaternion must be tightly packed for the skinning kernels");
+
+		using SkinKernel = void (*)(const float* palette, Detail::SkinView skin, Detail::ConstStreamView3 positions, Detail::ConstStreamView3 normals,
+		                            Detail::StreamView3 skinnedPositions, Detail::StreamView3 skinnedNormals, size_t count) noexcept;
+
+		// Vertices per parallel chunk, a multiple of the SIMD width
+		constexpr size_t SkinGrain = 4096;
+
+		Detail::ConstStreamView3 View(const Vector3Stream* S) noexcept
+		{
+			return S ? Detail::ConstStreamView3{ S->x.data(), S->y.data(), S->z.data() } : Detail::ConstStreamView3{};
+		}
+
+		Detail::StreamView3 View(Vector3Stream* S) noexcept
+		{
+			return S ? Detail::StreamView3{ S->x.data(), S->y.data(), S->z.data() } : Detail::StreamView3{};
+		}
+
+		template <typename View>
+		View Offset(View V, size_t offset) noexcept
+		{
+			return V.x ? View{ V.x + offset, V.y + offset, V.z + offset } : V;
+		}
+
+		SkinKernel LinearBlendKernel() noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+				return Detail::AVX2::SkinLinearBlend;
+#endif
+			return Detail::Generic::SkinLinearBlend;
+		}
+
+		SkinKernel DualQuaternionBlendKernel() noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+				return Detail::AVX2::SkinDualQuaternionBlend;
+#endif
+			return Detail::Generic::SkinDualQuaternionBlend;
+		}
+
+		[[maybe_unused]] bool ValidJoints(size_t paletteSize, const SkinWeights& weights) noexcept
+		{
+			for (size_t k = 0; k < weights.InfluenceCount(); ++k)
+			{
+				const std::span<const uint16_t> joints = weights.Joints(k);
+				if (std::any_of(joints.begin(), joints.end(), [&](uint16_t joint) { return joint >= paletteSize; }))
+					return false;
+			}
+			return true;
+		}
+
+		// Normals and skinnedNormals are both null or both set
+		void Skin(const Parallel::ParallelPolicy* policy, SkinKernel kernel, const float* palette, size_t paletteSize, const SkinWeights& weights,
+		          const Vector3Stream& positions, const Vector3Stream* normals, Vector3Stream& skinnedPositions, Vector3Stream* skinnedNormals) noexcept
+		{
+			const size_t count = weights.VertexCount();
+			assert(positions.Size() == count && skinnedPositions.Size() == count);
+			assert(!normals || (normals->Size() == count && skinnedNormals->Size() == count));
+			assert(ValidJoints(paletteSize, weights));
+			(void)paletteSize;
+
+			const Detail::SkinView skin = { weights.Joints(0).data(), weights.Weights(0).data(), weights.InfluenceCount(), count };
+			const Detail::ConstStreamView3 input = View(&positions);
+			const Detail::ConstStreamView3 inputNormals = View(normals);
+			const Detail::StreamView3 output = View(&skinnedPositions);
+			const Detail::StreamView3 outputNormals = View(skinnedNormals);
+
+			const auto run = [&](Parallel::Range range) {
+				const Detail::SkinView chunk = { skin.joints + range.begin, skin.weights + range.begin, skin.influences, skin.stride };
+				kernel(palette, chunk, Offset(input, range.begin), Offset(inputNormals, range.begin), Offset(output, range.begin),
+				       Offset(outputNormals, range.begin), range.Size());
+			};
+
+			if (policy)
+				Parallel::ParallelFor(count, policy->grain ? policy->grain : SkinGrain, run);
+			else
+				run({ 0, count });
+		}
+
+		const float* Data(std::span<const Matrix> palette) noexcept
+		{
+			return reinterpret_cast<const float*>(palette.data());
+		}
+
+		const float* Data(std::span<const DualQuaternion> palette) noexcept
+		{
+			return reinterpret_cast<const float*>(palette.data());
+		}
+	}
+
+	void Skinning::LinearBlend(std::span<const Matrix> palette, const SkinWeights& weights, const Vector3Stream& positions,
+	                           Vector3Stream& skinnedPositions) noexcept
+	{
+		Skin(nullptr, LinearBlendKernel(), Data(palette), palette.size(), weights, positions, nullptr, skinnedPositions, nullptr);
+	}
+
+	void Skinning::LinearBlend(std::span<const Matrix> palette, const SkinWeights& weights, const Vector3Stream& positions, const Vector3Stream& normals,
+	                           Vector3Stream& skinnedPositions, Vector3Stream& skinnedNormals) noexcept
+	{
+		Skin(nullptr, LinearBlendKernel(), Data(palette), palette.size(), weights, positions, &normals, skinnedPositions, &skinnedNormals);
+	}
+
+	void Skinning::LinearBlend(const Parallel::ParallelPolicy& policy, std::span<const Matrix> palette, const SkinWeights& weights,
+	                           const Vector3Stream& positions, Vector3Stream& skinnedPositions) noexcept
+	{
+		Skin(&policy, LinearBlendKernel(), Data(palette), palette.size(), weights, positions, nullptr, skinnedPositions, nullptr);
+	}
+
+	void Skinning::LinearBlend(const Parallel::ParallelPolicy& policy, std::span<const Matrix> palette, const SkinWeights& weights,
+	                           const Vector3Stream& positions, const Vector3Stream& normals, Vector3Stream& skinnedPositions,
+	                           Vector3Stream& skinnedNormals) noexcept
+	{
+		Skin(&policy, LinearBlendKernel(), Data(palette), palette.size(), weights, positions, &normals, skinnedPositions, &skinnedNormals);
+	}
+
+	void Skinning::DualQuaternionBlend(std::span<const DualQuaternion> palette, const SkinWeights& weights, const Vector3Stream& positions,
+	                                   Vector3Stream& skinnedPositions) noexcept
+	{
+		Skin(nullptr, DualQuaternionBlendKernel(), Data(palette), palette.size(), weights, positions, nullptr, skinnedPositions, nullptr);
+	}
+
+	void Skinning::DualQuaternionBlend(std::span<const DualQuaternion> palette, const SkinWeights& weights, const Vector3Stream& positions,
+	                                   const Vector3Stream& normals, Vector3Stream& skinnedPositions, Vector3Stream& skinnedNormals) noexcept
+	{
+		Skin(nullptr, DualQuaternionBlendKernel(), Data(palette), palette.size(), weights, positions, &normals, skinnedPositions, &skinnedNormals);
+	}
+
+	void Skinning::DualQuaternionBlend(const Parallel::ParallelPolicy& policy, std::span<const DualQuaternion> palette, const SkinWeights& weights,
+	                                   const Vector3Stream& positions, Vector3Stream& skinnedPositions) noexcept
+	{
+		Skin(&policy, DualQuaternionBlendKernel(), Data(palette), palette.size(), weights, positions, nullptr, skinnedPositions, nullptr);
+	}
+
+	void Skinning::DualQuaternionBlend(const Parallel::ParallelPolicy& policy, std::span<const DualQuaternion> palette, const SkinWeights& weights,
+	                                   const Vector3Stream& positions, const Vector3Stream& normals, Vector3Stream& skinnedPositions,
+	                                   Vector3Stream& skinnedNormals) noexcept
+	{
+		Skin(&policy, DualQuaternionBlendKernel(), Data(palette), palette.size(), weights, positions, &normals, skinnedPositions, &skinnedNormals);
+	}
+}
@@ -0,0 +1,150 @@
+#pragma once
+#include <cstdint>
+#include <span>
+
+#include "PMath.h"
+#include "PMathMemory.h"
+#include "PMathParallel.h"
+#include "PMathStream.h"
+
+namespace PMgene::Math
+{
+	//****************************************************************************
+	// Dual quaternion
+	// Rigid transform, rotation then translation, as a pair of quaternions: the rotation and half
+	// the translation times the rotation. Blending dual quaternions and normalizing keeps the result
+	// rigid, which is what makes dual-quaternion skinning free of the collapsing joints of linear
+	// blending. Scale is not representable.
+
+	struct DualQuaternion
+	{
+		Quaternion real;
+		Quaternion dual;
+
+		// Constructors
+		constexpr DualQuaternion() noexcept : dual(0.f, 0.f, 0.f, 0.f) {}
+		constexpr DualQuaternion(const Quaternion& r, const Quaternion& d) noexcept : real(r), dual(d) {}
+		DualQuaternion(const Quaternion& rotation, const Vector3& translation) noexcept;
+
+		// Comparison operators
+		bool operator ==(const DualQuaternion& D) const noexcept;
+		bool operator !=(const DualQuaternion& D) const noexcept;
+
+		// Assignment operators
+		DualQuaternion& operator*=(const DualQuaternion& D) noexcept;
+
+		[[nodiscard]] Quaternion Rotation() const noexcept { return real; }
+		[[nodiscard]] Vector3 Translation() const noexcept;
+
+		// Scales both parts so the rotation is a unit quaternion
+		void Normalize() noexcept;
+
+		// Conjugates both parts, the inverse of a unit dual quaternion
+		DualQuaternion Invert() const noexcept;
+
+		// Conversions
+		[[nodiscard]] Matrix ToMatrix() const noexcept;
+
+		// Vector transforms: points are rotated and translated, normals only rotated
+		[[nodiscard]] Vector3 TransformPoint(const Vector3& V) const noexcept;
+		[[nodiscard]] Vector3 TransformNormal(const Vector3& V) const noexcept;
+
+		// Static functions
+		// Keeps the rotation and translation of M; scale and shear are dropped
+		static DualQuaternion CreateFromMatrix(const Matrix& M) noexcept;
+
+		// Constants
+		static const DualQuaternion Identity;
+	};
+
+	// Binary operators
+	// Like Matrix, D1 * D2 applies D1 first
+	DualQuaternion operator*(const DualQuaternion& D1, const DualQuaternion& D2) noexcept;
+
+	// Constants
+	inline constexpr DualQuaternion DualQuaternion::Identity = { Quaternion::Identity, Quaternion(0.f, 0.f, 0.f, 0.f) };
+
+
+	//****************************************************************************
+	// Skin weights
+	// Joint influences of every vertex of a mesh, up to MaxInfluences per vertex. Slots are stored
+	// SoA, slot k of all vertices back to back, so the kernels read one slot of 8 vertices at once.
+	// The weights of a vertex should sum to 1; unused slots have weight 0.
+
+	class SkinWeights
+	{
+	public:
+		static constexpr size_t MaxInfluences = 8;
+
+		SkinWeights() noexcept = default;
+		SkinWeights(size_t vertexCount, size_t influenceCount);
+
+		// Clears every slot to joint 0 with weight 0
+		void Resize(size_t vertexCount, size_t influenceCount);
+		void Clear() noexcept;
+
+		[[nodiscard]] size_t VertexCount() const noexcept { return m_vertexCount; }
+		[[nodiscard]] size_t InfluenceCount() const noexcept { return m_influenceCount; }
+
+		// Element access
+		[[nodiscard]] uint16_t Joint(size_t vertex, size_t slot) const noexcept { return m_joints[slot * m_vertexCount + vertex]; }
+		[[nodiscard]] float Weight(size_t vertex, size_t slot) const noexcept { return m_weights[slot * m_vertexCount + vertex]; }
+		void Set(size_t vertex, size_t slot, uint16_t joint, float weight) noexcept
+		{
+			m_joints[slot * m_vertexCount + vertex] = joint;
+			m_weights[slot * m_vertexCount + vertex] = weight;
+		}
+
+		// One slot of every vertex, for bulk filling
+		[[nodiscard]] std::span<uint16_t> Joints(size_t slot) noexcept { return { m_joints.data() + slot * m_vertexCount, m_vertexCount }; }
+		[[nodiscard]] std::span<float> Weights(size_t slot) noexcept { return { m_weights.data() + slot * m_vertexCount, m_vertexCount }; }
+		[[nodiscard]] std::span<const uint16_t> Joints(size_t slot) const noexcept { return { m_joints.data() + slot * m_vertexCount, m_vertexCount }; }
+		[[nodiscard]] std::span<const float> Weights(size_t slot) const noexcept { return { m_weights.data() + slot * m_vertexCount, m_vertexCount }; }
+
+		// Scales the weights of every vertex to sum to 1, leaving vertices without weight alone
+		void NormalizeWeights() noexcept;
+
+	private:
+		AlignedVector<uint16_t> m_joints;
+		AlignedVector<float> m_weights;
+		size_t m_vertexCount = 0;
+		size_t m_influenceCount = 0;
+	};
+
+
+	//****************************************************************************
+	// Skinning
+	// Deforms SoA vertex streams by a palette of per-joint skinning transforms, usually the inverse
+	// bind pose times the joint's model transform (see Matrix::MultiplyBatch). Every joint index in
+	// the weights must be within the palette. Outputs must have the vertex count of the weights and
+	// must not alias the inputs. Skinned normals are renormalized.
+	// Runs on AVX2 kernels, 8 vertices per iteration with gathered palette entries, or a portable
+	// fallback.
+
+	namespace Skinning
+	{
+		// Blends the palette matrices by weight, then transforms. Handles scale, but joints bent far
+		// lose volume.
+		void LinearBlend(std::span<const Matrix> palette, const SkinWeights& weights, const Vector3Stream& positions,
+		                 Vector3Stream& skinnedPositions) noexcept;
+		void LinearBlend(std::span<const Matrix> palette, const SkinWeights& weights, const Vector3Stream& positions, const Vector3Stream& normals,
+		                 Vector3Stream& skinnedPositions, Vector3Stream& skinnedNormals) noexcept;
+		void LinearBlend(const Parallel::ParallelPolicy& policy, std::span<const Matrix> palette, const SkinWeights& weights,
+		                 const Vector3Stream& positions, Vector3Stream& skinnedPositions) noexcept;
+		void LinearBlend(const Parallel::ParallelPolicy& policy, std::span<const Matrix> palette, const SkinWeights& weights,
+		                 const Vector3Stream& positions, const Vector3Stream& normals, Vector3Stream& skinnedPositions,
+		                 Vector3Stream& skinnedNormals) noexcept;
+
+		// Blends unit dual quaternions along the shorter arc of each vertex's first influence, then
+		// normalizes and transforms. Rigid only, but preserves volume around joints.
+		void DualQuaternionBlend(std::span<const DualQuaternion> palette, const SkinWeights& weights, const Vector3Stream& positions,
+		                         Vector3Stream& skinnedPositions) noexcept;
+		void DualQuaternionBlend(std::span<const DualQuaternion> palette, const SkinWeights& weights, const Vector3Stream& positions,
+		                         const Vector3Stream& normals, Vector3Stream& skinnedPositions, Vector3Stream& skinnedNormals) noexcept;
+		void DualQuaternionBlend(const Parallel::ParallelPolicy& policy, std::span<const DualQuaternion> palette, const SkinWeights& weights,
+		                         const Vector3Stream& positions, Vector3Stream& skinnedPositions) noexcept;
+		void DualQuaternionBlend(const Parallel::ParallelPolicy& policy, std::span<const DualQuaternion> palette, const SkinWeights& weights,
+		                         const Vector3Stream& positions, const Vector3Stream& normals, Vector3Stream& skinnedPositions,
+		                         Vector3Stream& skinnedNormals) noexcept;
+	}
+}
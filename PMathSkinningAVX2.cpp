@@ -0,0 +1,179 @@
+#include "PMathCpu.h"
+
+#if PMATH_X86
+#include <bit>
+#include <type_traits>
+
+#include "PMathAVX2.h"
+#include "PMathKernels.h"
+
+namespace PMgene::Math::Detail::AVX2
+{
+	namespace
+	{
+		// Joint indices of slot 'k' for the 8 vertices from 'i', scaled to palette offsets. Tail lanes
+		// read joint 0, which is valid in any palette, and their weights read as zero.
+		template <typename Lanes>
+		inline __m256i LoadOffsets(const SkinView& skin, size_t k, size_t i, Lanes lanes, int stride) noexcept
+		{
+			const uint16_t* joints = skin.joints + k * skin.stride + i;
+			__m128i indices;
+			if constexpr (std::is_same_v<Lanes, Lanes8>)
+			{
+				indices = _mm_loadu_si128(reinterpret_cast<const __m128i*>(joints));
+			}
+			else
+			{
+				alignas(16) uint16_t padded[8] = {};
+				const int count = std::popcount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(lanes.mask))));
+				for (int lane = 0; lane < count; ++lane)
+					padded[lane] = joints[lane];
+				indices = _mm_load_si128(reinterpret_cast<const __m128i*>(padded));
+			}
+			return _mm256_mullo_epi32(_mm256_cvtepu16_epi32(indices), _mm256_set1_epi32(stride));
+		}
+
+		inline __m256 Gather(const float* palette, __m256i offsets) noexcept
+		{
+			return _mm256_i32gather_ps(palette, offsets, 4);
+		}
+
+		inline bool AllZero(__m256 weights) noexcept
+		{
+			return _mm256_movemask_ps(_mm256_cmp_ps(weights, _mm256_setzero_ps(), _CMP_NEQ_UQ)) == 0;
+		}
+
+		template <typename Lanes>
+		inline void StoreNormal(StreamView3 normals, size_t i, Lanes lanes, __m256 x, __m256 y, __m256 z) noexcept
+		{
+			const __m256 length = _mm256_sqrt_ps(_mm256_fmadd_ps(z, z, _mm256_fmadd_ps(y, y, _mm256_mul_ps(x, x))));
+			const __m256 nonZero = _mm256_cmp_ps(length, _mm256_setzero_ps(), _CMP_NEQ_OQ);
+			const __m256 invLength = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(1.f), length), nonZero);
+			lanes.Store(normals.x + i, _mm256_mul_ps(x, invLength));
+			lanes.Store(normals.y + i, _mm256_mul_ps(y, invLength));
+			lanes.Store(normals.z + i, _mm256_mul_ps(z, invLength));
+		}
+	}
+
+	void SkinLinearBlend(const float* palette, SkinView skin, ConstStreamView3 positions, ConstStreamView3 normals,
+	                     StreamView3 skinnedPositions, StreamView3 skinnedNormals, size_t count) noexcept
+	{
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			// Rows 0-3 of the blended matrix, columns x, y and z. Slots no vertex uses are skipped,
+			// which saves most of the gathers on meshes with few influences per vertex.
+			__m256 m[12];
+			for (__m256& element : m)
+				element = _mm256_setzero_ps();
+
+			for (size_t k = 0; k < skin.influences; ++k)
+			{
+				const __m256 weight = lanes.Load(skin.weights + k * skin.stride + i);
+				if (AllZero(weight))
+					continue;
+
+				const __m256i offsets = LoadOffsets(skin, k, i, lanes, 16);
+				for (int row = 0; row < 4; ++row)
+				{
+					for (int column = 0; column < 3; ++column)
+						m[row * 3 + column] = _mm256_fmadd_ps(weight, Gather(palette + row * 4 + column, offsets), m[row * 3 + column]);
+				}
+			}
+
+			const __m256 x = lanes.Load(positions.x + i);
+			const __m256 y = lanes.Load(positions.y + i);
+			const __m256 z = lanes.Load(positions.z + i);
+			lanes.Store(skinnedPositions.x + i, _mm256_fmadd_ps(x, m[0], _mm256_fmadd_ps(y, m[3], _mm256_fmadd_ps(z, m[6], m[9]))));
+			lanes.Store(skinnedPositions.y + i, _mm256_fmadd_ps(x, m[1], _mm256_fmadd_ps(y, m[4], _mm256_fmadd_ps(z, m[7], m[10]))));
+			lanes.Store(skinnedPositions.z + i, _mm256_fmadd_ps(x, m[2], _mm256_fmadd_ps(y, m[5], _mm256_fmadd_ps(z, m[8], m[11]))));
+
+			if (normals.x)
+			{
+				const __m256 nx = lanes.Load(normals.x + i);
+				const __m256 ny = lanes.Load(normals.y + i);
+				const __m256 nz = lanes.Load(normals.z + i);
+				StoreNormal(skinnedNormals, i, lanes,
+				            _mm256_fmadd_ps(nx, m[0], _mm256_fmadd_ps(ny, m[3], _mm256_mul_ps(nz, m[6]))),
+				            _mm256_fmadd_ps(nx, m[1], _mm256_fmadd_ps(ny, m[4], _mm256_mul_ps(nz, m[7]))),
+				            _mm256_fmadd_ps(nx, m[2], _mm256_fmadd_ps(ny, m[5], _mm256_mul_ps(nz, m[8]))));
+			}
+		});
+	}
+
+	void SkinDualQuaternionBlend(const float* palette, SkinView skin, ConstStreamView3 positions, ConstStreamView3 normals,
+	                             StreamView3 skinnedPositions, StreamView3 skinnedNormals, size_t count) noexcept
+	{
+		const __m256 signMask = _mm256_set1_ps(-0.f);
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			// The real part of the first influence is the pivot every other one is aligned with
+			const __m256i pivotOffsets = LoadOffsets(skin, 0, i, lanes, 8);
+			const __m256 pivot[4] = { Gather(palette, pivotOffsets), Gather(palette + 1, pivotOffsets), Gather(palette + 2, pivotOffsets),
+			                          Gather(palette + 3, pivotOffsets) };
+
+			// Real part 0-3, dual part 4-7
+			__m256 b[8];
+			for (__m256& element : b)
+				element = _mm256_setzero_ps();
+
+			for (size_t k = 0; k < skin.influences; ++k)
+			{
+				__m256 weight = lanes.Load(skin.weights + k * skin.stride + i);
+				if (AllZero(weight))
+					continue;
+
+				const __m256i offsets = k == 0 ? pivotOffsets : LoadOffsets(skin, k, i, lanes, 8);
+				__m256 D[8];
+				for (int e = 0; e < 8; ++e)
+					D[e] = k == 0 && e < 4 ? pivot[e] : Gather(palette + e, offsets);
+
+				__m256 dot = _mm256_mul_ps(D[0], pivot[0]);
+				dot = _mm256_fmadd_ps(D[1], pivot[1], dot);
+				dot = _mm256_fmadd_ps(D[2], pivot[2], dot);
+				dot = _mm256_fmadd_ps(D[3], pivot[3], dot);
+				weight = _mm256_xor_ps(weight, _mm256_and_ps(dot, signMask));
+
+				for (int e = 0; e < 8; ++e)
+					b[e] = _mm256_fmadd_ps(weight, D[e], b[e]);
+			}
+
+			const __m256 length = _mm256_sqrt_ps(_mm256_fmadd_ps(b[3], b[3], _mm256_fmadd_ps(b[2], b[2], _mm256_fmadd_ps(b[1], b[1], _mm256_mul_ps(b[0], b[0])))));
+			const __m256 nonZero = _mm256_cmp_ps(length, _mm256_setzero_ps(), _CMP_NEQ_OQ);
+			const __m256 invLength = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(1.f), length), nonZero);
+			const __m256 rx = _mm256_mul_ps(b[0], invLength), ry = _mm256_mul_ps(b[1], invLength);
+			const __m256 rz = _mm256_mul_ps(b[2], invLength), rw = _mm256_mul_ps(b[3], invLength);
+			const __m256 dx = _mm256_mul_ps(b[4], invLength), dy = _mm256_mul_ps(b[5], invLength);
+			const __m256 dz = _mm256_mul_ps(b[6], invLength), dw = _mm256_mul_ps(b[7], invLength);
+
+			// Translation t = 2 (rw d - dw r + r x d), vector parts only
+			const __m256 two = _mm256_set1_ps(2.f);
+			const __m256 tx = _mm256_mul_ps(two, _mm256_fmsub_ps(rw, dx, _mm256_fmsub_ps(dw, rx, _mm256_fmsub_ps(ry, dz, _mm256_mul_ps(rz, dy)))));
+			const __m256 ty = _mm256_mul_ps(two, _mm256_fmsub_ps(rw, dy, _mm256_fmsub_ps(dw, ry, _mm256_fmsub_ps(rz, dx, _mm256_mul_ps(rx, dz)))));
+			const __m256 tz = _mm256_mul_ps(two, _mm256_fmsub_ps(rw, dz, _mm256_fmsub_ps(dw, rz, _mm256_fmsub_ps(rx, dy, _mm256_mul_ps(ry, dx)))));
+
+			// Rotation v' = v + 2 r x (r x v + rw v)
+			const auto rotate = [&](__m256 vx, __m256 vy, __m256 vz, __m256& ox, __m256& oy, __m256& oz) {
+				const __m256 cx = _mm256_fmadd_ps(rw, vx, _mm256_fmsub_ps(ry, vz, _mm256_mul_ps(rz, vy)));
+				const __m256 cy = _mm256_fmadd_ps(rw, vy, _mm256_fmsub_ps(rz, vx, _mm256_mul_ps(rx, vz)));
+				const __m256 cz = _mm256_fmadd_ps(rw, vz, _mm256_fmsub_ps(rx, vy, _mm256_mul_ps(ry, vx)));
+				ox = _mm256_fmadd_ps(two, _mm256_fmsub_ps(ry, cz, _mm256_mul_ps(rz, cy)), vx);
+				oy = _mm256_fmadd_ps(two, _mm256_fmsub_ps(rz, cx, _mm256_mul_ps(rx, cz)), vy);
+				oz = _mm256_fmadd_ps(two, _mm256_fmsub_ps(rx, cy, _mm256_mul_ps(ry, cx)), vz);
+			};
+
+			__m256 px, py, pz;
+			rotate(lanes.Load(positions.x + i), lanes.Load(positions.y + i), lanes.Load(positions.z + i), px, py, pz);
+			lanes.Store(skinnedPositions.x + i, _mm256_add_ps(px, tx));
+			lanes.Store(skinnedPositions.y + i, _mm256_add_ps(py, ty));
+			lanes.Store(skinnedPositions.z + i, _mm256_add_ps(pz, tz));
+
+			if (normals.x)
+			{
+				__m256 nx, ny, nz;
+				rotate(lanes.Load(normals.x + i), lanes.Load(normals.y + i), lanes.Load(normals.z + i), nx, ny, nz);
+				StoreNormal(skinnedNormals, i, lanes, nx, ny, nz);
+			}
+		});
+	}
+}
+#endif
@@ -0,0 +1,467 @@
+#include "PMathSpatialHash.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+
+#include "PMathCpu.h"
+#include "PMathKernels.h"
+#include "PMathSpatialHashTraversal.h"
+
+namespace PMgene::Math
+{
+	//****************************************************************************
+	// Generic kernels
+
+	namespace Detail::Generic
+	{
+		size_t SpatialHashRadius(const SpatialHashView& grid, const float* center, float radius, uint32_t* neighbours, size_t capacity) noexcept
+		{
+			const float radiusSq = radius * radius;
+			size_t found = 0;
+			ForEachSpatialHashSpan(grid, center, radius, [&](uint32_t begin, uint32_t end) {
+				for (uint32_t i = begin; i < end; ++i)
+				{
+					const float dx = grid.x[i] - center[0];
+					const float dy = grid.y[i] - center[1];
+					const float dz = grid.z[i] - center[2];
+					if (dx * dx + dy * dy + dz * dz > radiusSq)
+						continue;
+					if (found < capacity)
+						neighbours[found] = grid.indices[i];
+					++found;
+				}
+			});
+			return found;
+		}
+
+		size_t SpatialHashNearest(const SpatialHashView& grid, const float* center, float radius, uint32_t* neighbours, float* distances, size_t k) noexcept
+		{
+			if (k == 0)
+				return 0;
+
+			NearestList nearest(neighbours, distances, k, radius);
+			ForEachSpatialHashSpan(grid, center, radius, [&](uint32_t begin, uint32_t end) {
+				for (uint32_t i = begin; i < end; ++i)
+				{
+					const float dx = grid.x[i] - center[0];
+					const float dy = grid.y[i] - center[1];
+					const float dz = grid.z[i] - center[2];
+					nearest.Insert(dx * dx + dy * dy + dz * dz, grid.indices[i]);
+				}
+			});
+			return nearest.count;
+		}
+	}
+
+	namespace
+	{
+		// Points per build chunk, and the bucket bits the first sorting pass groups by
+		constexpr size_t BuildGrain = 8192;
+		constexpr uint32_t GroupBits = 8;
+
+		// Queries per parallel chunk
+		constexpr size_t QueryGrain = 64;
+
+		struct Bounds
+		{
+			float min[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+			float max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		};
+
+		// Runs kernel(i) for i in [0, count), as parallel tasks when asked to
+		template <typename Kernel>
+		void ForEachTask(bool parallel, size_t count, const Kernel& kernel)
+		{
+			if (!parallel)
+			{
+				for (size_t i = 0; i < count; ++i)
+					kernel(i);
+				return;
+			}
+
+			Parallel::ParallelFor(count, 1, [&](Parallel::Range range) {
+				for (size_t i = range.begin; i < range.end; ++i)
+					kernel(i);
+			});
+		}
+
+		size_t RadiusKernel(const Detail::SpatialHashView& grid, const Vector3& center, float radius, uint32_t* neighbours, size_t capacity) noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+				return Detail::AVX2::SpatialHashRadius(grid, &center.x, radius, neighbours, capacity);
+#endif
+			return Detail::Generic::SpatialHashRadius(grid, &center.x, radius, neighbours, capacity);
+		}
+
+		size_t NearestKernel(const Detail::SpatialHashView& grid, const Vector3& center, float radius, uint32_t* neighbours, size_t k) noexcept
+		{
+			// The scratch holds MaxNearest distances; entries past it stay InvalidIndex
+			const size_t searched = std::min(k, SpatialHashGrid::MaxNearest);
+			float distances[SpatialHashGrid::MaxNearest];
+			size_t found;
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+				found = Detail::AVX2::SpatialHashNearest(grid, &center.x, radius, neighbours, distances, searched);
+			else
+#endif
+				found = Detail::Generic::SpatialHashNearest(grid, &center.x, radius, neighbours, distances, searched);
+
+			std::fill(neighbours + found, neighbours + k, SpatialHashGrid::InvalidIndex);
+			return found;
+		}
+
+		size_t Grain(const Parallel::ParallelPolicy& policy) noexcept
+		{
+			return policy.grain != 0 ? policy.grain : QueryGrain;
+		}
+	}
+
+
+	//****************************************************************************
+	// Construction
+
+	SpatialHashGrid::SpatialHashGrid(float cellSize) noexcept
+	{
+		SetCellSize(cellSize);
+	}
+
+	void SpatialHashGrid::SetCellSize(float cellSize) noexcept
+	{
+		assert(cellSize > 0.f);
+		m_cellSize = cellSize;
+	}
+
+	void SpatialHashGrid::Build(std::span<const Vector3> positions)
+	{
+		BuildGrid(false, positions);
+	}
+
+	void SpatialHashGrid::Build(const Parallel::ParallelPolicy&, std::span<const Vector3> positions)
+	{
+		BuildGrid(true, positions);
+	}
+
+	void SpatialHashGrid::BuildGrid(bool parallel, std::span<const Vector3> positions)
+	{
+		assert(positions.size() < InvalidIndex);
+		const size_t count = positions.size();
+		if (count == 0)
+		{
+			Clear();
+			return;
+		}
+
+		const float inverseCellSize = 1.f / m_cellSize;
+		const size_t chunkCount = (count + BuildGrain - 1) / BuildGrain;
+		const auto chunkEnd = [&](size_t c) { return std::min((c + 1) * BuildGrain, count); };
+
+		// Bounds, to share the table between the axes by how many cells they span
+		std::vector<Bounds> partial(chunkCount);
+		ForEachTask(parallel, chunkCount, [&](size_t c) {
+			Bounds& bounds = partial[c];
+			for (size_t i = c * BuildGrain; i < chunkEnd(c); ++i)
+			{
+				const float* p = &positions[i].x;
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					bounds.min[axis] = std::min(bounds.min[axis], p[axis]);
+					bounds.max[axis] = std::max(bounds.max[axis], p[axis]);
+				}
+			}
+		});
+
+		Bounds bounds;
+		for (const Bounds& p : partial)
+		{
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				bounds.min[axis] = std::min(bounds.min[axis], p.min[axis]);
+				bounds.max[axis] = std::max(bounds.max[axis], p.max[axis]);
+			}
+		}
+
+		// About one bucket per point. Axes get a power of two at least as large as the cells they
+		// span, the widest giving up bits until the table fits.
+		const uint32_t tableBits = static_cast<uint32_t>(std::bit_width(std::bit_ceil(count)) - 1);
+		uint32_t bits[3];
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			const int64_t cells = int64_t(Detail::SpatialHashCell(bounds.max[axis], inverseCellSize)) -
+			                      Detail::SpatialHashCell(bounds.min[axis], inverseCellSize) + 1;
+			bits[axis] = static_cast<uint32_t>(std::bit_width(std::bit_ceil(static_cast<uint32_t>(std::min<int64_t>(cells, 1u << 31)))) - 1);
+		}
+		while (bits[0] + bits[1] + bits[2] > tableBits)
+			--bits[std::max_element(bits, bits + 3) - bits];
+
+		for (int axis = 0; axis < 3; ++axis)
+			m_mask[axis] = (1u << bits[axis]) - 1;
+		m_shift[0] = 0;
+		m_shift[1] = bits[0];
+		m_shift[2] = bits[0] + bits[1];
+
+		const uint32_t totalBits = bits[0] + bits[1] + bits[2];
+		const size_t bucketCount = size_t(1) << totalBits;
+		const uint32_t groupShift = totalBits > GroupBits ? totalBits - GroupBits : 0;
+		const size_t groupCount = bucketCount >> groupShift;
+		const size_t bucketsPerGroup = size_t(1) << groupShift;
+
+		m_buckets.resize(count);
+		m_grouped.resize(count);
+		m_groupOffsets.assign(chunkCount * groupCount, 0);
+		m_cellStart.resize(bucketCount + 1);
+		m_x.resize(count);
+		m_y.resize(count);
+		m_z.resize(count);
+		m_indices.resize(count);
+
+		// Counting sort in two passes, so no pass needs a histogram of every bucket per chunk.
+		// First the bucket of every point and, per chunk, how many fall in each group.
+		const Detail::SpatialHashView grid = View();
+		ForEachTask(parallel, chunkCount, [&](size_t c) {
+			uint32_t* histogram = m_groupOffsets.data() + c * groupCount;
+			for (size_t i = c * BuildGrain; i < chunkEnd(c); ++i)
+			{
+				const Vector3& P = positions[i];
+				const uint32_t bucket = Detail::SpatialHashBucket(grid, Detail::SpatialHashCell(P.x, inverseCellSize),
+				                                                  Detail::SpatialHashCell(P.y, inverseCellSize),
+				                                                  Detail::SpatialHashCell(P.z, inverseCellSize));
+				m_buckets[i] = bucket;
+				++histogram[bucket >> groupShift];
+			}
+		});
+
+		// Group-major offsets keep every chunk's points in order within a group
+		uint32_t offset = 0;
+		for (size_t g = 0; g < groupCount; ++g)
+		{
+			for (size_t c = 0; c < chunkCount; ++c)
+			{
+				uint32_t& slot = m_groupOffsets[c * groupCount + g];
+				const uint32_t n = slot;
+				slot = offset;
+				offset += n;
+			}
+		}
+
+		ForEachTask(parallel, chunkCount, [&](size_t c) {
+			uint32_t* cursor = m_groupOffsets.data() + c * groupCount;
+			for (size_t i = c * BuildGrain; i < chunkEnd(c); ++i)
+				m_grouped[cursor[m_buckets[i] >> groupShift]++] = static_cast<uint32_t>(i);
+		});
+
+		// Then every group on its own: count its buckets, turn the counts into ends, and place its
+		// points walking backwards, which leaves each bucket's start behind and keeps the order
+		const uint32_t* groupEnd = m_groupOffsets.data() + (chunkCount - 1) * groupCount;
+		ForEachTask(parallel, groupCount, [&](size_t g) {
+			const uint32_t begin = g == 0 ? 0 : groupEnd[g - 1];
+			const uint32_t end = groupEnd[g];
+			uint32_t* start = m_cellStart.data() + g * bucketsPerGroup;
+			const uint32_t firstBucket = static_cast<uint32_t>(g * bucketsPerGroup);
+
+			std::fill(start, start + bucketsPerGroup, 0u);
+			for (uint32_t p = begin; p < end; ++p)
+				++start[m_buckets[m_grouped[p]] - firstBucket];
+
+			uint32_t sum = begin;
+			for (size_t b = 0; b < bucketsPerGroup; ++b)
+			{
+				sum += start[b];
+				start[b] = sum;
+			}
+
+			for (uint32_t p = end; p-- > begin;)
+			{
+				const uint32_t i = m_grouped[p];
+				const uint32_t slot = --start[m_buckets[i] - firstBucket];
+				m_x[slot] = positions[i].x;
+				m_y[slot] = positions[i].y;
+				m_z[slot] = positions[i].z;
+				m_indices[slot] = i;
+			}
+		});
+		m_cellStart[bucketCount] = static_cast<uint32_t>(count);
+	}
+
+	void SpatialHashGrid::Clear() noexcept
+	{
+		m_cellStart.clear();
+		m_x.clear();
+		m_y.clear();
+		m_z.clear();
+		m_indices.clear();
+	}
+
+	Detail::SpatialHashView SpatialHashGrid::View() const noexcept
+	{
+		return { m_x.data(), m_y.data(), m_z.data(), m_indices.data(), m_cellStart.data(), 1.f / m_cellSize,
+		         { m_mask[0], m_mask[1], m_mask[2] }, { m_shift[0], m_shift[1], m_shift[2] } };
+	}
+
+
+	//****************************************************************************
+	// Queries
+
+	size_t SpatialHashGrid::QueryRadius(const Vector3& center, float radius, std::vector<uint32_t>& result) const
+	{
+		if (Empty())
+			return 0;
+
+		// Try with room for a typical query first and search again only if it was too small
+		constexpr size_t Guess = 64;
+		const size_t start = result.size();
+		result.resize(start + Guess);
+		const size_t found = RadiusKernel(View(), center, radius, result.data() + start, Guess);
+		if (found > Guess)
+		{
+			result.resize(start + found);
+			RadiusKernel(View(), center, radius, result.data() + start, found);
+		}
+		result.resize(start + found);
+		return found;
+	}
+
+	void SpatialHashGrid::QueryRadius(std::span<const Vector3> centers, float radius, std::vector<uint32_t>& offsets, std::vector<uint32_t>& neighbours) const
+	{
+		offsets.resize(centers.size() + 1);
+		offsets[0] = 0;
+		neighbours.clear();
+		for (size_t i = 0; i < centers.size(); ++i)
+		{
+			QueryRadius(centers[i], radius, neighbours);
+			offsets[i + 1] = static_cast<uint32_t>(neighbours.size());
+		}
+	}
+
+	void SpatialHashGrid::QueryRadius(const Parallel::ParallelPolicy& policy, std::span<const Vector3> centers, float radius,
+	                                  std::vector<uint32_t>& offsets, std::vector<uint32_t>& neighbours) const
+	{
+		offsets.assign(centers.size() + 1, 0);
+		neighbours.clear();
+		if (Empty())
+			return;
+
+		// Count, turn the counts into offsets, then search again to fill every query's range
+		const Detail::SpatialHashView grid = View();
+		Parallel::ParallelFor(centers.size(), Grain(policy), [&](Parallel::Range range) {
+			for (size_t i = range.begin; i < range.end; ++i)
+				offsets[i + 1] = static_cast<uint32_t>(RadiusKernel(grid, centers[i], radius, nullptr, 0));
+		});
+
+		for (size_t i = 0; i < centers.size(); ++i)
+			offsets[i + 1] += offsets[i];
+		neighbours.resize(offsets.back());
+
+		Parallel::ParallelFor(centers.size(), Grain(policy), [&](Parallel::Range range) {
+			for (size_t i = range.begin; i < range.end; ++i)
+				RadiusKernel(grid, centers[i], radius, neighbours.data() + offsets[i], offsets[i + 1] - offsets[i]);
+		});
+	}
+
+	size_t SpatialHashGrid::QueryNearest(const Vector3& center, float radius, std::span<uint32_t> neighbours) const noexcept
+	{
+		if (Empty())
+		{
+			std::fill(neighbours.begin(), neighbours.end(), InvalidIndex);
+			return 0;
+		}
+		return NearestKernel(View(), center, radius, neighbours.data(), neighbours.size());
+	}
+
+	void SpatialHashGrid::QueryNearest(std::span<const Vector3> centers, float radius, size_t k, std::span<uint32_t> neighbours) const noexcept
+	{
+		assert(neighbours.size() == centers.size() * k);
+		if (Empty())
+		{
+			std::fill(neighbours.begin(), neighbours.end(), InvalidIndex);
+			return;
+		}
+
+		const Detail::SpatialHashView grid = View();
+		for (size_t i = 0; i < centers.size(); ++i)
+			NearestKernel(grid, centers[i], radius, neighbours.data() + i * k, k);
+	}
+
+	void SpatialHashGrid::QueryNearest(const Parallel::ParallelPolicy& policy, std::span<const Vector3> centers, float radius, size_t k,
+	                                   std::span<uint32_t> neighbours) const noexcept
+	{
+		assert(neighbours.size() == centers.size() * k);
+		if (Empty())
+			return QueryNearest(centers, radius, k, neighbours);
+
+		const Detail::SpatialHashView grid = View();
+		Parallel::ParallelFor(centers.size(), Grain(policy), [&](Parallel::Range range) {
+			for (size_t i = range.begin; i < range.end; ++i)
+				NearestKernel(grid, centers[i], radius, neighbours.data() + i * k, k);
+		});
+	}
+
+	void SpatialHashGrid::QueryRadius(float radius, std::vector<uint32_t>& offsets, std::vector<uint32_t>& neighbours) const
+	{
+		offsets.assign(Size() + 1, 0);
+		neighbours.clear();
+		if (Empty())
+			return;
+
+		const Detail::SpatialHashView grid = View();
+		for (size_t slot = 0; slot < Size(); ++slot)
+			offsets[m_indices[slot] + 1] = static_cast<uint32_t>(RadiusKernel(grid, Point(slot), radius, nullptr, 0));
+
+		for (size_t i = 0; i < Size(); ++i)
+			offsets[i + 1] += offsets[i];
+		neighbours.resize(offsets.back());
+
+		for (size_t slot = 0; slot < Size(); ++slot)
+		{
+			const uint32_t i = m_indices[slot];
+			RadiusKernel(grid, Point(slot), radius, neighbours.data() + offsets[i], offsets[i + 1] - offsets[i]);
+		}
+	}
+
+	void SpatialHashGrid::QueryRadius(const Parallel::ParallelPolicy& policy, float radius, std::vector<uint32_t>& offsets, std::vector<uint32_t>& neighbours) const
+	{
+		offsets.assign(Size() + 1, 0);
+		neighbours.clear();
+		if (Empty())
+			return;
+
+		const Detail::SpatialHashView grid = View();
+		Parallel::ParallelFor(Size(), Grain(policy), [&](Parallel::Range range) {
+			for (size_t slot = range.begin; slot < range.end; ++slot)
+				offsets[m_indices[slot] + 1] = static_cast<uint32_t>(RadiusKernel(grid, Point(slot), radius, nullptr, 0));
+		});
+
+		for (size_t i = 0; i < Size(); ++i)
+			offsets[i + 1] += offsets[i];
+		neighbours.resize(offsets.back());
+
+		Parallel::ParallelFor(Size(), Grain(policy), [&](Parallel::Range range) {
+			for (size_t slot = range.begin; slot < range.end; ++slot)
+			{
+				const uint32_t i = m_indices[slot];
+				RadiusKernel(grid, Point(slot), radius, neighbours.data() + offsets[i], offsets[i + 1] - offsets[i]);
+			}
+		});
+	}
+
+	void SpatialHashGrid::QueryNearest(float radius, size_t k, std::span<uint32_t> neighbours) const noexcept
+	{
+		assert(neighbours.size() == Size() * k);
+		const Detail::SpatialHashView grid = View();
+		for (size_t slot = 0; slot < Size(); ++slot)
+			NearestKernel(grid, Point(slot), radius, neighbours.data() + size_t(m_indices[slot]) * k, k);
+	}
+
+	void SpatialHashGrid::QueryNearest(const Parallel::ParallelPolicy& policy, float radius, size_t k, std::span<uint32_t> neighbours) const noexcept
+	{
+		assert(neighbours.size() == Size() * k);
+		const Detail::SpatialHashView grid = View();
+		Parallel::ParallelFor(Size(), Grain(policy), [&](Parallel::Range range) {
+			for (size_t slot = range.begin; slot < range.end; ++slot)
+				NearestKernel(grid, Point(slot), radius, neighbours.data() + size_t(m_indices[slot]) * k, k);
+		});
+	}
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "PMath.h"
+#include "PMathKernels.h"
+#include "PMathParallel.h"
+
+namespace PMgene::Math
+{
+	//****************************************************************************
+	// Spatial hash grid
+	// Uniform grid over points for radius and k-nearest queries, cheap enough to rebuild every
+	// frame. Cells are cellSize wide and map to buckets by wrapping their coordinates, x fastest,
+	// so a row of neighbouring cells is one run of points; far apart cells that wrap onto the same
+	// bucket only add candidates the distance test rejects. Build sizes the table to about one
+	// bucket per point and counting-sorts the points into bucket order, keeping the positions SoA
+	// for the SIMD distance tests. Queries are cheapest with a cell size near the query radius.
+
+	class SpatialHashGrid
+	{
+	public:
+		static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+		// Largest k of the nearest-neighbour queries. A larger k still gets k entries per center, but
+		// only the first MaxNearest are searched and the rest are InvalidIndex.
+		static constexpr size_t MaxNearest = 64;
+
+		explicit SpatialHashGrid(float cellSize = 1.f) noexcept;
+
+		[[nodiscard]] float CellSize() const noexcept { return m_cellSize; }
+		// Takes effect at the next Build
+		void SetCellSize(float cellSize) noexcept;
+
+		// The parallel version splits every pass over the points and the buckets; both sort the
+		// same way, so queries return the same results in the same order.
+		void Build(std::span<const Vector3> positions);
+		void Build(const Parallel::ParallelPolicy& policy, std::span<const Vector3> positions);
+
+		void Clear() noexcept;
+
+		[[nodiscard]] bool Empty() const noexcept { return m_indices.empty(); }
+		[[nodiscard]] size_t Size() const noexcept { return m_indices.size(); }
+		[[nodiscard]] size_t BucketCount() const noexcept { return m_cellStart.empty() ? 0 : m_cellStart.size() - 1; }
+
+		// Appends the points within radius of center, boundary included, in no particular order,
+		// and returns their number. Indices are the positions in the span given to Build; a query
+		// centred on a point finds the point itself.
+		size_t QueryRadius(const Vector3& center, float radius, std::vector<uint32_t>& result) const;
+
+		// Batch radius query: the neighbours of center i are neighbours[offsets[i], offsets[i + 1])
+		void QueryRadius(std::span<const Vector3> centers, float radius, std::vector<uint32_t>& offsets, std::vector<uint32_t>& neighbours) const;
+		void QueryRadius(const Parallel::ParallelPolicy& policy, std::span<const Vector3> centers, float radius, std::vector<uint32_t>& offsets,
+		                 std::vector<uint32_t>& neighbours) const;
+
+		// The neighbours.size() nearest points within radius, closest first and ties by index.
+		// Returns how many were found and fills the rest with InvalidIndex.
+		size_t QueryNearest(const Vector3& center, float radius, std::span<uint32_t> neighbours) const noexcept;
+
+		// Batch nearest query, k entries per center in neighbours
+		void QueryNearest(std::span<const Vector3> centers, float radius, size_t k, std::span<uint32_t> neighbours) const noexcept;
+		void QueryNearest(const Parallel::ParallelPolicy& policy, std::span<const Vector3> centers, float radius, size_t k,
+		                  std::span<uint32_t> neighbours) const noexcept;
+
+		// Every stored point's own neighbours, as if the positions given to Build were passed as
+		// the centers, but visiting the points in bucket order so that consecutive queries share
+		// cells. Each point finds itself, so ask for k + 1 to get k others.
+		void QueryRadius(float radius, std::vector<uint32_t>& offsets, std::vector<uint32_t>& neighbours) const;
+		void QueryRadius(const Parallel::ParallelPolicy& policy, float radius, std::vector<uint32_t>& offsets, std::vector<uint32_t>& neighbours) const;
+		void QueryNearest(float radius, size_t k, std::span<uint32_t> neighbours) const noexcept;
+		void QueryNearest(const Parallel::ParallelPolicy& policy, float radius, size_t k, std::span<uint32_t> neighbours) const noexcept;
+
+	private:
+		void BuildGrid(bool parallel, std::span<const Vector3> positions);
+		[[nodiscard]] Detail::SpatialHashView View() const noexcept;
+		[[nodiscard]] Vector3 Point(size_t slot) const noexcept { return Vector3(m_x[slot], m_y[slot], m_z[slot]); }
+
+		float m_cellSize;
+		uint32_t m_mask[3] = {};
+		uint32_t m_shift[3] = {};
+
+		// Per bucket, plus the end
+		std::vector<uint32_t> m_cellStart;
+
+		// Per point in bucket order
+		std::vector<float> m_x;
+		std::vector<float> m_y;
+		std::vector<float> m_z;
+		std::vector<uint32_t> m_indices;
+
+		// Build scratch, kept so steady rebuilds do not allocate
+		std::vector<uint32_t> m_buckets;
+		std::vector<uint32_t> m_grouped;
+		std::vector<uint32_t> m_groupOffsets;
+	};
+}
@@ -0,0 +1,78 @@
+#include "PMathCpu.h"
+
+#if PMATH_X86
+#include <bit>
+#include <cstdint>
+
+#include "PMathAVX2.h"
+#include "PMathKernels.h"
+#include "PMathSpatialHashTraversal.h"
+
+namespace PMgene::Math::Detail::AVX2
+{
+	namespace
+	{
+		// Calls found(i) for the points of [begin, end) within sqrt(bound()) of the center, testing 8
+		// at a time. The bound is read once per 8 points, so it may shrink as points are found.
+		template <typename Bound, typename Found>
+		void TestSpan(const SpatialHashView& grid, const __m256* center, uint32_t begin, uint32_t end, const Bound& bound, Found&& found) noexcept
+		{
+			ForEach8(end - begin, [&](size_t offset, auto lanes)
+			{
+				const size_t i = begin + offset;
+				const __m256 dx = _mm256_sub_ps(lanes.Load(grid.x + i), center[0]);
+				const __m256 dy = _mm256_sub_ps(lanes.Load(grid.y + i), center[1]);
+				const __m256 dz = _mm256_sub_ps(lanes.Load(grid.z + i), center[2]);
+				const __m256 distance = _mm256_fmadd_ps(dx, dx, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dz, dz)));
+
+				__m256 inside = _mm256_cmp_ps(distance, _mm256_set1_ps(bound()), _CMP_LE_OQ);
+				// Past the end the points read as the origin
+				if constexpr (requires { lanes.mask; })
+					inside = _mm256_and_ps(inside, _mm256_castsi256_ps(lanes.mask));
+
+				uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(inside));
+				if (mask == 0)
+					return;
+
+				alignas(32) float distances[8];
+				_mm256_store_ps(distances, distance);
+				for (; mask != 0; mask &= mask - 1)
+				{
+					const int lane = std::countr_zero(mask);
+					found(i + lane, distances[lane]);
+				}
+			});
+		}
+	}
+
+	size_t SpatialHashRadius(const SpatialHashView& grid, const float* center, float radius, uint32_t* neighbours, size_t capacity) noexcept
+	{
+		const __m256 c[3] = { _mm256_set1_ps(center[0]), _mm256_set1_ps(center[1]), _mm256_set1_ps(center[2]) };
+		const float radiusSq = radius * radius;
+		size_t found = 0;
+		ForEachSpatialHashSpan(grid, center, radius, [&](uint32_t begin, uint32_t end) {
+			TestSpan(grid, c, begin, end, [&] { return radiusSq; }, [&](size_t i, float) {
+				if (found < capacity)
+					neighbours[found] = grid.indices[i];
+				++found;
+			});
+		});
+		return found;
+	}
+
+	size_t SpatialHashNearest(const SpatialHashView& grid, const float* center, float radius, uint32_t* neighbours, float* distances, size_t k) noexcept
+	{
+		if (k == 0)
+			return 0;
+
+		const __m256 c[3] = { _mm256_set1_ps(center[0]), _mm256_set1_ps(center[1]), _mm256_set1_ps(center[2]) };
+		NearestList nearest(neighbours, distances, k, radius);
+		ForEachSpatialHashSpan(grid, center, radius, [&](uint32_t begin, uint32_t end) {
+			TestSpan(grid, c, begin, end, [&] { return nearest.bound; }, [&](size_t i, float distance) {
+				nearest.Insert(distance, grid.indices[i]);
+			});
+		});
+		return nearest.count;
+	}
+}
+#endif
@@ -0,0 +1,115 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "PMathKernels.h"
+
+// Spatial hash grid queries shared by the kernel translation units. Like PMathBVHTraversal.h,
+// the loops are templates over the span test so each instruction set compiles its own copy,
+// and everything has internal linkage.
+
+namespace PMgene::Math::Detail
+{
+	namespace
+	{
+		// Cell coordinates stay far from the int32 limits, so spans over them cannot overflow
+		constexpr float MaxCell = 1 << 30;
+
+		// Rounds down without std::floor, which is a library call below SSE4.1
+		inline int32_t SpatialHashCell(float coordinate, float inverseCellSize) noexcept
+		{
+			const float cell = std::clamp(coordinate * inverseCellSize, -MaxCell, MaxCell);
+			const int32_t truncated = static_cast<int32_t>(cell);
+			return truncated - (cell < static_cast<float>(truncated));
+		}
+
+		inline uint32_t SpatialHashBucket(const SpatialHashView& grid, int32_t x, int32_t y, int32_t z) noexcept
+		{
+			return (static_cast<uint32_t>(x) & grid.mask[0]) |
+			       (static_cast<uint32_t>(y) & grid.mask[1]) << grid.shift[1] |
+			       (static_cast<uint32_t>(z) & grid.mask[2]) << grid.shift[2];
+		}
+
+		// Calls visit(begin, end) for the runs of points in the cells the sphere overlaps. Cells in
+		// a row along x have consecutive buckets, so a row is one run unless it wraps. Spans wider
+		// than the table along an axis visit every bucket of that axis once.
+		template <typename Visit>
+		void ForEachSpatialHashSpan(const SpatialHashView& grid, const float* center, float radius, Visit&& visit) noexcept
+		{
+			int32_t first[3];
+			uint32_t count[3];
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				first[axis] = SpatialHashCell(center[axis] - radius, grid.inverseCellSize);
+				const int64_t cells = int64_t(SpatialHashCell(center[axis] + radius, grid.inverseCellSize)) - first[axis] + 1;
+				count[axis] = static_cast<uint32_t>(std::min<int64_t>(cells, int64_t(grid.mask[axis]) + 1));
+			}
+
+			const uint32_t x0 = static_cast<uint32_t>(first[0]) & grid.mask[0];
+			const uint32_t x1 = x0 + count[0];
+			const uint32_t width = grid.mask[0] + 1;
+			for (uint32_t z = 0; z < count[2]; ++z)
+			{
+				for (uint32_t y = 0; y < count[1]; ++y)
+				{
+					const uint32_t row = SpatialHashBucket(grid, 0, first[1] + int32_t(y), first[2] + int32_t(z));
+					if (x1 <= width)
+					{
+						visit(grid.cellStart[row + x0], grid.cellStart[row + x1]);
+					}
+					else
+					{
+						visit(grid.cellStart[row + x0], grid.cellStart[row + width]);
+						visit(grid.cellStart[row], grid.cellStart[row + x1 - width]);
+					}
+				}
+			}
+		}
+
+		// The k closest candidates so far, sorted by distance then index
+		struct NearestList
+		{
+			uint32_t* indices;
+			float* distances;
+			size_t k;
+			size_t count = 0;
+			// Candidates farther than this cannot enter the list
+			float bound;
+
+			NearestList(uint32_t* neighbours, float* distanceStorage, size_t capacity, float radius) noexcept
+				: indices(neighbours), distances(distanceStorage), k(capacity), bound(radius * radius)
+			{
+			}
+
+			void Insert(float distance, uint32_t index) noexcept
+			{
+				if (!(distance <= bound))
+					return;
+
+				size_t i = count;
+				if (count == k)
+				{
+					if (distance == distances[k - 1] && index > indices[k - 1])
+						return;
+					i = k - 1;
+				}
+				else
+				{
+					++count;
+				}
+
+				for (; i > 0 && (distances[i - 1] > distance || (distances[i - 1] == distance && indices[i - 1] > index)); --i)
+				{
+					distances[i] = distances[i - 1];
+					indices[i] = indices[i - 1];
+				}
+				distances[i] = distance;
+				indices[i] = index;
+
+				if (count == k)
+					bound = distances[k - 1];
+			}
+		};
+	}
+}
@@ -0,0 +1,427 @@
+#include "PMathStream.h"
+
+#include <cassert>
+#include <cmath>
+
+#include "PMathCpu.h"
+#include "PMathKernels.h"
+
+namespace PMgene::Math
+{
+	//****************************************************************************
+	// Portable kernels, written so the compiler can auto-vectorize them for the baseline ISA
+
+	namespace Detail::Generic
+	{
+		void Vector3Add(ConstStreamView3 a, ConstStreamView3 b, StreamView3 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				result.x[i] = a.x[i] + b.x[i];
+				result.y[i] = a.y[i] + b.y[i];
+				result.z[i] = a.z[i] + b.z[i];
+			}
+		}
+
+		void Vector3Subtract(ConstStreamView3 a, ConstStreamView3 b, StreamView3 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				result.x[i] = a.x[i] - b.x[i];
+				result.y[i] = a.y[i] - b.y[i];
+				result.z[i] = a.z[i] - b.z[i];
+			}
+		}
+
+		void Vector3Multiply(ConstStreamView3 a, ConstStreamView3 b, StreamView3 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				result.x[i] = a.x[i] * b.x[i];
+				result.y[i] = a.y[i] * b.y[i];
+				result.z[i] = a.z[i] * b.z[i];
+			}
+		}
+
+		void Vector3Scale(ConstStreamView3 a, float s, StreamView3 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				result.x[i] = a.x[i] * s;
+				result.y[i] = a.y[i] * s;
+				result.z[i] = a.z[i] * s;
+			}
+		}
+
+		void Vector3Lerp(ConstStreamView3 a, ConstStreamView3 b, const float* t, size_t tStride, StreamView3 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float ti = t[i * tStride];
+				result.x[i] = a.x[i] + ti * (b.x[i] - a.x[i]);
+				result.y[i] = a.y[i] + ti * (b.y[i] - a.y[i]);
+				result.z[i] = a.z[i] + ti * (b.z[i] - a.z[i]);
+			}
+		}
+
+		void Vector3Dot(ConstStreamView3 a, ConstStreamView3 b, float* result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				result[i] = a.x[i] * b.x[i] + a.y[i] * b.y[i] + a.z[i] * b.z[i];
+			}
+		}
+
+		void Vector3Cross(ConstStreamView3 a, ConstStreamView3 b, StreamView3 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float ax = a.x[i], ay = a.y[i], az = a.z[i];
+				const float bx = b.x[i], by = b.y[i], bz = b.z[i];
+				result.x[i] = ay * bz - az * by;
+				result.y[i] = az * bx - ax * bz;
+				result.z[i] = ax * by - ay * bx;
+			}
+		}
+
+		void Vector3Length(ConstStreamView3 a, float* result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				result[i] = std::sqrt(a.x[i] * a.x[i] + a.y[i] * a.y[i] + a.z[i] * a.z[i]);
+			}
+		}
+
+		void Vector3Normalize(ConstStreamView3 a, StreamView3 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float x = a.x[i], y = a.y[i], z = a.z[i];
+				const float length = std::sqrt(x * x + y * y + z * z);
+				const float invLength = length != 0.f ? 1.f / length : 0.f;
+				result.x[i] = x * invLength;
+				result.y[i] = y * invLength;
+				result.z[i] = z * invLength;
+			}
+		}
+
+		void Vector3LoadAoS(const float* source, StreamView3 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				result.x[i] = source[i * 3];
+				result.y[i] = source[i * 3 + 1];
+				result.z[i] = source[i * 3 + 2];
+			}
+		}
+
+		void Vector3StoreAoS(ConstStreamView3 a, float* destination, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				destination[i * 3] = a.x[i];
+				destination[i * 3 + 1] = a.y[i];
+				destination[i * 3 + 2] = a.z[i];
+			}
+		}
+	}
+
+	//****************************************************************************
+	// Vector3Stream
+
+	namespace
+	{
+		static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 must be tightly packed for AoS conversion");
+
+		Detail::StreamView3 View(Vector3Stream& S) noexcept
+		{
+			return { S.x.data(), S.y.data(), S.z.data() };
+		}
+
+		Detail::ConstStreamView3 View(const Vector3Stream& S) noexcept
+		{
+			return { S.x.data(), S.y.data(), S.z.data() };
+		}
+
+		template <typename View>
+		View Offset(View V, size_t offset) noexcept
+		{
+			return { V.x + offset, V.y + offset, V.z + offset };
+		}
+
+		// Elements per parallel chunk, a multiple of every SIMD width
+		constexpr size_t ParallelGrain = 16384;
+
+		void LerpKernel(Detail::ConstStreamView3 a, Detail::ConstStreamView3 b, const float* t, size_t tStride, Detail::StreamView3 result,
+		                size_t count) noexcept
+		{
+			switch (GetSimdLevel())
+			{
+#if PMATH_X86
+			case SimdLevel::AVX512:
+				Detail::AVX512::Vector3Lerp(a, b, t, tStride, result, count);
+				break;
+			case SimdLevel::AVX2:
+				Detail::AVX2::Vector3Lerp(a, b, t, tStride, result, count);
+				break;
+#endif
+			default:
+				Detail::Generic::Vector3Lerp(a, b, t, tStride, result, count);
+				break;
+			}
+		}
+
+		void NormalizeKernel(Detail::ConstStreamView3 a, Detail::StreamView3 result, size_t count) noexcept
+		{
+			switch (GetSimdLevel())
+			{
+#if PMATH_X86
+			case SimdLevel::AVX512:
+				Detail::AVX512::Vector3Normalize(a, result, count);
+				break;
+			case SimdLevel::AVX2:
+				Detail::AVX2::Vector3Normalize(a, result, count);
+				break;
+#endif
+			default:
+				Detail::Generic::Vector3Normalize(a, result, count);
+				break;
+			}
+		}
+	}
+
+	void Vector3Stream::Resize(size_t count)
+	{
+		x.resize(count);
+		y.resize(count);
+		z.resize(count);
+	}
+
+	void Vector3Stream::Clear() noexcept
+	{
+		x.clear();
+		y.clear();
+		z.clear();
+	}
+
+	void Vector3Stream::Load(std::span<const Vector3> V)
+	{
+		Resize(V.size());
+
+		const float* source = reinterpret_cast<const float*>(V.data());
+		switch (GetSimdLevel())
+		{
+#if PMATH_X86
+		case SimdLevel::AVX512:
+			Detail::AVX512::Vector3LoadAoS(source, View(*this), V.size());
+			break;
+		case SimdLevel::AVX2:
+			Detail::AVX2::Vector3LoadAoS(source, View(*this), V.size());
+			break;
+#endif
+		default:
+			Detail::Generic::Vector3LoadAoS(source, View(*this), V.size());
+			break;
+		}
+	}
+
+	void Vector3Stream::Store(std::span<Vector3> V) const noexcept
+	{
+		assert(V.size() == Size());
+
+		float* destination = reinterpret_cast<float*>(V.data());
+		switch (GetSimdLevel())
+		{
+#if PMATH_X86
+		case SimdLevel::AVX512:
+			Detail::AVX512::Vector3StoreAoS(View(*this), destination, Size());
+			break;
+		case SimdLevel::AVX2:
+			Detail::AVX2::Vector3StoreAoS(View(*this), destination, Size());
+			break;
+#endif
+		default:
+			Detail::Generic::Vector3StoreAoS(View(*this), destination, Size());
+			break;
+		}
+	}
+
+	void Vector3Stream::Normalize() noexcept
+	{
+		Normalize(*this, *this);
+	}
+
+	void Vector3Stream::Normalize(const Parallel::ParallelPolicy& policy) noexcept
+	{
+		Normalize(policy, *this, *this);
+	}
+
+	void Vector3Stream::Add(const Vector3Stream& a, const Vector3Stream& b, Vector3Stream& result) noexcept
+	{
+		assert(a.Size() == b.Size() && result.Size() == a.Size());
+
+		switch (GetSimdLevel())
+		{
+#if PMATH_X86
+		case SimdLevel::AVX512:
+			Detail::AVX512::Vector3Add(View(a), View(b), View(result), a.Size());
+			break;
+		case SimdLevel::AVX2:
+			Detail::AVX2::Vector3Add(View(a), View(b), View(result), a.Size());
+			break;
+#endif
+		default:
+			Detail::Generic::Vector3Add(View(a), View(b), View(result), a.Size());
+			break;
+		}
+	}
+
+	void Vector3Stream::Subtract(const Vector3Stream& a, const Vector3Stream& b, Vector3Stream& result) noexcept
+	{
+		assert(a.Size() == b.Size() && result.Size() == a.Size());
+
+		switch (GetSimdLevel())
+		{
+#if PMATH_X86
+		case SimdLevel::AVX512:
+			Detail::AVX512::Vector3Subtract(View(a), View(b), View(result), a.Size());
+			break;
+		case SimdLevel::AVX2:
+			Detail::AVX2::Vector3Subtract(View(a), View(b), View(result), a.Size());
+			break;
+#endif
+		default:
+			Detail::Generic::Vector3Subtract(View(a), View(b), View(result), a.Size());
+			break;
+		}
+	}
+
+	void Vector3Stream::Multiply(const Vector3Stream& a, const Vector3Stream& b, Vector3Stream& result) noexcept
+	{
+		assert(a.Size() == b.Size() && result.Size() == a.Size());
+
+		switch (GetSimdLevel())
+		{
+#if PMATH_X86
+		case SimdLevel::AVX512:
+			Detail::AVX512::Vector3Multiply(View(a), View(b), View(result), a.Size());
+			break;
+		case SimdLevel::AVX2:
+			Detail::AVX2::Vector3Multiply(View(a), View(b), View(result), a.Size());
+			break;
+#endif
+		default:
+			Detail::Generic::Vector3Multiply(View(a), View(b), View(result), a.Size());
+			break;
+		}
+	}
+
+	void Vector3Stream::Scale(const Vector3Stream& a, float s, Vector3Stream& result) noexcept
+	{
+		assert(result.Size() == a.Size());
+
+		switch (GetSimdLevel())
+		{
+#if PMATH_X86
+		case SimdLevel::AVX512:
+			Detail::AVX512::Vector3Scale(View(a), s, View(result), a.Size());
+			break;
+		case SimdLevel::AVX2:
+			Detail::AVX2::Vector3Scale(View(a), s, View(result), a.Size());
+			break;
+#endif
+		default:
+			Detail::Generic::Vector3Scale(View(a), s, View(result), a.Size());
+			break;
+		}
+	}
+
+	void Vector3Stream::Lerp(const Vector3Stream& a, const Vector3Stream& b, float t, Vector3Stream& result) noexcept
+	{
+		assert(a.Size() == b.Size() && result.Size() == a.Size());
+		LerpKernel(View(a), View(b), &t, 0, View(result), a.Size());
+	}
+
+	void Vector3Stream::Lerp(const Vector3Stream& a, const Vector3Stream& b, std::span<const float> t, Vector3Stream& result) noexcept
+	{
+		assert(a.Size() == b.Size() && result.Size() == a.Size() && t.size() == a.Size());
+		LerpKernel(View(a), View(b), t.data(), 1, View(result), a.Size());
+	}
+
+	void Vector3Stream::Cross(const Vector3Stream& a, const Vector3Stream& b, Vector3Stream& result) noexcept
+	{
+		assert(a.Size() == b.Size() && result.Size() == a.Size());
+
+		switch (GetSimdLevel())
+		{
+#if PMATH_X86
+		case SimdLevel::AVX512:
+			Detail::AVX512::Vector3Cross(View(a), View(b), View(result), a.Size());
+			break;
+		case SimdLevel::AVX2:
+			Detail::AVX2::Vector3Cross(View(a), View(b), View(result), a.Size());
+			break;
+#endif
+		default:
+			Detail::Generic::Vector3Cross(View(a), View(b), View(result), a.Size());
+			break;
+		}
+	}
+
+	void Vector3Stream::Normalize(const Vector3Stream& a, Vector3Stream& result) noexcept
+	{
+		assert(result.Size() == a.Size());
+		NormalizeKernel(View(a), View(result), a.Size());
+	}
+
+	void Vector3Stream::Normalize(const Parallel::ParallelPolicy& policy, const Vector3Stream& a, Vector3Stream& result) noexcept
+	{
+		assert(result.Size() == a.Size());
+
+		const Detail::ConstStreamView3 input = View(a);
+		const Detail::StreamView3 output = View(result);
+		Parallel::ParallelFor(a.Size(), policy.grain ? policy.grain : ParallelGrain, [&](Parallel::Range range) {
+			NormalizeKernel(Offset(input, range.begin), Offset(output, range.begin), range.Size());
+		});
+	}
+
+	void Vector3Stream::Dot(const Vector3Stream& a, const Vector3Stream& b, std::span<float> result) noexcept
+	{
+		assert(a.Size() == b.Size() && result.size() == a.Size());
+
+		switch (GetSimdLevel())
+		{
+#if PMATH_X86
+		case SimdLevel::AVX512:
+			Detail::AVX512::Vector3Dot(View(a), View(b), result.data(), a.Size());
+			break;
+		case SimdLevel::AVX2:
+			Detail::AVX2::Vector3Dot(View(a), View(b), result.data(), a.Size());
+			break;
+#endif
+		default:
+			Detail::Generic::Vector3Dot(View(a), View(b), result.data(), a.Size());
+			break;
+		}
+	}
+
+	void Vector3Stream::Length(const Vector3Stream& a, std::span<float> result) noexcept
+	{
+		assert(result.size() == a.Size());
+
+		switch (GetSimdLevel())
+		{
+#if PMATH_X86
+		case SimdLevel::AVX512:
+			Detail::AVX512::Vector3Length(View(a), result.data(), a.Size());
+			break;
+		case SimdLevel::AVX2:
+			Detail::AVX2::Vector3Length(View(a), result.data(), a.Size());
+			break;
+#endif
+		default:
+			Detail::Generic::Vector3Length(View(a), result.data(), a.Size());
+			break;
+		}
+	}
+}
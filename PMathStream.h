@@ -0,0 +1,313 @@
+#pragma once
+#include <span>
+
+#include "PMath.h"
+#include "PMathMemory.h"
+#include "PMathParallel.h"
+
+namespace PMgene::Math
+{
+	//****************************************************************************
+	// Vector2Stream
+	// Structure-of-arrays storage for many Vector2 values, with AVX2 kernels or a portable fallback.
+
+	struct Vector2Stream
+	{
+		AlignedVector<float> x;
+		AlignedVector<float> y;
+
+		// Constructors
+		Vector2Stream() noexcept = default;
+
+		explicit Vector2Stream(size_t count) : x(count), y(count)
+		{
+		}
+
+		explicit Vector2Stream(std::span<const Vector2> V)
+		{
+			Load(V);
+		}
+
+		[[nodiscard]] size_t Size() const noexcept { return x.size(); }
+		[[nodiscard]] bool Empty() const noexcept { return x.empty(); }
+
+		void Resize(size_t count);
+		void Clear() noexcept;
+
+		// Element access
+		[[nodiscard]] Vector2 Get(size_t i) const noexcept { return Vector2(x[i], y[i]); }
+		void Set(size_t i, const Vector2& V) noexcept
+		{
+			x[i] = V.x;
+			y[i] = V.y;
+		}
+
+		// AoS <-> SoA conversion. Load resizes the stream, Store expects V.size() == Size()
+		void Load(std::span<const Vector2> V);
+		void Store(std::span<Vector2> V) const noexcept;
+
+		// Stream operations
+		void Normalize() noexcept;
+
+		// Batch operations. Inputs and result must have the same size; result may alias an input
+		static void Add(const Vector2Stream& a, const Vector2Stream& b, Vector2Stream& result) noexcept;
+		static void Subtract(const Vector2Stream& a, const Vector2Stream& b, Vector2Stream& result) noexcept;
+		static void Multiply(const Vector2Stream& a, const Vector2Stream& b, Vector2Stream& result) noexcept;
+		static void Scale(const Vector2Stream& a, float s, Vector2Stream& result) noexcept;
+		// t is either one factor for every element or one per element
+		static void Lerp(const Vector2Stream& a, const Vector2Stream& b, float t, Vector2Stream& result) noexcept;
+		static void Lerp(const Vector2Stream& a, const Vector2Stream& b, std::span<const float> t, Vector2Stream& result) noexcept;
+		static void Normalize(const Vector2Stream& a, Vector2Stream& result) noexcept;
+
+		static void Dot(const Vector2Stream& a, const Vector2Stream& b, std::span<float> result) noexcept;
+		static void Length(const Vector2Stream& a, std::span<float> result) noexcept;
+	};
+
+	//****************************************************************************
+	// Vector3Stream
+	// Structure-of-arrays storage for many Vector3 values. Batch operations run on the
+	// widest kernels the CPU supports (AVX-512, AVX2 or a portable fallback).
+
+	struct Vector3Stream
+	{
+		AlignedVector<float> x;
+		AlignedVector<float> y;
+		AlignedVector<float> z;
+
+		// Constructors
+		Vector3Stream() noexcept = default;
+
+		explicit Vector3Stream(size_t count) : x(count), y(count), z(count)
+		{
+		}
+
+		explicit Vector3Stream(std::span<const Vector3> V)
+		{
+			Load(V);
+		}
+
+		[[nodiscard]] size_t Size() const noexcept { return x.size(); }
+		[[nodiscard]] bool Empty() const noexcept { return x.empty(); }
+
+		void Resize(size_t count);
+		void Clear() noexcept;
+
+		// Element access
+		[[nodiscard]] Vector3 Get(size_t i) const noexcept { return Vector3(x[i], y[i], z[i]); }
+		void Set(size_t i, const Vector3& V) noexcept
+		{
+			x[i] = V.x;
+			y[i] = V.y;
+			z[i] = V.z;
+		}
+
+		// AoS <-> SoA conversion. Load resizes the stream, Store expects V.size() == Size()
+		void Load(std::span<const Vector3> V);
+		void Store(std::span<Vector3> V) const noexcept;
+
+		// Stream operations
+		void Normalize() noexcept;
+		void Normalize(const Parallel::ParallelPolicy& policy) noexcept;
+
+		// Batch operations. Inputs and result must have the same size; result may alias an input
+		static void Add(const Vector3Stream& a, const Vector3Stream& b, Vector3Stream& result) noexcept;
+		static void Subtract(const Vector3Stream& a, const Vector3Stream& b, Vector3Stream& result) noexcept;
+		static void Multiply(const Vector3Stream& a, const Vector3Stream& b, Vector3Stream& result) noexcept;
+		static void Scale(const Vector3Stream& a, float s, Vector3Stream& result) noexcept;
+		// t is either one factor for every element or one per element
+		static void Lerp(const Vector3Stream& a, const Vector3Stream& b, float t, Vector3Stream& result) noexcept;
+		static void Lerp(const Vector3Stream& a, const Vector3Stream& b, std::span<const float> t, Vector3Stream& result) noexcept;
+		static void Cross(const Vector3Stream& a, const Vector3Stream& b, Vector3Stream& result) noexcept;
+		static void Normalize(const Vector3Stream& a, Vector3Stream& result) noexcept;
+		static void Normalize(const Parallel::ParallelPolicy& policy, const Vector3Stream& a, Vector3Stream& result) noexcept;
+
+		static void Dot(const Vector3Stream& a, const Vector3Stream& b, std::span<float> result) noexcept;
+		static void Length(const Vector3Stream& a, std::span<float> result) noexcept;
+	};
+
+	//****************************************************************************
+	// Vector4Stream
+	// Structure-of-arrays storage for many Vector4 values, with AVX2 kernels or a portable fallback.
+
+	struct Vector4Stream
+	{
+		AlignedVector<float> x;
+		AlignedVector<float> y;
+		AlignedVector<float> z;
+		AlignedVector<float> w;
+
+		// Constructors
+		Vector4Stream() noexcept = default;
+
+		explicit Vector4Stream(size_t count) : x(count), y(count), z(count), w(count)
+		{
+		}
+
+		explicit Vector4Stream(std::span<const Vector4> V)
+		{
+			Load(V);
+		}
+
+		[[nodiscard]] size_t Size() const noexcept { return x.size(); }
+		[[nodiscard]] bool Empty() const noexcept { return x.empty(); }
+
+		void Resize(size_t count);
+		void Clear() noexcept;
+
+		// Element access
+		[[nodiscard]] Vector4 Get(size_t i) const noexcept { return Vector4(x[i], y[i], z[i], w[i]); }
+		void Set(size_t i, const Vector4& V) noexcept
+		{
+			x[i] = V.x;
+			y[i] = V.y;
+			z[i] = V.z;
+			w[i] = V.w;
+		}
+
+		// AoS <-> SoA conversion. Load resizes the stream, Store expects V.size() == Size()
+		void Load(std::span<const Vector4> V);
+		void Store(std::span<Vector4> V) const noexcept;
+
+		// Stream operations
+		void Normalize() noexcept;
+
+		// Batch operations. Inputs and result must have the same size; result may alias an input
+		static void Add(const Vector4Stream& a, const Vector4Stream& b, Vector4Stream& result) noexcept;
+		static void Subtract(const Vector4Stream& a, const Vector4Stream& b, Vector4Stream& result) noexcept;
+		static void Multiply(const Vector4Stream& a, const Vector4Stream& b, Vector4Stream& result) noexcept;
+		static void Scale(const Vector4Stream& a, float s, Vector4Stream& result) noexcept;
+		// t is either one factor for every element or one per element
+		static void Lerp(const Vector4Stream& a, const Vector4Stream& b, float t, Vector4Stream& result) noexcept;
+		static void Lerp(const Vector4Stream& a, const Vector4Stream& b, std::span<const float> t, Vector4Stream& result) noexcept;
+		static void Normalize(const Vector4Stream& a, Vector4Stream& result) noexcept;
+
+		static void Dot(const Vector4Stream& a, const Vector4Stream& b, std::span<float> result) noexcept;
+		static void Length(const Vector4Stream& a, std::span<float> result) noexcept;
+	};
+
+	//****************************************************************************
+	// QuaternionStream
+	// Structure-of-arrays storage for many quaternions, meant for blending whole skeletons at once.
+	// Batch operations run on AVX2 kernels, 8 quaternions per iteration, or a portable fallback.
+
+	enum class SlerpMode
+	{
+		Exact,      // Within 3e-6 of the true arc per component, like Quaternion::Slerp
+		Approximate // Corrected nlerp, at most 4e-4 radians off the arc (0.05 degrees of rotation)
+	};
+
+	struct QuaternionStream
+	{
+		AlignedVector<float> x;
+		AlignedVector<float> y;
+		AlignedVector<float> z;
+		AlignedVector<float> w;
+
+		// Constructors
+		QuaternionStream() noexcept = default;
+
+		explicit QuaternionStream(size_t count) : x(count), y(count), z(count), w(count)
+		{
+		}
+
+		explicit QuaternionStream(std::span<const Quaternion> Q)
+		{
+			Load(Q);
+		}
+
+		[[nodiscard]] size_t Size() const noexcept { return x.size(); }
+		[[nodiscard]] bool Empty() const noexcept { return x.empty(); }
+
+		void Resize(size_t count);
+		void Clear() noexcept;
+
+		// Element access
+		[[nodiscard]] Quaternion Get(size_t i) const noexcept { return Quaternion(x[i], y[i], z[i], w[i]); }
+		void Set(size_t i, const Quaternion& Q) noexcept
+		{
+			x[i] = Q.x;
+			y[i] = Q.y;
+			z[i] = Q.z;
+			w[i] = Q.w;
+		}
+
+		// AoS <-> SoA conversion. Load resizes the stream, Store expects Q.size() == Size()
+		void Load(std::span<const Quaternion> Q);
+		void Store(std::span<Quaternion> Q) const noexcept;
+
+		// Stream operations
+		void Normalize() noexcept;
+
+		// Batch operations. Inputs and result must have the same size; result may alias an input.
+		// Interpolation takes the shorter arc per element without branching, and t is either one
+		// factor for every element or one per element. Lerp normalizes, like Quaternion::Lerp.
+		static void Normalize(const QuaternionStream& a, QuaternionStream& result) noexcept;
+
+		static void Lerp(const QuaternionStream& a, const QuaternionStream& b, float t, QuaternionStream& result) noexcept;
+		static void Lerp(const QuaternionStream& a, const QuaternionStream& b, std::span<const float> t, QuaternionStream& result) noexcept;
+		static void Lerp(const Parallel::ParallelPolicy& policy, const QuaternionStream& a, const QuaternionStream& b, float t, QuaternionStream& result) noexcept;
+		static void Lerp(const Parallel::ParallelPolicy& policy, const QuaternionStream& a, const QuaternionStream& b, std::span<const float> t, QuaternionStream& result) noexcept;
+
+		static void Slerp(const QuaternionStream& a, const QuaternionStream& b, float t, QuaternionStream& result, SlerpMode mode = SlerpMode::Exact) noexcept;
+		static void Slerp(const QuaternionStream& a, const QuaternionStream& b, std::span<const float> t, QuaternionStream& result, SlerpMode mode = SlerpMode::Exact) noexcept;
+		static void Slerp(const Parallel::ParallelPolicy& policy, const QuaternionStream& a, const QuaternionStream& b, float t, QuaternionStream& result, SlerpMode mode = SlerpMode::Exact) noexcept;
+		static void Slerp(const Parallel::ParallelPolicy& policy, const QuaternionStream& a, const QuaternionStream& b, std::span<const float> t, QuaternionStream& result, SlerpMode mode = SlerpMode::Exact) noexcept;
+
+		// Euler conversion with the angle layout of Quaternion::ToEuler and
+		// Quaternion::CreateFromYawPitchRoll(const Vector3&): pitch in x, yaw in y, roll in z.
+		// Gimbal lock is handled per element without branching. Results agree with the scalar
+		// versions to float rounding, which for yaw and roll grows as cos(pitch) nears zero in both.
+		// angles and result must have the same size as the input.
+		static void ToEuler(const QuaternionStream& a, Vector3Stream& angles) noexcept;
+		static void ToEuler(const Parallel::ParallelPolicy& policy, const QuaternionStream& a, Vector3Stream& angles) noexcept;
+		static void CreateFromYawPitchRoll(const Vector3Stream& angles, QuaternionStream& result) noexcept;
+		static void CreateFromYawPitchRoll(const Parallel::ParallelPolicy& policy, const Vector3Stream& angles, QuaternionStream& result) noexcept;
+	};
+
+
+	//****************************************************************************
+	// RayStream
+	// Structure-of-arrays rays for testing many rays against one primitive, like picking or sensor
+	// sweeps. Queries write one distance per ray with the semantics of Ray::Intersects, or FLT_MAX
+	// where the ray misses; distance must have the same size as the stream.
+
+	struct RayStream
+	{
+		Vector3Stream position;
+		Vector3Stream direction;
+
+		// Constructors
+		RayStream() noexcept = default;
+
+		explicit RayStream(size_t count) : position(count), direction(count)
+		{
+		}
+
+		explicit RayStream(std::span<const Ray> rays)
+		{
+			Load(rays);
+		}
+
+		[[nodiscard]] size_t Size() const noexcept { return position.Size(); }
+		[[nodiscard]] bool Empty() const noexcept { return position.Empty(); }
+
+		void Resize(size_t count);
+		void Clear() noexcept;
+
+		// Element access
+		[[nodiscard]] Ray Get(size_t i) const noexcept { return Ray(position.Get(i), direction.Get(i)); }
+		void Set(size_t i, const Ray& R) noexcept
+		{
+			position.Set(i, R.position);
+			direction.Set(i, R.direction);
+		}
+
+		// AoS <-> SoA conversion. Load resizes the stream, Store expects rays.size() == Size()
+		void Load(std::span<const Ray> rays);
+		void Store(std::span<Ray> rays) const noexcept;
+
+		// Queries
+		void Intersects(const Plane& P, std::span<float> distance) const noexcept;
+		void Intersects(const BoundingSphere& S, std::span<float> distance) const noexcept;
+	};
+}
@@ -0,0 +1,168 @@
+#include "PMathCpu.h"
+
+#if PMATH_X86
+#include "PMathAVX2.h"
+#include "PMathKernels.h"
+
+namespace PMgene::Math::Detail::AVX2
+{
+	void Vector3Add(ConstStreamView3 a, ConstStreamView3 b, StreamView3 result, size_t count) noexcept
+	{
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			lanes.Store(result.x + i, _mm256_add_ps(lanes.Load(a.x + i), lanes.Load(b.x + i)));
+			lanes.Store(result.y + i, _mm256_add_ps(lanes.Load(a.y + i), lanes.Load(b.y + i)));
+			lanes.Store(result.z + i, _mm256_add_ps(lanes.Load(a.z + i), lanes.Load(b.z + i)));
+		});
+	}
+
+	void Vector3Subtract(ConstStreamView3 a, ConstStreamView3 b, StreamView3 result, size_t count) noexcept
+	{
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			lanes.Store(result.x + i, _mm256_sub_ps(lanes.Load(a.x + i), lanes.Load(b.x + i)));
+			lanes.Store(result.y + i, _mm256_sub_ps(lanes.Load(a.y + i), lanes.Load(b.y + i)));
+			lanes.Store(result.z + i, _mm256_sub_ps(lanes.Load(a.z + i), lanes.Load(b.z + i)));
+		});
+	}
+
+	void Vector3Multiply(ConstStreamView3 a, ConstStreamView3 b, StreamView3 result, size_t count) noexcept
+	{
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			lanes.Store(result.x + i, _mm256_mul_ps(lanes.Load(a.x + i), lanes.Load(b.x + i)));
+			lanes.Store(result.y + i, _mm256_mul_ps(lanes.Load(a.y + i), lanes.Load(b.y + i)));
+			lanes.Store(result.z + i, _mm256_mul_ps(lanes.Load(a.z + i), lanes.Load(b.z + i)));
+		});
+	}
+
+	void Vector3Scale(ConstStreamView3 a, float s, StreamView3 result, size_t count) noexcept
+	{
+		const __m256 S = _mm256_set1_ps(s);
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			lanes.Store(result.x + i, _mm256_mul_ps(lanes.Load(a.x + i), S));
+			lanes.Store(result.y + i, _mm256_mul_ps(lanes.Load(a.y + i), S));
+			lanes.Store(result.z + i, _mm256_mul_ps(lanes.Load(a.z + i), S));
+		});
+	}
+
+	void Vector3Lerp(ConstStreamView3 a, ConstStreamView3 b, const float* t, size_t tStride, StreamView3 result, size_t count) noexcept
+	{
+		const auto lerp = [&](size_t i, auto lanes, __m256 T)
+		{
+			const __m256 ax = lanes.Load(a.x + i);
+			const __m256 ay = lanes.Load(a.y + i);
+			const __m256 az = lanes.Load(a.z + i);
+			lanes.Store(result.x + i, _mm256_fmadd_ps(T, _mm256_sub_ps(lanes.Load(b.x + i), ax), ax));
+			lanes.Store(result.y + i, _mm256_fmadd_ps(T, _mm256_sub_ps(lanes.Load(b.y + i), ay), ay));
+			lanes.Store(result.z + i, _mm256_fmadd_ps(T, _mm256_sub_ps(lanes.Load(b.z + i), az), az));
+		};
+
+		if (tStride == 0)
+		{
+			const __m256 T = _mm256_set1_ps(*t);
+			ForEach8(count, [&](size_t i, auto lanes) { lerp(i, lanes, T); });
+		}
+		else
+		{
+			ForEach8(count, [&](size_t i, auto lanes) { lerp(i, lanes, lanes.Load(t + i)); });
+		}
+	}
+
+	void Vector3Dot(ConstStreamView3 a, ConstStreamView3 b, float* result, size_t count) noexcept
+	{
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			__m256 d = _mm256_mul_ps(lanes.Load(a.x + i), lanes.Load(b.x + i));
+			d = _mm256_fmadd_ps(lanes.Load(a.y + i), lanes.Load(b.y + i), d);
+			d = _mm256_fmadd_ps(lanes.Load(a.z + i), lanes.Load(b.z + i), d);
+			lanes.Store(result + i, d);
+		});
+	}
+
+	void Vector3Cross(ConstStreamView3 a, ConstStreamView3 b, StreamView3 result, size_t count) noexcept
+	{
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			const __m256 ax = lanes.Load(a.x + i);
+			const __m256 ay = lanes.Load(a.y + i);
+			const __m256 az = lanes.Load(a.z + i);
+			const __m256 bx = lanes.Load(b.x + i);
+			const __m256 by = lanes.Load(b.y + i);
+			const __m256 bz = lanes.Load(b.z + i);
+
+			lanes.Store(result.x + i, _mm256_fmsub_ps(ay, bz, _mm256_mul_ps(az, by)));
+			lanes.Store(result.y + i, _mm256_fmsub_ps(az, bx, _mm256_mul_ps(ax, bz)));
+			lanes.Store(result.z + i, _mm256_fmsub_ps(ax, by, _mm256_mul_ps(ay, bx)));
+		});
+	}
+
+	void Vector3Length(ConstStreamView3 a, float* result, size_t count) noexcept
+	{
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			const __m256 x = lanes.Load(a.x + i);
+			const __m256 y = lanes.Load(a.y + i);
+			const __m256 z = lanes.Load(a.z + i);
+			const __m256 lengthSq = _mm256_fmadd_ps(z, z, _mm256_fmadd_ps(y, y, _mm256_mul_ps(x, x)));
+			lanes.Store(result + i, _mm256_sqrt_ps(lengthSq));
+		});
+	}
+
+	void Vector3Normalize(ConstStreamView3 a, StreamView3 result, size_t count) noexcept
+	{
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 one = _mm256_set1_ps(1.f);
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			const __m256 x = lanes.Load(a.x + i);
+			const __m256 y = lanes.Load(a.y + i);
+			const __m256 z = lanes.Load(a.z + i);
+			const __m256 length = _mm256_sqrt_ps(_mm256_fmadd_ps(z, z, _mm256_fmadd_ps(y, y, _mm256_mul_ps(x, x))));
+
+			// Zero-length vectors normalize to zero, matching XMVector3Normalize
+			const __m256 nonZero = _mm256_cmp_ps(length, zero, _CMP_NEQ_OQ);
+			const __m256 invLength = _mm256_and_ps(_mm256_div_ps(one, length), nonZero);
+
+			lanes.Store(result.x + i, _mm256_mul_ps(x, invLength));
+			lanes.Store(result.y + i, _mm256_mul_ps(y, invLength));
+			lanes.Store(result.z + i, _mm256_mul_ps(z, invLength));
+		});
+	}
+
+	void Vector3LoadAoS(const float* source, StreamView3 result, size_t count) noexcept
+	{
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 x, y, z;
+			LoadAoS8(source + i * 3, x, y, z);
+			_mm256_storeu_ps(result.x + i, x);
+			_mm256_storeu_ps(result.y + i, y);
+			_mm256_storeu_ps(result.z + i, z);
+		}
+		for (; i < count; ++i)
+		{
+			result.x[i] = source[i * 3];
+			result.y[i] = source[i * 3 + 1];
+			result.z[i] = source[i * 3 + 2];
+		}
+	}
+
+	void Vector3StoreAoS(ConstStreamView3 a, float* destination, size_t count) noexcept
+	{
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			StoreAoS8(destination + i * 3, _mm256_loadu_ps(a.x + i), _mm256_loadu_ps(a.y + i), _mm256_loadu_ps(a.z + i));
+		}
+		for (; i < count; ++i)
+		{
+			destination[i * 3] = a.x[i];
+			destination[i * 3 + 1] = a.y[i];
+			destination[i * 3 + 2] = a.z[i];
+		}
+	}
+}
+#endif
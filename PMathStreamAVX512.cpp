@@ -0,0 +1,168 @@
+#include "PMathCpu.h"
+
+#if PMATH_X86
+#include "PMathAVX512.h"
+#include "PMathKernels.h"
+
+namespace PMgene::Math::Detail::AVX512
+{
+	void Vector3Add(ConstStreamView3 a, ConstStreamView3 b, StreamView3 result, size_t count) noexcept
+	{
+		ForEach16(count, [&](size_t i, auto lanes)
+		{
+			lanes.Store(result.x + i, _mm512_add_ps(lanes.Load(a.x + i), lanes.Load(b.x + i)));
+			lanes.Store(result.y + i, _mm512_add_ps(lanes.Load(a.y + i), lanes.Load(b.y + i)));
+			lanes.Store(result.z + i, _mm512_add_ps(lanes.Load(a.z + i), lanes.Load(b.z + i)));
+		});
+	}
+
+	void Vector3Subtract(ConstStreamView3 a, ConstStreamView3 b, StreamView3 result, size_t count) noexcept
+	{
+		ForEach16(count, [&](size_t i, auto lanes)
+		{
+			lanes.Store(result.x + i, _mm512_sub_ps(lanes.Load(a.x + i), lanes.Load(b.x + i)));
+			lanes.Store(result.y + i, _mm512_sub_ps(lanes.Load(a.y + i), lanes.Load(b.y + i)));
+			lanes.Store(result.z + i, _mm512_sub_ps(lanes.Load(a.z + i), lanes.Load(b.z + i)));
+		});
+	}
+
+	void Vector3Multiply(ConstStreamView3 a, ConstStreamView3 b, StreamView3 result, size_t count) noexcept
+	{
+		ForEach16(count, [&](size_t i, auto lanes)
+		{
+			lanes.Store(result.x + i, _mm512_mul_ps(lanes.Load(a.x + i), lanes.Load(b.x + i)));
+			lanes.Store(result.y + i, _mm512_mul_ps(lanes.Load(a.y + i), lanes.Load(b.y + i)));
+			lanes.Store(result.z + i, _mm512_mul_ps(lanes.Load(a.z + i), lanes.Load(b.z + i)));
+		});
+	}
+
+	void Vector3Scale(ConstStreamView3 a, float s, StreamView3 result, size_t count) noexcept
+	{
+		const __m512 S = _mm512_set1_ps(s);
+		ForEach16(count, [&](size_t i, auto lanes)
+		{
+			lanes.Store(result.x + i, _mm512_mul_ps(lanes.Load(a.x + i), S));
+			lanes.Store(result.y + i, _mm512_mul_ps(lanes.Load(a.y + i), S));
+			lanes.Store(result.z + i, _mm512_mul_ps(lanes.Load(a.z + i), S));
+		});
+	}
+
+	void Vector3Lerp(ConstStreamView3 a, ConstStreamView3 b, const float* t, size_t tStride, StreamView3 result, size_t count) noexcept
+	{
+		const auto lerp = [&](size_t i, auto lanes, __m512 T)
+		{
+			const __m512 ax = lanes.Load(a.x + i);
+			const __m512 ay = lanes.Load(a.y + i);
+			const __m512 az = lanes.Load(a.z + i);
+			lanes.Store(result.x + i, _mm512_fmadd_ps(T, _mm512_sub_ps(lanes.Load(b.x + i), ax), ax));
+			lanes.Store(result.y + i, _mm512_fmadd_ps(T, _mm512_sub_ps(lanes.Load(b.y + i), ay), ay));
+			lanes.Store(result.z + i, _mm512_fmadd_ps(T, _mm512_sub_ps(lanes.Load(b.z + i), az), az));
+		};
+
+		if (tStride == 0)
+		{
+			const __m512 T = _mm512_set1_ps(*t);
+			ForEach16(count, [&](size_t i, auto lanes) { lerp(i, lanes, T); });
+		}
+		else
+		{
+			ForEach16(count, [&](size_t i, auto lanes) { lerp(i, lanes, lanes.Load(t + i)); });
+		}
+	}
+
+	void Vector3Dot(ConstStreamView3 a, ConstStreamView3 b, float* result, size_t count) noexcept
+	{
+		ForEach16(count, [&](size_t i, auto lanes)
+		{
+			__m512 d = _mm512_mul_ps(lanes.Load(a.x + i), lanes.Load(b.x + i));
+			d = _mm512_fmadd_ps(lanes.Load(a.y + i), lanes.Load(b.y + i), d);
+			d = _mm512_fmadd_ps(lanes.Load(a.z + i), lanes.Load(b.z + i), d);
+			lanes.Store(result + i, d);
+		});
+	}
+
+	void Vector3Cross(ConstStreamView3 a, ConstStreamView3 b, StreamView3 result, size_t count) noexcept
+	{
+		ForEach16(count, [&](size_t i, auto lanes)
+		{
+			const __m512 ax = lanes.Load(a.x + i);
+			const __m512 ay = lanes.Load(a.y + i);
+			const __m512 az = lanes.Load(a.z + i);
+			const __m512 bx = lanes.Load(b.x + i);
+			const __m512 by = lanes.Load(b.y + i);
+			const __m512 bz = lanes.Load(b.z + i);
+
+			lanes.Store(result.x + i, _mm512_fmsub_ps(ay, bz, _mm512_mul_ps(az, by)));
+			lanes.Store(result.y + i, _mm512_fmsub_ps(az, bx, _mm512_mul_ps(ax, bz)));
+			lanes.Store(result.z + i, _mm512_fmsub_ps(ax, by, _mm512_mul_ps(ay, bx)));
+		});
+	}
+
+	void Vector3Length(ConstStreamView3 a, float* result, size_t count) noexcept
+	{
+		ForEach16(count, [&](size_t i, auto lanes)
+		{
+			const __m512 x = lanes.Load(a.x + i);
+			const __m512 y = lanes.Load(a.y + i);
+			const __m512 z = lanes.Load(a.z + i);
+			const __m512 lengthSq = _mm512_fmadd_ps(z, z, _mm512_fmadd_ps(y, y, _mm512_mul_ps(x, x)));
+			lanes.Store(result + i, _mm512_sqrt_ps(lengthSq));
+		});
+	}
+
+	void Vector3Normalize(ConstStreamView3 a, StreamView3 result, size_t count) noexcept
+	{
+		const __m512 zero = _mm512_setzero_ps();
+		const __m512 one = _mm512_set1_ps(1.f);
+		ForEach16(count, [&](size_t i, auto lanes)
+		{
+			const __m512 x = lanes.Load(a.x + i);
+			const __m512 y = lanes.Load(a.y + i);
+			const __m512 z = lanes.Load(a.z + i);
+			const __m512 length = _mm512_sqrt_ps(_mm512_fmadd_ps(z, z, _mm512_fmadd_ps(y, y, _mm512_mul_ps(x, x))));
+
+			// Zero-length vectors normalize to zero, matching XMVector3Normalize
+			const __mmask16 nonZero = _mm512_cmp_ps_mask(length, zero, _CMP_NEQ_OQ);
+			const __m512 invLength = _mm512_maskz_div_ps(nonZero, one, length);
+
+			lanes.Store(result.x + i, _mm512_mul_ps(x, invLength));
+			lanes.Store(result.y + i, _mm512_mul_ps(y, invLength));
+			lanes.Store(result.z + i, _mm512_mul_ps(z, invLength));
+		});
+	}
+
+	void Vector3LoadAoS(const float* source, StreamView3 result, size_t count) noexcept
+	{
+		size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			__m512 x, y, z;
+			LoadAoS16(source + i * 3, x, y, z);
+			_mm512_storeu_ps(result.x + i, x);
+			_mm512_storeu_ps(result.y + i, y);
+			_mm512_storeu_ps(result.z + i, z);
+		}
+		for (; i < count; ++i)
+		{
+			result.x[i] = source[i * 3];
+			result.y[i] = source[i * 3 + 1];
+			result.z[i] = source[i * 3 + 2];
+		}
+	}
+
+	void Vector3StoreAoS(ConstStreamView3 a, float* destination, size_t count) noexcept
+	{
+		size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			StoreAoS16(destination + i * 3, _mm512_loadu_ps(a.x + i), _mm512_loadu_ps(a.y + i), _mm512_loadu_ps(a.z + i));
+		}
+		for (; i < count; ++i)
+		{
+			destination[i * 3] = a.x[i];
+			destination[i * 3 + 1] = a.y[i];
+			destination[i * 3 + 2] = a.z[i];
+		}
+	}
+}
+#endif
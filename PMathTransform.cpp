@@ -0,0 +1,394 @@
+#include <cassert>
+
+#include "PMath.h"
+#include "PMathCpu.h"
+#include "PMathKernels.h"
+#include "PMathParallel.h"
+#include "PMathStream.h"
+
+using namespace DirectX;
+
+namespace PMgene::Math
+{
+	//****************************************************************************
+	// Portable transform kernels
+
+	namespace Detail::Generic
+	{
+		namespace
+		{
+			template <TransformMode Mode>
+			void TransformSoA(const float* m, ConstStreamView3 input, StreamView3 output, size_t count) noexcept
+			{
+				const float w = Mode == TransformMode::Normal ? 0.f : 1.f;
+				for (size_t i = 0; i < count; ++i)
+				{
+					const float x = input.x[i], y = input.y[i], z = input.z[i];
+					float rx = x * m[0] + y * m[4] + z * m[8] + w * m[12];
+					float ry = x * m[1] + y * m[5] + z * m[9] + w * m[13];
+					float rz = x * m[2] + y * m[6] + z * m[10] + w * m[14];
+					if constexpr (Mode == TransformMode::Coord)
+					{
+						const float rw = x * m[3] + y * m[7] + z * m[11] + m[15];
+						rx /= rw;
+						ry /= rw;
+						rz /= rw;
+					}
+					output.x[i] = rx;
+					output.y[i] = ry;
+					output.z[i] = rz;
+				}
+			}
+
+			template <TransformMode Mode>
+			void TransformAoS(const float* matrix, const float* input, float* output, size_t count) noexcept
+			{
+				const XMMATRIX M = XMLoadFloat4x4(reinterpret_cast<const XMFLOAT4X4*>(matrix));
+				const XMFLOAT3* in = reinterpret_cast<const XMFLOAT3*>(input);
+				XMFLOAT3* out = reinterpret_cast<XMFLOAT3*>(output);
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					const XMVECTOR v = XMLoadFloat3(in + i);
+					if constexpr (Mode == TransformMode::Point)
+						XMStoreFloat3(out + i, XMVector3Transform(v, M));
+					else if constexpr (Mode == TransformMode::Normal)
+						XMStoreFloat3(out + i, XMVector3TransformNormal(v, M));
+					else
+						XMStoreFloat3(out + i, XMVector3TransformCoord(v, M));
+				}
+			}
+
+			XMMATRIX LoadMatrix(const float* m) noexcept
+			{
+				return XMLoadFloat4x4(reinterpret_cast<const XMFLOAT4X4*>(m));
+			}
+
+			void StoreMatrix(float* m, FXMMATRIX M) noexcept
+			{
+				XMStoreFloat4x4(reinterpret_cast<XMFLOAT4X4*>(m), M);
+			}
+		}
+
+		void Vector3TransformSoA(const float* matrix, TransformMode mode, ConstStreamView3 input, StreamView3 output, size_t count) noexcept
+		{
+			switch (mode)
+			{
+			case TransformMode::Point:
+				TransformSoA<TransformMode::Point>(matrix, input, output, count);
+				break;
+			case TransformMode::Normal:
+				TransformSoA<TransformMode::Normal>(matrix, input, output, count);
+				break;
+			case TransformMode::Coord:
+				TransformSoA<TransformMode::Coord>(matrix, input, output, count);
+				break;
+			}
+		}
+
+		void Vector3TransformAoS(const float* matrix, TransformMode mode, const float* input, float* output, size_t count) noexcept
+		{
+			switch (mode)
+			{
+			case TransformMode::Point:
+				TransformAoS<TransformMode::Point>(matrix, input, output, count);
+				break;
+			case TransformMode::Normal:
+				TransformAoS<TransformMode::Normal>(matrix, input, output, count);
+				break;
+			case TransformMode::Coord:
+				TransformAoS<TransformMode::Coord>(matrix, input, output, count);
+				break;
+			}
+		}
+
+		void MatrixMultiply(const float* a, const float* b, float* result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+				StoreMatrix(result + i * 16, XMMatrixMultiply(LoadMatrix(a + i * 16), LoadMatrix(b + i * 16)));
+		}
+
+		void MatrixMultiplyBroadcastA(const float* a, const float* b, float* result, size_t count) noexcept
+		{
+			const XMMATRIX A = LoadMatrix(a);
+			for (size_t i = 0; i < count; ++i)
+				StoreMatrix(result + i * 16, XMMatrixMultiply(A, LoadMatrix(b + i * 16)));
+		}
+
+		void MatrixMultiplyBroadcastB(const float* a, const float* b, float* result, size_t count) noexcept
+		{
+			const XMMATRIX B = LoadMatrix(b);
+			for (size_t i = 0; i < count; ++i)
+				StoreMatrix(result + i * 16, XMMatrixMultiply(LoadMatrix(a + i * 16), B));
+		}
+	}
+
+	//****************************************************************************
+	// Matrix batch transforms
+
+	namespace
+	{
+		static_assert(sizeof(Matrix) == 16 * sizeof(float), "Matrix must be tightly packed for batch kernels");
+
+		// Elements per parallel chunk, multiples of the SIMD width so chunks stay aligned
+		constexpr size_t TransformGrain = 16384;
+		constexpr size_t MultiplyGrain = 2048;
+
+		size_t Grain(const Parallel::ParallelPolicy& policy, size_t grain) noexcept
+		{
+			return policy.grain != 0 ? policy.grain : grain;
+		}
+
+		const float* Data(std::span<const Matrix> M) noexcept
+		{
+			return reinterpret_cast<const float*>(M.data());
+		}
+
+		float* Data(std::span<Matrix> M) noexcept
+		{
+			return reinterpret_cast<float*>(M.data());
+		}
+
+		const float* Data(std::span<const Vector3> V) noexcept
+		{
+			return reinterpret_cast<const float*>(V.data());
+		}
+
+		float* Data(std::span<Vector3> V) noexcept
+		{
+			return reinterpret_cast<float*>(V.data());
+		}
+
+		Detail::ConstStreamView3 View(const Vector3Stream& S) noexcept
+		{
+			return { S.x.data(), S.y.data(), S.z.data() };
+		}
+
+		Detail::StreamView3 View(Vector3Stream& S) noexcept
+		{
+			return { S.x.data(), S.y.data(), S.z.data() };
+		}
+
+		template <typename View>
+		View Offset(View V, size_t offset) noexcept
+		{
+			return { V.x + offset, V.y + offset, V.z + offset };
+		}
+
+		void TransformAoS(const Matrix& M, Detail::TransformMode mode, const float* input, float* output, size_t count) noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+			{
+				Detail::AVX2::Vector3TransformAoS(&M._11, mode, input, output, count);
+				return;
+			}
+#endif
+			Detail::Generic::Vector3TransformAoS(&M._11, mode, input, output, count);
+		}
+
+		void TransformSoA(const Matrix& M, Detail::TransformMode mode, Detail::ConstStreamView3 input, Detail::StreamView3 output, size_t count) noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+			{
+				Detail::AVX2::Vector3TransformSoA(&M._11, mode, input, output, count);
+				return;
+			}
+#endif
+			Detail::Generic::Vector3TransformSoA(&M._11, mode, input, output, count);
+		}
+
+		void TransformBatch(const Matrix& M, Detail::TransformMode mode, std::span<const Vector3> input, std::span<Vector3> output) noexcept
+		{
+			assert(input.size() == output.size());
+			TransformAoS(M, mode, Data(input), Data(output), input.size());
+		}
+
+		void TransformBatch(const Matrix& M, Detail::TransformMode mode, const Vector3Stream& input, Vector3Stream& output) noexcept
+		{
+			assert(input.Size() == output.Size());
+			TransformSoA(M, mode, View(input), View(output), input.Size());
+		}
+
+		void TransformBatch(const Parallel::ParallelPolicy& policy, const Matrix& M, Detail::TransformMode mode, std::span<const Vector3> input, std::span<Vector3> output) noexcept
+		{
+			assert(input.size() == output.size());
+
+			const float* in = Data(input);
+			float* out = Data(output);
+			Parallel::ParallelFor(input.size(), Grain(policy, TransformGrain), [&](Parallel::Range range) {
+				TransformAoS(M, mode, in + range.begin * 3, out + range.begin * 3, range.Size());
+			});
+		}
+
+		void TransformBatch(const Parallel::ParallelPolicy& policy, const Matrix& M, Detail::TransformMode mode, const Vector3Stream& input, Vector3Stream& output) noexcept
+		{
+			assert(input.Size() == output.Size());
+
+			const Detail::ConstStreamView3 in = View(input);
+			const Detail::StreamView3 out = View(output);
+			Parallel::ParallelFor(input.Size(), Grain(policy, TransformGrain), [&](Parallel::Range range) {
+				TransformSoA(M, mode, Offset(in, range.begin), Offset(out, range.begin), range.Size());
+			});
+		}
+	}
+
+	void Matrix::TransformPoints(std::span<const Vector3> input, std::span<Vector3> output) const noexcept
+	{
+		TransformBatch(*this, Detail::TransformMode::Point, input, output);
+	}
+
+	void Matrix::TransformPoints(const Vector3Stream& input, Vector3Stream& output) const noexcept
+	{
+		TransformBatch(*this, Detail::TransformMode::Point, input, output);
+	}
+
+	void Matrix::TransformNormals(std::span<const Vector3> input, std::span<Vector3> output) const noexcept
+	{
+		TransformBatch(*this, Detail::TransformMode::Normal, input, output);
+	}
+
+	void Matrix::TransformNormals(const Vector3Stream& input, Vector3Stream& output) const noexcept
+	{
+		TransformBatch(*this, Detail::TransformMode::Normal, input, output);
+	}
+
+	void Matrix::TransformCoords(std::span<const Vector3> input, std::span<Vector3> output) const noexcept
+	{
+		TransformBatch(*this, Detail::TransformMode::Coord, input, output);
+	}
+
+	void Matrix::TransformCoords(const Vector3Stream& input, Vector3Stream& output) const noexcept
+	{
+		TransformBatch(*this, Detail::TransformMode::Coord, input, output);
+	}
+
+	void Matrix::TransformPoints(const Parallel::ParallelPolicy& policy, std::span<const Vector3> input, std::span<Vector3> output) const noexcept
+	{
+		TransformBatch(policy, *this, Detail::TransformMode::Point, input, output);
+	}
+
+	void Matrix::TransformPoints(const Parallel::ParallelPolicy& policy, const Vector3Stream& input, Vector3Stream& output) const noexcept
+	{
+		TransformBatch(policy, *this, Detail::TransformMode::Point, input, output);
+	}
+
+	void Matrix::TransformNormals(const Parallel::ParallelPolicy& policy, std::span<const Vector3> input, std::span<Vector3> output) const noexcept
+	{
+		TransformBatch(policy, *this, Detail::TransformMode::Normal, input, output);
+	}
+
+	void Matrix::TransformNormals(const Parallel::ParallelPolicy& policy, const Vector3Stream& input, Vector3Stream& output) const noexcept
+	{
+		TransformBatch(policy, *this, Detail::TransformMode::Normal, input, output);
+	}
+
+	void Matrix::TransformCoords(const Parallel::ParallelPolicy& policy, std::span<const Vector3> input, std::span<Vector3> output) const noexcept
+	{
+		TransformBatch(policy, *this, Detail::TransformMode::Coord, input, output);
+	}
+
+	void Matrix::TransformCoords(const Parallel::ParallelPolicy& policy, const Vector3Stream& input, Vector3Stream& output) const noexcept
+	{
+		TransformBatch(policy, *this, Detail::TransformMode::Coord, input, output);
+	}
+
+	//****************************************************************************
+	// Matrix batch concatenation
+
+	namespace
+	{
+		void MultiplyKernel(const float* a, const float* b, float* result, size_t count) noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+			{
+				Detail::AVX2::MatrixMultiply(a, b, result, count);
+				return;
+			}
+#endif
+			Detail::Generic::MatrixMultiply(a, b, result, count);
+		}
+
+		void MultiplyBroadcastAKernel(const float* a, const float* b, float* result, size_t count) noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+			{
+				Detail::AVX2::MatrixMultiplyBroadcastA(a, b, result, count);
+				return;
+			}
+#endif
+			Detail::Generic::MatrixMultiplyBroadcastA(a, b, result, count);
+		}
+
+		void MultiplyBroadcastBKernel(const float* a, const float* b, float* result, size_t count) noexcept
+		{
+#if PMATH_X86
+			if (GetSimdLevel() >= SimdLevel::AVX2)
+			{
+				Detail::AVX2::MatrixMultiplyBroadcastB(a, b, result, count);
+				return;
+			}
+#endif
+			Detail::Generic::MatrixMultiplyBroadcastB(a, b, result, count);
+		}
+	}
+
+	void Matrix::MultiplyBatch(std::span<const Matrix> a, std::span<const Matrix> b, std::span<Matrix> result) noexcept
+	{
+		assert(a.size() == b.size() && result.size() == a.size());
+		MultiplyKernel(Data(a), Data(b), Data(result), a.size());
+	}
+
+	void Matrix::MultiplyBatch(const Matrix& a, std::span<const Matrix> b, std::span<Matrix> result) noexcept
+	{
+		assert(result.size() == b.size());
+		MultiplyBroadcastAKernel(&a._11, Data(b), Data(result), b.size());
+	}
+
+	void Matrix::MultiplyBatch(std::span<const Matrix> a, const Matrix& b, std::span<Matrix> result) noexcept
+	{
+		assert(result.size() == a.size());
+		MultiplyBroadcastBKernel(Data(a), &b._11, Data(result), a.size());
+	}
+
+	void Matrix::MultiplyBatch(const Parallel::ParallelPolicy& policy, std::span<const Matrix> a, std::span<const Matrix> b, std::span<Matrix> result) noexcept
+	{
+		assert(a.size() == b.size() && result.size() == a.size());
+
+		const float* A = Data(a);
+		const float* B = Data(b);
+		float* R = Data(result);
+		Parallel::ParallelFor(a.size(), Grain(policy, MultiplyGrain), [&](Parallel::Range range) {
+			MultiplyKernel(A + range.begin * 16, B + range.begin * 16, R + range.begin * 16, range.Size());
+		});
+	}
+
+	void Matrix::MultiplyBatch(const Parallel::ParallelPolicy& policy, const Matrix& a, std::span<const Matrix> b, std::span<Matrix> result) noexcept
+	{
+		assert(result.size() == b.size());
+
+		// a may live inside result, which other chunks are already writing
+		const Matrix A = a;
+		const float* B = Data(b);
+		float* R = Data(result);
+		Parallel::ParallelFor(b.size(), Grain(policy, MultiplyGrain), [&](Parallel::Range range) {
+			MultiplyBroadcastAKernel(&A._11, B + range.begin * 16, R + range.begin * 16, range.Size());
+		});
+	}
+
+	void Matrix::MultiplyBatch(const Parallel::ParallelPolicy& policy, std::span<const Matrix> a, const Matrix& b, std::span<Matrix> result) noexcept
+	{
+		assert(result.size() == a.size());
+
+		// b may live inside result, which other chunks are already writing
+		const Matrix B = b;
+		const float* A = Data(a);
+		float* R = Data(result);
+		Parallel::ParallelFor(a.size(), Grain(policy, MultiplyGrain), [&](Parallel::Range range) {
+			MultiplyBroadcastBKernel(A + range.begin * 16, &B._11, R + range.begin * 16, range.Size());
+		});
+	}
+}
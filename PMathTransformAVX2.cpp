@@ -0,0 +1,340 @@
+#include "PMathCpu.h"
+
+#if PMATH_X86
+#include <cstdint>
+#include <cstring>
+
+#include "PMathAVX2.h"
+#include "PMathKernels.h"
+
+namespace PMgene::Math::Detail::AVX2
+{
+	namespace
+	{
+		// Matrix elements broadcast once so the whole loop runs with the rows held in registers
+		struct BroadcastMatrix
+		{
+			__m256 m[4][4];
+
+			explicit BroadcastMatrix(const float* matrix) noexcept
+			{
+				for (int r = 0; r < 4; ++r)
+					for (int c = 0; c < 4; ++c)
+						m[r][c] = _mm256_broadcast_ss(matrix + r * 4 + c);
+			}
+		};
+
+		template <TransformMode Mode>
+		inline void Transform8(const BroadcastMatrix& M, __m256& x, __m256& y, __m256& z) noexcept
+		{
+			__m256 rx, ry, rz;
+			if constexpr (Mode == TransformMode::Normal)
+			{
+				rx = _mm256_mul_ps(z, M.m[2][0]);
+				ry = _mm256_mul_ps(z, M.m[2][1]);
+				rz = _mm256_mul_ps(z, M.m[2][2]);
+			}
+			else
+			{
+				rx = _mm256_fmadd_ps(z, M.m[2][0], M.m[3][0]);
+				ry = _mm256_fmadd_ps(z, M.m[2][1], M.m[3][1]);
+				rz = _mm256_fmadd_ps(z, M.m[2][2], M.m[3][2]);
+			}
+			rx = _mm256_fmadd_ps(y, M.m[1][0], rx);
+			ry = _mm256_fmadd_ps(y, M.m[1][1], ry);
+			rz = _mm256_fmadd_ps(y, M.m[1][2], rz);
+			rx = _mm256_fmadd_ps(x, M.m[0][0], rx);
+			ry = _mm256_fmadd_ps(x, M.m[0][1], ry);
+			rz = _mm256_fmadd_ps(x, M.m[0][2], rz);
+
+			if constexpr (Mode == TransformMode::Coord)
+			{
+				__m256 rw = _mm256_fmadd_ps(z, M.m[2][3], M.m[3][3]);
+				rw = _mm256_fmadd_ps(y, M.m[1][3], rw);
+				rw = _mm256_fmadd_ps(x, M.m[0][3], rw);
+				rx = _mm256_div_ps(rx, rw);
+				ry = _mm256_div_ps(ry, rw);
+				rz = _mm256_div_ps(rz, rw);
+			}
+
+			x = rx;
+			y = ry;
+			z = rz;
+		}
+
+		template <TransformMode Mode>
+		inline void Transform1(const float* m, const float* in, float* out) noexcept
+		{
+			const float x = in[0], y = in[1], z = in[2];
+			const float w = Mode == TransformMode::Normal ? 0.f : 1.f;
+			float rx = x * m[0] + y * m[4] + z * m[8] + w * m[12];
+			float ry = x * m[1] + y * m[5] + z * m[9] + w * m[13];
+			float rz = x * m[2] + y * m[6] + z * m[10] + w * m[14];
+			if constexpr (Mode == TransformMode::Coord)
+			{
+				const float rw = x * m[3] + y * m[7] + z * m[11] + m[15];
+				rx /= rw;
+				ry /= rw;
+				rz /= rw;
+			}
+			out[0] = rx;
+			out[1] = ry;
+			out[2] = rz;
+		}
+
+		bool IsAligned(const void* p, uintptr_t alignment) noexcept
+		{
+			return (reinterpret_cast<uintptr_t>(p) & (alignment - 1)) == 0;
+		}
+
+		inline void Store8(float* p, __m256 v, bool nonTemporal) noexcept
+		{
+			if (nonTemporal)
+				_mm256_stream_ps(p, v);
+			else
+				_mm256_storeu_ps(p, v);
+		}
+
+		// Software pipelined: the next block is loaded before the current one is transformed
+		// and stored, hiding load latency behind the FMA chains
+		template <TransformMode Mode>
+		void TransformSoA(const float* matrix, ConstStreamView3 input, StreamView3 output, size_t count) noexcept
+		{
+			const BroadcastMatrix M(matrix);
+			const bool nonTemporal = count * 3 * sizeof(float) >= NonTemporalStoreBytes &&
+				IsAligned(output.x, 32) && IsAligned(output.y, 32) && IsAligned(output.z, 32);
+
+			size_t i = 0;
+			if (count >= 8)
+			{
+				__m256 x = _mm256_loadu_ps(input.x);
+				__m256 y = _mm256_loadu_ps(input.y);
+				__m256 z = _mm256_loadu_ps(input.z);
+				for (; i + 16 <= count; i += 8)
+				{
+					const __m256 nx = _mm256_loadu_ps(input.x + i + 8);
+					const __m256 ny = _mm256_loadu_ps(input.y + i + 8);
+					const __m256 nz = _mm256_loadu_ps(input.z + i + 8);
+
+					Transform8<Mode>(M, x, y, z);
+					Store8(output.x + i, x, nonTemporal);
+					Store8(output.y + i, y, nonTemporal);
+					Store8(output.z + i, z, nonTemporal);
+
+					x = nx;
+					y = ny;
+					z = nz;
+				}
+				Transform8<Mode>(M, x, y, z);
+				Store8(output.x + i, x, nonTemporal);
+				Store8(output.y + i, y, nonTemporal);
+				Store8(output.z + i, z, nonTemporal);
+				i += 8;
+			}
+
+			if (i < count)
+			{
+				const TailLanes lanes(count - i);
+				__m256 x = lanes.Load(input.x + i);
+				__m256 y = lanes.Load(input.y + i);
+				__m256 z = lanes.Load(input.z + i);
+				Transform8<Mode>(M, x, y, z);
+				lanes.Store(output.x + i, x);
+				lanes.Store(output.y + i, y);
+				lanes.Store(output.z + i, z);
+			}
+
+			if (nonTemporal)
+				_mm_sfence();
+		}
+
+		template <TransformMode Mode, bool NonTemporal>
+		void TransformAoS(const float* matrix, const float* input, float* output, size_t count) noexcept
+		{
+			const BroadcastMatrix M(matrix);
+
+			size_t i = 0;
+			if (count >= 8)
+			{
+				__m256 x, y, z;
+				LoadAoS8(input, x, y, z);
+				for (; i + 16 <= count; i += 8)
+				{
+					__m256 nx, ny, nz;
+					LoadAoS8(input + (i + 8) * 3, nx, ny, nz);
+
+					Transform8<Mode>(M, x, y, z);
+					StoreAoS8<NonTemporal>(output + i * 3, x, y, z);
+
+					x = nx;
+					y = ny;
+					z = nz;
+				}
+				Transform8<Mode>(M, x, y, z);
+				StoreAoS8<NonTemporal>(output + i * 3, x, y, z);
+				i += 8;
+			}
+
+			for (; i < count; ++i)
+				Transform1<Mode>(matrix, input + i * 3, output + i * 3);
+
+			if constexpr (NonTemporal)
+				_mm_sfence();
+		}
+
+		template <TransformMode Mode>
+		void TransformAoS(const float* matrix, const float* input, float* output, size_t count) noexcept
+		{
+			// Blocks of 8 XMFLOAT3 are 96 bytes, so a 16-byte aligned start keeps every block aligned
+			if (count * 3 * sizeof(float) >= NonTemporalStoreBytes && IsAligned(output, 16))
+				TransformAoS<Mode, true>(matrix, input, output, count);
+			else
+				TransformAoS<Mode, false>(matrix, input, output, count);
+		}
+
+		// Two consecutive matrices with their rows interleaved: row[r] holds row r of the first
+		// matrix in the low 128 bits and row r of the second one in the high 128 bits
+		struct MatrixPair
+		{
+			__m256 row[4];
+
+			static MatrixPair Load(const float* m) noexcept
+			{
+				const __m256 a01 = _mm256_loadu_ps(m);
+				const __m256 a23 = _mm256_loadu_ps(m + 8);
+				const __m256 b01 = _mm256_loadu_ps(m + 16);
+				const __m256 b23 = _mm256_loadu_ps(m + 24);
+				return { {
+					_mm256_permute2f128_ps(a01, b01, 0x20),
+					_mm256_permute2f128_ps(a01, b01, 0x31),
+					_mm256_permute2f128_ps(a23, b23, 0x20),
+					_mm256_permute2f128_ps(a23, b23, 0x31)
+				} };
+			}
+
+			// The same matrix in both halves
+			static MatrixPair Broadcast(const float* m) noexcept
+			{
+				return { {
+					_mm256_broadcast_ps(reinterpret_cast<const __m128*>(m)),
+					_mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 4)),
+					_mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 8)),
+					_mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 12))
+				} };
+			}
+
+			void Store(float* m) const noexcept
+			{
+				_mm256_storeu_ps(m, _mm256_permute2f128_ps(row[0], row[1], 0x20));
+				_mm256_storeu_ps(m + 8, _mm256_permute2f128_ps(row[2], row[3], 0x20));
+				_mm256_storeu_ps(m + 16, _mm256_permute2f128_ps(row[0], row[1], 0x31));
+				_mm256_storeu_ps(m + 24, _mm256_permute2f128_ps(row[2], row[3], 0x31));
+			}
+		};
+
+		// Row r of a * b is the sum of a[r][k] * b.row[k], each half of the register working on its own pair
+		inline __m256 MultiplyRow(__m256 a, const MatrixPair& B) noexcept
+		{
+			__m256 r = _mm256_mul_ps(_mm256_permute_ps(a, _MM_SHUFFLE(0, 0, 0, 0)), B.row[0]);
+			r = _mm256_fmadd_ps(_mm256_permute_ps(a, _MM_SHUFFLE(1, 1, 1, 1)), B.row[1], r);
+			r = _mm256_fmadd_ps(_mm256_permute_ps(a, _MM_SHUFFLE(2, 2, 2, 2)), B.row[2], r);
+			return _mm256_fmadd_ps(_mm256_permute_ps(a, _MM_SHUFFLE(3, 3, 3, 3)), B.row[3], r);
+		}
+
+		inline MatrixPair Multiply(const MatrixPair& A, const MatrixPair& B) noexcept
+		{
+			return { { MultiplyRow(A.row[0], B), MultiplyRow(A.row[1], B), MultiplyRow(A.row[2], B), MultiplyRow(A.row[3], B) } };
+		}
+
+		// Single product for the odd matrix at the end of a batch
+		inline void Multiply1(const float* a, const float* b, float* result) noexcept
+		{
+			const __m128 b0 = _mm_loadu_ps(b);
+			const __m128 b1 = _mm_loadu_ps(b + 4);
+			const __m128 b2 = _mm_loadu_ps(b + 8);
+			const __m128 b3 = _mm_loadu_ps(b + 12);
+
+			__m128 r[4];
+			for (int i = 0; i < 4; ++i)
+			{
+				const __m128 row = _mm_loadu_ps(a + i * 4);
+				r[i] = _mm_mul_ps(_mm_permute_ps(row, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+				r[i] = _mm_fmadd_ps(_mm_permute_ps(row, _MM_SHUFFLE(1, 1, 1, 1)), b1, r[i]);
+				r[i] = _mm_fmadd_ps(_mm_permute_ps(row, _MM_SHUFFLE(2, 2, 2, 2)), b2, r[i]);
+				r[i] = _mm_fmadd_ps(_mm_permute_ps(row, _MM_SHUFFLE(3, 3, 3, 3)), b3, r[i]);
+			}
+			for (int i = 0; i < 4; ++i)
+				_mm_storeu_ps(result + i * 4, r[i]);
+		}
+	}
+
+	void Vector3TransformSoA(const float* matrix, TransformMode mode, ConstStreamView3 input, StreamView3 output, size_t count) noexcept
+	{
+		switch (mode)
+		{
+		case TransformMode::Point:
+			TransformSoA<TransformMode::Point>(matrix, input, output, count);
+			break;
+		case TransformMode::Normal:
+			TransformSoA<TransformMode::Normal>(matrix, input, output, count);
+			break;
+		case TransformMode::Coord:
+			TransformSoA<TransformMode::Coord>(matrix, input, output, count);
+			break;
+		}
+	}
+
+	void Vector3TransformAoS(const float* matrix, TransformMode mode, const float* input, float* output, size_t count) noexcept
+	{
+		switch (mode)
+		{
+		case TransformMode::Point:
+			TransformAoS<TransformMode::Point>(matrix, input, output, count);
+			break;
+		case TransformMode::Normal:
+			TransformAoS<TransformMode::Normal>(matrix, input, output, count);
+			break;
+		case TransformMode::Coord:
+			TransformAoS<TransformMode::Coord>(matrix, input, output, count);
+			break;
+		}
+	}
+
+	void MatrixMultiply(const float* a, const float* b, float* result, size_t count) noexcept
+	{
+		size_t i = 0;
+		for (; i + 2 <= count; i += 2)
+			Multiply(MatrixPair::Load(a + i * 16), MatrixPair::Load(b + i * 16)).Store(result + i * 16);
+		if (i < count)
+			Multiply1(a + i * 16, b + i * 16, result + i * 16);
+	}
+
+	void MatrixMultiplyBroadcastA(const float* a, const float* b, float* result, size_t count) noexcept
+	{
+		// a may live inside result, so the odd tail works from a copy
+		float A1[16];
+		std::memcpy(A1, a, sizeof(A1));
+		const MatrixPair A = MatrixPair::Broadcast(A1);
+
+		size_t i = 0;
+		for (; i + 2 <= count; i += 2)
+			Multiply(A, MatrixPair::Load(b + i * 16)).Store(result + i * 16);
+		if (i < count)
+			Multiply1(A1, b + i * 16, result + i * 16);
+	}
+
+	void MatrixMultiplyBroadcastB(const float* a, const float* b, float* result, size_t count) noexcept
+	{
+		// b may live inside result, so the odd tail works from a copy
+		float B1[16];
+		std::memcpy(B1, b, sizeof(B1));
+		const MatrixPair B = MatrixPair::Broadcast(B1);
+
+		size_t i = 0;
+		for (; i + 2 <= count; i += 2)
+			Multiply(MatrixPair::Load(a + i * 16), B).Store(result + i * 16);
+		if (i < count)
+			Multiply1(a + i * 16, B1, result + i * 16);
+	}
+}
+#endif
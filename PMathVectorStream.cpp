@@ -0,0 +1,718 @@
+#include "PMathStream.h"
+
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+
+#include "PMath.inl"
+#include "PMathBounds.h"
+#include "PMathCpu.h"
+#include "PMathKernels.h"
+
+namespace PMgene::Math
+{
+	//****************************************************************************
+	// Portable kernels, written so the compiler can auto-vectorize them for the baseline ISA. Ray
+	// queries select with ternaries on values, so their loops stay free of branches too.
+
+	namespace Detail::Generic
+	{
+		void Vector2Add(ConstStreamView2 a, ConstStreamView2 b, StreamView2 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				result.x[i] = a.x[i] + b.x[i];
+				result.y[i] = a.y[i] + b.y[i];
+			}
+		}
+
+		void Vector2Subtract(ConstStreamView2 a, ConstStreamView2 b, StreamView2 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				result.x[i] = a.x[i] - b.x[i];
+				result.y[i] = a.y[i] - b.y[i];
+			}
+		}
+
+		void Vector2Multiply(ConstStreamView2 a, ConstStreamView2 b, StreamView2 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				result.x[i] = a.x[i] * b.x[i];
+				result.y[i] = a.y[i] * b.y[i];
+			}
+		}
+
+		void Vector2Scale(ConstStreamView2 a, float s, StreamView2 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				result.x[i] = a.x[i] * s;
+				result.y[i] = a.y[i] * s;
+			}
+		}
+
+		void Vector2Lerp(ConstStreamView2 a, ConstStreamView2 b, const float* t, size_t tStride, StreamView2 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float ti = t[i * tStride];
+				result.x[i] = a.x[i] + ti * (b.x[i] - a.x[i]);
+				result.y[i] = a.y[i] + ti * (b.y[i] - a.y[i]);
+			}
+		}
+
+		void Vector2Dot(ConstStreamView2 a, ConstStreamView2 b, float* result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				result[i] = a.x[i] * b.x[i] + a.y[i] * b.y[i];
+			}
+		}
+
+		void Vector2Length(ConstStreamView2 a, float* result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				result[i] = std::sqrt(a.x[i] * a.x[i] + a.y[i] * a.y[i]);
+			}
+		}
+
+		void Vector2Normalize(ConstStreamView2 a, StreamView2 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float x = a.x[i], y = a.y[i];
+				const float length = std::sqrt(x * x + y * y);
+				const float invLength = length != 0.f ? 1.f / length : 0.f;
+				result.x[i] = x * invLength;
+				result.y[i] = y * invLength;
+			}
+		}
+
+		void Vector2LoadAoS(const float* source, StreamView2 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				result.x[i] = source[i * 2];
+				result.y[i] = source[i * 2 + 1];
+			}
+		}
+
+		void Vector2StoreAoS(ConstStreamView2 a, float* destination, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				destination[i * 2] = a.x[i];
+				destination[i * 2 + 1] = a.y[i];
+			}
+		}
+
+		void Vector4Add(ConstStreamView4 a, ConstStreamView4 b, StreamView4 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				result.x[i] = a.x[i] + b.x[i];
+				result.y[i] = a.y[i] + b.y[i];
+				result.z[i] = a.z[i] + b.z[i];
+				result.w[i] = a.w[i] + b.w[i];
+			}
+		}
+
+		void Vector4Subtract(ConstStreamView4 a, ConstStreamView4 b, StreamView4 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				result.x[i] = a.x[i] - b.x[i];
+				result.y[i] = a.y[i] - b.y[i];
+				result.z[i] = a.z[i] - b.z[i];
+				result.w[i] = a.w[i] - b.w[i];
+			}
+		}
+
+		void Vector4Multiply(ConstStreamView4 a, ConstStreamView4 b, StreamView4 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				result.x[i] = a.x[i] * b.x[i];
+				result.y[i] = a.y[i] * b.y[i];
+				result.z[i] = a.z[i] * b.z[i];
+				result.w[i] = a.w[i] * b.w[i];
+			}
+		}
+
+		void Vector4Scale(ConstStreamView4 a, float s, StreamView4 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				result.x[i] = a.x[i] * s;
+				result.y[i] = a.y[i] * s;
+				result.z[i] = a.z[i] * s;
+				result.w[i] = a.w[i] * s;
+			}
+		}
+
+		void Vector4Lerp(ConstStreamView4 a, ConstStreamView4 b, const float* t, size_t tStride, StreamView4 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float ti = t[i * tStride];
+				result.x[i] = a.x[i] + ti * (b.x[i] - a.x[i]);
+				result.y[i] = a.y[i] + ti * (b.y[i] - a.y[i]);
+				result.z[i] = a.z[i] + ti * (b.z[i] - a.z[i]);
+				result.w[i] = a.w[i] + ti * (b.w[i] - a.w[i]);
+			}
+		}
+
+		void Vector4Dot(ConstStreamView4 a, ConstStreamView4 b, float* result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				result[i] = a.x[i] * b.x[i] + a.y[i] * b.y[i] + a.z[i] * b.z[i] + a.w[i] * b.w[i];
+			}
+		}
+
+		void Vector4Length(ConstStreamView4 a, float* result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				result[i] = std::sqrt(a.x[i] * a.x[i] + a.y[i] * a.y[i] + a.z[i] * a.z[i] + a.w[i] * a.w[i]);
+			}
+		}
+
+		void Vector4Normalize(ConstStreamView4 a, StreamView4 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float x = a.x[i], y = a.y[i], z = a.z[i], w = a.w[i];
+				const float length = std::sqrt(x * x + y * y + z * z + w * w);
+				const float invLength = length != 0.f ? 1.f / length : 0.f;
+				result.x[i] = x * invLength;
+				result.y[i] = y * invLength;
+				result.z[i] = z * invLength;
+				result.w[i] = w * invLength;
+			}
+		}
+
+		void Vector4LoadAoS(const float* source, StreamView4 result, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				result.x[i] = source[i * 4];
+				result.y[i] = source[i * 4 + 1];
+				result.z[i] = source[i * 4 + 2];
+				result.w[i] = source[i * 4 + 3];
+			}
+		}
+
+		void Vector4StoreAoS(ConstStreamView4 a, float* destination, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				destination[i * 4] = a.x[i];
+				destination[i * 4 + 1] = a.y[i];
+				destination[i * 4 + 2] = a.z[i];
+				destination[i * 4 + 3] = a.w[i];
+			}
+		}
+
+		void PlaneDistance(const float* plane, ConstStreamView3 points, float* result, size_t count) noexcept
+		{
+			const float nx = plane[0], ny = plane[1], nz = plane[2], d = plane[3];
+			for (size_t i = 0; i < count; ++i)
+			{
+				result[i] = nx * points.x[i] + ny * points.y[i] + nz * points.z[i] + d;
+			}
+		}
+
+		void RayPlaneIntersect(ConstStreamView3 position, ConstStreamView3 direction, const float* plane, float* distance, size_t count) noexcept
+		{
+			const float nx = plane[0], ny = plane[1], nz = plane[2], d = plane[3];
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float rate = nx * direction.x[i] + ny * direction.y[i] + nz * direction.z[i];
+				const float height = nx * position.x[i] + ny * position.y[i] + nz * position.z[i] + d;
+				const float t = -height / rate;
+				distance[i] = rate != 0.f && t >= 0.f ? t : FLT_MAX;
+			}
+		}
+
+		void RaySphereIntersect(ConstStreamView3 position, ConstStreamView3 direction, const float* sphere, float* distance, size_t count) noexcept
+		{
+			const float cx = sphere[0], cy = sphere[1], cz = sphere[2], radiusSq = sphere[3] * sphere[3];
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float ox = position.x[i] - cx, oy = position.y[i] - cy, oz = position.z[i] - cz;
+				const float dx = direction.x[i], dy = direction.y[i], dz = direction.z[i];
+				const float a = dx * dx + dy * dy + dz * dz;
+				const float b = ox * dx + oy * dy + oz * dz;
+				const float c = ox * ox + oy * oy + oz * oz - radiusSq;
+				const float discriminant = b * b - a * c;
+
+				const float t = (-b - std::sqrt(std::fmax(discriminant, 0.f))) / a;
+				const bool hit = b < 0.f && discriminant >= 0.f;
+				distance[i] = c <= 0.f ? 0.f : hit ? t : FLT_MAX;
+			}
+		}
+	}
+
+	//****************************************************************************
+	// Vector2Stream and Vector4Stream
+
+	namespace
+	{
+		static_assert(sizeof(Vector2) == 2 * sizeof(float), "Vector2 must be tightly packed for AoS conversion");
+		static_assert(sizeof(Vector4) == 4 * sizeof(float), "Vector4 must be tightly packed for AoS conversion");
+
+		Detail::StreamView2 View(Vector2Stream& S) noexcept
+		{
+			return { S.x.data(), S.y.data() };
+		}
+
+		Detail::ConstStreamView2 View(const Vector2Stream& S) noexcept
+		{
+			return { S.x.data(), S.y.data() };
+		}
+
+		Detail::ConstStreamView3 View(const Vector3Stream& S) noexcept
+		{
+			return { S.x.data(), S.y.data(), S.z.data() };
+		}
+
+		Detail::StreamView4 View(Vector4Stream& S) noexcept
+		{
+			return { S.x.data(), S.y.data(), S.z.data(), S.w.data() };
+		}
+
+		Detail::ConstStreamView4 View(const Vector4Stream& S) noexcept
+		{
+			return { S.x.data(), S.y.data(), S.z.data(), S.w.data() };
+		}
+	}
+
+	void Vector2Stream::Resize(size_t count)
+	{
+		x.resize(count);
+		y.resize(count);
+	}
+
+	void Vector2Stream::Clear() noexcept
+	{
+		x.clear();
+		y.clear();
+	}
+
+	void Vector2Stream::Load(std::span<const Vector2> V)
+	{
+		Resize(V.size());
+
+		const float* source = reinterpret_cast<const float*>(V.data());
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector2LoadAoS(source, View(*this), V.size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector2LoadAoS(source, View(*this), V.size());
+	}
+
+	void Vector2Stream::Store(std::span<Vector2> V) const noexcept
+	{
+		assert(V.size() == Size());
+
+		float* destination = reinterpret_cast<float*>(V.data());
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector2StoreAoS(View(*this), destination, Size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector2StoreAoS(View(*this), destination, Size());
+	}
+
+	void Vector2Stream::Normalize() noexcept
+	{
+		Normalize(*this, *this);
+	}
+
+	void Vector2Stream::Add(const Vector2Stream& a, const Vector2Stream& b, Vector2Stream& result) noexcept
+	{
+		assert(a.Size() == b.Size() && result.Size() == a.Size());
+
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector2Add(View(a), View(b), View(result), a.Size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector2Add(View(a), View(b), View(result), a.Size());
+	}
+
+	void Vector2Stream::Subtract(const Vector2Stream& a, const Vector2Stream& b, Vector2Stream& result) noexcept
+	{
+		assert(a.Size() == b.Size() && result.Size() == a.Size());
+
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector2Subtract(View(a), View(b), View(result), a.Size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector2Subtract(View(a), View(b), View(result), a.Size());
+	}
+
+	void Vector2Stream::Multiply(const Vector2Stream& a, const Vector2Stream& b, Vector2Stream& result) noexcept
+	{
+		assert(a.Size() == b.Size() && result.Size() == a.Size());
+
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector2Multiply(View(a), View(b), View(result), a.Size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector2Multiply(View(a), View(b), View(result), a.Size());
+	}
+
+	void Vector2Stream::Scale(const Vector2Stream& a, float s, Vector2Stream& result) noexcept
+	{
+		assert(result.Size() == a.Size());
+
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector2Scale(View(a), s, View(result), a.Size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector2Scale(View(a), s, View(result), a.Size());
+	}
+
+	void Vector2Stream::Lerp(const Vector2Stream& a, const Vector2Stream& b, float t, Vector2Stream& result) noexcept
+	{
+		assert(a.Size() == b.Size() && result.Size() == a.Size());
+
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector2Lerp(View(a), View(b), &t, 0, View(result), a.Size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector2Lerp(View(a), View(b), &t, 0, View(result), a.Size());
+	}
+
+	void Vector2Stream::Lerp(const Vector2Stream& a, const Vector2Stream& b, std::span<const float> t, Vector2Stream& result) noexcept
+	{
+		assert(a.Size() == b.Size() && result.Size() == a.Size() && t.size() == a.Size());
+
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector2Lerp(View(a), View(b), t.data(), 1, View(result), a.Size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector2Lerp(View(a), View(b), t.data(), 1, View(result), a.Size());
+	}
+
+	void Vector2Stream::Normalize(const Vector2Stream& a, Vector2Stream& result) noexcept
+	{
+		assert(result.Size() == a.Size());
+
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector2Normalize(View(a), View(result), a.Size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector2Normalize(View(a), View(result), a.Size());
+	}
+
+	void Vector2Stream::Dot(const Vector2Stream& a, const Vector2Stream& b, std::span<float> result) noexcept
+	{
+		assert(a.Size() == b.Size() && result.size() == a.Size());
+
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector2Dot(View(a), View(b), result.data(), a.Size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector2Dot(View(a), View(b), result.data(), a.Size());
+	}
+
+	void Vector2Stream::Length(const Vector2Stream& a, std::span<float> result) noexcept
+	{
+		assert(result.size() == a.Size());
+
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector2Length(View(a), result.data(), a.Size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector2Length(View(a), result.data(), a.Size());
+	}
+
+	void Vector4Stream::Resize(size_t count)
+	{
+		x.resize(count);
+		y.resize(count);
+		z.resize(count);
+		w.resize(count);
+	}
+
+	void Vector4Stream::Clear() noexcept
+	{
+		x.clear();
+		y.clear();
+		z.clear();
+		w.clear();
+	}
+
+	void Vector4Stream::Load(std::span<const Vector4> V)
+	{
+		Resize(V.size());
+
+		const float* source = reinterpret_cast<const float*>(V.data());
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector4LoadAoS(source, View(*this), V.size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector4LoadAoS(source, View(*this), V.size());
+	}
+
+	void Vector4Stream::Store(std::span<Vector4> V) const noexcept
+	{
+		assert(V.size() == Size());
+
+		float* destination = reinterpret_cast<float*>(V.data());
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector4StoreAoS(View(*this), destination, Size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector4StoreAoS(View(*this), destination, Size());
+	}
+
+	void Vector4Stream::Normalize() noexcept
+	{
+		Normalize(*this, *this);
+	}
+
+	void Vector4Stream::Add(const Vector4Stream& a, const Vector4Stream& b, Vector4Stream& result) noexcept
+	{
+		assert(a.Size() == b.Size() && result.Size() == a.Size());
+
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector4Add(View(a), View(b), View(result), a.Size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector4Add(View(a), View(b), View(result), a.Size());
+	}
+
+	void Vector4Stream::Subtract(const Vector4Stream& a, const Vector4Stream& b, Vector4Stream& result) noexcept
+	{
+		assert(a.Size() == b.Size() && result.Size() == a.Size());
+
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector4Subtract(View(a), View(b), View(result), a.Size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector4Subtract(View(a), View(b), View(result), a.Size());
+	}
+
+	void Vector4Stream::Multiply(const Vector4Stream& a, const Vector4Stream& b, Vector4Stream& result) noexcept
+	{
+		assert(a.Size() == b.Size() && result.Size() == a.Size());
+
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector4Multiply(View(a), View(b), View(result), a.Size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector4Multiply(View(a), View(b), View(result), a.Size());
+	}
+
+	void Vector4Stream::Scale(const Vector4Stream& a, float s, Vector4Stream& result) noexcept
+	{
+		assert(result.Size() == a.Size());
+
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector4Scale(View(a), s, View(result), a.Size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector4Scale(View(a), s, View(result), a.Size());
+	}
+
+	void Vector4Stream::Lerp(const Vector4Stream& a, const Vector4Stream& b, float t, Vector4Stream& result) noexcept
+	{
+		assert(a.Size() == b.Size() && result.Size() == a.Size());
+
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector4Lerp(View(a), View(b), &t, 0, View(result), a.Size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector4Lerp(View(a), View(b), &t, 0, View(result), a.Size());
+	}
+
+	void Vector4Stream::Lerp(const Vector4Stream& a, const Vector4Stream& b, std::span<const float> t, Vector4Stream& result) noexcept
+	{
+		assert(a.Size() == b.Size() && result.Size() == a.Size() && t.size() == a.Size());
+
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector4Lerp(View(a), View(b), t.data(), 1, View(result), a.Size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector4Lerp(View(a), View(b), t.data(), 1, View(result), a.Size());
+	}
+
+	void Vector4Stream::Normalize(const Vector4Stream& a, Vector4Stream& result) noexcept
+	{
+		assert(result.Size() == a.Size());
+
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector4Normalize(View(a), View(result), a.Size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector4Normalize(View(a), View(result), a.Size());
+	}
+
+	void Vector4Stream::Dot(const Vector4Stream& a, const Vector4Stream& b, std::span<float> result) noexcept
+	{
+		assert(a.Size() == b.Size() && result.size() == a.Size());
+
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector4Dot(View(a), View(b), result.data(), a.Size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector4Dot(View(a), View(b), result.data(), a.Size());
+	}
+
+	void Vector4Stream::Length(const Vector4Stream& a, std::span<float> result) noexcept
+	{
+		assert(result.size() == a.Size());
+
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::Vector4Length(View(a), result.data(), a.Size());
+			return;
+		}
+#endif
+		Detail::Generic::Vector4Length(View(a), result.data(), a.Size());
+	}
+
+	//****************************************************************************
+	// Plane
+
+	void Plane::Distance(const Vector3Stream& points, std::span<float> result) const noexcept
+	{
+		assert(result.size() == points.Size());
+
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::PlaneDistance(&x, View(points), result.data(), points.Size());
+			return;
+		}
+#endif
+		Detail::Generic::PlaneDistance(&x, View(points), result.data(), points.Size());
+	}
+
+	//****************************************************************************
+	// RayStream
+
+	void RayStream::Resize(size_t count)
+	{
+		position.Resize(count);
+		direction.Resize(count);
+	}
+
+	void RayStream::Clear() noexcept
+	{
+		position.Clear();
+		direction.Clear();
+	}
+
+	void RayStream::Load(std::span<const Ray> rays)
+	{
+		Resize(rays.size());
+		for (size_t i = 0; i < rays.size(); ++i)
+			Set(i, rays[i]);
+	}
+
+	void RayStream::Store(std::span<Ray> rays) const noexcept
+	{
+		assert(rays.size() == Size());
+		for (size_t i = 0; i < rays.size(); ++i)
+			rays[i] = Get(i);
+	}
+
+	void RayStream::Intersects(const Plane& P, std::span<float> distance) const noexcept
+	{
+		assert(distance.size() == Size());
+
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::RayPlaneIntersect(View(position), View(direction), &P.x, distance.data(), Size());
+			return;
+		}
+#endif
+		Detail::Generic::RayPlaneIntersect(View(position), View(direction), &P.x, distance.data(), Size());
+	}
+
+	void RayStream::Intersects(const BoundingSphere& S, std::span<float> distance) const noexcept
+	{
+		assert(distance.size() == Size());
+
+		const float sphere[4] = { S.center.x, S.center.y, S.center.z, S.radius };
+#if PMATH_X86
+		if (GetSimdLevel() >= SimdLevel::AVX2)
+		{
+			Detail::AVX2::RaySphereIntersect(View(position), View(direction), sphere, distance.data(), Size());
+			return;
+		}
+#endif
+		Detail::Generic::RaySphereIntersect(View(position), View(direction), sphere, distance.data(), Size());
+	}
+}
@@ -0,0 +1,363 @@
+#include "PMathCpu.h"
+
+#if PMATH_X86
+#include <cfloat>
+
+#include "PMathAVX2.h"
+#include "PMathKernels.h"
+
+namespace PMgene::Math::Detail::AVX2
+{
+	void Vector2Add(ConstStreamView2 a, ConstStreamView2 b, StreamView2 result, size_t count) noexcept
+	{
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			lanes.Store(result.x + i, _mm256_add_ps(lanes.Load(a.x + i), lanes.Load(b.x + i)));
+			lanes.Store(result.y + i, _mm256_add_ps(lanes.Load(a.y + i), lanes.Load(b.y + i)));
+		});
+	}
+
+	void Vector2Subtract(ConstStreamView2 a, ConstStreamView2 b, StreamView2 result, size_t count) noexcept
+	{
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			lanes.Store(result.x + i, _mm256_sub_ps(lanes.Load(a.x + i), lanes.Load(b.x + i)));
+			lanes.Store(result.y + i, _mm256_sub_ps(lanes.Load(a.y + i), lanes.Load(b.y + i)));
+		});
+	}
+
+	void Vector2Multiply(ConstStreamView2 a, ConstStreamView2 b, StreamView2 result, size_t count) noexcept
+	{
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			lanes.Store(result.x + i, _mm256_mul_ps(lanes.Load(a.x + i), lanes.Load(b.x + i)));
+			lanes.Store(result.y + i, _mm256_mul_ps(lanes.Load(a.y + i), lanes.Load(b.y + i)));
+		});
+	}
+
+	void Vector2Scale(ConstStreamView2 a, float s, StreamView2 result, size_t count) noexcept
+	{
+		const __m256 S = _mm256_set1_ps(s);
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			lanes.Store(result.x + i, _mm256_mul_ps(lanes.Load(a.x + i), S));
+			lanes.Store(result.y + i, _mm256_mul_ps(lanes.Load(a.y + i), S));
+		});
+	}
+
+	void Vector2Lerp(ConstStreamView2 a, ConstStreamView2 b, const float* t, size_t tStride, StreamView2 result, size_t count) noexcept
+	{
+		const auto lerp = [&](size_t i, auto lanes, __m256 T)
+		{
+			const __m256 ax = lanes.Load(a.x + i);
+			const __m256 ay = lanes.Load(a.y + i);
+			lanes.Store(result.x + i, _mm256_fmadd_ps(T, _mm256_sub_ps(lanes.Load(b.x + i), ax), ax));
+			lanes.Store(result.y + i, _mm256_fmadd_ps(T, _mm256_sub_ps(lanes.Load(b.y + i), ay), ay));
+		};
+
+		if (tStride == 0)
+		{
+			const __m256 T = _mm256_set1_ps(*t);
+			ForEach8(count, [&](size_t i, auto lanes) { lerp(i, lanes, T); });
+		}
+		else
+		{
+			ForEach8(count, [&](size_t i, auto lanes) { lerp(i, lanes, lanes.Load(t + i)); });
+		}
+	}
+
+	void Vector2Dot(ConstStreamView2 a, ConstStreamView2 b, float* result, size_t count) noexcept
+	{
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			__m256 d = _mm256_mul_ps(lanes.Load(a.x + i), lanes.Load(b.x + i));
+			d = _mm256_fmadd_ps(lanes.Load(a.y + i), lanes.Load(b.y + i), d);
+			lanes.Store(result + i, d);
+		});
+	}
+
+	void Vector2Length(ConstStreamView2 a, float* result, size_t count) noexcept
+	{
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			const __m256 x = lanes.Load(a.x + i);
+			const __m256 y = lanes.Load(a.y + i);
+			lanes.Store(result + i, _mm256_sqrt_ps(_mm256_fmadd_ps(y, y, _mm256_mul_ps(x, x))));
+		});
+	}
+
+	void Vector2Normalize(ConstStreamView2 a, StreamView2 result, size_t count) noexcept
+	{
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 one = _mm256_set1_ps(1.f);
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			const __m256 x = lanes.Load(a.x + i);
+			const __m256 y = lanes.Load(a.y + i);
+			const __m256 length = _mm256_sqrt_ps(_mm256_fmadd_ps(y, y, _mm256_mul_ps(x, x)));
+
+			// Zero-length vectors normalize to zero, matching XMVector2Normalize
+			const __m256 nonZero = _mm256_cmp_ps(length, zero, _CMP_NEQ_OQ);
+			const __m256 invLength = _mm256_and_ps(_mm256_div_ps(one, length), nonZero);
+
+			lanes.Store(result.x + i, _mm256_mul_ps(x, invLength));
+			lanes.Store(result.y + i, _mm256_mul_ps(y, invLength));
+		});
+	}
+
+	void Vector2LoadAoS(const float* source, StreamView2 result, size_t count) noexcept
+	{
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 x, y;
+			LoadAoS8x2(source + i * 2, x, y);
+			_mm256_storeu_ps(result.x + i, x);
+			_mm256_storeu_ps(result.y + i, y);
+		}
+		for (; i < count; ++i)
+		{
+			result.x[i] = source[i * 2];
+			result.y[i] = source[i * 2 + 1];
+		}
+	}
+
+	void Vector2StoreAoS(ConstStreamView2 a, float* destination, size_t count) noexcept
+	{
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			StoreAoS8x2(destination + i * 2, _mm256_loadu_ps(a.x + i), _mm256_loadu_ps(a.y + i));
+		}
+		for (; i < count; ++i)
+		{
+			destination[i * 2] = a.x[i];
+			destination[i * 2 + 1] = a.y[i];
+		}
+	}
+
+	void Vector4Add(ConstStreamView4 a, ConstStreamView4 b, StreamView4 result, size_t count) noexcept
+	{
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			lanes.Store(result.x + i, _mm256_add_ps(lanes.Load(a.x + i), lanes.Load(b.x + i)));
+			lanes.Store(result.y + i, _mm256_add_ps(lanes.Load(a.y + i), lanes.Load(b.y + i)));
+			lanes.Store(result.z + i, _mm256_add_ps(lanes.Load(a.z + i), lanes.Load(b.z + i)));
+			lanes.Store(result.w + i, _mm256_add_ps(lanes.Load(a.w + i), lanes.Load(b.w + i)));
+		});
+	}
+
+	void Vector4Subtract(ConstStreamView4 a, ConstStreamView4 b, StreamView4 result, size_t count) noexcept
+	{
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			lanes.Store(result.x + i, _mm256_sub_ps(lanes.Load(a.x + i), lanes.Load(b.x + i)));
+			lanes.Store(result.y + i, _mm256_sub_ps(lanes.Load(a.y + i), lanes.Load(b.y + i)));
+			lanes.Store(result.z + i, _mm256_sub_ps(lanes.Load(a.z + i), lanes.Load(b.z + i)));
+			lanes.Store(result.w + i, _mm256_sub_ps(lanes.Load(a.w + i), lanes.Load(b.w + i)));
+		});
+	}
+
+	void Vector4Multiply(ConstStreamView4 a, ConstStreamView4 b, StreamView4 result, size_t count) noexcept
+	{
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			lanes.Store(result.x + i, _mm256_mul_ps(lanes.Load(a.x + i), lanes.Load(b.x + i)));
+			lanes.Store(result.y + i, _mm256_mul_ps(lanes.Load(a.y + i), lanes.Load(b.y + i)));
+			lanes.Store(result.z + i, _mm256_mul_ps(lanes.Load(a.z + i), lanes.Load(b.z + i)));
+			lanes.Store(result.w + i, _mm256_mul_ps(lanes.Load(a.w + i), lanes.Load(b.w + i)));
+		});
+	}
+
+	void Vector4Scale(ConstStreamView4 a, float s, StreamView4 result, size_t count) noexcept
+	{
+		const __m256 S = _mm256_set1_ps(s);
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			lanes.Store(result.x + i, _mm256_mul_ps(lanes.Load(a.x + i), S));
+			lanes.Store(result.y + i, _mm256_mul_ps(lanes.Load(a.y + i), S));
+			lanes.Store(result.z + i, _mm256_mul_ps(lanes.Load(a.z + i), S));
+			lanes.Store(result.w + i, _mm256_mul_ps(lanes.Load(a.w + i), S));
+		});
+	}
+
+	void Vector4Lerp(ConstStreamView4 a, ConstStreamView4 b, const float* t, size_t tStride, StreamView4 result, size_t count) noexcept
+	{
+		const auto lerp = [&](size_t i, auto lanes, __m256 T)
+		{
+			const __m256 ax = lanes.Load(a.x + i);
+			const __m256 ay = lanes.Load(a.y + i);
+			const __m256 az = lanes.Load(a.z + i);
+			const __m256 aw = lanes.Load(a.w + i);
+			lanes.Store(result.x + i, _mm256_fmadd_ps(T, _mm256_sub_ps(lanes.Load(b.x + i), ax), ax));
+			lanes.Store(result.y + i, _mm256_fmadd_ps(T, _mm256_sub_ps(lanes.Load(b.y + i), ay), ay));
+			lanes.Store(result.z + i, _mm256_fmadd_ps(T, _mm256_sub_ps(lanes.Load(b.z + i), az), az));
+			lanes.Store(result.w + i, _mm256_fmadd_ps(T, _mm256_sub_ps(lanes.Load(b.w + i), aw), aw));
+		};
+
+		if (tStride == 0)
+		{
+			const __m256 T = _mm256_set1_ps(*t);
+			ForEach8(count, [&](size_t i, auto lanes) { lerp(i, lanes, T); });
+		}
+		else
+		{
+			ForEach8(count, [&](size_t i, auto lanes) { lerp(i, lanes, lanes.Load(t + i)); });
+		}
+	}
+
+	void Vector4Dot(ConstStreamView4 a, ConstStreamView4 b, float* result, size_t count) noexcept
+	{
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			__m256 d = _mm256_mul_ps(lanes.Load(a.x + i), lanes.Load(b.x + i));
+			d = _mm256_fmadd_ps(lanes.Load(a.y + i), lanes.Load(b.y + i), d);
+			d = _mm256_fmadd_ps(lanes.Load(a.z + i), lanes.Load(b.z + i), d);
+			d = _mm256_fmadd_ps(lanes.Load(a.w + i), lanes.Load(b.w + i), d);
+			lanes.Store(result + i, d);
+		});
+	}
+
+	void Vector4Length(ConstStreamView4 a, float* result, size_t count) noexcept
+	{
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			const __m256 x = lanes.Load(a.x + i);
+			const __m256 y = lanes.Load(a.y + i);
+			const __m256 z = lanes.Load(a.z + i);
+			const __m256 w = lanes.Load(a.w + i);
+			lanes.Store(result + i, _mm256_sqrt_ps(_mm256_fmadd_ps(w, w, _mm256_fmadd_ps(z, z, _mm256_fmadd_ps(y, y, _mm256_mul_ps(x, x))))));
+		});
+	}
+
+	void Vector4Normalize(ConstStreamView4 a, StreamView4 result, size_t count) noexcept
+	{
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 one = _mm256_set1_ps(1.f);
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			const __m256 x = lanes.Load(a.x + i);
+			const __m256 y = lanes.Load(a.y + i);
+			const __m256 z = lanes.Load(a.z + i);
+			const __m256 w = lanes.Load(a.w + i);
+			const __m256 length = _mm256_sqrt_ps(_mm256_fmadd_ps(w, w, _mm256_fmadd_ps(z, z, _mm256_fmadd_ps(y, y, _mm256_mul_ps(x, x)))));
+
+			// Zero-length vectors normalize to zero, matching XMVector4Normalize
+			const __m256 nonZero = _mm256_cmp_ps(length, zero, _CMP_NEQ_OQ);
+			const __m256 invLength = _mm256_and_ps(_mm256_div_ps(one, length), nonZero);
+
+			lanes.Store(result.x + i, _mm256_mul_ps(x, invLength));
+			lanes.Store(result.y + i, _mm256_mul_ps(y, invLength));
+			lanes.Store(result.z + i, _mm256_mul_ps(z, invLength));
+			lanes.Store(result.w + i, _mm256_mul_ps(w, invLength));
+		});
+	}
+
+	void Vector4LoadAoS(const float* source, StreamView4 result, size_t count) noexcept
+	{
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 x, y, z, w;
+			LoadAoS8x4(source + i * 4, x, y, z, w);
+			_mm256_storeu_ps(result.x + i, x);
+			_mm256_storeu_ps(result.y + i, y);
+			_mm256_storeu_ps(result.z + i, z);
+			_mm256_storeu_ps(result.w + i, w);
+		}
+		for (; i < count; ++i)
+		{
+			result.x[i] = source[i * 4];
+			result.y[i] = source[i * 4 + 1];
+			result.z[i] = source[i * 4 + 2];
+			result.w[i] = source[i * 4 + 3];
+		}
+	}
+
+	void Vector4StoreAoS(ConstStreamView4 a, float* destination, size_t count) noexcept
+	{
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			StoreAoS8x4(destination + i * 4, _mm256_loadu_ps(a.x + i), _mm256_loadu_ps(a.y + i), _mm256_loadu_ps(a.z + i), _mm256_loadu_ps(a.w + i));
+		}
+		for (; i < count; ++i)
+		{
+			destination[i * 4] = a.x[i];
+			destination[i * 4 + 1] = a.y[i];
+			destination[i * 4 + 2] = a.z[i];
+			destination[i * 4 + 3] = a.w[i];
+		}
+	}
+
+	void PlaneDistance(const float* plane, ConstStreamView3 points, float* result, size_t count) noexcept
+	{
+		const __m256 nx = _mm256_set1_ps(plane[0]);
+		const __m256 ny = _mm256_set1_ps(plane[1]);
+		const __m256 nz = _mm256_set1_ps(plane[2]);
+		const __m256 d = _mm256_set1_ps(plane[3]);
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			__m256 distance = _mm256_fmadd_ps(nx, lanes.Load(points.x + i), d);
+			distance = _mm256_fmadd_ps(ny, lanes.Load(points.y + i), distance);
+			distance = _mm256_fmadd_ps(nz, lanes.Load(points.z + i), distance);
+			lanes.Store(result + i, distance);
+		});
+	}
+
+	void RayPlaneIntersect(ConstStreamView3 position, ConstStreamView3 direction, const float* plane, float* distance, size_t count) noexcept
+	{
+		const __m256 nx = _mm256_set1_ps(plane[0]);
+		const __m256 ny = _mm256_set1_ps(plane[1]);
+		const __m256 nz = _mm256_set1_ps(plane[2]);
+		const __m256 d = _mm256_set1_ps(plane[3]);
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 miss = _mm256_set1_ps(FLT_MAX);
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			__m256 rate = _mm256_mul_ps(nx, lanes.Load(direction.x + i));
+			rate = _mm256_fmadd_ps(ny, lanes.Load(direction.y + i), rate);
+			rate = _mm256_fmadd_ps(nz, lanes.Load(direction.z + i), rate);
+			__m256 height = _mm256_fmadd_ps(nx, lanes.Load(position.x + i), d);
+			height = _mm256_fmadd_ps(ny, lanes.Load(position.y + i), height);
+			height = _mm256_fmadd_ps(nz, lanes.Load(position.z + i), height);
+
+			// Parallel rays give t = inf or NaN, which the rate test discards
+			const __m256 t = _mm256_div_ps(_mm256_sub_ps(zero, height), rate);
+			const __m256 hit = _mm256_and_ps(_mm256_cmp_ps(rate, zero, _CMP_NEQ_OQ), _mm256_cmp_ps(t, zero, _CMP_GE_OQ));
+			lanes.Store(distance + i, _mm256_blendv_ps(miss, t, hit));
+		});
+	}
+
+	void RaySphereIntersect(ConstStreamView3 position, ConstStreamView3 direction, const float* sphere, float* distance, size_t count) noexcept
+	{
+		const __m256 cx = _mm256_set1_ps(sphere[0]);
+		const __m256 cy = _mm256_set1_ps(sphere[1]);
+		const __m256 cz = _mm256_set1_ps(sphere[2]);
+		const __m256 radiusSq = _mm256_set1_ps(sphere[3] * sphere[3]);
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 miss = _mm256_set1_ps(FLT_MAX);
+		ForEach8(count, [&](size_t i, auto lanes)
+		{
+			const __m256 ox = _mm256_sub_ps(lanes.Load(position.x + i), cx);
+			const __m256 oy = _mm256_sub_ps(lanes.Load(position.y + i), cy);
+			const __m256 oz = _mm256_sub_ps(lanes.Load(position.z + i), cz);
+			const __m256 dx = lanes.Load(direction.x + i);
+			const __m256 dy = lanes.Load(direction.y + i);
+			const __m256 dz = lanes.Load(direction.z + i);
+
+			// Solves |offset + t * direction| = radius for the smaller non-negative t
+			const __m256 a = _mm256_fmadd_ps(dz, dz, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dx, dx)));
+			const __m256 b = _mm256_fmadd_ps(oz, dz, _mm256_fmadd_ps(oy, dy, _mm256_mul_ps(ox, dx)));
+			const __m256 c = _mm256_sub_ps(_mm256_fmadd_ps(oz, oz, _mm256_fmadd_ps(oy, oy, _mm256_mul_ps(ox, ox))), radiusSq);
+			const __m256 discriminant = _mm256_fmsub_ps(b, b, _mm256_mul_ps(a, c));
+
+			const __m256 root = _mm256_sqrt_ps(_mm256_max_ps(discriminant, zero));
+			const __m256 t = _mm256_div_ps(_mm256_sub_ps(_mm256_sub_ps(zero, b), root), a);
+			const __m256 hit = _mm256_and_ps(_mm256_cmp_ps(b, zero, _CMP_LT_OQ), _mm256_cmp_ps(discriminant, zero, _CMP_GE_OQ));
+			const __m256 inside = _mm256_cmp_ps(c, zero, _CMP_LE_OQ);
+			lanes.Store(distance + i, _mm256_andnot_ps(inside, _mm256_blendv_ps(miss, t, hit)));
+		});
+	}
+}
+#endif